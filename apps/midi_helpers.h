@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 
 #include "apps/midi_probe.h"
@@ -16,7 +17,19 @@
 __attribute__((weak)) void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2);
 static inline void midi_tx3_weak_impl(uint8_t b0, uint8_t b1, uint8_t b2) { (void)b0; (void)b1; (void)b2; }
 static inline void _midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
-  if ((void*)&midi_tx3) midi_tx3(b0,b1,b2); else midi_tx3_weak_impl(b0,b1,b2);
+  if (midi_tx3 != NULL) midi_tx3(b0,b1,b2); else midi_tx3_weak_impl(b0,b1,b2);
+}
+
+/* Sorties ciblées : masque de destinations, mêmes bits que midi_dest_t
+   (1 = DIN, 2 = USB). Hook optionnel midi_tx3_to(dests,b0,b1,b2) ; sans lui,
+   retour sur midi_tx3 (toutes sorties). */
+#define MIDI_HELPERS_DEST_DIN  0x01u
+#define MIDI_HELPERS_DEST_USB  0x02u
+#define MIDI_HELPERS_DEST_ALL  (MIDI_HELPERS_DEST_DIN | MIDI_HELPERS_DEST_USB)
+
+__attribute__((weak)) void midi_tx3_to(uint8_t dests, uint8_t b0, uint8_t b1, uint8_t b2);
+static inline void _midi_tx3_to(uint8_t dests, uint8_t b0, uint8_t b1, uint8_t b2) {
+  if (midi_tx3_to != NULL) midi_tx3_to(dests,b0,b1,b2); else _midi_tx3(b0,b1,b2);
 }
 
 /* Helpers API (canal 1..16) */
@@ -30,6 +43,16 @@ static inline void midi_note_off(uint8_t ch1_16, uint8_t note, uint8_t vel) {
   midi_probe_log(0U, (uint8_t)(ch + 1U), note, vel, 2U);
   _midi_tx3((uint8_t)(0x80u | ch), note, vel);
 }
+static inline void midi_note_on_to(uint8_t dests, uint8_t ch1_16, uint8_t note, uint8_t vel) {
+  uint8_t ch = MIDI_HELPERS_CLAMP(ch1_16, 1, 16) - 1;
+  midi_probe_log(0U, (uint8_t)(ch + 1U), note, vel, 1U);
+  _midi_tx3_to(dests, (uint8_t)(0x90u | ch), note, vel);
+}
+static inline void midi_note_off_to(uint8_t dests, uint8_t ch1_16, uint8_t note, uint8_t vel) {
+  uint8_t ch = MIDI_HELPERS_CLAMP(ch1_16, 1, 16) - 1;
+  midi_probe_log(0U, (uint8_t)(ch + 1U), note, vel, 2U);
+  _midi_tx3_to(dests, (uint8_t)(0x80u | ch), note, vel);
+}
 static inline void midi_all_notes_off(uint8_t ch1_16) {
   uint8_t ch = MIDI_HELPERS_CLAMP(ch1_16, 1, 16) - 1;
   midi_probe_log(0U, (uint8_t)(ch + 1U), 0U, 0U, 3U);
@@ -40,4 +63,5 @@ static inline void midi_all_notes_off(uint8_t ch1_16) {
    midi_note_on(3, 60, 100);
    midi_note_off(3, 60, 64);
    midi_all_notes_off(3);
+   midi_note_on_to(MIDI_HELPERS_DEST_USB, 3, 60, 100);
 */
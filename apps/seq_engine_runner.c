@@ -17,11 +17,16 @@
 #include "apps/rtos_shim.h"
 #include "apps/seq_led_bridge.h"
 #include "brick_config.h"
+#include "cart_bus.h"
+#include "cart_dirty.h"
 #include "cart_link.h"
+#include "cart_proto.h"
 #include "cart_registry.h"
 #include "core/seq/reader/seq_reader.h"
 #include "core/seq/seq_config.h"
 #include "core/seq/seq_model.h"
+#include "core/seq/seq_scheduler.h"
+#include "core/seq/seq_song.h"
 #include "ui_mute_backend.h"
 
 #ifdef BRICK_DEBUG_PLOCK
@@ -41,85 +46,199 @@
     do { (void)(tag); (void)(param); (void)(value); (void)(time); } while (0)
 #endif
 
+/* Worst case: a cart p-lock lives two steps at most (early pass), i.e. 16 tracks x
+   SEQ_MODEL_MAX_PLOCKS_PER_STEP x 2 = 768 locks, all on the active cart, so bounded
+   by its CART_PARAM_COUNT parameters. */
 #ifndef SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS
-#define SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS 24U
+#define SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS CART_PARAM_COUNT
 #endif
 
+/* Open-addressed (cart, param) -> slot index, load factor kept <= 1/2. */
+#ifndef SEQ_ENGINE_RUNNER_PLOCK_HASH_BITS
+#define SEQ_ENGINE_RUNNER_PLOCK_HASH_BITS 10U
+#endif
+#define SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE (1U << SEQ_ENGINE_RUNNER_PLOCK_HASH_BITS)
+#define SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK (SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE - 1U)
+#define SEQ_ENGINE_RUNNER_PLOCK_WORDS (CART_PARAM_COUNT / 32U)
+
+_Static_assert(SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE >= (2U * SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS),
+               "p-lock hash must stay at most half full");
+_Static_assert(SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS < UINT16_MAX, "p-lock slot index is 16-bit");
+
+/* Cart slides: p-locks ramping to their value over the step. At most
+   SEQ_ENGINE_RUNNER_MAX_SLIDES run at once (a slide beyond that is sent as a plain
+   lock). Their intermediate frames share SEQ_ENGINE_RUNNER_SLIDE_LINK_PCT percent of
+   the bytes CART_UART_BAUD carries in one step, after the step's own lock and restore
+   frames, so ramps never delay a note-synchronous p-lock. */
+#ifndef SEQ_ENGINE_RUNNER_MAX_SLIDES
+#define SEQ_ENGINE_RUNNER_MAX_SLIDES 32U
+#endif
+#ifndef SEQ_ENGINE_RUNNER_SLIDE_LINK_PCT
+#define SEQ_ENGINE_RUNNER_SLIDE_LINK_PCT 50U
+#endif
+
+/* Micro-timing resolution: 12 micro-ticks per step, same quantum as seq_live_capture. */
+#define SEQ_ENGINE_RUNNER_MICRO_PER_STEP 12
+
+/* Scheduler MIDI output bits double as midi_helpers destinations (DIN = 1, USB = 2). */
+_Static_assert((SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_DIN) == MIDI_HELPERS_DEST_DIN) &&
+               (SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_USB) == MIDI_HELPERS_DEST_USB),
+               "scheduler MIDI outputs must match midi_helpers destinations");
+_Static_assert((SEQ_SCHEDULER_OUT_CART1 + CART_COUNT) <= SEQ_SCHEDULER_OUT_COUNT, "one scheduler output per cart");
+
+/* Value not known to be on the cart: the next lock must be sent. */
+#define SEQ_ENGINE_RUNNER_PLOCK_VALUE_UNKNOWN 0xFFU
+
+/* Held cart p-lock. Slots are dense in [0, s_plock_count): release swaps the last one in.
+   A slot whose depth reached 0 is only restored at the end of the step, so a lock
+   taken again on that step keeps it without a restore/lock pair on the bus. */
 typedef struct {
-    bool active;
-    cart_id_t cart;
     uint16_t param_id;
+    uint8_t cart;
     uint8_t depth;
-    uint8_t previous;
+    uint8_t previous;  /* value before the first lock, restored on release */
+    uint8_t value;     /* last value scheduled for the cart */
+    uint8_t owner;     /* track that set `value` (SEQ_ENGINE_RUNNER_TRACK_COUNT: none) */
+    uint8_t step_tag;  /* low byte of the step `value` applies to */
+    bool sliding;      /* a slide is ramping the cart towards `value` */
 } seq_engine_runner_plock_state_t;
 
+/* Running ramp of one cart parameter. A lock planned ahead while it runs is
+   queued (`next_*`, span 0 for a plain lock) and takes over when it ends. */
+typedef struct {
+    systime_t start;
+    systime_t span;
+    systime_t next_start;
+    systime_t next_span;
+    uint16_t param_id;
+    uint8_t cart;
+    uint8_t from;
+    uint8_t to;
+    uint8_t last;      /* value on the cart */
+    uint8_t next_to;
+    bool queued;
+    bool finished;
+} seq_engine_runner_slide_t;
+
 typedef struct {
     bool active;
     uint8_t note;
-    uint32_t off_step;
+    systime_t off_due;
 } seq_engine_runner_note_state_t;
 
+typedef enum {
+    SEQ_ENGINE_RUNNER_PASS_ON_TIME = 0, /* Voices not planned early (all voices without look-ahead). */
+    SEQ_ENGINE_RUNNER_PASS_ALL,
+    SEQ_ENGINE_RUNNER_PASS_EARLY        /* Voices with micro < 0, or every voice when an output
+                                           has a negative latency offset, planned one step ahead. */
+} seq_engine_runner_pass_t;
+
 enum {
     SEQ_ENGINE_RUNNER_TRACK_COUNT = 16U
 };
 
 static CCM_DATA seq_engine_runner_plock_state_t s_plock_state[SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS];
+static CCM_DATA uint16_t s_plock_hash[SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE];            /* slot + 1, 0 = empty */
+static CCM_DATA uint32_t s_plock_present[CART_COUNT][SEQ_ENGINE_RUNNER_PLOCK_WORDS]; /* 512-bit map per cart */
+static uint16_t s_plock_count = 0U;
 static CCM_DATA seq_engine_runner_note_state_t s_note_state[SEQ_ENGINE_RUNNER_TRACK_COUNT][SEQ_MODEL_VOICES_PER_STEP];
-
-typedef struct {
-    uint8_t ch;
-    uint8_t note;
-    uint8_t vel;
-} midi_event_t;
-
-static midi_event_t s_off_events[SEQ_ENGINE_RUNNER_TRACK_COUNT * SEQ_MODEL_VOICES_PER_STEP];
-static midi_event_t s_on_events[SEQ_ENGINE_RUNNER_TRACK_COUNT * SEQ_MODEL_VOICES_PER_STEP];
-static uint8_t s_off_count = 0U;
-static uint8_t s_on_count = 0U;
+static uint32_t s_plock_planned_step[SEQ_ENGINE_RUNNER_TRACK_COUNT];
+static uint16_t s_plock_planned_mask = 0U;
+static bool s_lookahead_valid = false;
+static uint32_t s_lookahead_step = 0U;
+static bool s_lookahead_all = false; /* the looked-ahead step was planned whole (output lead) */
+static bool s_chase_pending = false; /* next step played is the first after a start/continue */
+static seq_engine_runner_slide_t s_slides[SEQ_ENGINE_RUNNER_MAX_SLIDES];
+static uint8_t s_slide_count = 0U;
+static uint8_t s_slide_cursor = 0U;       /* first slide served on the next tick */
+static uint8_t s_slide_ticks_left = 1U;   /* ticks left in the step budget */
+static uint32_t s_slide_budget = 0U;      /* bytes left for intermediate frames */
+static uint32_t s_step_lock_bytes = 0U;   /* lock/restore bytes planned this step */
+static systime_t s_step_now = 0U;
+static systime_t s_step_st = 0U;
+static systime_t s_tick_st = 0U; /* Cart link admission window (one clock tick). */
 
 static void _runner_reset_notes(void);
+static void _runner_reset_planning(void);
 static void _runner_flush_active_notes(void);
 static void _runner_advance_plock_state(void);
-static void _runner_apply_plocks(seq_track_handle_t handle, uint8_t step_idx, cart_id_t cart);
-static void _runner_handle_step(uint8_t track, uint32_t step_abs, uint8_t step_idx, seq_track_handle_t handle);
-static void _runner_queue_event(uint8_t ch, uint8_t note, uint8_t velocity, bool is_on);
-static void _runner_flush_queued_events(void);
+static void _runner_expire_plocks(void);
+static void _runner_plan_step(uint8_t track,
+                              seq_track_handle_t handle,
+                              const seq_plan_track_t *plan,
+                              uint32_t step_abs,
+                              systime_t boundary,
+                              const clock_step_info_t *info,
+                              seq_engine_runner_pass_t pass,
+                              bool all_early,
+                              cart_id_t cart);
+static void _runner_apply_plocks(uint8_t track,
+                                 seq_track_handle_t handle,
+                                 uint32_t step_abs,
+                                 cart_id_t cart,
+                                 systime_t due,
+                                 uint8_t depth);
+static void _runner_mute_track(uint8_t track);
+static void _runner_chase_track(uint8_t track, const seq_plan_track_t *plan, uint32_t step_abs,
+                                const clock_step_info_t *info);
+static void _runner_schedule_note_off(uint8_t track, uint8_t slot, uint8_t note, systime_t due);
+static void _runner_dispatch_event(const seq_scheduler_event_t *event);
+static int32_t _runner_time_diff(systime_t a, systime_t b);
+static int32_t _runner_micro_delta(systime_t step_st, int32_t micro);
 static uint8_t _runner_clamp_u8(int32_t value);
-static void _runner_send_note_on(uint8_t track, uint8_t note, uint8_t velocity);
-static void _runner_send_note_off(uint8_t track, uint8_t note);
+static void _runner_send_note_on(uint8_t track, uint8_t note, uint8_t velocity, uint8_t outputs);
+static void _runner_send_note_off(uint8_t track, uint8_t note, uint8_t outputs);
+static void _runner_plock_reset(void);
 static seq_engine_runner_plock_state_t *_runner_plock_find(cart_id_t cart, uint16_t param_id);
 static seq_engine_runner_plock_state_t *_runner_plock_acquire(cart_id_t cart, uint16_t param_id);
-static void _runner_plock_release(seq_engine_runner_plock_state_t *slot);
+static void _runner_plock_release(uint16_t index);
+static bool _runner_slide_start(seq_engine_runner_plock_state_t *slot, uint8_t to, systime_t due, bool plain);
+static void _runner_slide_cancel(seq_engine_runner_plock_state_t *slot);
+static void _runner_slide_remove(uint8_t index);
+static void _runner_slide_open_budget(const clock_step_info_t *info);
+static void _runner_service_slides(systime_t now);
+
+seq_engine_runner_plock_stats_t seq_engine_runner_plock_stats;
+seq_engine_runner_chase_stats_t seq_engine_runner_chase_stats;
 
 void seq_engine_runner_init(void) {
+    seq_scheduler_init();
     _runner_reset_notes();
-    memset(s_plock_state, 0, sizeof(s_plock_state));
+    _runner_reset_planning();
+    _runner_plock_reset();
+    seq_engine_runner_plock_stats_reset();
+    s_chase_pending = false;
 }
 
 void seq_engine_runner_on_transport_play(void) {
+    seq_scheduler_clear();
     _runner_flush_active_notes();
     _runner_reset_notes();
+    _runner_reset_planning();
     _runner_advance_plock_state();
+    _runner_expire_plocks();
+    /* The start position is only known at the first step (SPP, locate). */
+    s_chase_pending = true;
 }
 
 void seq_engine_runner_on_transport_stop(void) {
+    seq_scheduler_clear();
     _runner_flush_active_notes();
+    _runner_reset_planning();
 
     cart_id_t cart = cart_registry_get_active_id();
-    if (cart < CART_COUNT) {
-        for (size_t i = 0U; i < SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS; ++i) {
-            seq_engine_runner_plock_state_t *slot = &s_plock_state[i];
-            if (!slot->active || (slot->cart != cart)) {
-                continue;
-            }
-            cart_link_param_changed(slot->param_id, slot->previous, false, 0U);
-            _runner_plock_release(slot);
-        }
-    } else {
-        for (size_t i = 0U; i < SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS; ++i) {
-            _runner_plock_release(&s_plock_state[i]);
+    for (uint16_t i = 0U; i < s_plock_count; ++i) {
+        const seq_engine_runner_plock_state_t *slot = &s_plock_state[i];
+        if ((cart < CART_COUNT) && (slot->cart == cart)) {
+            cart_link_param_send(slot->param_id, slot->previous, CART_CLASS_RESTORE);
+            seq_engine_runner_plock_stats.restores++;
         }
     }
+    _runner_plock_reset();
+    s_slide_budget = 0U;
+    s_step_lock_bytes = 0U;
+    s_tick_st = 0U;
+    cart_bus_on_tick(0U); /* Stopped: UI edits are no longer metered. */
 
     for (uint8_t ch = 1U; ch <= SEQ_ENGINE_RUNNER_TRACK_COUNT; ++ch) {
         midi_all_notes_off(ch);
@@ -133,46 +252,128 @@ void seq_engine_runner_on_clock_step(const clock_step_info_t *info) {
 
     midi_probe_tick_begin(info->step_idx_abs);
 
+    seq_scheduler_set_period(info->tick_st);
+    s_step_now = info->now;
+    s_step_st = info->step_st;
+    s_tick_st = info->tick_st;
     _runner_advance_plock_state();
 
     const uint32_t step_abs = info->step_idx_abs;
-    const uint8_t step_idx = (uint8_t)(step_abs % SEQ_MODEL_STEPS_PER_TRACK);
+    const uint32_t next_abs = step_abs + 1U;
+    const systime_t next_boundary = (systime_t)(info->now + info->step_st);
+    const bool lookahead_hit = s_lookahead_valid && (s_lookahead_step == step_abs);
+    /* The ON_TIME pass must split the step exactly as its EARLY pass did. */
+    const bool on_time_all_early = lookahead_hit && s_lookahead_all;
+    const bool next_all_early = seq_scheduler_lead() > 0U;
     const cart_id_t cart = cart_registry_get_active_id();
+    /* Steps before 0 never played: a start from the top has nothing to chase. */
+    const bool chase = s_chase_pending && (step_abs > 0U);
+    s_chase_pending = false;
     uint8_t bank = 0U;
     uint8_t pattern = 0U;
     seq_led_bridge_get_active(&bank, &pattern);
+    if (chase) {
+        seq_engine_runner_chase_stats.chases++;
+        seq_engine_runner_chase_stats.steps_visited = 0U;
+    }
 
+    uint16_t muted = 0U;
+    uint16_t song_muted = seq_song_mute_mask();
     for (uint8_t track = 0U; track < SEQ_ENGINE_RUNNER_TRACK_COUNT; ++track) {
+        if (ui_mute_backend_is_muted(track)) {
+            _runner_mute_track(track);
+            muted |= (uint16_t)(1U << track);
+            continue;
+        }
+        if ((song_muted & (1U << track)) != 0U) {
+            _runner_mute_track(track);
+            continue;
+        }
         seq_track_handle_t handle = seq_reader_make_handle(bank, pattern, track);
-        _runner_handle_step(track, step_abs, step_idx, handle);
-        _runner_apply_plocks(handle, step_idx, cart);
+        const seq_plan_track_t *plan = seq_reader_get_plan(handle);
+        if (plan == NULL) {
+            continue;
+        }
+        if (chase) {
+            _runner_chase_track(track, plan, step_abs, info);
+        }
+        _runner_plan_step(track, handle, plan, step_abs, info->now, info,
+                          lookahead_hit ? SEQ_ENGINE_RUNNER_PASS_ON_TIME : SEQ_ENGINE_RUNNER_PASS_ALL,
+                          on_time_all_early, cart);
+    }
+
+    /* Pattern boundary: a queued pattern is swapped in before the next step is looked ahead,
+       so its early voices are planned from the new pattern; notes already queued ring out. */
+    if (((next_abs % SEQ_MODEL_STEPS_PER_TRACK) == 0U) && seq_song_on_boundary(info->now, &bank, &pattern)) {
+        seq_led_bridge_set_active(bank, pattern);
+    }
+    song_muted = seq_song_mute_mask(); /* the next song entry may mute other tracks */
+
+    for (uint8_t track = 0U; track < SEQ_ENGINE_RUNNER_TRACK_COUNT; ++track) {
+        if (((muted | song_muted) & (1U << track)) != 0U) {
+            continue;
+        }
+        seq_track_handle_t handle = seq_reader_make_handle(bank, pattern, track);
+        const seq_plan_track_t *plan = seq_reader_get_plan(handle);
+        if (plan == NULL) {
+            continue;
+        }
+        _runner_plan_step(track, handle, plan, next_abs, next_boundary, info, SEQ_ENGINE_RUNNER_PASS_EARLY,
+                          next_all_early, cart);
     }
 
-    _runner_flush_queued_events();
+    s_lookahead_valid = true;
+    s_lookahead_step = next_abs;
+    s_lookahead_all = next_all_early;
+
+    _runner_expire_plocks();
+    _runner_slide_open_budget(info);
+    (void)seq_scheduler_dispatch(info->now, _runner_dispatch_event);
 
     midi_probe_tick_end();
 }
 
+void seq_engine_runner_on_clock_tick(systime_t now) {
+    cart_bus_on_tick((uint32_t)s_tick_st);
+    (void)seq_scheduler_dispatch(now, _runner_dispatch_event);
+    if (s_slide_count > 0U) {
+        _runner_service_slides(now);
+    }
+}
+
+bool seq_engine_runner_service(systime_t now, systime_t *next_due) {
+    (void)seq_scheduler_dispatch(now, _runner_dispatch_event);
+    return seq_scheduler_next_release(next_due);
+}
+
 static void _runner_reset_notes(void) {
     for (uint8_t track = 0U; track < SEQ_ENGINE_RUNNER_TRACK_COUNT; ++track) {
         for (uint8_t slot = 0U; slot < SEQ_MODEL_VOICES_PER_STEP; ++slot) {
             seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
             state->active = false;
             state->note = 0U;
-            state->off_step = 0U;
+            state->off_due = 0U;
         }
     }
 }
 
+static void _runner_reset_planning(void) {
+    memset(s_plock_planned_step, 0, sizeof(s_plock_planned_step));
+    s_plock_planned_mask = 0U;
+    s_lookahead_valid = false;
+    s_lookahead_step = 0U;
+    s_lookahead_all = false;
+}
+
 static void _runner_flush_active_notes(void) {
     for (uint8_t track = 0U; track < SEQ_ENGINE_RUNNER_TRACK_COUNT; ++track) {
         for (uint8_t slot = 0U; slot < SEQ_MODEL_VOICES_PER_STEP; ++slot) {
             seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
             if (state->active) {
-                _runner_send_note_off(track, state->note);
+                _runner_send_note_off(track, state->note, SEQ_SCHEDULER_OUT_MIDI);
                 state->active = false;
                 state->note = 0U;
-                state->off_step = 0U;
+                state->off_due = 0U;
             }
         }
     }
@@ -180,178 +381,400 @@ static void _runner_flush_active_notes(void) {
 
 static void _runner_advance_plock_state(void) {
     cart_id_t cart = cart_registry_get_active_id();
-    for (size_t i = 0U; i < SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS; ++i) {
+    /* Walk down: a release moves the last (already visited) slot into the hole. */
+    for (uint16_t i = s_plock_count; i-- > 0U;) {
         seq_engine_runner_plock_state_t *slot = &s_plock_state[i];
-        if (!slot->active) {
+        if ((cart >= CART_COUNT) || (slot->cart != cart)) {
+            /* Cart removed or switched: nothing left to restore the value on. */
+            _runner_plock_release(i);
             continue;
         }
         if (slot->depth > 0U) {
             slot->depth--;
         }
-        if ((slot->depth == 0U) && (cart < CART_COUNT) && (slot->cart == cart)) {
-            cart_link_param_changed(slot->param_id, slot->previous, false, 0U);
-            _runner_plock_release(slot);
-        } else if (cart >= CART_COUNT) {
-            _runner_plock_release(slot);
-        }
     }
 }
 
-static bool _runner_step_has_voice(const seq_step_view_t *view) {
-    if (view == NULL) {
-        return false;
+/* End of step: restore and release the locks no track took again on it. */
+static void _runner_expire_plocks(void) {
+    for (uint16_t i = s_plock_count; i-- > 0U;) {
+        seq_engine_runner_plock_state_t *slot = &s_plock_state[i];
+        if (slot->depth != 0U) {
+            continue;
+        }
+        _runner_slide_cancel(slot);
+        if (slot->value != slot->previous) {
+            cart_link_param_send(slot->param_id, slot->previous, CART_CLASS_RESTORE);
+            seq_engine_runner_plock_stats.restores++;
+            s_step_lock_bytes += (uint32_t)cart_proto_set_size(slot->param_id);
+        }
+        _runner_plock_release(i);
     }
-    const uint8_t flags = view->flags;
-    const bool automation_only = (flags & SEQ_STEPF_AUTOMATION_ONLY) != 0U;
-    const bool has_voice = (flags & SEQ_STEPF_HAS_VOICE) != 0U;
-    return has_voice && !automation_only;
 }
 
-static void _runner_handle_step(uint8_t track,
-                                uint32_t step_abs,
-                                uint8_t step_idx,
-                                seq_track_handle_t handle) {
+static void _runner_mute_track(uint8_t track) {
+    seq_scheduler_cancel_track(track);
+    /* Its pending lock events are gone: the cart value is no longer known. */
+    for (uint16_t i = 0U; i < s_plock_count; ++i) {
+        if (s_plock_state[i].owner == track) {
+            _runner_slide_cancel(&s_plock_state[i]);
+            s_plock_state[i].value = SEQ_ENGINE_RUNNER_PLOCK_VALUE_UNKNOWN;
+            s_plock_state[i].owner = SEQ_ENGINE_RUNNER_TRACK_COUNT;
+        }
+    }
+    s_plock_planned_mask &= (uint16_t)~(1U << track);
     for (uint8_t slot = 0U; slot < SEQ_MODEL_VOICES_PER_STEP; ++slot) {
         seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
-        if (state->active && (step_abs >= state->off_step)) {
-            _runner_queue_event((uint8_t)(track + 1U), state->note, 0U, false);
+        if (state->active) {
+            _runner_send_note_off(track, state->note, SEQ_SCHEDULER_OUT_MIDI);
             state->active = false;
             state->note = 0U;
-            state->off_step = 0U;
+            state->off_due = 0U;
         }
     }
+}
 
-    if (ui_mute_backend_is_muted(track)) {
-        for (uint8_t slot = 0U; slot < SEQ_MODEL_VOICES_PER_STEP; ++slot) {
-            seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
-            if (state->active) {
-                _runner_queue_event((uint8_t)(track + 1U), state->note, 0U, false);
-                state->active = false;
-                state->note = 0U;
-                state->off_step = 0U;
-            }
-        }
-        return;
-    }
+/*
+ * Plans one step of a track. A step is split in two passes: voices with a
+ * negative micro offset are planned at the previous boundary (EARLY) so they
+ * can actually fire before their step, the other voices at their own
+ * boundary (ON_TIME). With @p all_early (an output has a negative latency
+ * offset, see seq_scheduler_lead()) every voice goes to the EARLY pass, so
+ * its early copies can be released before the boundary too. P-locks follow
+ * the first pass that plays a voice, with t_plock = max(now, t_on - tick_st/2)
+ * (SEQ_BEHAVIOR §1.3).
+ */
+static void _runner_plan_step(uint8_t track,
+                              seq_track_handle_t handle,
+                              const seq_plan_track_t *plan,
+                              uint32_t step_abs,
+                              systime_t boundary,
+                              const clock_step_info_t *info,
+                              seq_engine_runner_pass_t pass,
+                              bool all_early,
+                              cart_id_t cart) {
+    const uint8_t step_idx = (uint8_t)(step_abs % SEQ_MODEL_STEPS_PER_TRACK);
+    const uint64_t step_bit = (uint64_t)1U << step_idx;
+    const systime_t now = info->now;
 
-    seq_step_view_t view;
-    if (!seq_reader_get_step(handle, step_idx, &view)) {
+    /* Silent steps are rejected from the plan bitsets without touching per-step data. */
+    if (((plan->voice_bits | plan->cart_plock_bits) & step_bit) == 0U) {
         return;
     }
+    const bool has_cart_plock = (plan->cart_plock_bits & step_bit) != 0U;
 
-    if (!_runner_step_has_voice(&view)) {
-        return;
+    uint8_t voices = (uint8_t)(plan->voice_mask[step_idx] & SEQ_PLAN_VOICE_PLAY_MASK);
+    const uint8_t early = all_early ? 0xFFU : (uint8_t)(plan->voice_mask[step_idx] >> SEQ_PLAN_VOICE_EARLY_SHIFT);
+    if (pass == SEQ_ENGINE_RUNNER_PASS_EARLY) {
+        voices &= early;
+        if ((voices == 0U) && !has_cart_plock) {
+            return;
+        }
+    } else if (pass == SEQ_ENGINE_RUNNER_PASS_ON_TIME) {
+        voices &= (uint8_t)~early;
     }
 
-    for (uint8_t slot = 0U; slot < SEQ_MODEL_VOICES_PER_STEP; ++slot) {
-        seq_step_voice_view_t voice_view;
-        if (!seq_reader_get_step_voice(handle, step_idx, slot, &voice_view)) {
-            continue;
-        }
-        if (!voice_view.enabled) {
+    bool planned_voice = false;
+    systime_t first_on = boundary;
+
+    for (uint8_t slot = 0U; voices != 0U; ++slot, voices >>= 1U) {
+        if ((voices & 1U) == 0U) {
             continue;
         }
+        const seq_plan_voice_t voice = seq_plan_voice(plan, step_idx, slot);
 
-        seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
-
-        uint8_t note = _runner_clamp_u8((int32_t)voice_view.note);
-        uint8_t velocity = _runner_clamp_u8((int32_t)voice_view.vel);
-        if (velocity == 0U) {
-            continue;
+        systime_t t_on = (systime_t)(boundary + (systime_t)_runner_micro_delta(info->step_st, voice.micro));
+        if (_runner_time_diff(t_on, now) < 0) {
+            t_on = now;
         }
+        const systime_t t_off = (systime_t)(t_on + (systime_t)((uint32_t)voice.length * info->step_st));
 
-        if (state->active) {
-            _runner_queue_event((uint8_t)(track + 1U), state->note, 0U, false);
-            state->active = false;
-            state->note = 0U;
-            state->off_step = 0U;
+        seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
+        if (state->active && (_runner_time_diff(state->off_due, t_on) > 0)) {
+            /* Retrigger before the previous note ended: move its NOTE_OFF up. */
+            (void)seq_scheduler_cancel_note_off(track, slot);
+            _runner_schedule_note_off(track, slot, state->note, t_on);
         }
 
-        _runner_queue_event((uint8_t)(track + 1U), note, velocity, true);
+        const seq_scheduler_event_t on = {
+            .due = t_on,
+            .type = (uint8_t)SEQ_SCHEDULER_EV_NOTE_ON,
+            .outputs = SEQ_SCHEDULER_OUT_MIDI,
+            .track = track,
+            .slot = slot,
+            .note = voice.note,
+            .velocity = voice.vel,
+        };
+        (void)seq_scheduler_push(&on);
 
         state->active = true;
-        state->note = note;
-        uint32_t length = (uint32_t)voice_view.length;
-        if (length == 0U) {
-            length = 1U;
+        state->note = voice.note;
+        state->off_due = t_off;
+        _runner_schedule_note_off(track, slot, voice.note, t_off);
+
+        if (!planned_voice || (_runner_time_diff(t_on, first_on) < 0)) {
+            first_on = t_on;
         }
-        state->off_step = step_abs + length;
+        planned_voice = true;
     }
-}
 
-static void _runner_queue_event(uint8_t ch, uint8_t note, uint8_t velocity, bool is_on) {
-    midi_event_t *events = is_on ? s_on_events : s_off_events;
-    uint8_t *count = is_on ? &s_on_count : &s_off_count;
-    const uint8_t capacity = (uint8_t)(SEQ_ENGINE_RUNNER_TRACK_COUNT * SEQ_MODEL_VOICES_PER_STEP);
+    if (!has_cart_plock) {
+        return;
+    }
 
-    if (*count >= capacity) {
+    const uint16_t track_bit = (uint16_t)(1U << track);
+    const bool plocks_done = ((s_plock_planned_mask & track_bit) != 0U) && (s_plock_planned_step[track] == step_abs);
+    if (plocks_done || ((pass == SEQ_ENGINE_RUNNER_PASS_EARLY) && !planned_voice)) {
         return;
     }
 
-    midi_event_t *slot = &events[*count];
-    slot->ch = ch;
-    slot->note = note;
-    slot->vel = velocity;
-    (*count)++;
+    systime_t t_plock = (systime_t)(first_on - (info->tick_st / 2U));
+    if (_runner_time_diff(t_plock, now) < 0) {
+        t_plock = now;
+    }
+    /* Early p-locks are taken one boundary ahead: keep them alive one step longer. */
+    const uint8_t depth = (pass == SEQ_ENGINE_RUNNER_PASS_EARLY) ? 2U : 1U;
+    _runner_apply_plocks(track, handle, step_abs, cart, t_plock, depth);
+    s_plock_planned_step[track] = step_abs;
+    s_plock_planned_mask |= track_bit;
+}
+
+static uint64_t _runner_rotr64(uint64_t bits, uint8_t n) {
+    return (n == 0U) ? bits : ((bits >> n) | (bits << (64U - n)));
 }
 
-static void _runner_flush_queued_events(void) {
-    for (uint8_t i = 0U; i < s_off_count; ++i) {
-        const midi_event_t *event = &s_off_events[i];
-        midi_note_off(event->ch, event->note, event->vel);
+/*
+ * Chase: rebuilds the voices of @p track that would still be sounding when
+ * playback starts at @p step_abs, without replaying the steps before it.
+ * A retrigger on a voice slot cuts the previous note, so only the last step
+ * that played each slot matters. The plan occupancy bitset is rotated so the
+ * step just before the start sits on the top bit, and the scan walks down
+ * from one occupied step to the previous one (count leading zeros), never
+ * further back than the longest note (SEQ_MODEL_STEPS_PER_TRACK steps) nor
+ * before step 0. A sustained voice is sent now and keeps its original end.
+ * Slots the start step plays itself are skipped: it retriggers them at once.
+ * Cart p-locks and slides need no chase: a lock never outlives its step and a
+ * slide reaches its value within that step, so the only locks and ramps live
+ * at the start step are its own, planned by the normal pass.
+ */
+static void _runner_chase_track(uint8_t track, const seq_plan_track_t *plan, uint32_t step_abs,
+                                const clock_step_info_t *info) {
+    const uint8_t step_idx = (uint8_t)(step_abs % SEQ_MODEL_STEPS_PER_TRACK);
+    const uint32_t reach = (step_abs < SEQ_MODEL_STEPS_PER_TRACK) ? step_abs : SEQ_MODEL_STEPS_PER_TRACK;
+    uint8_t open = (uint8_t)(((1U << SEQ_MODEL_VOICES_PER_STEP) - 1U) & ~plan->voice_mask[step_idx]);
+
+    /* Bit b of the window is step (step_idx + b) % 64: `back` steps before the start is bit 64 - back. */
+    uint64_t window = _runner_rotr64(plan->voice_bits, step_idx);
+    if (reach < SEQ_MODEL_STEPS_PER_TRACK) {
+        window &= ~(((uint64_t)1U << (SEQ_MODEL_STEPS_PER_TRACK - reach)) - 1U);
+    }
+
+    while ((open != 0U) && (window != 0U)) {
+        const uint8_t bit = (uint8_t)(63 - __builtin_clzll(window));
+        window &= ~((uint64_t)1U << bit);
+        const int32_t back = (int32_t)SEQ_MODEL_STEPS_PER_TRACK - (int32_t)bit;
+        const uint8_t idx = (uint8_t)((step_idx + bit) % SEQ_MODEL_STEPS_PER_TRACK);
+        uint8_t voices = (uint8_t)(plan->voice_mask[idx] & open);
+        open &= (uint8_t)~plan->voice_mask[idx];
+        seq_engine_runner_chase_stats.steps_visited++;
+
+        for (uint8_t slot = 0U; voices != 0U; ++slot, voices >>= 1U) {
+            if ((voices & 1U) == 0U) {
+                continue;
+            }
+            const seq_plan_voice_t voice = seq_plan_voice(plan, idx, slot);
+            /* Micro-tick units relative to the start boundary. */
+            const int32_t on_u = (int32_t)voice.micro - (back * SEQ_ENGINE_RUNNER_MICRO_PER_STEP);
+            const int32_t off_u = on_u + ((int32_t)voice.length * SEQ_ENGINE_RUNNER_MICRO_PER_STEP);
+            if (off_u <= 0) {
+                continue; /* ended before the start */
+            }
+            systime_t t_on = (systime_t)(info->now + (systime_t)_runner_micro_delta(info->step_st, on_u));
+            if (_runner_time_diff(t_on, info->now) < 0) {
+                t_on = info->now;
+            }
+            const systime_t t_off = (systime_t)(info->now + (systime_t)_runner_micro_delta(info->step_st, off_u));
+
+            const seq_scheduler_event_t on = {
+                .due = t_on,
+                .type = (uint8_t)SEQ_SCHEDULER_EV_NOTE_ON,
+                .outputs = SEQ_SCHEDULER_OUT_MIDI,
+                .track = track,
+                .slot = slot,
+                .note = voice.note,
+                .velocity = voice.vel,
+            };
+            if (!seq_scheduler_push(&on)) {
+                continue;
+            }
+            seq_engine_runner_note_state_t *state = &s_note_state[track][slot];
+            state->active = true;
+            state->note = voice.note;
+            state->off_due = t_off;
+            _runner_schedule_note_off(track, slot, voice.note, t_off);
+            seq_engine_runner_chase_stats.notes++;
+        }
     }
+}
 
-    for (uint8_t i = 0U; i < s_on_count; ++i) {
-        const midi_event_t *event = &s_on_events[i];
-        midi_note_on(event->ch, event->note, event->vel);
+static void _runner_schedule_note_off(uint8_t track, uint8_t slot, uint8_t note, systime_t due) {
+    const seq_scheduler_event_t off = {
+        .due = due,
+        .type = (uint8_t)SEQ_SCHEDULER_EV_NOTE_OFF,
+        .outputs = SEQ_SCHEDULER_OUT_MIDI,
+        .track = track,
+        .slot = slot,
+        .note = note,
+    };
+    if (!seq_scheduler_push(&off)) {
+        /* NOTE_OFF is never dropped: emit it right away when the queue is saturated. */
+        _runner_send_note_off(track, note, SEQ_SCHEDULER_OUT_MIDI);
     }
+}
 
-    s_off_count = 0U;
-    s_on_count = 0U;
+static void _runner_dispatch_event(const seq_scheduler_event_t *event) {
+    switch ((seq_scheduler_event_type_t)event->type) {
+    case SEQ_SCHEDULER_EV_NOTE_OFF: {
+        _runner_send_note_off(event->track, event->note, event->outputs);
+        if ((event->track < SEQ_ENGINE_RUNNER_TRACK_COUNT) && (event->slot < SEQ_MODEL_VOICES_PER_STEP)) {
+            seq_engine_runner_note_state_t *state = &s_note_state[event->track][event->slot];
+            if (state->active && (state->note == event->note) && (state->off_due == event->due)) {
+                state->active = false;
+                state->note = 0U;
+                state->off_due = 0U;
+            }
+        }
+        break;
+    }
+    case SEQ_SCHEDULER_EV_PLOCK:
+        BRICK_DEBUG_PLOCK_LOG("RUNNER_PLOCK_APPLY", event->param_id, event->value, event->due);
+        cart_link_param_send(event->param_id, event->value, CART_CLASS_SEQ);
+        break;
+    case SEQ_SCHEDULER_EV_NOTE_ON:
+        _runner_send_note_on(event->track, event->note, event->velocity, event->outputs);
+        break;
+    default:
+        break;
+    }
 }
 
 static bool _runner_is_cart_param(uint16_t param_id) {
     return (param_id & 0x8000U) == 0U;
 }
 
-static void _runner_apply_plocks(seq_track_handle_t handle, uint8_t step_idx, cart_id_t cart) {
+/* Only transitions reach the cart: a lock equal to the value already scheduled
+   is absorbed. Two tracks locking one parameter on the same step resolve to the
+   lowest track, whatever the pass that planned each of them. A slide lock ramps
+   from the current value and reaches its own at the end of the step. */
+static void _runner_apply_plocks(uint8_t track,
+                                 seq_track_handle_t handle,
+                                 uint32_t step_abs,
+                                 cart_id_t cart,
+                                 systime_t due,
+                                 uint8_t depth) {
     if (cart >= CART_COUNT) {
         return;
     }
-
-    seq_step_view_t view;
-    if (!seq_reader_get_step(handle, step_idx, &view)) {
-        return;
-    }
-
-    if ((view.flags & SEQ_STEPF_HAS_CART_PLOCK) == 0U) {
-        return;
-    }
+    const uint8_t step_idx = (uint8_t)(step_abs % SEQ_MODEL_STEPS_PER_TRACK);
+    const uint8_t step_tag = (uint8_t)step_abs;
 
     seq_plock_iter_t it;
     if (!seq_reader_plock_iter_open(handle, step_idx, &it)) {
         return;
     }
 
+    /* Walk first, then validate against the track seqlock: a walk torn by a
+       concurrent edit is dropped whole rather than half applied. */
+    uint16_t params[SEQ_MODEL_MAX_PLOCKS_PER_STEP];
+    int32_t values[SEQ_MODEL_MAX_PLOCKS_PER_STEP];
+    uint8_t count = 0U;
     uint16_t param_id;
     int32_t value;
-    while (seq_reader_plock_iter_next(&it, &param_id, &value)) {
-        if (!_runner_is_cart_param(param_id)) {
+    while ((count < SEQ_MODEL_MAX_PLOCKS_PER_STEP) && seq_reader_plock_iter_next(&it, &param_id, &value)) {
+        if (_runner_is_cart_param(param_id)) {
+            params[count] = param_id;
+            values[count] = value;
+            ++count;
+        }
+    }
+    if (seq_reader_plock_iter_torn(&it)) {
+        return;
+    }
+
+    for (uint8_t i = 0U; i < count; ++i) {
+        const bool slide = (params[i] & SEQ_READER_PLOCK_CART_SLIDE) != 0U;
+        const uint16_t param = (uint16_t)(params[i] & (uint16_t)~SEQ_READER_PLOCK_CART_SLIDE);
+        if (param >= CART_PARAM_COUNT) {
+            seq_engine_runner_plock_stats.out_of_range++;
             continue;
         }
-        seq_engine_runner_plock_state_t *slot = _runner_plock_acquire(cart, param_id);
+        seq_engine_runner_plock_state_t *slot = _runner_plock_acquire(cart, param);
         if (slot == NULL) {
+            continue; /* table full, counted in seq_engine_runner_plock_stats.exhausted */
+        }
+        if (slot->depth < depth) {
+            slot->depth = depth;
+        }
+        if ((slot->owner < SEQ_ENGINE_RUNNER_TRACK_COUNT) && (slot->step_tag == step_tag)) {
+            seq_engine_runner_plock_stats.collisions++;
+            if (slot->owner < track) {
+                continue;
+            }
+        }
+        slot->owner = track;
+        slot->step_tag = step_tag;
+
+        const uint8_t locked = _runner_clamp_u8(values[i]);
+        if (slot->value == locked) {
+            seq_engine_runner_plock_stats.unchanged++;
             continue;
         }
-        if (slot->depth == 0U) {
-            slot->previous = cart_link_shadow_get(cart, param_id);
+        if (slot->sliding) {
+            /* Planned ahead: let the running ramp finish first. Due now: it ends here. */
+            if ((_runner_time_diff(due, s_step_now) > 0) &&
+                _runner_slide_start(slot, locked, due, !slide)) {
+                if (!slide) {
+                    seq_engine_runner_plock_stats.sent++;
+                    s_step_lock_bytes += (uint32_t)cart_proto_set_size(param);
+                }
+                continue;
+            }
+            _runner_slide_cancel(slot);
+            if (slot->value == locked) {
+                seq_engine_runner_plock_stats.unchanged++;
+                continue;
+            }
+        }
+        if (slide && _runner_slide_start(slot, locked, due, false)) {
+            continue;
+        }
+        /* A later pass never plans an earlier due, so this event lands last. */
+        slot->value = locked;
+        const seq_scheduler_event_t ev = {
+            .due = due,
+            .type = (uint8_t)SEQ_SCHEDULER_EV_PLOCK,
+            .outputs = SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_CART1 + cart),
+            .track = track,
+            .value = locked,
+            .param_id = param,
+        };
+        if (seq_scheduler_push(&ev)) {
+            seq_engine_runner_plock_stats.sent++;
+            s_step_lock_bytes += (uint32_t)cart_proto_set_size(param);
+        } else {
+            slot->value = SEQ_ENGINE_RUNNER_PLOCK_VALUE_UNKNOWN;
         }
-        slot->depth = 1U;
-        const uint8_t clamped = _runner_clamp_u8(value);
-        cart_link_param_changed(param_id, clamped, false, 0U);
     }
 }
 
+static int32_t _runner_time_diff(systime_t a, systime_t b) {
+    return (int32_t)(uint32_t)(a - b);
+}
+
+static int32_t _runner_micro_delta(systime_t step_st, int32_t micro) {
+    return ((int32_t)step_st * (int32_t)micro) / SEQ_ENGINE_RUNNER_MICRO_PER_STEP;
+}
+
 static uint8_t _runner_clamp_u8(int32_t value) {
     if (value < 0) {
         return 0U;
@@ -362,22 +785,69 @@ static uint8_t _runner_clamp_u8(int32_t value) {
     return (uint8_t)value;
 }
 
-static void _runner_send_note_on(uint8_t track, uint8_t note, uint8_t velocity) {
-    midi_note_on((uint8_t)(track + 1U), note, velocity);
+/* @p outputs: scheduler output mask, 0 for an unrouted event (every MIDI output). */
+static void _runner_send_note_on(uint8_t track, uint8_t note, uint8_t velocity, uint8_t outputs) {
+    const uint8_t dests = (uint8_t)(outputs & SEQ_SCHEDULER_OUT_MIDI);
+    if ((outputs == 0U) || (dests == SEQ_SCHEDULER_OUT_MIDI)) {
+        midi_note_on((uint8_t)(track + 1U), note, velocity);
+    } else if (dests != 0U) {
+        midi_note_on_to(dests, (uint8_t)(track + 1U), note, velocity);
+    }
 }
 
-static void _runner_send_note_off(uint8_t track, uint8_t note) {
-    midi_note_off((uint8_t)(track + 1U), note, 0U);
+static void _runner_send_note_off(uint8_t track, uint8_t note, uint8_t outputs) {
+    const uint8_t dests = (uint8_t)(outputs & SEQ_SCHEDULER_OUT_MIDI);
+    if ((outputs == 0U) || (dests == SEQ_SCHEDULER_OUT_MIDI)) {
+        midi_note_off((uint8_t)(track + 1U), note, 0U);
+    } else if (dests != 0U) {
+        midi_note_off_to(dests, (uint8_t)(track + 1U), note, 0U);
+    }
 }
 
-static seq_engine_runner_plock_state_t *_runner_plock_find(cart_id_t cart, uint16_t param_id) {
-    for (size_t i = 0U; i < SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS; ++i) {
-        seq_engine_runner_plock_state_t *slot = &s_plock_state[i];
-        if (slot->active && (slot->cart == cart) && (slot->param_id == param_id)) {
-            return slot;
+void seq_engine_runner_plock_stats_reset(void) {
+    memset(&seq_engine_runner_plock_stats, 0, sizeof(seq_engine_runner_plock_stats));
+    seq_engine_runner_plock_stats.active = s_plock_count;
+    seq_engine_runner_plock_stats.high_water = s_plock_count;
+}
+
+static void _runner_plock_reset(void) {
+    memset(s_plock_hash, 0, sizeof(s_plock_hash));
+    memset(s_plock_present, 0, sizeof(s_plock_present));
+    s_plock_count = 0U;
+    seq_engine_runner_plock_stats.active = 0U;
+    s_slide_count = 0U;
+    s_slide_cursor = 0U;
+}
+
+static uint16_t _runner_plock_home(cart_id_t cart, uint16_t param_id) {
+    const uint32_t key = ((uint32_t)cart * CART_PARAM_COUNT) + param_id;
+    return (uint16_t)((key * 2654435761U) >> (32U - SEQ_ENGINE_RUNNER_PLOCK_HASH_BITS));
+}
+
+/* Hash position of a present key; SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE if absent. */
+static uint16_t _runner_plock_hash_pos(cart_id_t cart, uint16_t param_id) {
+    uint16_t pos = _runner_plock_home(cart, param_id);
+    for (uint16_t probe = 0U; probe < SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE; ++probe) {
+        const uint16_t entry = s_plock_hash[pos];
+        if (entry == 0U) {
+            break;
         }
+        const seq_engine_runner_plock_state_t *slot = &s_plock_state[entry - 1U];
+        if ((slot->cart == cart) && (slot->param_id == param_id)) {
+            return pos;
+        }
+        pos = (uint16_t)((pos + 1U) & SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK);
+    }
+    return SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE;
+}
+
+static seq_engine_runner_plock_state_t *_runner_plock_find(cart_id_t cart, uint16_t param_id) {
+    /* The presence map answers the common "not held" case without probing. */
+    if ((s_plock_present[cart][param_id >> 5U] & (1UL << (param_id & 31U))) == 0U) {
+        return NULL;
     }
-    return NULL;
+    const uint16_t pos = _runner_plock_hash_pos(cart, param_id);
+    return (pos < SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE) ? &s_plock_state[s_plock_hash[pos] - 1U] : NULL;
 }
 
 static seq_engine_runner_plock_state_t *_runner_plock_acquire(cart_id_t cart, uint16_t param_id) {
@@ -385,29 +855,233 @@ static seq_engine_runner_plock_state_t *_runner_plock_acquire(cart_id_t cart, ui
     if (slot != NULL) {
         return slot;
     }
+    if (s_plock_count >= SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS) {
+        seq_engine_runner_plock_stats.exhausted++;
+        return NULL;
+    }
 
-    for (size_t i = 0U; i < SEQ_ENGINE_RUNNER_MAX_ACTIVE_PLOCKS; ++i) {
-        slot = &s_plock_state[i];
-        if (!slot->active) {
-            slot->active = true;
-            slot->cart = cart;
-            slot->param_id = param_id;
-            slot->depth = 0U;
-            slot->previous = cart_link_shadow_get(cart, param_id);
-            return slot;
+    uint16_t pos = _runner_plock_home(cart, param_id);
+    uint16_t probe = 1U;
+    while (s_plock_hash[pos] != 0U) {
+        pos = (uint16_t)((pos + 1U) & SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK);
+        ++probe;
+    }
+    if (probe > seq_engine_runner_plock_stats.probe_max) {
+        seq_engine_runner_plock_stats.probe_max = probe;
+    }
+
+    slot = &s_plock_state[s_plock_count];
+    slot->cart = (uint8_t)cart;
+    slot->param_id = param_id;
+    slot->depth = 0U;
+    slot->previous = cart_link_shadow_get(cart, param_id);
+    slot->value = slot->previous;
+    slot->owner = SEQ_ENGINE_RUNNER_TRACK_COUNT;
+    slot->step_tag = 0U;
+    slot->sliding = false;
+    s_plock_hash[pos] = (uint16_t)(s_plock_count + 1U);
+    s_plock_present[cart][param_id >> 5U] |= 1UL << (param_id & 31U);
+    s_plock_count++;
+
+    seq_engine_runner_plock_stats.active = s_plock_count;
+    if (s_plock_count > seq_engine_runner_plock_stats.high_water) {
+        seq_engine_runner_plock_stats.high_water = s_plock_count;
+    }
+    return slot;
+}
+
+static void _runner_plock_release(uint16_t index) {
+    if (index >= s_plock_count) {
+        return;
+    }
+    seq_engine_runner_plock_state_t *slot = &s_plock_state[index];
+    _runner_slide_cancel(slot);
+
+    /* Backward-shift deletion: pull each displaced follower into the hole so
+       probe chains never need tombstones. */
+    uint16_t hole = _runner_plock_hash_pos(slot->cart, slot->param_id);
+    if (hole < SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE) {
+        uint16_t next = (uint16_t)((hole + 1U) & SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK);
+        while (s_plock_hash[next] != 0U) {
+            const seq_engine_runner_plock_state_t *other = &s_plock_state[s_plock_hash[next] - 1U];
+            const uint16_t home = _runner_plock_home(other->cart, other->param_id);
+            if (((next - home) & SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK) >=
+                ((next - hole) & SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK)) {
+                s_plock_hash[hole] = s_plock_hash[next];
+                hole = next;
+            }
+            next = (uint16_t)((next + 1U) & SEQ_ENGINE_RUNNER_PLOCK_HASH_MASK);
+        }
+        s_plock_hash[hole] = 0U;
+    }
+    s_plock_present[slot->cart][slot->param_id >> 5U] &= ~(1UL << (slot->param_id & 31U));
+
+    /* Keep the slots dense: the last one takes the freed index. */
+    const uint16_t last = (uint16_t)(s_plock_count - 1U);
+    if (index != last) {
+        const seq_engine_runner_plock_state_t *moved = &s_plock_state[last];
+        const uint16_t pos = _runner_plock_hash_pos(moved->cart, moved->param_id);
+        *slot = *moved;
+        if (pos < SEQ_ENGINE_RUNNER_PLOCK_HASH_SIZE) {
+            s_plock_hash[pos] = (uint16_t)(index + 1U);
         }
     }
+    s_plock_count = last;
+    seq_engine_runner_plock_stats.active = s_plock_count;
+}
 
-    return NULL;
+/* Start a ramp of @p slot to @p to over one step from @p due (or queue it behind
+   the running one); @p plain queues a plain lock instead. False when no ramp
+   entry is free: the caller sends a plain lock. */
+static bool _runner_slide_start(seq_engine_runner_plock_state_t *slot, uint8_t to, systime_t due, bool plain) {
+    if (slot->sliding) {
+        for (uint8_t i = 0U; i < s_slide_count; ++i) {
+            seq_engine_runner_slide_t *ramp = &s_slides[i];
+            if ((ramp->param_id == slot->param_id) && (ramp->cart == slot->cart)) {
+                ramp->next_start = due;
+                ramp->next_span = plain ? 0U : s_step_st;
+                ramp->next_to = to;
+                ramp->queued = true;
+                slot->value = to;
+                if (!plain) {
+                    seq_engine_runner_plock_stats.slides++;
+                }
+                return true;
+            }
+        }
+        slot->sliding = false; /* not found: fall through to a new ramp */
+    }
+    if (plain || (s_slide_count >= SEQ_ENGINE_RUNNER_MAX_SLIDES)) {
+        if (!plain) {
+            seq_engine_runner_plock_stats.slides_dropped++;
+        }
+        return false;
+    }
+
+    const uint8_t from = (slot->value == SEQ_ENGINE_RUNNER_PLOCK_VALUE_UNKNOWN) ? slot->previous : slot->value;
+    seq_engine_runner_slide_t *ramp = &s_slides[s_slide_count++];
+    ramp->start = due;
+    ramp->span = s_step_st;
+    ramp->param_id = slot->param_id;
+    ramp->cart = slot->cart;
+    ramp->from = from;
+    ramp->to = to;
+    ramp->last = from;
+    ramp->queued = false;
+    ramp->finished = false;
+    slot->value = to;
+    slot->sliding = true;
+    seq_engine_runner_plock_stats.slides++;
+    return true;
 }
 
-static void _runner_plock_release(seq_engine_runner_plock_state_t *slot) {
-    if (slot == NULL) {
+/* Stop the ramp of @p slot where it stands: `value` becomes what the cart holds. */
+static void _runner_slide_cancel(seq_engine_runner_plock_state_t *slot) {
+    if (!slot->sliding) {
         return;
     }
-    slot->active = false;
-    slot->cart = (cart_id_t)0U;
-    slot->param_id = 0U;
-    slot->depth = 0U;
-    slot->previous = 0U;
+    slot->sliding = false;
+    for (uint8_t i = 0U; i < s_slide_count; ++i) {
+        if ((s_slides[i].param_id == slot->param_id) && (s_slides[i].cart == slot->cart)) {
+            slot->value = s_slides[i].last;
+            _runner_slide_remove(i);
+            return;
+        }
+    }
+}
+
+static void _runner_slide_remove(uint8_t index) {
+    s_slide_count--;
+    if (index != s_slide_count) {
+        s_slides[index] = s_slides[s_slide_count];
+    }
+    if (s_slide_cursor >= s_slide_count) {
+        s_slide_cursor = 0U;
+    }
+}
+
+/* Step boundary: grant the next step its share of the cart link, minus the
+   lock and restore frames planned for it. */
+static void _runner_slide_open_budget(const clock_step_info_t *info) {
+    const uint64_t link = ((uint64_t)(CART_UART_BAUD / 10U) * (uint64_t)info->step_st) / CH_CFG_ST_FREQUENCY;
+    const uint64_t share = (link * SEQ_ENGINE_RUNNER_SLIDE_LINK_PCT) / 100U;
+    s_slide_budget = (share > s_step_lock_bytes) ? (uint32_t)(share - s_step_lock_bytes) : 0U;
+    s_step_lock_bytes = 0U;
+    s_slide_ticks_left = (info->tick_st > 0U) ? (uint8_t)(info->step_st / info->tick_st) : 1U;
+    if (s_slide_ticks_left == 0U) {
+        s_slide_ticks_left = 1U;
+    }
+    seq_engine_runner_plock_stats.slide_budget = s_slide_budget;
+}
+
+/* Tick: move every ramp to its current value. The budget left is spread over
+   the remaining ticks; an intermediate frame that does not fit is skipped
+   (the ramp jumps further on a later tick), the final value always goes out.
+   Service starts at the first ramp skipped last time so none starves. */
+static void _runner_service_slides(systime_t now) {
+    uint32_t allowance = s_slide_budget / s_slide_ticks_left;
+    if (s_slide_ticks_left > 1U) {
+        s_slide_ticks_left--;
+    }
+
+    const uint8_t count = s_slide_count;
+    const uint8_t first = s_slide_cursor;
+    bool skipped = false;
+    for (uint8_t n = 0U; n < count; ++n) {
+        const uint8_t i = (uint8_t)((first + n) % count);
+        seq_engine_runner_slide_t *ramp = &s_slides[i];
+        if (ramp->finished) {
+            continue;
+        }
+        const int32_t elapsed = _runner_time_diff(now, ramp->start);
+        if (elapsed <= 0) {
+            continue;
+        }
+        const bool done = (ramp->span == 0U) || (elapsed >= (int32_t)ramp->span);
+        const uint8_t value = done ? ramp->to
+                                   : (uint8_t)((int32_t)ramp->from +
+                                               ((((int32_t)ramp->to - (int32_t)ramp->from) * elapsed) /
+                                                (int32_t)ramp->span));
+        if (value != ramp->last) {
+            const uint32_t cost = (uint32_t)cart_proto_set_size(ramp->param_id);
+            if (!done && (cost > allowance)) {
+                seq_engine_runner_plock_stats.slide_skipped++;
+                if (!skipped) {
+                    s_slide_cursor = i;
+                    skipped = true;
+                }
+                continue;
+            }
+            cart_link_param_send(ramp->param_id, value, CART_CLASS_SEQ);
+            ramp->last = value;
+            allowance = (allowance > cost) ? (allowance - cost) : 0U;
+            s_slide_budget = (s_slide_budget > cost) ? (s_slide_budget - cost) : 0U;
+            seq_engine_runner_plock_stats.slide_frames++;
+        }
+        if (done) {
+            if (ramp->queued) {
+                ramp->from = ramp->last;
+                ramp->to = ramp->next_to;
+                ramp->start = ramp->next_start;
+                ramp->span = ramp->next_span;
+                ramp->queued = false;
+            } else {
+                ramp->finished = true;
+            }
+        }
+    }
+    if (!skipped) {
+        s_slide_cursor = 0U;
+    }
+
+    for (uint8_t i = s_slide_count; i-- > 0U;) {
+        if (s_slides[i].finished) {
+            seq_engine_runner_plock_state_t *slot =
+                _runner_plock_find((cart_id_t)s_slides[i].cart, s_slides[i].param_id);
+            if (slot != NULL) {
+                slot->sliding = false;
+            }
+            _runner_slide_remove(i);
+        }
+    }
 }
@@ -7,6 +7,7 @@
  */
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "clock_manager.h"
 
@@ -14,10 +15,71 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Held cart p-lock table statistics (diagnostic).
+ *
+ * Held p-locks are indexed by (cart, param_id): a 512-bit presence map per
+ * cart and an open-addressed index over a dense slot array, sized to the
+ * worst case (every parameter of the active cart).
+ *
+ * Only transitions reach the cart bus: a lock equal to the value already
+ * scheduled is absorbed, and a parameter is restored once, at the end of the
+ * first step that no longer locks it.
+ *
+ * Slide locks ramp the parameter to their value over the step. Their
+ * intermediate frames share a fraction of the cart link (CART_UART_BAUD over
+ * the step duration) left after the step's own lock and restore frames.
+ */
+typedef struct {
+    uint16_t active;         /**< P-locks currently held. */
+    uint16_t high_water;     /**< Maximum of `active`. */
+    uint16_t probe_max;      /**< Longest index probe on insertion. */
+    uint32_t exhausted;      /**< P-locks dropped because the table was full. */
+    uint32_t out_of_range;   /**< P-locks dropped: parameter outside the cart map. */
+    uint32_t sent;           /**< Lock values scheduled for the cart. */
+    uint32_t unchanged;      /**< Locks absorbed: value already scheduled. */
+    uint32_t restores;       /**< Pre-lock values written back. */
+    uint32_t collisions;     /**< Same parameter locked by two tracks on one step (lowest track wins). */
+    uint32_t slides;         /**< Slide locks started (ramp over their step). */
+    uint32_t slides_dropped; /**< Slide locks sent as plain locks: every ramp in use. */
+    uint32_t slide_frames;   /**< Ramp frames sent (intermediate and final values). */
+    uint32_t slide_skipped;  /**< Intermediate ramp frames skipped for lack of link budget. */
+    uint32_t slide_budget;   /**< Bytes granted to ramps for the current step. */
+} seq_engine_runner_plock_stats_t;
+
+extern seq_engine_runner_plock_stats_t seq_engine_runner_plock_stats;
+
+/**
+ * @brief Chase statistics (diagnostic).
+ *
+ * Playback that starts away from step 0 (locate + Continue, SPP from a master)
+ * rebuilds the notes that should still be sounding at that step: each track's
+ * occupancy bitset is scanned backwards from the step, one occupied step at a
+ * time, until every voice slot is resolved or one maximum note length back.
+ */
+typedef struct {
+    uint32_t chases;        /**< Starts that ran a chase. */
+    uint32_t notes;         /**< Sustained voices sent again by the chase. */
+    uint16_t steps_visited; /**< Occupied steps read by the last chase, all tracks. */
+} seq_engine_runner_chase_stats_t;
+
+extern seq_engine_runner_chase_stats_t seq_engine_runner_chase_stats;
+
 void seq_engine_runner_init(void);
+/** Transport start or continue: the first step played chases the state at its position. */
 void seq_engine_runner_on_transport_play(void);
 void seq_engine_runner_on_transport_stop(void);
 void seq_engine_runner_on_clock_step(const clock_step_info_t *info);
+/** Release the scheduled events due at @p now (called on every 24 PPQN tick). */
+void seq_engine_runner_on_clock_tick(systime_t now);
+/**
+ * @brief Release the events due at @p now between two ticks (clock_seq service).
+ * @param next_due Release time of the next pending event.
+ * @return false when nothing is pending (@p next_due untouched).
+ */
+bool seq_engine_runner_service(systime_t now, systime_t *next_due);
+/** Reset the p-lock counters; `active` and `high_water` restart from the current load. */
+void seq_engine_runner_plock_stats_reset(void);
 
 #ifdef __cplusplus
 }
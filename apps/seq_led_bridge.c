@@ -66,6 +66,8 @@ typedef struct {
     uint8_t              track_index;   /**< Currently bound track (for future multi-track). */
     uint8_t              track_count;   /**< Active track count (project view). */
     seq_led_bridge_hold_view_t hold;    /**< Aggregated hold/tweak snapshot. */
+    seq_model_track_t   *write_track;   /**< Piste verrouillée par la section d'écriture ouverte. */
+    uint8_t              write_depth;   /**< Imbrication des sections d'écriture. */
 } seq_led_bridge_state_t;
 
 static CCM_DATA seq_led_bridge_state_t g;
@@ -92,15 +94,13 @@ static void _cache_refresh_hold_slots(uint16_t base_step) {
 #if SEQ_USE_HANDLES
     seq_track_handle_t active =
         seq_reader_make_handle(g_cache.active_bank, g_cache.active_pattern, g.track_index);
-    for (uint8_t local = 0U; local < SEQ_LED_BRIDGE_STEPS_PER_PAGE; ++local) {
-        const uint16_t absolute = base_step + (uint16_t)local;
-        if (!_valid_step_index(absolute)) {
-            break;
-        }
-        seq_step_view_t view;
-        if (seq_reader_get_step(active, (uint8_t)absolute, &view)) {
-            g_cache.hold_slots[local] = view.flags;
-        }
+    uint8_t count = 0U;
+    while ((count < SEQ_LED_BRIDGE_STEPS_PER_PAGE) && _valid_step_index((uint16_t)(base_step + count))) {
+        ++count;
+    }
+    if (count != 0U) {
+        /* Une page = une copie contiguë du tableau de flags du plan (SoA). */
+        (void)seq_reader_get_step_flags(active, (uint8_t)base_step, count, g_cache.hold_slots);
     }
 #else
     const seq_model_track_t *track = _seq_led_bridge_track_const();
@@ -135,12 +135,35 @@ static inline seq_project_t *_seq_led_bridge_project(void) {
     return g.project;
 }
 
+/* Résolu via le projet : le jeu de pistes lié change à chaque bascule de pattern.
+   Pendant une section d'écriture, on reste sur la piste verrouillée. */
 static inline seq_model_track_t *_seq_led_bridge_track(void) {
-    return g.track;
+    if (g.write_depth > 0U) {
+        return g.write_track;
+    }
+    return (g.project != NULL) ? seq_project_get_active_track(g.project) : g.track;
+}
+
+/* Section d'écriture seqlock sur la piste active : le runner (thread clock) lit la
+   piste sans verrou et rejette toute lecture qui chevauche la section. Ré-entrante. */
+static void _track_write_begin(void) {
+    if (g.write_depth++ > 0U) {
+        return;
+    }
+    g.write_track = (g.project != NULL) ? seq_project_get_active_track(g.project) : g.track;
+    seq_model_gen_write_begin((g.write_track != NULL) ? &g.write_track->generation : NULL);
+}
+
+static void _track_write_end(void) {
+    if ((g.write_depth == 0U) || (--g.write_depth > 0U)) {
+        return;
+    }
+    seq_model_gen_write_end((g.write_track != NULL) ? &g.write_track->generation : NULL);
+    g.write_track = NULL;
 }
 
 static inline const seq_model_track_t *_seq_led_bridge_track_const(void) {
-    return g.track;
+    return _seq_led_bridge_track();
 }
 
 static inline void _seq_led_bridge_bump_generation(void) {
@@ -168,6 +191,10 @@ UI_RAM_AUDIT(g_hold_slots);
 const size_t g_hold_slots_size = sizeof(g_hold_slots);
 #undef SEQ_LED_BRIDGE_HOLD_SLOTS_SEC
 
+/* Arène des p-locks des steps en édition (mêmes dimensions que celle d’une piste). */
+static CCM_DATA seq_model_plock_pool_t g_hold_plocks;
+UI_RAM_AUDIT(g_hold_plocks);
+
 #ifndef SEQ_LED_BRIDGE_MAX_CART_PARAMS
 #define SEQ_LED_BRIDGE_MAX_CART_PARAMS 32U
 #endif
@@ -246,6 +273,16 @@ static inline void _clear_step_voices(seq_model_step_t *step) {
 
 static void _hold_slots_clear(void) {
     memset(g_hold_slots, 0, sizeof(g_hold_slots));
+    seq_model_plock_pool_init(&g_hold_plocks);
+}
+
+/* Arène qui porte les p-locks du step édité : celle des slots si le step est en hold. */
+static seq_model_plock_pool_t *_hold_pool(const seq_led_bridge_hold_slot_t *slot) {
+    if (slot != NULL) {
+        return &g_hold_plocks;
+    }
+    seq_model_track_t *track = _seq_led_bridge_track();
+    return (track != NULL) ? &track->plocks : NULL;
 }
 
 static void _hold_cart_reset(void) {
@@ -253,17 +290,22 @@ static void _hold_cart_reset(void) {
     g_hold_cart_param_count = 0U;
 }
 
-static uint8_t _resolve_step_note(const seq_model_step_t *step, uint8_t voice, uint8_t fallback) {
+static uint8_t _resolve_step_note(const seq_model_step_t *step,
+                                  const seq_model_plock_pool_t *pool,
+                                  uint8_t voice,
+                                  uint8_t fallback) {
     if (step == NULL) {
         return fallback;
     }
 
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        const seq_model_plock_t *plk = &step->plocks[i];
-        if ((plk->domain == SEQ_MODEL_PLOCK_INTERNAL) &&
-            (plk->internal_param == SEQ_MODEL_PLOCK_PARAM_NOTE) &&
-            (plk->voice_index == voice)) {
-            int32_t value = plk->value;
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if ((plk.domain == SEQ_MODEL_PLOCK_INTERNAL) &&
+            (plk.internal_param == SEQ_MODEL_PLOCK_PARAM_NOTE) &&
+            (plk.voice_index == voice)) {
+            int32_t value = plk.value;
             if (value < 0) {
                 value = 0;
             } else if (value > 127) {
@@ -276,7 +318,7 @@ static uint8_t _resolve_step_note(const seq_model_step_t *step, uint8_t voice, u
     return fallback;
 }
 
-static bool _ensure_primary_voice_for_seq(seq_model_step_t *step) {
+static bool _ensure_primary_voice_for_seq(seq_model_step_t *step, const seq_model_plock_pool_t *pool) {
     if (step == NULL) {
         return false;
     }
@@ -288,7 +330,7 @@ static bool _ensure_primary_voice_for_seq(seq_model_step_t *step) {
     if ((voice.state != SEQ_MODEL_VOICE_ENABLED) || (voice.velocity == 0U)) {
         fallback = (g.last_note <= 127U) ? g.last_note : 60U;
     }
-    uint8_t desired_note = _resolve_step_note(step, 0U, fallback);
+    uint8_t desired_note = _resolve_step_note(step, pool, 0U, fallback);
     if (voice.note != desired_note) {
         voice.note = desired_note;
         mutated = true;
@@ -325,8 +367,12 @@ static bool _hold_commit_slot(uint8_t local) {
     bool mutated = slot->mutated;
     seq_model_track_t *track = _seq_led_bridge_track();
     if ((track != NULL) && mutated && _valid_step_index(slot->absolute_index)) {
-        track->steps[slot->absolute_index] = slot->staged;
+        /* Arène de la piste pleine : l’édition est abandonnée, le step reste intact. */
+        _track_write_begin();
+        mutated = seq_model_step_copy(&track->steps[slot->absolute_index], &track->plocks,
+                                      &slot->staged, &g_hold_plocks);
         seq_model_step_recompute_flags(&track->steps[slot->absolute_index]);
+        _track_write_end();
         const seq_model_voice_t *voice =
             seq_model_step_get_voice(&track->steps[slot->absolute_index], 0U);
         if ((voice != NULL) &&
@@ -335,6 +381,7 @@ static bool _hold_commit_slot(uint8_t local) {
         }
     }
 
+    seq_model_step_clear_plocks(&slot->staged, &g_hold_plocks);
     memset(slot, 0, sizeof(*slot));
     return mutated;
 }
@@ -378,9 +425,13 @@ static seq_led_bridge_hold_slot_t *_hold_resolve_slot(uint8_t local, bool ensure
         return NULL;
     }
 
+    seq_model_step_clear_plocks(&slot->staged, &g_hold_plocks);
+    if (!seq_model_step_copy(&slot->staged, &g_hold_plocks, &track->steps[absolute], &track->plocks)) {
+        memset(slot, 0, sizeof(*slot));
+        return NULL;
+    }
     slot->active = true;
     slot->absolute_index = absolute;
-    slot->staged = track->steps[absolute];
     slot->mutated = false;
     return slot;
 }
@@ -424,7 +475,8 @@ static void _hold_sync_mask(uint16_t mask) {
     g.page_hold_mask[g.visible_page] = mask & 0xFFFFu;
 }
 
-static const seq_model_step_t *_hold_step_for_view(uint8_t local, uint16_t absolute) {
+static const seq_model_step_t *_hold_step_for_view(uint8_t local, uint16_t absolute,
+                                                    const seq_model_plock_pool_t **pool) {
     if (!_valid_step_index(absolute)) {
         return NULL;
     }
@@ -437,12 +489,14 @@ static const seq_model_step_t *_hold_step_for_view(uint8_t local, uint16_t absol
 
     const seq_led_bridge_hold_slot_t *slot = &slots[local];
     if (slot->active && slot->absolute_index == absolute) {
+        *pool = &g_hold_plocks;
         return &slot->staged;
     }
     const seq_model_track_t *track = _seq_led_bridge_track_const();
     if (track == NULL) {
         return NULL;
     }
+    *pool = &track->plocks;
     return &track->steps[absolute];
 }
 
@@ -507,6 +561,7 @@ static seq_hold_param_id_t _hold_param_for_internal(seq_model_plock_internal_par
 }
 
 static void _hold_collect_step(const seq_model_step_t *step,
+                               const seq_model_plock_pool_t *pool,
                                bool present[SEQ_HOLD_PARAM_COUNT],
                                bool plocked[SEQ_HOLD_PARAM_COUNT],
                                int32_t values[SEQ_HOLD_PARAM_COUNT]) {
@@ -537,46 +592,50 @@ static void _hold_collect_step(const seq_model_step_t *step,
         values[base + 3U] = v->micro_offset;
     }
 
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        const seq_model_plock_t *plk = &step->plocks[i];
-        if (plk->domain != SEQ_MODEL_PLOCK_INTERNAL) {
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if (plk.domain != SEQ_MODEL_PLOCK_INTERNAL) {
             continue;
         }
-        if (plk->voice_index >= SEQ_MODEL_VOICES_PER_STEP) {
+        if (plk.voice_index >= SEQ_MODEL_VOICES_PER_STEP) {
             continue;
         }
         const seq_hold_param_id_t pid =
-            _hold_param_for_internal(plk->internal_param, plk->voice_index);
+            _hold_param_for_internal(plk.internal_param, plk.voice_index);
         if (pid >= SEQ_HOLD_PARAM_COUNT) {
             continue;
         }
         present[pid] = true;
         plocked[pid] = true;
-        values[pid] = plk->value;
+        values[pid] = plk.value;
     }
 }
 
-static void _hold_collect_cart_plocks(const seq_model_step_t *step) {
+static void _hold_collect_cart_plocks(const seq_model_step_t *step, const seq_model_plock_pool_t *pool) {
     if (step == NULL) {
         return;
     }
 
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        const seq_model_plock_t *plk = &step->plocks[i];
-        if (plk->domain != SEQ_MODEL_PLOCK_CART) {
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if (plk.domain != SEQ_MODEL_PLOCK_CART) {
             continue;
         }
         seq_led_bridge_hold_cart_entry_t *entry =
-            _hold_cart_entry_get(plk->parameter_id, true);
+            _hold_cart_entry_get(plk.parameter_id, true);
         if (entry == NULL) {
             continue;
         }
         entry->match_count++;
         if (!entry->view.available) {
             entry->view.available = true;
-            entry->view.value = plk->value;
+            entry->view.value = plk.value;
             entry->view.mixed = false;
-        } else if (entry->view.value != plk->value) {
+        } else if (entry->view.value != plk.value) {
             entry->view.mixed = true;
         }
     }
@@ -607,13 +666,14 @@ static void _hold_update(uint16_t mask) {
         if (!_valid_step_index(absolute)) {
             continue;
         }
-        const seq_model_step_t *step = _hold_step_for_view(local, absolute);
+        const seq_model_plock_pool_t *pool = NULL;
+        const seq_model_step_t *step = _hold_step_for_view(local, absolute, &pool);
 
         bool present[SEQ_HOLD_PARAM_COUNT] = { false };
         bool step_plocked[SEQ_HOLD_PARAM_COUNT] = { false };
         int32_t step_values[SEQ_HOLD_PARAM_COUNT] = { 0 };
-        _hold_collect_step(step, present, step_plocked, step_values);
-        _hold_collect_cart_plocks(step);
+        _hold_collect_step(step, pool, present, step_plocked, step_values);
+        _hold_collect_cart_plocks(step, pool);
 
         if (first) {
             for (uint8_t i = 0U; i < SEQ_HOLD_PARAM_COUNT; ++i) {
@@ -711,24 +771,29 @@ static int32_t _clamp_i32(int32_t value, int32_t min, int32_t max) {
 }
 
 static bool _ensure_internal_plock_value(seq_model_step_t *step,
+                                         seq_model_plock_pool_t *pool,
                                          seq_model_plock_internal_param_t param,
                                          uint8_t voice,
                                          int32_t value) {
-    if (step == NULL) {
+    if ((step == NULL) || (pool == NULL)) {
         return false;
     }
     const int16_t casted = (int16_t)value;
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        seq_model_plock_t *plk = &step->plocks[i];
-        if ((plk->domain == SEQ_MODEL_PLOCK_INTERNAL) &&
-            (plk->internal_param == param) &&
-            (plk->voice_index == voice)) {
-            if (plk->value != casted) {
-                plk->value = casted;
-                return true;
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    size_t index = 0U;
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if ((plk.domain == SEQ_MODEL_PLOCK_INTERNAL) &&
+            (plk.internal_param == param) &&
+            (plk.voice_index == voice)) {
+            if (plk.value != casted) {
+                plk.value = casted;
+                return seq_model_step_set_plock(step, pool, index, &plk);
             }
             return false;
         }
+        ++index;
     }
 
     if (step->plock_count >= SEQ_MODEL_MAX_PLOCKS_PER_STEP) {
@@ -743,27 +808,32 @@ static bool _ensure_internal_plock_value(seq_model_step_t *step,
         .internal_param = param
     };
 
-    return seq_model_step_add_plock(step, &plock);
+    return seq_model_step_add_plock(step, pool, &plock);
 }
 
 static bool _ensure_cart_plock_value(seq_model_step_t *step,
+                                     seq_model_plock_pool_t *pool,
                                      uint16_t parameter_id,
                                      uint8_t track,
                                      int32_t value) {
-    if (step == NULL) {
+    if ((step == NULL) || (pool == NULL)) {
         return false;
     }
 
     const int16_t casted = (int16_t)value;
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        seq_model_plock_t *plk = &step->plocks[i];
-        if ((plk->domain == SEQ_MODEL_PLOCK_CART) && (plk->parameter_id == parameter_id)) {
-            if (plk->value != casted) {
-                plk->value = casted;
-                return true;
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    size_t index = 0U;
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if ((plk.domain == SEQ_MODEL_PLOCK_CART) && (plk.parameter_id == parameter_id)) {
+            if (plk.value != casted) {
+                plk.value = casted;
+                return seq_model_step_set_plock(step, pool, index, &plk);
             }
             return false;
         }
+        ++index;
     }
 
     if (step->plock_count >= SEQ_MODEL_MAX_PLOCKS_PER_STEP) {
@@ -778,7 +848,7 @@ static bool _ensure_cart_plock_value(seq_model_step_t *step,
         .internal_param = SEQ_MODEL_PLOCK_PARAM_NOTE,
     };
 
-    return seq_model_step_add_plock(step, &plock);
+    return seq_model_step_add_plock(step, pool, &plock);
 }
 
 static void _update_preview_mask(void) {
@@ -807,6 +877,11 @@ static void _rebuild_runtime_from_track(void) {
 
     const uint16_t base = _page_base(g.visible_page);
     _cache_refresh_hold_slots(base);
+#if SEQ_USE_HANDLES
+    uint8_t page_flags[SEQ_LED_BRIDGE_STEPS_PER_PAGE];
+    const bool page_ok = (base < SEQ_MODEL_STEPS_PER_TRACK) &&
+                         seq_reader_get_step_flags(handle, (uint8_t)base, SEQ_LED_BRIDGE_STEPS_PER_PAGE, page_flags);
+#endif
     for (uint8_t local = 0U; local < SEQ_LED_BRIDGE_STEPS_PER_PAGE; ++local) {
         const uint16_t absolute = base + (uint16_t)local;
         seq_step_state_t *dst = &g.rt.steps[local];
@@ -817,11 +892,10 @@ static void _rebuild_runtime_from_track(void) {
         }
 
 #if SEQ_USE_HANDLES
-        seq_step_view_t view;
-        if (!seq_reader_get_step(handle, (uint8_t)absolute, &view)) {
+        if (!page_ok) {
             continue;
         }
-        const uint8_t step_flags = view.flags;
+        const uint8_t step_flags = page_flags[local];
         const bool has_voice = (step_flags & SEQ_STEPF_HAS_VOICE) != 0U;
         const bool has_seq_plock = (step_flags & SEQ_STEPF_HAS_SEQ_PLOCK) != 0U;
         const bool has_cart_plock = (step_flags & SEQ_STEPF_HAS_CART_PLOCK) != 0U;
@@ -964,6 +1038,24 @@ void seq_led_bridge_publish(void) {
     _publish_runtime();
 }
 
+void seq_led_bridge_on_pattern_swap(void) {
+    /* Les steps maintenus appartenaient au pattern sortant : l'édition en cours est abandonnée. */
+    _hold_slots_clear();
+    _hold_cart_reset();
+    g.hold.active = false;
+    g.hold.mask = 0U;
+    memset(g.hold.params, 0, sizeof(g.hold.params));
+    memset(g.page_hold_mask, 0, sizeof(g.page_hold_mask));
+    g.preview_mask = 0U;
+
+    seq_model_track_t *track_model = _seq_led_bridge_track();
+    if (track_model != NULL) {
+        seq_recorder_attach_track(track_model);
+    }
+
+    _publish_runtime();
+}
+
 void seq_led_bridge_set_max_pages(uint8_t max_pages) {
     if (max_pages == 0U) {
         max_pages = 1U;
@@ -1039,10 +1131,11 @@ void seq_led_bridge_step_clear(uint8_t i) {
     if (step == NULL) {
         return;
     }
+    _track_write_begin();
+    seq_model_step_clear_plocks(step, &_seq_led_bridge_track()->plocks);
     seq_model_step_init(step);
     _clear_step_voices(step);
-    seq_model_step_clear_plocks(step);
-    _seq_led_bridge_bump_generation();
+    _track_write_end();
     _hold_refresh_if_active();
 }
 
@@ -1059,14 +1152,15 @@ void seq_led_bridge_step_set_voice(uint8_t i, uint8_t voice_idx, uint8_t pitch,
     voice.note = pitch;
     voice.velocity = velocity;
     voice.state = (velocity > 0U) ? SEQ_MODEL_VOICE_ENABLED : SEQ_MODEL_VOICE_DISABLED;
+    _track_write_begin();
     step->voices[voice_idx] = voice;
     seq_model_step_recompute_flags(step);
+    _track_write_end();
     if (seq_model_step_has_playable_voice(step) &&
         (voice_idx == 0U) &&
         (voice.state == SEQ_MODEL_VOICE_ENABLED) && (voice.velocity > 0U)) {
         g.last_note = voice.note;
     }
-    _seq_led_bridge_bump_generation();
     _hold_refresh_if_active();
 }
 
@@ -1077,6 +1171,9 @@ void seq_led_bridge_step_set_has_plock(uint8_t i, bool on) {
         return;
     }
 
+    if (slot == NULL) {
+        _track_write_begin();
+    }
     bool mutated = false;
     if (on) {
         const bool has_voice = seq_model_step_has_playable_voice(step);
@@ -1086,7 +1183,7 @@ void seq_led_bridge_step_set_has_plock(uint8_t i, bool on) {
             mutated = true;
         }
     } else if (step->plock_count > 0U) {
-        seq_model_step_clear_plocks(step);
+        seq_model_step_clear_plocks(step, _hold_pool(slot));
         mutated = true;
     }
 
@@ -1094,10 +1191,11 @@ void seq_led_bridge_step_set_has_plock(uint8_t i, bool on) {
         seq_model_step_recompute_flags(step);
         if (slot != NULL) {
             slot->mutated = true;
-        } else {
-            _seq_led_bridge_bump_generation();
         }
     }
+    if (slot == NULL) {
+        _track_write_end();
+    }
     _hold_refresh_if_active();
 }
 
@@ -1113,12 +1211,13 @@ void seq_led_bridge_quick_toggle_step(uint8_t i) {
     if (was_on) {
         seq_led_bridge_step_clear(i);
     } else {
+        _track_write_begin();
         seq_model_step_init_default(step, g.last_note);
+        _track_write_end();
         const seq_model_voice_t *voice = seq_model_step_get_voice(step, 0U);
         if (voice != NULL) {
             g.last_note = voice->note;
         }
-        _seq_led_bridge_bump_generation();
         _hold_refresh_if_active();
         // --- FIX: suppression du step preview MIDI pour éviter les notes parasites ---
     }
@@ -1132,6 +1231,9 @@ void seq_led_bridge_set_step_param_only(uint8_t i, bool on) {
         return;
     }
 
+    if (slot == NULL) {
+        _track_write_begin();
+    }
     bool mutated = false;
     if (on) {
         const bool has_voice = seq_model_step_has_playable_voice(step);
@@ -1141,7 +1243,7 @@ void seq_led_bridge_set_step_param_only(uint8_t i, bool on) {
             mutated = true;
         }
     } else if (step->plock_count > 0U) {
-        seq_model_step_clear_plocks(step);
+        seq_model_step_clear_plocks(step, _hold_pool(slot));
         mutated = true;
     }
 
@@ -1149,10 +1251,11 @@ void seq_led_bridge_set_step_param_only(uint8_t i, bool on) {
         seq_model_step_recompute_flags(step);
         if (slot != NULL) {
             slot->mutated = true;
-        } else {
-            _seq_led_bridge_bump_generation();
         }
     }
+    if (slot == NULL) {
+        _track_write_end();
+    }
     _hold_refresh_if_active();
     seq_led_bridge_publish();
 }
@@ -1205,13 +1308,19 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
     }
 
     bool mutated_track = false;
+    bool locked = false;
 
     for (uint8_t i = 0U; i < SEQ_LED_BRIDGE_STEPS_PER_PAGE; ++i) {
         if ((held_mask & (1U << i)) == 0U) {
             continue;
         }
         seq_led_bridge_hold_slot_t *slot = _hold_resolve_slot(i, true);
+        if ((slot == NULL) && !locked) {
+            _track_write_begin(); /* écriture directe dans la piste live */
+            locked = true;
+        }
         seq_model_step_t *step = (slot != NULL) ? &slot->staged : _step_from_page(i);
+        seq_model_plock_pool_t *pool = _hold_pool(slot);
         if (step == NULL) {
             continue;
         }
@@ -1223,7 +1332,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
             if (!had_plock) {
                 seq_model_step_make_neutral(step);
                 step_mutated = true;
-            } else if (_ensure_primary_voice_for_seq(step)) {
+            } else if (_ensure_primary_voice_for_seq(step, pool)) {
                 step_mutated = true;
             }
         }
@@ -1235,16 +1344,16 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                     step->offsets.transpose = (int8_t)v;
                     step_mutated = true;
                 }
-                step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_GLOBAL_TR, 0U, v);
+                step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_GLOBAL_TR, 0U, v);
                 break;
             }
             case SEQ_HOLD_PARAM_ALL_VEL: {
                 int32_t v = _clamp_i32(value, -127, 127);
                 if (step->offsets.velocity != v) {
-                    step->offsets.velocity = (int16_t)v;
+                    step->offsets.velocity = (int8_t)v;
                     step_mutated = true;
                 }
-                step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_GLOBAL_VE, 0U, v);
+                step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_GLOBAL_VE, 0U, v);
                 break;
             }
             case SEQ_HOLD_PARAM_ALL_LEN: {
@@ -1253,7 +1362,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                     step->offsets.length = (int8_t)v;
                     step_mutated = true;
                 }
-                step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_GLOBAL_LE, 0U, v);
+                step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_GLOBAL_LE, 0U, v);
                 break;
             }
             case SEQ_HOLD_PARAM_ALL_MIC: {
@@ -1262,7 +1371,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                     step->offsets.micro = (int8_t)v;
                     step_mutated = true;
                 }
-                step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_GLOBAL_MI, 0U, v);
+                step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_GLOBAL_MI, 0U, v);
                 break;
             }
             default: {
@@ -1284,7 +1393,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                             voice_state.note = (uint8_t)v;
                             step_mutated = true;
                         }
-                        step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_NOTE, voice, v);
+                        step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_NOTE, voice, v);
                         if ((voice == 0U) &&
                             (voice_state.state == SEQ_MODEL_VOICE_ENABLED) &&
                             (voice_state.velocity > 0U)) {
@@ -1300,7 +1409,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                             step_mutated = true;
                         }
                         voice_state.state = (voice_state.velocity > 0U) ? SEQ_MODEL_VOICE_ENABLED : SEQ_MODEL_VOICE_DISABLED;
-                        step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_VELOCITY, voice, v);
+                        step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_VELOCITY, voice, v);
                         break;
                     }
                     case 2: { /* Length */
@@ -1309,7 +1418,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                             voice_state.length = (uint8_t)v;
                             step_mutated = true;
                         }
-                        step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_LENGTH, voice, v);
+                        step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_LENGTH, voice, v);
                         break;
                     }
                     case 3: { /* Micro */
@@ -1318,7 +1427,7 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
                             voice_state.micro_offset = (int8_t)v;
                             step_mutated = true;
                         }
-                        step_mutated |= _ensure_internal_plock_value(step, SEQ_MODEL_PLOCK_PARAM_MICRO, voice, v);
+                        step_mutated |= _ensure_internal_plock_value(step, pool, SEQ_MODEL_PLOCK_PARAM_MICRO, voice, v);
                         break;
                     }
                     default:
@@ -1339,7 +1448,9 @@ void seq_led_bridge_apply_plock_param(seq_hold_param_id_t param_id,
         }
     }
 
-    if (mutated_track) {
+    if (locked) {
+        _track_write_end();
+    } else if (mutated_track) {
         _seq_led_bridge_bump_generation();
     }
 
@@ -1385,6 +1496,7 @@ void seq_led_bridge_apply_cart_param(uint16_t parameter_id,
     }
 
     bool mutated_track = false;
+    bool locked = false;
 
     for (uint8_t i = 0U; i < SEQ_LED_BRIDGE_STEPS_PER_PAGE; ++i) {
         if ((held_mask & (1U << i)) == 0U) {
@@ -1392,7 +1504,12 @@ void seq_led_bridge_apply_cart_param(uint16_t parameter_id,
         }
 
         seq_led_bridge_hold_slot_t *slot = _hold_resolve_slot(i, true);
+        if ((slot == NULL) && !locked) {
+            _track_write_begin(); /* écriture directe dans la piste live */
+            locked = true;
+        }
         seq_model_step_t *step = (slot != NULL) ? &slot->staged : _step_from_page(i);
+        seq_model_plock_pool_t *pool = _hold_pool(slot);
         if (step == NULL) {
             continue;
         }
@@ -1409,7 +1526,7 @@ void seq_led_bridge_apply_cart_param(uint16_t parameter_id,
             }
         }
 
-        if (_ensure_cart_plock_value(step, parameter_id, track, value)) {
+        if (_ensure_cart_plock_value(step, pool, parameter_id, track, value)) {
             if (slot != NULL) {
                 slot->mutated = true;
             } else {
@@ -1420,7 +1537,9 @@ void seq_led_bridge_apply_cart_param(uint16_t parameter_id,
         seq_model_step_recompute_flags(step);
     }
 
-    if (mutated_track) {
+    if (locked) {
+        _track_write_end();
+    } else if (mutated_track) {
         _seq_led_bridge_bump_generation();
     }
 
@@ -24,6 +24,8 @@ extern "C" {
 void seq_led_bridge_init(void);
 void seq_led_bridge_bind_project(seq_project_t *project);
 void seq_led_bridge_publish(void);
+/** Recale le bridge après une bascule de pattern (thread UI) : hold abandonné, recorder rattaché. */
+void seq_led_bridge_on_pattern_swap(void);
 
 void seq_led_bridge_set_max_pages(uint8_t max_pages);
 void seq_led_bridge_set_total_span(uint16_t total_steps);
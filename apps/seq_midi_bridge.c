@@ -2,31 +2,47 @@
 #include <stdint.h>
 #include "midi/midi.h"   // pile matérielle (USB + DIN)
 
+_Static_assert((MIDI_DEST_UART == 1) && (MIDI_DEST_USB == 2) && (MIDI_DEST_BOTH == 3),
+               "seq_midi_bridge: midi_tx3_to() reçoit midi_dest_t comme masque de bits");
+
 // -----------------------------------------------------------------------------
-// Hook fort : appelé par les helpers apps/midi_helpers.h
-// Transforme (b0,b1,b2) en appels bas-niveau hot-safe.
+// Hook fort ciblé (midi_note_on_to/midi_note_off_to) : `dests` a les bits de
+// midi_dest_t (DIN = 1, USB = 2). Utilisé par l'ordonnanceur, qui émet DIN et
+// USB à des instants différents quand leurs offsets de latence diffèrent.
 // -----------------------------------------------------------------------------
-void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+void midi_tx3_to(uint8_t dests, uint8_t b0, uint8_t b1, uint8_t b2) {
+    const midi_dest_t dest = (midi_dest_t)(dests & MIDI_DEST_BOTH);
     const uint8_t st = b0 & 0xF0;
     const uint8_t ch = b0 & 0x0F;
 
+    if (dest == MIDI_DEST_NONE)
+        return;
+
     switch (st) {
         case 0x90: // NOTE ON
             if (b2)
-                midi_note_on(MIDI_DEST_BOTH, ch, b1, b2);
+                midi_note_on(dest, ch, b1, b2);
             else
-                midi_note_off(MIDI_DEST_BOTH, ch, b1, 64);
+                midi_note_off(dest, ch, b1, 64);
             break;
 
         case 0x80: // NOTE OFF
-            midi_note_off(MIDI_DEST_BOTH, ch, b1, b2 ? b2 : 64);
+            midi_note_off(dest, ch, b1, b2 ? b2 : 64);
             break;
 
         case 0xB0: // Control Change (CC)
-            midi_cc(MIDI_DEST_BOTH, ch, b1, b2);
+            midi_cc(dest, ch, b1, b2);
             break;
 
         default:
             break;
     }
 }
+
+// -----------------------------------------------------------------------------
+// Hook fort : appelé par les helpers apps/midi_helpers.h
+// Transforme (b0,b1,b2) en appels bas-niveau hot-safe, vers les deux sorties.
+// -----------------------------------------------------------------------------
+void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+    midi_tx3_to(MIDI_DEST_BOTH, b0, b1, b2);
+}
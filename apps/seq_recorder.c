@@ -5,8 +5,6 @@
 
 #include "seq_recorder.h"
 
-#include "apps/rtos_shim.h"
-
 #include "brick_config.h"
 
 #include "core/seq/seq_live_capture.h"
@@ -79,11 +77,11 @@ void seq_recorder_set_recording(bool enabled) {
 }
 
 void seq_recorder_handle_note_on(uint8_t note, uint8_t velocity) {
-    const systime_t now = chVTGetSystemTimeX();
+    const hr_time_t now = hr_time_now();
     seq_recorder_handle_note_on_at(note, velocity, now); // --- ARP FIX: wrapper timestamp ---
 }
 
-void seq_recorder_handle_note_on_at(uint8_t note, uint8_t velocity, systime_t timestamp) {
+void seq_recorder_handle_note_on_at(uint8_t note, uint8_t velocity, hr_time_t timestamp) {
     seq_live_capture_input_t input;
     seq_live_capture_plan_t plan;
 
@@ -112,11 +110,11 @@ void seq_recorder_handle_note_on_at(uint8_t note, uint8_t velocity, systime_t ti
 }
 
 void seq_recorder_handle_note_off(uint8_t note) {
-    const systime_t now = chVTGetSystemTimeX();
+    const hr_time_t now = hr_time_now();
     seq_recorder_handle_note_off_at(note, now); // --- ARP FIX: wrapper timestamp ---
 }
 
-void seq_recorder_handle_note_off_at(uint8_t note, systime_t timestamp) {
+void seq_recorder_handle_note_off_at(uint8_t note, hr_time_t timestamp) {
     seq_live_capture_input_t input;
     seq_live_capture_plan_t plan;
 
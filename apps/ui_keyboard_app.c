@@ -17,6 +17,7 @@
 #include "brick_config.h"
 #include "ui_led_backend.h"
 #include "kbd_chords_dict.h"
+#include "core/seq/seq_scale.h"
 
 #define KBD_MAX_VOICING_NOTES 12
 #define KBD_MAX_ACTIVE_NOTES  16
@@ -27,6 +28,7 @@ typedef struct {
   bool        omnichord;
   uint8_t     ui_root_midi;     /* Root absolue (0..127) — base C4 + offset UI */
   kbd_scale_t ui_scale;         /* Identifiant de gamme */
+  seq_scale_lut_t scale_lut;    /* Table de quantisation (root, gamme), reconstruite au changement */
 
   note_order_t note_order;      /* Natural vs Fifths (page 2) */
   bool         chord_override;  /* true = bypass quantization pour accords Omnichord */
@@ -63,40 +65,24 @@ static void sink_all_notes_off_internal(void){
 
 /* ======================= Helpers gamme / quantization ==================== */
 
-static inline uint8_t _root_pc(void){ return (uint8_t)(g.ui_root_midi % 12u); }
-
-static bool _pc_in_current_scale(uint8_t pc){
-  if (g.ui_scale == KBD_SCALE_CHROMATIC) return true;
-  const uint8_t base_pc = _root_pc();
-  for (uint8_t s = 0; s < 8; ++s){
-    const uint8_t sc_pc = (uint8_t)((base_pc + (uint8_t)kbd_scale_slot_semitone_offset((uint8_t)g.ui_scale, s)) % 12u);
-    if (sc_pc == pc) return true;
+/* Masque de classes de hauteur d'une gamme clavier (bit n = n demi-tons au-dessus de la root). */
+static uint16_t _scale_pc_mask(kbd_scale_t scale){
+  if (scale == KBD_SCALE_CHROMATIC) return SEQ_SCALE_MASK_CHROMATIC;
+  uint16_t mask = 0;
+  for (uint8_t s = 0; s < KBD_SCALE_SLOT_COUNT; ++s){
+    mask |= (uint16_t)(1u << ((uint8_t)kbd_scale_slot_semitone_offset((uint8_t)scale, s) % 12u));
   }
-  return false;
+  return mask;
 }
 
-static uint8_t quantize_to_current_scale(uint8_t midi_note){
-  if (g.ui_scale == KBD_SCALE_CHROMATIC) return midi_note; /* tout passe */
-
-  const uint8_t pc = (uint8_t)(midi_note % 12u);
-  if (_pc_in_current_scale(pc)) return midi_note;
-
-  int8_t up = 1, down = 1;
-  while (up < 12){
-    const uint8_t test_pc = (uint8_t)((pc + up) % 12u);
-    if (_pc_in_current_scale(test_pc)) break;
-    ++up;
-  }
-  while (down < 12){
-    const uint8_t test_pc = (uint8_t)((pc + 12u - down) % 12u);
-    if (_pc_in_current_scale(test_pc)) break;
-    ++down;
-  }
+/* Appelé à chaque changement de root/gamme : la table n'est reconstruite que si la config change. */
+static void _refresh_scale_lut(void){
+  (void)seq_scale_lut_prepare(&g.scale_lut, _scale_pc_mask(g.ui_scale), (uint8_t)(g.ui_root_midi % 12u));
+}
 
-  int16_t corrected = (int16_t)midi_note + ((down <= up) ? (int8_t)(-down) : up);
-  if (corrected < 0) corrected = 0;
-  else if (corrected > 127) corrected = 127;
-  return (uint8_t)corrected;
+/* Quantisation = une lecture de table (tie-break vers le bas, reste dans [0..127]). */
+static inline uint8_t quantize_to_current_scale(uint8_t midi_note){
+  return seq_scale_lut_apply(&g.scale_lut, midi_note);
 }
 
 /* ====================== Helpers mapping Natural / Fifths ================= */
@@ -224,6 +210,7 @@ void ui_keyboard_app_init(const ui_keyboard_note_sink_t *sink){
   g.note_order     = NOTE_ORDER_NATURAL;
   g.chord_override = false;
   g.octave_shift   = 0;
+  _refresh_scale_lut();
 
   if (sink) g.sink = *sink; else {
     g.sink.note_on = NULL; g.sink.note_off = NULL; g.sink.all_notes_off = NULL;
@@ -237,6 +224,7 @@ void ui_keyboard_app_set_params(uint8_t root_midi, kbd_scale_t scale, bool omnic
   g.ui_root_midi = root_midi;
   g.ui_scale     = scale;
   g.omnichord    = omnichord;
+  _refresh_scale_lut();
   if (omni_changed){
     flush_sounding_notes();
     g.chord_mask = 0;
@@ -50,10 +50,10 @@ extern void ui_backend_all_notes_off(void);
 
 static arp_engine_t s_arp_engine;                 // --- ARP: instance moteur ---
 static arp_config_t s_arp_config;                 // --- ARP: configuration courante ---
-static systime_t    s_last_group_stamp;           // --- ARP FIX: timestamp commun accords ---
-static systime_t    s_last_group_seen;            // --- ARP FIX: détection burst ---
+static hr_time_t    s_last_group_stamp;           // --- ARP FIX: timestamp commun accords ---
+static hr_time_t    s_last_group_seen;            // --- ARP FIX: détection burst ---
 
-static void _arp_callback_note_on(uint8_t note, uint8_t vel, systime_t when);
+static void _arp_callback_note_on(uint8_t note, uint8_t vel, hr_time_t when);
 static void _arp_callback_note_off(uint8_t note);
 
 static const arp_callbacks_t k_arp_callbacks = {
@@ -65,15 +65,15 @@ static inline uint8_t _resolve_velocity(uint8_t vel) {
   return (vel != 0u) ? vel : DEFAULT_VELOCITY;
 }
 
-static void _direct_note_on_at(uint8_t note, uint8_t vel, systime_t when) { // --- ARP FIX: timestamp groupé ---
+static void _direct_note_on_at(uint8_t note, uint8_t vel, hr_time_t when) { // --- ARP FIX: timestamp groupé ---
   const uint8_t resolved = _resolve_velocity(vel);
   seq_recorder_handle_note_on_at(note, resolved, when);
   ui_backend_note_on(note, resolved);
 }
 
-static systime_t _capture_group_timestamp(void) {
-  const systime_t now = chVTGetSystemTimeX();
-  if (chTimeDiffX(s_last_group_seen, now) <= TIME_MS2I(1)) {
+static hr_time_t _capture_group_timestamp(void) {
+  const hr_time_t now = hr_time_now();
+  if ((uint32_t)hr_time_diff(s_last_group_seen, now) <= HR_TIME_MS(1)) {
     s_last_group_seen = now;
     return s_last_group_stamp;
   }
@@ -83,17 +83,17 @@ static systime_t _capture_group_timestamp(void) {
 }
 
 static void _direct_note_on(uint8_t note, uint8_t vel) {
-  const systime_t stamp = _capture_group_timestamp();
+  const hr_time_t stamp = _capture_group_timestamp();
   _direct_note_on_at(note, vel, stamp);
 }
 
 static void _direct_note_off(uint8_t note) {
-  const systime_t now = chVTGetSystemTimeX();
+  const hr_time_t now = hr_time_now();
   seq_recorder_handle_note_off_at(note, now); // --- ARP FIX: wrapper timestamp ---
   ui_backend_note_off(note);
 }
 
-static void _arp_callback_note_on(uint8_t note, uint8_t vel, systime_t when) { // --- ARP: callback MIDI ---
+static void _arp_callback_note_on(uint8_t note, uint8_t vel, hr_time_t when) { // --- ARP: callback MIDI ---
   _direct_note_on_at(note, vel, when);
 }
 
@@ -285,7 +285,7 @@ void ui_keyboard_bridge_update_from_model(void) {
   ui_backend_shadow_set(KBD_UI_ID(KBD_UI_LOCAL_ARP), (uint8_t)(s_arp_config.enabled ? 1u : 0u));
 }
 
-void ui_keyboard_bridge_tick(systime_t now) {
+void ui_keyboard_bridge_tick(hr_time_t now) {
   (void)now;
   ui_keyboard_app_tick(0u);
   arp_tick(&s_arp_engine, now);
@@ -294,3 +294,16 @@ void ui_keyboard_bridge_tick(systime_t now) {
 void ui_keyboard_bridge_on_transport_stop(void) {
   arp_stop_all(&s_arp_engine); // --- ARP: STOP transport ---
 }
+
+void ui_keyboard_bridge_on_external_note(uint8_t note, uint8_t velocity, bool pressed, hr_time_t when) {
+  if (s_arp_config.enabled) {
+    arp_note_input(&s_arp_engine, note, pressed ? _resolve_velocity(velocity) : 0u, pressed);
+    return;
+  }
+  if (pressed) {
+    _direct_note_on_at(note, velocity, when);
+  } else {
+    seq_recorder_handle_note_off_at(note, when);
+    ui_backend_note_off(note);
+  }
+}
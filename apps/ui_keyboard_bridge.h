@@ -9,7 +9,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "apps/rtos_shim.h" // --- ARP: systime_t pour tick ---
+#include "hr_time.h" // --- ARP: horodatage µs pour tick ---
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,13 +36,23 @@ void ui_keyboard_bridge_update_from_model(void);
 /**
  * @brief Tick optionnel (placeholder pour intégrations futures, ex: ARP).
  */
-void ui_keyboard_bridge_tick(systime_t now); // --- ARP: tick haute résolution ---
+void ui_keyboard_bridge_tick(hr_time_t now); // --- ARP: tick haute résolution (µs) ---
 
 /**
  * @brief Panic clavier/ARP lors d'un STOP transport.
  */
 void ui_keyboard_bridge_on_transport_stop(void); // --- ARP: flush note engine ---
 
+/**
+ * @brief Note reçue d’un clavier MIDI externe (USB/DIN), horodatée à l’arrivée.
+ *
+ * Même chemin que le clavier interne : ARP si actif, sinon émission directe et
+ * enregistrement au timestamp d’arrivée (`seq_recorder_handle_note_*_at`).
+ * @param velocity Vélocité (ignorée si @p pressed est false).
+ * @param when     Horodatage µs d’arrivée (`midi_rx_event_t.ts`).
+ */
+void ui_keyboard_bridge_on_external_note(uint8_t note, uint8_t velocity, bool pressed, hr_time_t when);
+
 #ifdef __cplusplus
 }
 #endif
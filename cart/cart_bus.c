@@ -2,18 +2,35 @@
  * @file cart_bus.c
  * @brief Gestion du bus de communication série entre Brick et les cartouches XVA.
  *
- * Ce module gère la file d’envoi asynchrone (mailbox + pool mémoire) pour chaque
- * cartouche connectée sur un port UART.
+ * Ce module gère l’envoi asynchrone des paramètres vers chaque cartouche
+ * connectée sur un port UART.
  * Il assure :
- * - La configuration des UARTs (CART1 à CART4)
- * - La mise en file des commandes SET/GET de paramètres
+ * - La configuration des UARTs (CART1 à CART3 ; voir CART4 ci-dessous)
+ * - La coalescence des commandes SET/GET (dernière valeur gagnante)
  * - L’encapsulation des messages selon le protocole `cart_proto_xva1`
- * - La transmission séquencée par thread dédié (un par cartouche)
+ * - La transmission par DMA, blocs contigus enchaînés depuis l’ISR de fin de transfert
+ * - La réception des réponses GET (un octet par requête) et la lecture complète par lots
  *
  * @details
- * Chaque port de cartouche dispose d’une mailbox (`chMB`) et d’un pool de commandes.
- * Les requêtes sont postées via `cart_set_param()` ou `cart_get_param()`, puis
- * envoyées par le thread `cart_tx_thread`.
+ * Chaque port dispose d’un moteur `cart_tx_port_t` : ensemble de paramètres
+ * sales (`cart_dirty_t` : bitmap de 512 bits + dernière valeur) et tampon DMA.
+ * `cart_set_param()` / `cart_get_param()` marquent le paramètre puis, si le
+ * port est inactif, démarrent un transfert (`uartStartSendI`). Le callback
+ * `txend1` encode le bloc suivant à partir de l’état sale courant et le
+ * relance aussitôt : aucun thread d’émission, aucune commutation de contexte
+ * par rafale. Plusieurs écritures du même paramètre pendant un transfert n’en
+ * produisent qu’une trame, avec la valeur la plus récente.
+ *
+ * Priorités : chaque SET est rangé dans la classe de son émetteur
+ * (séquenceur, restauration, UI) ; les GET forment la classe de fond.
+ * `cart_bus_on_tick()` fixe, à chaque tick d’horloge, le budget d’octets du
+ * port (débit UART × durée du tick) ; les classes non séquenceur au-delà de
+ * leur part attendent le tick suivant, qui relance le port.
+ *
+ * Réception : le callback `rxchar` range chaque octet reçu dans le lot de GET
+ * ouvert (`cart_sync_t`) ; un lot complet est validé dans la file des
+ * réponses, lue par `cart_bus_rx_pop()`, et le lot suivant part depuis le
+ * même callback. `cart_bus_sync_poll()` (thread) gère les expirations.
  *
  * UART mapping :
  * | Cart | UART   | Broches STM32  |
@@ -23,6 +40,10 @@
  * | 3    | USART3 | PB10 / PB11    |
  * | 4    | USART2 | PA2 / PA3      |
  *
+ * CART4 partage USART2 avec le MIDI DIN (`SD2`, 31250 bauds) : le port n’est
+ * actif que si `STM32_UART_USE_USART2` est activé (MIDI DIN déplacé) ; sinon
+ * ses requêtes sont refusées et comptées dans `tx_dropped`.
+ *
  * @ingroup cart
  */
 
@@ -30,208 +51,259 @@
 #include "hal.h"
 #include "brick_config.h"
 #include "cart_bus.h"
-#include "cart_proto.h"
-#if CH_CFG_USE_REGISTRY
-#include "chprintf.h"    /* chsnprintf */
-#endif
+#include "cart_tx.h"
 /* ===========================================================
  * ⚙️ Configuration
  * =========================================================== */
-#ifndef CART_QUEUE_LEN
-#define CART_QUEUE_LEN 32
+#ifndef CART_GET_TIMEOUT_MS
+#define CART_GET_TIMEOUT_MS 20u  /* bloc DMA (≈ 2,6 ms) + temps de réponse cartouche */
 #endif
-#ifndef CART_MB_DROP_OLDEST
-#define CART_MB_DROP_OLDEST 1
-#endif
-#ifndef CART_UART_BAUD
-#define CART_UART_BAUD 500000u   /* XVA1 = 500 kbaud, 8N1 */
-#endif
-#ifndef CART_TX_THREAD_PRIO
-         #define CART_TX_THREAD_PRIO (NORMALPRIO + 2)
-         #endif
 /* ===========================================================
  * Structures internes
  * =========================================================== */
 typedef struct {
-    uint16_t param;
-    uint8_t  value;
-    bool     is_get;
-} cart_cmd_t;
-
-typedef struct {
-    SerialDriver *uart;
-    mailbox_t     mb;
-    msg_t         q[CART_QUEUE_LEN];
-    memory_pool_t pool;
-    cart_cmd_t    pool_buf[CART_QUEUE_LEN];
-    thread_t     *tx;
+    UARTDriver     *uart;
+    cart_tx_port_t  tx;
 } cart_port_t;
 
 /* ===========================================================
  * Variables globales
  * =========================================================== */
-static CCM_DATA cart_port_t s_port[CART_COUNT];
-static uint16_t s_cart_mb_fill[CART_COUNT];
-static uint16_t s_cart_mb_high_water[CART_COUNT];
+/* Pas de CCM_DATA : les tampons sont lus par le DMA, qui n’accède pas à la CCM. */
+static cart_port_t s_port[CART_COUNT];
 cart_tx_stats_t    cart_stats[CART_COUNT];
 
-static inline void cart_mb_increment(cart_id_t id) {
-    if (id >= CART_COUNT) {
-        return;
-    }
-    osalSysLock();
-    if (s_cart_mb_fill[id] < CART_QUEUE_LEN) {
-        s_cart_mb_fill[id]++;
-        if (s_cart_mb_fill[id] > s_cart_mb_high_water[id]) {
-            s_cart_mb_high_water[id] = s_cart_mb_fill[id];
-            cart_stats[id].mb_high_water = s_cart_mb_high_water[id];
-        }
-    }
-    osalSysUnlock();
-}
-
-static inline void cart_mb_decrement(cart_id_t id) {
-    if (id >= CART_COUNT) {
-        return;
-    }
-    osalSysLock();
-    if (s_cart_mb_fill[id] > 0U) {
-        s_cart_mb_fill[id]--;
-    }
-    osalSysUnlock();
-}
-
 /* ===========================================================
  * 🧭 Mapping logique → UART physique
  * =========================================================== */
-static SerialDriver* map_uart(cart_id_t id) {
+static UARTDriver* map_uart(cart_id_t id) {
     switch (id) {
-        case CART1: return &SD1;
-        case CART2: return &SD4;
-        case CART3: return &SD3;
-        case CART4: return &SD2;
+        case CART1: return &UARTD1;
+        case CART2: return &UARTD4;
+        case CART3: return &UARTD3;
+#if STM32_UART_USE_USART2
+        case CART4: return &UARTD2;
+#endif
         default:    return NULL;
     }
 }
 
+static cart_id_t port_of(UARTDriver *uartp) {
+    for (int i = 0; i < CART_COUNT; i++) {
+        if (s_port[i].uart == uartp) {
+            return (cart_id_t)i;
+        }
+    }
+    return CART_COUNT;
+}
+
 /* ===========================================================
- * Thread d’émission
+ * Émission DMA
  * =========================================================== */
-static CCM_DATA THD_WORKING_AREA(waCartTx[CART_COUNT], 512);
-
-/* Configuration UART commune à toutes les cartouches (Flash). */
-static const SerialConfig k_cart_serial_cfg = { CART_UART_BAUD, 0, 0, 0 };
+static void cart_publish_stats_i(cart_id_t id) {
+    const cart_tx_port_t *tx = &s_port[id].tx;
+    cart_stats[id].tx_sent = tx->frames;
+    cart_stats[id].bursts = tx->bursts;
+    cart_stats[id].coalesced = tx->dirty.coalesced;
+    cart_stats[id].dirty_high_water = tx->dirty.high_water;
+    cart_stats[id].rx_replies = tx->sync.stats.replies;
+    cart_stats[id].rx_stray = tx->sync.stats.stray;
+    cart_stats[id].get_timeouts = tx->sync.stats.timeouts;
+    for (int c = 0; c < CART_CLASS_COUNT; c++) {
+        cart_stats[id].class_frames[c] = tx->cls[c].frames;
+        cart_stats[id].class_deferred[c] = tx->cls[c].deferred;
+        cart_stats[id].class_latency_max[c] = tx->cls[c].latency_max;
+    }
+}
 
-static THD_FUNCTION(cart_tx_thread, arg) {
-    const cart_id_t id = (cart_id_t)(uintptr_t)arg;
+/* Démarre un bloc si le port est inactif (sous verrou, thread ou ISR). */
+static void cart_kick_i(cart_id_t id) {
     cart_port_t *p = &s_port[id];
-    uint8_t frame[4];
-
-#if CH_CFG_USE_REGISTRY
-    char name[16];
-    chsnprintf(name, sizeof(name), "cart_tx_%d", (int)id + 1);
-    chRegSetThreadName(name);
-#endif
+    const size_t len = cart_tx_kick(&p->tx, (uint32_t)chVTGetSystemTimeX());
+    if (len != 0U) {
+        uartStartSendI(p->uart, len, p->tx.buf);
+    }
+    cart_publish_stats_i(id);
+}
 
-    while (true) {
-        cart_cmd_t *cmd;
-        chMBFetchTimeout(&p->mb, (msg_t*)&cmd, TIME_INFINITE);
-        cart_mb_decrement(id);
+/* Fin de transfert DMA (ISR) : enchaîne le bloc suivant. */
+static void cart_txend1_cb(UARTDriver *uartp) {
+    const cart_id_t id = port_of(uartp);
+    if (id >= CART_COUNT) {
+        return;
+    }
+    cart_port_t *p = &s_port[id];
 
-        const size_t len = cmd->is_get
-            ? cart_proto_build_get(cmd->param, frame)
-            : cart_proto_build_set(cmd->param, cmd->value, frame);
+    osalSysLockFromISR();
+    const size_t len = cart_tx_complete(&p->tx, (uint32_t)chVTGetSystemTimeX());
+    if (len != 0U) {
+        uartStartSendI(uartp, len, p->tx.buf);
+    }
+    cart_publish_stats_i(id);
+    osalSysUnlockFromISR();
+}
 
-        sdWrite(p->uart, frame, len);
-        cart_stats[id].tx_sent++;
+/* Octet reçu hors réception DMA (ISR) : réponse au GET le plus ancien. */
+static void cart_rxchar_cb(UARTDriver *uartp, uint16_t c) {
+    const cart_id_t id = port_of(uartp);
+    if (id >= CART_COUNT) {
+        return;
+    }
+    cart_port_t *p = &s_port[id];
 
-        chPoolFree(&p->pool, cmd);
+    osalSysLockFromISR();
+    if (cart_sync_on_byte(&p->tx.sync, (uint8_t)c, (uint32_t)chVTGetSystemTimeX())) {
+        cart_kick_i(id); /* lot validé : le suivant peut partir */
+    } else {
+        cart_publish_stats_i(id);
     }
+    osalSysUnlockFromISR();
 }
 
+/* Configuration UART commune à toutes les cartouches (Flash). */
+static const UARTConfig k_cart_uart_cfg = {
+    .txend1_cb = cart_txend1_cb,
+    .txend2_cb = NULL,
+    .rxend_cb  = NULL,
+    .rxchar_cb = cart_rxchar_cb,
+    .rxerr_cb  = NULL,
+    .timeout_cb = NULL,
+    .speed     = CART_UART_BAUD,
+    .cr1       = 0,
+    .cr2       = 0,
+    .cr3       = 0
+};
+
 /* ===========================================================
  * Initialisation du bus cartouche
  * =========================================================== */
 void cart_bus_init(void) {
     for (int i = 0; i < CART_COUNT; i++) {
         cart_port_t *p = &s_port[i];
-        p->uart = map_uart((cart_id_t)i);
-        chDbgAssert(p->uart != NULL, "UART map invalid");
-        sdStart(p->uart, &k_cart_serial_cfg);
-
-        chMBObjectInit(&p->mb, p->q, CART_QUEUE_LEN);
-        chPoolObjectInit(&p->pool, sizeof(cart_cmd_t), NULL);
-        chPoolLoadArray(&p->pool, p->pool_buf, CART_QUEUE_LEN);
+        cart_tx_init(&p->tx, (uint32_t)TIME_MS2I(CART_GET_TIMEOUT_MS));
 
         cart_stats[i].tx_sent = 0;
         cart_stats[i].tx_dropped = 0;
-        cart_stats[i].mb_full = 0;
-        cart_stats[i].mb_high_water = 0;
-        s_cart_mb_fill[i] = 0;
-        s_cart_mb_high_water[i] = 0;
-
+        cart_stats[i].bursts = 0;
+        cart_stats[i].coalesced = 0;
+        cart_stats[i].dirty_high_water = 0;
+        cart_stats[i].rx_replies = 0;
+        cart_stats[i].rx_stray = 0;
+        cart_stats[i].get_timeouts = 0;
+        for (int c = 0; c < CART_CLASS_COUNT; c++) {
+            cart_stats[i].class_frames[c] = 0;
+            cart_stats[i].class_deferred[c] = 0;
+            cart_stats[i].class_latency_max[c] = 0;
+        }
 
-         p->tx = chThdCreateStatic(waCartTx[i], sizeof(waCartTx[i]),
-                                   CART_TX_THREAD_PRIO, cart_tx_thread, (void*)(uintptr_t)i);
-        chDbgAssert(p->tx != NULL, "cart_tx thd fail");
+        p->uart = map_uart((cart_id_t)i);
+        if (p->uart != NULL) {
+            uartStart(p->uart, &k_cart_uart_cfg);
+        }
     }
 }
 
 /* ===========================================================
  * Commandes internes (SET/GET)
  * =========================================================== */
-static bool post_cmd(cart_id_t id, bool is_get, uint16_t param, uint8_t value) {
+static bool post_cmd(cart_id_t id, bool is_get, cart_class_t cls, uint16_t param, uint8_t value) {
     if (id >= CART_COUNT) return false;
     cart_port_t *p = &s_port[id];
 
-    cart_cmd_t *cmd = (cart_cmd_t*)chPoolAlloc(&p->pool);
-    if (!cmd) { cart_stats[id].tx_dropped++; return false; }
-
-    cmd->param = param;
-    cmd->value = value;
-    cmd->is_get = is_get;
-
-    if (chMBPostTimeout(&p->mb, (msg_t)cmd, TIME_IMMEDIATE) != MSG_OK) {
-        cart_stats[id].mb_full++;
-#if CART_MB_DROP_OLDEST
-        msg_t old;
-        if (chMBFetchTimeout(&p->mb, &old, TIME_IMMEDIATE) == MSG_OK) {
-            cart_mb_decrement(id);
-            chPoolFree(&p->pool, (void*)old);
-            if (chMBPostTimeout(&p->mb, (msg_t)cmd, TIME_IMMEDIATE) == MSG_OK) {
-                cart_mb_increment(id);
-                return true;
-            }
-        } else {
-            chPoolFree(&p->pool, cmd);
-            return false;
-        }
-#else
-        chPoolFree(&p->pool, cmd);
-        return false;
-#endif
-    } else {
-        cart_mb_increment(id);
-        return true;
-    }
-    chPoolFree(&p->pool, cmd);
-    return false;
+    if (p->uart == NULL) { cart_stats[id].tx_dropped++; return false; }
+
+    const bool ok = is_get ? cart_sync_request(&p->tx.sync, param)
+                           : cart_dirty_set_class(&p->tx.dirty, cls, param, value,
+                                                  (uint32_t)chVTGetSystemTimeX());
+    if (!ok) { cart_stats[id].tx_dropped++; return false; }
+
+    /* Port inactif : démarre le DMA ; sinon la fin du transfert reprendra l’état sale. */
+    osalSysLock();
+    cart_kick_i(id);
+    osalSysUnlock();
+    return true;
 }
 
 uint16_t cart_bus_get_mailbox_high_water(cart_id_t id) {
     if (id >= CART_COUNT) {
         return 0;
     }
-    return s_cart_mb_high_water[id];
+    return s_port[id].tx.dirty.high_water;
+}
+
+bool cart_bus_get_rtt(cart_id_t id, uint32_t *lots, uint32_t *rtt, uint8_t *lot_size) {
+    if (id >= CART_COUNT) {
+        return false;
+    }
+    const cart_sync_stats_t *st = &s_port[id].tx.sync.stats;
+    osalSysLock();
+    if (lots) *lots = st->replies;
+    if (rtt) *rtt = st->rtt_last;
+    if (lot_size) *lot_size = st->rtt_lot;
+    osalSysUnlock();
+    return true;
 }
 
 /* ===========================================================
  * API publique
  * =========================================================== */
 bool cart_set_param(cart_id_t id, uint16_t param, uint8_t value) {
-    return post_cmd(id, false, param, value);
+    return post_cmd(id, false, CART_CLASS_UI, param, value);
+}
+
+bool cart_set_param_class(cart_id_t id, cart_class_t cls, uint16_t param, uint8_t value) {
+    return post_cmd(id, false, cls, param, value);
 }
 
 bool cart_get_param(cart_id_t id, uint16_t param) {
-    return post_cmd(id, true, param, 0);
+    return post_cmd(id, true, CART_CLASS_BACKGROUND, param, 0);
+}
+
+bool cart_bus_request_dump(cart_id_t id) {
+    if (id >= CART_COUNT) return false;
+    cart_port_t *p = &s_port[id];
+    if (p->uart == NULL) { cart_stats[id].tx_dropped++; return false; }
+
+    cart_sync_request_all(&p->tx.sync);
+    osalSysLock();
+    cart_kick_i(id);
+    osalSysUnlock();
+    return true;
+}
+
+bool cart_bus_rx_pop(cart_id_t id, uint16_t *param, uint8_t *value) {
+    if ((id >= CART_COUNT) || (param == NULL) || (value == NULL)) {
+        return false;
+    }
+    cart_sync_result_t r;
+    if (!cart_sync_pop(&s_port[id].tx.sync, &r)) {
+        return false;
+    }
+    *param = r.param;
+    *value = r.value;
+    return true;
+}
+
+void cart_bus_sync_poll(cart_id_t id) {
+    if ((id >= CART_COUNT) || (s_port[id].uart == NULL)) {
+        return;
+    }
+    osalSysLock();
+    if (cart_sync_poll(&s_port[id].tx.sync, (uint32_t)chVTGetSystemTimeX())) {
+        cart_kick_i(id); /* réponses lues ou silence écoulé */
+    }
+    osalSysUnlock();
+}
+
+void cart_bus_on_tick(uint32_t tick_st) {
+    const uint32_t bytes = (uint32_t)(((uint64_t)(CART_UART_BAUD / 10u) * tick_st) / CH_CFG_ST_FREQUENCY);
+    for (int i = 0; i < CART_COUNT; i++) {
+        if (s_port[i].uart == NULL) {
+            continue;
+        }
+        osalSysLock();
+        cart_tx_set_budget(&s_port[i].tx, tick_st, bytes);
+        cart_kick_i((cart_id_t)i); /* nouvelle fenêtre : reprend les trames différées */
+        osalSysUnlock();
+    }
 }
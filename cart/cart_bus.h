@@ -4,8 +4,9 @@
  *
  * Ce module assure la communication série asynchrone entre le cœur Brick
  * et jusqu’à quatre cartouches d’extension (XVA, etc.).
- * Chaque cartouche est associée à un port UART dédié et dispose de sa propre
- * file d’envoi (mailbox + pool mémoire) gérée par un thread indépendant.
+ * Chaque cartouche est associée à un port UART dédié et dispose de son propre
+ * ensemble de paramètres sales (dernière valeur gagnante, voir `cart_dirty.h`),
+ * émis par DMA en blocs contigus enchaînés depuis l’ISR (voir `cart_tx.h`).
  *
  * ### Mapping UART matériel
  * | Cart | UART   | Broches STM32  |
@@ -15,6 +16,14 @@
  * | 3    | USART3 | PB10 / PB11    |
  * | 4    | USART2 | PA2 / PA3      |
  *
+ * CART4 partage USART2 avec le MIDI DIN : inactif tant que `STM32_UART_USE_USART2`
+ * n’est pas activé.
+ *
+ * Chaque SET porte une classe de priorité (`cart_class_t`). Pendant la lecture,
+ * `cart_bus_on_tick()` borne à chaque tick d’horloge les octets émis par port :
+ * les p-locks du séquenceur passent toujours, les autres classes sont
+ * différées au tick suivant quand leur part est épuisée.
+ *
  * @ingroup cart
  */
 
@@ -22,6 +31,14 @@
 #define BRICK_CART_CART_BUS_H
 #include <stdint.h>
 #include <stdbool.h>
+#include "cart_dirty.h"
+
+/* ===========================================================
+ * Configuration
+ * =========================================================== */
+#ifndef CART_UART_BAUD
+#define CART_UART_BAUD 500000u   /* XVA1 = 500 kbaud, 8N1 (10 bits par octet) */
+#endif
 
 /* ===========================================================
  * Types et structures
@@ -43,9 +60,16 @@ typedef enum {
  */
 typedef struct {
     volatile uint32_t tx_sent;     /**< Nombre total de trames envoyées */
-    volatile uint32_t tx_dropped;  /**< Trames perdues faute de pool mémoire */
-    volatile uint32_t mb_full;     /**< Nombre de saturations de mailbox */
-    volatile uint16_t mb_high_water; /**< Occupation max observée de la mailbox */
+    volatile uint32_t tx_dropped;  /**< Requêtes refusées (paramètre hors plage, port inactif) */
+    volatile uint32_t bursts;      /**< Transferts DMA (un bloc contigu chacun) */
+    volatile uint32_t coalesced;   /**< SET absorbés par un SET du même paramètre en attente */
+    volatile uint16_t dirty_high_water; /**< Nombre max de paramètres en attente simultanément */
+    volatile uint32_t rx_replies;  /**< Réponses GET reçues et associées */
+    volatile uint32_t rx_stray;    /**< Octets reçus sans GET en vol (ignorés) */
+    volatile uint32_t get_timeouts;/**< Fenêtres GET expirées puis replanifiées */
+    volatile uint32_t class_frames[CART_CLASS_COUNT];      /**< Trames émises, par classe */
+    volatile uint32_t class_deferred[CART_CLASS_COUNT];    /**< Blocs partis sans la classe faute de budget */
+    volatile uint32_t class_latency_max[CART_CLASS_COUNT]; /**< Attente max avant émission (ticks système) */
 } cart_tx_stats_t;
 
 /**
@@ -58,7 +82,7 @@ extern cart_tx_stats_t cart_stats[CART_COUNT];
  * =========================================================== */
 
 /**
- * @brief Initialise tous les ports série de cartouche et crée les threads TX.
+ * @brief Initialise les ports UART de cartouche (émission DMA, sans thread).
  */
 void cart_bus_init(void);
 
@@ -68,19 +92,80 @@ void cart_bus_init(void);
  * @param id     Identifiant de la cartouche (CART1..CART4)
  * @param param  Identifiant du paramètre (dest_id)
  * @param value  Nouvelle valeur (brute, 8 bits)
+ * Une écriture du même paramètre encore en attente est remplacée (seule la
+ * dernière valeur est émise).
  * @return `true` si la commande a été postée avec succès, sinon `false`.
  */
 bool cart_set_param(cart_id_t id, uint16_t param, uint8_t value);
 
+/**
+ * @brief Variante de `cart_set_param()` avec classe de priorité explicite.
+ *
+ * `cart_set_param()` émet dans la classe `CART_CLASS_UI`. Un paramètre déjà
+ * en attente dans une classe plus prioritaire y reste (avec la nouvelle valeur).
+ * @param cls Classe de la trame (`CART_CLASS_SEQ` .. `CART_CLASS_UI`)
+ */
+bool cart_set_param_class(cart_id_t id, cart_class_t cls, uint16_t param, uint8_t value);
+
 /**
  * @brief Envoie une commande GET (lecture de paramètre) vers une cartouche.
  *
+ * La réponse est récupérée par `cart_bus_rx_pop()`. Une requête déjà en
+ * attente d’émission n’est pas dupliquée.
+ *
  * @param id     Identifiant de la cartouche (CART1..CART4)
  * @param param  Identifiant du paramètre (dest_id)
  * @return `true` si la commande a été postée avec succès, sinon `false`.
  */
 bool cart_get_param(cart_id_t id, uint16_t param);
 
-/** @brief Retourne le high-water mark de la mailbox pour un port donné. */
+/**
+ * @brief Demande la lecture des 512 paramètres d’une cartouche.
+ *
+ * Les GET sont émis par lots (au plus `CART_SYNC_WINDOW`, validés à la
+ * dernière réponse), au fil de la place disponible dans la file des réponses.
+ * @return `false` si le port est invalide ou inactif.
+ */
+bool cart_bus_request_dump(cart_id_t id);
+
+/**
+ * @brief Retire la plus ancienne réponse GET reçue d’une cartouche.
+ * @note Consommateur unique (thread UI via `cart_link_sync_poll()`).
+ * @return `true` si une réponse a été lue.
+ */
+bool cart_bus_rx_pop(cart_id_t id, uint16_t *param, uint8_t *value);
+
+/**
+ * @brief Gère les expirations de réponses et relance les lots de GET.
+ *
+ * À appeler périodiquement depuis un thread (après avoir lu les réponses).
+ */
+void cart_bus_sync_poll(cart_id_t id);
+
+/**
+ * @brief Retourne le nombre max de paramètres en attente pour un port donné.
+ * @note Nom historique conservé (file mailbox remplacée par l’ensemble sale).
+ */
 uint16_t cart_bus_get_mailbox_high_water(cart_id_t id);
+
+/**
+ * @brief Aller-retour du dernier lot de GET validé d’un port (calibration de latence).
+ *
+ * @param lots     Réponses validées depuis le démarrage : change à chaque lot.
+ * @param rtt      Ouverture du lot → dernière réponse, en ticks système.
+ * @param lot_size Taille du lot : 1 pour une mesure de latence exploitable.
+ * @return `false` si le port est invalide.
+ */
+bool cart_bus_get_rtt(cart_id_t id, uint32_t *lots, uint32_t *rtt, uint8_t *lot_size);
+
+/**
+ * @brief Ouvre la fenêtre d’admission d’un tick d’horloge sur tous les ports.
+ *
+ * À appeler à chaque tick 24 PPQN pendant la lecture : la fenêtre vaut
+ * @p tick_st et son budget les octets que `CART_UART_BAUD` transporte dans
+ * ce temps. Relance les ports dont des trames avaient été différées.
+ *
+ * @param tick_st Durée d’un tick (ticks système) ; 0 lève la limite (arrêt).
+ */
+void cart_bus_on_tick(uint32_t tick_st);
 #endif /* BRICK_CART_CART_BUS_H */
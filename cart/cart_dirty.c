@@ -0,0 +1,165 @@
+/**
+ * @file cart_dirty.c
+ * @brief Ensemble de paramètres sales par port cartouche (bitmap + dernière valeur).
+ *
+ * @ingroup cart
+ */
+
+#include "cart_dirty.h"
+#include "cart_proto.h"
+
+#include <string.h>
+
+_Static_assert((CART_PARAM_COUNT % 32U) == 0U, "CART_PARAM_COUNT doit être multiple de 32");
+_Static_assert(CART_DIRTY_WORDS <= 255U, "curseur sur 8 bits");
+
+/* Sur Cortex-M4, les opérations atomiques se compilent en LDREX/STREX. */
+
+static void pending_add(cart_dirty_t *d, uint8_t cls) {
+    (void)__atomic_add_fetch(&d->class_pending[cls], 1U, __ATOMIC_RELAXED);
+    const uint16_t now = __atomic_add_fetch(&d->pending, 1U, __ATOMIC_RELAXED);
+    if (now > __atomic_load_n(&d->high_water, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&d->high_water, now, __ATOMIC_RELAXED);
+    }
+}
+
+static void pending_sub(cart_dirty_t *d, uint8_t cls) {
+    (void)__atomic_sub_fetch(&d->class_pending[cls], 1U, __ATOMIC_RELAXED);
+    (void)__atomic_sub_fetch(&d->pending, 1U, __ATOMIC_RELAXED);
+}
+
+static bool mark(volatile uint32_t *bits, uint16_t param) {
+    const uint32_t mask = 1UL << (param & 31U);
+    const uint32_t prev = __atomic_fetch_or(&bits[param >> 5], mask, __ATOMIC_RELEASE);
+    return (prev & mask) == 0U;
+}
+
+void cart_dirty_init(cart_dirty_t *d) {
+    memset((void *)d, 0, sizeof(*d));
+}
+
+bool cart_dirty_set_class(cart_dirty_t *d, cart_class_t cls, uint16_t param, uint8_t value, uint32_t now) {
+    if ((param >= CART_PARAM_COUNT) || ((uint8_t)cls >= CART_DIRTY_CLASSES)) {
+        return false;
+    }
+    const uint8_t c = (uint8_t)cls;
+    const uint8_t w = (uint8_t)(param >> 5);
+    const uint32_t mask = 1UL << (param & 31U);
+
+    /* Valeur d’abord, bits ensuite (publication release). */
+    __atomic_store_n(&d->value[param], value, __ATOMIC_RELAXED);
+
+    /* Déjà en attente plus haut : la trame partira à ce rang, avec cette valeur. */
+    for (uint8_t k = 0U; k < c; ++k) {
+        if ((__atomic_load_n(&d->set_bits[k][w], __ATOMIC_ACQUIRE) & mask) != 0U) {
+            (void)__atomic_add_fetch(&d->coalesced, 1U, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+
+    if (__atomic_load_n(&d->class_pending[c], __ATOMIC_RELAXED) == 0U) {
+        __atomic_store_n(&d->since[c], now, __ATOMIC_RELAXED);
+    }
+    if (mark(d->set_bits[c], param)) {
+        pending_add(d, c);
+    } else {
+        (void)__atomic_add_fetch(&d->coalesced, 1U, __ATOMIC_RELAXED);
+    }
+
+    /* Retiré des classes moins prioritaires : une seule trame, au rang le plus haut. */
+    for (uint8_t k = (uint8_t)(c + 1U); k < CART_DIRTY_CLASSES; ++k) {
+        const uint32_t prev = __atomic_fetch_and(&d->set_bits[k][w], ~mask, __ATOMIC_ACQ_REL);
+        if ((prev & mask) != 0U) {
+            pending_sub(d, k);
+            (void)__atomic_add_fetch(&d->coalesced, 1U, __ATOMIC_RELAXED);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Encode les bits d’un mot, dans l’ordre croissant des paramètres.
+ * @return false si le bloc est plein (des bits restent posés dans le mot).
+ */
+static bool drain_word(cart_dirty_t *d, uint8_t cls, uint8_t w, uint8_t *out, size_t cap,
+                       size_t *n, uint32_t *frames) {
+    volatile uint32_t *word = &d->set_bits[cls][w];
+    uint32_t bits = __atomic_load_n(word, __ATOMIC_ACQUIRE);
+
+    while (bits != 0U) {
+        const uint32_t b = (uint32_t)__builtin_ctz(bits);
+        const uint16_t param = (uint16_t)((w * 32U) + b);
+        const uint32_t mask = 1UL << b;
+        bits &= ~mask;
+
+        uint8_t frame[4];
+        /* Taille de la trame connue avant retrait du bit : jamais de trame coupée. */
+        const size_t len = cart_proto_set_size(param);
+        if ((*n + len) > cap) {
+            return false;
+        }
+
+        /* Bit retiré avant lecture de la valeur : une écriture concurrente le reposera. */
+        const uint32_t prev = __atomic_fetch_and(word, ~mask, __ATOMIC_ACQ_REL);
+        if ((prev & mask) == 0U) {
+            continue; /* déplacé vers une classe plus prioritaire entre-temps */
+        }
+        pending_sub(d, cls);
+
+        (void)cart_proto_build_set(param, __atomic_load_n(&d->value[param], __ATOMIC_RELAXED), frame);
+        memcpy(&out[*n], frame, len);
+        *n += len;
+        (*frames)++;
+    }
+    return true;
+}
+
+size_t cart_dirty_drain_class(cart_dirty_t *d, cart_class_t cls, uint8_t *out, size_t cap, uint32_t *frames) {
+    size_t n = 0U;
+    uint32_t count = 0U;
+    const uint8_t c = (uint8_t)cls;
+
+    if (c < CART_DIRTY_CLASSES) {
+        /* Tous les mots, à partir du curseur de la classe. */
+        for (uint8_t i = 0U; i < CART_DIRTY_WORDS; ++i) {
+            const uint8_t w = (uint8_t)((d->cursor[c] + i) % CART_DIRTY_WORDS);
+            if (!drain_word(d, c, w, out, cap, &n, &count)) {
+                d->cursor[c] = w;
+                break;
+            }
+        }
+    }
+
+    if (frames != NULL) {
+        *frames = count;
+    }
+    return n;
+}
+
+size_t cart_dirty_drain(cart_dirty_t *d, uint8_t *out, size_t cap, uint32_t *frames) {
+    size_t n = 0U;
+    uint32_t count = 0U;
+    for (uint8_t c = 0U; c < CART_DIRTY_CLASSES; ++c) {
+        uint32_t f = 0U;
+        n += cart_dirty_drain_class(d, (cart_class_t)c, &out[n], cap - n, &f);
+        count += f;
+        if (cart_dirty_class_pending(d, (cart_class_t)c) != 0U) {
+            break;
+        }
+    }
+    if (frames != NULL) {
+        *frames = count;
+    }
+    return n;
+}
+
+uint16_t cart_dirty_pending(const cart_dirty_t *d) {
+    return __atomic_load_n(&d->pending, __ATOMIC_RELAXED);
+}
+
+uint16_t cart_dirty_class_pending(const cart_dirty_t *d, cart_class_t cls) {
+    if ((uint8_t)cls >= CART_DIRTY_CLASSES) {
+        return 0U;
+    }
+    return __atomic_load_n(&d->class_pending[cls], __ATOMIC_RELAXED);
+}
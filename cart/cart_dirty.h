@@ -0,0 +1,111 @@
+/**
+ * @file cart_dirty.h
+ * @brief Ensemble de paramètres « sales » par port cartouche (dernière valeur gagnante).
+ *
+ * Remplace la file de commandes : chaque port garde un bitmap de 512 bits
+ * (un par `dest_id`) et la dernière valeur écrite. Plusieurs écritures du même
+ * paramètre avant l’émission se réduisent à une seule trame portant la valeur
+ * la plus récente ; aucune écriture d’un autre paramètre n’est jamais perdue.
+ *
+ * Les requêtes GET, dont chaque réponse doit être associée à sa requête,
+ * sont gérées à part par `cart_sync.h`.
+ *
+ * Classes de priorité : chaque SET en attente appartient à une classe
+ * (`cart_class_t`), avec un bitmap par classe et un tableau de valeurs
+ * commun. Un paramètre n’est en attente que dans une seule classe : la plus
+ * prioritaire de ses écritures en attente, qui porte toujours la dernière
+ * valeur. Le consommateur vide les classes dans l’ordre de priorité.
+ *
+ * Concurrence : plusieurs producteurs (threads) et un consommateur (émission).
+ * Les bits sont posés/retirés par opérations atomiques ; le consommateur
+ * retire le bit **avant** de lire la valeur, si bien qu’une écriture
+ * concurrente est au pire émise deux fois, jamais perdue.
+ *
+ * Module sans dépendance RTOS (testé sur hôte, `tests/cart_dirty_tests.c`).
+ *
+ * @ingroup cart
+ */
+
+#ifndef BRICK_CART_CART_DIRTY_H
+#define BRICK_CART_CART_DIRTY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Nombre de paramètres adressables par cartouche (protocole XVA1 étendu). */
+#define CART_PARAM_COUNT 512U
+
+#define CART_DIRTY_WORDS (CART_PARAM_COUNT / 32U)
+
+/**
+ * @brief Classes de trames, par priorité d’émission décroissante.
+ */
+typedef enum {
+    CART_CLASS_SEQ = 0,    /**< P-lock calé sur un step (séquenceur) */
+    CART_CLASS_RESTORE,    /**< Restauration d’une valeur après p-lock */
+    CART_CLASS_UI,         /**< Édition interactive (encodeurs, menus) */
+    CART_CLASS_BACKGROUND, /**< Relecture du shadow (GET, voir `cart_sync.h`) */
+    CART_CLASS_COUNT
+} cart_class_t;
+
+/** @brief Classes portées par des SET (la classe de fond n’émet que des GET). */
+#define CART_DIRTY_CLASSES ((uint8_t)CART_CLASS_BACKGROUND)
+
+/**
+ * @brief Ensemble sale d’un port.
+ */
+typedef struct {
+    volatile uint32_t set_bits[CART_DIRTY_CLASSES][CART_DIRTY_WORDS]; /**< SET en attente, par classe */
+    volatile uint8_t  value[CART_PARAM_COUNT];     /**< Dernière valeur écrite */
+    volatile uint16_t pending;                     /**< Paramètres en attente */
+    volatile uint16_t class_pending[CART_DIRTY_CLASSES]; /**< Paramètres en attente par classe */
+    volatile uint32_t since[CART_DIRTY_CLASSES];   /**< Instant de la plus ancienne écriture en attente (approché) */
+    volatile uint16_t high_water;                  /**< Maximum de `pending` observé */
+    volatile uint32_t coalesced;                   /**< Écritures absorbées par un SET déjà en attente */
+    uint8_t           cursor[CART_DIRTY_CLASSES];  /**< Mot de reprise (équité si le bloc est plein) */
+} cart_dirty_t;
+
+/** Vide l’ensemble et remet les compteurs à zéro (hors concurrence). */
+void cart_dirty_init(cart_dirty_t *d);
+
+/**
+ * @brief Producteur : enregistre la dernière valeur d’un paramètre dans une classe.
+ *
+ * Si le paramètre attend déjà dans une classe plus prioritaire, il y reste
+ * avec la nouvelle valeur ; s’il attend dans une classe moins prioritaire,
+ * il en est retiré.
+ * @param now Instant de l’écriture (ticks quelconques, pour les latences).
+ * @return false si @p param ou @p cls est hors plage.
+ */
+bool cart_dirty_set_class(cart_dirty_t *d, cart_class_t cls, uint16_t param, uint8_t value, uint32_t now);
+
+/** @brief Écriture interactive (`CART_CLASS_UI`), sans instant. */
+static inline bool cart_dirty_set(cart_dirty_t *d, uint16_t param, uint8_t value) {
+    return cart_dirty_set_class(d, CART_CLASS_UI, param, value, 0U);
+}
+
+/**
+ * @brief Consommateur : encode les paramètres sales d’une classe en trames contiguës.
+ *
+ * Aucune trame n’est coupée : le passage s’arrête dès que la suivante ne
+ * tient plus dans @p cap, et reprend au même endroit au prochain appel.
+ * @param[out] frames Nombre de trames écrites (optionnel).
+ * @return Nombre d’octets écrits dans @p out (0 si rien n’est en attente).
+ */
+size_t cart_dirty_drain_class(cart_dirty_t *d, cart_class_t cls, uint8_t *out, size_t cap, uint32_t *frames);
+
+/**
+ * @brief Consommateur : encode toutes les classes, par ordre de priorité.
+ *
+ * Une classe n’est entamée que si les plus prioritaires sont vides.
+ */
+size_t cart_dirty_drain(cart_dirty_t *d, uint8_t *out, size_t cap, uint32_t *frames);
+
+/** Nombre de paramètres en attente (instantané). */
+uint16_t cart_dirty_pending(const cart_dirty_t *d);
+
+/** Nombre de paramètres en attente dans une classe (instantané). */
+uint16_t cart_dirty_class_pending(const cart_dirty_t *d, cart_class_t cls);
+
+#endif /* BRICK_CART_CART_DIRTY_H */
@@ -25,6 +25,15 @@
  */
 size_t cart_proto_build_set(uint16_t param, uint8_t value, uint8_t out[4]);
 
+/**
+ * @brief Taille de la trame “set” d’un paramètre, sans l’encoder.
+ * @param param  Identifiant du paramètre (0–511)
+ * @return 3 ou 4 octets (même règle que `cart_proto_build_set()`)
+ */
+static inline size_t cart_proto_set_size(uint16_t param) {
+    return (param <= 254U) ? 3U : 4U;
+}
+
 /**
  * @brief Construit une trame “get param” prête à envoyer sur UART.
  * @param param  Identifiant du paramètre à lire (0–511)
@@ -0,0 +1,208 @@
+/**
+ * @file cart_sync.c
+ * @brief Lectures de paramètres cartouche : lots de GET validés et file des réponses.
+ *
+ * @ingroup cart
+ */
+
+#include "cart_sync.h"
+#include "cart_proto.h"
+
+#include <string.h>
+
+_Static_assert((CART_SYNC_RESULT_LEN & (CART_SYNC_RESULT_LEN - 1U)) == 0U,
+               "CART_SYNC_RESULT_LEN doit être une puissance de 2");
+_Static_assert(CART_SYNC_WINDOW <= CART_SYNC_RESULT_LEN, "lot plus grand que la file des réponses");
+_Static_assert(CART_SYNC_WINDOW <= 255U, "lot sur 8 bits");
+
+/* 255 est l’octet d’extension du protocole : « g 255 255 » lirait le paramètre 511. */
+#define CART_SYNC_UNADDRESSABLE 255U
+
+static bool time_reached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+/** Place libre dans la file des réponses (réponses non lues déduites). */
+static uint16_t results_free(const cart_sync_t *s) {
+    const uint16_t head = __atomic_load_n(&s->r_head, __ATOMIC_ACQUIRE);
+    const uint16_t tail = __atomic_load_n(&s->r_tail, __ATOMIC_ACQUIRE);
+    return (uint16_t)(CART_SYNC_RESULT_LEN - (uint16_t)(head - tail));
+}
+
+static bool has_requests(const cart_sync_t *s) {
+    for (uint8_t w = 0U; w < CART_DIRTY_WORDS; ++w) {
+        if (__atomic_load_n(&s->req_bits[w], __ATOMIC_RELAXED) != 0U) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void cart_sync_init(cart_sync_t *s, uint32_t timeout) {
+    memset((void *)s, 0, sizeof(*s));
+    s->timeout = timeout;
+}
+
+bool cart_sync_request(cart_sync_t *s, uint16_t param) {
+    if ((param >= CART_PARAM_COUNT) || (param == CART_SYNC_UNADDRESSABLE)) {
+        return false;
+    }
+    (void)__atomic_fetch_or(&s->req_bits[param >> 5], 1UL << (param & 31U), __ATOMIC_RELEASE);
+    return true;
+}
+
+void cart_sync_request_all(cart_sync_t *s) {
+    for (uint8_t w = 0U; w < CART_DIRTY_WORDS; ++w) {
+        uint32_t bits = 0xFFFFFFFFUL;
+        if (w == (CART_SYNC_UNADDRESSABLE >> 5)) {
+            bits &= ~(1UL << (CART_SYNC_UNADDRESSABLE & 31U));
+        }
+        (void)__atomic_fetch_or(&s->req_bits[w], bits, __ATOMIC_RELEASE);
+    }
+}
+
+bool cart_sync_can_emit(const cart_sync_t *s, uint32_t now) {
+    if (s->holding && !time_reached(now, s->hold_until)) {
+        return false;
+    }
+    return (s->sent == 0U) && (results_free(s) != 0U) && has_requests(s);
+}
+
+size_t cart_sync_emit(cart_sync_t *s, uint8_t *out, size_t cap, uint32_t now, uint32_t *frames) {
+    size_t n = 0U;
+
+    if (frames != NULL) {
+        *frames = 0U;
+    }
+    if (s->holding) {
+        if (!time_reached(now, s->hold_until)) {
+            return 0U;
+        }
+        s->holding = false;
+    }
+    if (s->sent != 0U) {
+        return 0U; /* un lot à la fois : l’ordre des réponses reste vérifiable */
+    }
+
+    uint16_t room = results_free(s);
+    if (room > CART_SYNC_WINDOW) {
+        room = CART_SYNC_WINDOW;
+    }
+
+    uint8_t count = 0U;
+    bool full = false;
+    for (uint8_t i = 0U; (i < CART_DIRTY_WORDS) && !full && (count < room); ++i) {
+        const uint8_t w = (uint8_t)((s->cursor + i) % CART_DIRTY_WORDS);
+        uint32_t bits = __atomic_load_n(&s->req_bits[w], __ATOMIC_ACQUIRE);
+
+        while ((bits != 0U) && (count < room)) {
+            const uint32_t b = (uint32_t)__builtin_ctz(bits);
+            const uint32_t mask = 1UL << b;
+            const uint16_t param = (uint16_t)((w * 32U) + b);
+            bits &= ~mask;
+
+            uint8_t frame[4];
+            const size_t len = cart_proto_build_get(param, frame);
+            if ((n + len) > cap) {
+                full = true;
+                break;
+            }
+            (void)__atomic_fetch_and(&s->req_bits[w], ~mask, __ATOMIC_ACQ_REL);
+            s->batch[count++] = param;
+            memcpy(&out[n], frame, len);
+            n += len;
+        }
+        if (full || (bits != 0U)) {
+            s->cursor = w; /* bloc ou lot pleins : reprise sur ce mot */
+        }
+    }
+
+    if (count != 0U) {
+        s->sent = count;
+        s->received = 0U;
+        s->issued_at = now;
+        if (count > s->stats.inflight_max) {
+            s->stats.inflight_max = count;
+        }
+        s->stats.gets_sent += count;
+    }
+    if (frames != NULL) {
+        *frames = count;
+    }
+    return n;
+}
+
+bool cart_sync_on_byte(cart_sync_t *s, uint8_t byte, uint32_t now) {
+    if ((s->sent == 0U) || s->holding) {
+        s->stats.stray++;
+        return false;
+    }
+
+    s->staged[s->received++] = byte;
+    if (s->received < s->sent) {
+        return false;
+    }
+
+    /* Lot complet : validation (place réservée à l’ouverture du lot). */
+    uint16_t head = s->r_head;
+    for (uint8_t i = 0U; i < s->sent; ++i) {
+        cart_sync_result_t *r = &s->results[head & (CART_SYNC_RESULT_LEN - 1U)];
+        r->param = s->batch[i];
+        r->value = s->staged[i];
+        head++;
+    }
+    __atomic_store_n(&s->r_head, head, __ATOMIC_RELEASE);
+    s->stats.replies += s->sent;
+    /* Aller-retour du lot (GET d’un seul paramètre : latence du lien, calibration). */
+    s->stats.rtt_lot = s->sent;
+    s->stats.rtt_last = now - s->issued_at;
+    s->sent = 0U;
+    s->received = 0U;
+    s->fail_streak = 0U;
+    return true;
+}
+
+bool cart_sync_poll(cart_sync_t *s, uint32_t now) {
+    if (s->holding && time_reached(now, s->hold_until)) {
+        s->holding = false;
+    }
+    if ((s->sent != 0U) && !s->holding && time_reached(now, s->issued_at + s->timeout)) {
+        /* Réponse perdue : le lot entier est suspect, il est jeté puis replanifié. */
+        s->stats.timeouts++;
+        s->fail_streak++;
+        const bool give_up = (s->fail_streak >= CART_SYNC_MAX_RETRIES);
+        for (uint8_t i = 0U; i < s->sent; ++i) {
+            if (give_up) {
+                s->stats.abandoned++;
+            } else {
+                (void)cart_sync_request(s, s->batch[i]);
+            }
+        }
+        if (give_up) {
+            for (uint8_t w = 0U; w < CART_DIRTY_WORDS; ++w) {
+                const uint32_t bits = __atomic_exchange_n(&s->req_bits[w], 0U, __ATOMIC_ACQ_REL);
+                s->stats.abandoned += (uint32_t)__builtin_popcount(bits);
+            }
+            s->fail_streak = 0U;
+        }
+        s->sent = 0U;
+        s->received = 0U;
+        s->holding = true;
+        s->hold_until = now + s->timeout;
+    }
+    return cart_sync_can_emit(s, now);
+}
+
+bool cart_sync_pop(cart_sync_t *s, cart_sync_result_t *out) {
+    const uint16_t tail = s->r_tail;
+    if (tail == __atomic_load_n(&s->r_head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *out = s->results[tail & (CART_SYNC_RESULT_LEN - 1U)];
+    __atomic_store_n(&s->r_tail, (uint16_t)(tail + 1U), __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t cart_sync_inflight(const cart_sync_t *s) {
+    return (uint8_t)(s->sent - s->received);
+}
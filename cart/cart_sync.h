@@ -0,0 +1,137 @@
+/**
+ * @file cart_sync.h
+ * @brief Lectures de paramètres cartouche : requêtes GET fenêtrées et réponses.
+ *
+ * Le protocole XVA1 répond à chaque trame `'g' param` par **un octet brut**
+ * (la valeur), dans l’ordre des requêtes et sans en-tête. L’association
+ * réponse ↔ paramètre repose donc sur l’ordre d’émission, et un seul octet
+ * perdu décalerait toutes les réponses suivantes. Les GET partent par **lots** :
+ * - les requêtes sont marquées dans un bitmap (un GET en double n’est émis
+ *   qu’une fois) ; une **lecture complète** (« dump ») marque tous les bits ;
+ * - `cart_sync_emit()` ouvre un lot d’au plus `CART_SYNC_WINDOW` GET (et jamais
+ *   plus que la place libre dans la file des réponses : le consommateur lent
+ *   freine l’émission), émis d’un seul bloc DMA ;
+ * - les octets reçus sont mis de côté ; le lot n’est **validé** (réponses
+ *   poussées dans une file SPSC lue par le thread qui réconcilie le shadow)
+ *   que lorsque toutes ses réponses sont arrivées, puis le lot suivant part ;
+ * - un lot incomplet après `timeout` est jeté et replanifié, et l’émission est
+ *   suspendue pendant `timeout` : un octet tardif tombe dans cette fenêtre de
+ *   silence et est compté comme orphelin. Après `CART_SYNC_MAX_RETRIES`
+ *   expirations consécutives sans lot validé, les requêtes sont abandonnées.
+ *
+ * Concurrence : `cart_sync_request*()` sont sans verrou (bits atomiques,
+ * producteurs multiples). `cart_sync_emit()`, `cart_sync_on_byte()` et
+ * `cart_sync_poll()` sont appelées sous section critique (ISR DMA/UART,
+ * thread). `cart_sync_pop()` est réservée à un unique consommateur.
+ *
+ * Module sans dépendance RTOS (testé sur hôte, `tests/cart_sync_tests.c`).
+ * Les instants sont des ticks quelconques sur 32 bits (comparaison modulo).
+ *
+ * @ingroup cart
+ */
+
+#ifndef BRICK_CART_CART_SYNC_H
+#define BRICK_CART_CART_SYNC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cart_dirty.h"
+
+/** @brief Taille maximale d’un lot de GET (octets de réponse attendus). */
+#ifndef CART_SYNC_WINDOW
+#define CART_SYNC_WINDOW 16U
+#endif
+
+/** @brief Capacité de la file des réponses (puissance de 2). */
+#ifndef CART_SYNC_RESULT_LEN
+#define CART_SYNC_RESULT_LEN 64U
+#endif
+
+/** @brief Expirations consécutives sans réponse avant abandon des requêtes (cartouche absente). */
+#ifndef CART_SYNC_MAX_RETRIES
+#define CART_SYNC_MAX_RETRIES 3U
+#endif
+
+/** @brief Réponse décodée. */
+typedef struct {
+    uint16_t param;
+    uint8_t  value;
+} cart_sync_result_t;
+
+/** @brief Statistiques de lecture d’un port. */
+typedef struct {
+    volatile uint32_t gets_sent;   /**< Trames GET émises */
+    volatile uint32_t replies;     /**< Réponses validées (lots complets) */
+    volatile uint32_t stray;       /**< Octets reçus sans GET en vol (ou pendant le silence) */
+    volatile uint32_t timeouts;    /**< Lots expirés (jetés puis replanifiés) */
+    volatile uint32_t abandoned;   /**< Requêtes abandonnées (cartouche muette) */
+    volatile uint16_t inflight_max;/**< Maximum de GET en vol observé */
+    volatile uint8_t  rtt_lot;     /**< Taille du dernier lot validé */
+    volatile uint32_t rtt_last;    /**< Dernier lot validé : ouverture → dernière réponse (ticks) */
+} cart_sync_stats_t;
+
+/** @brief État de lecture d’un port. */
+typedef struct {
+    volatile uint32_t  req_bits[CART_DIRTY_WORDS]; /**< GET demandés, non émis */
+    uint16_t           batch[CART_SYNC_WINDOW];    /**< Paramètres du lot, ordre d’émission */
+    uint8_t            staged[CART_SYNC_WINDOW];   /**< Réponses reçues, non validées */
+    uint8_t            sent;                       /**< Taille du lot ouvert (0 : aucun) */
+    uint8_t            received;                   /**< Réponses reçues pour le lot */
+    uint32_t           issued_at;                  /**< Ouverture du lot */
+    uint8_t            cursor;                     /**< Mot de reprise du balayage */
+    bool               holding;                    /**< Silence après expiration */
+    uint8_t            fail_streak;                /**< Expirations consécutives sans réponse */
+    uint32_t           hold_until;
+    uint32_t           timeout;                    /**< Délai max d’une réponse (ticks) */
+    cart_sync_result_t results[CART_SYNC_RESULT_LEN];
+    volatile uint16_t  r_head;                     /**< Écrit par le producteur (ISR) */
+    volatile uint16_t  r_tail;                     /**< Écrit par le consommateur */
+    cart_sync_stats_t  stats;
+} cart_sync_t;
+
+/** Réinitialise l’état (aucune requête, aucun GET en vol). */
+void cart_sync_init(cart_sync_t *s, uint32_t timeout);
+
+/**
+ * @brief Demande la lecture d’un paramètre.
+ * @return false si hors plage ou non adressable (255 : octet d’extension du protocole).
+ */
+bool cart_sync_request(cart_sync_t *s, uint16_t param);
+
+/** @brief Demande la lecture de tous les paramètres adressables (511 requêtes). */
+void cart_sync_request_all(cart_sync_t *s);
+
+/**
+ * @brief Ouvre un lot de GET dans @p out si aucun lot n’est en cours.
+ * @param[out] frames Nombre de trames ajoutées (optionnel).
+ * @return Octets écrits (jamais de trame coupée).
+ */
+size_t cart_sync_emit(cart_sync_t *s, uint8_t *out, size_t cap, uint32_t now, uint32_t *frames);
+
+/**
+ * @brief Octet reçu de la cartouche.
+ *
+ * La validation d’un lot note son aller-retour (`stats.rtt_last`, depuis
+ * l’ouverture du lot) : sur un lot d’un seul GET, c’est la latence du lien.
+ * @return true si l’octet a complété le lot (réponses validées, lot suivant possible).
+ */
+bool cart_sync_on_byte(cart_sync_t *s, uint8_t byte, uint32_t now);
+
+/**
+ * @brief Surveille l’expiration du lot ouvert et la fin du silence.
+ * @return true si des GET peuvent être émis (appeler `cart_sync_emit()`).
+ */
+bool cart_sync_poll(cart_sync_t *s, uint32_t now);
+
+/** @brief true si des GET attendent, qu’aucun lot n’est ouvert et que la file des réponses a de la place. */
+bool cart_sync_can_emit(const cart_sync_t *s, uint32_t now);
+
+/** @brief Consommateur : retire la réponse la plus ancienne. */
+bool cart_sync_pop(cart_sync_t *s, cart_sync_result_t *out);
+
+/** Nombre de réponses encore attendues pour le lot ouvert. */
+uint8_t cart_sync_inflight(const cart_sync_t *s);
+
+#endif /* BRICK_CART_CART_SYNC_H */
@@ -0,0 +1,119 @@
+/**
+ * @file cart_tx.c
+ * @brief Moteur d’émission DMA d’un port cartouche (tampon unique, enchaînement en ISR).
+ *
+ * @ingroup cart
+ */
+
+#include "cart_tx.h"
+
+#include <string.h>
+
+static const uint8_t k_class_share_pct[CART_CLASS_COUNT] = {
+    100U, /* séquenceur : jamais différé */
+    CART_TX_SHARE_RESTORE_PCT,
+    CART_TX_SHARE_UI_PCT,
+    CART_TX_SHARE_BACKGROUND_PCT,
+};
+
+/* Place accordée à une classe dans le bloc, compte tenu de la fenêtre en cours. */
+static size_t admitted(const cart_tx_port_t *p, uint8_t cls, size_t len) {
+    const size_t room = sizeof(p->buf) - len;
+    if ((p->window == 0U) || (cls == (uint8_t)CART_CLASS_SEQ)) {
+        return room;
+    }
+    const uint32_t limit = (uint32_t)(((uint64_t)p->window_bytes * k_class_share_pct[cls]) / 100U);
+    const uint32_t used = p->window_spent + (uint32_t)len;
+    if (used >= limit) {
+        return 0U;
+    }
+    return ((limit - used) < room) ? (size_t)(limit - used) : room;
+}
+
+static void account(cart_tx_port_t *p, uint8_t cls, uint32_t frames, uint32_t since, uint32_t now) {
+    cart_tx_class_stats_t *st = &p->cls[cls];
+    st->frames += frames;
+    const uint32_t latency = now - since;
+    st->latency_last = latency;
+    if (latency > st->latency_max) {
+        st->latency_max = latency;
+    }
+}
+
+static size_t start_block(cart_tx_port_t *p, uint32_t now) {
+    if ((p->window != 0U) && ((uint32_t)(now - p->window_start) >= p->window)) {
+        p->window_start = now;
+        p->window_spent = 0U;
+    }
+
+    uint32_t frames = 0U;
+    size_t len = 0U;
+    bool sets_left = false;
+    for (uint8_t c = 0U; c < CART_DIRTY_CLASSES; ++c) {
+        if (cart_dirty_class_pending(&p->dirty, (cart_class_t)c) == 0U) {
+            continue;
+        }
+        const size_t cap = admitted(p, c, len);
+        if (cap < 4U) {
+            if (cap != (sizeof(p->buf) - len)) {
+                p->cls[c].deferred++; /* refusée par la fenêtre, pas par le bloc */
+            }
+            sets_left = true;
+            break;
+        }
+        const uint32_t since = p->dirty.since[c];
+        uint32_t f = 0U;
+        len += cart_dirty_drain_class(&p->dirty, (cart_class_t)c, &p->buf[len], cap, &f);
+        if (f != 0U) {
+            account(p, c, f, since, now);
+            frames += f;
+        }
+        if (cart_dirty_class_pending(&p->dirty, (cart_class_t)c) != 0U) {
+            sets_left = true; /* bloc ou part pleins : les classes suivantes attendent */
+            break;
+        }
+    }
+    if (!sets_left && (cart_dirty_pending(&p->dirty) == 0U)) {
+        const size_t cap = admitted(p, (uint8_t)CART_CLASS_BACKGROUND, len);
+        uint32_t gets = 0U;
+        len += cart_sync_emit(&p->sync, &p->buf[len], cap, now, &gets);
+        p->cls[CART_CLASS_BACKGROUND].frames += gets;
+        frames += gets;
+    }
+    if (len == 0U) {
+        p->busy = false;
+        return 0U;
+    }
+    p->busy = true;
+    p->frames += frames;
+    p->bytes += (uint32_t)len;
+    p->window_spent += (uint32_t)len;
+    p->bursts++;
+    return len;
+}
+
+void cart_tx_init(cart_tx_port_t *p, uint32_t get_timeout) {
+    memset((void *)p, 0, sizeof(*p));
+    cart_dirty_init(&p->dirty);
+    cart_sync_init(&p->sync, get_timeout);
+}
+
+void cart_tx_set_budget(cart_tx_port_t *p, uint32_t window, uint32_t bytes) {
+    p->window = window;
+    p->window_bytes = bytes;
+}
+
+size_t cart_tx_kick(cart_tx_port_t *p, uint32_t now) {
+    if (p->busy) {
+        return 0U; /* la fin du transfert en cours reprendra l’ensemble sale */
+    }
+    return start_block(p, now);
+}
+
+size_t cart_tx_complete(cart_tx_port_t *p, uint32_t now) {
+    const size_t len = start_block(p, now);
+    if (len != 0U) {
+        p->chained++;
+    }
+    return len;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file cart_tx.h
+ * @brief Moteur d’émission DMA d’un port cartouche (sans thread).
+ *
+ * Chaque port associe son ensemble de paramètres sales (`cart_dirty_t`) et ses
+ * lectures en cours (`cart_sync_t`) à un tampon DMA unique :
+ * - `cart_tx_kick()` (producteur, sous verrou) démarre un transfert si le
+ *   port est inactif ;
+ * - `cart_tx_complete()` (ISR de fin de DMA, sous verrou) enchaîne le bloc
+ *   contigu suivant, encodé à partir de l’état sale **au moment de la fin du
+ *   transfert** : tout ce qui a été écrit pendant l’émission part dans le bloc
+ *   suivant, avec la dernière valeur.
+ *
+ * Un bloc contient d’abord les SET, classe par classe dans l’ordre de
+ * priorité (`cart_class_t`), puis — seulement si tous les SET sont partis —
+ * les GET autorisés par la fenêtre de lecture : une réponse reflète toujours
+ * les écritures déposées avant la requête.
+ *
+ * Admission : `cart_tx_set_budget()` fixe une fenêtre (un tick d’horloge 24 PPQN)
+ * et les octets que la liaison y transporte. Les SET séquenceur passent
+ * toujours ; les autres classes ne sont admises que tant que les octets
+ * confiés au DMA dans la fenêtre restent sous leur part
+ * (`CART_TX_SHARE_*_PCT`), ce qui garde de la place pour les p-locks du tick.
+ * Une classe refusée reste en attente jusqu’à la fenêtre suivante (compteur
+ * `deferred`) ; elle repart au prochain `cart_tx_kick()`.
+ *
+ * Les deux fonctions renvoient la longueur du bloc à confier au DMA (0 : rien
+ * à émettre). Le tampon n’est réécrit que port inactif, donc jamais pendant
+ * qu’il est lu par le DMA.
+ *
+ * Module sans dépendance RTOS (testé sur hôte avec une UART simulée,
+ * `tests/cart_tx_tests.c`) ; `cart_bus.c` le branche sur le driver UART HAL.
+ *
+ * @ingroup cart
+ */
+
+#ifndef BRICK_CART_CART_TX_H
+#define BRICK_CART_CART_TX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cart_dirty.h"
+#include "cart_sync.h"
+
+/** @brief Taille d’un bloc DMA (≈ 2,6 ms de fil à 500 kbaud). */
+#ifndef CART_TX_BURST_BYTES
+#define CART_TX_BURST_BYTES 128U
+#endif
+
+/** @brief Part de la fenêtre (en %) au-delà de laquelle chaque classe est différée. */
+#ifndef CART_TX_SHARE_RESTORE_PCT
+#define CART_TX_SHARE_RESTORE_PCT 100U
+#endif
+#ifndef CART_TX_SHARE_UI_PCT
+#define CART_TX_SHARE_UI_PCT 75U
+#endif
+#ifndef CART_TX_SHARE_BACKGROUND_PCT
+#define CART_TX_SHARE_BACKGROUND_PCT 50U
+#endif
+
+/**
+ * @brief Statistiques d’une classe de trames.
+ */
+typedef struct {
+    volatile uint32_t frames;       /**< Trames confiées au DMA */
+    volatile uint32_t deferred;     /**< Blocs partis sans elle faute de budget */
+    volatile uint32_t latency_last; /**< Attente de la plus ancienne trame au dernier départ (ticks) */
+    volatile uint32_t latency_max;  /**< Maximum de `latency_last` */
+} cart_tx_class_stats_t;
+
+/**
+ * @brief État d’émission d’un port.
+ * @note Le DMA ne lit pas la CCM du STM32F4 : l’objet doit résider en SRAM.
+ */
+typedef struct {
+    cart_dirty_t      dirty;
+    cart_sync_t       sync;
+    uint8_t           buf[CART_TX_BURST_BYTES];  /**< Bloc en cours de transfert */
+    volatile bool     busy;                      /**< Transfert DMA en cours */
+    volatile uint32_t frames;                    /**< Trames confiées au DMA */
+    volatile uint32_t bytes;                     /**< Octets confiés au DMA */
+    volatile uint32_t bursts;                    /**< Transferts DMA démarrés */
+    volatile uint32_t chained;                   /**< Transferts enchaînés depuis l’ISR */
+    cart_tx_class_stats_t cls[CART_CLASS_COUNT]; /**< Statistiques par classe */
+    uint32_t          window;                    /**< Durée d’une fenêtre d’admission (0 : sans limite) */
+    uint32_t          window_bytes;              /**< Octets transportés par la liaison dans une fenêtre */
+    uint32_t          window_start;              /**< Début de la fenêtre courante */
+    uint32_t          window_spent;              /**< Octets confiés au DMA dans la fenêtre */
+} cart_tx_port_t;
+
+/**
+ * @brief Réinitialise le port (ensemble vide, inactif, compteurs à zéro).
+ * @param get_timeout Délai maximal d’une réponse GET (ticks, voir `cart_sync_init()`).
+ */
+void cart_tx_init(cart_tx_port_t *p, uint32_t get_timeout);
+
+/**
+ * @brief Fixe la fenêtre d’admission (sous verrou).
+ * @param window Durée de la fenêtre (ticks, 0 : admission sans limite).
+ * @param bytes  Octets que la liaison transporte pendant @p window.
+ */
+void cart_tx_set_budget(cart_tx_port_t *p, uint32_t window, uint32_t bytes);
+
+/**
+ * @brief Démarre un transfert si le port est inactif et que des trames attendent.
+ * @return Octets à envoyer depuis `p->buf`, 0 si rien à démarrer.
+ */
+size_t cart_tx_kick(cart_tx_port_t *p, uint32_t now);
+
+/**
+ * @brief Fin de transfert : libère le tampon et enchaîne le bloc suivant.
+ * @return Octets à envoyer depuis `p->buf`, 0 si le port redevient inactif.
+ */
+size_t cart_tx_complete(cart_tx_port_t *p, uint32_t now);
+
+#endif /* BRICK_CART_CART_TX_H */
@@ -101,7 +101,7 @@
 #endif
 
 #if !defined(HAL_USE_UART) || defined(__DOXYGEN__)
-#define HAL_USE_UART                        FALSE
+#define HAL_USE_UART                        TRUE
 #endif
 
 #if !defined(HAL_USE_USB) || defined(__DOXYGEN__)
@@ -47,30 +47,29 @@ static inline void _sanitise_config(arp_config_t *cfg) {
   if (cfg->sync_mode >= ARP_SYNC_COUNT) cfg->sync_mode = ARP_SYNC_INTERNAL;
 }
 
-static inline systime_t _seconds_to_ticks(float seconds) {
-  if (seconds <= 0.0005f) seconds = 0.0005f;
-  const uint32_t usec = (uint32_t)((seconds * 1000000.0f) + 0.5f);
-  return chTimeUS2I(usec);
+// --- ARP: durée d’un pas en ticks 24 PPQN (noire = 24), base temps de l’horloge ---
+static uint32_t _rate_clock_ticks(arp_rate_t rate) {
+  switch (rate) {
+    case ARP_RATE_QUARTER: return 24u;
+    case ARP_RATE_EIGHTH: return 12u;
+    case ARP_RATE_SIXTEENTH: return 6u;
+    case ARP_RATE_THIRTY_SECOND: return 3u;
+    case ARP_RATE_QUARTER_TRIPLET: return 16u; // --- ARP FIX: triplet rates ---
+    case ARP_RATE_EIGHTH_TRIPLET: return 8u;
+    case ARP_RATE_SIXTEENTH_TRIPLET: return 4u;
+    case ARP_RATE_THIRTY_SECOND_TRIPLET: return 2u;
+    default: return 6u;
+  }
 }
 
-static systime_t _compute_period(const arp_config_t *cfg, float bpm) {
-  if (!cfg || bpm <= 0.0f) {
-    bpm = 120.0f;
-  }
-  const float quarter = 60.0f / bpm;
-  float duration = quarter;
-  switch (cfg->rate) {
-    case ARP_RATE_QUARTER: duration = quarter; break;
-    case ARP_RATE_EIGHTH: duration = quarter * 0.5f; break;
-    case ARP_RATE_SIXTEENTH: duration = quarter * 0.25f; break;
-    case ARP_RATE_THIRTY_SECOND: duration = quarter * 0.125f; break;
-    case ARP_RATE_QUARTER_TRIPLET: duration = quarter * (2.0f / 3.0f); break; // --- ARP FIX: triplet rates ---
-    case ARP_RATE_EIGHTH_TRIPLET: duration = quarter / 3.0f; break;
-    case ARP_RATE_SIXTEENTH_TRIPLET: duration = quarter / 6.0f; break;
-    case ARP_RATE_THIRTY_SECOND_TRIPLET: duration = quarter / 12.0f; break;
-    default: duration = quarter * 0.25f; break;
-  }
-  return _seconds_to_ticks(duration);
+static hr_time_t _compute_period(const arp_config_t *cfg) {
+  const uint32_t ticks = cfg ? _rate_clock_ticks(cfg->rate) : 6u;
+  return clock_manager_span_hr(ticks); // même période que les steps du séquenceur, en µs
+}
+
+// --- ARP: échéance atteinte (comparaison au rebouclage près) ---
+static inline bool _due(hr_time_t when, hr_time_t now) {
+  return hr_time_diff(when, now) >= 0;
 }
 
 // --- ARP FIX: helpers pour les groupes Hold / Strum ---
@@ -158,15 +157,14 @@ static void _activate_from_latched(arp_engine_t *engine) {
 
 static void _recompute_periods(arp_engine_t *engine) {
   if (!engine) return;
-  const float bpm = clock_manager_get_bpm();
-  engine->base_period = _compute_period(&engine->config, bpm);
-  if (engine->base_period < TIME_MS2I(1)) {
-    engine->base_period = TIME_MS2I(1);
+  engine->base_period = _compute_period(&engine->config);
+  if (engine->base_period < HR_TIME_MS(1)) {
+    engine->base_period = HR_TIME_MS(1);
   }
   engine->swing_period = (engine->base_period * engine->config.swing_percent) / 100u;
-  systime_t base_offset = TIME_MS2I(engine->config.strum_offset_ms);
+  hr_time_t base_offset = HR_TIME_MS(engine->config.strum_offset_ms);
   if (base_offset > 0u) {
-    systime_t boosted = base_offset * 2u; // --- ARP FIX: impact strum plus prononcé ---
+    hr_time_t boosted = base_offset * 2u; // --- ARP FIX: impact strum plus prononcé ---
     if (boosted < base_offset) {
       boosted = base_offset;
     }
@@ -186,7 +184,7 @@ static void _clear_active_notes(arp_engine_t *engine) {
   engine->pending_on_count = 0u;
 }
 
-static void _reset_runtime(arp_engine_t *engine, systime_t now) {
+static void _reset_runtime(arp_engine_t *engine, hr_time_t now) {
   engine->step_index = 0u;
   engine->direction = 0u;
   engine->next_event = now;
@@ -194,7 +192,7 @@ static void _reset_runtime(arp_engine_t *engine, systime_t now) {
   engine->latched_active = (engine->latched_count > 0u);
 }
 
-static void _try_start(arp_engine_t *engine, systime_t now) {
+static void _try_start(arp_engine_t *engine, hr_time_t now) {
   if (!engine->config.enabled) {
     engine->running = false;
     return;
@@ -225,7 +223,7 @@ static void _try_start(arp_engine_t *engine, systime_t now) {
   }
 }
 
-static void _schedule_note_off(arp_engine_t *engine, uint8_t note, systime_t off_time) {
+static void _schedule_note_off(arp_engine_t *engine, uint8_t note, hr_time_t off_time) {
   if (engine->active_count >= ARP_ARRAY_SIZE(engine->active_notes)) {
     return;
   }
@@ -234,7 +232,7 @@ static void _schedule_note_off(arp_engine_t *engine, uint8_t note, systime_t off
   engine->active_count++;
 }
 
-static void _queue_note_on(arp_engine_t *engine, uint8_t note, uint8_t velocity, systime_t when) {
+static void _queue_note_on(arp_engine_t *engine, uint8_t note, uint8_t velocity, hr_time_t when) {
   if (engine->pending_on_count >= ARP_ARRAY_SIZE(engine->pending_on_notes)) {
     return;
   }
@@ -244,19 +242,19 @@ static void _queue_note_on(arp_engine_t *engine, uint8_t note, uint8_t velocity,
   engine->pending_on_count++;
 }
 
-static void _dispatch_pending_note_ons(arp_engine_t *engine, systime_t now) {
+static void _dispatch_pending_note_ons(arp_engine_t *engine, hr_time_t now) {
   uint8_t w = 0u;
   for (uint8_t i = 0u; i < engine->pending_on_count; ++i) {
-    if (engine->pending_on_time[i] <= now) {
-      const systime_t event_time = engine->pending_on_time[i];
+    if (_due(engine->pending_on_time[i], now)) {
+      const hr_time_t event_time = engine->pending_on_time[i];
       if (engine->callbacks.note_on) {
         engine->callbacks.note_on(engine->pending_on_notes[i], engine->pending_on_vel[i], event_time);
       }
-      const systime_t gate_len = (engine->base_period * engine->config.gate_percent) / 100u;
-      systime_t off_time = event_time + gate_len;
-      if (off_time <= event_time) {
-        off_time = event_time + 1;
+      hr_time_t gate_len = (engine->base_period * engine->config.gate_percent) / 100u;
+      if (gate_len == 0u) {
+        gate_len = 1u;
       }
+      const hr_time_t off_time = event_time + gate_len;
       _schedule_note_off(engine, engine->pending_on_notes[i], off_time);
     } else {
       engine->pending_on_notes[w] = engine->pending_on_notes[i];
@@ -268,10 +266,10 @@ static void _dispatch_pending_note_ons(arp_engine_t *engine, systime_t now) {
   engine->pending_on_count = w;
 }
 
-static void _dispatch_note_offs(arp_engine_t *engine, systime_t now) {
+static void _dispatch_note_offs(arp_engine_t *engine, hr_time_t now) {
   uint8_t w = 0u;
   for (uint8_t i = 0u; i < engine->active_count; ++i) {
-    if (engine->active_until[i] <= now) {
+    if (_due(engine->active_until[i], now)) {
       if (engine->callbacks.note_off) {
         engine->callbacks.note_off(engine->active_notes[i]);
       }
@@ -397,19 +395,19 @@ static uint8_t _build_sequence(const arp_engine_t *engine, uint8_t *notes_out, u
   return count;
 }
 
-static void _emit_single_note(arp_engine_t *engine, uint8_t note, uint8_t velocity, systime_t now) {
-  const systime_t gate_len = (engine->base_period * engine->config.gate_percent) / 100u;
-  systime_t off_time = now + gate_len;
-  if (off_time <= now) {
-    off_time = now + 1;
+static void _emit_single_note(arp_engine_t *engine, uint8_t note, uint8_t velocity, hr_time_t now) {
+  hr_time_t gate_len = (engine->base_period * engine->config.gate_percent) / 100u;
+  if (gate_len == 0u) {
+    gate_len = 1u;
   }
+  const hr_time_t off_time = now + gate_len;
   if (engine->callbacks.note_on) {
     engine->callbacks.note_on(note, velocity, now);
   }
   _schedule_note_off(engine, note, off_time);
 }
 
-static void _emit_sequence(arp_engine_t *engine, const uint8_t *sequence, const uint8_t *velocities, uint8_t count, systime_t now) {
+static void _emit_sequence(arp_engine_t *engine, const uint8_t *sequence, const uint8_t *velocities, uint8_t count, hr_time_t now) {
   if (count == 0u) {
     return;
   }
@@ -454,16 +452,16 @@ static void _emit_sequence(arp_engine_t *engine, const uint8_t *sequence, const
         break;
     }
 
-    systime_t offset = 0u;
+    hr_time_t offset = 0u;
     for (uint8_t i = 0u; i < count; ++i) {
       const uint8_t idx = order[i];
       uint8_t vel = _accent_velocity(engine, velocities[idx], engine->step_index + i);
       vel = _apply_strum_variation(engine, vel);
-      systime_t target_time = now + offset;
+      hr_time_t target_time = now + offset;
       if (engine->config.strum_mode == ARP_STRUM_RANDOM && engine->strum_offset > 0u) {
-        systime_t jitter_max = engine->strum_offset / 3u;
+        hr_time_t jitter_max = engine->strum_offset / 3u;
         if (jitter_max > 0u) {
-          systime_t jitter = (systime_t)(_lcg_next(engine) % (jitter_max + 1u));
+          hr_time_t jitter = (hr_time_t)(_lcg_next(engine) % (jitter_max + 1u));
           if ((_lcg_next(engine) & 1u) != 0u) {
             if (jitter < target_time - now) {
               target_time -= jitter;
@@ -491,7 +489,7 @@ static void _emit_sequence(arp_engine_t *engine, const uint8_t *sequence, const
 void arp_init(arp_engine_t *engine, const arp_config_t *cfg) {
   if (!engine) return;
   memset(engine, 0, sizeof(*engine));
-  engine->random_seed = 0x12345u ^ (uint32_t)chVTGetSystemTimeX();
+  engine->random_seed = 0x12345u ^ (uint32_t)hr_time_now();
   if (cfg) {
     engine->config = *cfg;
   } else {
@@ -516,7 +514,7 @@ void arp_init(arp_engine_t *engine, const arp_config_t *cfg) {
   }
   _sanitise_config(&engine->config);
   _recompute_periods(engine);
-  engine->next_event = chVTGetSystemTimeX();
+  engine->next_event = hr_time_now();
 }
 
 void arp_set_callbacks(arp_engine_t *engine, const arp_callbacks_t *cb) {
@@ -538,7 +536,7 @@ void arp_set_config(arp_engine_t *engine, const arp_config_t *cfg) {
 
 void arp_note_input(arp_engine_t *engine, uint8_t note, uint8_t velocity, bool pressed) {
   if (!engine) return;
-  systime_t now = chVTGetSystemTimeX();
+  const hr_time_t now = hr_time_now();
   if (pressed) {
     const bool had_phys = (engine->phys_count > 0u);
     _insert_sorted_unique(engine->phys_notes, engine->phys_velocities, &engine->phys_count,
@@ -580,7 +578,7 @@ void arp_note_input(arp_engine_t *engine, uint8_t note, uint8_t velocity, bool p
   _try_start(engine, now);
 }
 
-void arp_tick(arp_engine_t *engine, systime_t now) {
+void arp_tick(arp_engine_t *engine, hr_time_t now) {
   if (!engine) return;
   _recompute_periods(engine);
   _dispatch_pending_note_ons(engine, now);
@@ -598,15 +596,22 @@ void arp_tick(arp_engine_t *engine, systime_t now) {
     return;
   }
 
-  if (engine->next_event > now) {
+  if (!_due(engine->next_event, now)) {
     return;
   }
 
+  // --- ARP: pas horodaté à son échéance, pas au réveil du thread UI : la grille
+  // (swing compris) ne glisse pas de la latence de poll ; resynchro si retard > 1 pas ---
+  hr_time_t due = engine->next_event;
+  if ((uint32_t)hr_time_diff(due, now) >= engine->base_period) {
+    due = now;
+  }
+
   uint8_t sequence[64];
   uint8_t velocities[64];
   const uint8_t seq_count = _build_sequence(engine, sequence, velocities);
   if (seq_count == 0u) {
-    engine->next_event = now + engine->base_period;
+    engine->next_event = due + engine->base_period;
     return;
   }
 
@@ -614,16 +619,16 @@ void arp_tick(arp_engine_t *engine, systime_t now) {
     uint8_t index = _resolve_direction_index(engine, seq_count);
     if (index >= seq_count) index = (uint8_t)(seq_count - 1u);
     uint8_t vel = _accent_velocity(engine, velocities[index], engine->step_index);
-    _emit_single_note(engine, sequence[index], vel, now);
+    _emit_single_note(engine, sequence[index], vel, due);
   } else {
-    _emit_sequence(engine, sequence, velocities, seq_count, now);
+    _emit_sequence(engine, sequence, velocities, seq_count, due);
   }
 
-  systime_t period = engine->base_period;
+  hr_time_t period = engine->base_period;
   if ((engine->step_index & 1u) && engine->config.swing_percent > 0u) {
     period += engine->swing_period;
   }
-  engine->next_event = now + period;
+  engine->next_event = due + period;
   _advance_step(engine, seq_count);
 }
 
@@ -637,7 +642,7 @@ void arp_stop_all(arp_engine_t *engine) {
   engine->pending_on_count = 0u;
   _clear_active_notes(engine);
   engine->running = false;
-  engine->next_event = chVTGetSystemTimeX();
+  engine->next_event = hr_time_now();
 }
 
 void arp_set_hold(arp_engine_t *engine, bool enabled) {
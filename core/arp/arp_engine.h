@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "ch.h"
+#include "hr_time.h" // --- ARP: horodatage µs (swing / strum sans arrondi au tick système) ---
 
 #ifdef __cplusplus
 extern "C" {
@@ -82,7 +83,7 @@ typedef struct {
 
 // --- ARP: Callbacks NoteOn/NoteOff ---
 typedef struct {
-  void (*note_on)(uint8_t note, uint8_t velocity, systime_t when); // --- ARP FIX: timestamp pour note on ---
+  void (*note_on)(uint8_t note, uint8_t velocity, hr_time_t when); // --- ARP FIX: timestamp (µs) pour note on ---
   void (*note_off)(uint8_t note);
 } arp_callbacks_t;
 
@@ -104,10 +105,10 @@ typedef struct {
   uint8_t        pattern_velocities[32];
   uint8_t        pattern_count;
 
-  systime_t      next_event;
-  systime_t      base_period;
-  systime_t      swing_period;
-  systime_t      strum_offset;
+  hr_time_t      next_event;
+  hr_time_t      base_period;
+  hr_time_t      swing_period;
+  hr_time_t      strum_offset;
 
   uint32_t       step_index;
   uint8_t        direction;        // 0 up,1 down
@@ -115,12 +116,12 @@ typedef struct {
   uint8_t        strum_phase;      // --- ARP FIX: alt/rnd strum mémoire ---
 
   uint8_t        active_notes[64];
-  systime_t      active_until[64];
+  hr_time_t      active_until[64];
   uint8_t        active_count;
 
   uint8_t        pending_on_notes[64];
   uint8_t        pending_on_vel[64];
-  systime_t      pending_on_time[64];
+  hr_time_t      pending_on_time[64];
   uint8_t        pending_on_count;
 
   uint32_t       random_seed;
@@ -131,7 +132,7 @@ void arp_init(arp_engine_t *engine, const arp_config_t *cfg);
 void arp_set_callbacks(arp_engine_t *engine, const arp_callbacks_t *cb);
 void arp_set_config(arp_engine_t *engine, const arp_config_t *cfg);
 void arp_note_input(arp_engine_t *engine, uint8_t note, uint8_t velocity, bool pressed);
-void arp_tick(arp_engine_t *engine, systime_t now);
+void arp_tick(arp_engine_t *engine, hr_time_t now);
 void arp_stop_all(arp_engine_t *engine);
 void arp_set_hold(arp_engine_t *engine, bool enabled); // --- ARP FIX: API dédiée Hold ---
 
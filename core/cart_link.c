@@ -7,6 +7,11 @@
  * un registre local “shadow” pour chaque cartouche, garantissant la cohérence
  * des valeurs entre l’UI et le bus physique UART.
  *
+ * Resynchronisation : `cart_link_resync()` demande la lecture complète des
+ * paramètres de la cartouche ; `cart_link_sync_poll()` réconcilie les
+ * réponses dans le shadow. Une modification locale postérieure à la requête
+ * l’emporte sur la réponse (bitmap `g_local_touched`).
+ *
  * @ingroup cart
  */
 
@@ -30,6 +35,19 @@
 /** Registres shadow : un tableau par cartouche. */
 static uint8_t g_shadow_params[CART_COUNT][CART_LINK_MAX_DEST_ID];
 
+/** Paramètres modifiés localement depuis leur dernière demande de lecture. */
+static uint32_t g_local_touched[CART_COUNT][(CART_LINK_MAX_DEST_ID + 31) / 32];
+
+static void touch(cart_id_t cid, uint16_t param_id) {
+    (void)__atomic_fetch_or(&g_local_touched[cid][param_id >> 5],
+                            1UL << (param_id & 31U), __ATOMIC_RELAXED);
+}
+
+static bool touched(cart_id_t cid, uint16_t param_id) {
+    return (__atomic_load_n(&g_local_touched[cid][param_id >> 5], __ATOMIC_RELAXED)
+            & (1UL << (param_id & 31U))) != 0U;
+}
+
 /* =======================================================================
  *   Initialisation
  * ======================================================================= */
@@ -41,6 +59,7 @@ static uint8_t g_shadow_params[CART_COUNT][CART_LINK_MAX_DEST_ID];
  */
 void cart_link_init(void) {
     memset(g_shadow_params, 0, sizeof(g_shadow_params));
+    memset(g_local_touched, 0, sizeof(g_local_touched));
 }
 
 /* =======================================================================
@@ -67,6 +86,7 @@ void cart_link_param_changed(uint16_t param_id, uint8_t value,
 
     uint8_t *shadow = &g_shadow_params[active][param_id];
     uint8_t out;
+    touch(active, param_id);
 
     if (is_bitwise) {
         if (value) {
@@ -84,6 +104,23 @@ void cart_link_param_changed(uint16_t param_id, uint8_t value,
     cart_set_param(active, param_id, out);
 }
 
+/**
+ * @brief Envoi d’une valeur complète dans une classe de priorité donnée.
+ *
+ * Utilisé par le séquenceur (p-locks, restaurations) : même mise à jour du
+ * shadow que `cart_link_param_changed()`, classe choisie par l’appelant.
+ */
+void cart_link_param_send(uint16_t param_id, uint8_t value, cart_class_t cls) {
+    cart_id_t active = cart_registry_get_active_id();
+    if (active >= CART_COUNT || param_id >= CART_LINK_MAX_DEST_ID) {
+        return;
+    }
+
+    g_shadow_params[active][param_id] = value;
+    touch(active, param_id);
+    cart_set_param_class(active, cls, param_id, value);
+}
+
 /* =======================================================================
  *   API “Shadow” : accès local aux registres
  * ======================================================================= */
@@ -109,5 +146,59 @@ uint8_t cart_link_shadow_get(cart_id_t cid, uint16_t param_id) {
  */
 void cart_link_shadow_set(cart_id_t cid, uint16_t param_id, uint8_t v) {
     if (cid >= CART_COUNT || param_id >= CART_LINK_MAX_DEST_ID) return;
+    touch(cid, param_id);
     g_shadow_params[cid][param_id] = v;
 }
+
+/* =======================================================================
+ *   Resynchronisation depuis la cartouche
+ * ======================================================================= */
+
+/**
+ * @brief Demande la relecture complète d’une cartouche (hot-plug, preset côté cart).
+ *
+ * Les modifications locales antérieures sont oubliées : les réponses
+ * remplaceront le shadow, sauf pour les paramètres modifiés après cet appel.
+ */
+bool cart_link_resync(cart_id_t cid) {
+    if (cid >= CART_COUNT) return false;
+    for (size_t w = 0; w < (sizeof(g_local_touched[0]) / sizeof(g_local_touched[0][0])); ++w) {
+        __atomic_store_n(&g_local_touched[cid][w], 0U, __ATOMIC_RELAXED);
+    }
+    return cart_bus_request_dump(cid);
+}
+
+/**
+ * @brief Demande la relecture d’un seul paramètre.
+ */
+bool cart_link_request_param(cart_id_t cid, uint16_t param_id) {
+    if (cid >= CART_COUNT || param_id >= CART_LINK_MAX_DEST_ID) return false;
+    (void)__atomic_fetch_and(&g_local_touched[cid][param_id >> 5],
+                             ~(1UL << (param_id & 31U)), __ATOMIC_RELAXED);
+    return cart_get_param(cid, param_id);
+}
+
+/**
+ * @brief Réconcilie les réponses reçues dans le shadow et relance les lectures.
+ *
+ * @return Nombre de valeurs du shadow effectivement modifiées.
+ */
+uint16_t cart_link_sync_poll(void) {
+    uint16_t changed = 0;
+    for (int i = 0; i < CART_COUNT; i++) {
+        const cart_id_t cid = (cart_id_t)i;
+        uint16_t param_id;
+        uint8_t value;
+        while (cart_bus_rx_pop(cid, &param_id, &value)) {
+            if (param_id >= CART_LINK_MAX_DEST_ID || touched(cid, param_id)) {
+                continue; /* valeur locale plus récente que la réponse */
+            }
+            if (g_shadow_params[cid][param_id] != value) {
+                g_shadow_params[cid][param_id] = value;
+                changed++;
+            }
+        }
+        cart_bus_sync_poll(cid);
+    }
+    return changed;
+}
@@ -9,7 +9,8 @@
  * Fournit les primitives pour :
  * - notifier les changements de paramètres issus de l’UI,
  * - gérer les registres shadow locaux (pour éviter les envois redondants),
- * - assurer la cohérence des valeurs entre firmware et DSP externe.
+ * - assurer la cohérence des valeurs entre firmware et DSP externe,
+ * - relire l’état réel de la cartouche (hot-plug, preset chargé côté cartouche).
  *
  * @note Implémente le pont attendu par la couche UI via `ui_backend`.
  * @note Header public : ne dépend que de `cart_bus.h` (types `cart_id_t`, `CARTx`).
@@ -50,6 +51,20 @@ void cart_link_param_changed(uint16_t param_id,
                              bool is_bitwise,
                              uint8_t bit_mask);
 
+/**
+ * @brief Envoie une valeur à la cartouche active dans une classe de priorité.
+ * @ingroup cart_link
+ *
+ * Comme `cart_link_param_changed()` (shadow mis à jour, écriture complète),
+ * mais la trame part dans la classe @p cls : `CART_CLASS_SEQ` pour les
+ * p-locks, `CART_CLASS_RESTORE` pour les valeurs restaurées après p-lock.
+ *
+ * @param param_id Identifiant de paramètre
+ * @param value    Nouvelle valeur
+ * @param cls      Classe de la trame (voir `cart_bus.h`)
+ */
+void cart_link_param_send(uint16_t param_id, uint8_t value, cart_class_t cls);
+
 /**
  * @brief Lecture du shadow local pour une cartouche donnée.
  * @ingroup cart_link
@@ -74,6 +89,34 @@ uint8_t cart_link_shadow_get(cart_id_t cid, uint16_t param_id);
  */
 void cart_link_shadow_set(cart_id_t cid, uint16_t param_id, uint8_t v);
 
+/**
+ * @brief Relit les 512 paramètres d’une cartouche dans le shadow.
+ * @ingroup cart_link
+ *
+ * Lecture par lots (voir `cart_bus_request_dump()`) ; les réponses sont
+ * appliquées par `cart_link_sync_poll()`. Un paramètre modifié localement
+ * après cet appel conserve sa valeur locale.
+ *
+ * @param cid Identifiant de cartouche
+ * @return `false` si le port est invalide ou inactif.
+ */
+bool cart_link_resync(cart_id_t cid);
+
+/**
+ * @brief Relit un paramètre d’une cartouche dans le shadow.
+ * @ingroup cart_link
+ */
+bool cart_link_request_param(cart_id_t cid, uint16_t param_id);
+
+/**
+ * @brief Applique au shadow les réponses reçues et relance les lectures en attente.
+ * @ingroup cart_link
+ *
+ * À appeler périodiquement depuis le thread UI.
+ * @return Nombre de valeurs du shadow modifiées (rafraîchir l’affichage si > 0).
+ */
+uint16_t cart_link_sync_poll(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,125 @@
+/**
+ * @file clock_dda.c
+ * @brief Accumulateur de phase du tempo interne (période rationnelle, Bresenham).
+ *
+ * Invariant : après `n` ticks au tempo constant `m`, `at × m + rem == n × NUM`
+ * avec `0 ≤ rem < m`. L’instant planifié est donc le temps exact tronqué,
+ * jamais plus d’un coup de timer en retard. Un changement de tempo remet le
+ * reste à l’échelle du nouveau dénominateur (fraction de coup conservée).
+ *
+ * @ingroup clock
+ */
+
+#include "clock_dda.h"
+
+_Static_assert(CLOCK_DDA_MBPM_MIN <= CLOCK_DDA_MBPM_MAX, "clock_dda: plage de tempo vide");
+_Static_assert((CLOCK_DDA_NUM / CLOCK_DDA_MBPM_MAX) >= 1U, "clock_dda: intervalle nul au tempo maximal");
+
+/* ======================================================================
+ *                              FONCTIONS INTERNES
+ * ====================================================================== */
+
+static uint32_t clamp_mbpm(uint32_t mbpm) {
+    if (mbpm < CLOCK_DDA_MBPM_MIN) {
+        return CLOCK_DDA_MBPM_MIN;
+    }
+    if (mbpm > CLOCK_DDA_MBPM_MAX) {
+        return CLOCK_DDA_MBPM_MAX;
+    }
+    return mbpm;
+}
+
+/* Nouveau dénominateur : le reste garde la même fraction de coup. */
+static void retune(clock_dda_t *d, uint32_t mbpm) {
+    if (mbpm == d->mbpm) {
+        return;
+    }
+    d->rem = (uint32_t)(((uint64_t)d->rem * mbpm) / d->mbpm);
+    d->mbpm = mbpm;
+}
+
+/* ======================================================================
+ *                              API PUBLIQUE
+ * ====================================================================== */
+
+uint32_t clock_dda_mbpm_from_bpm(float bpm) {
+    if (!(bpm > 0.0f)) {
+        return CLOCK_DDA_MBPM_MIN;
+    }
+    const float mbpm = (bpm * 1000.0f) + 0.5f;
+    if (mbpm >= (float)CLOCK_DDA_MBPM_MAX) {
+        return CLOCK_DDA_MBPM_MAX;
+    }
+    return clamp_mbpm((uint32_t)mbpm);
+}
+
+void clock_dda_init(clock_dda_t *d, uint32_t mbpm) {
+    d->mbpm = clamp_mbpm(mbpm);
+    d->rem = 0U;
+    d->at = 0U;
+    d->ticks = 0U;
+    d->ramp_to = d->mbpm;
+    d->ramp_left = 0U;
+}
+
+uint32_t clock_dda_start(clock_dda_t *d) {
+    d->rem = 0U;
+    d->at = 0U;
+    d->ticks = 0U;
+    return clock_dda_next(d);
+}
+
+uint32_t clock_dda_next(clock_dda_t *d) {
+    if (d->ramp_left > 0U) {
+        const int64_t delta = (int64_t)d->ramp_to - (int64_t)d->mbpm;
+        d->ramp_left--;
+        retune(d, (d->ramp_left == 0U) ? d->ramp_to
+                                       : (uint32_t)((int64_t)d->mbpm + (delta / (int64_t)(d->ramp_left + 1U))));
+    }
+
+    const uint64_t acc = (uint64_t)d->rem + CLOCK_DDA_NUM;
+    const uint32_t interval = (uint32_t)(acc / d->mbpm);
+    d->rem = (uint32_t)(acc - ((uint64_t)interval * d->mbpm));
+    d->at += interval;
+    d->ticks++;
+    return interval;
+}
+
+void clock_dda_set_tempo(clock_dda_t *d, uint32_t mbpm) {
+    d->ramp_left = 0U;
+    d->ramp_to = clamp_mbpm(mbpm);
+    retune(d, d->ramp_to);
+}
+
+void clock_dda_ramp(clock_dda_t *d, uint32_t mbpm, uint32_t ticks) {
+    if (ticks == 0U) {
+        clock_dda_set_tempo(d, mbpm);
+        return;
+    }
+    d->ramp_to = clamp_mbpm(mbpm);
+    d->ramp_left = ticks;
+}
+
+uint32_t clock_dda_tempo(const clock_dda_t *d) {
+    return d->mbpm;
+}
+
+uint64_t clock_dda_time(const clock_dda_t *d) {
+    return d->at;
+}
+
+systime_t clock_dda_to_st(systime_t origin, uint64_t at) {
+    const uint64_t st = ((at * CLOCK_DDA_ST_HZ) + (CLOCK_DDA_TIMER_HZ / 2U)) / CLOCK_DDA_TIMER_HZ;
+    return (systime_t)(origin + (systime_t)st);
+}
+
+systime_t clock_dda_span_st(const clock_dda_t *d, uint32_t ticks) {
+    /* NUM × ST_HZ / TIMER_HZ = 2500 × ST_HZ : exact, un seul arrondi. */
+    const uint64_t num = (uint64_t)ticks * 2500U * CLOCK_DDA_ST_HZ;
+    return (systime_t)((num + (d->mbpm / 2U)) / d->mbpm);
+}
+
+uint32_t clock_dda_span(const clock_dda_t *d, uint32_t ticks) {
+    const uint64_t num = (uint64_t)ticks * CLOCK_DDA_NUM;
+    return (uint32_t)((num + (d->mbpm / 2U)) / d->mbpm);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file clock_dda.h
+ * @brief Générateur de tempo à accumulateur de phase (DDA) pour l’horloge interne.
+ *
+ * La période exacte d’un tick 24 PPQN vaut `60 × f_timer / (24 × bpm)` coups
+ * de timer, rarement entière. Plutôt que d’arrondir une fois pour toutes
+ * (erreur répétée à chaque tick, donc dérive), le générateur tient la période
+ * comme un rationnel `CLOCK_DDA_NUM / mbpm` (tempo en millièmes de BPM) et
+ * distribue le reste à la Bresenham : chaque intervalle est entier, leur somme
+ * ne s’écarte jamais de plus d’un coup de timer du temps exact.
+ *
+ * - dérive cumulée nulle (l’erreur reste bornée, quel que soit le nombre de ticks) ;
+ * - changement de tempo et rampes (accelerando) appliqués tick par tick, sans
+ *   redémarrer le timer ni perdre la phase ;
+ * - horodatage absolu de chaque tick (`clock_dda_time()`), converti sans dérive
+ *   vers `systime_t` : c’est l’horodatage de référence de `clock_step_info_t`.
+ *
+ * Module purement calculatoire (aucun appel RTOS) : `midi_clock` l’appelle
+ * depuis l’ISR du timer (`tests/clock_dda_tests.c` sur hôte).
+ *
+ * @ingroup clock
+ */
+
+#ifndef CLOCK_DDA_H
+#define CLOCK_DDA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ch.h"    // systime_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup clock
+ *  @{
+ */
+
+/* ======================================================================
+ *                              CONFIGURATION
+ * ====================================================================== */
+
+/** Fréquence du timer matériel cadençant les ticks (Hz). */
+#ifndef CLOCK_DDA_TIMER_HZ
+#define CLOCK_DDA_TIMER_HZ 1000000U
+#endif
+
+/** Fréquence de la base de temps `systime_t` (Hz). */
+#ifndef CLOCK_DDA_ST_HZ
+#if defined(CH_CFG_ST_FREQUENCY)
+#define CLOCK_DDA_ST_HZ CH_CFG_ST_FREQUENCY
+#else
+#define CLOCK_DDA_ST_HZ 10000U
+#endif
+#endif
+
+/** Intervalle maximal programmable (timer 16 bits). */
+#ifndef CLOCK_DDA_INTERVAL_MAX
+#define CLOCK_DDA_INTERVAL_MAX 65535U
+#endif
+
+/** Numérateur de la période : `60 × f_timer × 1000 / 24` (période = NUM / mbpm). */
+#define CLOCK_DDA_NUM ((uint64_t)CLOCK_DDA_TIMER_HZ * 2500U)
+
+/** Tempo minimal (mBPM) : la période tient dans `CLOCK_DDA_INTERVAL_MAX`. */
+#define CLOCK_DDA_MBPM_MIN ((uint32_t)((CLOCK_DDA_NUM + CLOCK_DDA_INTERVAL_MAX - 1U) / CLOCK_DDA_INTERVAL_MAX))
+/** Tempo maximal (mBPM). */
+#ifndef CLOCK_DDA_MBPM_MAX
+#define CLOCK_DDA_MBPM_MAX 999000U
+#endif
+
+/* ======================================================================
+ *                               TYPES
+ * ====================================================================== */
+
+/**
+ * @brief État du générateur (un par horloge).
+ *
+ * Le temps est compté en coups de timer depuis `clock_dda_start()`.
+ */
+typedef struct {
+    uint32_t mbpm;       /**< Tempo courant (millièmes de BPM), dénominateur de la période */
+    uint32_t rem;        /**< Reste de l’accumulateur (< `mbpm`) */
+    uint64_t at;         /**< Instant du dernier tick planifié */
+    uint32_t ticks;      /**< Ticks planifiés depuis le départ */
+    uint32_t ramp_to;    /**< Tempo visé par la rampe en cours */
+    uint32_t ramp_left;  /**< Ticks restants de la rampe (0 : pas de rampe) */
+} clock_dda_t;
+
+/* ======================================================================
+ *                               API
+ * ====================================================================== */
+
+/** Convertit un tempo en BPM vers des mBPM bornés. */
+uint32_t clock_dda_mbpm_from_bpm(float bpm);
+
+/** Initialise le générateur au tempo @p mbpm (phase à zéro). */
+void clock_dda_init(clock_dda_t *d, uint32_t mbpm);
+
+/**
+ * @brief Remet la phase à zéro et planifie le premier tick.
+ * @return Intervalle (coups de timer) jusqu’au premier tick.
+ */
+uint32_t clock_dda_start(clock_dda_t *d);
+
+/**
+ * @brief Planifie le tick suivant (appelé à chaque tick, en ISR).
+ *
+ * Avance la rampe éventuelle, puis l’accumulateur.
+ * @return Intervalle (coups de timer) entre le tick courant et le suivant.
+ */
+uint32_t clock_dda_next(clock_dda_t *d);
+
+/**
+ * @brief Change le tempo à partir du prochain intervalle planifié.
+ *
+ * La fraction de coup accumulée est conservée (reste remis à l’échelle) ;
+ * une rampe en cours est abandonnée.
+ */
+void clock_dda_set_tempo(clock_dda_t *d, uint32_t mbpm);
+
+/**
+ * @brief Rampe linéaire du tempo courant vers @p mbpm sur @p ticks ticks.
+ *
+ * `ticks == 0` équivaut à `clock_dda_set_tempo()`.
+ */
+void clock_dda_ramp(clock_dda_t *d, uint32_t mbpm, uint32_t ticks);
+
+/** Tempo courant (mBPM). */
+uint32_t clock_dda_tempo(const clock_dda_t *d);
+
+/** Instant du dernier tick planifié (coups de timer depuis le départ). */
+uint64_t clock_dda_time(const clock_dda_t *d);
+
+/**
+ * @brief Convertit un instant du générateur en `systime_t`.
+ *
+ * Arrondi calculé sur l’instant absolu : aucune erreur ne s’accumule d’un tick
+ * à l’autre. Le résultat reboucle comme `systime_t`.
+ * @param origin Valeur de `systime_t` au départ du générateur.
+ */
+systime_t clock_dda_to_st(systime_t origin, uint64_t at);
+
+/**
+ * @brief Durée de @p ticks ticks au tempo courant, en `systime_t` (arrondie une fois).
+ *
+ * `clock_dda_span_st(d, 6)` est la durée exacte d’un step, et non six fois
+ * une durée de tick déjà arrondie.
+ */
+systime_t clock_dda_span_st(const clock_dda_t *d, uint32_t ticks);
+
+/** Durée de @p ticks ticks au tempo courant, en coups de timer (arrondie une fois). */
+uint32_t clock_dda_span(const clock_dda_t *d, uint32_t ticks);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_DDA_H */
@@ -0,0 +1,45 @@
+/**
+ * @file clock_jitter.c
+ * @brief Sonde de gigue d’une suite d’événements périodiques (µs).
+ *
+ * @ingroup clock
+ */
+
+#include "clock_jitter.h"
+
+#include <string.h>
+
+/* ======================================================================
+ *                              API PUBLIQUE
+ * ====================================================================== */
+
+void clock_jitter_reset(clock_jitter_t *j) {
+    memset(j, 0, sizeof(*j));
+}
+
+void clock_jitter_rebase(clock_jitter_t *j) {
+    j->primed = false;
+}
+
+void clock_jitter_add(clock_jitter_t *j, hr_time_t nominal, hr_time_t actual) {
+    const int32_t late = hr_time_diff(nominal, actual);
+    j->late_last = (late > 0) ? (uint32_t)late : 0U;
+    if (j->late_last > j->late_max) {
+        j->late_max = j->late_last;
+    }
+    j->late_sum += j->late_last;
+
+    if (j->primed) {
+        const int32_t err = hr_time_diff(j->prev_actual, actual) - hr_time_diff(j->prev_nominal, nominal);
+        j->jitter_last = (err < 0) ? (uint32_t)(-err) : (uint32_t)err;
+        if (j->jitter_last > j->jitter_max) {
+            j->jitter_max = j->jitter_last;
+        }
+        j->jitter_sum += j->jitter_last;
+        j->intervals++;
+    }
+    j->prev_nominal = nominal;
+    j->prev_actual = actual;
+    j->primed = true;
+    j->samples++;
+}
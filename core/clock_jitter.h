@@ -0,0 +1,74 @@
+/**
+ * @file clock_jitter.h
+ * @brief Sonde de gigue d’une suite d’événements périodiques (µs).
+ *
+ * Chaque échantillon associe l’instant nominal d’un événement (tick planifié
+ * par l’accumulateur de phase) à son instant réel d’exécution :
+ * - retard : `réel − nominal` (borné à 0 si l’événement est en avance) ;
+ * - gigue : écart entre l’intervalle réel de deux événements consécutifs et
+ *   leur intervalle nominal, en valeur absolue. C’est ce que voit un appareil
+ *   esclave : un retard constant ne le gêne pas, sa variation si.
+ *
+ * Module purement calculatoire : `midi_clock` l’alimente depuis l’ISR du
+ * timer (émission F8) et depuis le thread séquenceur ; le simulateur hôte
+ * (`tests/clock_jitter_tests.c`) mesure les mêmes grandeurs.
+ *
+ * @ingroup clock
+ */
+
+#ifndef CLOCK_JITTER_H
+#define CLOCK_JITTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hr_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup clock
+ *  @{
+ */
+
+/** @brief Statistiques d’une sonde (µs). */
+typedef struct {
+    volatile uint32_t samples;      /**< Événements mesurés. */
+    volatile uint32_t late_last;    /**< Retard du dernier événement. */
+    volatile uint32_t late_max;     /**< Retard maximal. */
+    volatile uint32_t late_sum;     /**< Somme des retards (moyenne = sum / samples). */
+    volatile uint32_t intervals;    /**< Intervalles mesurés (gigue). */
+    volatile uint32_t jitter_last;  /**< Gigue du dernier intervalle. */
+    volatile uint32_t jitter_max;   /**< Gigue maximale. */
+    volatile uint32_t jitter_sum;   /**< Somme des gigues (moyenne = sum / intervals). */
+    hr_time_t         prev_nominal; /**< Instant nominal de l’événement précédent. */
+    hr_time_t         prev_actual;  /**< Instant réel de l’événement précédent. */
+    bool              primed;       /**< Un événement précédent sert de référence. */
+} clock_jitter_t;
+
+/** Remet la sonde à zéro (la gigue repart du prochain couple d’événements). */
+void clock_jitter_reset(clock_jitter_t *j);
+
+/**
+ * @brief Oublie l’événement précédent en gardant les statistiques.
+ *
+ * À appeler quand la suite nominale change d’origine (redémarrage du
+ * transport) : l’intervalle à travers la coupure n’est pas une gigue.
+ */
+void clock_jitter_rebase(clock_jitter_t *j);
+
+/**
+ * @brief Intègre un événement.
+ * @param nominal Instant planifié.
+ * @param actual  Instant d’exécution mesuré.
+ */
+void clock_jitter_add(clock_jitter_t *j, hr_time_t nominal, hr_time_t actual);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_JITTER_H */
@@ -7,15 +7,16 @@
  * - Source d’horloge interne ou externe (via MIDI)
  * - Conversion 24 PPQN → 1/16 (6 ticks MIDI par pas)
  * - Démarrage / arrêt synchronisé (Start/Stop/SongPos)
- * - Gestion du tempo via `midi_clock`
+ * - Gestion du tempo via `midi_clock` (maître) ou `clock_slave` (esclave)
  *
  * @ingroup clock
  */
 
 #include "clock_manager.h"
+#include "clock_slave.h"
 #include "midi_clock.h"
 #include "midi.h"
-#include "hal.h"   // chTimeUS2I()
+#include "hal.h"
 
 /* ======================================================================
  *                              ÉTAT GLOBAL
@@ -23,80 +24,134 @@
 
 static clock_source_t   s_src          = CLOCK_SRC_INTERNAL;  /**< Source actuelle de l’horloge */
 static clock_step_cb2_t s_step_cb_v2   = NULL;                 /**< Callback V2 (recommandé) */
+static clock_tick_cb_t  s_tick_cb      = NULL;                 /**< Callback par tick 24 PPQN */
+static clock_transport_cb_t s_transport_cb = NULL;             /**< Callback transport (mode esclave) */
+static clock_service_cb_t s_service_cb = NULL;                 /**< Callback de service entre les ticks */
 static uint32_t         s_tick_count   = 0;                    /**< Compteur interne de ticks MIDI (0..5) */
 static uint32_t         s_step_idx_abs = 0;                    /**< Compteur absolu de steps 1/16 */
+static bool             s_ext_running  = false;                /**< Transport du maître en marche (esclave) */
+/** Sérialise ticks, steps, transport et service : en esclave, les ticks arrivent du
+ *  thread MIDI alors que le service tourne dans `clock_seq`. */
+static mutex_t          s_cb_mtx;
 
 /* ======================================================================
  *                              FONCTIONS INTERNES
  * ====================================================================== */
 
 /**
- * @brief Convertit le BPM courant en durées `systime_t` pour 1 tick et 1 step.
- * @param bpm Tempo actuel
- * @param[out] tick_st Durée d’1 tick MIDI (24 PPQN) en `systime_t`
- * @param[out] step_st Durée d’1 step (1/16 = 6 ticks) en `systime_t`
+ * @brief Tempo et durées courants selon la source active.
+ *
+ * En esclave, les valeurs lissées par la PLL `clock_slave` remplacent le
+ * tempo du générateur interne dès qu’une période a été mesurée.
  */
-static inline void compute_periods_st(float bpm, systime_t *tick_st, systime_t *step_st) {
-    if (bpm < 0.5f) bpm = 120.0f; // garde-fou
-    // Période d’1 tick en microsecondes : 60e6 / (bpm * 24)
-    const float    tick_us_f = 60000000.0f / (bpm * 24.0f);
-    const uint32_t tick_us   = (uint32_t)(tick_us_f + 0.5f);
-    const systime_t t_st     = chTimeUS2I(tick_us);
-    if (tick_st) *tick_st = t_st;
-    if (step_st) *step_st = t_st * 6U;
+static float current_timing(clock_step_info_t *info) {
+    info->tick_hr = clock_manager_span_hr(1U);
+    info->step_hr = clock_manager_span_hr(6U);
+    if ((s_src == CLOCK_SRC_MIDI) && clock_slave_get_periods(&info->tick_st, &info->step_st)) {
+        return clock_slave_get_bpm();
+    }
+    // Durées issues de la période exacte du générateur (arrondies une fois chacune).
+    info->tick_st = midi_clock_span_st(1U);
+    info->step_st = midi_clock_span_st(6U);
+    return midi_clock_get_bpm();
 }
 
 /**
  * @brief Gère un tick MIDI (1/24) → conversion en steps 1/16.
  *
- * Tous les 6 ticks MIDI, déclenche le callback V2.
- * Appelée depuis le thread `midi_clock` (pas en ISR).
+ * Notifie le callback de tick à chaque tick, puis tous les 6 ticks MIDI
+ * déclenche le callback V2.
+ * Appelée depuis le thread séquenceur `clock_seq` ou le thread de réception MIDI
+ * (esclave), pas en ISR.
+ * @param now    Horodatage du tick (génération interne ou réception du F8).
+ * @param now_hr Même instant en µs.
  */
-static void handle_tick(void) {
+static void handle_tick(systime_t now, hr_time_t now_hr) {
+    chMtxLock(&s_cb_mtx);
+    if (s_tick_cb) {
+        s_tick_cb(now);
+    }
+
     s_tick_count++;
     if (s_tick_count < 6U) {
+        chMtxUnlock(&s_cb_mtx);
         return;
     }
 
     // 6 ticks → 1 step
     s_tick_count = 0U;
-    const systime_t now = chVTGetSystemTimeX();
-    const float     bpm = midi_clock_get_bpm();
-
-    systime_t tick_st, step_st;
-    compute_periods_st(bpm, &tick_st, &step_st);
 
     if (s_step_cb_v2) {
         clock_step_info_t info = {
             .now          = now,
             .step_idx_abs = s_step_idx_abs,
-            .bpm          = bpm,
-            .tick_st      = tick_st,
-            .step_st      = step_st,
-            .ext_clock    = (s_src == CLOCK_SRC_MIDI)
+            .ext_clock    = (s_src == CLOCK_SRC_MIDI),
+            .now_hr       = now_hr
         };
+        info.bpm = current_timing(&info);
         s_step_cb_v2(&info);
     }
 
     // Incrément du compteur absolu de steps (après notification)
     s_step_idx_abs++;
+    chMtxUnlock(&s_cb_mtx);
 }
 
 /**
  * @brief Callback appelé à chaque tick MIDI (F8) par `midi_clock`.
  *
  * Redirige selon la source d’horloge active.
- * @note Appelé depuis le **thread** midi_clock (priorité haute), pas en ISR.
+ * @param now    Horodatage nominal du tick (accumulateur de phase de `midi_clock`),
+ *               indépendant de la latence de réveil du thread.
+ * @param now_hr Même instant en µs.
+ * @note Appelé depuis le **thread** séquenceur `clock_seq` (priorité haute), pas
+ *       en ISR : le F8 du tick est déjà parti de l’ISR du timer.
  */
-static void on_midi_tick(void) {
+static void on_midi_tick(systime_t now, hr_time_t now_hr) {
     if (s_src == CLOCK_SRC_INTERNAL) {
-        handle_tick();
-    } else {
-        // TODO: mode esclave externe → gestion d'une source MIDI Clock externe
-        // (filtrage F8 in, resynchronisation, etc.)
+        handle_tick(now, now_hr);
+    }
+    // En esclave, les ticks viennent de clock_manager_on_midi_realtime().
+}
+
+/**
+ * @brief Arme le départ : le prochain F8 déclenche immédiatement le step courant.
+ */
+static void arm_first_step(void) {
+    s_tick_count = 5U;
+}
+
+/**
+ * @brief Position SPP (doubles-croches, 14 bits) d’un index absolu de step.
+ *
+ * Au-delà de 16383 steps (≈ 1 h à 120 BPM), la position reboucle comme celle
+ * du maître qui l’émettrait.
+ */
+static uint16_t spp_from_step(uint32_t step_idx_abs) {
+    return (uint16_t)(step_idx_abs & 0x3FFFU);
+}
+
+static void notify_transport(clock_transport_event_t ev) {
+    if (s_transport_cb) {
+        chMtxLock(&s_cb_mtx);
+        s_transport_cb(ev, s_step_idx_abs);
+        chMtxUnlock(&s_cb_mtx);
     }
 }
 
+/**
+ * @brief Service entre les ticks, appelé par `midi_clock` dans le thread `clock_seq`.
+ */
+static bool on_midi_service(systime_t now, systime_t *next_due) {
+    if (s_service_cb == NULL) {
+        return false;
+    }
+    chMtxLock(&s_cb_mtx);
+    const bool armed = s_service_cb(now, next_due);
+    chMtxUnlock(&s_cb_mtx);
+    return armed;
+}
+
 /* ======================================================================
  *                              API PUBLIQUE
  * ====================================================================== */
@@ -105,12 +160,27 @@ void clock_manager_init(clock_source_t src) {
     s_src          = src;
     s_tick_count   = 0U;
     s_step_idx_abs = 0U;
+    s_ext_running  = false;
+    chMtxObjectInit(&s_cb_mtx);
+    clock_slave_reset();
 
     midi_clock_init();
     midi_clock_register_tick_callback(on_midi_tick);
+    midi_clock_register_service_callback(on_midi_service);
 }
 
-void clock_manager_set_source(clock_source_t src) { s_src = src; }
+void clock_manager_set_source(clock_source_t src) {
+    if (src == s_src) {
+        return;
+    }
+    if (src == CLOCK_SRC_MIDI) {
+        // Le maître pilote désormais le transport : plus de F8 générés localement.
+        midi_clock_stop();
+        clock_slave_reset();
+    }
+    s_ext_running = false;
+    s_src = src;
+}
 
 clock_source_t clock_manager_get_source(void) { return s_src; }
 
@@ -120,29 +190,151 @@ void clock_manager_set_bpm(float bpm) {
     }
 }
 
-float clock_manager_get_bpm(void) { return midi_clock_get_bpm(); }
+void clock_manager_ramp_bpm(float bpm, uint32_t ticks) {
+    if (s_src == CLOCK_SRC_INTERNAL) {
+        midi_clock_ramp_bpm(bpm, ticks);
+    }
+}
+
+systime_t clock_manager_span_st(uint32_t ticks) {
+    if ((s_src == CLOCK_SRC_MIDI) && clock_slave_has_period()) {
+        const uint64_t q16 = (uint64_t)clock_slave_get_period_q16() * ticks;
+        return (systime_t)((q16 + (1UL << 15)) >> 16);
+    }
+    return midi_clock_span_st(ticks);
+}
+
+hr_time_t clock_manager_span_hr(uint32_t ticks) {
+    if ((s_src == CLOCK_SRC_MIDI) && clock_slave_has_period()) {
+        // Période PLL en systime Q16 : la conversion en µs garde la fraction.
+        const uint64_t q16 = (uint64_t)clock_slave_get_period_q16() * ticks * HR_TIME_PER_ST;
+        return (hr_time_t)((q16 + (1UL << 15)) >> 16);
+    }
+    return midi_clock_span_hr(ticks);
+}
+
+float clock_manager_get_bpm(void) {
+    if ((s_src == CLOCK_SRC_MIDI) && clock_slave_has_period()) {
+        return clock_slave_get_bpm();
+    }
+    return midi_clock_get_bpm();
+}
 
 void clock_manager_start(void) {
     if (s_src == CLOCK_SRC_INTERNAL) {
         // S’assurer que le premier step part immédiatement après le 1er F8
-        s_tick_count   = 5U;
+        arm_first_step();
         s_step_idx_abs = 0U;
 
         midi_song_position(MIDI_DEST_USB, 0);
         midi_start(MIDI_DEST_USB);
         midi_clock_start();
-    } else {
-        // TODO: support futur du mode esclave externe
     }
+    // En esclave, le départ est donné par le FA/FB du maître.
+}
+
+void clock_manager_continue(void) {
+    if ((s_src == CLOCK_SRC_INTERNAL) && !midi_clock_is_running()) {
+        arm_first_step();
+        // Position d’abord : un esclave reprend au SPP reçu transport arrêté.
+        midi_song_position(MIDI_DEST_BOTH, spp_from_step(s_step_idx_abs));
+        midi_continue(MIDI_DEST_USB);
+        midi_clock_start();
+    }
+    // En esclave, la reprise est donnée par le FB du maître.
+}
+
+bool clock_manager_locate(uint32_t step_idx_abs) {
+    if (clock_manager_is_running()) {
+        return false;
+    }
+    s_step_idx_abs = step_idx_abs;
+    arm_first_step();
+    return true;
+}
+
+uint32_t clock_manager_get_position(void) {
+    return s_step_idx_abs;
 }
 
 void clock_manager_stop(void) {
-    midi_stop(MIDI_DEST_USB);
-    midi_clock_stop();
+    if (s_src == CLOCK_SRC_INTERNAL) {
+        midi_stop(MIDI_DEST_USB);
+        midi_clock_stop();
+    } else {
+        // Arrêt local : on ignore les F8 jusqu’au prochain FA/FB du maître.
+        s_ext_running = false;
+    }
 }
 
-bool clock_manager_is_running(void) { return midi_clock_is_running(); }
+bool clock_manager_is_running(void) {
+    if (s_src == CLOCK_SRC_MIDI) {
+        return s_ext_running;
+    }
+    return midi_clock_is_running();
+}
 
 void clock_manager_register_step_callback2(clock_step_cb2_t cb) {
     s_step_cb_v2 = cb;
 }
+
+void clock_manager_register_tick_callback(clock_tick_cb_t cb) {
+    s_tick_cb = cb;
+}
+
+void clock_manager_register_service_callback(clock_service_cb_t cb) {
+    s_service_cb = cb;
+}
+
+void clock_manager_register_transport_callback(clock_transport_cb_t cb) {
+    s_transport_cb = cb;
+}
+
+void clock_manager_on_midi_realtime(uint8_t status, hr_time_t ts) {
+    if (s_src != CLOCK_SRC_MIDI) {
+        return;
+    }
+
+    switch (status) {
+    case 0xF8: {
+        // La PLL suit le maître même à l’arrêt : tempo prêt dès le FA.
+        const systime_t ts_st = hr_time_to_st(ts);
+        (void)clock_slave_on_tick(ts_st);
+        if (s_ext_running) {
+            handle_tick(ts_st, ts);
+            // Événements planifiés hors de clock_seq : son échéance de service a pu avancer.
+            midi_clock_kick();
+        }
+        break;
+    }
+    case 0xFA:
+        s_step_idx_abs = 0U;
+        arm_first_step();
+        s_ext_running = true;
+        notify_transport(CLOCK_TRANSPORT_START);
+        break;
+    case 0xFB:
+        // Reprise au step fixé par le dernier SPP (ou là où le maître s’était arrêté).
+        arm_first_step();
+        s_ext_running = true;
+        notify_transport(CLOCK_TRANSPORT_CONTINUE);
+        break;
+    case 0xFC:
+        if (s_ext_running) {
+            s_ext_running = false;
+            notify_transport(CLOCK_TRANSPORT_STOP);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void clock_manager_on_song_position(uint16_t position) {
+    if ((s_src != CLOCK_SRC_MIDI) || s_ext_running) {
+        return;
+    }
+    // 1 « MIDI beat » SPP = 6 F8 = 1 step 1/16.
+    s_step_idx_abs = position;
+    arm_first_step();
+}
@@ -16,7 +16,9 @@
 #define CLOCK_MANAGER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "ch.h"    // systime_t
+#include "hr_time.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,12 +44,15 @@ typedef enum {
 /**
  * @brief Informations complètes passées au callback à chaque “step” (1/16).
  *
- * - `now` : horodatage absolu en `systime_t` (base ChibiOS)
+ * - `now` : horodatage nominal du tick en `systime_t` (base ChibiOS) : accumulateur de
+ *   phase du générateur interne, ou réception du F8 en esclave
  * - `step_idx_abs` : compteur de pas 1/16 depuis le start (peut déborder)
  * - `bpm` : tempo courant
  * - `tick_st` : durée d’1 tick MIDI (24 PPQN) en `systime_t`
  * - `step_st` : durée d’1 step (1/16 = 6 ticks) en `systime_t`
  * - `ext_clock` : true si la source active est une horloge externe
+ * - `now_hr`, `tick_hr`, `step_hr` : mêmes grandeurs en µs (`hr_time.h`), pour
+ *   la capture live et l’arpégiateur (les `*_st` servent l’ordonnanceur)
  */
 typedef struct {
     systime_t now;
@@ -56,6 +61,9 @@ typedef struct {
     systime_t tick_st;
     systime_t step_st;
     bool      ext_clock;
+    hr_time_t now_hr;
+    hr_time_t tick_hr;
+    hr_time_t step_hr;
 } clock_step_info_t;
 
 /**
@@ -63,6 +71,36 @@ typedef struct {
  */
 typedef void (*clock_step_cb2_t)(const clock_step_info_t *info);
 
+/**
+ * @brief Prototype du callback appelé à chaque tick MIDI (24 PPQN).
+ * @param now Horodatage du tick en `systime_t`.
+ */
+typedef void (*clock_tick_cb_t)(systime_t now);
+
+/**
+ * @brief Prototype du callback de service entre les ticks.
+ * @param now      Heure courante.
+ * @param next_due Prochaine échéance à servir (sortie).
+ * @return false s’il n’y a rien à servir.
+ */
+typedef bool (*clock_service_cb_t)(systime_t now, systime_t *next_due);
+
+/**
+ * @brief Évènements de transport reçus d’un maître MIDI (mode esclave).
+ */
+typedef enum {
+    CLOCK_TRANSPORT_START,     /**< 0xFA : départ depuis le début */
+    CLOCK_TRANSPORT_CONTINUE,  /**< 0xFB : reprise à la position courante (SPP) */
+    CLOCK_TRANSPORT_STOP       /**< 0xFC : arrêt */
+} clock_transport_event_t;
+
+/**
+ * @brief Prototype du callback de transport externe.
+ * @param ev Évènement reçu.
+ * @param step_idx_abs Index du prochain step joué (0 pour START, SPP pour CONTINUE).
+ */
+typedef void (*clock_transport_cb_t)(clock_transport_event_t ev, uint32_t step_idx_abs);
+
 /* ======================================================================
  *                               API
  * ====================================================================== */
@@ -88,17 +126,59 @@ clock_source_t clock_manager_get_source(void);
  */
 void clock_manager_set_bpm(float bpm);
 
+/**
+ * @brief Rampe de tempo vers @p bpm sur @p ticks ticks 24 PPQN (horloge interne).
+ *
+ * Appliquée tick par tick par le générateur, sans redémarrage ni saut de phase.
+ */
+void clock_manager_ramp_bpm(float bpm, uint32_t ticks);
+
 /**
  * @brief Récupère le tempo courant (BPM).
  */
 float clock_manager_get_bpm(void);
 
+/**
+ * @brief Durée de @p ticks ticks 24 PPQN au tempo courant, en `systime_t`.
+ *
+ * Même référence que `clock_step_info_t` : période exacte du générateur
+ * interne, ou période filtrée de la PLL en esclave. Arrondie une seule fois.
+ */
+systime_t clock_manager_span_st(uint32_t ticks);
+
+/**
+ * @brief Variante de `clock_manager_span_st()` en µs (`hr_time_t`).
+ */
+hr_time_t clock_manager_span_hr(uint32_t ticks);
+
 /**
  * @brief Démarre la génération d’horloge.
  * Envoie aussi `MIDI Start` sur la sortie active et réinitialise l’index de step.
  */
 void clock_manager_start(void);
 
+/**
+ * @brief Reprend la génération d’horloge à la position courante (horloge interne).
+ *
+ * Envoie `Song Position Pointer` puis `MIDI Continue` : les esclaves reprennent
+ * au même step. La position est celle où le transport s’est arrêté, ou celle
+ * fixée par `clock_manager_locate()`. Sans effet si l’horloge tourne déjà.
+ */
+void clock_manager_continue(void);
+
+/**
+ * @brief Fixe le prochain step joué (transport à l’arrêt).
+ *
+ * Départ depuis une position arbitraire : `clock_manager_locate(n)` puis
+ * `clock_manager_continue()`. Le runner reconstitue l’état du step (notes
+ * tenues) au premier step joué.
+ * @return false si le transport tourne (position inchangée).
+ */
+bool clock_manager_locate(uint32_t step_idx_abs);
+
+/** @brief Index absolu du prochain step joué (position de reprise transport à l’arrêt). */
+uint32_t clock_manager_get_position(void);
+
 /**
  * @brief Arrête la génération d’horloge (et envoie `MIDI Stop`).
  */
@@ -115,6 +195,53 @@ bool clock_manager_is_running(void);
  */
 void clock_manager_register_step_callback2(clock_step_cb2_t cb);
 
+/**
+ * @brief Enregistre un callback appelé à chaque tick MIDI (24 PPQN).
+ *
+ * Sert à vider l’ordonnanceur d’événements du séquenceur entre deux steps
+ * (micro-timing, offsets, p-locks anticipés). Appelé avant le callback de step
+ * lorsque le tick coïncide avec un step.
+ * @param cb Pointeur vers la fonction callback (peut être NULL pour désinscrire).
+ */
+void clock_manager_register_tick_callback(clock_tick_cb_t cb);
+
+/**
+ * @brief Enregistre un callback de service appelé entre les ticks.
+ * Sert à libérer les événements de l’ordonnanceur à leur échéance exacte
+ * (micro-timing, offsets de latence par sortie) plutôt qu’au tick suivant.
+ * Appelé depuis le thread `clock_seq`, à l’échéance rendue par l’appel
+ * précédent, dans les deux modes d’horloge. Les callbacks de tick, de step,
+ * de transport et de service ne se chevauchent jamais (verrou commun).
+ * @param cb Pointeur vers la fonction callback (peut être NULL pour désinscrire).
+ */
+void clock_manager_register_service_callback(clock_service_cb_t cb);
+
+/**
+ * @brief Enregistre un callback appelé sur Start/Continue/Stop reçus en mode esclave.
+ * @param cb Pointeur vers la fonction callback (peut être NULL pour désinscrire).
+ */
+void clock_manager_register_transport_callback(clock_transport_cb_t cb);
+
+/**
+ * @brief Point d’entrée des messages temps réel MIDI reçus (F8/FA/FB/FC).
+ *
+ * Ignoré si la source active n’est pas `CLOCK_SRC_MIDI`. Les F8 alimentent la
+ * PLL de `clock_slave` (tempo, `tick_st`, `step_st` lissés) et, transport en
+ * marche, font avancer les ticks/steps comme l’horloge interne.
+ * @param status Octet de statut temps réel.
+ * @param ts Horodatage µs de réception (au plus près de l’octet reçu) ; la PLL
+ *           le reçoit converti en `systime_t`.
+ * @note À appeler depuis le thread de réception MIDI (pas en ISR).
+ */
+void clock_manager_on_midi_realtime(uint8_t status, hr_time_t ts);
+
+/**
+ * @brief Song Position Pointer reçu (0xF2), en doubles-croches depuis le début.
+ *
+ * Pris en compte transport à l’arrêt : le prochain Continue reprend à ce step.
+ */
+void clock_manager_on_song_position(uint16_t position);
+
 /** @} */ // end of group clock
 
 #ifdef __cplusplus
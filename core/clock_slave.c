@@ -0,0 +1,218 @@
+/**
+ * @file clock_slave.c
+ * @brief PLL numérique de suivi d’horloge MIDI externe (24 PPQN).
+ *
+ * La phase est tenue en `systime_t` + fraction Q16 et la période en Q16,
+ * ce qui conserve la précision sub-tick malgré la base de temps à 10 kHz.
+ * Les différences d’horodatage passent par un cast signé pour rester
+ * correctes au rebouclage de `systime_t`.
+ *
+ * @ingroup clock
+ */
+
+#include "clock_slave.h"
+
+#include <string.h>
+
+/* ======================================================================
+ *                              CONSTANTES
+ * ====================================================================== */
+
+#define CLOCK_SLAVE_Q16_ONE   (1UL << 16)
+
+/** Période d’un tick au tempo maximal (Q16). */
+#define CLOCK_SLAVE_PERIOD_MIN_Q16 \
+    ((uint32_t)(((uint64_t)CLOCK_SLAVE_ST_HZ * 60U * CLOCK_SLAVE_Q16_ONE) / (24U * CLOCK_SLAVE_BPM_MAX)))
+/** Période d’un tick au tempo minimal (Q16). */
+#define CLOCK_SLAVE_PERIOD_MAX_Q16 \
+    ((uint32_t)(((uint64_t)CLOCK_SLAVE_ST_HZ * 60U * CLOCK_SLAVE_Q16_ONE) / (24U * CLOCK_SLAVE_BPM_MIN)))
+
+_Static_assert(((uint64_t)CLOCK_SLAVE_ST_HZ * 60U * CLOCK_SLAVE_Q16_ONE) / (24U * CLOCK_SLAVE_BPM_MIN) <= UINT32_MAX,
+               "clock_slave: période Q16 hors uint32 au tempo minimal");
+
+/* ======================================================================
+ *                              ÉTAT GLOBAL
+ * ====================================================================== */
+
+clock_slave_stats_t clock_slave_stats = {0};
+
+static uint8_t   s_seen        = 0U;   /**< 0 : aucun F8, 1 : un horodatage, 2 : PLL active */
+static systime_t s_last_raw    = 0U;   /**< Dernier horodatage reçu */
+static systime_t s_phase       = 0U;   /**< Tick estimé (partie entière) */
+static uint32_t  s_phase_frac  = 0U;   /**< Tick estimé (fraction Q16) */
+static uint32_t  s_period_q16  = 0U;   /**< Période filtrée (Q16), 0 = inconnue */
+static uint32_t  s_lock_q16    = 0U;   /**< Période au moment du verrouillage */
+static uint16_t  s_good_run    = 0U;   /**< Ticks consécutifs sous le seuil */
+static bool      s_locked      = false;
+
+/* ======================================================================
+ *                              FONCTIONS INTERNES
+ * ====================================================================== */
+
+static int32_t time_diff(systime_t a, systime_t b) {
+    return (int32_t)(uint32_t)(a - b);
+}
+
+static uint32_t q16_round(uint64_t v_q16) {
+    return (uint32_t)((v_q16 + (CLOCK_SLAVE_Q16_ONE / 2U)) >> 16);
+}
+
+static uint32_t abs_i64_to_u32(int64_t v) {
+    const uint64_t a = (v < 0) ? (uint64_t)(-v) : (uint64_t)v;
+    return (a > UINT32_MAX) ? UINT32_MAX : (uint32_t)a;
+}
+
+static bool period_in_range(uint64_t period_q16) {
+    return (period_q16 >= CLOCK_SLAVE_PERIOD_MIN_Q16) && (period_q16 <= CLOCK_SLAVE_PERIOD_MAX_Q16);
+}
+
+static void restart_acquisition(systime_t t) {
+    s_seen       = 1U;
+    s_phase      = t;
+    s_phase_frac = 0U;
+    s_good_run   = 0U;
+    s_locked     = false;
+}
+
+static void update_lock(uint32_t abs_err_q16) {
+    const uint32_t lock_err = s_period_q16 / CLOCK_SLAVE_LOCK_ERR_DIV;
+
+    if (s_locked) {
+        if (abs_err_q16 > (s_period_q16 / 2U)) {
+            // Saut de phase d’une demi-période : on repasse en acquisition (gains larges).
+            s_locked   = false;
+            s_good_run = 0U;
+        }
+        return;
+    }
+
+    if (abs_err_q16 <= lock_err) {
+        if (++s_good_run >= CLOCK_SLAVE_LOCK_TICKS) {
+            s_locked   = true;
+            s_lock_q16 = s_period_q16;
+            clock_slave_stats.locks++;
+        }
+    } else {
+        s_good_run = 0U;
+    }
+}
+
+/* ======================================================================
+ *                              API PUBLIQUE
+ * ====================================================================== */
+
+void clock_slave_reset(void) {
+    s_seen       = 0U;
+    s_last_raw   = 0U;
+    s_phase      = 0U;
+    s_phase_frac = 0U;
+    s_period_q16 = 0U;
+    s_lock_q16   = 0U;
+    s_good_run   = 0U;
+    s_locked     = false;
+    memset((void *)&clock_slave_stats, 0, sizeof(clock_slave_stats));
+}
+
+bool clock_slave_on_tick(systime_t t) {
+    clock_slave_stats.ticks++;
+
+    if (s_seen == 0U) {
+        s_last_raw = t;
+        restart_acquisition(t);
+        return false;
+    }
+
+    const int32_t interval = time_diff(t, s_last_raw);
+    s_last_raw = t;
+    const uint64_t interval_q16 = (interval > 0) ? ((uint64_t)interval << 16) : 0U;
+
+    if (s_seen == 1U) {
+        if (!period_in_range(interval_q16)) {
+            clock_slave_stats.rejected++;
+            restart_acquisition(t);
+            return s_period_q16 != 0U;
+        }
+        // Première période mesurée : amorce de la PLL.
+        s_period_q16 = (uint32_t)interval_q16;
+        s_phase      = t;
+        s_phase_frac = 0U;
+        s_seen       = 2U;
+        return true;
+    }
+
+    if (interval_q16 > ((uint64_t)s_period_q16 * CLOCK_SLAVE_DROPOUT_TICKS)) {
+        // Maître muet (stop sans FC, câble débranché) : la période est gardée,
+        // la phase est réacquise au prochain intervalle.
+        clock_slave_stats.dropouts++;
+        restart_acquisition(t);
+        return true;
+    }
+
+    // Gigue brute : intervalle mesuré vs période filtrée.
+    const uint32_t jitter = q16_round(abs_i64_to_u32((int64_t)interval_q16 - (int64_t)s_period_q16));
+    clock_slave_stats.jitter_last = jitter;
+    clock_slave_stats.jitter_sum += jitter;
+    if (jitter > clock_slave_stats.jitter_max) {
+        clock_slave_stats.jitter_max = jitter;
+    }
+
+    // Erreur de phase vs tick prédit (phase + période), en Q16 relatif à s_phase.
+    const int64_t predicted = (int64_t)s_phase_frac + (int64_t)s_period_q16;
+    const int64_t measured  = (int64_t)time_diff(t, s_phase) * (int64_t)CLOCK_SLAVE_Q16_ONE;
+    const int64_t err       = measured - predicted;
+
+    const uint32_t alpha_div = 1UL << (s_locked ? CLOCK_SLAVE_ALPHA_SHIFT : CLOCK_SLAVE_ACQ_ALPHA_SHIFT);
+    const uint32_t beta_div  = 1UL << (s_locked ? CLOCK_SLAVE_BETA_SHIFT : CLOCK_SLAVE_ACQ_BETA_SHIFT);
+
+    int64_t phase_rel = predicted + (err / (int64_t)alpha_div);
+    if (phase_rel < 0) {
+        phase_rel = 0;
+    }
+    s_phase      = (systime_t)(s_phase + (systime_t)((uint64_t)phase_rel >> 16));
+    s_phase_frac = (uint32_t)((uint64_t)phase_rel & (CLOCK_SLAVE_Q16_ONE - 1U));
+
+    int64_t period = (int64_t)s_period_q16 + (err / (int64_t)beta_div);
+    if (period < (int64_t)CLOCK_SLAVE_PERIOD_MIN_Q16) {
+        period = (int64_t)CLOCK_SLAVE_PERIOD_MIN_Q16;
+    } else if (period > (int64_t)CLOCK_SLAVE_PERIOD_MAX_Q16) {
+        period = (int64_t)CLOCK_SLAVE_PERIOD_MAX_Q16;
+    }
+    s_period_q16 = (uint32_t)period;
+
+    const uint32_t abs_err = abs_i64_to_u32(err);
+    update_lock(abs_err);
+
+    if (s_locked) {
+        const uint32_t phase_err = q16_round(abs_err);
+        if (phase_err > clock_slave_stats.phase_err_max) {
+            clock_slave_stats.phase_err_max = phase_err;
+        }
+        clock_slave_stats.drift_ppm =
+            (int32_t)((((int64_t)s_period_q16 - (int64_t)s_lock_q16) * 1000000) / (int64_t)s_lock_q16);
+    }
+
+    return true;
+}
+
+bool clock_slave_is_locked(void) { return s_locked; }
+
+bool clock_slave_has_period(void) { return s_period_q16 != 0U; }
+
+float clock_slave_get_bpm(void) {
+    if (s_period_q16 == 0U) {
+        return 0.0f;
+    }
+    const float tick_st = (float)s_period_q16 / (float)CLOCK_SLAVE_Q16_ONE;
+    return (60.0f * (float)CLOCK_SLAVE_ST_HZ) / (24.0f * tick_st);
+}
+
+bool clock_slave_get_periods(systime_t *tick_st, systime_t *step_st) {
+    if (s_period_q16 == 0U) {
+        return false;
+    }
+    if (tick_st) *tick_st = (systime_t)q16_round(s_period_q16);
+    if (step_st) *step_st = (systime_t)q16_round((uint64_t)s_period_q16 * 6U);
+    return true;
+}
+
+uint32_t clock_slave_get_period_q16(void) { return s_period_q16; }
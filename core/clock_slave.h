@@ -0,0 +1,151 @@
+/**
+ * @file clock_slave.h
+ * @brief Suivi d’une horloge MIDI externe (F8) par boucle à verrouillage de phase.
+ *
+ * Les F8 reçus d’un maître (DAW, autre Brick) arrivent avec la gigue du
+ * transport (USB par trames de 1 ms, UART, ordonnancement). Ce module
+ * estime la période d’un tick 24 PPQN par un filtre alpha-bêta du second
+ * ordre (PLL numérique) :
+ * - erreur de phase = horodatage reçu − tick prédit ;
+ * - phase corrigée de `err / 2^CLOCK_SLAVE_ALPHA_SHIFT` ;
+ * - période corrigée de `err / 2^CLOCK_SLAVE_BETA_SHIFT`.
+ *
+ * Gains larges pendant l’acquisition, puis gains fins une fois verrouillé.
+ * Un trou supérieur à `CLOCK_SLAVE_DROPOUT_TICKS` périodes relance
+ * l’acquisition. Le module est purement calculatoire (aucun appel RTOS) :
+ * `clock_manager` lui transmet les F8 horodatés.
+ *
+ * @ingroup clock
+ */
+
+#ifndef CLOCK_SLAVE_H
+#define CLOCK_SLAVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ch.h"    // systime_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup clock
+ *  @{
+ */
+
+/* ======================================================================
+ *                              CONFIGURATION
+ * ====================================================================== */
+
+/** Fréquence de la base de temps `systime_t` (Hz). */
+#ifndef CLOCK_SLAVE_ST_HZ
+#if defined(CH_CFG_ST_FREQUENCY)
+#define CLOCK_SLAVE_ST_HZ CH_CFG_ST_FREQUENCY
+#else
+#define CLOCK_SLAVE_ST_HZ 10000U
+#endif
+#endif
+
+/** Gain de phase pendant l’acquisition (1/2). */
+#ifndef CLOCK_SLAVE_ACQ_ALPHA_SHIFT
+#define CLOCK_SLAVE_ACQ_ALPHA_SHIFT 1U
+#endif
+/** Gain de période pendant l’acquisition (1/8). */
+#ifndef CLOCK_SLAVE_ACQ_BETA_SHIFT
+#define CLOCK_SLAVE_ACQ_BETA_SHIFT 3U
+#endif
+/** Gain de phase une fois verrouillé (1/8). */
+#ifndef CLOCK_SLAVE_ALPHA_SHIFT
+#define CLOCK_SLAVE_ALPHA_SHIFT 3U
+#endif
+/** Gain de période une fois verrouillé (1/128, quasi amorti critique). */
+#ifndef CLOCK_SLAVE_BETA_SHIFT
+#define CLOCK_SLAVE_BETA_SHIFT 7U
+#endif
+/** Ticks consécutifs sous le seuil d’erreur pour déclarer le verrouillage (1 noire). */
+#ifndef CLOCK_SLAVE_LOCK_TICKS
+#define CLOCK_SLAVE_LOCK_TICKS 24U
+#endif
+/** Seuil d’erreur de phase de verrouillage, en 1/8 de période. */
+#ifndef CLOCK_SLAVE_LOCK_ERR_DIV
+#define CLOCK_SLAVE_LOCK_ERR_DIV 8U
+#endif
+/** Intervalle (en périodes) au-delà duquel le maître est considéré perdu. */
+#ifndef CLOCK_SLAVE_DROPOUT_TICKS
+#define CLOCK_SLAVE_DROPOUT_TICKS 4U
+#endif
+/** Plage de tempo acceptée (BPM). */
+#ifndef CLOCK_SLAVE_BPM_MIN
+#define CLOCK_SLAVE_BPM_MIN 20U
+#endif
+#ifndef CLOCK_SLAVE_BPM_MAX
+#define CLOCK_SLAVE_BPM_MAX 300U
+#endif
+
+/* ======================================================================
+ *                               TYPES
+ * ====================================================================== */
+
+/**
+ * @brief Statistiques de suivi (diagnostic, même esprit que `midi_tx_stats`).
+ *
+ * Unités `systime_t` sauf mention contraire.
+ * - gigue : écart entre l’intervalle brut de deux F8 et la période filtrée ;
+ * - erreur de phase : écart entre un F8 reçu et le tick prédit par la PLL ;
+ * - dérive : variation de la période filtrée depuis le dernier verrouillage.
+ */
+typedef struct {
+    volatile uint32_t ticks;          /**< F8 traités. */
+    volatile uint32_t locks;          /**< Verrouillages acquis. */
+    volatile uint32_t dropouts;       /**< Pertes du maître (trou > `CLOCK_SLAVE_DROPOUT_TICKS`). */
+    volatile uint32_t rejected;       /**< Intervalles hors plage de tempo ignorés. */
+    volatile uint32_t jitter_last;    /**< Gigue du dernier intervalle. */
+    volatile uint32_t jitter_max;     /**< Gigue maximale. */
+    volatile uint32_t jitter_sum;     /**< Somme des gigues (moyenne = sum / ticks). */
+    volatile uint32_t phase_err_max;  /**< |erreur de phase| maximale une fois verrouillé. */
+    volatile int32_t  drift_ppm;      /**< Dérive de période depuis le verrouillage (ppm). */
+} clock_slave_stats_t;
+
+/** @brief Statistiques globales du suivi d’horloge externe. */
+extern clock_slave_stats_t clock_slave_stats;
+
+/* ======================================================================
+ *                               API
+ * ====================================================================== */
+
+/** Oublie la phase et la période (nouvelle acquisition) et remet les stats à zéro. */
+void clock_slave_reset(void);
+
+/**
+ * @brief Intègre un F8 reçu.
+ * @param t Horodatage de réception.
+ * @return true si une période est disponible (au moins deux F8 cohérents).
+ */
+bool clock_slave_on_tick(systime_t t);
+
+/** Indique si la PLL est verrouillée sur le maître. */
+bool clock_slave_is_locked(void);
+
+/** Indique si une période valide est disponible. */
+bool clock_slave_has_period(void);
+
+/** Tempo estimé (BPM), 0 si aucune période n’est disponible. */
+float clock_slave_get_bpm(void);
+
+/**
+ * @brief Durées filtrées d’un tick (24 PPQN) et d’un step (6 ticks).
+ * @return false si aucune période n’est disponible (sorties inchangées).
+ */
+bool clock_slave_get_periods(systime_t *tick_st, systime_t *step_st);
+
+/** Période filtrée en `systime_t` Q16 (diagnostic / tests). */
+uint32_t clock_slave_get_period_q16(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLOCK_SLAVE_H */
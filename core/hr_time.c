@@ -0,0 +1,93 @@
+/**
+ * @file hr_time.c
+ * @brief Base de temps µs tirée du compteur de cycles DWT (Cortex-M4).
+ *
+ * `DWT->CYCCNT` compte les cycles HCLK sur 32 bits et reboucle toutes les
+ * 2^32 / 180 MHz ≈ 23,8 s. Chaque lecture convertit les cycles écoulés depuis
+ * la précédente en µs (reste de cycles conservé, aucune dérive) et les ajoute
+ * au compteur 32 bits `s_now`. Un timer virtuel relit le compteur chaque
+ * seconde : aucun rebouclage de `CYCCNT` n’échappe à l’extension, même sans
+ * lecture applicative.
+ *
+ * @ingroup clock
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "hr_time.h"
+
+/** Cycles HCLK par microseconde. */
+#define HR_TIME_CYC_PER_US (STM32_HCLK / HR_TIME_HZ)
+
+/** Période du rafraîchissement (bien en deçà du rebouclage de `CYCCNT`). */
+#ifndef HR_TIME_REFRESH_MS
+#define HR_TIME_REFRESH_MS 1000U
+#endif
+
+_Static_assert((STM32_HCLK % HR_TIME_HZ) == 0U, "hr_time: HCLK doit être un multiple de 1 MHz");
+_Static_assert((HR_TIME_HZ % HR_TIME_ST_HZ) == 0U, "hr_time: systime_t doit diviser la base µs");
+
+/* ======================================================================
+ *                              ÉTAT GLOBAL
+ * ====================================================================== */
+
+static virtual_timer_t s_refresh_vt;
+static uint32_t        s_last_cyc = 0U;  /**< `CYCCNT` à la dernière lecture */
+static uint32_t        s_frac_cyc = 0U;  /**< Cycles pas encore convertis (< 1 µs) */
+static hr_time_t       s_now      = 0U;  /**< Instant étendu (µs) */
+
+/* ======================================================================
+ *                              FONCTIONS INTERNES
+ * ====================================================================== */
+
+/* Avance l’instant étendu jusqu’au cycle courant (sous verrou). */
+static hr_time_t advance(void) {
+    const uint32_t cyc = DWT->CYCCNT;
+    const uint32_t elapsed = (cyc - s_last_cyc) + s_frac_cyc;
+    const uint32_t us = elapsed / HR_TIME_CYC_PER_US;
+    s_last_cyc = cyc;
+    s_frac_cyc = elapsed - (us * HR_TIME_CYC_PER_US);
+    s_now += us;
+    return s_now;
+}
+
+static void refresh_cb(virtual_timer_t *vtp, void *p) {
+    (void)vtp;
+    (void)p;
+    chSysLockFromISR();
+    (void)advance();
+    chSysUnlockFromISR();
+}
+
+/* ======================================================================
+ *                              API PUBLIQUE
+ * ====================================================================== */
+
+void hr_time_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    chSysLock();
+    s_last_cyc = DWT->CYCCNT;
+    s_frac_cyc = 0U;
+    s_now = 0U;
+    chSysUnlock();
+
+    chVTObjectInit(&s_refresh_vt);
+    chVTSetContinuous(&s_refresh_vt, TIME_MS2I(HR_TIME_REFRESH_MS), refresh_cb, NULL);
+}
+
+hr_time_t hr_time_now(void) {
+    const syssts_t sts = chSysGetStatusAndLockX();
+    const hr_time_t now = advance();
+    chSysRestoreStatusX(sts);
+    return now;
+}
+
+hr_time_t hr_time_sample(systime_t *st) {
+    const syssts_t sts = chSysGetStatusAndLockX();
+    const hr_time_t now = advance();
+    *st = chVTGetSystemTimeX();
+    chSysRestoreStatusX(sts);
+    return now;
+}
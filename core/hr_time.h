@@ -0,0 +1,130 @@
+/**
+ * @file hr_time.h
+ * @brief Base de temps monotone haute résolution (µs) des chemins temps réel.
+ *
+ * `systime_t` avance à `CH_CFG_ST_FREQUENCY` (10 kHz) : 100 µs de grain, plus
+ * grossier que le micro-timing du modèle (1/12 de step, ≈ 10 ms à 120 BPM,
+ * mais des écarts de quelques centaines de µs s’entendent sur une capture ou
+ * un swing d’arpège). `hr_time_t` compte les microsecondes :
+ * - cible : compteur de cycles DWT (`CYCCNT`, HCLK) étendu en µs, lu en
+ *   quelques cycles depuis un thread ou une ISR (aucun timer matériel mobilisé :
+ *   TIM2/TIM5 32 bits sont pris par l’encodeur 4 et la base de temps ChibiOS) ;
+ * - hôte : `tests/stubs/hr_time_stub.c`, dérivé de l’horloge simulée.
+ *
+ * Les instants rebouclent toutes les 2^32 µs (≈ 71 min) : toute comparaison
+ * passe par `hr_time_diff()`. L’ordonnanceur et les attentes RTOS restent en
+ * `systime_t` ; les conversions d’instants prennent une paire (µs, systime)
+ * lue d’un bloc et sont exactes au tick système près.
+ *
+ * @ingroup clock
+ */
+
+#ifndef HR_TIME_H
+#define HR_TIME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ch.h"    // systime_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup clock
+ *  @{
+ */
+
+/* ======================================================================
+ *                              CONFIGURATION
+ * ====================================================================== */
+
+/** Fréquence de la base haute résolution (Hz). */
+#define HR_TIME_HZ 1000000U
+
+/** Fréquence de la base de temps `systime_t` (Hz). */
+#ifndef HR_TIME_ST_HZ
+#if defined(CH_CFG_ST_FREQUENCY)
+#define HR_TIME_ST_HZ CH_CFG_ST_FREQUENCY
+#else
+#define HR_TIME_ST_HZ 10000U
+#endif
+#endif
+
+/** Microsecondes par tick système. */
+#define HR_TIME_PER_ST (HR_TIME_HZ / HR_TIME_ST_HZ)
+
+/** Durée en millisecondes → `hr_time_t`. */
+#define HR_TIME_MS(ms) ((hr_time_t)((uint32_t)(ms) * 1000U))
+
+/* ======================================================================
+ *                               TYPES
+ * ====================================================================== */
+
+/** Instant ou durée en microsecondes (reboucle sur 32 bits). */
+typedef uint32_t hr_time_t;
+
+/* ======================================================================
+ *                               API
+ * ====================================================================== */
+
+/**
+ * @brief Démarre le compteur (cible : active le DWT et le rafraîchissement périodique).
+ * @note À appeler après `chSysInit()`, avant les modules horodatés.
+ */
+void hr_time_init(void);
+
+/** Instant courant (µs). Appelable en thread, en ISR et sous verrou. */
+hr_time_t hr_time_now(void);
+
+/**
+ * @brief Instant courant (µs) et `systime_t` correspondant, lus d’un bloc.
+ * @param st Reçoit la valeur de `chVTGetSystemTimeX()` au même instant.
+ */
+hr_time_t hr_time_sample(systime_t *st);
+
+/** Écart signé `to − from` (µs), correct au rebouclage (|écart| < 35 min). */
+static inline int32_t hr_time_diff(hr_time_t from, hr_time_t to) {
+    return (int32_t)(to - from);
+}
+
+/** Durée `systime_t` → µs (exacte). */
+static inline hr_time_t hr_time_span_from_st(systime_t st) {
+    return (hr_time_t)((uint32_t)st * HR_TIME_PER_ST);
+}
+
+/** Durée µs → `systime_t` (arrondie au tick le plus proche). */
+static inline systime_t hr_time_span_to_st(hr_time_t span) {
+    return (systime_t)((span + (HR_TIME_PER_ST / 2U)) / HR_TIME_PER_ST);
+}
+
+/**
+ * @brief Instant µs → `systime_t` (passé ou futur proche).
+ *
+ * Décalé depuis une paire lue au même instant : l’erreur ne dépasse pas un
+ * tick système, quel que soit l’âge de @p t.
+ */
+static inline systime_t hr_time_to_st(hr_time_t t) {
+    systime_t st;
+    const int32_t age = hr_time_diff(t, hr_time_sample(&st));
+    const int32_t half = (int32_t)(HR_TIME_PER_ST / 2U);
+    const int32_t ticks = (age >= 0) ? ((age + half) / (int32_t)HR_TIME_PER_ST)
+                                     : -((half - age) / (int32_t)HR_TIME_PER_ST);
+    return (systime_t)(st - (systime_t)ticks);
+}
+
+/** Instant `systime_t` → µs (à un tick système près). */
+static inline hr_time_t hr_time_from_st(systime_t t) {
+    systime_t st;
+    const hr_time_t now = hr_time_sample(&st);
+    const int32_t age = (int32_t)(uint32_t)(st - t);
+    return (hr_time_t)(now - (hr_time_t)(age * (int32_t)HR_TIME_PER_ST));
+}
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HR_TIME_H */
@@ -0,0 +1,87 @@
+/**
+ * @file latency_cal.c
+ * @brief Calibration de la latence d’une sortie par mesure d’aller-retour (µs).
+ *
+ * @ingroup clock
+ */
+
+#include "latency_cal.h"
+
+#include <string.h>
+
+/* ======================================================================
+ *                              API PUBLIQUE
+ * ====================================================================== */
+
+void latency_cal_start(latency_cal_t *c, uint8_t probes, uint32_t timeout_us) {
+    memset(c, 0, sizeof(*c));
+    c->probes = (probes != 0U) ? probes : 1U;
+    c->timeout_us = timeout_us;
+    c->rtt_min = UINT32_MAX;
+    c->state = LATENCY_CAL_RUNNING;
+}
+
+bool latency_cal_poll(latency_cal_t *c, hr_time_t now) {
+    if (c->state != LATENCY_CAL_RUNNING) {
+        return false;
+    }
+    if (c->pending) {
+        if (hr_time_diff(c->sent_at, now) < (int32_t)c->timeout_us) {
+            return false;
+        }
+        c->pending = false;
+        c->misses++;
+        if (c->misses >= LATENCY_CAL_MAX_MISSES) {
+            /* Des échos déjà reçus restent une mesure valable (liaison devenue muette). */
+            c->state = (c->samples != 0U) ? LATENCY_CAL_DONE : LATENCY_CAL_NO_LOOPBACK;
+            return false;
+        }
+    }
+    if (c->samples >= c->probes) {
+        c->state = LATENCY_CAL_DONE;
+        return false;
+    }
+    return true;
+}
+
+void latency_cal_sent(latency_cal_t *c, hr_time_t at) {
+    if (c->state != LATENCY_CAL_RUNNING) {
+        return;
+    }
+    c->sent_at = at;
+    c->pending = true;
+}
+
+void latency_cal_echo(latency_cal_t *c, hr_time_t at) {
+    if ((c->state != LATENCY_CAL_RUNNING) || !c->pending) {
+        return;
+    }
+    const int32_t rtt = hr_time_diff(c->sent_at, at);
+    if (rtt < 0) {
+        return;  /* écho antérieur à l’émission : octet d’une sonde précédente */
+    }
+    latency_cal_sample(c, (uint32_t)rtt);
+}
+
+void latency_cal_sample(latency_cal_t *c, uint32_t rtt_us) {
+    if ((c->state != LATENCY_CAL_RUNNING) || !c->pending) {
+        return;
+    }
+    c->pending = false;
+    c->misses = 0U;
+    c->samples++;
+    c->rtt_sum += rtt_us;
+    if (rtt_us < c->rtt_min) {
+        c->rtt_min = rtt_us;
+    }
+    if (rtt_us > c->rtt_max) {
+        c->rtt_max = rtt_us;
+    }
+}
+
+int32_t latency_cal_offset_us(const latency_cal_t *c) {
+    if ((c->state != LATENCY_CAL_DONE) || (c->samples == 0U)) {
+        return 0;
+    }
+    return -(int32_t)((c->rtt_min + 1U) / 2U);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file latency_cal.h
+ * @brief Calibration de la latence d’une sortie par mesure d’aller-retour (µs).
+ *
+ * Une sonde part sur la sortie, son écho revient par un bouclage (câble DIN
+ * OUT → IN, réponse à un GET de cartouche). Le module cadence les sondes
+ * (une seule en vol), rejette celles restées sans écho après `timeout_us` et
+ * garde l’aller-retour minimal : c’est le chemin le moins perturbé par les
+ * files, dont la moitié estime le retard aller de la sortie. Après
+ * @ref LATENCY_CAL_MAX_MISSES sondes consécutives sans écho, la sortie est
+ * déclarée sans bouclage.
+ *
+ * Module purement calculatoire : `ui/ui_output_latency` l’alimente (envoi depuis
+ * le thread UI, écho depuis le thread de lecture DIN sous verrou) ;
+ * `tests/latency_cal_tests.c` sur hôte.
+ *
+ * @ingroup clock
+ */
+
+#ifndef LATENCY_CAL_H
+#define LATENCY_CAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hr_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup clock
+ *  @{
+ */
+
+/** Sondes consécutives sans écho avant abandon. */
+#ifndef LATENCY_CAL_MAX_MISSES
+#define LATENCY_CAL_MAX_MISSES 3U
+#endif
+
+/** @brief État d’une calibration. */
+typedef enum {
+    LATENCY_CAL_IDLE = 0,     /**< Jamais lancée (ou annulée). */
+    LATENCY_CAL_RUNNING,      /**< Sondes en cours. */
+    LATENCY_CAL_DONE,         /**< Mesure disponible. */
+    LATENCY_CAL_NO_LOOPBACK   /**< Aucun écho : pas de bouclage sur cette sortie. */
+} latency_cal_state_t;
+
+/** @brief Calibration d’une sortie. */
+typedef struct {
+    latency_cal_state_t state;
+    uint8_t   probes;      /**< Échos visés. */
+    uint8_t   samples;     /**< Échos valides reçus. */
+    uint8_t   misses;      /**< Sondes consécutives sans écho. */
+    bool      pending;     /**< Une sonde est en vol. */
+    hr_time_t sent_at;     /**< Émission de la sonde en vol. */
+    uint32_t  timeout_us;  /**< Délai d’écho au-delà duquel la sonde est perdue. */
+    uint32_t  rtt_min;     /**< Aller-retour minimal (µs). */
+    uint32_t  rtt_max;     /**< Aller-retour maximal (µs). */
+    uint32_t  rtt_sum;     /**< Somme des allers-retours (moyenne = sum / samples). */
+} latency_cal_t;
+
+/** Lance une calibration de @p probes échos (statistiques remises à zéro). */
+void latency_cal_start(latency_cal_t *c, uint8_t probes, uint32_t timeout_us);
+
+/**
+ * @brief Fait avancer la calibration.
+ *
+ * Expire la sonde en vol au-delà du délai et termine la mesure une fois les
+ * échos obtenus (ou le bouclage absent).
+ * @return true s’il faut émettre une sonde maintenant, puis appeler
+ *         `latency_cal_sent()`.
+ */
+bool latency_cal_poll(latency_cal_t *c, hr_time_t now);
+
+/** Note l’émission de la sonde demandée par `latency_cal_poll()`. */
+void latency_cal_sent(latency_cal_t *c, hr_time_t at);
+
+/** Écho de la sonde en vol reçu à l’instant @p at (ignoré sans sonde en vol). */
+void latency_cal_echo(latency_cal_t *c, hr_time_t at);
+
+/**
+ * @brief Écho dont l’aller-retour a été mesuré ailleurs (compteur du lien).
+ *
+ * Même effet que `latency_cal_echo()` avec `at = sent_at + rtt_us`.
+ */
+void latency_cal_sample(latency_cal_t *c, uint32_t rtt_us);
+
+/**
+ * @brief Décalage de sortie déduit de la mesure (µs).
+ *
+ * `−rtt_min / 2` (arrondi au µs) : la sortie est servie en avance de son
+ * retard aller. 0 tant que la calibration n’est pas `LATENCY_CAL_DONE`.
+ */
+int32_t latency_cal_offset_us(const latency_cal_t *c);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATENCY_CAL_H */
@@ -6,17 +6,39 @@
  * - Utilise le timer matériel **TIM3** (via GPTD3) à 1 MHz.
  * - Envoie les messages `0xF8` à intervalles réguliers selon le BPM courant.
  * - Fournit un **callback applicatif** à chaque tick (pour séquenceur, clock_manager, etc.).
- * - Supporte start/stop dynamique et recalcul automatique à changement de tempo.
+ * - Supporte start/stop dynamique, changement de tempo et rampes sans redémarrer le timer.
  *
- * @note Résolution : 1 µs (bpm min ≈ 38.2 à 24 PPQN).
+ * Chaque interruption reprogramme la période qui commence (`gptChangeIntervalI`)
+ * avec l’intervalle suivant de l’accumulateur de phase (`clock_dda.h`) : les
+ * intervalles sont entiers mais leur somme suit le temps exact à 1 µs près,
+ * sans dérive. Le GPT compte à la fréquence de `hr_time_t` : l’instant µs du
+ * tick est l’origine µs plus le temps du générateur, exact.
+ *
+ * Le F8 part de l’ISR elle-même (`midi_clock_i()`, DIN + USB) : il n’hérite ni
+ * de la latence d’ordonnancement ni du coût du step précédent. L’ISR dépose
+ * ensuite l’horodatage du tick dans une petite file et réveille le thread
+ * séquenceur (`clock_seq`), qui vide la file et appelle le callback pour chaque
+ * tick, dans l’ordre : un step long retarde les steps suivants, jamais l’horloge
+ * émise. Entre deux ticks, le thread se réveille aussi à l’échéance que lui
+ * rend le callback de service (`midi_clock_register_service_callback()`) :
+ * l’ordonnanceur d’événements libère ainsi micro-timing et offsets de latence
+ * au tick système près, sans attendre le F8 suivant. Deux sondes (`midi_clock_stats`) mesurent le retard et la gigue du F8
+ * émis et du callback séquenceur ; `MIDI_CLOCK_PROBE_LINE` expose en plus
+ * l’émission du F8 sur une broche, pour l’oscilloscope.
+ *
+ * @note Résolution : 1 µs par intervalle, 0,001 BPM en moyenne (bpm min ≈ 38.2 à 24 PPQN).
  * @ingroup midi
  */
 
 #include "ch.h"
 #include "hal.h"
 #include "brick_config.h"
+#include "clock_dda.h"
+#include "clock_jitter.h"
+#include "hr_time.h"
 #include "midi_clock.h"
-#include "midi.h"   /* pour midi_clock(MIDI_DEST_BOTH) */
+#include "midi.h"   /* pour midi_clock_i() */
+#include "stack_watch.h"
 
 /* ===== Sélection du timer =====
  * On utilise TIM3 (APB1, 16 bits) via GPTD3.
@@ -26,21 +48,53 @@
 /* Base du timer après préscaler (Hz) :
  * 1 MHz → résolution 1 µs (bpm min ≈ 38.2 à 24 PPQN)
  */
-#define MIDI_GPT_BASE_HZ      1000000U
+#define MIDI_GPT_BASE_HZ      CLOCK_DDA_TIMER_HZ
+
+_Static_assert(CLOCK_DDA_TIMER_HZ == HR_TIME_HZ, "midi_clock: le GPT doit compter en µs (hr_time_t)");
+
+/* Ticks en attente du thread séquenceur (puissance de 2). 8 ticks ≈ 80 ms à
+ * 250 BPM : au-delà, le séquenceur a décroché et le tick est compté perdu. */
+/* Pile du thread séquenceur : il exécute tout le runner (plan, p-locks cart,
+ * envoi MIDI). Chaîne la plus profonde mesurée à l’hôte (-fcallgraph-info=su,
+ * -O2) : 768 o du step runner à la résolution des p-locks, hors envoi MIDI et
+ * lien cart ; le double couvre ces appels. À confirmer sur cible avec
+ * `midi_clock_stack_unused()`. */
+#ifndef MIDI_CLOCK_SEQ_STACK_SIZE
+#define MIDI_CLOCK_SEQ_STACK_SIZE 1536U
+#endif
+
+#ifndef MIDI_CLOCK_TICK_QUEUE
+#define MIDI_CLOCK_TICK_QUEUE 8U
+#endif
+_Static_assert((MIDI_CLOCK_TICK_QUEUE & (MIDI_CLOCK_TICK_QUEUE - 1U)) == 0U,
+               "midi_clock: MIDI_CLOCK_TICK_QUEUE doit être une puissance de 2");
 
-/* === Callback tick (24 PPQN) === */
-static midi_tick_cb_t s_tick_cb = NULL;
+/* === Callback tick (24 PPQN) et service entre les ticks === */
+static midi_tick_cb_t    s_tick_cb    = NULL;
+static midi_service_cb_t s_service_cb = NULL;
+
+/* === Statistiques === */
+midi_clock_stats_t midi_clock_stats;
 
 /* === Variables internes === */
-static CCM_DATA THD_WORKING_AREA(waMidiClk, 256);
-static THD_FUNCTION(thMidiClk, arg);
+typedef struct {
+  systime_t st;
+  hr_time_t hr;
+} tick_stamp_t;
+
+static CCM_DATA THD_WORKING_AREA(waClockSeq, MIDI_CLOCK_SEQ_STACK_SIZE);
+static THD_FUNCTION(thClockSeq, arg);
 static void gpt3_cb(GPTDriver *gptp);
 
 static binary_semaphore_t clk_sem;
-static float     s_bpm            = 120.0f;
-static uint32_t  s_interval_ticks = 0;
-static bool      s_running        = false;
-static bool      s_initialized    = false;
+static clock_dda_t        s_dda;                /* période et phase (sous verrou) */
+static systime_t          s_origin         = 0; /* systime au départ du générateur */
+static hr_time_t          s_origin_hr      = 0; /* instant µs au départ du générateur */
+static tick_stamp_t       s_ticks[MIDI_CLOCK_TICK_QUEUE]; /* ticks échus, non traités */
+static uint32_t           s_tick_head      = 0; /* prochain tick à traiter */
+static uint32_t           s_tick_count     = 0; /* ticks en attente */
+static bool               s_running        = false;
+static bool               s_initialized    = false;
 
 /* === Configuration du GPT === */
 static const GPTConfig gpt3cfg = {
@@ -50,43 +104,83 @@ static const GPTConfig gpt3cfg = {
   .dier      = 0U,
 };
 
-/**
- * @brief Calcule le nombre de ticks timer pour un BPM donné.
- */
-static uint32_t compute_interval_ticks(float bpm) {
-  if (bpm < 1.0f) bpm = 1.0f;
-  float ticks_f = (60.0f * (float)MIDI_GPT_BASE_HZ) / (bpm * 24.0f);
-  if (ticks_f < 1.0f)    ticks_f = 1.0f;
-  if (ticks_f > 65535.f) ticks_f = 65535.f; /* TIM3 = 16 bits */
-  return (uint32_t)(ticks_f + 0.5f);
-}
-
 /**
  * @brief Callback IRQ du timer GPT3 (tick MIDI 24 PPQN).
  */
 static void gpt3_cb(GPTDriver *gptp) {
-  (void)gptp;
   chSysLockFromISR();
-  chBSemSignalI(&clk_sem);
+#if defined(MIDI_CLOCK_PROBE_LINE)
+  palSetLine(MIDI_CLOCK_PROBE_LINE);
+#endif
+  /* F8 d’abord : la seule latence est celle de l’entrée en interruption. */
+  midi_clock_i();
+  const uint64_t at = clock_dda_time(&s_dda);
+  const hr_time_t tick_hr = (hr_time_t)(s_origin_hr + (hr_time_t)at);
+  clock_jitter_add(&midi_clock_stats.f8, tick_hr, hr_time_now());
+#if defined(MIDI_CLOCK_PROBE_LINE)
+  palClearLine(MIDI_CLOCK_PROBE_LINE);
+#endif
+
+  /* Sans préchargement d’ARR : la nouvelle valeur vaut pour la période qui
+     vient de commencer (le compteur est encore loin de l’intervalle minimal). */
+  gptChangeIntervalI(gptp, clock_dda_next(&s_dda));
+
+  if (s_tick_count < MIDI_CLOCK_TICK_QUEUE) {
+    tick_stamp_t *t = &s_ticks[(s_tick_head + s_tick_count) & (MIDI_CLOCK_TICK_QUEUE - 1U)];
+    t->st = clock_dda_to_st(s_origin, at);
+    t->hr = tick_hr;
+    s_tick_count++;
+    if (s_tick_count > midi_clock_stats.queue_high_water) {
+      midi_clock_stats.queue_high_water = s_tick_count;
+    }
+    chBSemSignalI(&clk_sem);
+  } else {
+    midi_clock_stats.seq_overruns++;
+  }
   chSysUnlockFromISR();
 }
 
+/* Attente jusqu’à l’échéance de service (TIME_IMMEDIATE si déjà passée). */
+static sysinterval_t service_wait(bool armed, systime_t due) {
+  if (!armed) {
+    return TIME_INFINITE;
+  }
+  const int32_t left = (int32_t)(uint32_t)(due - chVTGetSystemTimeX());
+  return (left > 0) ? (sysinterval_t)left : TIME_IMMEDIATE;
+}
+
 /**
- * @brief Thread d’envoi des horloges MIDI (`0xF8`) et notification du callback.
+ * @brief Thread séquenceur : notifie le callback pour chaque tick échu, dans l’ordre.
+ *
+ * Réveillé par l’ISR, par `midi_clock_kick()` ou à l’échéance rendue par le
+ * callback de service ; un réveil peut couvrir plusieurs ticks si le step
+ * précédent a duré plus d’une période. Le service passe après les ticks.
  */
-static THD_FUNCTION(thMidiClk, arg) {
+static THD_FUNCTION(thClockSeq, arg) {
   (void)arg;
 #if CH_CFG_USE_REGISTRY
-  chRegSetThreadName("midi_clk");
+  chRegSetThreadName("clock_seq");
 #endif
+  bool      armed = false;
+  systime_t due   = 0;
   while (true) {
-    chBSemWait(&clk_sem);
-
-    /* Envoi d’un message Clock MIDI (F8) vers USB + DIN */
-    midi_clock(MIDI_DEST_BOTH);
+    (void)chBSemWaitTimeout(&clk_sem, service_wait(armed, due));
+    while (true) {
+      chSysLock();
+      if (s_tick_count == 0U) {
+        chSysUnlock();
+        break;
+      }
+      const tick_stamp_t t = s_ticks[s_tick_head];
+      s_tick_head = (s_tick_head + 1U) & (MIDI_CLOCK_TICK_QUEUE - 1U);
+      s_tick_count--;
+      clock_jitter_add(&midi_clock_stats.seq, t.hr, hr_time_now());
+      chSysUnlock();
 
-    /* Notifie l’application (séquenceur, etc.) */
-    if (s_tick_cb) s_tick_cb();
+      /* Notifie l’application (séquenceur, etc.) */
+      if (s_tick_cb) s_tick_cb(t.st, t.hr);
+    }
+    armed = (s_service_cb != NULL) && s_service_cb(chVTGetSystemTimeX(), &due);
   }
 }
 
@@ -100,7 +194,21 @@ static THD_FUNCTION(thMidiClk, arg) {
 void midi_clock_register_tick_callback(midi_tick_cb_t cb) { s_tick_cb = cb; }
 
 /**
- * @brief Initialise le générateur MIDI Clock (thread + GPT3).
+ * @brief Enregistre le callback de service appelé par le thread séquenceur entre les ticks.
+ */
+void midi_clock_register_service_callback(midi_service_cb_t cb) { s_service_cb = cb; }
+
+/**
+ * @brief Réveille le thread séquenceur pour qu’il recalcule son échéance de service.
+ */
+void midi_clock_kick(void) {
+  if (s_initialized) {
+    chBSemSignal(&clk_sem);
+  }
+}
+
+/**
+ * @brief Initialise le générateur MIDI Clock (thread séquenceur + GPT3).
  */
 void midi_clock_init(void) {
   if (s_initialized) {
@@ -109,8 +217,13 @@ void midi_clock_init(void) {
   s_initialized = true;
   chBSemObjectInit(&clk_sem, true);
   (void)chBSemWaitTimeout(&clk_sem, TIME_IMMEDIATE); /* consomme le token initial */
-  chThdCreateStatic(waMidiClk, sizeof(waMidiClk), NORMALPRIO + 3, thMidiClk, NULL);
-  s_interval_ticks = compute_interval_ticks(s_bpm);
+  midi_clock_stats_reset();
+#if defined(MIDI_CLOCK_PROBE_LINE)
+  palSetLineMode(MIDI_CLOCK_PROBE_LINE, PAL_MODE_OUTPUT_PUSHPULL);
+  palClearLine(MIDI_CLOCK_PROBE_LINE);
+#endif
+  chThdCreateStatic(waClockSeq, sizeof(waClockSeq), NORMALPRIO + 3, thClockSeq, NULL);
+  clock_dda_init(&s_dda, 120000U);
   gptStart(&MIDI_GPT_DRIVER, &gpt3cfg);
 }
 
@@ -119,7 +232,14 @@ void midi_clock_init(void) {
  */
 void midi_clock_start(void) {
   if (s_running) return;
-  gptStartContinuous(&MIDI_GPT_DRIVER, s_interval_ticks);
+  chSysLock();
+  const uint32_t first = clock_dda_start(&s_dda);
+  s_origin_hr = hr_time_sample(&s_origin);
+  /* Nouvelle origine : l’intervalle à travers l’arrêt n’est pas une gigue. */
+  clock_jitter_rebase(&midi_clock_stats.f8);
+  clock_jitter_rebase(&midi_clock_stats.seq);
+  chSysUnlock();
+  gptStartContinuous(&MIDI_GPT_DRIVER, first);
   s_running = true;
 }
 
@@ -133,24 +253,73 @@ void midi_clock_stop(void) {
 }
 
 /**
- * @brief Modifie le tempo du générateur.
+ * @brief Modifie le tempo du générateur (dès le prochain intervalle).
  * @param bpm Nouveau tempo en BPM.
  */
 void midi_clock_set_bpm(float bpm) {
-  s_bpm = bpm;
-  s_interval_ticks = compute_interval_ticks(s_bpm);
-  if (s_running) {
-    gptStopTimer(&MIDI_GPT_DRIVER);
-    gptStartContinuous(&MIDI_GPT_DRIVER, s_interval_ticks);
-  }
+  const uint32_t mbpm = clock_dda_mbpm_from_bpm(bpm);
+  chSysLock();
+  clock_dda_set_tempo(&s_dda, mbpm);
+  chSysUnlock();
+}
+
+/**
+ * @brief Rampe de tempo sur @p ticks ticks.
+ */
+void midi_clock_ramp_bpm(float bpm, uint32_t ticks) {
+  const uint32_t mbpm = clock_dda_mbpm_from_bpm(bpm);
+  chSysLock();
+  clock_dda_ramp(&s_dda, mbpm, ticks);
+  chSysUnlock();
 }
 
 /**
  * @brief Retourne le tempo actuel (BPM).
  */
-float midi_clock_get_bpm(void) { return s_bpm; }
+float midi_clock_get_bpm(void) {
+  chSysLock();
+  const uint32_t mbpm = clock_dda_tempo(&s_dda);
+  chSysUnlock();
+  return (float)mbpm / 1000.0f;
+}
+
+/**
+ * @brief Durée de @p ticks ticks au tempo courant.
+ */
+systime_t midi_clock_span_st(uint32_t ticks) {
+  chSysLock();
+  const systime_t span = clock_dda_span_st(&s_dda, ticks);
+  chSysUnlock();
+  return span;
+}
+
+/**
+ * @brief Durée de @p ticks ticks au tempo courant, en µs.
+ */
+hr_time_t midi_clock_span_hr(uint32_t ticks) {
+  chSysLock();
+  const hr_time_t span = (hr_time_t)clock_dda_span(&s_dda, ticks);
+  chSysUnlock();
+  return span;
+}
 
 /**
  * @brief Indique si la clock MIDI est active.
  */
 bool midi_clock_is_running(void) { return s_running; }
+
+/**
+ * @brief Remet les statistiques d’horloge à zéro.
+ */
+size_t midi_clock_stack_unused(void) {
+  return stack_watch_unused(waClockSeq, sizeof(waClockSeq));
+}
+
+void midi_clock_stats_reset(void) {
+  chSysLock();
+  clock_jitter_reset(&midi_clock_stats.f8);
+  clock_jitter_reset(&midi_clock_stats.seq);
+  midi_clock_stats.queue_high_water = 0U;
+  midi_clock_stats.seq_overruns = 0U;
+  chSysUnlock();
+}
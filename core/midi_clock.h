@@ -3,11 +3,16 @@
  * @brief Interface du générateur d’horloge MIDI (24 PPQN via GPT3).
  *
  * Ce module fournit une horloge MIDI conforme à la spécification :
- * - Envoi automatique de messages `0xF8` à fréquence dépendant du BPM.
+ * - Envoi automatique de messages `0xF8` à fréquence dépendant du BPM,
+ *   directement depuis l’ISR du timer (DIN + USB), sans passer par un thread.
  * - Basée sur le timer matériel **TIM3** configuré à 1 MHz.
- * - Résolution temporelle : **1 µs**.
- * - Prise en charge du **callback applicatif** à chaque tick (24 PPQN).
- * - Support du démarrage/arrêt dynamique et ajustement de tempo en temps réel.
+ * - Période tenue par un accumulateur de phase (`clock_dda.h`) : intervalles
+ *   entiers en µs, moyenne exacte au millième de BPM, aucune dérive cumulée.
+ * - Prise en charge du **callback applicatif** à chaque tick (24 PPQN), avec
+ *   l’horodatage nominal du tick, appelé par un thread séquenceur distinct
+ *   réveillé par l’ISR : le travail du step ne retarde jamais le F8.
+ * - Support du démarrage/arrêt dynamique, changement de tempo et rampes sans
+ *   redémarrage du timer.
  *
  * @ingroup midi
  */
@@ -17,7 +22,9 @@
 
 #include "ch.h"
 #include "hal.h"
-#include "midi.h"   /* pour midi_clock(MIDI_DEST_BOTH) */
+#include "midi.h"   /* pour midi_clock_i() */
+#include "clock_jitter.h"
+#include "hr_time.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,8 +37,37 @@ extern "C" {
 /**
  * @typedef midi_tick_cb_t
  * @brief Type de callback appelé à chaque tick MIDI (24 PPQN).
+ * @param now    Horodatage nominal du tick (accumulateur de phase, pas l’heure de réveil du thread).
+ * @param now_hr Même instant dans la base µs (`hr_time.h`), sans arrondi au tick système.
  */
-typedef void (*midi_tick_cb_t)(void);
+typedef void (*midi_tick_cb_t)(systime_t now, hr_time_t now_hr);
+
+/**
+ * @typedef midi_service_cb_t
+ * @brief Callback de service, appelé par le thread séquenceur après chaque réveil.
+ * @param now      Heure courante.
+ * @param next_due Prochaine échéance à servir (sortie).
+ * @return false s’il n’y a rien à servir avant le prochain tick (attente du tick seul).
+ */
+typedef bool (*midi_service_cb_t)(systime_t now, systime_t *next_due);
+
+/**
+ * @brief Statistiques de l’horloge interne (diagnostic, même esprit que `midi_tx_stats`).
+ *
+ * Sondes en µs, référence : instant nominal de chaque tick.
+ * - `f8` : émission du F8 dans l’ISR (latence d’interruption seule) ;
+ * - `seq` : entrée du callback dans le thread séquenceur (ordonnancement et
+ *   coût des steps précédents compris).
+ */
+typedef struct {
+  clock_jitter_t    f8;                /**< F8 émis depuis l’ISR. */
+  clock_jitter_t    seq;               /**< Callback séquenceur. */
+  volatile uint32_t queue_high_water;  /**< Ticks en attente du thread, maximum observé. */
+  volatile uint32_t seq_overruns;      /**< Ticks perdus pour le séquenceur (file pleine). */
+} midi_clock_stats_t;
+
+/** @brief Statistiques globales de l’horloge interne. */
+extern midi_clock_stats_t midi_clock_stats;
 
 /* ====================================================================== */
 /*                              API PUBLIQUE                              */
@@ -43,11 +79,28 @@ typedef void (*midi_tick_cb_t)(void);
  */
 void  midi_clock_register_tick_callback(midi_tick_cb_t cb);
 
+/**
+ * @brief Enregistre le callback de service du thread séquenceur.
+ *
+ * Appelé dans le thread `clock_seq` après les ticks de chaque réveil ; le
+ * thread se réveille ensuite à l’échéance rendue, même sans tick (résolution :
+ * le tick système).
+ */
+void  midi_clock_register_service_callback(midi_service_cb_t cb);
+
+/**
+ * @brief Réveille le thread séquenceur pour recalculer son échéance de service.
+ *
+ * À appeler après avoir planifié des événements hors du thread (horloge
+ * esclave, reçue dans le thread MIDI). Contexte thread.
+ */
+void  midi_clock_kick(void);
+
 /**
  * @brief Initialise le générateur d’horloge MIDI.
  *
  * Configure GPT3 (1 MHz), initialise la sémaphore de synchronisation
- * et crée le thread d’envoi des ticks.
+ * et crée le thread séquenceur qui reçoit les ticks.
  */
 void  midi_clock_init(void);
 
@@ -66,15 +119,35 @@ void  midi_clock_start(void);
 void  midi_clock_stop(void);
 
 /**
- * @brief Définit le BPM et recalcule l’intervalle du timer.
+ * @brief Définit le BPM (résolution 0,001 BPM).
  *
- * Si la clock est active, le GPT est redémarré avec la nouvelle période.
+ * Pris en compte à partir du prochain intervalle planifié : le timer n’est pas
+ * redémarré, la phase est conservée.
  * @param bpm Nouveau tempo en battements par minute.
  */
 void  midi_clock_set_bpm(float bpm);
 
 /**
- * @brief Retourne le tempo actuel (BPM).
+ * @brief Rampe linéaire du tempo (accelerando / ritardando).
+ *
+ * Le tempo rejoint @p bpm en @p ticks ticks 24 PPQN, tick par tick.
+ */
+void  midi_clock_ramp_bpm(float bpm, uint32_t ticks);
+
+/**
+ * @brief Durée de @p ticks ticks 24 PPQN au tempo courant, en `systime_t`.
+ *
+ * Arrondie une seule fois depuis la période exacte (un step = 6 ticks).
+ */
+systime_t midi_clock_span_st(uint32_t ticks);
+
+/**
+ * @brief Durée de @p ticks ticks 24 PPQN au tempo courant, en µs (`hr_time_t`).
+ */
+hr_time_t midi_clock_span_hr(uint32_t ticks);
+
+/**
+ * @brief Retourne le tempo actuel (BPM), rampe en cours comprise.
  */
 float midi_clock_get_bpm(void);
 
@@ -84,6 +157,17 @@ float midi_clock_get_bpm(void);
  */
 bool  midi_clock_is_running(void);
 
+/**
+ * @brief Remet à zéro les statistiques `midi_clock_stats`.
+ */
+void  midi_clock_stats_reset(void);
+
+/**
+ * @brief Marge de pile jamais atteinte par le thread séquenceur (`clock_seq`).
+ * @return Octets, 0 sans `CH_DBG_FILL_THREADS`.
+ */
+size_t midi_clock_stack_unused(void);
+
 #ifdef __cplusplus
 }
 #endif
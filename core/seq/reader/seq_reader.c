@@ -6,23 +6,115 @@
 
 #include "core/seq/runtime/seq_runtime_cold.h"
 #include "core/seq/runtime/seq_runtime_layout.h"
+#include "core/seq/runtime/seq_sections.h"
 #include "core/seq/seq_runtime.h"
 #include "core/seq/seq_project.h"
 #include "core/seq/seq_model.h"
+#include "core/seq/seq_scale.h"
+#include "core/seq/seq_scheduler.h"
 
 enum {
     k_seq_reader_plock_internal_flag = 0x8000U,
     k_seq_reader_plock_internal_voice_shift = 8U,
 };
 
+enum {
+    k_seq_reader_micro_min = -12,
+    k_seq_reader_micro_max = 12,
+};
+
 typedef struct {
-    const seq_model_plock_t *plocks;
-    uint8_t count;
-    uint8_t index;
+    seq_model_plock_iter_t cursor;
+    const seq_model_track_t *track;
+    uint32_t gen;
 } seq_reader_plock_iter_state_t;
 
 static seq_reader_plock_iter_state_t s_plock_iter_state;
 
+#ifndef SEQ_READER_PLAN_CAPACITY
+#define SEQ_READER_PLAN_CAPACITY SEQ_RUNTIME_TRACK_CAPACITY
+#endif
+
+// Compile attempts per rebuild before falling back to the last consistent plan.
+#ifndef SEQ_READER_PLAN_ATTEMPTS
+#define SEQ_READER_PLAN_ATTEMPTS 2U
+#endif
+
+// Service passes an outdated ready plan is left to the runner before it is
+// compiled again: continuous edits must not keep the runner from swapping.
+#ifndef SEQ_READER_PLAN_BACK_WAITS
+#define SEQ_READER_PLAN_BACK_WAITS 2U
+#endif
+
+_Static_assert(SEQ_PLAN_STEP_COUNT == SEQ_MODEL_STEPS_PER_TRACK, "plan/model step count mismatch");
+_Static_assert(SEQ_PLAN_VOICE_COUNT == SEQ_MODEL_VOICES_PER_STEP, "plan/model voice count mismatch");
+
+// What a compiled plan was built from.
+typedef struct {
+    const seq_model_track_t *track;
+    uint32_t track_gen;
+    uint32_t project_gen;
+    uint8_t bank;
+    uint8_t pattern;
+    bool valid;
+} seq_reader_plan_key_t;
+
+// Back buffer ownership: the plan service compiles into a free buffer, the
+// runner swaps a ready one in. Transitions are CAS so neither side waits.
+enum {
+    k_back_free = 0U,  // service may claim it
+    k_back_busy = 1U,  // service compiling
+    k_back_ready = 2U, // compiled, the runner may swap it in
+    k_back_swap = 3U,  // runner swapping
+};
+
+// Two plans per track: `live` (played by the runner) and `back` (compiled off
+// the tick by seq_reader_plan_service()). `live_buf` selects which of
+// s_plan_front[i] / s_plan_back[i] is live.
+typedef struct {
+    seq_reader_plan_key_t key;      // of the live plan
+    uint32_t publish;               // seqlock over live_buf + key (odd while they change)
+    uint8_t live_buf;
+    seq_reader_plan_key_t back_key; // of the back plan, written by the service only
+    bool back_prefetch;             // back holds the queued pattern's track (swapped after the flip)
+    uint8_t back_waits;             // service passes that left an outdated ready plan to the runner
+    uint32_t back_state;            // k_back_*
+} seq_reader_plan_slot_t;
+
+static seq_reader_plan_slot_t s_plan_cache[SEQ_READER_PLAN_CAPACITY];
+static seq_plan_track_t s_plan_front[SEQ_READER_PLAN_CAPACITY];
+static SEQ_CCM_SEC seq_plan_track_t s_plan_back[SEQ_READER_PLAN_CAPACITY];
+// Note maps of the track scales, one per compiling context (rebuilt when the scale changes).
+static seq_scale_lut_t s_plan_service_scale;
+static seq_scale_lut_t s_plan_runner_scale;
+static uint32_t s_plan_rebuilds;
+
+// Footprint guard on the real storage (seq_runtime_hot_budget.c only reports it).
+// The resident tracks and the scheduler queue share the hot budget with the
+// Reader; the spare track set of the pattern queue shares the CCM with the back plans.
+#define SEQ_READER_HOT_BYTES (sizeof(s_plan_cache) + sizeof(s_plan_front) + sizeof(s_plan_service_scale) + \
+                              sizeof(s_plan_runner_scale))
+#define SEQ_READER_TRACK_SET_BYTES (sizeof(seq_model_track_t) * SEQ_RUNTIME_TRACK_CAPACITY)
+_Static_assert((SEQ_READER_HOT_BYTES + sizeof(s_plock_iter_state) + SEQ_READER_TRACK_SET_BYTES +
+                (sizeof(seq_scheduler_event_t) * SEQ_SCHEDULER_CAPACITY)) <= SEQ_RUNTIME_HOT_BUDGET_MAX,
+               "Hot runtime footprint exceeds budget");
+_Static_assert((sizeof(s_plan_back) + SEQ_READER_TRACK_SET_BYTES) <= SEQ_RUNTIME_CCM_BUDGET_MAX,
+               "Spare track set and back plans exceed the CCM budget");
+
+const size_t seq_reader_hot_bytes = SEQ_READER_HOT_BYTES;
+const size_t seq_reader_scratch_bytes = sizeof(s_plock_iter_state);
+const size_t seq_reader_ccm_bytes = sizeof(s_plan_back);
+
+seq_reader_sync_stats_t seq_reader_sync_stats;
+
+static const seq_project_t *_resolve_project(void) {
+    const seq_runtime_blocks_t *blocks = seq_runtime_blocks_get();
+    if ((blocks == NULL) || (blocks->hot_impl == NULL)) {
+        return NULL;
+    }
+    return (const seq_project_t *)blocks->hot_impl;
+}
+
 static const seq_model_track_t *_resolve_legacy_track(seq_track_handle_t handle) {
     if ((handle.bank >= SEQ_PROJECT_BANK_COUNT) ||
         (handle.pattern >= SEQ_PROJECT_PATTERNS_PER_BANK) ||
@@ -30,12 +122,7 @@ static const seq_model_track_t *_resolve_legacy_track(seq_track_handle_t handle)
         return NULL;
     }
 
-    const seq_runtime_blocks_t *blocks = seq_runtime_blocks_get();
-    if ((blocks == NULL) || (blocks->hot_impl == NULL)) {
-        return NULL;
-    }
-
-    const seq_project_t *project = (const seq_project_t *)blocks->hot_impl;
+    const seq_project_t *project = _resolve_project();
     if (project == NULL) {
         return NULL;
     }
@@ -62,13 +149,23 @@ static const seq_model_voice_t *_select_primary_voice(const seq_model_step_t *st
     return &step->voices[0];
 }
 
+static int32_t _clamp_i32(int32_t value, int32_t lo, int32_t hi) {
+    if (value < lo) {
+        return lo;
+    }
+    if (value > hi) {
+        return hi;
+    }
+    return value;
+}
+
 static uint16_t _encode_plock_id(const seq_model_plock_t *plock) {
     if (plock == NULL) {
         return 0U;
     }
 
     if (plock->domain == SEQ_MODEL_PLOCK_CART) {
-        return plock->parameter_id;
+        return (uint16_t)(plock->parameter_id | (plock->slide ? SEQ_READER_PLOCK_CART_SLIDE : 0U));
     }
 
     const uint16_t voice = ((uint16_t)(plock->voice_index & 0x03U)) << k_seq_reader_plock_internal_voice_shift;
@@ -76,6 +173,101 @@ static uint16_t _encode_plock_id(const seq_model_plock_t *plock) {
     return (uint16_t)(k_seq_reader_plock_internal_flag | voice | param);
 }
 
+// Resolve one voice as it must be played: step "All" offsets (SEQ_BEHAVIOR §1.1),
+// track transpose and scale clamp (§1.4) through @p scale, the track's prepared
+// note map (NULL: quantised without a map). Returns false when the voice is silent.
+static bool _resolve_voice(const seq_model_track_t *track,
+                           const seq_model_step_t *step,
+                           uint8_t voice_slot,
+                           const seq_scale_lut_t *scale,
+                           seq_plan_voice_t *out) {
+    const seq_model_voice_t *voice = &step->voices[voice_slot];
+    if ((voice->state != SEQ_MODEL_VOICE_ENABLED) || (voice->velocity == 0U)) {
+        return false;
+    }
+
+    const seq_model_step_offsets_t *offsets = &step->offsets;
+    const int32_t velocity = _clamp_i32((int32_t)voice->velocity + (int32_t)offsets->velocity, 0, 127);
+    if (velocity == 0) {
+        return false;
+    }
+
+    const seq_model_track_config_t *config = &track->config;
+    const int32_t note = (int32_t)voice->note + (int32_t)offsets->transpose +
+                         (int32_t)config->transpose.global + (int32_t)config->transpose.per_voice[voice_slot];
+
+    const uint8_t clamped = (uint8_t)_clamp_i32(note, 0, 127);
+    out->note = (scale != NULL) ? seq_scale_lut_apply(scale, clamped)
+                                : seq_scale_snap(seq_scale_config_mask(&config->scale), config->scale.root, clamped);
+    out->vel = (uint8_t)velocity;
+    out->length = (uint8_t)_clamp_i32((int32_t)voice->length + (int32_t)offsets->length,
+                                      1, (int32_t)SEQ_MODEL_STEPS_PER_TRACK);
+    out->micro = (int8_t)_clamp_i32((int32_t)voice->micro_offset + (int32_t)offsets->micro,
+                                    k_seq_reader_micro_min, k_seq_reader_micro_max);
+    return true;
+}
+
+static uint8_t _compute_step_flags(const seq_model_step_t *step) {
+    const bool has_voice = seq_model_step_has_playable_voice(step);
+    const bool has_seq_plock = seq_model_step_has_seq_plock(step);
+    const bool has_cart_plock = seq_model_step_has_cart_plock(step);
+    const bool automation = seq_model_step_is_automation_only(step);
+
+    uint8_t flags = 0U;
+    if (has_voice) {
+        flags |= SEQ_STEPF_HAS_VOICE;
+    }
+    if (has_seq_plock || has_cart_plock) {
+        flags |= SEQ_STEPF_HAS_ANY_PLOCK;
+    }
+    if (has_seq_plock) {
+        flags |= SEQ_STEPF_HAS_SEQ_PLOCK;
+    }
+    if (has_cart_plock) {
+        flags |= SEQ_STEPF_HAS_CART_PLOCK;
+    }
+    if (automation) {
+        flags |= SEQ_STEPF_AUTOMATION_ONLY;
+    }
+    return flags;
+}
+
+static void _compile_plan(const seq_model_track_t *track, seq_scale_lut_t *scale, seq_plan_track_t *plan) {
+    memset(plan, 0, sizeof(*plan));
+    (void)seq_scale_lut_prepare(scale, seq_scale_config_mask(&track->config.scale), track->config.scale.root);
+
+    for (uint8_t i = 0U; i < SEQ_MODEL_STEPS_PER_TRACK; ++i) {
+        const seq_model_step_t *step = &track->steps[i];
+        const uint8_t flags = _compute_step_flags(step);
+
+        plan->flags[i] = flags;
+        if ((flags & SEQ_STEPF_HAS_CART_PLOCK) != 0U) {
+            plan->cart_plock_bits |= (uint64_t)1U << i;
+        }
+        if (((flags & SEQ_STEPF_HAS_VOICE) == 0U) || ((flags & SEQ_STEPF_AUTOMATION_ONLY) != 0U)) {
+            continue;
+        }
+
+        for (uint8_t slot = 0U; slot < SEQ_MODEL_VOICES_PER_STEP; ++slot) {
+            seq_plan_voice_t voice;
+            if (!_resolve_voice(track, step, slot, scale, &voice)) {
+                continue;
+            }
+            plan->note[i][slot] = voice.note;
+            plan->vel[i][slot] = voice.vel;
+            plan->length[i][slot] = voice.length;
+            plan->micro[i][slot] = voice.micro;
+            plan->voice_mask[i] |= (uint8_t)(1U << slot);
+            if (voice.micro < 0) {
+                plan->voice_mask[i] |= (uint8_t)(1U << (SEQ_PLAN_VOICE_EARLY_SHIFT + slot));
+            }
+        }
+        if (plan->voice_mask[i] != 0U) {
+            plan->voice_bits |= (uint64_t)1U << i;
+        }
+    }
+}
+
 bool seq_reader_get_step(seq_track_handle_t h, uint8_t step, seq_step_view_t *out) {
     if (out == NULL) {
         return false;
@@ -99,31 +291,7 @@ bool seq_reader_get_step(seq_track_handle_t h, uint8_t step, seq_step_view_t *ou
         out->micro = voice->micro_offset;
     }
 
-    if (legacy_step != NULL) {
-        const bool has_voice = seq_model_step_has_playable_voice(legacy_step);
-        const bool has_seq_plock = seq_model_step_has_seq_plock(legacy_step);
-        const bool has_cart_plock = seq_model_step_has_cart_plock(legacy_step);
-        const bool has_any_plock = has_seq_plock || has_cart_plock;
-        const bool automation = seq_model_step_is_automation_only(legacy_step);
-
-        uint8_t flags = 0U;
-        if (has_voice) {
-            flags |= SEQ_STEPF_HAS_VOICE;
-        }
-        if (has_any_plock) {
-            flags |= SEQ_STEPF_HAS_ANY_PLOCK;
-        }
-        if (has_seq_plock) {
-            flags |= SEQ_STEPF_HAS_SEQ_PLOCK;
-        }
-        if (has_cart_plock) {
-            flags |= SEQ_STEPF_HAS_CART_PLOCK;
-        }
-        if (automation) {
-            flags |= SEQ_STEPF_AUTOMATION_ONLY;
-        }
-        out->flags = flags;
-    }
+    out->flags = _compute_step_flags(legacy_step);
 
     return true;
 }
@@ -145,13 +313,12 @@ bool seq_reader_get_step_voice(seq_track_handle_t h,
         return false;
     }
 
-    const seq_model_step_t *legacy_step = &track->steps[step];
-    const seq_model_voice_t *voice = &legacy_step->voices[voice_slot];
-    if ((voice->state == SEQ_MODEL_VOICE_ENABLED) && (voice->velocity > 0U)) {
-        out->note = voice->note;
-        out->vel = voice->velocity;
-        out->length = voice->length;
-        out->micro = voice->micro_offset;
+    seq_plan_voice_t resolved;
+    if (_resolve_voice(track, &track->steps[step], voice_slot, NULL, &resolved)) {
+        out->note = resolved.note;
+        out->vel = resolved.vel;
+        out->length = resolved.length;
+        out->micro = resolved.micro;
         out->enabled = true;
     }
 
@@ -194,37 +361,300 @@ bool seq_reader_plock_iter_open(seq_track_handle_t h, uint8_t step, seq_plock_it
         return false;
     }
 
+    s_plock_iter_state.track = track;
+    s_plock_iter_state.gen = seq_model_gen_read_begin(&track->generation);
     const seq_model_step_t *legacy_step = &track->steps[step];
-    s_plock_iter_state.plocks = legacy_step->plocks;
-    s_plock_iter_state.count = legacy_step->plock_count;
-    s_plock_iter_state.index = 0U;
+    seq_model_step_plock_iter(legacy_step, &track->plocks, &s_plock_iter_state.cursor);
     it->_opaque = &s_plock_iter_state;
     return true;
 }
 
+bool seq_reader_plock_iter_torn(const seq_plock_iter_t *it) {
+    if ((it == NULL) || (it->_opaque == NULL)) {
+        return false;
+    }
+
+    const seq_reader_plock_iter_state_t *state = (const seq_reader_plock_iter_state_t *)it->_opaque;
+    if (!seq_model_gen_read_retry(&state->track->generation, state->gen)) {
+        return false;
+    }
+    seq_reader_sync_stats.torn_plocks++;
+    return true;
+}
+
 bool seq_reader_plock_iter_next(seq_plock_iter_t *it, uint16_t *param_id, int32_t *value) {
     if ((it == NULL) || (it->_opaque == NULL)) {
         return false;
     }
 
     seq_reader_plock_iter_state_t *state = (seq_reader_plock_iter_state_t *)it->_opaque;
-    if ((state->plocks == NULL) || (state->index >= state->count)) {
+    seq_model_plock_t plock;
+    if (!seq_model_plock_iter_next(&state->cursor, &plock)) {
         return false;
     }
 
-    const seq_model_plock_t *plock = &state->plocks[state->index];
-    state->index++;
-
     if (param_id != NULL) {
-        *param_id = _encode_plock_id(plock);
+        *param_id = _encode_plock_id(&plock);
     }
     if (value != NULL) {
-        *value = (int32_t)plock->value;
+        *value = (int32_t)plock.value;
+    }
+
+    return true;
+}
+
+/* Compile @p track into @p plan under its seqlock. Never waits for the
+   writer: a torn read is retried at most SEQ_READER_PLAN_ATTEMPTS times. */
+static bool _compile_plan_consistent(const seq_model_track_t *track, seq_scale_lut_t *scale,
+                                     seq_plan_track_t *plan, uint32_t *out_gen) {
+    for (uint8_t attempt = 0U; attempt < SEQ_READER_PLAN_ATTEMPTS; ++attempt) {
+        const uint32_t gen = seq_model_gen_read_begin(&track->generation);
+        if ((gen & 1U) != 0U) {
+            // Writer preempted mid-edit: it cannot finish while we spin.
+            __atomic_fetch_add(&seq_reader_sync_stats.writer_active, 1U, __ATOMIC_RELAXED);
+            return false;
+        }
+        _compile_plan(track, scale, plan);
+        if (!seq_model_gen_read_retry(&track->generation, gen)) {
+            *out_gen = gen;
+            __atomic_fetch_add(&s_plan_rebuilds, 1U, __ATOMIC_RELAXED);
+            return true;
+        }
+        __atomic_fetch_add(&seq_reader_sync_stats.torn_retries, 1U, __ATOMIC_RELAXED);
+    }
+    return false;
+}
+
+static seq_plan_track_t *_live_plan(uint8_t index, const seq_reader_plan_slot_t *slot) {
+    return (slot->live_buf == 0U) ? &s_plan_front[index] : &s_plan_back[index];
+}
+
+static seq_plan_track_t *_back_plan(uint8_t index, const seq_reader_plan_slot_t *slot) {
+    return (slot->live_buf == 0U) ? &s_plan_back[index] : &s_plan_front[index];
+}
+
+static bool _key_same_source(const seq_reader_plan_key_t *key, const seq_model_track_t *track, uint8_t bank,
+                             uint8_t pattern) {
+    return key->valid && (key->track == track) && (key->bank == bank) && (key->pattern == pattern);
+}
+
+static bool _key_current(const seq_reader_plan_key_t *key, const seq_model_track_t *track, uint32_t track_gen,
+                         uint32_t project_gen, uint8_t bank, uint8_t pattern) {
+    return _key_same_source(key, track, bank, pattern) && (key->track_gen == track_gen) &&
+           (key->project_gen == project_gen);
+}
+
+static void _publish_begin(seq_reader_plan_slot_t *slot) {
+    __atomic_store_n(&slot->publish, slot->publish + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void _publish_end(seq_reader_plan_slot_t *slot) {
+    __atomic_store_n(&slot->publish, slot->publish + 1U, __ATOMIC_RELEASE);
+}
+
+static bool _back_claim(seq_reader_plan_slot_t *slot, uint32_t from, uint32_t to) {
+    uint32_t expected = from;
+    return __atomic_compare_exchange_n(&slot->back_state, &expected, to, false, __ATOMIC_ACQUIRE,
+                                       __ATOMIC_RELAXED);
+}
+
+/* Runner side: swap in the back plan if it was built from what is bound now. */
+static void _take_back(seq_reader_plan_slot_t *slot, const seq_model_track_t *track, uint32_t project_gen,
+                       uint8_t bank, uint8_t pattern) {
+    if (__atomic_load_n(&slot->back_state, __ATOMIC_ACQUIRE) != k_back_ready) {
+        return;
+    }
+    // Built from the bound track: newer than the live plan even if edits landed
+    // since (the service compiles those next). A prefetched plan matches once
+    // the flip bound its track.
+    if (!_back_claim(slot, k_back_ready, k_back_swap)) {
+        return;
+    }
+    const seq_reader_plan_key_t *back = &slot->back_key;
+    if (!_key_same_source(back, track, bank, pattern)) {
+        __atomic_store_n(&slot->back_state, k_back_ready, __ATOMIC_RELEASE);
+        return;
+    }
+    _publish_begin(slot);
+    slot->key = *back;
+    if (slot->back_prefetch) {
+        slot->key.project_gen = project_gen; // compiled before the flip moved it
+    }
+    slot->live_buf ^= 1U;
+    _publish_end(slot);
+    __atomic_store_n(&slot->back_state, k_back_free, __ATOMIC_RELEASE);
+    seq_reader_sync_stats.swaps++;
+}
+
+const seq_plan_track_t *seq_reader_get_plan(seq_track_handle_t h) {
+    if (h.track >= SEQ_READER_PLAN_CAPACITY) {
+        return NULL;
+    }
+
+    const seq_model_track_t *track = _resolve_legacy_track(h);
+    if (track == NULL) {
+        return NULL;
+    }
+
+    const seq_project_t *project = _resolve_project();
+    seq_reader_plan_slot_t *slot = &s_plan_cache[h.track];
+    const uint32_t track_gen = __atomic_load_n(&track->generation.value, __ATOMIC_ACQUIRE);
+    const uint32_t project_gen = project->generation.value;
+    _take_back(slot, track, project_gen, h.bank, h.pattern);
+
+    if (_key_same_source(&slot->key, track, h.bank, h.pattern)) {
+        if ((slot->key.track_gen != track_gen) || (slot->key.project_gen != project_gen)) {
+            // Edited since: keep playing this plan until the service swaps the new one in.
+            seq_reader_sync_stats.stale_plans++;
+        }
+        return _live_plan(h.track, slot);
+    }
+
+    // Nothing compiled for the bound track yet (first play, flip without prefetch).
+    // The live plan belongs to another source and only the runner reads it:
+    // compile in place, the key stays invalid if the read was torn.
+    uint32_t gen = 0U;
+    _publish_begin(slot);
+    slot->key.valid = false;
+    const bool compiled = _compile_plan_consistent(track, &s_plan_runner_scale, _live_plan(h.track, slot), &gen);
+    if (compiled) {
+        slot->key = (seq_reader_plan_key_t){track, gen, project_gen, h.bank, h.pattern, true};
+    }
+    _publish_end(slot);
+    if (!compiled) {
+        return NULL;
+    }
+    seq_reader_sync_stats.tick_compiles++;
+    return _live_plan(h.track, slot);
+}
+
+/* Service side: compile @p track into the back buffer of @p index unless the live
+   or the ready plan already matches. Returns true if a plan was compiled. */
+static bool _service_compile(uint8_t index, const seq_model_track_t *track, uint32_t project_gen, uint8_t bank,
+                             uint8_t pattern, bool prefetch) {
+    seq_reader_plan_slot_t *slot = &s_plan_cache[index];
+    const uint32_t track_gen = __atomic_load_n(&track->generation.value, __ATOMIC_ACQUIRE);
+
+    if (!prefetch) {
+        const uint32_t publish = __atomic_load_n(&slot->publish, __ATOMIC_ACQUIRE);
+        const seq_reader_plan_key_t live = slot->key;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (((publish & 1U) != 0U) || (__atomic_load_n(&slot->publish, __ATOMIC_RELAXED) != publish)) {
+            return false; // runner swapping: look again on the next pass
+        }
+        if (_key_current(&live, track, track_gen, project_gen, bank, pattern)) {
+            return false;
+        }
     }
 
+    const uint32_t state = __atomic_load_n(&slot->back_state, __ATOMIC_ACQUIRE);
+    if (state == k_back_ready) {
+        if ((slot->back_prefetch == prefetch) && _key_same_source(&slot->back_key, track, bank, pattern) &&
+            (slot->back_key.track_gen == track_gen) && (prefetch || (slot->back_key.project_gen == project_gen))) {
+            return false; // already waiting for the runner
+        }
+        if (prefetch && !slot->back_prefetch) {
+            return false; // an edit waits for its swap: it wins over the prefetch
+        }
+        if (!prefetch && !slot->back_prefetch && _key_same_source(&slot->back_key, track, bank, pattern) &&
+            (slot->back_waits++ < SEQ_READER_PLAN_BACK_WAITS)) {
+            return false; // outdated, but still newer than live: give the runner a chance to take it
+        }
+    }
+    if (((state != k_back_free) && (state != k_back_ready)) || !_back_claim(slot, state, k_back_busy)) {
+        return false; // runner swapping it in
+    }
+
+    uint32_t gen = 0U;
+    if (!_compile_plan_consistent(track, &s_plan_service_scale, _back_plan(index, slot), &gen)) {
+        __atomic_store_n(&slot->back_state, k_back_free, __ATOMIC_RELEASE);
+        return false;
+    }
+    slot->back_key = (seq_reader_plan_key_t){track, gen, project_gen, bank, pattern, true};
+    slot->back_prefetch = prefetch;
+    slot->back_waits = 0U;
+    __atomic_store_n(&slot->back_state, k_back_ready, __ATOMIC_RELEASE);
     return true;
 }
 
+uint8_t seq_reader_plan_service(void) {
+    const seq_project_t *project = _resolve_project();
+    if (project == NULL) {
+        return 0U;
+    }
+    const uint8_t bank = project->active_bank;
+    const uint8_t pattern = project->active_pattern;
+    const uint32_t project_gen = __atomic_load_n(&project->generation.value, __ATOMIC_ACQUIRE);
+
+    uint8_t compiled = 0U;
+    for (uint8_t t = 0U; t < SEQ_READER_PLAN_CAPACITY; ++t) {
+        const seq_model_track_t *track = seq_project_get_track_const(project, t);
+        if ((track != NULL) && _service_compile(t, track, project_gen, bank, pattern, false)) {
+            compiled++;
+        }
+    }
+    return compiled;
+}
+
+uint8_t seq_reader_plan_prefetch(uint8_t bank, uint8_t pattern, const seq_model_track_t *const *tracks,
+                                 uint8_t count) {
+    if (tracks == NULL) {
+        return 0U;
+    }
+    if (count > SEQ_READER_PLAN_CAPACITY) {
+        count = SEQ_READER_PLAN_CAPACITY;
+    }
+
+    uint8_t compiled = 0U;
+    for (uint8_t t = 0U; t < count; ++t) {
+        if ((tracks[t] != NULL) && _service_compile(t, tracks[t], 0U, bank, pattern, true)) {
+            compiled++;
+        }
+    }
+    return compiled;
+}
+
+bool seq_reader_get_step_flags(seq_track_handle_t h, uint8_t first, uint8_t count, uint8_t *out) {
+    if ((out == NULL) || (count == 0U)) {
+        return false;
+    }
+
+    memset(out, 0, count);
+    const uint8_t avail = (first < SEQ_PLAN_STEP_COUNT) ? (uint8_t)(SEQ_PLAN_STEP_COUNT - first) : 0U;
+    const uint8_t n = (count < avail) ? count : avail;
+    const seq_model_track_t *track = _resolve_legacy_track(h);
+    if ((track == NULL) || (h.track >= SEQ_READER_PLAN_CAPACITY)) {
+        return false;
+    }
+
+    // Read-only on the cache. Copy the live plan if it is current, otherwise
+    // derive the flags from the track directly.
+    const seq_reader_plan_slot_t *slot = &s_plan_cache[h.track];
+    const uint32_t publish = __atomic_load_n(&slot->publish, __ATOMIC_ACQUIRE);
+    if (((publish & 1U) == 0U) && _key_same_source(&slot->key, track, h.bank, h.pattern) &&
+        (slot->key.track_gen == __atomic_load_n(&track->generation.value, __ATOMIC_ACQUIRE))) {
+        memcpy(out, &_live_plan(h.track, slot)->flags[first], n);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->publish, __ATOMIC_RELAXED) == publish) {
+            return true;
+        }
+    }
+
+    for (uint8_t i = 0U; i < n; ++i) {
+        out[i] = _compute_step_flags(&track->steps[first + i]);
+    }
+    return true;
+}
+
+uint32_t seq_reader_plan_rebuild_count(void) {
+    return s_plan_rebuilds;
+}
+
+void seq_reader_sync_stats_reset(void) {
+    memset(&seq_reader_sync_stats, 0, sizeof(seq_reader_sync_stats));
+}
+
 seq_track_handle_t seq_reader_get_active_track_handle(void) {
     seq_track_handle_t h = (seq_track_handle_t){0U, 0U, 0U};
     seq_cold_view_t project_view = seq_runtime_cold_view(SEQ_COLDV_PROJECT);
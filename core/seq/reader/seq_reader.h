@@ -1,7 +1,9 @@
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "core/seq/seq_handles.h"
+#include "core/seq/seq_model.h"
 #include "core/seq/seq_views.h"
 
 #ifdef __cplusplus
@@ -17,7 +19,56 @@ bool seq_reader_count_step_voices(seq_track_handle_t h,
                                   uint8_t step,
                                   uint8_t *out_count);
 bool seq_reader_plock_iter_open(seq_track_handle_t h, uint8_t step, seq_plock_iter_t *it);
+// Cart p-lock ids are returned as is, with SEQ_READER_PLOCK_CART_SLIDE set when
+// the lock ramps to its value over the step; bit 15 marks internal p-locks.
+#define SEQ_READER_PLOCK_CART_SLIDE 0x4000U
 bool seq_reader_plock_iter_next(seq_plock_iter_t *it, uint16_t *param_id, int32_t *value);
+// True if the track was edited since the iterator was opened: the p-locks read
+// through it may be torn and must be discarded (counted in torn_plocks).
+bool seq_reader_plock_iter_torn(const seq_plock_iter_t *it);
+
+// Lock-free publication: tracks are read under their generation seqlock
+// (seq_model_gen_read_begin/retry); the Reader never waits for a writer.
+typedef struct {
+    uint32_t torn_retries;  // plan compiles discarded because the track moved under them
+    uint32_t writer_active; // rebuilds skipped because an edit was in progress
+    uint32_t stale_plans;   // ticks served from the previous consistent plan
+    uint32_t torn_plocks;   // p-lock walks discarded
+    uint32_t swaps;         // plans compiled off the tick and swapped in by the runner
+    uint32_t tick_compiles; // plans the runner had to compile itself (nothing compiled for the bound track)
+} seq_reader_sync_stats_t;
+
+extern seq_reader_sync_stats_t seq_reader_sync_stats;
+void seq_reader_sync_stats_reset(void);
+
+// Compiled playback plan of a track (NULL if the handle does not resolve).
+// Plans are compiled off the tick by seq_reader_plan_service(); the runner only
+// swaps the newest one in and keeps playing the previous plan until then. It
+// compiles itself only when nothing was compiled for the bound track yet
+// (counted in tick_compiles). The plan stays valid until the next call for the
+// same track. Reader context only (runner).
+const seq_plan_track_t *seq_reader_get_plan(seq_track_handle_t h);
+// Compile the plans of the active pattern whose track or project generation
+// moved since their last compile. Call after seq_model_gen_write_end(), from
+// the single context that edits tracks (UI thread). Returns the plans compiled.
+uint8_t seq_reader_plan_service(void);
+// Compile the plans of (bank, pattern) from @p tracks before they are bound
+// (pattern queue shadow set), so the runner swaps them in on the flip. Same
+// context as seq_reader_plan_service(); a pending edit plan is never replaced.
+uint8_t seq_reader_plan_prefetch(uint8_t bank, uint8_t pattern, const seq_model_track_t *const *tracks,
+                                 uint8_t count);
+uint32_t seq_reader_plan_rebuild_count(void);
+
+// Bytes of Reader state: plan cache, live plans and runner fallback in the hot
+// set, p-lock cursor (real-time scratch), back plans in CCM. seq_reader.c checks
+// them against the budgets of seq_runtime_layout.h.
+extern const size_t seq_reader_hot_bytes;
+extern const size_t seq_reader_scratch_bytes;
+extern const size_t seq_reader_ccm_bytes;
+// SEQ_STEPF_* of steps [first, first + count) copied from the published plan when
+// it is current, else derived from the track; steps past the track end read as 0.
+// Never compiles, callable from any thread. Returns false if the handle does not resolve.
+bool seq_reader_get_step_flags(seq_track_handle_t h, uint8_t first, uint8_t count, uint8_t *out);
 
 // MP3a: expose active track handle for apps
 seq_track_handle_t seq_reader_get_active_track_handle(void);
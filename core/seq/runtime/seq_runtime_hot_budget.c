@@ -1,40 +1,33 @@
 #include "core/seq/runtime/seq_runtime_hot_budget.h"
 
+#include "core/seq/reader/seq_reader.h"
 #include "core/seq/runtime/seq_runtime_layout.h"
 #include "core/seq/seq_model.h"
+#include "core/seq/seq_runtime.h"
+#include "core/seq/seq_scheduler.h"
 
-// Local replica of the private Reader scratch state declared in seq_reader.c.
-typedef struct {
-    const seq_model_plock_t *plocks;
-    uint8_t count;
-    uint8_t index;
-} seq_reader_plock_iter_state_sizeof_t;
-
+// The Reader exports the size of its real storage and checks the hot and CCM
+// totals at compile time (seq_reader.c); the other blocks are public types.
 enum {
-    k_hot_reader_core = sizeof(seq_reader_plock_iter_state_sizeof_t),
-    k_hot_scheduler_total = 0U,
-    k_hot_scheduler_queue = 0U,
+    k_hot_scheduler_queue = sizeof(seq_scheduler_event_t) * SEQ_SCHEDULER_CAPACITY,
     k_hot_scheduler_core = 0U,
     k_hot_player_core = 0U,
-    k_hot_reader_plock_iter = sizeof(seq_reader_plock_iter_state_sizeof_t),
-    k_hot_player_stack_bytes = 0U,
-    k_hot_rt_scratch = k_hot_reader_plock_iter,
-    k_hot_total = k_hot_reader_core + k_hot_scheduler_core + k_hot_player_core +
-                  k_hot_scheduler_queue + k_hot_rt_scratch
+    // Resident tracks edited in place by the UI and walked by the Reader (p-locks pooled per track).
+    k_hot_tracks = sizeof(seq_model_track_t) * SEQ_RUNTIME_TRACK_CAPACITY,
+    // Spare track set of the pattern queue (seq_runtime.c), placed in CCM.
+    k_ccm_spare_tracks = sizeof(seq_model_track_t) * SEQ_RUNTIME_TRACK_CAPACITY,
 };
 
-_Static_assert(k_hot_scheduler_total >= k_hot_scheduler_queue,
-               "scheduler queue size exceeds scheduler total");
-_Static_assert(k_hot_total <= SEQ_RUNTIME_HOT_BUDGET_MAX,
-               "Hot runtime footprint exceeds budget");
-
 seq_hot_snapshot_t seq_runtime_hot_snapshot(void) {
     seq_hot_snapshot_t snapshot = {0};
-    snapshot.sizeof_reader_core = (size_t)k_hot_reader_core;
+    snapshot.sizeof_reader_core = seq_reader_hot_bytes;
     snapshot.sizeof_scheduler_core = (size_t)k_hot_scheduler_core;
     snapshot.sizeof_player_core = (size_t)k_hot_player_core;
     snapshot.sizeof_rt_queues = (size_t)k_hot_scheduler_queue;
-    snapshot.sizeof_rt_scratch = (size_t)k_hot_rt_scratch;
+    snapshot.sizeof_rt_scratch = seq_reader_scratch_bytes;
+    snapshot.sizeof_tracks = (size_t)k_hot_tracks;
+    snapshot.sizeof_ccm_tracks = (size_t)k_ccm_spare_tracks;
+    snapshot.sizeof_ccm_plans = seq_reader_ccm_bytes;
     return snapshot;
 }
 
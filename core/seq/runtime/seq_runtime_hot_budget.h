@@ -12,6 +12,9 @@ typedef struct {
     size_t sizeof_player_core;
     size_t sizeof_rt_queues;
     size_t sizeof_rt_scratch;
+    size_t sizeof_tracks;      // pistes résidentes (steps + arène p-lock)
+    size_t sizeof_ccm_tracks;  // jeu de réserve de la file de patterns (CCM, hors total hot)
+    size_t sizeof_ccm_plans;   // plans compilés hors tick, en attente d'échange (CCM, hors total hot)
 } seq_hot_snapshot_t;
 
 seq_hot_snapshot_t seq_runtime_hot_snapshot(void);
@@ -19,7 +22,7 @@ seq_hot_snapshot_t seq_runtime_hot_snapshot(void);
 static inline size_t seq_runtime_hot_total(const seq_hot_snapshot_t *s) {
     return s->sizeof_reader_core + s->sizeof_scheduler_core +
            s->sizeof_player_core + s->sizeof_rt_queues +
-           s->sizeof_rt_scratch;
+           s->sizeof_rt_scratch + s->sizeof_tracks;
 }
 
 #if defined(HOST_BUILD) || defined(UNIT_TEST)
@@ -4,7 +4,10 @@
 
 // Budgets cibles (peuvent être ajustés plus tard, mais fixés pour la CI host)
 #ifndef SEQ_RUNTIME_HOT_BUDGET_MAX
-#define SEQ_RUNTIME_HOT_BUDGET_MAX (64u * 1024u)   // 64 KiB hot
+#define SEQ_RUNTIME_HOT_BUDGET_MAX (64u * 1024u)   // 64 KiB hot (pistes + cache de plans + file)
+#endif
+#ifndef SEQ_RUNTIME_CCM_BUDGET_MAX
+#define SEQ_RUNTIME_CCM_BUDGET_MAX (62u * 1024u)   // pistes de réserve + plans de fond, sur les 64 KiB de CCM
 #endif
 #ifndef SEQ_RUNTIME_COLD_BUDGET_HINT
 #define SEQ_RUNTIME_COLD_BUDGET_HINT (96u * 1024u) // indicatif
@@ -13,3 +13,10 @@
 #else
 #    define SEQ_HOT_SEC
 #endif
+
+// Zeroed at boot by crt1 like .bss (ram4 area of the ChibiOS startup).
+#if SEQ_ENABLE_CCM_SECTIONS
+#    define SEQ_CCM_SEC __attribute__((section(".ram4_clear.seq")))
+#else
+#    define SEQ_CCM_SEC
+#endif
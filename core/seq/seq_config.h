@@ -15,6 +15,15 @@
 #define SEQ_ENABLE_HOT_SECTIONS 0
 #endif
 
+// CCM placement (STM32F4 ram4: CPU only, no DMA). Host builds keep plain BSS.
+#ifndef SEQ_ENABLE_CCM_SECTIONS
+#if defined(HOST_BUILD) || defined(UNIT_TEST)
+#define SEQ_ENABLE_CCM_SECTIONS 0
+#else
+#define SEQ_ENABLE_CCM_SECTIONS 1
+#endif
+#endif
+
 #ifndef SEQ_EXPERIMENT_MOVE_ONE_BLOCK
 #define SEQ_EXPERIMENT_MOVE_ONE_BLOCK 0
 #endif
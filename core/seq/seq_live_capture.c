@@ -16,7 +16,7 @@ static void _seq_live_capture_reset_context(seq_live_capture_t *capture);
 static void _seq_live_capture_bind_track(seq_live_capture_t *capture, seq_model_track_t *track);
 static bool _seq_live_capture_compute_grid(const seq_live_capture_t *capture,
                                            seq_model_quantize_grid_t grid,
-                                           systime_t *out_duration);
+                                           hr_time_t *out_duration);
 static void _seq_live_capture_divmod(int64_t value, int64_t divisor, int64_t *quotient, int64_t *remainder);
 static int8_t _seq_live_capture_micro_from_delta(int64_t delta, int64_t step_duration);
 static int8_t _seq_live_capture_micro_from_within(int64_t within_step, int64_t step_duration);
@@ -25,14 +25,16 @@ static uint8_t _seq_live_capture_pick_voice_slot(const seq_model_step_t *step,
                                                  uint8_t requested,
                                                  uint8_t note);
 static void _seq_live_capture_clear_voice_trackers(seq_live_capture_t *capture);
+static uint8_t _seq_live_capture_scale_note(seq_live_capture_t *capture, uint8_t note);
 static bool _seq_live_capture_upsert_internal_plock(seq_model_step_t *step,
+                                                    seq_model_plock_pool_t *pool,
                                                     seq_model_plock_internal_param_t param,
                                                     uint8_t voice,
                                                     int32_t value);
 static uint8_t _seq_live_capture_compute_length_steps(const seq_live_capture_t *capture,
-                                                      systime_t start_time,
-                                                      systime_t end_time,
-                                                      systime_t step_duration_snapshot);
+                                                      hr_time_t start_time,
+                                                      hr_time_t end_time,
+                                                      hr_time_t step_duration_snapshot);
 
 void seq_live_capture_init(seq_live_capture_t *capture, const seq_live_capture_config_t *config) {
     chDbgCheck(capture != NULL);
@@ -75,14 +77,15 @@ bool seq_live_capture_is_recording(const seq_live_capture_t *capture) {
 void seq_live_capture_update_clock(seq_live_capture_t *capture, const clock_step_info_t *info) {
     chDbgCheck((capture != NULL) && (info != NULL));
 
-    capture->clock_step_time = info->now;
-    capture->clock_step_duration = info->step_st;
-    capture->clock_tick_duration = info->tick_st;
+    capture->clock_step_time = info->now_hr;
+    capture->clock_step_duration = info->step_hr;
+    capture->clock_tick_duration = info->tick_hr;
     capture->clock_step_index = info->step_idx_abs;
     capture->clock_track_step = (size_t)(info->step_idx_abs % SEQ_MODEL_STEPS_PER_TRACK);
     capture->clock_valid = true;
 }
 
+
 bool seq_live_capture_plan_event(seq_live_capture_t *capture,
                                  const seq_live_capture_input_t *input,
                                  seq_live_capture_plan_t *out_plan) {
@@ -110,9 +113,10 @@ bool seq_live_capture_plan_event(seq_live_capture_t *capture,
     }
     capture->quantize = active_quantize;
 
-    int64_t base_time = (int64_t)capture->clock_step_time;
+    // Times are relative to the latest step boundary: wrap-safe on the 32-bit µs base.
+    int64_t base_time = 0;
     int64_t step_duration = (int64_t)capture->clock_step_duration;
-    int64_t delta_time = (int64_t)input->timestamp - base_time;
+    int64_t delta_time = (int64_t)hr_time_diff(capture->clock_step_time, input->timestamp);
     int64_t base_step = (int64_t)capture->clock_track_step;
 
     if (delta_time < 0) {
@@ -126,7 +130,7 @@ bool seq_live_capture_plan_event(seq_live_capture_t *capture,
     int64_t applied_delta = delta_time;
     bool quantized = false;
     if (active_quantize.enabled && (active_quantize.strength > 0U)) {
-        systime_t grid_duration = 0U;
+        hr_time_t grid_duration = 0U;
         if (_seq_live_capture_compute_grid(capture, active_quantize.grid, &grid_duration) && (grid_duration > 0U)) {
             int64_t grid = (int64_t)grid_duration;
             int64_t rounded = ((delta_time + (grid / 2)) / grid) * grid;
@@ -146,27 +150,23 @@ bool seq_live_capture_plan_event(seq_live_capture_t *capture,
     int8_t micro_offset = _seq_live_capture_micro_from_within(remainder, step_duration);
     int8_t micro_adjust = _seq_live_capture_micro_from_delta(applied_delta - delta_time, step_duration);
 
-    if (scheduled_time < 0) {
-        scheduled_time = 0;
-    }
-
     out_plan->type = input->type;
     out_plan->step_index = wrapped_step;
     out_plan->step_delta = (int32_t)quotient;
     out_plan->voice_index = input->voice_index;
-    out_plan->note = input->note;
+    out_plan->note = _seq_live_capture_scale_note(capture, input->note);
     out_plan->velocity = input->velocity;
     out_plan->micro_offset = micro_offset;
     out_plan->micro_adjust = micro_adjust;
     out_plan->quantized = quantized;
     out_plan->input_time = input->timestamp;
-    out_plan->scheduled_time = (systime_t)scheduled_time;
+    out_plan->scheduled_time = (hr_time_t)(capture->clock_step_time + (hr_time_t)scheduled_time);
 
     return true;
 }
 
-bool seq_live_capture_commit_plan(seq_live_capture_t *capture,
-                                  const seq_live_capture_plan_t *plan) {
+static bool _seq_live_capture_commit_locked(seq_live_capture_t *capture,
+                                            const seq_live_capture_plan_t *plan) {
     if ((capture == NULL) || (plan == NULL) || (capture->track == NULL)) {
         return false;
     }
@@ -215,10 +215,10 @@ bool seq_live_capture_commit_plan(seq_live_capture_t *capture,
             seq_model_voice_init(&voice, slot == 0U);
         }
 
-        const systime_t start_time_raw = capture->voices[slot].active ?
+        const hr_time_t start_time_raw = capture->voices[slot].active ?
                                           capture->voices[slot].start_time_raw : plan->input_time;
-        const systime_t end_time_raw = plan->input_time;
-        const systime_t start_step_duration = capture->voices[slot].active ?
+        const hr_time_t end_time_raw = plan->input_time;
+        const hr_time_t start_step_duration = capture->voices[slot].active ?
                                               capture->voices[slot].step_duration : capture->clock_step_duration;
         const uint8_t length_steps = _seq_live_capture_compute_length_steps(capture,
                                                                             start_time_raw,
@@ -237,6 +237,7 @@ bool seq_live_capture_commit_plan(seq_live_capture_t *capture,
         }
 
         (void)_seq_live_capture_upsert_internal_plock(step,
+                                                      &capture->track->plocks,
                                                       SEQ_MODEL_PLOCK_PARAM_LENGTH,
                                                       slot,
                                                       length_steps);
@@ -280,12 +281,15 @@ bool seq_live_capture_commit_plan(seq_live_capture_t *capture,
         return false;
     }
 
-    (void)_seq_live_capture_upsert_internal_plock(step, SEQ_MODEL_PLOCK_PARAM_NOTE, slot, voice.note);
+    (void)_seq_live_capture_upsert_internal_plock(step, &capture->track->plocks,
+                                                  SEQ_MODEL_PLOCK_PARAM_NOTE, slot, voice.note);
     (void)_seq_live_capture_upsert_internal_plock(step,
+                                                  &capture->track->plocks,
                                                   SEQ_MODEL_PLOCK_PARAM_VELOCITY,
                                                   slot,
                                                   voice.velocity);
     (void)_seq_live_capture_upsert_internal_plock(step,
+                                                  &capture->track->plocks,
                                                   SEQ_MODEL_PLOCK_PARAM_MICRO,
                                                   slot,
                                                   voice.micro_offset);
@@ -302,6 +306,19 @@ bool seq_live_capture_commit_plan(seq_live_capture_t *capture,
     return true;
 }
 
+bool seq_live_capture_commit_plan(seq_live_capture_t *capture,
+                                  const seq_live_capture_plan_t *plan) {
+    if ((capture == NULL) || (capture->track == NULL)) {
+        return false;
+    }
+
+    // The runner reads the track lock-free: bracket the edit in a seqlock section.
+    seq_model_gen_write_begin(&capture->track->generation);
+    const bool committed = _seq_live_capture_commit_locked(capture, plan);
+    seq_model_gen_write_end(&capture->track->generation);
+    return committed;
+}
+
 static void _seq_live_capture_reset_context(seq_live_capture_t *capture) {
     memset(capture, 0, sizeof(*capture));
     capture->quantize.enabled = false;
@@ -320,7 +337,7 @@ static void _seq_live_capture_bind_track(seq_live_capture_t *capture, seq_model_
 
 static bool _seq_live_capture_compute_grid(const seq_live_capture_t *capture,
                                            seq_model_quantize_grid_t grid,
-                                           systime_t *out_duration) {
+                                           hr_time_t *out_duration) {
     if ((capture == NULL) || (out_duration == NULL)) {
         return false;
     }
@@ -366,7 +383,7 @@ static bool _seq_live_capture_compute_grid(const seq_live_capture_t *capture,
         return false;
     }
 
-    *out_duration = (systime_t)scaled;
+    *out_duration = (hr_time_t)scaled;
     return true;
 }
 
@@ -483,25 +500,30 @@ static void _seq_live_capture_clear_voice_trackers(seq_live_capture_t *capture)
 }
 
 static bool _seq_live_capture_upsert_internal_plock(seq_model_step_t *step,
+                                                    seq_model_plock_pool_t *pool,
                                                     seq_model_plock_internal_param_t param,
                                                     uint8_t voice,
                                                     int32_t value) {
-    if (step == NULL) {
+    if ((step == NULL) || (pool == NULL)) {
         return false;
     }
 
     const int16_t casted = (int16_t)value;
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        seq_model_plock_t *plk = &step->plocks[i];
-        if ((plk->domain == SEQ_MODEL_PLOCK_INTERNAL) &&
-            (plk->internal_param == param) &&
-            (plk->voice_index == voice)) {
-            if (plk->value != casted) {
-                plk->value = casted;
-                return true;
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    size_t index = 0U;
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if ((plk.domain == SEQ_MODEL_PLOCK_INTERNAL) &&
+            (plk.internal_param == param) &&
+            (plk.voice_index == voice)) {
+            if (plk.value != casted) {
+                plk.value = casted;
+                return seq_model_step_set_plock(step, pool, index, &plk);
             }
             return false;
         }
+        ++index;
     }
 
     if (step->plock_count >= SEQ_MODEL_MAX_PLOCKS_PER_STEP) {
@@ -516,19 +538,19 @@ static bool _seq_live_capture_upsert_internal_plock(seq_model_step_t *step,
         .internal_param = param,
     };
 
-    return seq_model_step_add_plock(step, &plock);
+    return seq_model_step_add_plock(step, pool, &plock);
 }
 
 static uint8_t _seq_live_capture_compute_length_steps(const seq_live_capture_t *capture,
-                                                      systime_t start_time,
-                                                      systime_t end_time,
-                                                      systime_t step_duration_snapshot) {
+                                                      hr_time_t start_time,
+                                                      hr_time_t end_time,
+                                                      hr_time_t step_duration_snapshot) {
     (void)capture;
     if (step_duration_snapshot == 0U) {
         return 1U;
     }
 
-    int64_t delta = (int64_t)end_time - (int64_t)start_time;
+    int64_t delta = (int64_t)hr_time_diff(start_time, end_time);
     if (delta <= 0) {
         return 1U;
     }
@@ -543,3 +565,22 @@ static uint8_t _seq_live_capture_compute_length_steps(const seq_live_capture_t *
 
     return (uint8_t)length;
 }
+
+/* Snap the captured note to the track scale as it will sound: the Reader
+   quantises after the global transpose, so the note is mapped in that domain
+   and shifted back. Chromatic/disabled scales leave it untouched. */
+static uint8_t _seq_live_capture_scale_note(seq_live_capture_t *capture, uint8_t note) {
+    const seq_model_scale_config_t *scale = &capture->track->config.scale;
+    const uint16_t mask = seq_scale_config_mask(scale);
+    if (mask == SEQ_SCALE_MASK_CHROMATIC) {
+        return note;
+    }
+
+    const int32_t transpose = (int32_t)capture->track->config.transpose.global;
+    int32_t sounding = (int32_t)note + transpose;
+    sounding = (sounding < 0) ? 0 : ((sounding > 127) ? 127 : sounding);
+    const uint8_t *map = seq_scale_lut_prepare(&capture->scale, mask, scale->root);
+    int32_t stored = (int32_t)map[sounding] - transpose;
+    stored = (stored < 0) ? 0 : ((stored > 127) ? 127 : stored);
+    return (uint8_t)stored;
+}
@@ -4,6 +4,9 @@
 /**
  * @file seq_live_capture.h
  * @brief Live capture façade bridging UI events to the sequencer model.
+ *
+ * Timestamps and durations use the microsecond base (`hr_time.h`) so that
+ * captured micro-timing is not rounded to the 100 µs system tick.
  */
 
 #include <stdbool.h>
@@ -13,7 +16,9 @@
 #include "ch.h"
 
 #include "clock_manager.h"
+#include "hr_time.h"
 #include "seq_model.h"
+#include "seq_scale.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,7 +47,7 @@ typedef struct {
     uint8_t note;                       /**< MIDI note number. */
     uint8_t velocity;                   /**< MIDI velocity (0-127). */
     uint8_t voice_index;                /**< Suggested voice slot. */
-    systime_t timestamp;                /**< Absolute timestamp of the event. */
+    hr_time_t timestamp;                /**< Absolute timestamp of the event (µs). */
 } seq_live_capture_input_t;
 
 /**
@@ -58,8 +63,8 @@ typedef struct {
     int8_t micro_offset;                /**< Planned micro-timing offset (-12..+12). */
     int8_t micro_adjust;                /**< Quantize correction compared to raw input. */
     bool quantized;                     /**< True if quantize altered the timing. */
-    systime_t input_time;               /**< Raw timestamp of the incoming event. */
-    systime_t scheduled_time;           /**< Timestamp at which the event should play. */
+    hr_time_t input_time;               /**< Raw timestamp of the incoming event (µs). */
+    hr_time_t scheduled_time;           /**< Timestamp at which the event should play (µs). */
 } seq_live_capture_plan_t;
 
 /**
@@ -68,19 +73,20 @@ typedef struct {
 typedef struct {
     seq_model_track_t *track;              /**< Active track reference. */
     seq_model_quantize_config_t quantize;    /**< Cached quantize configuration. */
+    seq_scale_lut_t scale;                   /**< Note map of the track scale (rebuilt on change). */
     bool recording;                          /**< Recording flag. */
     bool clock_valid;                        /**< True once clock data has been provided. */
-    systime_t clock_step_time;               /**< Timestamp of the latest 1/16 step boundary. */
-    systime_t clock_step_duration;           /**< Duration of a 1/16 step. */
-    systime_t clock_tick_duration;           /**< Duration of a single MIDI tick. */
+    hr_time_t clock_step_time;               /**< Timestamp of the latest 1/16 step boundary (µs). */
+    hr_time_t clock_step_duration;           /**< Duration of a 1/16 step (µs). */
+    hr_time_t clock_tick_duration;           /**< Duration of a single MIDI tick (µs). */
     uint32_t clock_step_index;               /**< Absolute step index (monotonic). */
     size_t clock_track_step;               /**< Step index within the track. */
     struct {
         bool active;                         /**< True when a note-on has been captured. */
         size_t step_index;                   /**< Step index that received the note-on. */
-        systime_t start_time;                /**< Scheduled playback time of the note-on. */
-        systime_t start_time_raw;            /**< Raw timestamp captured at note-on. */
-        systime_t step_duration;             /**< Step duration snapshot for the note. */
+        hr_time_t start_time;                /**< Scheduled playback time of the note-on (µs). */
+        hr_time_t start_time_raw;            /**< Raw timestamp captured at note-on (µs). */
+        hr_time_t step_duration;             /**< Step duration snapshot for the note (µs). */
         uint8_t voice_slot;                  /**< Voice slot used to store the note. */
         uint8_t note;                        /**< MIDI note tied to the slot. */
     } voices[SEQ_MODEL_VOICES_PER_STEP];
@@ -96,7 +102,7 @@ void seq_live_capture_override_quantize(seq_live_capture_t *capture, const seq_m
 void seq_live_capture_set_recording(seq_live_capture_t *capture, bool enabled);
 /** Check whether live capture recording is enabled. */
 bool seq_live_capture_is_recording(const seq_live_capture_t *capture);
-/** Refresh the timing reference from the latest clock step. */
+/** Refresh the timing reference from the latest clock step (µs fields of @p info). */
 void seq_live_capture_update_clock(seq_live_capture_t *capture, const clock_step_info_t *info);
 /** Plan an event using the current quantize/timing state. */
 bool seq_live_capture_plan_event(seq_live_capture_t *capture,
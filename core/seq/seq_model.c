@@ -7,9 +7,116 @@
 
 #include <string.h>
 
+#define SEQ_MODEL_PLOCK_KEY_INTERNAL    0x8000U
+#define SEQ_MODEL_PLOCK_KEY_VOICE_SHIFT 8U
+#define SEQ_MODEL_PLOCK_KEY_CART_SHIFT  13U
+#define SEQ_MODEL_PLOCK_KEY_CART_SLIDE  0x1000U
+
+_Static_assert(SEQ_MODEL_TRACK_PLOCK_CAPACITY < SEQ_MODEL_PLOCK_NIL, "p-lock arena too large for 16-bit links");
+
 static void seq_model_step_reset_offsets(seq_model_step_offsets_t *offsets);
 static void seq_model_track_reset_config(seq_model_track_config_t *config);
 
+/* Scratch arena used by seq_model_track_compact_plocks() (UI/save context only). */
+static seq_model_plock_rec_t s_compact_records[SEQ_MODEL_TRACK_PLOCK_CAPACITY];
+
+seq_model_plock_drop_stats_t seq_model_plock_drop_stats;
+
+static bool seq_model_plock_pack(const seq_model_plock_t *plock, uint16_t *key) {
+    if (plock->voice_index >= SEQ_MODEL_VOICES_PER_STEP) {
+        return false;
+    }
+
+    if (plock->domain == SEQ_MODEL_PLOCK_INTERNAL) {
+        *key = (uint16_t)(SEQ_MODEL_PLOCK_KEY_INTERNAL |
+                          ((uint16_t)plock->voice_index << SEQ_MODEL_PLOCK_KEY_VOICE_SHIFT) |
+                          (uint16_t)plock->internal_param);
+        return true;
+    }
+
+    if ((plock->domain == SEQ_MODEL_PLOCK_CART) && (plock->parameter_id <= SEQ_MODEL_PLOCK_CART_PARAM_MAX)) {
+        *key = (uint16_t)(((uint16_t)plock->voice_index << SEQ_MODEL_PLOCK_KEY_CART_SHIFT) |
+                          (plock->slide ? SEQ_MODEL_PLOCK_KEY_CART_SLIDE : 0U) |
+                          plock->parameter_id);
+        return true;
+    }
+
+    return false;
+}
+
+static void seq_model_plock_unpack(const seq_model_plock_rec_t *rec, seq_model_plock_t *out) {
+    out->value = rec->value;
+    if ((rec->key & SEQ_MODEL_PLOCK_KEY_INTERNAL) != 0U) {
+        out->domain = SEQ_MODEL_PLOCK_INTERNAL;
+        out->voice_index = (uint8_t)((rec->key >> SEQ_MODEL_PLOCK_KEY_VOICE_SHIFT) & 0x03U);
+        out->internal_param = (uint8_t)(rec->key & 0x00FFU);
+        out->parameter_id = 0U;
+        out->slide = false;
+    } else {
+        out->domain = SEQ_MODEL_PLOCK_CART;
+        out->voice_index = (uint8_t)((rec->key >> SEQ_MODEL_PLOCK_KEY_CART_SHIFT) & 0x03U);
+        out->internal_param = 0U;
+        out->parameter_id = (uint16_t)(rec->key & SEQ_MODEL_PLOCK_CART_PARAM_MAX);
+        out->slide = (rec->key & SEQ_MODEL_PLOCK_KEY_CART_SLIDE) != 0U;
+    }
+}
+
+static void seq_model_step_mark_domain(seq_model_step_t *step, uint16_t key) {
+    if ((key & SEQ_MODEL_PLOCK_KEY_INTERNAL) != 0U) {
+        step->flags.seq_plock = 1U;
+    } else {
+        step->flags.cart_plock = 1U;
+    }
+}
+
+/* Rebuild the cached domain bits after a lock was removed or rewritten. */
+static void seq_model_step_refresh_domains(seq_model_step_t *step, const seq_model_plock_pool_t *pool) {
+    step->flags.seq_plock = 0U;
+    step->flags.cart_plock = 0U;
+
+    uint16_t idx = step->plock_tail;
+    for (uint8_t i = 0U; i < step->plock_count; ++i) {
+        idx = pool->records[idx].next;
+        seq_model_step_mark_domain(step, pool->records[idx].key);
+    }
+}
+
+/* Append a packed record; the caller checks the per-step limit. */
+static bool seq_model_step_append_record(seq_model_step_t *step, seq_model_plock_pool_t *pool,
+                                         int16_t value, uint16_t key) {
+    const uint16_t idx = pool->free_head;
+    if (idx == SEQ_MODEL_PLOCK_NIL) {
+        return false;
+    }
+
+    seq_model_plock_rec_t *rec = &pool->records[idx];
+    pool->free_head = rec->next;
+    ++pool->used;
+
+    rec->value = value;
+    rec->key = key;
+    if (step->plock_tail == SEQ_MODEL_PLOCK_NIL) {
+        rec->next = idx;
+    } else {
+        rec->next = pool->records[step->plock_tail].next;
+        pool->records[step->plock_tail].next = idx;
+    }
+    step->plock_tail = idx;
+    ++step->plock_count;
+    seq_model_step_mark_domain(step, key);
+    return true;
+}
+
+/* Record preceding the lock at @p index (the tail precedes the head). */
+static uint16_t seq_model_step_plock_before(const seq_model_step_t *step, const seq_model_plock_pool_t *pool,
+                                            size_t index) {
+    uint16_t idx = step->plock_tail;
+    for (size_t i = 0U; i < index; ++i) {
+        idx = pool->records[idx].next;
+    }
+    return idx;
+}
+
 void seq_model_gen_reset(seq_model_gen_t *gen) {
     if (gen == NULL) {
         return;
@@ -23,7 +130,42 @@ void seq_model_gen_bump(seq_model_gen_t *gen) {
         return;
     }
 
-    ++gen->value;
+    /* Even-preserving: a bump is an empty write section. */
+    __atomic_store_n(&gen->value, gen->value + 2U, __ATOMIC_RELEASE);
+}
+
+void seq_model_gen_write_begin(seq_model_gen_t *gen) {
+    if (gen == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&gen->value, gen->value + 1U, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void seq_model_gen_write_end(seq_model_gen_t *gen) {
+    if (gen == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&gen->value, gen->value + 1U, __ATOMIC_RELEASE);
+}
+
+uint32_t seq_model_gen_read_begin(const seq_model_gen_t *gen) {
+    if (gen == NULL) {
+        return 0U;
+    }
+
+    return __atomic_load_n(&gen->value, __ATOMIC_ACQUIRE);
+}
+
+bool seq_model_gen_read_retry(const seq_model_gen_t *gen, uint32_t start) {
+    if (gen == NULL) {
+        return false;
+    }
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return ((start & 1U) != 0U) || (__atomic_load_n(&gen->value, __ATOMIC_RELAXED) != start);
 }
 
 bool seq_model_gen_has_changed(const seq_model_gen_t *lhs, const seq_model_gen_t *rhs) {
@@ -82,6 +224,7 @@ void seq_model_track_init(seq_model_track_t *track) {
         return;
     }
 
+    seq_model_plock_pool_init(&track->plocks);
     for (i = 0U; i < SEQ_MODEL_STEPS_PER_TRACK; ++i) {
         seq_model_step_init(&track->steps[i]);
     }
@@ -90,6 +233,64 @@ void seq_model_track_init(seq_model_track_t *track) {
     seq_model_track_reset_config(&track->config);
 }
 
+void seq_model_track_compact_plocks(seq_model_track_t *track) {
+    if (track == NULL) {
+        return;
+    }
+
+    seq_model_plock_pool_t *pool = &track->plocks;
+    uint16_t used = 0U;
+
+    for (size_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+        seq_model_step_t *step = &track->steps[s];
+        if (step->plock_count == 0U) {
+            step->plock_tail = SEQ_MODEL_PLOCK_NIL;
+            continue;
+        }
+
+        const uint16_t first = used;
+        uint16_t idx = step->plock_tail;
+        for (uint8_t i = 0U; i < step->plock_count; ++i) {
+            idx = pool->records[idx].next;
+            s_compact_records[used] = pool->records[idx];
+            s_compact_records[used].next = (uint16_t)(used + 1U);
+            ++used;
+        }
+        s_compact_records[used - 1U].next = first;
+        step->plock_tail = (uint16_t)(used - 1U);
+    }
+
+    memcpy(pool->records, s_compact_records, (size_t)used * sizeof(seq_model_plock_rec_t));
+    for (uint16_t i = used; i < SEQ_MODEL_TRACK_PLOCK_CAPACITY; ++i) {
+        pool->records[i].next = ((uint16_t)(i + 1U) < SEQ_MODEL_TRACK_PLOCK_CAPACITY) ? (uint16_t)(i + 1U)
+                                                                                      : SEQ_MODEL_PLOCK_NIL;
+    }
+    pool->free_head = (used < SEQ_MODEL_TRACK_PLOCK_CAPACITY) ? used : SEQ_MODEL_PLOCK_NIL;
+    pool->used = used;
+}
+
+void seq_model_plock_pool_init(seq_model_plock_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    memset(pool->records, 0, sizeof(pool->records));
+    for (uint16_t i = 0U; i < SEQ_MODEL_TRACK_PLOCK_CAPACITY; ++i) {
+        pool->records[i].next = ((uint16_t)(i + 1U) < SEQ_MODEL_TRACK_PLOCK_CAPACITY) ? (uint16_t)(i + 1U)
+                                                                                      : SEQ_MODEL_PLOCK_NIL;
+    }
+    pool->free_head = 0U;
+    pool->used = 0U;
+}
+
+uint16_t seq_model_plock_pool_available(const seq_model_plock_pool_t *pool) {
+    if (pool == NULL) {
+        return 0U;
+    }
+
+    return (uint16_t)(SEQ_MODEL_TRACK_PLOCK_CAPACITY - pool->used);
+}
+
 const seq_model_voice_t *seq_model_step_get_voice(const seq_model_step_t *step, size_t voice_index) {
     if ((step == NULL) || (voice_index >= SEQ_MODEL_VOICES_PER_STEP)) {
         return NULL;
@@ -108,55 +309,172 @@ bool seq_model_step_set_voice(seq_model_step_t *step, size_t voice_index, const
     return true;
 }
 
-bool seq_model_step_add_plock(seq_model_step_t *step, const seq_model_plock_t *plock) {
-    if ((step == NULL) || (plock == NULL)) {
+bool seq_model_step_add_plock(seq_model_step_t *step, seq_model_plock_pool_t *pool, const seq_model_plock_t *plock) {
+    uint16_t key = 0U;
+
+    if ((step == NULL) || (pool == NULL) || (plock == NULL)) {
         return false;
     }
 
     if (step->plock_count >= SEQ_MODEL_MAX_PLOCKS_PER_STEP) {
+        seq_model_plock_drop_stats.step_full++;
         return false;
     }
 
-    if (plock->voice_index >= SEQ_MODEL_VOICES_PER_STEP) {
+    if (!seq_model_plock_pack(plock, &key)) {
         return false;
     }
 
-    step->plocks[step->plock_count] = *plock;
-    ++step->plock_count;
+    if (!seq_model_step_append_record(step, pool, plock->value, key)) {
+        seq_model_plock_drop_stats.arena_full++;
+        return false;
+    }
     seq_model_step_recompute_flags(step);
     return true;
 }
 
-void seq_model_step_clear_plocks(seq_model_step_t *step) {
-    if (step == NULL) {
+uint32_t seq_model_plock_drop_total(void) {
+    return seq_model_plock_drop_stats.step_full + seq_model_plock_drop_stats.arena_full;
+}
+
+void seq_model_step_clear_plocks(seq_model_step_t *step, seq_model_plock_pool_t *pool) {
+    if ((step == NULL) || (pool == NULL)) {
         return;
     }
 
-    memset(step->plocks, 0, sizeof(step->plocks));
+    if (step->plock_count > 0U) {
+        /* Splice the whole circular chain onto the free list. */
+        const uint16_t head = pool->records[step->plock_tail].next;
+        pool->records[step->plock_tail].next = pool->free_head;
+        pool->free_head = head;
+        pool->used = (uint16_t)(pool->used - step->plock_count);
+    }
+    step->plock_tail = SEQ_MODEL_PLOCK_NIL;
     step->plock_count = 0U;
+    step->flags.seq_plock = 0U;
+    step->flags.cart_plock = 0U;
     seq_model_step_recompute_flags(step);
 }
 
-bool seq_model_step_remove_plock(seq_model_step_t *step, size_t index) {
-    if ((step == NULL) || (index >= step->plock_count)) {
+bool seq_model_step_remove_plock(seq_model_step_t *step, seq_model_plock_pool_t *pool, size_t index) {
+    if ((step == NULL) || (pool == NULL) || (index >= step->plock_count)) {
         return false;
     }
 
-    for (size_t i = index; i + 1U < step->plock_count; ++i) {
-        step->plocks[i] = step->plocks[i + 1U];
+    const uint16_t prev = seq_model_step_plock_before(step, pool, index);
+    const uint16_t victim = pool->records[prev].next;
+    if (step->plock_count == 1U) {
+        step->plock_tail = SEQ_MODEL_PLOCK_NIL;
+    } else {
+        pool->records[prev].next = pool->records[victim].next;
+        if (victim == step->plock_tail) {
+            step->plock_tail = prev;
+        }
     }
-    memset(&step->plocks[step->plock_count - 1U], 0, sizeof(seq_model_plock_t));
+
+    pool->records[victim].next = pool->free_head;
+    pool->free_head = victim;
+    --pool->used;
     --step->plock_count;
+    seq_model_step_refresh_domains(step, pool);
     seq_model_step_recompute_flags(step);
     return true;
 }
 
-bool seq_model_step_get_plock(const seq_model_step_t *step, size_t index, seq_model_plock_t *out) {
-    if ((step == NULL) || (index >= step->plock_count) || (out == NULL)) {
+bool seq_model_step_get_plock(const seq_model_step_t *step, const seq_model_plock_pool_t *pool,
+                              size_t index, seq_model_plock_t *out) {
+    if ((step == NULL) || (pool == NULL) || (index >= step->plock_count) || (out == NULL)) {
+        return false;
+    }
+
+    const uint16_t prev = seq_model_step_plock_before(step, pool, index);
+    seq_model_plock_unpack(&pool->records[pool->records[prev].next], out);
+    return true;
+}
+
+bool seq_model_step_set_plock(seq_model_step_t *step, seq_model_plock_pool_t *pool,
+                              size_t index, const seq_model_plock_t *plock) {
+    uint16_t key = 0U;
+
+    if ((step == NULL) || (pool == NULL) || (plock == NULL) || (index >= step->plock_count)) {
         return false;
     }
 
-    *out = step->plocks[index];
+    if (!seq_model_plock_pack(plock, &key)) {
+        return false;
+    }
+
+    seq_model_plock_rec_t *rec = &pool->records[pool->records[seq_model_step_plock_before(step, pool, index)].next];
+    const bool same_key = (rec->key == key);
+    rec->value = plock->value;
+    rec->key = key;
+    if (!same_key) {
+        seq_model_step_refresh_domains(step, pool);
+        seq_model_step_recompute_flags(step);
+    }
+    return true;
+}
+
+bool seq_model_step_copy(seq_model_step_t *dst, seq_model_plock_pool_t *dst_pool,
+                         const seq_model_step_t *src, const seq_model_plock_pool_t *src_pool) {
+    if ((dst == NULL) || (dst_pool == NULL) || (src == NULL) || (src_pool == NULL)) {
+        return false;
+    }
+    if (dst == src) {
+        return true;
+    }
+
+    /* The records of dst are released before the copy is allocated. */
+    const uint16_t room = (uint16_t)(seq_model_plock_pool_available(dst_pool) + dst->plock_count);
+    if (room < src->plock_count) {
+        return false;
+    }
+
+    seq_model_step_clear_plocks(dst, dst_pool);
+    *dst = *src;
+    dst->plock_tail = SEQ_MODEL_PLOCK_NIL;
+    dst->plock_count = 0U;
+    dst->flags.seq_plock = 0U;
+    dst->flags.cart_plock = 0U;
+
+    uint16_t idx = src->plock_tail;
+    for (uint8_t i = 0U; i < src->plock_count; ++i) {
+        idx = src_pool->records[idx].next;
+        (void)seq_model_step_append_record(dst, dst_pool, src_pool->records[idx].value, src_pool->records[idx].key);
+    }
+    seq_model_step_recompute_flags(dst);
+    return true;
+}
+
+void seq_model_step_plock_iter(const seq_model_step_t *step, const seq_model_plock_pool_t *pool,
+                               seq_model_plock_iter_t *it) {
+    if (it == NULL) {
+        return;
+    }
+
+    it->pool = pool;
+    it->next = SEQ_MODEL_PLOCK_NIL;
+    it->remaining = 0U;
+    if ((step == NULL) || (pool == NULL) || (step->plock_count == 0U) ||
+        (step->plock_tail >= SEQ_MODEL_TRACK_PLOCK_CAPACITY)) {
+        return;
+    }
+
+    it->next = pool->records[step->plock_tail].next;
+    it->remaining = step->plock_count;
+}
+
+bool seq_model_plock_iter_next(seq_model_plock_iter_t *it, seq_model_plock_t *out) {
+    if ((it == NULL) || (it->remaining == 0U) || (it->next >= SEQ_MODEL_TRACK_PLOCK_CAPACITY)) {
+        return false;
+    }
+
+    const seq_model_plock_rec_t *rec = &it->pool->records[it->next];
+    if (out != NULL) {
+        seq_model_plock_unpack(rec, out);
+    }
+    it->next = rec->next;
+    --it->remaining;
     return true;
 }
 
@@ -205,14 +523,7 @@ bool seq_model_step_has_seq_plock(const seq_model_step_t *step) {
         return false;
     }
 
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        const seq_model_plock_t *plk = &step->plocks[i];
-        if (plk->domain == SEQ_MODEL_PLOCK_INTERNAL) {
-            return true;
-        }
-    }
-
-    return false;
+    return step->flags.seq_plock;
 }
 
 bool seq_model_step_has_cart_plock(const seq_model_step_t *step) {
@@ -220,14 +531,7 @@ bool seq_model_step_has_cart_plock(const seq_model_step_t *step) {
         return false;
     }
 
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        const seq_model_plock_t *plk = &step->plocks[i];
-        if (plk->domain == SEQ_MODEL_PLOCK_CART) {
-            return true;
-        }
-    }
-
-    return false;
+    return step->flags.cart_plock;
 }
 
 void seq_model_step_make_automation_only(seq_model_step_t *step) {
@@ -21,14 +21,34 @@ extern "C" {
 /** Maximum number of parameter locks attached to a step. */
 #define SEQ_MODEL_MAX_PLOCKS_PER_STEP 24U
 
+/**
+ * Parameter lock records available to one track, shared by its steps.
+ * Sized so that SEQ_RUNTIME_TRACK_CAPACITY resident tracks stay within
+ * SEQ_RUNTIME_HOT_BUDGET_MAX (checked by seq_runtime_hot_budget.c).
+ */
+#ifndef SEQ_MODEL_TRACK_PLOCK_CAPACITY
+#define SEQ_MODEL_TRACK_PLOCK_CAPACITY 112U
+#endif
+
+/** Null link inside a parameter lock arena. */
+#define SEQ_MODEL_PLOCK_NIL 0xFFFFU
+
+/** Largest cartridge parameter id a packed parameter lock can address. */
+#define SEQ_MODEL_PLOCK_CART_PARAM_MAX 0x0FFFU
+
 /** Default velocity applied to the first voice when arming a step. */
 #define SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY   100U
 /** Default velocity applied to secondary voices when arming a step. */
 #define SEQ_MODEL_DEFAULT_VELOCITY_SECONDARY 0U
 
-/** Sequencer generation counter used for dirty tracking. */
+/**
+ * Sequencer generation counter used for dirty tracking.
+ *
+ * Doubles as the track seqlock: the value is even while the track is stable
+ * and odd while a writer is inside seq_model_gen_write_begin()/end().
+ */
 typedef struct {
-    uint32_t value; /**< Monotonic counter incremented on every mutation. */
+    uint32_t value; /**< Monotonic counter advanced on every mutation. */
 } seq_model_gen_t;
 
 /** Voice enablement state. */
@@ -85,8 +105,42 @@ typedef struct {
     seq_model_plock_domain_t domain; /**< Target domain. */
     uint8_t voice_index;             /**< Voice affected (0-3). */
     seq_model_plock_internal_param_t internal_param; /**< Internal parameter id. */
+    bool slide;                      /**< Cart locks: ramp to the value over the step. */
 } seq_model_plock_t;
 
+/**
+ * Compact parameter lock record stored in a track arena.
+ *
+ * The target is packed into @ref key: internal locks use
+ * 0x8000 | voice << 8 | internal_param, cartridge locks use
+ * voice << 13 | slide << 12 | parameter_id.
+ */
+typedef struct {
+    int16_t value;  /**< Value payload. */
+    uint16_t key;   /**< Packed target. */
+    uint16_t next;  /**< Next record of the owning step (circular) or of the free list. */
+} seq_model_plock_rec_t;
+
+/**
+ * Fixed pool of parameter lock records.
+ *
+ * Each step owns a circular chain of records (the step keeps the tail, the
+ * tail links to the head), so appending, clearing a step and unlinking a
+ * record are O(1); free records form a singly linked list.
+ */
+typedef struct {
+    seq_model_plock_rec_t records[SEQ_MODEL_TRACK_PLOCK_CAPACITY]; /**< Record storage. */
+    uint16_t free_head; /**< First free record (SEQ_MODEL_PLOCK_NIL when exhausted). */
+    uint16_t used;      /**< Records currently linked to a step. */
+} seq_model_plock_pool_t;
+
+/** Cursor walking the parameter locks of a step in insertion order. */
+typedef struct {
+    const seq_model_plock_pool_t *pool; /**< Arena holding the records. */
+    uint16_t next;                      /**< Next record to visit. */
+    uint8_t remaining;                  /**< Records left to visit. */
+} seq_model_plock_iter_t;
+
 /** Per-voice information stored for each step. */
 typedef struct {
     uint8_t note;                  /**< MIDI note number (0-127). */
@@ -98,7 +152,7 @@ typedef struct {
 
 /** Aggregate offsets applied to all voices on a step. */
 typedef struct {
-    int16_t velocity;  /**< Velocity offset (-127..+127). */
+    int8_t velocity;   /**< Velocity offset (-127..+127). */
     int8_t transpose;  /**< Semitone transpose (-12..+12). */
     int8_t length;     /**< Length offset (-32..+32). */
     int8_t micro;      /**< Micro-timing offset (-12..+12). */
@@ -108,15 +162,21 @@ typedef struct {
 typedef struct {
     uint8_t active : 1;     /**< True when at least one voice has velocity > 0. */
     uint8_t automation : 1; /**< True when the step is automation-only (no playable voices, has p-locks). */
-    uint8_t reserved : 6;   /**< Reserved for future use. */
+    uint8_t seq_plock : 1;  /**< True when at least one p-lock targets the sequencer domain. */
+    uint8_t cart_plock : 1; /**< True when at least one p-lock targets the cartridge domain. */
+    uint8_t reserved : 4;   /**< Reserved for future use. */
 } seq_model_step_flags_t;
 
+/**
+ * Step description. Parameter locks live in the owning track arena
+ * (seq_model_track_t::plocks); the step only keeps the tail of its chain.
+ */
 typedef struct {
     seq_model_voice_t voices[SEQ_MODEL_VOICES_PER_STEP]; /**< Voice data. */
-    seq_model_plock_t plocks[SEQ_MODEL_MAX_PLOCKS_PER_STEP]; /**< Parameter locks. */
-    uint8_t plock_count; /**< Number of active parameter locks. */
     seq_model_step_offsets_t offsets; /**< Per-step offsets. */
-    seq_model_step_flags_t flags; /**< Cached step flags (playable / automation). */
+    uint16_t plock_tail; /**< Last parameter lock record (SEQ_MODEL_PLOCK_NIL when none). */
+    uint8_t plock_count; /**< Number of active parameter locks. */
+    seq_model_step_flags_t flags; /**< Cached step flags (playable / automation / p-lock domains). */
 } seq_model_step_t;
 
 /** Quantization configuration applied during live capture. */
@@ -153,18 +213,30 @@ struct seq_model_track {
     seq_model_step_t steps[SEQ_MODEL_STEPS_PER_TRACK]; /**< Step list. */
     seq_model_track_config_t config; /**< Track-level configuration. */
     seq_model_gen_t generation; /**< Dirty tracking counter. */
+    seq_model_plock_pool_t plocks; /**< Parameter lock arena shared by the steps. */
 };
 
 /** Reset the generation counter to its initial value. */
 void seq_model_gen_reset(seq_model_gen_t *gen);
-/** Increment the generation counter after a mutation. */
+/** Advance the generation counter after a mutation (keeps it even). */
 void seq_model_gen_bump(seq_model_gen_t *gen);
+/** Open a write section: readers started before or during it will retry. */
+void seq_model_gen_write_begin(seq_model_gen_t *gen);
+/** Close the write section opened by seq_model_gen_write_begin(). */
+void seq_model_gen_write_end(seq_model_gen_t *gen);
+/** Start a lock-free read; an odd result means a writer is active. */
+uint32_t seq_model_gen_read_begin(const seq_model_gen_t *gen);
+/** True if the data read since @p start may be torn and must be discarded. */
+bool seq_model_gen_read_retry(const seq_model_gen_t *gen, uint32_t start);
 /** Check whether two generation counters differ. */
 bool seq_model_gen_has_changed(const seq_model_gen_t *lhs, const seq_model_gen_t *rhs);
 
 /** Initialise a voice with Elektron-like defaults. */
 void seq_model_voice_init(seq_model_voice_t *voice, bool primary);
-/** Clear a step and restore default voices/offsets. */
+/**
+ * Clear a step and restore default voices/offsets.
+ * Parameter locks are detached, not released: clear them first on a step that owns records.
+ */
 void seq_model_step_init(seq_model_step_t *step);
 /** Initialise a step using Elektron quick-step defaults for the provided note. */
 void seq_model_step_init_default(seq_model_step_t *step, uint8_t note);
@@ -172,22 +244,64 @@ void seq_model_step_init_default(seq_model_step_t *step, uint8_t note);
 void seq_model_step_make_neutral(seq_model_step_t *step);
 /** Convert a step into an automation-only placeholder (all voices muted). */
 void seq_model_step_make_automation_only(seq_model_step_t *step);
-/** Reset a full track to defaults. */
+/** Reset a full track to defaults (empties its parameter lock arena). */
 void seq_model_track_init(seq_model_track_t *track);
+/**
+ * Rewrite the parameter lock arena so each step's records are contiguous and
+ * in step order, reclaiming any leaked record. Used before saving.
+ */
+void seq_model_track_compact_plocks(seq_model_track_t *track);
+
+/** Mark every record of an arena as free. */
+void seq_model_plock_pool_init(seq_model_plock_pool_t *pool);
+/** Number of records still available in an arena. */
+uint16_t seq_model_plock_pool_available(const seq_model_plock_pool_t *pool);
 
 /** Retrieve a voice descriptor by index. */
 const seq_model_voice_t *seq_model_step_get_voice(const seq_model_step_t *step, size_t voice_index);
 /** Replace the voice descriptor at the provided index. */
 bool seq_model_step_set_voice(seq_model_step_t *step, size_t voice_index, const seq_model_voice_t *voice);
 
-/** Append a parameter lock to a step. */
-bool seq_model_step_add_plock(seq_model_step_t *step, const seq_model_plock_t *plock);
-/** Remove all parameter locks from a step. */
-void seq_model_step_clear_plocks(seq_model_step_t *step);
+/**
+ * @brief Parameter locks refused by seq_model_step_add_plock() (diagnostic).
+ *
+ * Edits and project loads both append through it, so a lock lost to a full
+ * step or a full track arena is counted here whoever asked for it.
+ */
+typedef struct {
+    uint32_t step_full;  /**< Step already holds SEQ_MODEL_MAX_PLOCKS_PER_STEP locks. */
+    uint32_t arena_full; /**< Track arena has no free record left. */
+} seq_model_plock_drop_stats_t;
+
+extern seq_model_plock_drop_stats_t seq_model_plock_drop_stats;
+
+/** Total of the drop counters (the UI compares it with the last value it saw). */
+uint32_t seq_model_plock_drop_total(void);
+
+/** Append a parameter lock to a step, allocating its record from @p pool. */
+bool seq_model_step_add_plock(seq_model_step_t *step, seq_model_plock_pool_t *pool, const seq_model_plock_t *plock);
+/** Remove all parameter locks from a step and return their records to @p pool. */
+void seq_model_step_clear_plocks(seq_model_step_t *step, seq_model_plock_pool_t *pool);
 /** Remove a parameter lock at the provided index. */
-bool seq_model_step_remove_plock(seq_model_step_t *step, size_t index);
+bool seq_model_step_remove_plock(seq_model_step_t *step, seq_model_plock_pool_t *pool, size_t index);
 /** Retrieve a parameter lock by index. */
-bool seq_model_step_get_plock(const seq_model_step_t *step, size_t index, seq_model_plock_t *out);
+bool seq_model_step_get_plock(const seq_model_step_t *step, const seq_model_plock_pool_t *pool,
+                              size_t index, seq_model_plock_t *out);
+/** Overwrite the parameter lock at the provided index in place. */
+bool seq_model_step_set_plock(seq_model_step_t *step, seq_model_plock_pool_t *pool,
+                              size_t index, const seq_model_plock_t *plock);
+/**
+ * Copy @p src (records in @p src_pool) over @p dst (records in @p dst_pool).
+ * The previous locks of @p dst are released first; fails without touching
+ * @p dst when @p dst_pool cannot hold the copy.
+ */
+bool seq_model_step_copy(seq_model_step_t *dst, seq_model_plock_pool_t *dst_pool,
+                         const seq_model_step_t *src, const seq_model_plock_pool_t *src_pool);
+/** Start walking the parameter locks of a step. */
+void seq_model_step_plock_iter(const seq_model_step_t *step, const seq_model_plock_pool_t *pool,
+                               seq_model_plock_iter_t *it);
+/** Fetch the next parameter lock; returns false once the step is exhausted. */
+bool seq_model_plock_iter_next(seq_model_plock_iter_t *it, seq_model_plock_t *out);
 
 /** Assign the aggregate offsets for a step. */
 void seq_model_step_set_offsets(seq_model_step_t *step, const seq_model_step_offsets_t *offsets);
@@ -204,7 +318,7 @@ bool seq_model_step_has_any_plock(const seq_model_step_t *step);
 bool seq_model_step_has_seq_plock(const seq_model_step_t *step);
 /** Return true when the step exposes at least one cartridge-domain parameter lock. */
 bool seq_model_step_has_cart_plock(const seq_model_step_t *step);
-/** Recompute cached flags after mutating voices or parameter locks. */
+/** Recompute cached voice flags (p-lock domain bits are maintained by the p-lock helpers). */
 void seq_model_step_recompute_flags(seq_model_step_t *step);
 
 /** Flash-resident template used to initialise neutral sequencer steps. */
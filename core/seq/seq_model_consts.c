@@ -36,16 +36,19 @@ const seq_model_step_t k_seq_model_step_default = {
             .state = SEQ_MODEL_VOICE_DISABLED,
         },
     },
-    .plock_count = 0U,
     .offsets = {
         .velocity = 0,
         .transpose = 0,
         .length = 0,
         .micro = 0,
     },
+    .plock_tail = SEQ_MODEL_PLOCK_NIL,
+    .plock_count = 0U,
     .flags = {
         .active = 0,
         .automation = 0,
+        .seq_plock = 0,
+        .cart_plock = 0,
         .reserved = 0,
     },
 };
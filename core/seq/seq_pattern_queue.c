@@ -0,0 +1,193 @@
+/**
+ * @file seq_pattern_queue.c
+ * @brief Queued pattern changes: background prefetch, swap on the pattern boundary.
+ */
+
+#include "core/seq/seq_pattern_queue.h"
+
+#include <string.h>
+
+#include "core/seq/reader/seq_reader.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+
+seq_pattern_queue_stats_t seq_pattern_queue_stats = {0};
+
+/* State shared by the requester (UI), the storage thread and the Reader
+   context. Every transition runs under chSysLock(); decoding does not. */
+static struct {
+    uint32_t  seq;          /* bumped on every request */
+    uint32_t  ready_seq;    /* request decoded in the shadow set, 0 if none */
+    systime_t requested_at;
+    uint8_t   bank;
+    uint8_t   pattern;
+    bool      pending;
+    bool      decoding;
+    bool      swapped;      /* UI notification, cleared by take_swapped() */
+    uint8_t   live_bank;
+    uint8_t   live_pattern;
+    seq_pattern_image_t image;
+} s_queue;
+
+void seq_pattern_queue_init(void) {
+    chSysLock();
+    memset(&s_queue, 0, sizeof(s_queue));
+    chSysUnlock();
+    seq_pattern_queue_stats_reset();
+}
+
+bool seq_pattern_queue_request(uint8_t bank, uint8_t pattern, systime_t now) {
+    if ((bank >= SEQ_PROJECT_BANK_COUNT) || (pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
+        return false;
+    }
+
+    chSysLock();
+    s_queue.seq++;
+    if (s_queue.seq == 0U) {
+        s_queue.seq = 1U;
+    }
+    s_queue.bank = bank;
+    s_queue.pattern = pattern;
+    s_queue.requested_at = now;
+    s_queue.pending = true;
+    seq_pattern_queue_stats.requests++;
+    chSysUnlock();
+    return true;
+}
+
+void seq_pattern_queue_cancel(void) {
+    chSysLock();
+    s_queue.pending = false;
+    chSysUnlock();
+}
+
+bool seq_pattern_queue_pending(uint8_t *bank, uint8_t *pattern) {
+    chSysLock();
+    const bool pending = s_queue.pending;
+    if (bank != NULL) {
+        *bank = s_queue.bank;
+    }
+    if (pattern != NULL) {
+        *pattern = s_queue.pattern;
+    }
+    chSysUnlock();
+    return pending;
+}
+
+bool seq_pattern_queue_service(systime_t now) {
+    chSysLock();
+    if (!s_queue.pending || s_queue.decoding || (s_queue.ready_seq == s_queue.seq)) {
+        chSysUnlock();
+        return false;
+    }
+    const uint32_t seq = s_queue.seq;
+    const uint8_t bank = s_queue.bank;
+    const uint8_t pattern = s_queue.pattern;
+    s_queue.decoding = true;
+    s_queue.ready_seq = 0U; /* the shadow set is about to be overwritten */
+    chSysUnlock();
+
+    seq_model_track_t *targets[SEQ_RUNTIME_TRACK_CAPACITY];
+    for (uint8_t t = 0U; t < SEQ_RUNTIME_TRACK_CAPACITY; ++t) {
+        targets[t] = seq_runtime_shadow_track(t);
+    }
+    const bool ok = seq_pattern_decode(bank, pattern, targets, SEQ_RUNTIME_TRACK_CAPACITY, &s_queue.image);
+    const systime_t elapsed = (systime_t)(chVTGetSystemTimeX() - now);
+
+    chSysLock();
+    s_queue.decoding = false;
+    if (!ok) {
+        seq_pattern_queue_stats.prefetch_failed++;
+        if (s_queue.seq == seq) {
+            s_queue.pending = false; /* unreadable slot: keep playing the current one */
+        }
+    } else {
+        seq_pattern_queue_stats.prefetches++;
+        if (elapsed > seq_pattern_queue_stats.prefetch_max) {
+            seq_pattern_queue_stats.prefetch_max = elapsed;
+        }
+        if (s_queue.seq == seq) {
+            s_queue.ready_seq = seq; /* superseded requests are decoded again */
+        }
+    }
+    chSysUnlock();
+    return true;
+}
+
+uint8_t seq_pattern_queue_prefetch_plans(void) {
+    chSysLock();
+    const bool ready = s_queue.pending && !s_queue.decoding && (s_queue.ready_seq == s_queue.seq);
+    const uint8_t bank = s_queue.bank;
+    const uint8_t pattern = s_queue.pattern;
+    chSysUnlock();
+    if (!ready) {
+        return 0U;
+    }
+
+    /* The storage thread only decodes again after a new request: the shadow
+       set stays put while it is compiled. */
+    const seq_model_track_t *tracks[SEQ_RUNTIME_TRACK_CAPACITY];
+    for (uint8_t t = 0U; t < SEQ_RUNTIME_TRACK_CAPACITY; ++t) {
+        tracks[t] = seq_runtime_shadow_track(t);
+    }
+    return seq_reader_plan_prefetch(bank, pattern, tracks, SEQ_RUNTIME_TRACK_CAPACITY);
+}
+
+bool seq_pattern_queue_flip(systime_t now, uint8_t *bank, uint8_t *pattern) {
+    chSysLock();
+    if (!s_queue.pending) {
+        chSysUnlock();
+        return false;
+    }
+    if (s_queue.decoding || (s_queue.ready_seq != s_queue.seq)) {
+        seq_pattern_queue_stats.prefetch_misses++;
+        chSysUnlock();
+        return false;
+    }
+
+    /* Every binding, the active slot and the project generation move together. */
+    seq_runtime_flip_tracks(s_queue.bank, s_queue.pattern);
+    const seq_pattern_image_t image = s_queue.image;
+    s_queue.pending = false;
+    s_queue.ready_seq = 0U; /* the former live set is the shadow now */
+    s_queue.swapped = true;
+    s_queue.live_bank = s_queue.bank;
+    s_queue.live_pattern = s_queue.pattern;
+
+    const systime_t latency = (systime_t)(now - s_queue.requested_at);
+    seq_pattern_queue_stats.swaps++;
+    seq_pattern_queue_stats.swap_latency_last = latency;
+    if (latency > seq_pattern_queue_stats.swap_latency_max) {
+        seq_pattern_queue_stats.swap_latency_max = latency;
+    }
+    if (bank != NULL) {
+        *bank = s_queue.live_bank;
+    }
+    if (pattern != NULL) {
+        *pattern = s_queue.live_pattern;
+    }
+    chSysUnlock();
+
+    /* Descriptor and cart bindings: metadata only, the Reader does not read them. */
+    seq_pattern_apply_image(&image);
+    return true;
+}
+
+bool seq_pattern_queue_take_swapped(uint8_t *bank, uint8_t *pattern) {
+    chSysLock();
+    const bool swapped = s_queue.swapped;
+    s_queue.swapped = false;
+    if (bank != NULL) {
+        *bank = s_queue.live_bank;
+    }
+    if (pattern != NULL) {
+        *pattern = s_queue.live_pattern;
+    }
+    chSysUnlock();
+    return swapped;
+}
+
+void seq_pattern_queue_stats_reset(void) {
+    memset(&seq_pattern_queue_stats, 0, sizeof(seq_pattern_queue_stats));
+}
@@ -0,0 +1,97 @@
+#ifndef BRICK_CORE_SEQ_SEQ_PATTERN_QUEUE_H_
+#define BRICK_CORE_SEQ_SEQ_PATTERN_QUEUE_H_
+
+/**
+ * @file seq_pattern_queue.h
+ * @brief Queued pattern changes: background prefetch, swap on the pattern boundary.
+ *
+ * A pattern change is queued, never applied in place. The storage thread
+ * decodes the next pattern from flash into a shadow track set while the
+ * current one keeps playing (seq_pattern_queue_service()). The runner calls
+ * seq_pattern_queue_flip() on the pattern boundary: if the shadow set is
+ * ready, the project track bindings are swapped in one critical section and
+ * the former live set becomes the next shadow. If the prefetch is not done
+ * yet, the boundary is counted as a miss and the current pattern loops once
+ * more; nothing is ever half-loaded.
+ *
+ * Only the context that owns the Reader (runner tick, or any thread while the
+ * transport is stopped) may flip.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Queue statistics (diagnostic, same spirit as `seq_scheduler_stats`).
+ */
+typedef struct {
+    uint32_t requests;          /**< Pattern changes queued. */
+    uint32_t prefetches;        /**< Shadow decodes completed. */
+    uint32_t prefetch_failed;   /**< Decodes that failed (request dropped). */
+    uint32_t prefetch_misses;   /**< Boundaries reached before the shadow was ready. */
+    uint32_t swaps;             /**< Pattern flips performed. */
+    systime_t prefetch_max;     /**< Longest decode (system ticks). */
+    systime_t swap_latency_last;/**< Request -> flip delay of the last swap (system ticks). */
+    systime_t swap_latency_max; /**< Longest request -> flip delay (system ticks). */
+} seq_pattern_queue_stats_t;
+
+extern seq_pattern_queue_stats_t seq_pattern_queue_stats;
+
+/** @brief Reset the queue and point its shadow set at the spare tracks. */
+void seq_pattern_queue_init(void);
+
+/**
+ * @brief Queue (bank, pattern) as the next pattern; replaces any pending request.
+ * @return false on an out-of-range slot.
+ */
+bool seq_pattern_queue_request(uint8_t bank, uint8_t pattern, systime_t now);
+
+/** @brief Drop the pending request, if any (the current pattern keeps playing). */
+void seq_pattern_queue_cancel(void);
+
+/** @brief True while a request waits for its flip. */
+bool seq_pattern_queue_pending(uint8_t *bank, uint8_t *pattern);
+
+/**
+ * @brief Decode the pending pattern into the shadow set (storage thread).
+ * @return true if a decode ran.
+ */
+bool seq_pattern_queue_service(systime_t now);
+
+/**
+ * @brief Compile the playback plans of the decoded shadow set (UI thread).
+ *
+ * Lets the runner swap compiled plans in on the flip instead of compiling
+ * them on the clock tick (see seq_reader_plan_prefetch()).
+ * @return Number of plans compiled.
+ */
+uint8_t seq_pattern_queue_prefetch_plans(void);
+
+/**
+ * @brief Swap in the prefetched pattern (pattern boundary, Reader context).
+ *
+ * Counts a prefetch miss when a request is pending but not decoded yet.
+ * @param[out] bank,pattern New live slot when the flip happened (optional).
+ * @return true if the live pattern changed.
+ */
+bool seq_pattern_queue_flip(systime_t now, uint8_t *bank, uint8_t *pattern);
+
+/**
+ * @brief Consume the "pattern swapped" notification for the UI thread.
+ * @param[out] bank,pattern New live slot (optional).
+ */
+bool seq_pattern_queue_take_swapped(uint8_t *bank, uint8_t *pattern);
+
+void seq_pattern_queue_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRICK_CORE_SEQ_SEQ_PATTERN_QUEUE_H_ */
@@ -0,0 +1,528 @@
+/**
+ * @file seq_pattern_store.c
+ * @brief Log-structured, wear-levelled record store implementation.
+ */
+
+#include "seq_pattern_store.h"
+
+#include <string.h>
+
+#define STORE_SECTOR_MAGIC   0x424C4F47U /* 'BLOG' */
+#define STORE_RECORD_MAGIC   0x5245U     /* 'RE' */
+#define STORE_FORMAT_VERSION 1U
+#define STORE_NO_SECTOR      UINT16_MAX
+#define STORE_COPY_CHUNK     64U
+#define STORE_COMMITTED      0x00U
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;       /**< Sector identifier. */
+    uint32_t erase_count; /**< Erase cycles seen by this sector. */
+    uint16_t version;     /**< Store format version. */
+    uint16_t reserved;    /**< Reserved for alignment. */
+    uint32_t reserved2;   /**< Reserved for future use. */
+} store_sector_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;       /**< Record identifier. */
+    uint16_t key;         /**< Pattern index or project header key. */
+    uint32_t seq;         /**< Store-wide sequence number (latest wins). */
+    uint16_t length;      /**< Payload length in bytes. */
+    uint16_t crc;         /**< CRC-16/CCITT over key, seq, length and payload. */
+    uint8_t  commit;      /**< 0xFF while programming, 0x00 once the payload is complete. */
+    uint8_t  reserved[3]; /**< Reserved for alignment. */
+} store_record_header_t;
+
+_Static_assert(sizeof(store_sector_header_t) == SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE,
+               "sector header size mismatch");
+_Static_assert(sizeof(store_record_header_t) == SEQ_PATTERN_STORE_RECORD_HEADER_SIZE,
+               "record header size mismatch");
+_Static_assert(BOARD_FLASH_SECTOR_SIZE <= UINT16_MAX, "sector offsets are 16-bit");
+
+static uint16_t crc16_update(uint16_t crc, const uint8_t *data, size_t length) {
+    for (size_t i = 0U; i < length; ++i) {
+        crc ^= (uint16_t)((uint16_t)data[i] << 8);
+        for (uint8_t b = 0U; b < 8U; ++b) {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t crc16_header(const store_record_header_t *header) {
+    uint16_t crc = 0xFFFFU;
+    crc = crc16_update(crc, (const uint8_t *)&header->key, sizeof(header->key));
+    crc = crc16_update(crc, (const uint8_t *)&header->seq, sizeof(header->seq));
+    return crc16_update(crc, (const uint8_t *)&header->length, sizeof(header->length));
+}
+
+static uint32_t record_size(uint32_t length) {
+    return (SEQ_PATTERN_STORE_RECORD_HEADER_SIZE + length + 3U) & ~3U;
+}
+
+static uint32_t sector_addr(const seq_pattern_store_t *store, uint16_t sector) {
+    return store->base + ((uint32_t)sector * store->sector_size);
+}
+
+static uint16_t sector_of(const seq_pattern_store_t *store, uint32_t addr) {
+    return (uint16_t)((addr - store->base) / store->sector_size);
+}
+
+static uint32_t sector_room(const seq_pattern_store_t *store, uint16_t sector) {
+    return store->sector_size - store->sectors[sector].write_off;
+}
+
+static bool sector_is_blank(const seq_pattern_store_t *store, uint16_t sector) {
+    uint8_t chunk[STORE_COPY_CHUNK];
+    const uint32_t addr = sector_addr(store, sector);
+    for (uint32_t off = 0U; off < store->sector_size; off += sizeof(chunk)) {
+        if (!board_flash_read(addr + off, chunk, sizeof(chunk))) {
+            return false;
+        }
+        for (size_t i = 0U; i < sizeof(chunk); ++i) {
+            if (chunk[i] != 0xFFU) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool stamp_sector(seq_pattern_store_t *store, uint16_t sector) {
+    seq_pattern_store_sector_t *s = &store->sectors[sector];
+    const store_sector_header_t header = {
+        .magic = STORE_SECTOR_MAGIC,
+        .erase_count = s->erase_count,
+        .version = STORE_FORMAT_VERSION,
+        .reserved = 0xFFFFU,
+        .reserved2 = 0xFFFFFFFFU
+    };
+    s->write_off = SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE;
+    s->live = 0U;
+    if (!board_flash_write(sector_addr(store, sector), &header, sizeof(header))) {
+        s->state = SEQ_PATTERN_STORE_SECTOR_STALE;
+        return false;
+    }
+    s->state = SEQ_PATTERN_STORE_SECTOR_BLANK;
+    return true;
+}
+
+static bool erase_sector(seq_pattern_store_t *store, uint16_t sector, bool sync) {
+    if (!board_flash_erase_sector(sector_addr(store, sector))) {
+        return false;
+    }
+    store->sectors[sector].erase_count++;
+    if (sync) {
+        store->stats.sync_erases++;
+    } else {
+        store->stats.erases++;
+    }
+    return stamp_sector(store, sector);
+}
+
+static bool payload_crc_ok(uint32_t payload_addr, const store_record_header_t *header) {
+    uint8_t chunk[STORE_COPY_CHUNK];
+    uint16_t crc = crc16_header(header);
+    for (uint32_t done = 0U; done < header->length;) {
+        uint32_t n = header->length - done;
+        if (n > sizeof(chunk)) {
+            n = sizeof(chunk);
+        }
+        if (!board_flash_read(payload_addr + done, chunk, n)) {
+            return false;
+        }
+        crc = crc16_update(crc, chunk, n);
+        done += n;
+    }
+    return crc == header->crc;
+}
+
+static uint32_t record_seq(uint32_t addr) {
+    store_record_header_t header;
+    if (!board_flash_read(addr, &header, sizeof(header))) {
+        return 0U;
+    }
+    return header.seq;
+}
+
+/* Mount helper: walk the records of a stamped sector and keep the newest version of each key. */
+static void scan_sector(seq_pattern_store_t *store, uint16_t sector, uint32_t *max_seq, uint16_t *max_sector) {
+    const uint32_t base = sector_addr(store, sector);
+    uint32_t off = SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE;
+
+    while ((off + SEQ_PATTERN_STORE_RECORD_HEADER_SIZE) <= store->sector_size) {
+        store_record_header_t header;
+        if (!board_flash_read(base + off, &header, sizeof(header))) {
+            off = store->sector_size;
+            break;
+        }
+        if (header.magic == 0xFFFFU) {
+            break; /* free space */
+        }
+        if ((header.magic != STORE_RECORD_MAGIC) || (header.length > SEQ_PATTERN_STORE_MAX_PAYLOAD) ||
+            ((off + record_size(header.length)) > store->sector_size)) {
+            store->stats.torn++;
+            off = store->sector_size; /* unreadable tail: close the sector */
+            break;
+        }
+
+        const uint32_t addr = base + off;
+        off += record_size(header.length);
+        if ((header.commit != STORE_COMMITTED) || (header.key >= SEQ_PATTERN_STORE_KEY_COUNT) ||
+            !payload_crc_ok(addr + SEQ_PATTERN_STORE_RECORD_HEADER_SIZE, &header)) {
+            store->stats.torn++;
+            continue;
+        }
+
+        const uint32_t current = store->key_addr[header.key];
+        if ((current == 0U) || (header.seq > record_seq(current))) {
+            store->key_addr[header.key] = addr;
+            store->key_len[header.key] = header.length;
+        }
+        if (header.seq >= *max_seq) {
+            *max_seq = header.seq;
+            *max_sector = sector;
+        }
+    }
+    store->sectors[sector].write_off = (uint16_t)off;
+}
+
+static uint16_t find_blank(const seq_pattern_store_t *store) {
+    uint16_t best = STORE_NO_SECTOR;
+    for (uint16_t s = 0U; s < store->sector_count; ++s) {
+        const seq_pattern_store_sector_t *sector = &store->sectors[s];
+        if ((sector->state == SEQ_PATTERN_STORE_SECTOR_BLANK) &&
+            ((best == STORE_NO_SECTOR) || (sector->erase_count < store->sectors[best].erase_count))) {
+            best = s;
+        }
+    }
+    return best;
+}
+
+static void close_active(seq_pattern_store_t *store) {
+    if (store->active == STORE_NO_SECTOR) {
+        return;
+    }
+    seq_pattern_store_sector_t *sector = &store->sectors[store->active];
+    sector->state = (sector->live == 0U) ? SEQ_PATTERN_STORE_SECTOR_STALE : SEQ_PATTERN_STORE_SECTOR_FULL;
+    store->active = STORE_NO_SECTOR;
+}
+
+static bool open_blank(seq_pattern_store_t *store) {
+    const uint16_t blank = find_blank(store);
+    if (blank == STORE_NO_SECTOR) {
+        return false;
+    }
+    close_active(store);
+    store->sectors[blank].state = SEQ_PATTERN_STORE_SECTOR_ACTIVE;
+    store->active = blank;
+    return true;
+}
+
+/* Drop the bytes of a superseded record; a closed sector left without live data becomes reclaimable. */
+static void release_record(seq_pattern_store_t *store, uint16_t key) {
+    const uint32_t addr = store->key_addr[key];
+    if (addr == 0U) {
+        return;
+    }
+    seq_pattern_store_sector_t *sector = &store->sectors[sector_of(store, addr)];
+    sector->live = (uint16_t)(sector->live - record_size(store->key_len[key]));
+    if ((sector->live == 0U) && (sector->state == SEQ_PATTERN_STORE_SECTOR_FULL)) {
+        sector->state = SEQ_PATTERN_STORE_SECTOR_STALE;
+    }
+}
+
+static void place_record(seq_pattern_store_t *store, uint16_t key, uint32_t addr, uint16_t length) {
+    release_record(store, key);
+    store->key_addr[key] = addr;
+    store->key_len[key] = length;
+    store->sectors[sector_of(store, addr)].live = (uint16_t)(store->sectors[sector_of(store, addr)].live + record_size(length));
+}
+
+/* Copy the records of @p victim still referenced by the key map into the active sector. */
+static bool evacuate(seq_pattern_store_t *store, uint16_t victim) {
+    uint8_t chunk[STORE_COPY_CHUNK];
+
+    for (uint16_t key = 0U; key < SEQ_PATTERN_STORE_KEY_COUNT; ++key) {
+        const uint32_t from = store->key_addr[key];
+        if ((from == 0U) || (sector_of(store, from) != victim)) {
+            continue;
+        }
+        const uint32_t size = record_size(store->key_len[key]);
+        if ((store->active == STORE_NO_SECTOR) || (sector_room(store, store->active) < size)) {
+            if (!open_blank(store)) {
+                return false;
+            }
+        }
+
+        /* Header first (already committed): a torn copy fails its CRC and the original stays valid. */
+        const uint32_t to = sector_addr(store, store->active) + store->sectors[store->active].write_off;
+        const uint32_t total = SEQ_PATTERN_STORE_RECORD_HEADER_SIZE + store->key_len[key];
+        store->sectors[store->active].write_off = (uint16_t)(store->sectors[store->active].write_off + size);
+        for (uint32_t done = 0U; done < total;) {
+            uint32_t n = total - done;
+            if (n > sizeof(chunk)) {
+                n = sizeof(chunk);
+            }
+            if (!board_flash_read(from + done, chunk, n) || !board_flash_write(to + done, chunk, n)) {
+                return false;
+            }
+            done += n;
+        }
+        place_record(store, key, to, store->key_len[key]);
+        store->stats.gc_moves++;
+    }
+
+    if (store->sectors[victim].live == 0U) {
+        store->sectors[victim].state = SEQ_PATTERN_STORE_SECTOR_STALE;
+    }
+    return true;
+}
+
+static uint16_t find_stale(const seq_pattern_store_t *store) {
+    for (uint16_t s = 0U; s < store->sector_count; ++s) {
+        if (store->sectors[s].state == SEQ_PATTERN_STORE_SECTOR_STALE) {
+            return s;
+        }
+    }
+    return STORE_NO_SECTOR;
+}
+
+/* Closed sector with the fewest live bytes that still holds dead ones. */
+static uint16_t find_gc_victim(const seq_pattern_store_t *store) {
+    uint16_t best = STORE_NO_SECTOR;
+    for (uint16_t s = 0U; s < store->sector_count; ++s) {
+        const seq_pattern_store_sector_t *sector = &store->sectors[s];
+        if (sector->state != SEQ_PATTERN_STORE_SECTOR_FULL) {
+            continue;
+        }
+        if ((uint32_t)sector->live >= (uint32_t)(sector->write_off - SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE)) {
+            continue; /* nothing to reclaim */
+        }
+        if ((best == STORE_NO_SECTOR) || (sector->live < store->sectors[best].live)) {
+            best = s;
+        }
+    }
+    return best;
+}
+
+/* Destination space available without erasing: rest of the active sector plus one blank sector. */
+static bool can_evacuate(const seq_pattern_store_t *store, uint16_t victim) {
+    uint32_t room = (store->active != STORE_NO_SECTOR) ? sector_room(store, store->active) : 0U;
+    if (find_blank(store) != STORE_NO_SECTOR) {
+        room += store->sector_size - SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE;
+    }
+    return room >= store->sectors[victim].live;
+}
+
+static bool maintain_step(seq_pattern_store_t *store, bool sync) {
+    const uint16_t stale = find_stale(store);
+    if (stale != STORE_NO_SECTOR) {
+        if (!erase_sector(store, stale, sync)) {
+            /* Keep the sector out of rotation until the next mount. */
+            store->sectors[stale].state = SEQ_PATTERN_STORE_SECTOR_FULL;
+        }
+        return true;
+    }
+
+    if (seq_pattern_store_blank_sectors(store) < SEQ_PATTERN_STORE_RESERVE_SECTORS) {
+        const uint16_t victim = find_gc_victim(store);
+        if ((victim != STORE_NO_SECTOR) && can_evacuate(store, victim)) {
+            return evacuate(store, victim);
+        }
+        if (sync) {
+            return false;
+        }
+    }
+    if (sync) {
+        return false;
+    }
+
+    /* Static wear levelling: move cold data off the least-erased sector. */
+    uint16_t coldest = STORE_NO_SECTOR;
+    uint32_t max_erase = 0U;
+    for (uint16_t s = 0U; s < store->sector_count; ++s) {
+        const seq_pattern_store_sector_t *sector = &store->sectors[s];
+        if (sector->erase_count > max_erase) {
+            max_erase = sector->erase_count;
+        }
+        if ((sector->state == SEQ_PATTERN_STORE_SECTOR_FULL) &&
+            ((coldest == STORE_NO_SECTOR) || (sector->erase_count < store->sectors[coldest].erase_count))) {
+            coldest = s;
+        }
+    }
+    if ((coldest != STORE_NO_SECTOR) &&
+        ((max_erase - store->sectors[coldest].erase_count) > SEQ_PATTERN_STORE_WEAR_SPREAD) &&
+        can_evacuate(store, coldest)) {
+        store->stats.wear_moves++;
+        return evacuate(store, coldest);
+    }
+    return false;
+}
+
+bool seq_pattern_store_mount(seq_pattern_store_t *store, uint32_t base, uint16_t sector_count) {
+    if ((store == NULL) || (sector_count == 0U) || (sector_count > SEQ_PATTERN_STORE_MAX_SECTORS) ||
+        (board_flash_get_sector_size() != BOARD_FLASH_SECTOR_SIZE)) {
+        return false;
+    }
+
+    memset(store, 0, sizeof(*store));
+    store->base = base;
+    store->sector_size = BOARD_FLASH_SECTOR_SIZE;
+    store->sector_count = sector_count;
+    store->active = STORE_NO_SECTOR;
+
+    uint32_t unknown[(SEQ_PATTERN_STORE_MAX_SECTORS + 31U) / 32U] = {0};
+    uint32_t blank[(SEQ_PATTERN_STORE_MAX_SECTORS + 31U) / 32U] = {0};
+    uint32_t max_erase = 0U;
+    uint32_t max_seq = 0U;
+    uint16_t max_sector = STORE_NO_SECTOR;
+
+    for (uint16_t s = 0U; s < sector_count; ++s) {
+        store_sector_header_t header;
+        if (!board_flash_read(sector_addr(store, s), &header, sizeof(header))) {
+            return false;
+        }
+        if ((header.magic == STORE_SECTOR_MAGIC) && (header.version == STORE_FORMAT_VERSION)) {
+            store->sectors[s].erase_count = header.erase_count;
+            if (header.erase_count > max_erase) {
+                max_erase = header.erase_count;
+            }
+            scan_sector(store, s, &max_seq, &max_sector);
+            continue;
+        }
+        /* No header: factory-blank sector, torn erase or foreign data. */
+        unknown[s >> 5] |= 1UL << (s & 31U);
+        if ((header.magic == 0xFFFFFFFFU) && sector_is_blank(store, s)) {
+            blank[s >> 5] |= 1UL << (s & 31U);
+        }
+    }
+
+    for (uint16_t key = 0U; key < SEQ_PATTERN_STORE_KEY_COUNT; ++key) {
+        if (store->key_addr[key] != 0U) {
+            seq_pattern_store_sector_t *sector = &store->sectors[sector_of(store, store->key_addr[key])];
+            sector->live = (uint16_t)(sector->live + record_size(store->key_len[key]));
+        }
+    }
+
+    for (uint16_t s = 0U; s < sector_count; ++s) {
+        seq_pattern_store_sector_t *sector = &store->sectors[s];
+        if ((unknown[s >> 5] & (1UL << (s & 31U))) != 0U) {
+            /* Unknown history: assume as worn as the most-erased sector. */
+            sector->erase_count = max_erase;
+            if ((blank[s >> 5] & (1UL << (s & 31U))) != 0U) {
+                (void)stamp_sector(store, s);
+            } else {
+                sector->state = SEQ_PATTERN_STORE_SECTOR_STALE;
+            }
+        } else if (sector->write_off <= SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE) {
+            sector->state = SEQ_PATTERN_STORE_SECTOR_BLANK;
+        } else {
+            sector->state = (sector->live == 0U) ? SEQ_PATTERN_STORE_SECTOR_STALE : SEQ_PATTERN_STORE_SECTOR_FULL;
+        }
+    }
+
+    /* Keep appending to the sector holding the newest record. */
+    if ((max_sector != STORE_NO_SECTOR) && (store->sectors[max_sector].state == SEQ_PATTERN_STORE_SECTOR_FULL) &&
+        (sector_room(store, max_sector) >= record_size(1U))) {
+        store->sectors[max_sector].state = SEQ_PATTERN_STORE_SECTOR_ACTIVE;
+        store->active = max_sector;
+    }
+    store->next_seq = max_seq + 1U;
+    return true;
+}
+
+bool seq_pattern_store_write(seq_pattern_store_t *store, uint16_t key, const void *data, size_t length) {
+    if ((store == NULL) || (key >= SEQ_PATTERN_STORE_KEY_COUNT) || (length > SEQ_PATTERN_STORE_MAX_PAYLOAD) ||
+        ((data == NULL) && (length > 0U))) {
+        return false;
+    }
+
+    const uint32_t size = record_size((uint32_t)length);
+    if ((store->active == STORE_NO_SECTOR) || (sector_room(store, store->active) < size)) {
+        /* The last blank sector is kept for compaction: reclaim now if maintenance fell behind. */
+        while ((seq_pattern_store_blank_sectors(store) <= 1U) && maintain_step(store, true)) {
+        }
+        if (!open_blank(store)) {
+            return false;
+        }
+    }
+
+    store_record_header_t header = {
+        .magic = STORE_RECORD_MAGIC,
+        .key = key,
+        .seq = store->next_seq,
+        .length = (uint16_t)length,
+        .crc = 0U,
+        .commit = 0xFFU,
+        .reserved = {0xFFU, 0xFFU, 0xFFU}
+    };
+    header.crc = crc16_update(crc16_header(&header), (const uint8_t *)data, length);
+
+    const uint32_t addr = sector_addr(store, store->active) + store->sectors[store->active].write_off;
+    store->sectors[store->active].write_off = (uint16_t)(store->sectors[store->active].write_off + size);
+    store->next_seq++;
+
+    const uint8_t commit = STORE_COMMITTED;
+    if (!board_flash_write(addr, &header, sizeof(header)) ||
+        ((length > 0U) && !board_flash_write(addr + SEQ_PATTERN_STORE_RECORD_HEADER_SIZE, data, length)) ||
+        !board_flash_write(addr + offsetof(store_record_header_t, commit), &commit, sizeof(commit))) {
+        return false;
+    }
+
+    place_record(store, key, addr, (uint16_t)length);
+    store->stats.writes++;
+    return true;
+}
+
+bool seq_pattern_store_read(const seq_pattern_store_t *store, uint16_t key, size_t offset,
+                            void *buffer, size_t capacity, size_t *length) {
+    if (length != NULL) {
+        *length = 0U;
+    }
+    if ((store == NULL) || (key >= SEQ_PATTERN_STORE_KEY_COUNT) || (store->key_addr[key] == 0U) ||
+        (offset > store->key_len[key])) {
+        return false;
+    }
+    size_t n = store->key_len[key] - offset;
+    if (n > capacity) {
+        n = capacity;
+    }
+    if (!board_flash_read(store->key_addr[key] + SEQ_PATTERN_STORE_RECORD_HEADER_SIZE + (uint32_t)offset, buffer, n)) {
+        return false;
+    }
+    if (length != NULL) {
+        *length = n;
+    }
+    return true;
+}
+
+size_t seq_pattern_store_length(const seq_pattern_store_t *store, uint16_t key) {
+    if ((store == NULL) || (key >= SEQ_PATTERN_STORE_KEY_COUNT) || (store->key_addr[key] == 0U)) {
+        return 0U;
+    }
+    return store->key_len[key];
+}
+
+uint32_t seq_pattern_store_address(const seq_pattern_store_t *store, uint16_t key) {
+    if ((store == NULL) || (key >= SEQ_PATTERN_STORE_KEY_COUNT)) {
+        return 0U;
+    }
+    return store->key_addr[key];
+}
+
+bool seq_pattern_store_maintain(seq_pattern_store_t *store) {
+    if (store == NULL) {
+        return false;
+    }
+    return maintain_step(store, false);
+}
+
+uint16_t seq_pattern_store_blank_sectors(const seq_pattern_store_t *store) {
+    uint16_t count = 0U;
+    for (uint16_t s = 0U; s < store->sector_count; ++s) {
+        if (store->sectors[s].state == SEQ_PATTERN_STORE_SECTOR_BLANK) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,144 @@
+#ifndef BRICK_CORE_SEQ_SEQ_PATTERN_STORE_H_
+#define BRICK_CORE_SEQ_SEQ_PATTERN_STORE_H_
+
+/**
+ * @file seq_pattern_store.h
+ * @brief Log-structured, wear-levelled record store for project slots.
+ *
+ * A project slot is a ring of flash sectors holding append-only records keyed
+ * by pattern index (plus one key for the project header). Saving a pattern
+ * programs a new record and never erases: the previous record simply becomes
+ * dead. There is no fixed directory sector; the key -> record map is rebuilt
+ * at mount time from the record headers (highest sequence number wins).
+ *
+ * Records are committed in two steps (header + payload, then a commit byte),
+ * and carry a CRC, so a record torn by a power cut is ignored and the previous
+ * version of the key stays visible.
+ *
+ * Erasing is deferred to seq_pattern_store_maintain(): it erases reclaimable
+ * sectors, compacts the emptiest ones and moves cold data off under-used
+ * sectors, keeping SEQ_PATTERN_STORE_RESERVE_SECTORS pre-erased sectors ready
+ * for saves. Each sector header carries its own erase counter; new sectors are
+ * always taken from the least-worn erased ones.
+ *
+ * The store is not thread-safe: writes and maintenance must run from the same
+ * context.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board/board_flash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of sectors managed by one store (1 MiB slot of 4 KiB sectors). */
+#ifndef SEQ_PATTERN_STORE_MAX_SECTORS
+#define SEQ_PATTERN_STORE_MAX_SECTORS 256U
+#endif
+
+/** Number of record keys (256 patterns + project header + song). */
+#ifndef SEQ_PATTERN_STORE_KEY_COUNT
+#define SEQ_PATTERN_STORE_KEY_COUNT 258U
+#endif
+
+/** Pre-erased sectors maintenance keeps available for saves. */
+#ifndef SEQ_PATTERN_STORE_RESERVE_SECTORS
+#define SEQ_PATTERN_STORE_RESERVE_SECTORS 2U
+#endif
+
+/** Erase-count spread that triggers a static wear-levelling move. */
+#ifndef SEQ_PATTERN_STORE_WEAR_SPREAD
+#define SEQ_PATTERN_STORE_WEAR_SPREAD 16U
+#endif
+
+/** Size of the on-flash sector header. */
+#define SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE 16U
+
+/** Size of the on-flash record header. */
+#define SEQ_PATTERN_STORE_RECORD_HEADER_SIZE 16U
+
+/** Largest payload a record can hold (one record never spans sectors). */
+#define SEQ_PATTERN_STORE_MAX_PAYLOAD \
+    (BOARD_FLASH_SECTOR_SIZE - SEQ_PATTERN_STORE_SECTOR_HEADER_SIZE - SEQ_PATTERN_STORE_RECORD_HEADER_SIZE)
+
+/** Runtime state of a sector. */
+typedef enum {
+    SEQ_PATTERN_STORE_SECTOR_STALE = 0, /**< Needs an erase before use. */
+    SEQ_PATTERN_STORE_SECTOR_BLANK,     /**< Erased and stamped, ready for records. */
+    SEQ_PATTERN_STORE_SECTOR_ACTIVE,    /**< Currently receiving records. */
+    SEQ_PATTERN_STORE_SECTOR_FULL       /**< Closed, holds live and/or dead records. */
+} seq_pattern_store_sector_state_t;
+
+/** RAM bookkeeping for one sector. */
+typedef struct {
+    uint32_t erase_count; /**< Erase cycles recorded in the sector header. */
+    uint16_t write_off;   /**< Next free byte inside the sector. */
+    uint16_t live;        /**< Bytes still referenced by the key map. */
+    uint8_t  state;       /**< seq_pattern_store_sector_state_t. */
+} seq_pattern_store_sector_t;
+
+/** Counters exposed for diagnostics and tests. */
+typedef struct {
+    uint32_t writes;       /**< Records appended by callers. */
+    uint32_t erases;       /**< Sector erases performed by maintenance. */
+    uint32_t sync_erases;  /**< Erases a write had to perform itself (reserve exhausted). */
+    uint32_t gc_moves;     /**< Records relocated by compaction. */
+    uint32_t wear_moves;   /**< Sectors evacuated for static wear levelling. */
+    uint32_t torn;         /**< Uncommitted or corrupted records skipped at mount. */
+} seq_pattern_store_stats_t;
+
+/** Mounted store. */
+typedef struct {
+    uint32_t base;                 /**< Flash address of the first sector. */
+    uint32_t sector_size;
+    uint16_t sector_count;
+    uint16_t active;               /**< Sector receiving records, UINT16_MAX if none. */
+    uint32_t next_seq;             /**< Sequence number of the next record. */
+    uint32_t key_addr[SEQ_PATTERN_STORE_KEY_COUNT]; /**< Record address, 0 if absent. */
+    uint16_t key_len[SEQ_PATTERN_STORE_KEY_COUNT];  /**< Payload length of the record. */
+    seq_pattern_store_sector_t sectors[SEQ_PATTERN_STORE_MAX_SECTORS];
+    seq_pattern_store_stats_t stats;
+} seq_pattern_store_t;
+
+/**
+ * @brief Scan @p sector_count sectors at @p base and rebuild the key map.
+ *
+ * Sectors without a valid header are stamped when blank, or scheduled for an
+ * erase otherwise; mount itself never erases.
+ */
+bool seq_pattern_store_mount(seq_pattern_store_t *store, uint32_t base, uint16_t sector_count);
+
+/** @brief Append a new version of @p key. Programs flash only, unless no erased sector is left. */
+bool seq_pattern_store_write(seq_pattern_store_t *store, uint16_t key, const void *data, size_t length);
+
+/**
+ * @brief Read up to @p capacity bytes of @p key starting at @p offset.
+ * @param[out] length Bytes copied (optional).
+ */
+bool seq_pattern_store_read(const seq_pattern_store_t *store, uint16_t key, size_t offset,
+                            void *buffer, size_t capacity, size_t *length);
+
+/** @brief Payload length of @p key, 0 when absent. */
+size_t seq_pattern_store_length(const seq_pattern_store_t *store, uint16_t key);
+
+/** @brief Flash address of the current record of @p key, 0 when absent. */
+uint32_t seq_pattern_store_address(const seq_pattern_store_t *store, uint16_t key);
+
+/**
+ * @brief Run one bounded maintenance step (at most one sector erase or one sector compaction).
+ * @return true if work was done and another call may do more.
+ */
+bool seq_pattern_store_maintain(seq_pattern_store_t *store);
+
+/** @brief Number of erased sectors ready for records. */
+uint16_t seq_pattern_store_blank_sectors(const seq_pattern_store_t *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRICK_CORE_SEQ_SEQ_PATTERN_STORE_H_ */
@@ -10,24 +10,39 @@
 #include "brick_config.h"
 #include "board/board_flash.h"
 #include "cart/cart_registry.h"
+#include "core/seq/seq_pattern_store.h"
 #include "core/seq/runtime/seq_runtime_cold.h"
 #include "core/ram_audit.h"
 
-#define SEQ_PROJECT_DIRECTORY_MAGIC 0x4250524FU /* 'BPRO' */
+#define SEQ_PROJECT_HEADER_MAGIC    0x4250524FU /* 'BPRO' */
 #define SEQ_PROJECT_PATTERN_MAGIC   0x42504154U /* 'BPAT' */
-#define SEQ_PROJECT_DIRECTORY_VERSION 1U
+#define SEQ_PROJECT_SONG_MAGIC      0x42534E47U /* 'BSNG' */
+#define SEQ_PROJECT_SONG_VERSION    1U
+#define SEQ_PROJECT_HEADER_VERSION  3U
+/** Oldest header still loaded: format 2 lacks the output latency offsets. */
+#define SEQ_PROJECT_HEADER_VERSION_MIN 2U
 
-typedef struct __attribute__((packed)) {
-    uint32_t offset;      /**< Relative offset inside the project slot. */
-    uint32_t length;      /**< Payload length in bytes. */
-    uint8_t  version;     /**< On-disk pattern version. */
-    uint8_t  track_count; /**< Tracks stored in the payload. */
-    uint8_t  reserved[2]; /**< Reserved for future use. */
-} seq_project_directory_entry_t;
+/** Store key of the project header record (pattern keys are 0..255). */
+#define SEQ_PROJECT_HEADER_KEY ((uint16_t)(SEQ_PROJECT_BANK_COUNT * SEQ_PROJECT_PATTERNS_PER_BANK))
+
+/** Store key of the song record (arrangement), next to the project header. */
+#define SEQ_PROJECT_SONG_KEY ((uint16_t)(SEQ_PROJECT_HEADER_KEY + 1U))
+
+_Static_assert(SEQ_PROJECT_SONG_KEY < SEQ_PATTERN_STORE_KEY_COUNT, "store keys must cover every pattern");
+_Static_assert((SEQ_PROJECT_FLASH_SLOT_SIZE / BOARD_FLASH_SECTOR_SIZE) <= SEQ_PATTERN_STORE_MAX_SECTORS,
+               "project slot larger than the pattern store");
+_Static_assert(SEQ_PROJECT_PATTERN_STORAGE_MAX <= SEQ_PATTERN_STORE_MAX_PAYLOAD,
+               "pattern record must fit in one sector");
 
+/**
+ * Project header record. The per-pattern directory of format 1 is gone: the
+ * store rebuilds the pattern map from its record headers at mount time.
+ * Format 3 appends the output latency offsets; a format 2 record is the same
+ * layout without them.
+ */
 typedef struct __attribute__((packed)) {
-    uint32_t magic;                           /**< Directory identifier. */
-    uint16_t version;                         /**< Directory format version. */
+    uint32_t magic;                           /**< Header identifier. */
+    uint16_t version;                         /**< Header format version. */
     uint16_t project_index;                   /**< Slot index inside external flash. */
     uint32_t tempo;                           /**< Project tempo snapshot. */
     uint8_t  active_bank;                     /**< Active bank when saved. */
@@ -35,8 +50,23 @@ typedef struct __attribute__((packed)) {
     uint8_t  track_count;                     /**< Runtime track count when saved. */
     uint8_t  reserved;                        /**< Reserved for alignment. */
     char     name[SEQ_PROJECT_NAME_MAX];      /**< Project label. */
-    seq_project_directory_entry_t entries[SEQ_PROJECT_BANK_COUNT][SEQ_PROJECT_PATTERNS_PER_BANK];
-} seq_project_directory_t;
+    int16_t  latency_us[SEQ_PROJECT_OUTPUT_COUNT]; /**< Output latency offsets (format 3). */
+} seq_project_header_t;
+
+/** Size of a format 2 header record. */
+#define SEQ_PROJECT_HEADER_V2_SIZE offsetof(seq_project_header_t, latency_us)
+
+/** Song record: this header followed by `length` seq_project_song_entry_t. */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;     /**< Song record identifier. */
+    uint16_t version;   /**< Song record version. */
+    uint16_t length;    /**< Number of entries. */
+    uint8_t  flags;     /**< SEQ_PROJECT_SONG_FLAG_*. */
+    uint8_t  reserved[3];
+} song_header_t;
+
+_Static_assert((sizeof(song_header_t) + (SEQ_PROJECT_SONG_MAX_ENTRIES * sizeof(seq_project_song_entry_t))) <=
+               SEQ_PATTERN_STORE_MAX_PAYLOAD, "song record must fit in one sector");
 
 typedef struct __attribute__((packed)) {
     uint32_t magic;     /**< Pattern blob identifier. */
@@ -118,6 +148,9 @@ typedef enum {
 static seq_project_t *s_active_project;
 static CCM_DATA uint8_t s_pattern_buffer[SEQ_PROJECT_PATTERN_STORAGE_MAX];
 UI_RAM_AUDIT(s_pattern_buffer);
+static CCM_DATA seq_pattern_store_t s_store;
+UI_RAM_AUDIT(s_store);
+static uint8_t s_store_project = UINT8_MAX; /**< Project slot mounted in s_store. */
 
 static void pattern_desc_reset(seq_project_pattern_desc_t *desc) {
     if (desc == NULL) {
@@ -131,6 +164,17 @@ static inline void project_bind(seq_project_t *project) {
     s_active_project = project;
 }
 
+/* The model keeps the velocity offset in 8 bits; older images may carry any int16. */
+static int8_t _offset_velocity(int16_t stored) {
+    if (stored < -127) {
+        return -127;
+    }
+    if (stored > 127) {
+        return 127;
+    }
+    return (int8_t)stored;
+}
+
 static bool ensure_flash_ready(void) {
     if (board_flash_is_ready()) {
         return true;
@@ -146,9 +190,18 @@ static uint8_t pattern_linear_index(uint8_t bank, uint8_t pattern) {
     return (uint8_t)(bank * SEQ_PROJECT_PATTERNS_PER_BANK + pattern);
 }
 
-static uint32_t pattern_offset(uint8_t project_index, uint8_t bank, uint8_t pattern) {
-    return project_base(project_index) + (uint32_t)sizeof(seq_project_directory_t) +
-           (uint32_t)pattern_linear_index(bank, pattern) * (uint32_t)SEQ_PROJECT_PATTERN_STORAGE_MAX;
+/** Mount the record store of @p project_index (rebuilds its pattern map on slot change). */
+static bool store_mount(uint8_t project_index) {
+    if (s_store_project == project_index) {
+        return true;
+    }
+    s_store_project = UINT8_MAX;
+    if (!seq_pattern_store_mount(&s_store, project_base(project_index),
+                                 (uint16_t)(SEQ_PROJECT_FLASH_SLOT_SIZE / BOARD_FLASH_SECTOR_SIZE))) {
+        return false;
+    }
+    s_store_project = project_index;
+    return true;
 }
 
 static bool offsets_is_zero(const seq_model_step_offsets_t *offsets) {
@@ -271,14 +324,16 @@ static bool encode_track_steps_v1(const seq_model_track_t *track, uint8_t **curs
             }
         }
 
-        for (uint8_t p = 0U; p < step->plock_count; ++p) {
-            const seq_model_plock_t *plock = &step->plocks[p];
+        seq_model_plock_iter_t it;
+        seq_model_plock_t plock;
+        seq_model_step_plock_iter(step, &track->plocks, &it);
+        while (seq_model_plock_iter_next(&it, &plock)) {
             track_plock_v1_payload_t payload;
-            payload.value = plock->value;
-            payload.parameter_id = plock->parameter_id;
-            payload.domain = plock->domain;
-            payload.voice_index = plock->voice_index;
-            payload.internal_param = plock->internal_param;
+            payload.value = plock.value;
+            payload.parameter_id = plock.parameter_id;
+            payload.domain = plock.domain;
+            payload.voice_index = plock.voice_index;
+            payload.internal_param = plock.internal_param;
             if (!buffer_write(cursor, remaining, &payload, sizeof(payload))) {
                 return false;
             }
@@ -363,22 +418,27 @@ static bool encode_track_steps_v2(const seq_model_track_t *track, uint8_t **curs
             }
         }
 
-        for (uint8_t p = 0U; p < step->plock_count; ++p) {
-            const seq_model_plock_t *plock = &step->plocks[p];
+        seq_model_plock_iter_t it;
+        seq_model_plock_t plock;
+        seq_model_step_plock_iter(step, &track->plocks, &it);
+        while (seq_model_plock_iter_next(&it, &plock)) {
             track_plock_v2_payload_t payload;
-            uint8_t meta = (uint8_t)(plock->voice_index & 0x03U);
-            if (plock->domain == SEQ_MODEL_PLOCK_CART) {
+            uint8_t meta = (uint8_t)(plock.voice_index & 0x03U);
+            if (plock.domain == SEQ_MODEL_PLOCK_CART) {
                 meta |= (1U << 2);
+                if (plock.slide) {
+                    meta |= (1U << 3);
+                }
             } else {
-                meta |= (uint8_t)((plock->internal_param & 0x07U) << 3);
+                meta |= (uint8_t)((plock.internal_param & 0x07U) << 3);
             }
-            payload.value = plock->value;
+            payload.value = plock.value;
             payload.meta = meta;
             if (!buffer_write(cursor, remaining, &payload, sizeof(payload))) {
                 return false;
             }
-            if (plock->domain == SEQ_MODEL_PLOCK_CART) {
-                if (!buffer_write(cursor, remaining, &plock->parameter_id, sizeof(plock->parameter_id))) {
+            if (plock.domain == SEQ_MODEL_PLOCK_CART) {
+                if (!buffer_write(cursor, remaining, &plock.parameter_id, sizeof(plock.parameter_id))) {
                     return false;
                 }
             }
@@ -480,7 +540,7 @@ static bool decode_track_steps_v1(seq_model_track_t *track,
             cursor += sizeof(offsets);
             remaining -= sizeof(offsets);
 
-            step->offsets.velocity = offsets.velocity;
+            step->offsets.velocity = _offset_velocity(offsets.velocity);
             step->offsets.transpose = offsets.transpose;
             step->offsets.length = offsets.length;
             step->offsets.micro = offsets.micro;
@@ -491,7 +551,6 @@ static bool decode_track_steps_v1(seq_model_track_t *track,
             return false;
         }
 
-        uint8_t effective_plocks = 0U;
         for (uint8_t p = 0U; p < stored_plocks; ++p) {
             if (remaining < sizeof(track_plock_v1_payload_t)) {
                 return false;
@@ -506,15 +565,16 @@ static bool decode_track_steps_v1(seq_model_track_t *track,
                 continue;
             }
 
-            seq_model_plock_t *plock = &step->plocks[effective_plocks];
-            plock->value = payload_plock.value;
-            plock->parameter_id = payload_plock.parameter_id;
-            plock->domain = payload_plock.domain;
-            plock->voice_index = payload_plock.voice_index;
-            plock->internal_param = payload_plock.internal_param;
-            ++effective_plocks;
+            const seq_model_plock_t plock = {
+                .value = payload_plock.value,
+                .parameter_id = payload_plock.parameter_id,
+                .domain = payload_plock.domain,
+                .voice_index = payload_plock.voice_index,
+                .internal_param = payload_plock.internal_param
+            };
+            /* Locks beyond the track arena capacity are dropped (seq_model_plock_drop_stats). */
+            (void)seq_model_step_add_plock(step, &track->plocks, &plock);
         }
-        step->plock_count = effective_plocks;
 
         if (policy == TRACK_LOAD_ABSENT) {
             for (uint8_t v = 0U; v < SEQ_MODEL_VOICES_PER_STEP; ++v) {
@@ -602,7 +662,7 @@ static bool decode_track_steps_v2(seq_model_track_t *track,
             cursor += sizeof(offsets);
             remaining -= sizeof(offsets);
 
-            step->offsets.velocity = offsets.velocity;
+            step->offsets.velocity = _offset_velocity(offsets.velocity);
             step->offsets.transpose = offsets.transpose;
             step->offsets.length = offsets.length;
             step->offsets.micro = offsets.micro;
@@ -613,7 +673,6 @@ static bool decode_track_steps_v2(seq_model_track_t *track,
             return false;
         }
 
-        uint8_t effective_plocks = 0U;
         for (uint8_t p = 0U; p < stored_plocks; ++p) {
             if (remaining < sizeof(track_plock_v2_payload_t)) {
                 return false;
@@ -638,25 +697,23 @@ static bool decode_track_steps_v2(seq_model_track_t *track,
                 continue;
             }
 
-            if (effective_plocks >= SEQ_MODEL_MAX_PLOCKS_PER_STEP) {
-                return false;
-            }
-
-            seq_model_plock_t *plock = &step->plocks[effective_plocks];
-            plock->value = payload_plock.value;
-            plock->voice_index = (uint8_t)(payload_plock.meta & 0x03U);
+            seq_model_plock_t plock;
+            plock.value = payload_plock.value;
+            plock.voice_index = (uint8_t)(payload_plock.meta & 0x03U);
             if (is_cart) {
-                plock->domain = SEQ_MODEL_PLOCK_CART;
-                plock->parameter_id = parameter_id;
-                plock->internal_param = 0U;
+                plock.domain = SEQ_MODEL_PLOCK_CART;
+                plock.parameter_id = parameter_id;
+                plock.internal_param = 0U;
+                plock.slide = (payload_plock.meta & (1U << 3)) != 0U;
             } else {
-                plock->domain = SEQ_MODEL_PLOCK_INTERNAL;
-                plock->parameter_id = 0U;
-                plock->internal_param = (uint8_t)((payload_plock.meta >> 3) & 0x07U);
+                plock.domain = SEQ_MODEL_PLOCK_INTERNAL;
+                plock.parameter_id = 0U;
+                plock.internal_param = (uint8_t)((payload_plock.meta >> 3) & 0x07U);
+                plock.slide = false;
             }
-            ++effective_plocks;
+            /* Locks beyond the track arena capacity are dropped (seq_model_plock_drop_stats). */
+            (void)seq_model_step_add_plock(step, &track->plocks, &plock);
         }
-        step->plock_count = effective_plocks;
 
         if (policy == TRACK_LOAD_ABSENT) {
             for (uint8_t v = 0U; v < SEQ_MODEL_VOICES_PER_STEP; ++v) {
@@ -933,46 +990,43 @@ const seq_project_pattern_desc_t *seq_project_get_pattern_descriptor_const(const
     return &project->banks[bank].patterns[pattern];
 }
 
-static bool update_directory(const seq_project_t *project, uint8_t project_index) {
-    seq_project_directory_t dir;
-    memset(&dir, 0, sizeof(dir));
-
-    dir.magic = SEQ_PROJECT_DIRECTORY_MAGIC;
-    dir.version = SEQ_PROJECT_DIRECTORY_VERSION;
-    dir.project_index = project_index;
-    dir.tempo = project->tempo;
-    dir.active_bank = project->active_bank;
-    dir.active_pattern = project->active_pattern;
-    dir.track_count = project->track_count;
-    memcpy(dir.name, project->name, sizeof(dir.name));
-
-    const uint32_t base = project_base(project_index);
-
-    for (uint8_t b = 0U; b < SEQ_PROJECT_BANK_COUNT; ++b) {
-        for (uint8_t p = 0U; p < SEQ_PROJECT_PATTERNS_PER_BANK; ++p) {
-            const seq_project_pattern_desc_t *desc = &project->banks[b].patterns[p];
-            seq_project_directory_entry_t *entry = &dir.entries[b][p];
-            entry->version = desc->version;
-            entry->track_count = desc->track_count;
-            if ((desc->storage_length > 0U) && (desc->storage_offset >= base)) {
-                entry->offset = desc->storage_offset - base;
-                entry->length = desc->storage_length;
-            } else {
-                entry->offset = 0U;
-                entry->length = 0U;
-            }
-        }
-    }
-
-    if (!board_flash_erase(base, sizeof(dir))) {
+bool seq_project_set_output_latency(seq_project_t *project, uint8_t output, int32_t offset_us) {
+    if ((project == NULL) || (output >= SEQ_PROJECT_OUTPUT_COUNT)) {
         return false;
     }
-    if (!board_flash_write(base, &dir, sizeof(dir))) {
-        return false;
+    if (offset_us > SEQ_PROJECT_LATENCY_MAX_US) {
+        offset_us = SEQ_PROJECT_LATENCY_MAX_US;
+    } else if (offset_us < -SEQ_PROJECT_LATENCY_MAX_US) {
+        offset_us = -SEQ_PROJECT_LATENCY_MAX_US;
     }
+    project->latency_us[output] = (int16_t)offset_us;
     return true;
 }
 
+int32_t seq_project_get_output_latency(const seq_project_t *project, uint8_t output) {
+    if ((project == NULL) || (output >= SEQ_PROJECT_OUTPUT_COUNT)) {
+        return 0;
+    }
+    return project->latency_us[output];
+}
+
+static bool write_project_header(const seq_project_t *project, uint8_t project_index) {
+    seq_project_header_t header;
+    memset(&header, 0, sizeof(header));
+
+    header.magic = SEQ_PROJECT_HEADER_MAGIC;
+    header.version = SEQ_PROJECT_HEADER_VERSION;
+    header.project_index = project_index;
+    header.tempo = project->tempo;
+    header.active_bank = project->active_bank;
+    header.active_pattern = project->active_pattern;
+    header.track_count = project->track_count;
+    memcpy(header.name, project->name, sizeof(header.name));
+    memcpy(header.latency_us, project->latency_us, sizeof(header.latency_us));
+
+    return seq_pattern_store_write(&s_store, SEQ_PROJECT_HEADER_KEY, &header, sizeof(header));
+}
+
 bool seq_project_save(uint8_t project_index) {
     if ((s_active_project == NULL) || (project_index >= SEQ_PROJECT_MAX_PROJECTS)) {
         return false;
@@ -987,7 +1041,7 @@ bool seq_project_save(uint8_t project_index) {
         project_ro = (const seq_project_t *)project_view._p;
     }
 
-    if (!update_directory(project_ro, project_index)) {
+    if (!store_mount(project_index) || !write_project_header(project_ro, project_index)) {
         return false;
     }
 
@@ -1003,13 +1057,21 @@ bool seq_project_load(uint8_t project_index) {
         return false;
     }
 
-    seq_project_directory_t dir;
-    const uint32_t base = project_base(project_index);
-    if (!board_flash_read(base, &dir, sizeof(dir))) {
+    if (!store_mount(project_index)) {
         return false;
     }
 
-    if ((dir.magic != SEQ_PROJECT_DIRECTORY_MAGIC) || (dir.version != SEQ_PROJECT_DIRECTORY_VERSION)) {
+    seq_project_header_t dir;
+    memset(&dir, 0, sizeof(dir));
+    size_t read = 0U;
+    if (!seq_pattern_store_read(&s_store, SEQ_PROJECT_HEADER_KEY, 0U, &dir, sizeof(dir), &read) ||
+        (read < SEQ_PROJECT_HEADER_V2_SIZE)) {
+        return false;
+    }
+
+    if ((dir.magic != SEQ_PROJECT_HEADER_MAGIC) || (dir.version < SEQ_PROJECT_HEADER_VERSION_MIN) ||
+        (dir.version > SEQ_PROJECT_HEADER_VERSION) ||
+        (read != ((dir.version == SEQ_PROJECT_HEADER_VERSION) ? sizeof(dir) : SEQ_PROJECT_HEADER_V2_SIZE))) {
         return false;
     }
 
@@ -1020,18 +1082,26 @@ bool seq_project_load(uint8_t project_index) {
     project->active_pattern = (dir.active_pattern < SEQ_PROJECT_PATTERNS_PER_BANK) ? dir.active_pattern : 0U;
     project->track_count = (dir.track_count <= SEQ_PROJECT_MAX_TRACKS) ? dir.track_count : SEQ_PROJECT_MAX_TRACKS;
     memcpy(project->name, dir.name, sizeof(project->name));
+    /* Format 2: no offsets stored, `dir` was zeroed. */
+    for (uint8_t out = 0U; out < SEQ_PROJECT_OUTPUT_COUNT; ++out) {
+        (void)seq_project_set_output_latency(project, out, dir.latency_us[out]);
+    }
 
     for (uint8_t b = 0U; b < SEQ_PROJECT_BANK_COUNT; ++b) {
         for (uint8_t p = 0U; p < SEQ_PROJECT_PATTERNS_PER_BANK; ++p) {
             seq_project_pattern_desc_t *desc = &project->banks[b].patterns[p];
             pattern_desc_reset(desc);
-            const seq_project_directory_entry_t *entry = &dir.entries[b][p];
-            desc->version = entry->version;
-            desc->track_count = (entry->track_count <= SEQ_PROJECT_MAX_TRACKS) ? entry->track_count : SEQ_PROJECT_MAX_TRACKS;
-            if (entry->length > 0U) {
-                desc->storage_offset = base + entry->offset;
-                desc->storage_length = entry->length;
+            const uint16_t key = pattern_linear_index(b, p);
+            pattern_blob_header_t blob;
+            size_t blob_read = 0U;
+            if (!seq_pattern_store_read(&s_store, key, 0U, &blob, sizeof(blob), &blob_read) ||
+                (blob_read != sizeof(blob)) || (blob.magic != SEQ_PROJECT_PATTERN_MAGIC)) {
+                continue;
             }
+            desc->version = (uint8_t)blob.version;
+            desc->track_count = (blob.track_count <= SEQ_PROJECT_MAX_TRACKS) ? blob.track_count : SEQ_PROJECT_MAX_TRACKS;
+            desc->storage_offset = seq_pattern_store_address(&s_store, key);
+            desc->storage_length = (uint32_t)seq_pattern_store_length(&s_store, key);
         }
     }
 
@@ -1039,6 +1109,89 @@ bool seq_project_load(uint8_t project_index) {
     return true;
 }
 
+static bool song_header_read(song_header_t *header) {
+    if ((s_active_project == NULL) || !store_mount(s_active_project->project_index)) {
+        return false;
+    }
+    size_t read = 0U;
+    if (!seq_pattern_store_read(&s_store, SEQ_PROJECT_SONG_KEY, 0U, header, sizeof(*header), &read) ||
+        (read != sizeof(*header))) {
+        return false;
+    }
+    return (header->magic == SEQ_PROJECT_SONG_MAGIC) && (header->version == SEQ_PROJECT_SONG_VERSION) &&
+           (header->length <= SEQ_PROJECT_SONG_MAX_ENTRIES);
+}
+
+bool seq_project_song_save(const seq_project_song_entry_t *entries, uint16_t length, uint8_t flags) {
+    if ((s_active_project == NULL) || (length > SEQ_PROJECT_SONG_MAX_ENTRIES) ||
+        ((entries == NULL) && (length > 0U))) {
+        return false;
+    }
+    if (!ensure_flash_ready() || !store_mount(s_active_project->project_index)) {
+        return false;
+    }
+
+    const song_header_t header = {
+        .magic = SEQ_PROJECT_SONG_MAGIC,
+        .version = SEQ_PROJECT_SONG_VERSION,
+        .length = length,
+        .flags = flags,
+    };
+    uint8_t *cursor = s_pattern_buffer;
+    size_t remaining = sizeof(s_pattern_buffer);
+    if (!buffer_write(&cursor, &remaining, &header, sizeof(header))) {
+        return false;
+    }
+    for (uint16_t i = 0U; i < length; ++i) {
+        seq_project_song_entry_t entry = entries[i];
+        if ((entry.bank >= SEQ_PROJECT_BANK_COUNT) || (entry.pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
+            return false;
+        }
+        entry.reserved = 0U;
+        if (!buffer_write(&cursor, &remaining, &entry, sizeof(entry))) {
+            return false;
+        }
+    }
+
+    return seq_pattern_store_write(&s_store, SEQ_PROJECT_SONG_KEY, s_pattern_buffer,
+                                   (size_t)(cursor - s_pattern_buffer));
+}
+
+uint16_t seq_project_song_length(uint8_t *flags) {
+    song_header_t header;
+    if (!song_header_read(&header)) {
+        if (flags != NULL) {
+            *flags = 0U;
+        }
+        return 0U;
+    }
+    if (flags != NULL) {
+        *flags = header.flags;
+    }
+    return header.length;
+}
+
+bool seq_project_song_read(uint16_t index, seq_project_song_entry_t *out) {
+    song_header_t header;
+    if ((out == NULL) || !song_header_read(&header) || (index >= header.length)) {
+        return false;
+    }
+
+    const size_t offset = sizeof(header) + ((size_t)index * sizeof(*out));
+    size_t read = 0U;
+    if (!seq_pattern_store_read(&s_store, SEQ_PROJECT_SONG_KEY, offset, out, sizeof(*out), &read) ||
+        (read != sizeof(*out))) {
+        return false;
+    }
+    if ((out->bank >= SEQ_PROJECT_BANK_COUNT) || (out->pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
+        return false;
+    }
+    if (out->repeats == 0U) {
+        out->repeats = 1U;
+    }
+    return true;
+}
+
 bool seq_pattern_save(uint8_t bank, uint8_t pattern) {
     if ((s_active_project == NULL) || (bank >= SEQ_PROJECT_BANK_COUNT) || (pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
         return false;
@@ -1078,6 +1231,11 @@ bool seq_pattern_save(uint8_t bank, uint8_t pattern) {
         }
     }
 
+    /* Defragment the p-lock arenas: records back in step order, leaked ones reclaimed. */
+    for (uint8_t i = 0U; i < track_count; ++i) {
+        seq_model_track_compact_plocks(project->tracks[i].track);
+    }
+
     uint8_t *cursor = s_pattern_buffer;
     size_t remaining = sizeof(s_pattern_buffer);
 
@@ -1129,17 +1287,16 @@ bool seq_pattern_save(uint8_t bank, uint8_t pattern) {
         return false;
     }
 
-    const uint32_t offset = pattern_offset(project_ro->project_index, bank, pattern);
-    if (!board_flash_erase(offset, SEQ_PROJECT_PATTERN_STORAGE_MAX)) {
-        return false;
-    }
-    if (!board_flash_write(offset, s_pattern_buffer, total_size)) {
+    /* Append-only: programs a new record, the previous one becomes garbage for maintenance. */
+    const uint16_t key = pattern_linear_index(bank, pattern);
+    if (!store_mount(project_ro->project_index) ||
+        !seq_pattern_store_write(&s_store, key, s_pattern_buffer, total_size)) {
         return false;
     }
 
     desc->version = SEQ_PROJECT_PATTERN_VERSION;
     desc->track_count = track_count;
-    desc->storage_offset = offset;
+    desc->storage_offset = seq_pattern_store_address(&s_store, key);
     desc->storage_length = (uint32_t)total_size;
 
     for (uint8_t t = 0U; t < SEQ_PROJECT_MAX_TRACKS; ++t) {
@@ -1153,46 +1310,59 @@ bool seq_pattern_save(uint8_t bank, uint8_t pattern) {
     }
 
     seq_project_bump_generation(project);
-    return seq_project_save(project_ro->project_index);
+    return true;
 }
 
-bool seq_pattern_load(uint8_t bank, uint8_t pattern) {
-    if ((s_active_project == NULL) || (bank >= SEQ_PROJECT_BANK_COUNT) || (pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
+bool seq_pattern_decode(uint8_t bank,
+                        uint8_t pattern,
+                        seq_model_track_t *const *tracks,
+                        uint8_t track_count,
+                        seq_pattern_image_t *image) {
+    if ((s_active_project == NULL) || (image == NULL) ||
+        (bank >= SEQ_PROJECT_BANK_COUNT) || (pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
         return false;
     }
     if (!ensure_flash_ready()) {
         return false;
     }
 
-    seq_project_t *project = s_active_project;
-    seq_project_pattern_desc_t *desc = &project->banks[bank].patterns[pattern];
-
-    const seq_project_t *project_ro = project;
+    const seq_project_t *project_ro = s_active_project;
     seq_cold_view_t project_view = seq_runtime_cold_view(SEQ_COLDV_PROJECT);
     if ((project_view._p != NULL) && (project_view._bytes >= sizeof(seq_project_t))) {
         project_ro = (const seq_project_t *)project_view._p;
     }
 
-    if ((desc->storage_length == 0U) || (desc->storage_offset == 0U)) {
-        for (uint8_t t = 0U; t < project_ro->track_count; ++t) {
-            seq_model_track_t *track_model = project_ro->tracks[t].track;
-            if (track_model != NULL) {
-                seq_model_track_init(track_model);
+    memset(image, 0, sizeof(*image));
+    image->bank = bank;
+    image->pattern = pattern;
+
+    if (!store_mount(project_ro->project_index)) {
+        return false;
+    }
+    const uint16_t key = pattern_linear_index(bank, pattern);
+    const size_t stored_length = seq_pattern_store_length(&s_store, key);
+
+    if (stored_length == 0U) {
+        for (uint8_t t = 0U; t < track_count; ++t) {
+            if (tracks[t] != NULL) {
+                seq_model_track_init(tracks[t]);
             }
         }
         return true;
     }
 
-    if (desc->storage_length > SEQ_PROJECT_PATTERN_STORAGE_MAX) {
+    if (stored_length > SEQ_PROJECT_PATTERN_STORAGE_MAX) {
         return false;
     }
 
-    if (!board_flash_read(desc->storage_offset, s_pattern_buffer, desc->storage_length)) {
+    if (!seq_pattern_store_read(&s_store, key, 0U, s_pattern_buffer, sizeof(s_pattern_buffer), NULL)) {
         return false;
     }
+    image->storage_offset = seq_pattern_store_address(&s_store, key);
+    image->storage_length = (uint32_t)stored_length;
 
     const uint8_t *cursor = s_pattern_buffer;
-    size_t remaining = desc->storage_length;
+    size_t remaining = stored_length;
 
     if (remaining < sizeof(pattern_blob_header_t)) {
         return false;
@@ -1231,8 +1401,7 @@ bool seq_pattern_load(uint8_t bank, uint8_t pattern) {
         saved_cart.capabilities = track_header.capabilities;
         saved_cart.flags = track_header.flags;
 
-        seq_project_cart_ref_t resolved_cart;
-        track_load_policy_t policy = resolve_cart_policy(&saved_cart, &resolved_cart);
+        track_load_policy_t policy = resolve_cart_policy(&saved_cart, &image->carts[track]);
         seq_project_track_decode_policy_t decode_policy = SEQ_PROJECT_TRACK_DECODE_FULL;
         switch (policy) {
         case TRACK_LOAD_FULL:
@@ -1247,32 +1416,82 @@ bool seq_pattern_load(uint8_t bank, uint8_t pattern) {
             break;
         }
 
-        if (track < project_ro->track_count) {
-            seq_model_track_t *track_model = project_ro->tracks[track].track;
-            if ((track_model != NULL) &&
-                !seq_project_track_steps_decode(track_model, cursor, track_header.payload_size, header.version, decode_policy)) {
-                return false;
-            }
-            project->tracks[track].cart = resolved_cart;
-        }
-
-        if (track < SEQ_PROJECT_MAX_TRACKS) {
-            desc->tracks[track].cart = resolved_cart;
-            desc->tracks[track].valid = 1U;
+        if ((track < track_count) && (tracks[track] != NULL) &&
+            !seq_project_track_steps_decode(tracks[track], cursor, track_header.payload_size, header.version, decode_policy)) {
+            return false;
         }
 
         cursor += track_header.payload_size;
         remaining -= track_header.payload_size;
     }
 
-    if (stored_tracks > project_ro->track_count) {
+    image->track_count = stored_tracks;
+    return true;
+}
+
+void seq_pattern_apply_image(const seq_pattern_image_t *image) {
+    if ((s_active_project == NULL) || (image == NULL) || (image->storage_length == 0U) ||
+        (image->bank >= SEQ_PROJECT_BANK_COUNT) || (image->pattern >= SEQ_PROJECT_PATTERNS_PER_BANK)) {
+        return;
+    }
+
+    seq_project_t *project = s_active_project;
+    seq_project_pattern_desc_t *desc = &project->banks[image->bank].patterns[image->pattern];
+    const uint8_t stored_tracks = image->track_count;
+
+    desc->storage_offset = image->storage_offset;
+    desc->storage_length = image->storage_length;
+    for (uint8_t t = 0U; t < SEQ_PROJECT_MAX_TRACKS; ++t) {
+        if (t < stored_tracks) {
+            if (t < project->track_count) {
+                project->tracks[t].cart = image->carts[t];
+            }
+            desc->tracks[t].cart = image->carts[t];
+            desc->tracks[t].valid = 1U;
+        } else {
+            desc->tracks[t].valid = 0U;
+            memset(&desc->tracks[t].cart, 0, sizeof(desc->tracks[t].cart));
+        }
+    }
+
+    if (stored_tracks > project->track_count) {
         project->track_count = stored_tracks;
     }
     desc->track_count = stored_tracks;
-    for (uint8_t t = stored_tracks; t < SEQ_PROJECT_MAX_TRACKS; ++t) {
-        desc->tracks[t].valid = 0U;
-        memset(&desc->tracks[t].cart, 0, sizeof(desc->tracks[t].cart));
-    }
     seq_project_bump_generation(project);
+}
+
+bool seq_pattern_load(uint8_t bank, uint8_t pattern) {
+    if (s_active_project == NULL) {
+        return false;
+    }
+
+    const seq_project_t *project_ro = s_active_project;
+    seq_cold_view_t project_view = seq_runtime_cold_view(SEQ_COLDV_PROJECT);
+    if ((project_view._p != NULL) && (project_view._bytes >= sizeof(seq_project_t))) {
+        project_ro = (const seq_project_t *)project_view._p;
+    }
+
+    /* Decodes straight into the live tracks: use the pattern queue while playing. */
+    seq_model_track_t *targets[SEQ_PROJECT_MAX_TRACKS];
+    const uint8_t target_count = (project_ro->track_count <= SEQ_PROJECT_MAX_TRACKS)
+                                     ? project_ro->track_count
+                                     : SEQ_PROJECT_MAX_TRACKS;
+    for (uint8_t t = 0U; t < target_count; ++t) {
+        targets[t] = project_ro->tracks[t].track;
+    }
+
+    seq_pattern_image_t image;
+    if (!seq_pattern_decode(bank, pattern, targets, target_count, &image)) {
+        return false;
+    }
+    seq_pattern_apply_image(&image);
     return true;
 }
+
+bool seq_project_storage_service(void) {
+    if (s_store_project == UINT8_MAX) {
+        return false;
+    }
+    return seq_pattern_store_maintain(&s_store);
+}
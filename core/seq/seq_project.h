@@ -49,6 +49,29 @@ extern "C" {
 /** Maximum length for pattern names. */
 #define SEQ_PROJECT_PATTERN_NAME_MAX 16U
 
+/** Maximum number of entries in a song (arrangement). */
+#define SEQ_PROJECT_SONG_MAX_ENTRIES 256U
+
+/** Outputs with a latency offset: DIN, USB and the four carts (seq_scheduler_output_t order). */
+#define SEQ_PROJECT_OUTPUT_COUNT 6U
+
+/** Largest output latency offset stored, either way (microseconds). */
+#define SEQ_PROJECT_LATENCY_MAX_US 20000
+
+/** Song flags. */
+enum {
+    SEQ_PROJECT_SONG_FLAG_LOOP = 1U << 0 /**< Restart at entry 0 after the last one. */
+};
+
+/** One song entry: play (bank, pattern) `repeats` times with `mute_mask` tracks muted. */
+typedef struct __attribute__((packed)) {
+    uint8_t  bank;      /**< Bank of the pattern. */
+    uint8_t  pattern;   /**< Pattern inside the bank. */
+    uint8_t  repeats;   /**< Pattern loops before moving on (0 is read as 1). */
+    uint8_t  reserved;  /**< Reserved for alignment. */
+    uint16_t mute_mask; /**< Tracks muted while the entry plays (bit n = track n). */
+} seq_project_song_entry_t;
+
 /** Decode policy for standalone pattern payloads. */
 typedef enum {
     SEQ_PROJECT_TRACK_DECODE_FULL = 0,
@@ -97,7 +120,7 @@ typedef struct {
     uint8_t                       version;    /**< On-disk version. */
     uint8_t                       track_count;/**< Number of tracks stored. */
     uint16_t                      reserved;   /**< Alignment. */
-    uint32_t                      storage_offset; /**< Absolute offset inside flash slot. */
+    uint32_t                      storage_offset; /**< Flash address of the latest record (moves on compaction). */
     uint32_t                      storage_length; /**< Serialized payload length. */
     seq_project_track_desc_t tracks[SEQ_PROJECT_MAX_TRACKS]; /**< Track descriptors. */
 } seq_project_pattern_desc_t;
@@ -120,6 +143,7 @@ struct seq_project {
     uint8_t project_index;     /**< Active persistent project slot. */
     seq_model_gen_t generation;/**< Generation bumped on topology changes. */
     uint32_t tempo;            /**< Project tempo snapshot. */
+    int16_t latency_us[SEQ_PROJECT_OUTPUT_COUNT]; /**< Per-output latency offsets (us), see seq_scheduler. */
     char name[SEQ_PROJECT_NAME_MAX]; /**< Project label. */
 };
 
@@ -142,11 +166,71 @@ uint8_t seq_project_get_active_bank(const seq_project_t *project);
 uint8_t seq_project_get_active_pattern_index(const seq_project_t *project);
 seq_project_pattern_desc_t *seq_project_get_pattern_descriptor(seq_project_t *project, uint8_t bank, uint8_t pattern);
 const seq_project_pattern_desc_t *seq_project_get_pattern_descriptor_const(const seq_project_t *project, uint8_t bank, uint8_t pattern);
+/**
+ * @brief Set the latency offset of an output (DIN, USB, carts), in microseconds.
+ *
+ * Clamped to +/-SEQ_PROJECT_LATENCY_MAX_US and saved with the project header.
+ * Project data only: the caller applies it to the scheduler.
+ */
+bool seq_project_set_output_latency(seq_project_t *project, uint8_t output, int32_t offset_us);
+/** Latency offset of a scheduler output, in microseconds. */
+int32_t seq_project_get_output_latency(const seq_project_t *project, uint8_t output);
 bool seq_project_save(uint8_t project_index);
 bool seq_project_load(uint8_t project_index);
 bool seq_pattern_save(uint8_t bank, uint8_t pattern);
 bool seq_pattern_load(uint8_t bank, uint8_t pattern);
 
+/** Metadata of a pattern decoded into a caller-owned track set. */
+typedef struct {
+    uint8_t  bank;
+    uint8_t  pattern;
+    uint8_t  track_count;    /**< Tracks stored in the pattern (0: empty slot). */
+    uint8_t  reserved;
+    uint32_t storage_offset; /**< Flash address of the record read. */
+    uint32_t storage_length; /**< Payload length, 0 for an empty slot. */
+    seq_project_cart_ref_t carts[SEQ_PROJECT_MAX_TRACKS]; /**< Resolved cart bindings. */
+} seq_pattern_image_t;
+
+/**
+ * @brief Decode (bank, pattern) into @p tracks without touching the project.
+ *
+ * Tracks past @p track_count (or NULL entries) are skipped. Shares the
+ * pattern buffer with seq_pattern_save()/load(): call from the storage thread.
+ */
+bool seq_pattern_decode(uint8_t bank,
+                        uint8_t pattern,
+                        seq_model_track_t *const *tracks,
+                        uint8_t track_count,
+                        seq_pattern_image_t *image);
+
+/** @brief Publish a decoded image: cart bindings, pattern descriptor, project generation. */
+void seq_pattern_apply_image(const seq_pattern_image_t *image);
+
+/**
+ * @brief Store the song of the active project (one record next to the project header).
+ *
+ * Same context as seq_pattern_save(): shares its staging buffer.
+ */
+bool seq_project_song_save(const seq_project_song_entry_t *entries, uint16_t length, uint8_t flags);
+
+/** @brief Song length and flags of the active project (0 entries when no song is stored). */
+uint16_t seq_project_song_length(uint8_t *flags);
+
+/**
+ * @brief Read one song entry straight from flash (no song copy is kept in RAM).
+ * @return false past the end or when no song is stored.
+ */
+bool seq_project_song_read(uint16_t index, seq_project_song_entry_t *out);
+
+/**
+ * @brief Run one bounded step of pattern-store maintenance (sector erase or compaction).
+ *
+ * Saves only program flash while pre-erased sectors remain; call this from
+ * the thread that saves, when it can afford a sector erase (e.g. idle slots).
+ * @return true if work was done and another call may do more.
+ */
+bool seq_project_storage_service(void);
+
 bool seq_project_track_steps_encode(const seq_model_track_t *track,
                                       uint8_t *buffer,
                                       size_t buffer_size,
@@ -11,6 +11,7 @@
 #include "core/seq/seq_model.h"
 #include "core/ram_audit.h"
 #include "core/seq/runtime/seq_runtime_layout.h"
+#include "core/seq/runtime/seq_sections.h"
 
 struct seq_runtime {
     seq_project_t     project;
@@ -19,6 +20,13 @@ struct seq_runtime {
 
 seq_runtime_t g_seq_runtime;UI_RAM_AUDIT(g_seq_runtime);
 
+/* Second track set: the pattern queue decodes the next pattern here, then the
+   project bindings flip and the former live set becomes the spare. Placed in
+   CCM (counted by seq_runtime_hot_budget.c): tracks are only touched by the
+   CPU, flash I/O goes through the codec image buffer. */
+static SEQ_CCM_SEC seq_model_track_t s_spare_tracks[SEQ_RUNTIME_TRACK_CAPACITY];
+UI_RAM_AUDIT(s_spare_tracks);
+
 void seq_runtime_init(void) {
     seq_runtime_layout_reset_aliases();
     memset(&g_seq_runtime, 0, sizeof(g_seq_runtime));
@@ -43,16 +51,39 @@ seq_project_t *seq_runtime_access_project_mut(void) {
     return &g_seq_runtime.project;
 }
 
-const seq_model_track_t *seq_runtime_get_track(uint8_t idx) {
+/* Follows the project binding: the live set moves on every pattern flip. */
+static seq_model_track_t *_bound_track(uint8_t idx) {
     if (idx >= SEQ_RUNTIME_TRACK_CAPACITY) {
         return NULL;
     }
-    return &g_seq_runtime.tracks[idx];
+    seq_model_track_t *bound = g_seq_runtime.project.tracks[idx].track;
+    return (bound != NULL) ? bound : &g_seq_runtime.tracks[idx];
+}
+
+const seq_model_track_t *seq_runtime_get_track(uint8_t idx) {
+    return _bound_track(idx);
 }
 
 seq_model_track_t *seq_runtime_access_track_mut(uint8_t idx) {
+    return _bound_track(idx);
+}
+
+seq_model_track_t *seq_runtime_shadow_track(uint8_t idx) {
     if (idx >= SEQ_RUNTIME_TRACK_CAPACITY) {
         return NULL;
     }
-    return &g_seq_runtime.tracks[idx];
+    const seq_model_track_t *bound = g_seq_runtime.project.tracks[idx].track;
+    return (bound == &s_spare_tracks[idx]) ? &g_seq_runtime.tracks[idx] : &s_spare_tracks[idx];
+}
+
+void seq_runtime_flip_tracks(uint8_t bank, uint8_t pattern) {
+    seq_project_t *project = &g_seq_runtime.project;
+    for (uint8_t i = 0U; i < SEQ_RUNTIME_TRACK_CAPACITY; ++i) {
+        if (project->tracks[i].track != NULL) {
+            project->tracks[i].track = seq_runtime_shadow_track(i);
+        }
+    }
+    project->active_bank = bank;
+    project->active_pattern = pattern;
+    seq_project_bump_generation(project);
 }
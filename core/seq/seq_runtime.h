@@ -13,7 +13,7 @@ extern "C" {
 #endif
 
 #ifndef SEQ_RUNTIME_TRACK_CAPACITY
-#define SEQ_RUNTIME_TRACK_CAPACITY 2U
+#define SEQ_RUNTIME_TRACK_CAPACITY 16U
 #endif
 
 #ifndef SEQ_LED_BRIDGE_TRACK_CAPACITY
@@ -44,6 +44,15 @@ seq_project_t *seq_runtime_access_project_mut(void) SEQ_DEPRECATED;
 const seq_model_track_t *seq_runtime_get_track(uint8_t idx) SEQ_DEPRECATED;
 seq_model_track_t *seq_runtime_access_track_mut(uint8_t idx) SEQ_DEPRECATED;
 
+/** Track of the set that is not bound to the project (pattern queue prefetch target). */
+seq_model_track_t *seq_runtime_shadow_track(uint8_t idx);
+
+/**
+ * Bind the shadow set to the project and make (bank, pattern) the active slot.
+ * Caller provides exclusion against the Reader (see seq_pattern_queue_flip()).
+ */
+void seq_runtime_flip_tracks(uint8_t bank, uint8_t pattern);
+
 #ifdef __cplusplus
 }
 #endif
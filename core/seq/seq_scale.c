@@ -0,0 +1,68 @@
+/**
+ * @file seq_scale.c
+ * @brief Scale quantisation through 128-entry note maps.
+ */
+
+#include "core/seq/seq_scale.h"
+
+uint32_t seq_scale_lut_builds = 0U;
+
+/* Pitch-class masks indexed by seq_model_scale_mode_t. */
+static const uint16_t k_seq_scale_masks[] = {
+    SEQ_SCALE_MASK_CHROMATIC,
+    0x0AB5U, /* major: 0 2 4 5 7 9 11 */
+    0x05ADU, /* natural minor: 0 2 3 5 7 8 10 */
+    0x06ADU, /* dorian: 0 2 3 5 7 9 10 */
+    0x06B5U, /* mixolydian: 0 2 4 5 7 9 10 */
+};
+
+uint16_t seq_scale_mask(seq_model_scale_mode_t mode) {
+    if (mode >= (sizeof(k_seq_scale_masks) / sizeof(k_seq_scale_masks[0]))) {
+        return SEQ_SCALE_MASK_CHROMATIC;
+    }
+    return k_seq_scale_masks[mode];
+}
+
+uint16_t seq_scale_config_mask(const seq_model_scale_config_t *config) {
+    if ((config == NULL) || !config->enabled) {
+        return SEQ_SCALE_MASK_CHROMATIC;
+    }
+    return seq_scale_mask(config->mode);
+}
+
+uint8_t seq_scale_snap(uint16_t mask, uint8_t root, uint8_t note) {
+    mask &= SEQ_SCALE_MASK_CHROMATIC;
+    if ((note > 127U) || (mask == 0U)) {
+        return (uint8_t)(note & 0x7FU);
+    }
+
+    const int32_t pc = ((int32_t)note - (int32_t)(root % 12U) + 120) % 12;
+    if ((mask & (1U << pc)) != 0U) {
+        return note;
+    }
+
+    /* Closest degree, the one below first. */
+    for (int32_t d = 1; d < 12; ++d) {
+        if (((mask & (1U << ((pc - d + 12) % 12))) != 0U) && ((int32_t)note - d >= 0)) {
+            return (uint8_t)((int32_t)note - d);
+        }
+        if (((mask & (1U << ((pc + d) % 12))) != 0U) && ((int32_t)note + d <= 127)) {
+            return (uint8_t)((int32_t)note + d);
+        }
+    }
+    return note;
+}
+
+void seq_scale_lut_build(seq_scale_lut_t *lut, uint16_t mask, uint8_t root) {
+    if (lut == NULL) {
+        return;
+    }
+    root = (uint8_t)(root % 12U);
+    for (uint32_t n = 0U; n < SEQ_SCALE_NOTE_COUNT; ++n) {
+        lut->map[n] = seq_scale_snap(mask, root, (uint8_t)n);
+    }
+    lut->mask = mask;
+    lut->root = root;
+    lut->valid = true;
+    seq_scale_lut_builds++;
+}
@@ -0,0 +1,77 @@
+#ifndef BRICK_CORE_SEQ_SEQ_SCALE_H_
+#define BRICK_CORE_SEQ_SEQ_SCALE_H_
+
+/**
+ * @file seq_scale.h
+ * @brief Scale quantisation through 128-entry note maps.
+ *
+ * A scale is a 12-bit pitch-class mask (bit n = n semitones above the root).
+ * The mask tables are compile-time constants; the 128-entry note map of a
+ * (mask, root) pair is built once by its owner when the configuration changes
+ * (seq_scale_lut_prepare()), so quantising a note in a hot path is a single
+ * table load. Each context owns its maps (Reader plan slots, keyboard app,
+ * live capture): no map is shared across threads.
+ *
+ * Out-of-scale notes move to the closest degree, the lower one on a tie, and
+ * never leave [0, 127].
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "seq_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEQ_SCALE_NOTE_COUNT 128U
+#define SEQ_SCALE_MASK_CHROMATIC 0x0FFFU
+
+/**
+ * @brief Note map of one (mask, root) pair.
+ */
+typedef struct {
+    uint16_t mask;                     /**< Pitch-class mask the map was built for. */
+    uint8_t root;                      /**< Root pitch class (0-11). */
+    bool valid;                        /**< False until the first build. */
+    uint8_t map[SEQ_SCALE_NOTE_COUNT]; /**< Quantised note for every MIDI note. */
+} seq_scale_lut_t;
+
+/** @brief Number of map builds since boot (diagnostic). */
+extern uint32_t seq_scale_lut_builds;
+
+/** @brief Pitch-class mask of a sequencer scale (chromatic if unknown). */
+uint16_t seq_scale_mask(seq_model_scale_mode_t mode);
+
+/** @brief Pitch-class mask of a track scale configuration (chromatic when disabled). */
+uint16_t seq_scale_config_mask(const seq_model_scale_config_t *config);
+
+/** @brief Quantise one note without a map (cold paths, map construction). */
+uint8_t seq_scale_snap(uint16_t mask, uint8_t root, uint8_t note);
+
+/** @brief Build @p lut for (@p mask, @p root) unconditionally. */
+void seq_scale_lut_build(seq_scale_lut_t *lut, uint16_t mask, uint8_t root);
+
+/**
+ * @brief Make sure @p lut maps (@p mask, @p root); rebuilds only on a change.
+ * @return The note map.
+ */
+static inline const uint8_t *seq_scale_lut_prepare(seq_scale_lut_t *lut, uint16_t mask, uint8_t root) {
+    root = (uint8_t)(root % 12U);
+    if (!lut->valid || (lut->mask != mask) || (lut->root != root)) {
+        seq_scale_lut_build(lut, mask, root);
+    }
+    return lut->map;
+}
+
+/** @brief Quantise @p note through a prepared map. */
+static inline uint8_t seq_scale_lut_apply(const seq_scale_lut_t *lut, uint8_t note) {
+    return lut->map[note & 0x7FU];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRICK_CORE_SEQ_SEQ_SCALE_H_ */
@@ -0,0 +1,294 @@
+/**
+ * @file seq_scheduler.c
+ * @brief Timestamped event queue between the Reader and the Player.
+ *
+ * Storage is a fixed array kept sorted by release order, latest event first,
+ * so the next event to release is always at the tail (O(1) pop) and an
+ * insertion costs one bounded memmove. Release times are compared with a
+ * signed difference to stay correct across `systime_t` wrap-around.
+ *
+ * Output offsets are kept in system ticks. An event is stored once, keyed on
+ * the smallest offset among its pending outputs (`shift`); dispatch releases
+ * the outputs sharing that offset and re-inserts the event keyed on the next
+ * one. Capacity is therefore counted in events, not in outputs.
+ */
+
+#include "seq_scheduler.h"
+
+#include <string.h>
+
+#include "brick_config.h"
+
+#define SEQ_SCHEDULER_US_PER_TICK ((int32_t)(1000000U / CH_CFG_ST_FREQUENCY))
+
+_Static_assert((SEQ_SCHEDULER_LATENCY_MAX_US / SEQ_SCHEDULER_US_PER_TICK) < INT16_MAX,
+               "output offsets must fit the 16-bit event shift");
+_Static_assert(sizeof(seq_scheduler_event_t) <= 16U, "scheduler events are counted in the hot budget");
+
+seq_scheduler_stats_t seq_scheduler_stats = {0};
+
+static CCM_DATA seq_scheduler_event_t s_queue[SEQ_SCHEDULER_CAPACITY];
+static uint16_t s_count = 0U;
+static systime_t s_period = 0U;
+static bool s_has_last_lateness = false;
+static systime_t s_last_lateness = 0U;
+static int32_t s_latency_us[SEQ_SCHEDULER_OUT_COUNT];
+static int32_t s_offset[SEQ_SCHEDULER_OUT_COUNT]; /* system ticks, fits `shift` */
+
+static int32_t _sched_time_diff(systime_t a, systime_t b) {
+    return (int32_t)(uint32_t)(a - b);
+}
+
+static systime_t _sched_release(const seq_scheduler_event_t *ev) {
+    return (systime_t)(ev->due + (systime_t)(int32_t)ev->shift);
+}
+
+/* True when @p a must be released before @p b (or alongside, FIFO). */
+static bool _sched_releases_before(const seq_scheduler_event_t *a, const seq_scheduler_event_t *b) {
+    const int32_t diff = _sched_time_diff(_sched_release(a), _sched_release(b));
+    if (diff != 0) {
+        return diff < 0;
+    }
+    return a->type <= b->type;
+}
+
+static void _sched_remove_at(uint16_t index) {
+    if (index >= s_count) {
+        return;
+    }
+    const uint16_t tail = (uint16_t)(s_count - index - 1U);
+    if (tail > 0U) {
+        memmove(&s_queue[index], &s_queue[index + 1U], (size_t)tail * sizeof(s_queue[0]));
+    }
+    s_count--;
+}
+
+static void _sched_insert(const seq_scheduler_event_t *event) {
+    uint16_t pos = 0U;
+    while ((pos < s_count) && !_sched_releases_before(&s_queue[pos], event)) {
+        pos++;
+    }
+
+    const uint16_t tail = (uint16_t)(s_count - pos);
+    if (tail > 0U) {
+        memmove(&s_queue[pos + 1U], &s_queue[pos], (size_t)tail * sizeof(s_queue[0]));
+    }
+    s_queue[pos] = *event;
+    s_count++;
+
+    if (s_count > seq_scheduler_stats.queue_high_water) {
+        seq_scheduler_stats.queue_high_water = s_count;
+    }
+}
+
+/* Key @p ev on the earliest of its pending outputs (0 for an unrouted event). */
+static void _sched_key(seq_scheduler_event_t *ev) {
+    bool any = false;
+    int32_t shift = 0;
+    for (uint8_t out = 0U; out < SEQ_SCHEDULER_OUT_COUNT; ++out) {
+        if (((ev->outputs & SEQ_SCHEDULER_OUT_BIT(out)) != 0U) && (!any || (s_offset[out] < shift))) {
+            shift = s_offset[out];
+            any = true;
+        }
+    }
+    ev->shift = (int16_t)shift;
+}
+
+/* Pending outputs of @p ev released at its key (all of them when unrouted). */
+static uint8_t _sched_group(const seq_scheduler_event_t *ev) {
+    if ((ev->outputs & (uint8_t)((1U << SEQ_SCHEDULER_OUT_COUNT) - 1U)) == 0U) {
+        return ev->outputs;
+    }
+    uint8_t group = 0U;
+    for (uint8_t out = 0U; out < SEQ_SCHEDULER_OUT_COUNT; ++out) {
+        if (((ev->outputs & SEQ_SCHEDULER_OUT_BIT(out)) != 0U) && (s_offset[out] == (int32_t)ev->shift)) {
+            group |= SEQ_SCHEDULER_OUT_BIT(out);
+        }
+    }
+    return group;
+}
+
+/* Evict the latest pending NOTE_ON/p-lock to make room for a NOTE_OFF. */
+static bool _sched_evict_for_note_off(void) {
+    for (uint16_t i = 0U; i < s_count; ++i) {
+        if (s_queue[i].type != (uint8_t)SEQ_SCHEDULER_EV_NOTE_OFF) {
+            _sched_remove_at(i);
+            seq_scheduler_stats.dropped++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void seq_scheduler_init(void) {
+    seq_scheduler_clear();
+    s_period = 0U;
+    seq_scheduler_stats_reset();
+}
+
+void seq_scheduler_clear(void) {
+    s_count = 0U;
+    s_has_last_lateness = false;
+    s_last_lateness = 0U;
+}
+
+void seq_scheduler_set_period(systime_t period) {
+    s_period = period;
+}
+
+void seq_scheduler_set_latency(seq_scheduler_output_t out, int32_t offset_us) {
+    if ((uint32_t)out >= (uint32_t)SEQ_SCHEDULER_OUT_COUNT) {
+        return;
+    }
+    if (offset_us > SEQ_SCHEDULER_LATENCY_MAX_US) {
+        offset_us = SEQ_SCHEDULER_LATENCY_MAX_US;
+    } else if (offset_us < -SEQ_SCHEDULER_LATENCY_MAX_US) {
+        offset_us = -SEQ_SCHEDULER_LATENCY_MAX_US;
+    }
+    s_latency_us[out] = offset_us;
+    /* Round half away from zero so +x and -x map to opposite tick offsets. */
+    const int32_t half = SEQ_SCHEDULER_US_PER_TICK / 2;
+    s_offset[out] = (offset_us >= 0) ? ((offset_us + half) / SEQ_SCHEDULER_US_PER_TICK)
+                                     : -((-offset_us + half) / SEQ_SCHEDULER_US_PER_TICK);
+}
+
+int32_t seq_scheduler_get_latency(seq_scheduler_output_t out) {
+    if ((uint32_t)out >= (uint32_t)SEQ_SCHEDULER_OUT_COUNT) {
+        return 0;
+    }
+    return s_latency_us[out];
+}
+
+systime_t seq_scheduler_lead(void) {
+    int32_t lead = 0;
+    for (uint8_t out = 0U; out < SEQ_SCHEDULER_OUT_COUNT; ++out) {
+        if (-s_offset[out] > lead) {
+            lead = -s_offset[out];
+        }
+    }
+    return (systime_t)lead;
+}
+
+bool seq_scheduler_push(const seq_scheduler_event_t *event) {
+    if (event == NULL) {
+        return false;
+    }
+
+    if (s_count >= SEQ_SCHEDULER_CAPACITY) {
+        if ((event->type != (uint8_t)SEQ_SCHEDULER_EV_NOTE_OFF) || !_sched_evict_for_note_off()) {
+            if (event->type == (uint8_t)SEQ_SCHEDULER_EV_NOTE_OFF) {
+                seq_scheduler_stats.overflow++;
+            } else {
+                seq_scheduler_stats.dropped++;
+            }
+            return false;
+        }
+    }
+
+    seq_scheduler_event_t queued = *event;
+    _sched_key(&queued);
+    _sched_insert(&queued);
+    seq_scheduler_stats.scheduled++;
+    return true;
+}
+
+bool seq_scheduler_cancel_note_off(uint8_t track, uint8_t slot) {
+    bool found = false;
+    uint16_t i = 0U;
+    while (i < s_count) {
+        const seq_scheduler_event_t *ev = &s_queue[i];
+        if ((ev->type == (uint8_t)SEQ_SCHEDULER_EV_NOTE_OFF) && (ev->track == track) && (ev->slot == slot)) {
+            _sched_remove_at(i);
+            seq_scheduler_stats.cancelled++;
+            found = true;
+        } else {
+            i++;
+        }
+    }
+    return found;
+}
+
+void seq_scheduler_cancel_track(uint8_t track) {
+    uint16_t i = 0U;
+    while (i < s_count) {
+        if (s_queue[i].track == track) {
+            _sched_remove_at(i);
+            seq_scheduler_stats.cancelled++;
+        } else {
+            i++;
+        }
+    }
+}
+
+uint16_t seq_scheduler_dispatch(systime_t now, seq_scheduler_sink_t sink) {
+    uint16_t released = 0U;
+
+    while (s_count > 0U) {
+        const seq_scheduler_event_t *ev = &s_queue[s_count - 1U];
+        if (_sched_time_diff(_sched_release(ev), now) > 0) {
+            break;
+        }
+
+        seq_scheduler_event_t event = *ev;
+        s_count--;
+
+        /* Release the group due now; the other outputs wait in the queue. */
+        const uint8_t group = _sched_group(&event);
+        const uint8_t rest = (uint8_t)(event.outputs & (uint8_t)~group);
+        if (rest != 0U) {
+            seq_scheduler_event_t later = event;
+            later.outputs = rest;
+            _sched_key(&later);
+            _sched_insert(&later);
+        }
+        if ((group == 0U) && (event.outputs != 0U)) {
+            continue; /* offsets changed since the event was keyed: re-keyed above */
+        }
+        event.outputs = group;
+
+        const systime_t lateness = (systime_t)(now - _sched_release(&event));
+        if ((s_period > 0U) && (lateness > s_period)) {
+            seq_scheduler_stats.late++;
+        }
+        if (lateness > seq_scheduler_stats.lateness_max) {
+            seq_scheduler_stats.lateness_max = lateness;
+        }
+        seq_scheduler_stats.lateness_sum += lateness;
+        if (s_has_last_lateness) {
+            const systime_t jitter = (lateness > s_last_lateness) ? (systime_t)(lateness - s_last_lateness)
+                                                                  : (systime_t)(s_last_lateness - lateness);
+            if (jitter > seq_scheduler_stats.jitter_max) {
+                seq_scheduler_stats.jitter_max = jitter;
+            }
+        }
+        s_last_lateness = lateness;
+        s_has_last_lateness = true;
+
+        seq_scheduler_stats.dispatched++;
+        released++;
+
+        if (sink != NULL) {
+            sink(&event);
+        }
+    }
+
+    return released;
+}
+
+bool seq_scheduler_next_release(systime_t *when) {
+    if (s_count == 0U) {
+        return false;
+    }
+    if (when != NULL) {
+        *when = _sched_release(&s_queue[s_count - 1U]);
+    }
+    return true;
+}
+
+uint16_t seq_scheduler_pending(void) {
+    return s_count;
+}
+
+void seq_scheduler_stats_reset(void) {
+    memset((void *)&seq_scheduler_stats, 0, sizeof(seq_scheduler_stats));
+}
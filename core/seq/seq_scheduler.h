@@ -0,0 +1,164 @@
+#ifndef BRICK_CORE_SEQ_SEQ_SCHEDULER_H_
+#define BRICK_CORE_SEQ_SEQ_SCHEDULER_H_
+
+/**
+ * @file seq_scheduler.h
+ * @brief Timestamped event queue sitting between the Reader and the Player.
+ *
+ * The runner plans NOTE_ON/NOTE_OFF/p-lock events with an absolute
+ * `systime_t` deadline (micro-timing, per-step offsets, p-lock lead time) and
+ * the clock path drains every due event on each 24 PPQN tick, plus at the
+ * next release time in between (clock_seq service). Events sharing the same
+ * release time are released NOTE_OFF first, then p-locks, then NOTE_ON, in
+ * insertion order inside each class.
+ *
+ * Each event names the outputs it goes to. Every output has its own latency
+ * offset: an event is released to an output at `due + offset`, so a slow
+ * destination can be fired earlier (negative offset) or a fast one held back
+ * (positive offset) and they all sound together. An event takes one queue
+ * entry whatever its outputs: it is keyed on its earliest pending output
+ * group, and re-queued on the next group once that one is released. Negative
+ * offsets only work if the event is planned ahead of its deadline: the
+ * runner reads `seq_scheduler_lead()` to plan one step ahead.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * With the look-ahead pass active, a voice slot holds up to four entries at a
+ * step boundary: the current NOTE_ON still waiting on a positive offset, the
+ * NOTE_OFF moved to the next retrigger, the next NOTE_ON and its NOTE_OFF.
+ * 16 tracks x 4 voices x 4, plus 64 entries for p-locks.
+ */
+#ifndef SEQ_SCHEDULER_CAPACITY
+#define SEQ_SCHEDULER_CAPACITY 320U
+#endif
+
+/** Largest latency offset accepted, either way (microseconds). */
+#ifndef SEQ_SCHEDULER_LATENCY_MAX_US
+#define SEQ_SCHEDULER_LATENCY_MAX_US 20000
+#endif
+
+/**
+ * @brief Destinations with their own latency offset.
+ */
+typedef enum {
+    SEQ_SCHEDULER_OUT_DIN = 0, /**< MIDI DIN (UART, 31.25 kbaud). */
+    SEQ_SCHEDULER_OUT_USB,     /**< USB MIDI. */
+    SEQ_SCHEDULER_OUT_CART1,   /**< Cart UART 1 (CART1 + cart_id_t for the others). */
+    SEQ_SCHEDULER_OUT_CART2,
+    SEQ_SCHEDULER_OUT_CART3,
+    SEQ_SCHEDULER_OUT_CART4,
+    SEQ_SCHEDULER_OUT_COUNT
+} seq_scheduler_output_t;
+
+/** Output bit of @p out in `seq_scheduler_event_t.outputs`. */
+#define SEQ_SCHEDULER_OUT_BIT(out) ((uint8_t)(1U << (out)))
+/** Both MIDI outputs (DIN and USB). */
+#define SEQ_SCHEDULER_OUT_MIDI (SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_DIN) | SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_USB))
+
+/**
+ * @brief Event classes, ordered by release priority for equal deadlines.
+ */
+typedef enum {
+    SEQ_SCHEDULER_EV_NOTE_OFF = 0, /**< NOTE_OFF (never dropped). */
+    SEQ_SCHEDULER_EV_PLOCK,        /**< Cart parameter lock. */
+    SEQ_SCHEDULER_EV_NOTE_ON       /**< NOTE_ON. */
+} seq_scheduler_event_type_t;
+
+/**
+ * @brief Pending event.
+ */
+typedef struct {
+    systime_t due;     /**< Absolute musical deadline. */
+    int16_t shift;     /**< Offset of the next output group, released at `due + shift` (set by the scheduler). */
+    uint16_t param_id; /**< Cart parameter id (p-locks only). */
+    uint8_t type;      /**< @ref seq_scheduler_event_type_t. */
+    uint8_t outputs;   /**< SEQ_SCHEDULER_OUT_BIT() mask, 0 for an unrouted event (no offset).
+                            Pending outputs in the queue, released group in the sink. */
+    uint8_t track;     /**< Source track (0-based). */
+    uint8_t slot;      /**< Source voice slot (notes only). */
+    uint8_t note;      /**< MIDI note (notes only). */
+    uint8_t velocity;  /**< MIDI velocity (NOTE_ON only). */
+    uint8_t value;     /**< P-lock value (p-locks only). */
+} seq_scheduler_event_t;
+
+/**
+ * @brief Scheduler statistics (diagnostic, same spirit as `midi_tx_stats`).
+ *
+ * Lateness is the distance between an event release time and the time it was
+ * actually released; jitter is the largest lateness variation observed
+ * between two consecutive releases.
+ */
+typedef struct {
+    volatile uint32_t scheduled;        /**< Events accepted in the queue. */
+    volatile uint32_t dispatched;       /**< Events released to the sink. */
+    volatile uint32_t late;             /**< Releases later than one dispatch period. */
+    volatile uint32_t dropped;          /**< NOTE_ON/p-lock rejected or evicted (queue full). */
+    volatile uint32_t overflow;         /**< NOTE_OFF refused (queue saturated by NOTE_OFFs). */
+    volatile uint32_t cancelled;        /**< Events withdrawn before release. */
+    volatile uint32_t lateness_max;     /**< Worst lateness (systime_t units). */
+    volatile uint32_t lateness_sum;     /**< Sum of lateness, for averaging. */
+    volatile uint32_t jitter_max;       /**< Worst lateness delta between releases. */
+    volatile uint16_t queue_high_water; /**< Highest queue occupancy. */
+} seq_scheduler_stats_t;
+
+/** @brief Global scheduler statistics. */
+extern seq_scheduler_stats_t seq_scheduler_stats;
+
+/** @brief Sink invoked for every released event. */
+typedef void (*seq_scheduler_sink_t)(const seq_scheduler_event_t *event);
+
+/** Reset the queue and the statistics. */
+void seq_scheduler_init(void);
+/** Drop every pending event (transport stop/start). */
+void seq_scheduler_clear(void);
+/** Expected dispatch period, used to classify late releases. */
+void seq_scheduler_set_period(systime_t period);
+/**
+ * @brief Latency offset of an output, in microseconds.
+ *
+ * Clamped to +/-SEQ_SCHEDULER_LATENCY_MAX_US and rounded to the system tick.
+ * Read at release time, so pending events follow the change. Offsets are
+ * configuration: init and clear keep them.
+ */
+void seq_scheduler_set_latency(seq_scheduler_output_t out, int32_t offset_us);
+/** Latency offset of an output as set (microseconds, clamped). */
+int32_t seq_scheduler_get_latency(seq_scheduler_output_t out);
+/** How far ahead of their deadline events must be planned (largest negative offset). */
+systime_t seq_scheduler_lead(void);
+/**
+ * @brief Queue an event for all of its outputs (one queue entry).
+ * @return false if the queue is full; a NOTE_OFF first evicts the latest
+ *         pending NOTE_ON/p-lock, so false for NOTE_OFF means the caller must
+ *         emit it immediately. Nothing is queued when false is returned.
+ */
+bool seq_scheduler_push(const seq_scheduler_event_t *event);
+/** Withdraw the pending NOTE_OFF of a voice slot (every output). */
+bool seq_scheduler_cancel_note_off(uint8_t track, uint8_t slot);
+/** Withdraw every pending event of a track. */
+void seq_scheduler_cancel_track(uint8_t track);
+/**
+ * @brief Release every output group whose release time is at or before @p now, in order.
+ * @return Number of sink calls (one per output group).
+ */
+uint16_t seq_scheduler_dispatch(systime_t now, seq_scheduler_sink_t sink);
+/** Release time of the next pending event; false when the queue is empty. */
+bool seq_scheduler_next_release(systime_t *when);
+/** Number of pending events (queue entries). */
+uint16_t seq_scheduler_pending(void);
+/** Reset the statistics counters. */
+void seq_scheduler_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* BRICK_CORE_SEQ_SEQ_SCHEDULER_H_ */
@@ -0,0 +1,175 @@
+/**
+ * @file seq_song.c
+ * @brief Song (chain) mode: plays the project arrangement entry by entry.
+ */
+
+#include "core/seq/seq_song.h"
+
+#include <string.h>
+
+#include "core/seq/seq_pattern_queue.h"
+#include "core/seq/seq_project.h"
+
+seq_song_stats_t seq_song_stats = {0};
+
+/* Shared by the UI (start/stop), the storage thread (service) and the Reader
+   context (boundary). Transitions run under chSysLock(); flash reads do not. */
+static struct {
+    bool     active;
+    bool     started;       /* first entry reached the live slot */
+    bool     next_ready;    /* next entry read and queued */
+    bool     next_end;      /* no entry after the current one: the song ends */
+    uint8_t  flags;
+    uint16_t length;
+    uint16_t current;
+    uint16_t next;
+    uint8_t  repeats_left;
+    uint8_t  next_repeats;
+    uint16_t mute_mask;
+    uint16_t next_mute_mask;
+    uint32_t epoch;         /* bumped by start/stop: drops reads that raced them */
+} s_song;
+
+void seq_song_init(void) {
+    chSysLock();
+    memset(&s_song, 0, sizeof(s_song));
+    chSysUnlock();
+    seq_song_stats_reset();
+}
+
+bool seq_song_start(uint16_t first) {
+    if (first >= SEQ_PROJECT_SONG_MAX_ENTRIES) {
+        return false;
+    }
+
+    chSysLock();
+    const uint32_t epoch = s_song.epoch + 1U;
+    memset(&s_song, 0, sizeof(s_song));
+    s_song.epoch = epoch;
+    s_song.active = true;
+    s_song.next = first;
+    chSysUnlock();
+    seq_pattern_queue_cancel(); /* the song owns the queue from now on */
+    return true;
+}
+
+void seq_song_stop(void) {
+    chSysLock();
+    const bool was_active = s_song.active;
+    s_song.epoch++;
+    s_song.active = false;
+    s_song.mute_mask = 0U;
+    chSysUnlock();
+    if (was_active) {
+        seq_pattern_queue_cancel();
+    }
+}
+
+bool seq_song_is_active(void) {
+    chSysLock();
+    const bool active = s_song.active;
+    chSysUnlock();
+    return active;
+}
+
+uint16_t seq_song_position(uint8_t *repeats_left) {
+    chSysLock();
+    const uint16_t position = s_song.started ? s_song.current : s_song.next;
+    if (repeats_left != NULL) {
+        *repeats_left = s_song.started ? s_song.repeats_left : 0U;
+    }
+    chSysUnlock();
+    return position;
+}
+
+uint16_t seq_song_mute_mask(void) {
+    return s_song.mute_mask;
+}
+
+bool seq_song_service(systime_t now) {
+    chSysLock();
+    if (!s_song.active || s_song.next_ready || s_song.next_end) {
+        chSysUnlock();
+        return false;
+    }
+    const uint16_t index = s_song.next;
+    const uint32_t epoch = s_song.epoch;
+    chSysUnlock();
+
+    uint8_t flags = 0U;
+    seq_project_song_entry_t entry;
+    const uint16_t length = seq_project_song_length(&flags);
+    const bool ok = seq_project_song_read(index, &entry) &&
+                    seq_pattern_queue_request(entry.bank, entry.pattern, now);
+
+    chSysLock();
+    if (s_song.epoch != epoch) {
+        chSysUnlock();
+        return true;
+    }
+    if (!ok) {
+        seq_song_stats.read_errors++;
+        s_song.active = false; /* keep looping what plays, never a half-read arrangement */
+        s_song.mute_mask = 0U;
+    } else {
+        seq_song_stats.entries_read++;
+        s_song.length = length;
+        s_song.flags = flags;
+        s_song.next_repeats = entry.repeats;
+        s_song.next_mute_mask = entry.mute_mask;
+        s_song.next_ready = true;
+    }
+    chSysUnlock();
+    return true;
+}
+
+bool seq_song_on_boundary(systime_t now, uint8_t *bank, uint8_t *pattern) {
+    chSysLock();
+    if (!s_song.active) {
+        chSysUnlock();
+        return seq_pattern_queue_flip(now, bank, pattern);
+    }
+    if (s_song.started && (s_song.repeats_left > 1U)) {
+        s_song.repeats_left--;
+        chSysUnlock();
+        return false;
+    }
+    if (s_song.next_end) {
+        s_song.active = false; /* last entry done: its pattern keeps looping */
+        s_song.mute_mask = 0U;
+        chSysUnlock();
+        return false;
+    }
+    const bool ready = s_song.next_ready;
+    chSysUnlock();
+
+    const bool flipped = ready && seq_pattern_queue_flip(now, bank, pattern);
+    const bool lost = ready && !flipped && !seq_pattern_queue_pending(NULL, NULL);
+
+    chSysLock();
+    if (!flipped) {
+        seq_song_stats.underruns++;
+        if (lost) {
+            s_song.next_ready = false; /* request cancelled behind our back: read it again */
+        }
+        chSysUnlock();
+        return false;
+    }
+    seq_song_stats.entries_played++;
+    s_song.started = true;
+    s_song.current = s_song.next;
+    s_song.repeats_left = s_song.next_repeats;
+    s_song.mute_mask = s_song.next_mute_mask;
+    s_song.next_ready = false;
+    s_song.next = (uint16_t)(s_song.current + 1U);
+    if (s_song.next >= s_song.length) {
+        s_song.next = 0U;
+        s_song.next_end = (s_song.flags & SEQ_PROJECT_SONG_FLAG_LOOP) == 0U;
+    }
+    chSysUnlock();
+    return true;
+}
+
+void seq_song_stats_reset(void) {
+    memset(&seq_song_stats, 0, sizeof(seq_song_stats));
+}
@@ -0,0 +1,82 @@
+#ifndef BRICK_CORE_SEQ_SEQ_SONG_H_
+#define BRICK_CORE_SEQ_SEQ_SONG_H_
+
+/**
+ * @file seq_song.h
+ * @brief Song (chain) mode: plays the project arrangement entry by entry.
+ *
+ * The arrangement lives in flash (seq_project_song_*); the player never keeps
+ * a copy of it. Entries are read one at a time by the storage thread
+ * (seq_song_service()) and handed to the pattern queue, whose shadow set is
+ * the look-ahead window: at most two decoded patterns exist in RAM, the one
+ * playing and the next one, whatever the song length.
+ *
+ * The runner calls seq_song_on_boundary() on every pattern boundary instead
+ * of seq_pattern_queue_flip(): it counts repeats, flips to the next entry on
+ * the last one and reports an underrun when that entry is not decoded yet
+ * (the current pattern then loops once more).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Song player statistics (diagnostic, same spirit as `seq_pattern_queue_stats`).
+ */
+typedef struct {
+    uint32_t entries_read;   /**< Entries streamed from flash. */
+    uint32_t entries_played; /**< Entries that reached their first boundary. */
+    uint32_t underruns;      /**< Boundaries where the next entry was not decoded yet. */
+    uint32_t read_errors;    /**< Unreadable entries (song stopped). */
+} seq_song_stats_t;
+
+extern seq_song_stats_t seq_song_stats;
+
+void seq_song_init(void);
+
+/**
+ * @brief Arm the song from entry @p first; it takes over at the next boundary.
+ *
+ * The arrangement is read by the storage thread: a missing song or an entry
+ * past its end stops song mode there (`read_errors`).
+ * @return false if @p first is out of range.
+ */
+bool seq_song_start(uint16_t first);
+
+/** @brief Leave song mode; the playing pattern keeps looping. */
+void seq_song_stop(void);
+
+bool seq_song_is_active(void);
+
+/** @brief Entry playing (or about to play) and its remaining repeats. */
+uint16_t seq_song_position(uint8_t *repeats_left);
+
+/** @brief Tracks muted by the playing entry (bit n = track n), 0 outside song mode. */
+uint16_t seq_song_mute_mask(void);
+
+/**
+ * @brief Read the next entry and queue its pattern (storage thread).
+ * @return true if an entry was read.
+ */
+bool seq_song_service(systime_t now);
+
+/**
+ * @brief Pattern boundary (Reader context). Replaces seq_pattern_queue_flip().
+ * @param[out] bank,pattern New live slot when the pattern changed (optional).
+ * @return true if the live pattern changed.
+ */
+bool seq_song_on_boundary(systime_t now, uint8_t *bank, uint8_t *pattern);
+
+void seq_song_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRICK_CORE_SEQ_SEQ_SONG_H_ */
@@ -30,3 +30,41 @@ enum {
 typedef struct {
   void *_opaque;
 } seq_plock_iter_t;
+
+/* Compiled playback plan, stored as a structure of arrays: the per-step
+   flags and masks a scan needs are contiguous (64 B each, one cache line),
+   voices fully resolved (step offsets, track transpose, scale clamp) sit in
+   separate per-field arrays and are only touched for steps that play.
+   P-locks stay in the track arena; the plan only carries their presence.
+   Rebuilt by the Reader when the track generation moves. */
+enum {
+  SEQ_PLAN_STEP_COUNT = 64u,
+  SEQ_PLAN_VOICE_COUNT = 4u,
+  SEQ_PLAN_VOICE_PLAY_MASK = 0x0Fu,   /* voice_mask bits 0-3: voice n plays */
+  SEQ_PLAN_VOICE_EARLY_SHIFT = 4u,    /* voice_mask bits 4-7: voice n has a negative micro offset */
+};
+
+typedef struct {
+  uint8_t note;
+  uint8_t vel;
+  uint8_t length;
+  int8_t micro;
+} seq_plan_voice_t;
+
+typedef struct {
+  uint64_t voice_bits;                       /* bit s: voice_mask[s] != 0 */
+  uint64_t cart_plock_bits;                  /* bit s: step s carries cart p-locks */
+  uint8_t flags[SEQ_PLAN_STEP_COUNT];        /* SEQ_STEPF_* */
+  uint8_t voice_mask[SEQ_PLAN_STEP_COUNT];   /* bit n: voice n plays; bit 4+n: it plays early */
+  uint8_t note[SEQ_PLAN_STEP_COUNT][SEQ_PLAN_VOICE_COUNT];
+  uint8_t vel[SEQ_PLAN_STEP_COUNT][SEQ_PLAN_VOICE_COUNT];
+  uint8_t length[SEQ_PLAN_STEP_COUNT][SEQ_PLAN_VOICE_COUNT];
+  int8_t micro[SEQ_PLAN_STEP_COUNT][SEQ_PLAN_VOICE_COUNT];
+} seq_plan_track_t;
+
+static inline seq_plan_voice_t seq_plan_voice(const seq_plan_track_t *plan, uint8_t step, uint8_t voice) {
+  const seq_plan_voice_t out = {
+    plan->note[step][voice], plan->vel[step][voice], plan->length[step][voice], plan->micro[step][voice]
+  };
+  return out;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file core/stack_watch.h
+ * @brief Marge de pile restante d’un thread (motif de remplissage ChibiOS).
+ */
+
+#ifndef BRICK_CORE_STACK_WATCH_H_
+#define BRICK_CORE_STACK_WATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Octets de la working area jamais écrits depuis la création du thread.
+ *
+ * Avec `CH_DBG_FILL_THREADS`, la working area est remplie de
+ * `CH_DBG_STACK_FILL_VALUE` à la création ; la pile descend vers la base, le
+ * premier octet modifié en partant de la base marque l’appel le plus profond
+ * observé. Sans remplissage, retourne 0 (aucune mesure).
+ *
+ * @param wa   Base de la working area (`THD_WORKING_AREA`).
+ * @param size `sizeof` de la working area.
+ */
+static inline size_t stack_watch_unused(const void *wa, size_t size) {
+#if defined(CH_DBG_FILL_THREADS) && (CH_DBG_FILL_THREADS == TRUE)
+  const uint8_t *p = (const uint8_t *)wa;
+  size_t n = 0U;
+  while ((n < size) && (p[n] == (uint8_t)CH_DBG_STACK_FILL_VALUE)) {
+    n++;
+  }
+  return n;
+#else
+  (void)wa;
+  (void)size;
+  return 0U;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRICK_CORE_STACK_WATCH_H_ */
@@ -41,22 +41,28 @@
 
 /* --- Sequencer runtime --- */
 #include "core/seq/seq_runtime.h"
+#include "core/seq/seq_pattern_queue.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_song.h"
 
 /* --- I/O Temps Réel --- */
 #include "usb_device.h"
 #include "midi.h"
 #include "midi_clock.h"
+#include "midi_rx.h"
+#include "hr_time.h"
 
 /* ===========================================================
  * INITIALISATION EN BLOCS
  * ===========================================================*/
 
 /**
- * @brief Initialise le système (ChibiOS + HAL).
+ * @brief Initialise le système (ChibiOS + HAL) et la base de temps µs.
  */
 static void system_init(void) {
   halInit();
   chSysInit();
+  hr_time_init();       /* DWT CYCCNT → µs, avant tout module horodaté */
 }
 
 /**
@@ -64,12 +70,13 @@ static void system_init(void) {
  *
  * Ordre recommandé :
  * 1) USB device pour assurer l’énumération et la disponibilité de l’EP,
- * 2) MIDI (UART DIN + threads USB TX),
+ * 2) MIDI (UART DIN + file USB TX), puis réception (threads DIN RX + dispatch),
  * 3) Clock 24 PPQN (GPT + thread haute priorité).
  */
 static void io_realtime_init(void) {
   usb_device_start();   /* USB device + réénumération (usbcfg/usbd) */
-  midi_init();          /* UART DIN @ 31250 + mailbox USB + thread TX */
+  midi_init();          /* UART DIN @ 31250 + file USB TX double tampon */
+  midi_rx_init();       /* Files RX horodatées + threads DIN RX / dispatch */
   midi_clock_init();    /* GPT + thread Clock @ NORMALPRIO+3 */
 }
 
@@ -90,6 +97,9 @@ static void drivers_and_cart_init(void) {
   cart_registry_register(CART1, &CART_XVA1);
   // cart_registry_register(CART2, &CART_FX);
   // cart_registry_register(CART3, &CART_SAMPLER);
+
+  /* Shadow aligné sur l’état réel de la cartouche (réponses appliquées par le thread UI) */
+  (void)cart_link_resync(CART1);
 }
 
 /**
@@ -114,6 +124,8 @@ int main(void) {
   system_init();
 
   seq_runtime_init();
+  seq_pattern_queue_init();
+  seq_song_init();
 
   /* I/O temps réel d’abord (USB/MIDI/Clock), puis drivers/cart, puis UI */
   io_realtime_init();
@@ -126,8 +138,18 @@ int main(void) {
   /* Démarre le thread de gestion de l’interface utilisateur */
   ui_task_start();
 
+  /* Le thread principal devient le contexte stockage, sous l’UI : lecture de
+   * l’entrée suivante du song, préchargement du pattern en file (décodage
+   * flash → jeu de pistes fantôme), puis maintenance du journal de patterns
+   * quand rien n’est en attente. */
+  chThdSetPriority(NORMALPRIO - 1);
+
   while (true) {
     // --- FIX: le thread UI gère désormais le rafraîchissement LED pour éviter les doubles rendus ---
+    (void)seq_song_service(chVTGetSystemTimeX());
+    if (!seq_pattern_queue_service(chVTGetSystemTimeX())) {
+      (void)seq_project_storage_service();
+    }
     chThdSleepMilliseconds(20);
   }
 }
@@ -7,15 +7,23 @@
  * - **USB MIDI** (class compliant) via l’endpoint IN (EP2).
  *
  * Principes d’implémentation :
- * - Un **thread dédié** agrège les paquets USB-MIDI en trames de 64 octets (EP IN bulk)
- *   à partir d’une **mailbox** non bloquante.
- * - Les messages “Realtime” (F8, FA/FB/FC/FE/FF) bénéficient d’un **chemin rapide**
- *   avec micro-attente pour l’envoi immédiat si l’endpoint est libre.
+ * - Les paquets USB-MIDI sont écrits **directement** dans le tampon qui partira
+ *   au prochain transfert (`midi_usb_tx_ring`, double tampon, sans copie ni verrou).
+ * - Endpoint libre : le producteur démarre lui-même le transfert (un F8 part
+ *   sans attente). Endpoint occupé : le callback de fin de transfert (EP2 IN)
+ *   enchaîne le tampon rempli, sans réveil de thread.
+ * - La sortie DIN passe par un étage de classement (`midi_din_out`) : priorités
+ *   temps réel > NOTE_OFF > NOTE_ON > CC, running status, budget par step.
+ *   Un thread dédié l’écrit par petits blocs dès que la file UART se vide,
+ *   pour que le temps réel passe devant une rafale de notes.
+ * - Le F8 de l’horloge interne part de l’ISR du timer (`midi_clock_i()`) :
+ *   paquet USB précalculé déposé dans la file, octet DIN écrit directement
+ *   dans la file de l’UART quand l’étage n’a pas de temps réel en attente.
  * - Les statistiques d’envoi sont tenues dans `midi_tx_stats` pour le diagnostic.
  *
  * Contraintes temps réel :
- * - Le thread de TX USB doit avoir une priorité **au moins égale ou supérieure à l’UI**.
- * - Les callbacks d’USB doivent rester **courts** (signalement de sémaphore/flags uniquement).
+ * - Aucun thread ni sémaphore côté USB TX : aucune attente active pour les producteurs.
+ * - Les callbacks d’USB restent **courts** (une bascule de tampon au plus).
  * - Aucun appel bloquant en ISR ; pas d’allocations dynamiques à l’exécution.
  *
  * @note L’API publique est déclarée dans `midi.h`.
@@ -27,6 +35,8 @@
 #include "brick_config.h"
 #include "midi.h"
 #include "usbcfg.h"
+#include "midi_usb_tx_ring.h"
+#include "midi_din_out.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -41,22 +51,6 @@ extern volatile bool usb_midi_tx_ready;
 /*                         CONFIGURATION / ÉTAT                            */
 /* ====================================================================== */
 
-/**
- * @brief Priorité du thread de transmission USB-MIDI.
- * @details Doit être ≥ priorité UI pour garantir une latence stable des I/O.
- */
-#ifndef MIDI_USB_TX_PRIO
-#define MIDI_USB_TX_PRIO   (NORMALPRIO + 1)
-#endif
-
-/**
- * @brief Timeout d’attente du sémaphore TX en thread (ms).
- * @details Évite les blocages si l’hôte USB ne réarme pas l’endpoint.
- */
-#ifndef MIDI_USB_TX_WAIT_MS
-#define MIDI_USB_TX_WAIT_MS  2
-#endif
-
 /**
  * @brief Périphérique série utilisé pour la sortie DIN MIDI (UART2).
  * @details Mapping Nucleo-144 STM32F429ZI : PA2=TX, PA3=RX.
@@ -64,42 +58,33 @@ extern volatile bool usb_midi_tx_ready;
 #define MIDI_UART   &SD2   /* PA2=TX, PA3=RX */
 
 /**
- * @brief Taille de la file (mailbox) de messages USB-MIDI (en éléments de 32 bits).
- * @details Chaque élément correspond à un paquet USB-MIDI de 4 octets packé dans un `msg_t`.
+ * @brief Priorité du thread d’écriture DIN.
+ * @details Sous le thread séquenceur `clock_seq` (une rafale de tick est classée en entier), au-dessus de l’UI.
  */
-#define MIDI_USB_QUEUE_LEN   256
+#ifndef MIDI_DIN_TX_PRIO
+#define MIDI_DIN_TX_PRIO   (NORMALPRIO + 2)
+#endif
 
-/** @brief Mailbox de transmission USB-MIDI (producteur/consommateur). */
-static CCM_DATA mailbox_t midi_usb_mb;
-/** @brief Buffer circulaire pour la mailbox USB-MIDI. */
-static CCM_DATA msg_t     midi_usb_queue[MIDI_USB_QUEUE_LEN];
-static uint16_t  midi_usb_queue_fill = 0;
-static uint16_t  midi_usb_queue_high_water = 0;
+/**
+ * @brief Octets confiés à l’UART par écriture (≈ 320 µs par octet).
+ * @details Borne l’attente d’un message temps réel derrière des notes déjà écrites.
+ */
+#ifndef MIDI_DIN_TX_CHUNK
+#define MIDI_DIN_TX_CHUNK  6U
+#endif
 
-static inline void midi_usb_queue_increment(void) {
-  osalSysLock();
-  if (midi_usb_queue_fill < MIDI_USB_QUEUE_LEN) {
-    midi_usb_queue_fill++;
-    if (midi_usb_queue_fill > midi_usb_queue_high_water) {
-      midi_usb_queue_high_water = midi_usb_queue_fill;
-    }
-  }
-  osalSysUnlock();
-}
+#define MIDI_DIN_EVT_PUSH   EVENT_MASK(0)  /**< Message déposé dans l’étage DIN */
+#define MIDI_DIN_EVT_EMPTY  EVENT_MASK(1)  /**< File de sortie UART vide */
 
-static inline void midi_usb_queue_decrement(void) {
-  osalSysLock();
-  if (midi_usb_queue_fill > 0U) {
-    midi_usb_queue_fill--;
-  }
-  osalSysUnlock();
-}
+/** @brief Étage de sortie DIN (protégé par section critique). */
+static CCM_DATA midi_din_out_t midi_din;
+static thread_t *s_din_thread = NULL;
+/** @brief Bloc tiré de l’étage mais pas encore écrit dans l’UART (ordre des octets temps réel). */
+static bool s_din_inflight = false;
+static CCM_DATA THD_WORKING_AREA(waMidiDinTx, 256);
 
-/**
- * @brief Sémaphore “endpoint libre”.
- * @details Signalé dans le callback d’EP IN (ex. `ep2_in_cb()` côté `usbcfg.c`).
- */
-binary_semaphore_t tx_sem;
+/** @brief File d’émission USB-MIDI (double tampon, écrite par les producteurs, vidée par l’ISR EP2 IN). */
+static CCM_DATA midi_usb_tx_ring_t midi_usb_tx;
 
 /** @brief Statistiques globales de transmission MIDI (USB/DIN). */
 midi_tx_stats_t midi_tx_stats = {0};
@@ -119,81 +104,38 @@ midi_tx_stats_t midi_tx_stats = {0};
 #endif
 
 /* ====================================================================== */
-/*                        THREAD DE TRANSMISSION USB                      */
+/*                        THREAD D’ÉCRITURE DIN                           */
 /* ====================================================================== */
 
 /**
- * @brief Zone de travail du thread de transmission USB-MIDI.
+ * @brief Thread d’écriture DIN : un bloc de @ref MIDI_DIN_TX_CHUNK octets
+ *        chaque fois que la file de sortie UART est vide.
  */
-static CCM_DATA THD_WORKING_AREA(waMidiUsbTx, 512);
-
-/**
- * @brief Thread d’agrégation et d’envoi USB-MIDI.
- *
- * Récupère des paquets USB-MIDI (4 octets packés dans un `msg_t`) depuis
- * la mailbox @ref midi_usb_mb, les agrège dans un buffer de 64 octets et
- * déclenche `usbStartTransmitI()` sur EP IN (EP2).
- *
- * Politique de robustesse :
- * - Si l’USB n’est pas prêt, les paquets sont comptabilisés en
- *   @ref midi_tx_stats.usb_not_ready_drops.
- * - Si le sémaphore n’est pas obtenu dans @ref MIDI_USB_TX_WAIT_MS ms,
- *   le lot courant est **abandonné** (drop contrôlé) pour éviter tout blocage.
- *
- * @param arg Argument inutilisé.
- */
-static THD_FUNCTION(thdMidiUsbTx, arg) {
+static THD_FUNCTION(thdMidiDinTx, arg) {
   (void)arg;
 #if CH_CFG_USE_REGISTRY
-  chRegSetThreadName("MIDI_USB_TX");
+  chRegSetThreadName("MIDI_DIN_TX");
 #endif
-  uint8_t buf[64];
-  size_t n = 0;
+  event_listener_t el;
+  chEvtRegisterMaskWithFlags(chnGetEventSource(MIDI_UART), &el, MIDI_DIN_EVT_EMPTY, CHN_OUTPUT_EMPTY);
 
+  uint8_t chunk[MIDI_DIN_TX_CHUNK];
   while (true) {
-    msg_t msg;
-    msg_t res = chMBFetchTimeout(&midi_usb_mb, &msg, TIME_MS2I(1));
-
-    if (res == MSG_OK) {
-      midi_usb_queue_decrement();
-      buf[n++] = (uint8_t)((msg >> 24) & 0xFF);
-      buf[n++] = (uint8_t)((msg >> 16) & 0xFF);
-      buf[n++] = (uint8_t)((msg >> 8)  & 0xFF);
-      buf[n++] = (uint8_t)( msg        & 0xFF);
-
-      if (n == sizeof(buf)) {
-        if (usb_midi_tx_ready) {
-          const systime_t tw = TIME_MS2I(MIDI_USB_TX_WAIT_MS);
-          if (chBSemWaitTimeout(&tx_sem, tw) == MSG_OK) {
-            osalSysLock();
-            usbStartTransmitI(&USBD1, MIDI_EP_IN, buf, n);
-            osalSysUnlock();
-            midi_tx_stats.tx_sent_batched++;
-          } else {
-            /* Endpoint non réarmé à temps : abandon contrôlé du lot. */
-            midi_tx_stats.usb_not_ready_drops += n / 4;
-          }
-        } else {
-          midi_tx_stats.usb_not_ready_drops += n / 4;
-        }
-        n = 0;
-      }
-    } else if (n > 0) {
-      /* Flush du lot partiel après courte période d'inactivité. */
-      if (usb_midi_tx_ready) {
-        const systime_t tw = TIME_MS2I(MIDI_USB_TX_WAIT_MS);
-        if (chBSemWaitTimeout(&tx_sem, tw) == MSG_OK) {
-          osalSysLock();
-          usbStartTransmitI(&USBD1, MIDI_EP_IN, buf, n);
-          osalSysUnlock();
-          midi_tx_stats.tx_sent_batched++;
-        } else {
-          midi_tx_stats.usb_not_ready_drops += n / 4;
-        }
-      } else {
-        midi_tx_stats.usb_not_ready_drops += n / 4;
-      }
-      n = 0;
+    (void)chEvtWaitAnyTimeout(MIDI_DIN_EVT_PUSH | MIDI_DIN_EVT_EMPTY, TIME_MS2I(10));
+    (void)chEvtGetAndClearFlags(&el);
+
+    size_t n = 0U;
+    osalSysLock();
+    if (oqIsEmptyI(&(MIDI_UART)->oqueue)) {
+      n = midi_din_out_drain(&midi_din, chunk, sizeof(chunk));
+      s_din_inflight = (n != 0U);
+    }
+    osalSysUnlock();
+    if (n != 0U) {
+      sdWrite(MIDI_UART, chunk, n);
+      osalSysLock();
+      s_din_inflight = false;
+      osalSysUnlock();
     }
   }
 }
@@ -205,20 +147,16 @@ static THD_FUNCTION(thdMidiUsbTx, arg) {
 /**
  * @brief Initialise le sous-système MIDI.
  *
- * - Configure l’UART DIN à 31250 bauds,
- * - Initialise la mailbox et son buffer circulaire,
- * - Initialise le sémaphore d’EP libre,
- * - Démarre le thread de transmission USB-MIDI.
+ * - Configure l’UART DIN à 31250 bauds et démarre le thread d’écriture DIN,
+ * - Vide la file d’émission USB (endpoint considéré libre).
  */
 void midi_init(void) {
   static const SerialConfig uart_cfg = { 31250, 0, 0, 0 };
   sdStart(MIDI_UART, &uart_cfg);
-  midi_usb_queue_fill = 0;
-  midi_usb_queue_high_water = 0;
-  chMBObjectInit(&midi_usb_mb, midi_usb_queue, MIDI_USB_QUEUE_LEN);
-  chBSemObjectInit(&tx_sem, true);
-  chThdCreateStatic(waMidiUsbTx, sizeof(waMidiUsbTx),
-                    MIDI_USB_TX_PRIO, thdMidiUsbTx, NULL);
+  midi_din_out_init(&midi_din);
+  s_din_thread = chThdCreateStatic(waMidiDinTx, sizeof(waMidiDinTx),
+                                   MIDI_DIN_TX_PRIO, thdMidiDinTx, NULL);
+  midi_usb_tx_ring_reset(&midi_usb_tx);
 }
 
 /* ====================================================================== */
@@ -226,61 +164,81 @@ void midi_init(void) {
 /* ====================================================================== */
 
 /**
- * @brief Envoie un message brut sur la sortie DIN (UART).
+ * @brief Dépose un message dans l’étage DIN et réveille le thread d’écriture.
  * @param msg Pointeur sur les octets du message MIDI.
  * @param len Longueur en octets du message.
  */
-static void send_uart(const uint8_t *msg, size_t len) { sdWrite(MIDI_UART, msg, len); }
+static void send_uart(const uint8_t *msg, size_t len) {
+  osalSysLock();
+  const bool queued = midi_din_out_push(&midi_din, msg, len);
+  osalSysUnlock();
+  if (queued && (s_din_thread != NULL)) {
+    chEvtSignal(s_din_thread, MIDI_DIN_EVT_PUSH);
+  }
+}
+
+/* ====================================================================== */
+/*                       TRANSMISSION USB (PROTOCOLE)                     */
+/* ====================================================================== */
 
 /**
- * @brief Poste un paquet USB-MIDI (4 octets packés) dans la mailbox, sinon le supprime.
- *
- * @param m Paquet USB-MIDI encodé dans un `msg_t` (octet 0 dans bits 31..24).
- * @param force_drop_oldest Si vrai, retire le plus ancien élément de la mailbox
- *                          pour insérer le nouveau (politique “drop-oldest”).
- *                          Sinon, le paquet courant est perdu si la file est pleine.
+ * @brief Démarre un transfert EP2 IN sur un tampon de la file (appelant : thread).
  */
-static void post_mb_or_drop(msg_t m, bool force_drop_oldest) {
-  if (chMBPostTimeout(&midi_usb_mb, m, TIME_IMMEDIATE) != MSG_OK) {
-    if (force_drop_oldest || MIDI_MB_DROP_OLDEST) {
-      msg_t throwaway;
-      if (chMBFetchTimeout(&midi_usb_mb, &throwaway, TIME_IMMEDIATE) == MSG_OK) {
-        midi_usb_queue_decrement();
-      }
-      if (chMBPostTimeout(&midi_usb_mb, m, TIME_IMMEDIATE) != MSG_OK)
-        midi_tx_stats.tx_mb_drops++;
-      else
-        midi_usb_queue_increment();
-    } else {
-      midi_tx_stats.tx_mb_drops++;
-    }
-  } else {
-    midi_usb_queue_increment();
-  }
+static void usb_start_transmit(const uint8_t *buf, size_t len) {
+  osalSysLock();
+  usbStartTransmitI(&USBD1, MIDI_EP_IN, buf, len);
+  osalSysUnlock();
 }
 
 /**
- * @brief Micro-attente maximale (µs) tolérée pour envoyer une Note (endpoint opportuniste).
- * @details Si l’EP n’est pas saisi dans ce délai, le paquet partira via la mailbox (agrégé).
+ * @brief Dépose un paquet USB-MIDI dans la file d’émission.
+ *
+ * - USB non configuré : paquet perdu (@ref midi_tx_stats.usb_not_ready_drops),
+ * - endpoint libre : transfert démarré immédiatement (`tx_sent_immediate`),
+ * - endpoint occupé : paquet groupé avec les suivants, parti à la fin du
+ *   transfert en cours (`rt_other_enq_fallback` pour les Realtime hors F8),
+ * - tampon plein : paquet perdu (`rt_f8_drops` pour F8, sinon `tx_mb_drops`).
+ *
+ * @param from_isr true depuis une ISR, appelant sous `chSysLockFromISR()`.
  */
-#ifndef MIDI_NOTE_MICROWAIT_US
-#define MIDI_NOTE_MICROWAIT_US  80
-#endif
+static void usb_enqueue(const uint8_t packet[4], bool from_isr) {
+  if (!usb_midi_tx_ready) {
+    midi_tx_stats.usb_not_ready_drops++;
+    return;
+  }
 
-/* ====================================================================== */
-/*                       TRANSMISSION USB (PROTOCOLE)                     */
-/* ====================================================================== */
+  const uint8_t *tx_buf = NULL;
+  size_t tx_len = 0U;
+  switch (midi_usb_tx_ring_push(&midi_usb_tx, packet, &tx_buf, &tx_len)) {
+    case MIDI_USB_TX_START:
+      if (from_isr) {
+        usbStartTransmitI(&USBD1, MIDI_EP_IN, tx_buf, tx_len);
+      } else {
+        usb_start_transmit(tx_buf, tx_len);
+      }
+      midi_tx_stats.tx_sent_immediate++;
+      break;
+    case MIDI_USB_TX_QUEUED:
+      if ((packet[1] >= 0xF9U) && (packet[1] != 0xFDU)) {
+        midi_tx_stats.rt_other_enq_fallback++;
+      }
+      break;
+    case MIDI_USB_TX_FULL:
+    default:
+      if (packet[1] == 0xF8U) {
+        midi_tx_stats.rt_f8_drops++;
+      } else {
+        midi_tx_stats.tx_mb_drops++;
+      }
+      break;
+  }
+}
 
 /**
- * @brief Construit un paquet USB-MIDI (4 octets) et déclenche son envoi.
+ * @brief Construit un paquet USB-MIDI (4 octets) et le dépose dans la file d’émission.
  *
- * Règles principales :
- * - Mappage correct du **CIN** selon le type de message (NoteOn=0x9, CC=0xB, Realtime=0xF, etc.),
- * - Zéro-padding pour les messages courts (1 ou 2 octets),
- * - Priorité aux **Realtime** :
- *   - `0xF8` (Clock) : micro-attente plus longue pour envoi immédiat si possible,
- *   - `FA/FB/FC/FE/FF` : micro-attente courte, sinon fallback mailbox avec politique configurable,
- * - Pour les **Notes** : petite fenêtre d’envoi direct (`MIDI_NOTE_MICROWAIT_US`), sinon agrégation.
+ * Mappage du **CIN** selon le type de message (NoteOn=0x9, CC=0xB, Realtime=0xF, etc.)
+ * et zéro-padding pour les messages courts (1 ou 2 octets).
  *
  * @param msg Pointeur vers le message MIDI (status + data).
  * @param len Taille du message en octets (1 à 3 selon le type).
@@ -290,11 +248,9 @@ static void send_usb(const uint8_t *msg, size_t len) {
   const uint8_t st = msg[0];
   const uint8_t cable = (uint8_t)(MIDI_USB_CABLE<<4);
 
-  bool is_note=false;
-
   /* Channel Voice */
-  if ((st & 0xF0)==0x80 && len>=3){ packet[0]=cable|0x08; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; is_note=true; }
-  else if ((st & 0xF0)==0x90 && len>=3){ packet[0]=cable|0x09; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; is_note=true; }
+  if ((st & 0xF0)==0x80 && len>=3){ packet[0]=cable|0x08; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; }
+  else if ((st & 0xF0)==0x90 && len>=3){ packet[0]=cable|0x09; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; }
   else if ((st & 0xF0)==0xA0 && len>=3){ packet[0]=cable|0x0A; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; }
   else if ((st & 0xF0)==0xB0 && len>=3){ packet[0]=cable|0x0B; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; }
   else if ((st & 0xF0)==0xE0 && len>=3){ packet[0]=cable|0x0E; packet[1]=msg[0]; packet[2]=msg[1]; packet[3]=msg[2]; }
@@ -308,51 +264,11 @@ static void send_usb(const uint8_t *msg, size_t len) {
   else if (st==0xF6){          packet[0]=cable|0x0F; packet[1]=0xF6; }
 
   /* Realtime */
-  else if (st>=0xF8){
-    packet[0]=cable|0x0F; packet[1]=st;
-
-    if (st==0xF8){
-      systime_t tw=TIME_US2I(1000);
-      if (usb_midi_tx_ready && chBSemWaitTimeout(&tx_sem, tw)==MSG_OK){
-        osalSysLock(); usbStartTransmitI(&USBD1, MIDI_EP_IN, packet, 4); osalSysUnlock();
-        midi_tx_stats.tx_sent_immediate++;
-      } else {
-        msg_t m=((msg_t)packet[0]<<24)|((msg_t)packet[1]<<16)|((msg_t)packet[2]<<8)|packet[3];
-        post_mb_or_drop(m,false);
-      }
-      return;
-    }
-
-    if (st==0xFA || st==0xFB || st==0xFC || st==0xFE || st==0xFF){
-      systime_t tw=TIME_US2I(50);
-      if (usb_midi_tx_ready && chBSemWaitTimeout(&tx_sem, tw)==MSG_OK){
-        osalSysLock(); usbStartTransmitI(&USBD1, MIDI_EP_IN, packet, 4); osalSysUnlock();
-        midi_tx_stats.tx_sent_immediate++;
-      } else {
-        midi_tx_stats.rt_other_enq_fallback++;
-        msg_t m=((msg_t)packet[0]<<24)|((msg_t)packet[1]<<16)|((msg_t)packet[2]<<8)|packet[3];
-        post_mb_or_drop(m,true);
-      }
-      return;
-    }
-
-    msg_t m3=((msg_t)packet[0]<<24)|((msg_t)packet[1]<<16)|((msg_t)packet[2]<<8)|packet[3];
-    post_mb_or_drop(m3,false);
-    return;
-  }
+  else if (st>=0xF8){          packet[0]=cable|0x0F; packet[1]=st; }
 
   else { packet[0]=cable|0x0F; packet[1]=len>0?msg[0]:0; packet[2]=len>1?msg[1]:0; packet[3]=len>2?msg[2]:0; }
 
-  if (is_note){
-    const systime_t tw=TIME_US2I(MIDI_NOTE_MICROWAIT_US);
-    if (usb_midi_tx_ready && chBSemWaitTimeout(&tx_sem, tw)==MSG_OK){
-      osalSysLock(); usbStartTransmitI(&USBD1, MIDI_EP_IN, packet, 4); osalSysUnlock();
-      midi_tx_stats.tx_sent_immediate++; return;
-    }
-  }
-
-  msg_t m=((msg_t)packet[0]<<24)|((msg_t)packet[1]<<16)|((msg_t)packet[2]<<8)|packet[3];
-  post_mb_or_drop(m,false);
+  usb_enqueue(packet, false);
 }
 
 /* ====================================================================== */
@@ -444,6 +360,23 @@ void midi_clock(midi_dest_t d){
   midi_send(MIDI_DEST_BOTH,m,1);
 }
 
+void midi_clock_i(void){
+  static const uint8_t f8 = 0xF8;
+  static const uint8_t usb_f8[4] = { (uint8_t)((MIDI_USB_CABLE<<4)|0x0F), 0xF8, 0, 0 };
+
+  /* DIN : octet écrit dans la file UART, devant le prochain bloc de l’étage.
+     Un temps réel encore dans l’étage (ou dans le bloc en cours d’écriture)
+     garde la priorité : le F8 le suit alors par l’étage. */
+  output_queue_t *oqp = &(MIDI_UART)->oqueue;
+  if (!s_din_inflight && !oqIsFullI(oqp) && midi_din_out_bypass(&midi_din)) {
+    (void)oqPutI(oqp, f8);  /* q_notify arme l’interruption TX de l’UART */
+  } else if (midi_din_out_push(&midi_din, &f8, 1U) && (s_din_thread != NULL)) {
+    chEvtSignalI(s_din_thread, MIDI_DIN_EVT_PUSH);
+  }
+
+  usb_enqueue(usb_f8, true);
+}
+
 void midi_start(midi_dest_t d){
   (void)d;
   uint8_t m[1]={0xFA};
@@ -465,6 +398,11 @@ void midi_stop(midi_dest_t d){
   send_uart(m,1);
 }
 
+void midi_din_probe(void){
+  static const uint8_t f9 = 0xF9;
+  send_uart(&f9, 1U);
+}
+
 void midi_active_sensing(midi_dest_t d){
   (void)d;
   uint8_t m[1]={0xFE};
@@ -519,8 +457,35 @@ void midi_poly_mode_on(midi_dest_t dest, uint8_t ch) {
   midi_channel_mode_cc(dest, ch, 127U, 0U);
 }
 
+void midi_din_step_mark(uint32_t step_us) {
+  osalSysLock();
+  midi_din_out_step_mark(&midi_din, step_us);
+  osalSysUnlock();
+}
+
+const midi_din_out_stats_t *midi_din_get_stats(void) {
+  return &midi_din.stats;
+}
+
 uint16_t midi_usb_queue_high_watermark(void) {
-  return midi_usb_queue_high_water;
+  return midi_usb_tx.high_water;
+}
+
+/* ====================================================================== */
+/*                        INTERFACE ENDPOINT (usbcfg.c)                   */
+/* ====================================================================== */
+
+void midi_usb_tx_complete_i(void) {
+  const uint8_t *tx_buf = NULL;
+  size_t tx_len = 0U;
+  if (midi_usb_tx_ring_complete(&midi_usb_tx, &tx_buf, &tx_len)) {
+    usbStartTransmitI(&USBD1, MIDI_EP_IN, tx_buf, tx_len);
+    midi_tx_stats.tx_sent_batched++;
+  }
+}
+
+void midi_usb_tx_reset_i(void) {
+  midi_usb_tx_ring_abort(&midi_usb_tx);
 }
 
 /**
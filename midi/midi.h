@@ -23,27 +23,12 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "midi_din_out.h"
+
 /* ====================================================================== */
 /*                        CONFIGURATION GLOBALE                           */
 /* ====================================================================== */
 
-/**
- * @brief Comportement en cas de débordement de la file d’attente USB MIDI.
- *
- * Si défini à 1, le message le plus ancien est supprimé pour insérer le nouveau.
- * Sinon, le nouveau message est perdu.
- */
-#ifndef MIDI_MB_DROP_OLDEST
-#define MIDI_MB_DROP_OLDEST  0
-#endif
-
-/**
- * @brief Délai (en µs) avant de relâcher le sémaphore d’envoi pour les messages temps réel.
- */
-#ifndef MIDI_RT_MICROWAIT_US
-#define MIDI_RT_MICROWAIT_US 50
-#endif
-
 /**
  * @brief Numéro de câble USB MIDI (0 pour unique interface).
  */
@@ -71,12 +56,11 @@ typedef enum {
  * @brief Statistiques de transmission MIDI (pour diagnostic et debug).
  */
 typedef struct {
-  volatile uint32_t tx_sent_immediate;      /**< Messages envoyés immédiatement (EP libre) */
-  volatile uint32_t tx_sent_batched;        /**< Messages regroupés et envoyés par lot */
+  volatile uint32_t tx_sent_immediate;      /**< Transferts démarrés par un producteur (EP libre) */
+  volatile uint32_t tx_sent_batched;        /**< Transferts enchaînés par le callback EP2 IN (lot) */
   volatile uint32_t rt_f8_drops;            /**< Messages Clock (0xF8) perdus faute de place */
-  volatile uint32_t rt_f8_burst_sent;       /**< Groupes de messages Clock envoyés en rafale */
-  volatile uint32_t rt_other_enq_fallback;  /**< Autres messages temps réel mis en file (fallback) */
-  volatile uint32_t tx_mb_drops;            /**< Messages perdus (mailbox pleine) */
+  volatile uint32_t rt_other_enq_fallback;  /**< Autres messages temps réel mis en attente (EP occupé) */
+  volatile uint32_t tx_mb_drops;            /**< Messages perdus (tampon USB plein) */
   volatile uint32_t usb_not_ready_drops;    /**< Messages perdus (USB non prêt) */
 } midi_tx_stats_t;
 
@@ -88,10 +72,12 @@ extern midi_tx_stats_t midi_tx_stats;
 /* ====================================================================== */
 
 /**
- * @brief Initialise le module MIDI (UART + thread TX USB).
+ * @brief Initialise le module MIDI (UART + file d’émission USB).
  *
- * Configure le port UART DIN à 31250 bauds, initialise la mailbox et crée
- * le thread responsable de l’envoi USB.
+ * Configure le port UART DIN à 31250 bauds, démarre le thread d’écriture
+ * de l’étage DIN et vide la file d’émission
+ * USB à double tampon (aucun thread : l’envoi est piloté par les producteurs
+ * et le callback de fin de transfert EP2 IN).
  */
 void midi_init(void);
 
@@ -153,6 +139,12 @@ void midi_tune_request(midi_dest_t dest);
 /* ====================================================================== */
 
 void midi_clock(midi_dest_t dest);
+/**
+ * @brief Envoie un Clock (F8) vers DIN et USB depuis une ISR.
+ * @details Contexte I-Class (appelant sous `chSysLockFromISR()`) : aucun
+ *          réveil de thread sur le chemin normal, le F8 part avec l’interruption.
+ */
+void midi_clock_i(void);
 void midi_start(midi_dest_t dest);
 void midi_continue(midi_dest_t dest);
 void midi_stop(midi_dest_t dest);
@@ -181,7 +173,35 @@ void midi_poly_mode_on(midi_dest_t dest, uint8_t ch);
  */
 void midi_stats_reset(void);
 
-/** @brief Retourne le plus haut niveau de remplissage observé sur la mailbox USB. */
+/**
+ * @brief Clôt la fenêtre d’émission DIN du step précédent (budget par step).
+ * @param step_us Durée du step qui commence, en microsecondes.
+ * @note Appelée au début de chaque step (callback horloge).
+ */
+void midi_din_step_mark(uint32_t step_us);
+
+/** @brief Statistiques de l’étage DIN (octets, running status, dépassements par step). */
+const midi_din_out_stats_t *midi_din_get_stats(void);
+
+/** @brief Retourne le plus haut nombre de paquets USB en attente + en vol observé. */
 uint16_t midi_usb_queue_high_watermark(void);
 
+/**
+ * @brief Émet une sonde de calibration (octet non défini F9) sur la sortie DIN seule.
+ * @details Passe par l’étage DIN comme une note : l’aller-retour mesuré par
+ *          bouclage OUT → IN inclut donc la file d’émission. Les récepteurs
+ *          ignorent F9 (temps réel réservé).
+ */
+void midi_din_probe(void);
+
+/* ====================================================================== */
+/*                        INTERFACE ENDPOINT (usbcfg.c)                   */
+/* ====================================================================== */
+
+/** Fin de transfert EP2 IN : enchaîne le tampon rempli (contexte ISR, verrou I-Class pris). */
+void midi_usb_tx_complete_i(void);
+
+/** Configuration USB : abandonne la file d’émission et libère l’endpoint (contexte I-Class). */
+void midi_usb_tx_reset_i(void);
+
 #endif /* MIDI_H */
@@ -0,0 +1,209 @@
+/**
+ * @file midi_din_out.c
+ * @brief Étage de sortie DIN : classement, running status, budget par step.
+ *
+ * @ingroup drivers
+ */
+
+#include "midi_din_out.h"
+
+#include <string.h>
+
+_Static_assert(MIDI_DIN_OUT_QUEUE_LEN <= 255U, "MIDI_DIN_OUT_QUEUE_LEN doit tenir sur 8 bits");
+
+/* ====================================================================== */
+/*                              CLASSEMENT                                */
+/* ====================================================================== */
+
+static midi_din_prio_t classify(const uint8_t *msg, size_t len) {
+  const uint8_t st = msg[0];
+  if ((st >= 0xF8U) || (st == 0xF2U) || (st == 0xF3U)) {
+    return MIDI_DIN_PRIO_REALTIME; /* SPP / Song Select : position posée avant le Continue */
+  }
+  if (len < 3U) {
+    return MIDI_DIN_PRIO_OTHER;
+  }
+  switch (st & 0xF0U) {
+    case 0x80:
+      return MIDI_DIN_PRIO_NOTE_OFF;
+    case 0x90:
+      return (msg[2] == 0U) ? MIDI_DIN_PRIO_NOTE_OFF : MIDI_DIN_PRIO_NOTE_ON;
+    default:
+      return MIDI_DIN_PRIO_OTHER;
+  }
+}
+
+/** Statut effectivement émis : NOTE_OFF à vélocité neutre → NOTE_ON vélocité 0. */
+static uint8_t wire_status(const midi_din_msg_t *m) {
+  const uint8_t st = m->bytes[0];
+  if (((st & 0xF0U) == 0x80U) && ((m->bytes[2] == 0U) || (m->bytes[2] == 64U))) {
+    return (uint8_t)(0x90U | (st & 0x0FU));
+  }
+  return st;
+}
+
+/** Canal d’un message Channel Voice, 0xFF pour un message système. */
+static uint8_t msg_channel(uint8_t status) {
+  return (status < 0xF0U) ? (uint8_t)(status & 0x0FU) : 0xFFU;
+}
+
+/**
+ * @brief Choisit le prochain message d’une classe.
+ *
+ * Plus ancien message du canal du running status (les voix d’une piste
+ * s’enchaînent sans octet de statut), sinon tête de file. Aucun message
+ * n’est avancé devant un message antérieur du même canal ni devant un
+ * message système.
+ */
+static uint8_t pick(const midi_din_out_t *o, midi_din_prio_t prio) {
+  const uint8_t n = o->count[prio];
+  if ((o->running == 0U) || (prio == MIDI_DIN_PRIO_REALTIME)) {
+    return 0U;
+  }
+  const uint8_t run_ch = msg_channel(o->running);
+  for (uint8_t i = 0U; i < n; ++i) {
+    const uint8_t ch = msg_channel(o->q[prio][i].bytes[0]);
+    if (ch == run_ch) {
+      return i; /* plus ancien du canal courant : ordre par canal préservé */
+    }
+    if (ch == 0xFFU) {
+      break;    /* un message système n’est jamais devancé */
+    }
+  }
+  return 0U;
+}
+
+/** true si un NOTE_ON de même canal et même note attend encore dans sa classe. */
+static bool has_pending_note_on(const midi_din_out_t *o, const uint8_t *off) {
+  const uint8_t ch = (uint8_t)(off[0] & 0x0FU);
+  for (uint8_t i = 0U; i < o->count[MIDI_DIN_PRIO_NOTE_ON]; ++i) {
+    const midi_din_msg_t *m = &o->q[MIDI_DIN_PRIO_NOTE_ON][i];
+    if ((m->bytes[0] == (uint8_t)(0x90U | ch)) && (m->bytes[1] == off[1])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* ====================================================================== */
+/*                              API                                       */
+/* ====================================================================== */
+
+void midi_din_out_init(midi_din_out_t *o) {
+  memset(o, 0, sizeof(*o));
+}
+
+bool midi_din_out_push(midi_din_out_t *o, const uint8_t *msg, size_t len) {
+  if ((msg == NULL) || (len == 0U) || (len > 3U)) {
+    return false;
+  }
+  midi_din_prio_t prio = classify(msg, len);
+  if ((prio == MIDI_DIN_PRIO_NOTE_OFF) && has_pending_note_on(o, msg)) {
+    prio = MIDI_DIN_PRIO_NOTE_ON; /* ne jamais devancer le NOTE_ON qu’il relâche */
+  }
+  if (o->count[prio] >= MIDI_DIN_OUT_QUEUE_LEN) {
+    o->stats.drops++;
+    return false;
+  }
+  midi_din_msg_t *m = &o->q[prio][o->count[prio]++];
+  memset(m, 0, sizeof(*m));
+  m->len = (uint8_t)len;
+  memcpy(m->bytes, msg, len);
+  return true;
+}
+
+size_t midi_din_out_drain(midi_din_out_t *o, uint8_t *out, size_t cap) {
+  size_t n = 0U;
+
+  for (;;) {
+    midi_din_prio_t prio = MIDI_DIN_PRIO_COUNT;
+    for (uint8_t p = 0U; p < (uint8_t)MIDI_DIN_PRIO_COUNT; ++p) {
+      if (o->count[p] != 0U) {
+        prio = (midi_din_prio_t)p;
+        break;
+      }
+    }
+    if (prio == MIDI_DIN_PRIO_COUNT) {
+      if (n == 0U) {
+        o->running = 0U; /* fil inactif : statut réémis au prochain message */
+      }
+      break;
+    }
+
+    const uint8_t idx = pick(o, prio);
+    const midi_din_msg_t *m = &o->q[prio][idx];
+    const uint8_t st = wire_status(m);
+    const bool realtime = (st >= 0xF8U);
+    const bool omit = !realtime && (st < 0xF0U) && (st == o->running);
+    const size_t need = (size_t)m->len - (omit ? 1U : 0U);
+    if ((n + need) > cap) {
+      break;
+    }
+
+    if (!omit) {
+      out[n++] = st;
+    } else {
+      o->stats.bytes_saved++;
+    }
+    for (uint8_t i = 1U; i < m->len; ++i) {
+      out[n++] = m->bytes[i];
+    }
+    if (st != m->bytes[0]) {
+      out[n - 1U] = 0U; /* NOTE_OFF → NOTE_ON vélocité 0 */
+      o->stats.off_as_on++;
+    }
+
+    if (!realtime) {
+      /* Le temps réel ne touche pas au running status ; System Common l’annule. */
+      o->running = (st < 0xF0U) ? st : 0U;
+    }
+    o->stats.messages++;
+
+    const uint8_t remaining = (uint8_t)(o->count[prio] - idx - 1U);
+    if (remaining != 0U) {
+      memmove(&o->q[prio][idx], &o->q[prio][idx + 1U], (size_t)remaining * sizeof(midi_din_msg_t));
+    }
+    o->count[prio]--;
+  }
+
+  o->stats.bytes += (uint32_t)n;
+  o->step_bytes += (uint32_t)n;
+  return n;
+}
+
+size_t midi_din_out_pending(const midi_din_out_t *o) {
+  size_t total = 0U;
+  for (uint8_t p = 0U; p < (uint8_t)MIDI_DIN_PRIO_COUNT; ++p) {
+    total += o->count[p];
+  }
+  return total;
+}
+
+void midi_din_out_step_mark(midi_din_out_t *o, uint32_t step_us) {
+  const uint32_t backlog = (uint32_t)midi_din_out_pending(o);
+  if (o->stats.step_capacity != 0U) {
+    o->stats.step_bytes_last = o->step_bytes;
+    if (o->step_bytes > o->stats.step_bytes_max) {
+      o->stats.step_bytes_max = o->step_bytes;
+    }
+    o->stats.step_backlog_last = backlog;
+    if (backlog > o->stats.step_backlog_max) {
+      o->stats.step_backlog_max = backlog;
+    }
+    if (backlog != 0U) {
+      o->stats.step_overruns++;
+    }
+  }
+  o->step_bytes = 0U;
+  o->stats.step_capacity = (uint32_t)(((uint64_t)step_us * MIDI_DIN_BYTES_PER_SEC) / 1000000U);
+}
+
+bool midi_din_out_bypass(midi_din_out_t *o) {
+  if (o->count[MIDI_DIN_PRIO_REALTIME] != 0U) {
+    return false;
+  }
+  o->stats.messages++;
+  o->stats.bytes++;
+  o->step_bytes++;
+  return true;
+}
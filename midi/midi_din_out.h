@@ -0,0 +1,130 @@
+/**
+ * @file midi_din_out.h
+ * @brief Étage de sortie DIN : priorités, running status et budget par step.
+ *
+ * À 31250 bauds un octet occupe 320 µs : une rafale de step (16 pistes ×
+ * 4 voix, OFF + ON) dépasse facilement plusieurs dizaines de millisecondes.
+ * Cet étage réduit le nombre d’octets et ordonne l’émission :
+ * - **priorités** : temps réel, puis NOTE_OFF, puis NOTE_ON, puis CC et autres ;
+ *   SPP (F2) et Song Select (F3) voyagent avec le temps réel, dans l’ordre de
+ *   dépôt : un Continue ne devance jamais la position qu’il reprend ;
+ * - **regroupement par canal** dans une même classe (le running status
+ *   s’enchaîne entre voix d’une même piste), ordre FIFO conservé par canal ;
+ * - **running status** : l’octet de statut est omis s’il est identique au précédent ;
+ * - **NOTE_OFF → NOTE_ON vélocité 0** lorsque la vélocité de relâchement est
+ *   neutre (0 ou 64), ce qui prolonge le running status des NOTE_ON ;
+ * - **budget par step** : octets émis entre deux steps, capacité du fil
+ *   (3125 octets/s × durée du step) ; un step dont les messages sont encore
+ *   en attente au step suivant est compté comme dépassement.
+ *
+ * Module sans dépendance RTOS (testé sur hôte, `tests/midi_din_out_tests.c`) ;
+ * `midi.c` le protège par une section critique et le vide depuis son thread DIN.
+ *
+ * @ingroup drivers
+ */
+
+#ifndef MIDI_DIN_OUT_H
+#define MIDI_DIN_OUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Capacité de chaque classe de priorité, en messages. */
+#ifndef MIDI_DIN_OUT_QUEUE_LEN
+#define MIDI_DIN_OUT_QUEUE_LEN 64U
+#endif
+
+/** @brief Débit du fil DIN en octets par seconde (31250 bauds, 10 bits/octet). */
+#define MIDI_DIN_BYTES_PER_SEC 3125U
+
+/** @brief Classes de priorité, de la plus urgente à la moins urgente. */
+typedef enum {
+  MIDI_DIN_PRIO_REALTIME = 0,  /**< F8, FA, FB, FC, FE, FF ; F2, F3 (position avant FA/FB) */
+  MIDI_DIN_PRIO_NOTE_OFF,      /**< 8n, ou 9n vélocité 0 */
+  MIDI_DIN_PRIO_NOTE_ON,       /**< 9n vélocité > 0 */
+  MIDI_DIN_PRIO_OTHER,         /**< CC, PB, PC, AT, autres System Common */
+  MIDI_DIN_PRIO_COUNT
+} midi_din_prio_t;
+
+/** @brief Message en attente (forme canonique, non compressée). */
+typedef struct {
+  uint8_t len;
+  uint8_t bytes[3];
+} midi_din_msg_t;
+
+/**
+ * @struct midi_din_out_stats_t
+ * @brief Statistiques de l’étage DIN (même esprit que `midi_tx_stats`).
+ */
+typedef struct {
+  volatile uint32_t messages;          /**< Messages émis */
+  volatile uint32_t bytes;             /**< Octets émis sur le fil */
+  volatile uint32_t bytes_saved;       /**< Octets de statut évités (running status) */
+  volatile uint32_t off_as_on;         /**< NOTE_OFF émis en NOTE_ON vélocité 0 */
+  volatile uint32_t drops;             /**< Messages perdus (classe pleine) */
+  volatile uint32_t step_bytes_last;   /**< Octets émis pendant le dernier step clos */
+  volatile uint32_t step_bytes_max;    /**< Maximum d’octets émis sur un step */
+  volatile uint32_t step_capacity;     /**< Capacité du fil sur le step courant (octets) */
+  volatile uint32_t step_backlog_last; /**< Messages encore en attente à la fin du dernier step */
+  volatile uint32_t step_backlog_max;  /**< Maximum de messages en attente à une fin de step */
+  volatile uint32_t step_overruns;     /**< Steps qui n’ont pas tenu dans la capacité du fil */
+} midi_din_out_stats_t;
+
+/** @brief État de l’étage de sortie. */
+typedef struct {
+  midi_din_msg_t q[MIDI_DIN_PRIO_COUNT][MIDI_DIN_OUT_QUEUE_LEN];
+  uint8_t        count[MIDI_DIN_PRIO_COUNT];
+  uint8_t        running;      /**< Running status courant sur le fil (0 si aucun) */
+  uint32_t       step_bytes;   /**< Octets émis depuis le dernier step */
+  midi_din_out_stats_t stats;
+} midi_din_out_t;
+
+/** Réinitialise l’étage (files vides, running status oublié, statistiques à zéro). */
+void midi_din_out_init(midi_din_out_t *o);
+
+/**
+ * @brief Dépose un message complet (1 à 3 octets) dans sa classe de priorité.
+ * @return false si la classe est pleine (perte comptée).
+ */
+bool midi_din_out_push(midi_din_out_t *o, const uint8_t *msg, size_t len);
+
+/**
+ * @brief Encode les messages les plus prioritaires dans @p out.
+ *
+ * S’arrête à une frontière de message dès que le suivant ne tient plus dans
+ * @p cap octets : un appel court laisse le temps réel passer devant.
+ * @return Nombre d’octets écrits (0 si rien n’est en attente).
+ */
+size_t midi_din_out_drain(midi_din_out_t *o, uint8_t *out, size_t cap);
+
+/** Nombre de messages en attente, toutes classes confondues. */
+size_t midi_din_out_pending(const midi_din_out_t *o);
+
+/**
+ * @brief Clôt la fenêtre du step précédent et ouvre la suivante.
+ * @param step_us Durée du step qui commence, en microsecondes (capacité du fil).
+ */
+void midi_din_out_step_mark(midi_din_out_t *o, uint32_t step_us);
+
+/**
+ * @brief Réserve l’émission directe d’un octet temps réel, hors de l’étage.
+ *
+ * Sert au F8 écrit depuis l’ISR du timer d’horloge. Refusée si un message
+ * temps réel (ou un SPP) attend encore dans l’étage : l’ordre F2 → FB → F8
+ * reste celui du dépôt.
+ * L’octet accepté est compté dans les statistiques et le budget du step ; le
+ * temps réel ne touche pas au running status.
+ * @return false si le message doit passer par `midi_din_out_push()`.
+ */
+bool midi_din_out_bypass(midi_din_out_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MIDI_DIN_OUT_H */
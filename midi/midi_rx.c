@@ -0,0 +1,259 @@
+/**
+ * @file midi_rx.c
+ * @brief Réception MIDI (USB + DIN) : files SPSC horodatées et dispatch.
+ *
+ * Contraintes temps réel :
+ * - Le callback EP1 OUT reste court : décodage de 16 paquets au plus,
+ *   push sans verrou, un `chBSemSignalI()`.
+ * - Le DIN passe par le driver série (`SD2`, déjà démarré par `midi_init()`,
+ *   dont l’ISR n’offre pas de point d’accroche par octet) : l’horodatage est
+ *   pris au réveil du thread de lecture, reculé d’un temps-octet (320 µs) par
+ *   octet déjà arrivé derrière celui lu. Voir le biais résiduel dans `midi_rx.h`.
+ * - Horodatages en µs (`hr_time_now()`, lisible depuis l’ISR USB).
+ * - Chaque file n’a qu’un producteur et qu’un consommateur.
+ *
+ * @ingroup drivers
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "brick_config.h"
+#include "midi.h"   /* MIDI_USB_CABLE */
+#include "midi_din_out.h" /* MIDI_DIN_BYTES_PER_SEC */
+#include "midi_rx.h"
+#include "stack_watch.h"
+
+/* ====================================================================== */
+/*                         CONFIGURATION / ÉTAT                            */
+/* ====================================================================== */
+
+/**
+ * @brief Priorité du thread de dispatch (alignée sur le thread séquenceur `clock_seq`).
+ */
+#ifndef MIDI_RX_DISPATCH_PRIO
+#define MIDI_RX_DISPATCH_PRIO (NORMALPRIO + 3)
+#endif
+
+/**
+ * @brief Priorité du thread de lecture DIN (au-dessus du dispatch : il horodate).
+ */
+#ifndef MIDI_RX_DIN_PRIO
+#define MIDI_RX_DIN_PRIO (NORMALPRIO + 4)
+#endif
+
+/** @brief Périphérique série de l’entrée DIN (UART2, PA3=RX). */
+#define MIDI_RX_UART (&SD2)
+
+/** @brief Durée d’un octet sur le fil DIN (µs). */
+#define MIDI_RX_DIN_BYTE_US (1000000U / MIDI_DIN_BYTES_PER_SEC)
+
+midi_rx_stats_t midi_rx_stats = {0};
+
+static CCM_DATA midi_rx_ring_t s_usb_ring;      /**< ISR USB → dispatch */
+static CCM_DATA midi_rx_ring_t s_din_ring;      /**< Lecture DIN → dispatch */
+static CCM_DATA midi_rx_ring_t s_channel_ring;  /**< Dispatch → thread UI */
+
+static midi_parser_t s_usb_parser;
+static midi_parser_t s_din_parser;
+
+static binary_semaphore_t s_rx_sem;
+static volatile bool      s_initialized = false;
+
+static midi_rx_realtime_cb_t s_realtime_cb = NULL;
+static midi_rx_spp_cb_t      s_spp_cb      = NULL;
+static midi_rx_probe_cb_t    s_probe_cb    = NULL;
+
+/* Esclave, le dispatch exécute l’horloge et tout le runner à chaque F8 : même
+ * pile que le thread séquenceur de `midi_clock.c`, plus l’analyse et le routage. */
+#ifndef MIDI_RX_DISPATCH_STACK_SIZE
+#define MIDI_RX_DISPATCH_STACK_SIZE 1792U
+#endif
+
+static CCM_DATA THD_WORKING_AREA(waMidiRxDispatch, MIDI_RX_DISPATCH_STACK_SIZE);
+static CCM_DATA THD_WORKING_AREA(waMidiRxDin, 256);
+
+/* ====================================================================== */
+/*                              ROUTAGE                                   */
+/* ====================================================================== */
+
+/**
+ * @brief Aiguille un message complet vers l’horloge ou la file canal.
+ */
+static void route_event(const midi_rx_event_t *ev) {
+  const uint8_t st = ev->status;
+
+  if (st >= 0xF8U) {
+    midi_rx_stats.realtime++;
+    if (s_realtime_cb) s_realtime_cb(st, ev->ts);
+    return;
+  }
+  if (st == 0xF2U) {
+    midi_rx_stats.realtime++;
+    if (s_spp_cb) s_spp_cb((uint16_t)(ev->data1 | ((uint16_t)ev->data2 << 7)));
+    return;
+  }
+  if (st == 0xF0U) {
+    midi_rx_stats.sysex++;
+    return;
+  }
+  if (st < 0xF0U) {
+    if (midi_rx_ring_push(&s_channel_ring, ev)) {
+      midi_rx_stats.channel++;
+    } else {
+      midi_rx_stats.ring_drops++;
+    }
+  }
+  /* Autres System Common (MTC, Song Select, Tune Request) : non utilisés. */
+}
+
+static void drain_ring(midi_rx_ring_t *ring) {
+  midi_rx_event_t ev;
+  while (midi_rx_ring_pop(ring, &ev)) {
+    route_event(&ev);
+  }
+}
+
+/* ====================================================================== */
+/*                              THREADS                                   */
+/* ====================================================================== */
+
+/**
+ * @brief Thread de dispatch : vide les files USB/DIN dès qu’un producteur signale.
+ */
+static THD_FUNCTION(thdMidiRxDispatch, arg) {
+  (void)arg;
+#if CH_CFG_USE_REGISTRY
+  chRegSetThreadName("MIDI_RX");
+#endif
+  while (true) {
+    (void)chBSemWaitTimeout(&s_rx_sem, TIME_MS2I(10));
+    drain_ring(&s_usb_ring);
+    drain_ring(&s_din_ring);
+  }
+}
+
+/**
+ * @brief Thread de lecture DIN : un réveil par octet, horodaté au réveil.
+ *
+ * Si le thread a pris du retard, les octets suivants attendent déjà dans la
+ * file du driver : l’octet lu est arrivé au moins un temps-octet avant chacun.
+ */
+static THD_FUNCTION(thdMidiRxDin, arg) {
+  (void)arg;
+#if CH_CFG_USE_REGISTRY
+  chRegSetThreadName("MIDI_DIN_RX");
+#endif
+  while (true) {
+    const msg_t c = chnGetTimeout(MIDI_RX_UART, TIME_INFINITE);
+    if (c < 0) {
+      continue;
+    }
+    chSysLock();
+    const uint32_t behind = (uint32_t)iqGetFullI(&(MIDI_RX_UART)->iqueue);
+    chSysUnlock();
+    const hr_time_t ts = hr_time_now() - (hr_time_t)(behind * MIDI_RX_DIN_BYTE_US);
+    midi_rx_stats.din_bytes++;
+    if (behind > midi_rx_stats.din_backlog_max) {
+      midi_rx_stats.din_backlog_max = behind;
+    }
+    if ((c == 0xF9) && (s_probe_cb != NULL)) {
+      s_probe_cb(ts);  /* écho de sonde : l’analyseur l’ignore de toute façon */
+    }
+
+    midi_rx_event_t ev[MIDI_PARSER_MAX_EVENTS];
+    const uint8_t n = midi_parser_feed(&s_din_parser, (uint8_t)c, ts, ev);
+    for (uint8_t k = 0U; k < n; ++k) {
+      if (!midi_rx_ring_push(&s_din_ring, &ev[k])) {
+        midi_rx_stats.ring_drops++;
+      }
+    }
+    if (n != 0U) {
+      chBSemSignal(&s_rx_sem);
+    }
+    midi_rx_stats.stray_bytes = s_usb_parser.stray_bytes + s_din_parser.stray_bytes;
+  }
+}
+
+/* ====================================================================== */
+/*                              API PUBLIQUE                              */
+/* ====================================================================== */
+
+void midi_rx_init(void) {
+  if (s_initialized) {
+    return;
+  }
+  midi_rx_ring_reset(&s_usb_ring);
+  midi_rx_ring_reset(&s_din_ring);
+  midi_rx_ring_reset(&s_channel_ring);
+  midi_parser_init(&s_usb_parser, MIDI_RX_SRC_USB);
+  midi_parser_init(&s_din_parser, MIDI_RX_SRC_DIN);
+  chBSemObjectInit(&s_rx_sem, true);
+
+  chThdCreateStatic(waMidiRxDispatch, sizeof(waMidiRxDispatch),
+                    MIDI_RX_DISPATCH_PRIO, thdMidiRxDispatch, NULL);
+  chThdCreateStatic(waMidiRxDin, sizeof(waMidiRxDin),
+                    MIDI_RX_DIN_PRIO, thdMidiRxDin, NULL);
+  s_initialized = true;
+}
+
+void midi_rx_register_clock_callbacks(midi_rx_realtime_cb_t realtime_cb, midi_rx_spp_cb_t spp_cb) {
+  s_realtime_cb = realtime_cb;
+  s_spp_cb      = spp_cb;
+}
+
+void midi_rx_register_probe_callback(midi_rx_probe_cb_t cb) {
+  s_probe_cb = cb;
+}
+
+void midi_rx_usb_receive_i(const uint8_t *buf, size_t len) {
+  if (!s_initialized || (buf == NULL)) {
+    return;
+  }
+  const hr_time_t ts = hr_time_now();
+  bool pushed = false;
+
+  for (size_t i = 0U; (i + 4U) <= len; i += 4U) {
+    const uint8_t cable = (uint8_t)(buf[i] >> 4);
+    const uint8_t n     = midi_usb_cin_length(buf[i]);
+    if ((cable != MIDI_USB_CABLE) || (n == 0U)) {
+      midi_rx_stats.usb_bad_packets++;
+      continue;
+    }
+    midi_rx_stats.usb_packets++;
+
+    for (uint8_t b = 0U; b < n; ++b) {
+      midi_rx_event_t ev[MIDI_PARSER_MAX_EVENTS];
+      const uint8_t m = midi_parser_feed(&s_usb_parser, buf[i + 1U + b], ts, ev);
+      for (uint8_t k = 0U; k < m; ++k) {
+        if (!midi_rx_ring_push(&s_usb_ring, &ev[k])) {
+          midi_rx_stats.ring_drops++;
+        }
+        pushed = true;
+      }
+    }
+  }
+
+  if (pushed) {
+    chBSemSignalI(&s_rx_sem);
+  }
+}
+
+bool midi_rx_pop(midi_rx_event_t *out) {
+  if ((out == NULL) || !midi_rx_ring_pop(&s_channel_ring, out)) {
+    return false;
+  }
+  const uint32_t latency = (uint32_t)(hr_time_now() - out->ts);
+  midi_rx_stats.latency_last = latency;
+  if (latency > midi_rx_stats.latency_max) {
+    midi_rx_stats.latency_max = latency;
+  }
+  return true;
+}
+
+void midi_rx_stats_reset(void) {
+  midi_rx_stats = (midi_rx_stats_t){0};
+}
+
+size_t midi_rx_dispatch_stack_unused(void) {
+  return stack_watch_unused(waMidiRxDispatch, sizeof(waMidiRxDispatch));
+}
@@ -0,0 +1,115 @@
+/**
+ * @file midi_rx.h
+ * @brief Réception MIDI (USB EP1 OUT + DIN UART) : analyse, horodatage, routage.
+ *
+ * Chaîne de réception :
+ * - **USB** : le callback EP1 OUT (ISR) décode les paquets USB-MIDI,
+ *   horodate le transfert et pousse les messages dans une file SPSC.
+ * - **DIN** : un thread de lecture bloqué sur `SD2` horodate chaque octet
+ *   à son réveil et pousse les messages dans une seconde file SPSC.
+ *   Biais : l’horodatage DIN n’est pas pris dans l’ISR UART. Il vaut l’heure
+ *   de réveil du thread moins 320 µs par octet déjà arrivé derrière celui lu ;
+ *   il n’est donc jamais antérieur à l’arrivée réelle et la dépasse au plus de
+ *   la latence de réveil du thread (`MIDI_RX_DIN_PRIO`, sections critiques
+ *   comprises), quelques dizaines de µs en pratique. Les horodatages USB sont
+ *   pris dans l’ISR EP1 OUT (un par transfert).
+ * - Un thread de **dispatch** (priorité horloge) vide les deux files :
+ *   temps réel / SPP → callbacks horloge (mode esclave), autres messages
+ *   → file « canal » consommée par le thread UI (`midi_rx_pop()`).
+ *
+ * @ingroup drivers
+ */
+
+#ifndef MIDI_RX_H
+#define MIDI_RX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ch.h"
+#include "midi_rx_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ====================================================================== */
+/*                              TYPES                                     */
+/* ====================================================================== */
+
+/** @brief Callback des messages temps réel (F8/FA/FB/FC/FE/FF). */
+typedef void (*midi_rx_realtime_cb_t)(uint8_t status, hr_time_t ts);
+
+/** @brief Callback Song Position Pointer (en doubles-croches). */
+typedef void (*midi_rx_spp_cb_t)(uint16_t position);
+
+/** @brief Callback d’écho de sonde DIN (octet F9 reçu, horodaté en µs). */
+typedef void (*midi_rx_probe_cb_t)(hr_time_t ts);
+
+/**
+ * @struct midi_rx_stats_t
+ * @brief Statistiques de réception MIDI (pour diagnostic et debug).
+ */
+typedef struct {
+  volatile uint32_t usb_packets;        /**< Paquets USB-MIDI reçus */
+  volatile uint32_t usb_bad_packets;    /**< Paquets USB à CIN réservé / autre câble */
+  volatile uint32_t din_bytes;          /**< Octets DIN reçus */
+  volatile uint32_t din_backlog_max;    /**< Octets DIN en attente derrière un octet lu, maximum */
+  volatile uint32_t realtime;           /**< Messages temps réel routés vers l’horloge */
+  volatile uint32_t channel;            /**< Messages canal remis au thread UI */
+  volatile uint32_t sysex;              /**< SysEx complets (contenu ignoré) */
+  volatile uint32_t ring_drops;         /**< Messages perdus (file pleine) */
+  volatile uint32_t stray_bytes;        /**< Octets de données sans statut */
+  volatile uint32_t latency_last;       /**< Arrivée → consommation UI, dernier message (µs) */
+  volatile uint32_t latency_max;        /**< Arrivée → consommation UI, maximum (µs) */
+} midi_rx_stats_t;
+
+/** @brief Statistiques globales de réception MIDI. */
+extern midi_rx_stats_t midi_rx_stats;
+
+/* ====================================================================== */
+/*                              API                                       */
+/* ====================================================================== */
+
+/**
+ * @brief Initialise la réception (files, analyseurs, threads DIN + dispatch).
+ * @note Appeler après `midi_init()` (UART démarrée) et avant la configuration USB.
+ */
+void midi_rx_init(void);
+
+/** Enregistre les callbacks horloge (appelés depuis le thread de dispatch). */
+void midi_rx_register_clock_callbacks(midi_rx_realtime_cb_t realtime_cb, midi_rx_spp_cb_t spp_cb);
+
+/**
+ * @brief Enregistre le callback d’écho de sonde (calibration de latence DIN).
+ * @note Appelé depuis le thread de lecture DIN, avant l’analyseur : doit rester court.
+ */
+void midi_rx_register_probe_callback(midi_rx_probe_cb_t cb);
+
+/**
+ * @brief Injecte un transfert USB-MIDI reçu (paquets de 4 octets).
+ * @note Appelée depuis le callback EP1 OUT (contexte I-Class / ISR).
+ */
+void midi_rx_usb_receive_i(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Retire le plus ancien message canal reçu (Note, CC, PB, ...).
+ *
+ * Consommateur unique : le thread UI. Met à jour la latence
+ * arrivée → consommation dans @ref midi_rx_stats.
+ * @return false si aucun message n’est en attente.
+ */
+bool midi_rx_pop(midi_rx_event_t *out);
+
+/** Réinitialise les statistiques de réception. */
+void midi_rx_stats_reset(void);
+
+/** Marge de pile jamais atteinte par le thread de dispatch (0 sans `CH_DBG_FILL_THREADS`). */
+size_t midi_rx_dispatch_stack_unused(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MIDI_RX_H */
@@ -0,0 +1,197 @@
+/**
+ * @file midi_rx_parser.c
+ * @brief Analyseur MIDI en flux et file SPSC d’évènements (sans RTOS).
+ *
+ * @ingroup drivers
+ */
+
+#include "midi_rx_parser.h"
+
+#include <string.h>
+
+_Static_assert((MIDI_RX_RING_LEN & (MIDI_RX_RING_LEN - 1U)) == 0U,
+               "MIDI_RX_RING_LEN doit être une puissance de deux");
+_Static_assert(MIDI_RX_RING_LEN <= 32768U, "MIDI_RX_RING_LEN trop grand pour des indices 16 bits");
+
+/**
+ * @brief Barrière compilateur : l’élément est écrit/lu avant la publication
+ *        de l’indice (Cortex-M4 mono-cœur, accès mémoire dans l’ordre).
+ */
+#define MIDI_RX_BARRIER() __asm__ volatile("" ::: "memory")
+
+/* ====================================================================== */
+/*                              ANALYSEUR                                 */
+/* ====================================================================== */
+
+/** Nombre d’octets de données d’un message selon son statut. */
+static uint8_t data_length(uint8_t status) {
+  switch (status & 0xF0U) {
+    case 0x80: case 0x90: case 0xA0: case 0xB0: case 0xE0:
+      return 2U;
+    case 0xC0: case 0xD0:
+      return 1U;
+    default:
+      break;
+  }
+  switch (status) {
+    case 0xF1: case 0xF3: return 1U;
+    case 0xF2:            return 2U;
+    default:              return 0U;
+  }
+}
+
+static void emit(const midi_parser_t *p, uint8_t status, uint8_t d1, uint8_t d2,
+                 hr_time_t ts, midi_rx_event_t *out) {
+  out->ts     = ts;
+  out->source = p->source;
+  out->status = status;
+  out->data1  = d1;
+  out->data2  = d2;
+}
+
+void midi_parser_init(midi_parser_t *p, midi_rx_source_t source) {
+  memset(p, 0, sizeof(*p));
+  p->source = (uint8_t)source;
+}
+
+uint8_t midi_parser_feed(midi_parser_t *p, uint8_t byte, hr_time_t ts,
+                         midi_rx_event_t out[MIDI_PARSER_MAX_EVENTS]) {
+  /* Temps réel : transmis tel quel, sans toucher au message en cours. */
+  if (byte >= 0xF8U) {
+    if ((byte == 0xF9U) || (byte == 0xFDU)) {
+      return 0U; /* non définis */
+    }
+    emit(p, byte, 0U, 0U, ts, &out[0]);
+    return 1U;
+  }
+
+  if (byte & 0x80U) {
+    uint8_t n = 0U;
+    if (p->in_sysex) {
+      p->in_sysex = false;
+      if (byte != 0xF7U) {
+        p->sysex_aborted++;
+      }
+      emit(p, 0xF0U, (uint8_t)(p->sysex_len & 0x7FU), (uint8_t)((p->sysex_len >> 7) & 0x7FU), p->ts, &out[n++]);
+    }
+
+    p->count = 0U;
+    if (byte == 0xF0U) {
+      p->in_sysex  = true;
+      p->sysex_len = 0U;
+      p->status    = 0U;
+      p->running   = 0U;
+      p->ts        = ts;
+      return n;
+    }
+    if (byte == 0xF7U) {
+      p->status = 0U;
+      return n; /* F7 orphelin ignoré */
+    }
+
+    if (byte < 0xF0U) {
+      p->running = byte;
+    } else {
+      p->running = 0U; /* System Common annule le running status */
+    }
+    p->status   = byte;
+    p->expected = data_length(byte);
+    p->ts       = ts;
+
+    if (p->expected == 0U) {
+      p->status = 0U;
+      if (byte == 0xF6U) {
+        /* Tune Request, y compris quand il clôt un SysEx (second évènement). */
+        emit(p, byte, 0U, 0U, ts, &out[n++]);
+      }
+      /* F4/F5 non définis : ignorés. */
+    }
+    return n;
+  }
+
+  /* Octet de données. */
+  if (p->in_sysex) {
+    if (p->sysex_len < 0x3FFFU) {
+      p->sysex_len++;
+    }
+    return 0U;
+  }
+
+  if (p->status == 0U) {
+    if (p->running == 0U) {
+      p->stray_bytes++;
+      return 0U;
+    }
+    /* Running status : nouveau message sur le dernier statut Channel Voice. */
+    p->status   = p->running;
+    p->expected = data_length(p->running);
+    p->count    = 0U;
+    p->ts       = ts;
+  }
+
+  p->data[p->count++] = byte;
+  if (p->count < p->expected) {
+    return 0U;
+  }
+
+  emit(p, p->status, p->data[0], (p->expected > 1U) ? p->data[1] : 0U, p->ts, &out[0]);
+  p->status = 0U;
+  p->count  = 0U;
+  return 1U;
+}
+
+uint8_t midi_usb_cin_length(uint8_t cin) {
+  switch (cin & 0x0FU) {
+    case 0x2: case 0x6: case 0xC: case 0xD:
+      return 2U;
+    case 0x3: case 0x4: case 0x7: case 0x8: case 0x9: case 0xA: case 0xB: case 0xE:
+      return 3U;
+    case 0x5: case 0xF:
+      return 1U;
+    default:
+      return 0U; /* 0x0/0x1 réservés */
+  }
+}
+
+/* ====================================================================== */
+/*                              FILE SPSC                                 */
+/* ====================================================================== */
+
+void midi_rx_ring_reset(midi_rx_ring_t *r) {
+  r->head = 0U;
+  r->tail = 0U;
+  r->drops = 0U;
+  r->high_water = 0U;
+}
+
+bool midi_rx_ring_push(midi_rx_ring_t *r, const midi_rx_event_t *ev) {
+  const uint16_t head = r->head;
+  const uint16_t used = (uint16_t)(head - r->tail);
+  if (used >= MIDI_RX_RING_LEN) {
+    r->drops++;
+    return false;
+  }
+  r->buf[head & (MIDI_RX_RING_LEN - 1U)] = *ev;
+  MIDI_RX_BARRIER();
+  r->head = (uint16_t)(head + 1U);
+  if ((uint16_t)(used + 1U) > r->high_water) {
+    r->high_water = (uint16_t)(used + 1U);
+  }
+  return true;
+}
+
+bool midi_rx_ring_pop(midi_rx_ring_t *r, midi_rx_event_t *out) {
+  const uint16_t tail = r->tail;
+  if (tail == r->head) {
+    return false;
+  }
+  MIDI_RX_BARRIER();
+  *out = r->buf[tail & (MIDI_RX_RING_LEN - 1U)];
+  MIDI_RX_BARRIER();
+  r->tail = (uint16_t)(tail + 1U);
+  return true;
+}
+
+uint16_t midi_rx_ring_count(const midi_rx_ring_t *r) {
+  return (uint16_t)(r->head - r->tail);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file midi_rx_parser.h
+ * @brief Analyseur MIDI en flux et file SPSC d’évènements horodatés (réception).
+ *
+ * Briques sans dépendance RTOS utilisées par `midi_rx.c` :
+ * - **Analyseur** octet par octet : running status, octets temps réel
+ *   intercalés (y compris au milieu d’un message ou d’un SysEx), SysEx
+ *   terminé par F7 ou par un nouvel octet de statut, System Common.
+ * - **File SPSC** sans verrou : un seul producteur (ISR USB ou thread de
+ *   lecture DIN) et un seul consommateur ; indices 16 bits libres, taille
+ *   puissance de deux, publication de l’indice après écriture de l’élément.
+ *
+ * Les messages sont horodatés à l’arrivée de leur **premier** octet
+ * (statut, ou première donnée en running status), en µs (`hr_time.h`).
+ *
+ * @ingroup drivers
+ */
+
+#ifndef MIDI_RX_PARSER_H
+#define MIDI_RX_PARSER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hr_time.h"   /* hr_time_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ====================================================================== */
+/*                              TYPES                                     */
+/* ====================================================================== */
+
+/**
+ * @brief Origine d’un message reçu.
+ */
+typedef enum {
+  MIDI_RX_SRC_USB = 0,  /**< USB MIDI (EP1 OUT) */
+  MIDI_RX_SRC_DIN,      /**< DIN UART */
+  MIDI_RX_SRC_COUNT
+} midi_rx_source_t;
+
+/**
+ * @brief Message MIDI complet, horodaté.
+ *
+ * Pour un SysEx, `status` vaut 0xF0 et `data1`/`data2` portent la longueur
+ * reçue (14 bits, LSB/MSB) ; le contenu n’est pas conservé.
+ */
+typedef struct {
+  hr_time_t ts;      /**< Arrivée du premier octet du message (µs) */
+  uint8_t   source;  /**< @ref midi_rx_source_t */
+  uint8_t   status;  /**< Octet de statut (canal inclus) */
+  uint8_t   data1;   /**< Première donnée (0 si absente) */
+  uint8_t   data2;   /**< Seconde donnée (0 si absente) */
+} midi_rx_event_t;
+
+/**
+ * @brief État de l’analyseur d’un flux d’octets.
+ */
+typedef struct {
+  hr_time_t ts;            /**< Horodatage du message en cours (µs) */
+  uint8_t   source;        /**< Source reportée dans les évènements */
+  uint8_t   running;       /**< Running status (Channel Voice), 0 si aucun */
+  uint8_t   status;        /**< Statut du message en cours, 0 si aucun */
+  uint8_t   expected;      /**< Nombre d’octets de données attendus */
+  uint8_t   count;         /**< Octets de données reçus */
+  uint8_t   data[2];       /**< Données du message en cours */
+  bool      in_sysex;      /**< SysEx en cours */
+  uint16_t  sysex_len;     /**< Octets de SysEx reçus (F0/F7 exclus) */
+  uint32_t  stray_bytes;   /**< Données sans statut ignorées */
+  uint32_t  sysex_aborted; /**< SysEx interrompus par un autre statut */
+} midi_parser_t;
+
+/**
+ * @brief Capacité (puissance de deux) des files d’évènements.
+ */
+#ifndef MIDI_RX_RING_LEN
+#define MIDI_RX_RING_LEN 128U
+#endif
+
+/**
+ * @brief File SPSC d’évènements reçus.
+ */
+typedef struct {
+  volatile uint16_t head;        /**< Écrit par le producteur seul */
+  volatile uint16_t tail;        /**< Écrit par le consommateur seul */
+  volatile uint32_t drops;       /**< Évènements perdus (file pleine) */
+  volatile uint16_t high_water;  /**< Remplissage maximal observé */
+  midi_rx_event_t   buf[MIDI_RX_RING_LEN];
+} midi_rx_ring_t;
+
+/* ====================================================================== */
+/*                              API                                       */
+/* ====================================================================== */
+
+/** Réinitialise l’analyseur (oublie running status et message en cours). */
+void midi_parser_init(midi_parser_t *p, midi_rx_source_t source);
+
+/**
+ * @brief Évènements au plus produits par un octet : un statut qui interrompt
+ *        un SysEx clôt celui-ci et peut former lui-même un message (F6).
+ */
+#define MIDI_PARSER_MAX_EVENTS 2U
+
+/**
+ * @brief Injecte un octet.
+ * @param ts Horodatage d’arrivée de l’octet.
+ * @param[out] out Messages complets, dans l’ordre d’arrivée (`out[0]` d’abord).
+ * @return Nombre de messages écrits dans @p out (0 à @ref MIDI_PARSER_MAX_EVENTS).
+ */
+uint8_t midi_parser_feed(midi_parser_t *p, uint8_t byte, hr_time_t ts,
+                         midi_rx_event_t out[MIDI_PARSER_MAX_EVENTS]);
+
+/**
+ * @brief Nombre d’octets MIDI portés par un paquet USB-MIDI selon son CIN.
+ * @return 0 pour les CIN réservés.
+ */
+uint8_t midi_usb_cin_length(uint8_t cin);
+
+/** Vide la file et remet ses compteurs à zéro (hors concurrence). */
+void midi_rx_ring_reset(midi_rx_ring_t *r);
+
+/** Producteur : ajoute un évènement, false (et drop compté) si la file est pleine. */
+bool midi_rx_ring_push(midi_rx_ring_t *r, const midi_rx_event_t *ev);
+
+/** Consommateur : retire l’évènement le plus ancien, false si la file est vide. */
+bool midi_rx_ring_pop(midi_rx_ring_t *r, midi_rx_event_t *out);
+
+/** Nombre d’évènements en attente (instantané). */
+uint16_t midi_rx_ring_count(const midi_rx_ring_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MIDI_RX_PARSER_H */
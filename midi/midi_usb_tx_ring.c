@@ -0,0 +1,140 @@
+/**
+ * @file midi_usb_tx_ring.c
+ * @brief File d’émission USB-MIDI à double tampon (compare-and-swap).
+ *
+ * Mot d’état :
+ * - bit 0      : tampon de remplissage (0/1),
+ * - bit 1      : transfert en vol,
+ * - bits 2..8  : emplacements réservés dans le tampon de remplissage,
+ * - bits 9..15 : paquets validés dans le tampon 0,
+ * - bits 16..22: paquets validés dans le tampon 1.
+ *
+ * Un tampon n’est transmis que lorsque tous ses emplacements réservés sont
+ * validés ; un producteur préempté entre réservation et validation démarre
+ * lui-même le transfert après sa validation si l’endpoint est libre.
+ * Sur Cortex-M4 les CAS se compilent en LDREX/STREX.
+ *
+ * @ingroup drivers
+ */
+
+#include "midi_usb_tx_ring.h"
+
+_Static_assert(MIDI_USB_TX_BUF_PACKETS > 0U && MIDI_USB_TX_BUF_PACKETS <= 127U,
+               "MIDI_USB_TX_BUF_PACKETS doit tenir sur 7 bits");
+
+#define ST_ACTIVE_BIT   0x1U
+#define ST_BUSY_BIT     0x2U
+#define ST_RES_SHIFT    2U
+#define ST_COM_SHIFT(i) (9U + (7U * (uint32_t)(i)))
+#define ST_FIELD_MASK   0x7FU
+
+static inline uint32_t st_active(uint32_t s) { return s & ST_ACTIVE_BIT; }
+static inline bool     st_busy(uint32_t s)   { return (s & ST_BUSY_BIT) != 0U; }
+static inline uint32_t st_res(uint32_t s)    { return (s >> ST_RES_SHIFT) & ST_FIELD_MASK; }
+static inline uint32_t st_com(uint32_t s, uint32_t i) { return (s >> ST_COM_SHIFT(i)) & ST_FIELD_MASK; }
+
+static inline uint32_t st_load(const midi_usb_tx_ring_t *r) {
+  return __atomic_load_n(&r->state, __ATOMIC_ACQUIRE);
+}
+
+static inline bool st_cas(midi_usb_tx_ring_t *r, uint32_t *expected, uint32_t desired) {
+  return __atomic_compare_exchange_n(&r->state, expected, desired, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/** Tampon de remplissage entièrement validé et non vide. */
+static inline bool st_fill_ready(uint32_t s) {
+  const uint32_t res = st_res(s);
+  return (res != 0U) && (st_com(s, st_active(s)) == res);
+}
+
+/** Bascule : le tampon rempli part en vol, l’autre (libre) devient tampon de remplissage. */
+static inline uint32_t st_flip(uint32_t s) {
+  s &= ~(ST_FIELD_MASK << ST_RES_SHIFT);
+  s ^= ST_ACTIVE_BIT;
+  return s | ST_BUSY_BIT;
+}
+
+static void update_high_water(midi_usb_tx_ring_t *r, uint32_t s) {
+  uint32_t pending = st_res(s);
+  if (st_busy(s)) {
+    pending += st_com(s, st_active(s) ^ 1U);
+  }
+  /* Statistique : une mise à jour concurrente perdue est sans conséquence. */
+  if (pending > __atomic_load_n(&r->high_water, __ATOMIC_RELAXED)) {
+    __atomic_store_n(&r->high_water, (uint16_t)pending, __ATOMIC_RELAXED);
+  }
+}
+
+void midi_usb_tx_ring_reset(midi_usb_tx_ring_t *r) {
+  r->state = 0U;
+  r->drops = 0U;
+  r->high_water = 0U;
+}
+
+void midi_usb_tx_ring_abort(midi_usb_tx_ring_t *r) {
+  __atomic_store_n(&r->state, 0U, __ATOMIC_RELEASE);
+}
+
+midi_usb_tx_push_t midi_usb_tx_ring_push(midi_usb_tx_ring_t *r, const uint8_t packet[4],
+                                         const uint8_t **tx_buf, size_t *tx_len) {
+  /* 1) Réservation d’un emplacement dans le tampon de remplissage. */
+  uint32_t s = st_load(r);
+  do {
+    if (st_res(s) >= MIDI_USB_TX_BUF_PACKETS) {
+      (void)__atomic_add_fetch(&r->drops, 1U, __ATOMIC_RELAXED);
+      return MIDI_USB_TX_FULL;
+    }
+  } while (!st_cas(r, &s, s + (1U << ST_RES_SHIFT)));
+
+  const uint32_t idx  = st_active(s);
+  const uint32_t slot = st_res(s);
+
+  /* 2) Écriture directe dans le tampon qui partira au prochain transfert. */
+  uint8_t *dst = &r->buf[idx][slot * 4U];
+  dst[0] = packet[0];
+  dst[1] = packet[1];
+  dst[2] = packet[2];
+  dst[3] = packet[3];
+
+  /* 3) Validation (publication release de l’écriture). */
+  s = __atomic_add_fetch(&r->state, 1U << ST_COM_SHIFT(idx), __ATOMIC_ACQ_REL);
+  update_high_water(r, s);
+
+  /* 4) Endpoint libre : ce producteur démarre le transfert. */
+  while (!st_busy(s) && st_fill_ready(s)) {
+    if (st_cas(r, &s, st_flip(s))) {
+      *tx_buf = r->buf[st_active(s)];
+      *tx_len = (size_t)st_com(s, st_active(s)) * 4U;
+      return MIDI_USB_TX_START;
+    }
+  }
+  return MIDI_USB_TX_QUEUED;
+}
+
+bool midi_usb_tx_ring_complete(midi_usb_tx_ring_t *r, const uint8_t **tx_buf, size_t *tx_len) {
+  uint32_t s = st_load(r);
+  uint32_t ns;
+  bool chain;
+  do {
+    const uint32_t sent = st_active(s) ^ 1U;
+    ns = s & ~(ST_FIELD_MASK << ST_COM_SHIFT(sent));
+    chain = st_fill_ready(ns);
+    ns = chain ? st_flip(ns) : (ns & ~ST_BUSY_BIT);
+  } while (!st_cas(r, &s, ns));
+
+  if (!chain) {
+    return false;
+  }
+  *tx_buf = r->buf[st_active(s)];
+  *tx_len = (size_t)st_com(s, st_active(s)) * 4U;
+  return true;
+}
+
+uint16_t midi_usb_tx_ring_pending(const midi_usb_tx_ring_t *r) {
+  return (uint16_t)st_res(st_load(r));
+}
+
+bool midi_usb_tx_ring_busy(const midi_usb_tx_ring_t *r) {
+  return st_busy(st_load(r));
+}
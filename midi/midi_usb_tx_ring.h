@@ -0,0 +1,95 @@
+/**
+ * @file midi_usb_tx_ring.h
+ * @brief File d’émission USB-MIDI à double tampon, sans copie ni verrou.
+ *
+ * Deux tampons de paquets USB-MIDI (4 octets) alternent :
+ * - le tampon **de remplissage** reçoit les paquets écrits directement par
+ *   les producteurs (réservation d’un emplacement, écriture, validation) ;
+ * - le tampon **en vol** est transmis tel quel par l’endpoint IN.
+ *
+ * À la fin d’un transfert, le callback d’endpoint bascule les tampons et
+ * renvoie immédiatement le tampon rempli, sans passer par un thread. Si
+ * l’endpoint est libre, le producteur qui valide le dernier paquet démarre
+ * lui-même le transfert.
+ *
+ * Tout l’état (tampon actif, endpoint occupé, emplacements réservés,
+ * paquets validés par tampon) tient dans un mot de 32 bits modifié par
+ * compare-and-swap : plusieurs producteurs (threads) et le consommateur
+ * (ISR USB) progressent sans section critique.
+ *
+ * Module sans dépendance RTOS (testé sur hôte, `tests/midi_usb_tx_ring_tests.c`).
+ *
+ * @ingroup drivers
+ */
+
+#ifndef MIDI_USB_TX_RING_H
+#define MIDI_USB_TX_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Capacité d’un tampon, en paquets USB-MIDI (≤ 127).
+ * @details 64 paquets = 256 octets, transmis en un transfert bulk multi-paquets.
+ */
+#ifndef MIDI_USB_TX_BUF_PACKETS
+#define MIDI_USB_TX_BUF_PACKETS 64U
+#endif
+
+/** @brief Résultat d’un dépôt de paquet. */
+typedef enum {
+  MIDI_USB_TX_QUEUED = 0,  /**< Paquet en attente du prochain transfert */
+  MIDI_USB_TX_START,       /**< Endpoint libre : l’appelant démarre le transfert retourné */
+  MIDI_USB_TX_FULL         /**< Tampon de remplissage plein : paquet perdu */
+} midi_usb_tx_push_t;
+
+/**
+ * @brief File d’émission (état atomique + deux tampons).
+ */
+typedef struct {
+  volatile uint32_t state;       /**< Mot d’état (voir midi_usb_tx_ring.c) */
+  volatile uint32_t drops;       /**< Paquets perdus (tampon plein) */
+  volatile uint16_t high_water;  /**< Paquets en attente + en vol, maximum observé */
+  uint8_t buf[2][MIDI_USB_TX_BUF_PACKETS * 4U] __attribute__((aligned(4)));
+} midi_usb_tx_ring_t;
+
+/** Vide la file (endpoint considéré libre). Hors concurrence uniquement. */
+void midi_usb_tx_ring_reset(midi_usb_tx_ring_t *r);
+
+/**
+ * @brief Abandonne le contenu et libère l’endpoint (reconfiguration USB).
+ * @details Les compteurs (`drops`, `high_water`) sont conservés. Contexte I-Class.
+ */
+void midi_usb_tx_ring_abort(midi_usb_tx_ring_t *r);
+
+/**
+ * @brief Producteur : écrit un paquet dans le tampon de remplissage.
+ * @param[out] tx_buf Tampon à transmettre si le résultat vaut @ref MIDI_USB_TX_START.
+ * @param[out] tx_len Longueur en octets du transfert à démarrer.
+ */
+midi_usb_tx_push_t midi_usb_tx_ring_push(midi_usb_tx_ring_t *r, const uint8_t packet[4],
+                                         const uint8_t **tx_buf, size_t *tx_len);
+
+/**
+ * @brief Consommateur (fin de transfert) : libère le tampon transmis et
+ *        bascule sur le tampon rempli s’il est complet.
+ * @return true si @p tx_buf / @p tx_len doivent être transmis immédiatement.
+ */
+bool midi_usb_tx_ring_complete(midi_usb_tx_ring_t *r, const uint8_t **tx_buf, size_t *tx_len);
+
+/** Paquets en attente dans le tampon de remplissage (instantané). */
+uint16_t midi_usb_tx_ring_pending(const midi_usb_tx_ring_t *r);
+
+/** true si un transfert est en vol. */
+bool midi_usb_tx_ring_busy(const midi_usb_tx_ring_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MIDI_USB_TX_RING_H */
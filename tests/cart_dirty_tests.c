@@ -0,0 +1,231 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cart_dirty.h"
+#include "cart_proto.h"
+
+static cart_dirty_t g_dirty;
+
+/* -------------------------------------------------------------------------- */
+/* Coalescence : dernière valeur gagnante                                     */
+/* -------------------------------------------------------------------------- */
+
+static void test_last_value_wins(void) {
+    cart_dirty_init(&g_dirty);
+
+    /* Balayage d’encodeur : 40 écritures du même paramètre. */
+    for (uint8_t v = 0U; v < 40U; ++v) {
+        assert(cart_dirty_set(&g_dirty, 12U, v));
+    }
+    assert(cart_dirty_set(&g_dirty, 3U, 7U));
+    assert(cart_dirty_pending(&g_dirty) == 2U);
+    assert(g_dirty.coalesced == 39U);
+
+    uint8_t out[64];
+    uint32_t frames = 0U;
+    const size_t n = cart_dirty_drain(&g_dirty, out, sizeof(out), &frames);
+
+    uint8_t expected[8];
+    size_t e = cart_proto_build_set(3U, 7U, expected);
+    e += cart_proto_build_set(12U, 39U, &expected[e]);
+    assert((n == e) && (memcmp(out, expected, n) == 0));
+    assert(frames == 2U);
+    assert(cart_dirty_pending(&g_dirty) == 0U);
+    assert(cart_dirty_drain(&g_dirty, out, sizeof(out), &frames) == 0U);
+    assert(frames == 0U);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Classes de priorité                                                        */
+/* -------------------------------------------------------------------------- */
+
+static void test_classes_drain_in_priority_order(void) {
+    cart_dirty_init(&g_dirty);
+
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_UI, 10U, 1U, 0U));
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_RESTORE, 20U, 2U, 0U));
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_SEQ, 30U, 3U, 0U));
+    assert(!cart_dirty_set_class(&g_dirty, CART_CLASS_BACKGROUND, 40U, 4U, 0U)); /* GET uniquement */
+
+    uint8_t out[64];
+    uint32_t frames = 0U;
+    size_t n = cart_dirty_drain(&g_dirty, out, sizeof(out), &frames);
+
+    /* Ordre des classes, pas des paramètres. */
+    uint8_t expected[16];
+    size_t e = cart_proto_build_set(30U, 3U, expected);
+    e += cart_proto_build_set(20U, 2U, &expected[e]);
+    e += cart_proto_build_set(10U, 1U, &expected[e]);
+    assert((n == e) && (memcmp(out, expected, n) == 0));
+    assert(frames == 3U);
+
+    /* Écrit en UI puis par le séquenceur : une seule trame, montée en SEQ. */
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_UI, 10U, 5U, 0U));
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_SEQ, 10U, 6U, 0U));
+    assert(cart_dirty_class_pending(&g_dirty, CART_CLASS_UI) == 0U);
+    assert(cart_dirty_class_pending(&g_dirty, CART_CLASS_SEQ) == 1U);
+
+    /* Écrit en SEQ puis par l’UI : reste en SEQ, avec la valeur UI. */
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_SEQ, 11U, 7U, 0U));
+    assert(cart_dirty_set_class(&g_dirty, CART_CLASS_UI, 11U, 8U, 0U));
+    assert(cart_dirty_class_pending(&g_dirty, CART_CLASS_UI) == 0U);
+    assert(cart_dirty_pending(&g_dirty) == 2U);
+
+    assert(cart_dirty_drain_class(&g_dirty, CART_CLASS_UI, out, sizeof(out), &frames) == 0U);
+    n = cart_dirty_drain_class(&g_dirty, CART_CLASS_SEQ, out, sizeof(out), &frames);
+    e = cart_proto_build_set(10U, 6U, expected);
+    e += cart_proto_build_set(11U, 8U, &expected[e]);
+    assert((n == e) && (memcmp(out, expected, n) == 0));
+    assert(cart_dirty_pending(&g_dirty) == 0U);
+}
+
+static void test_extended_params_and_range(void) {
+    cart_dirty_init(&g_dirty);
+
+    assert(cart_dirty_set(&g_dirty, 300U, 0x55U));
+    assert(cart_dirty_set(&g_dirty, 511U, 1U));
+    assert(cart_dirty_set(&g_dirty, 300U, 0x56U));
+    assert(!cart_dirty_set(&g_dirty, 512U, 1U));
+    assert(!cart_dirty_set(&g_dirty, 0xFFFFU, 1U));
+
+    uint8_t out[32];
+    uint32_t frames = 0U;
+    const size_t n = cart_dirty_drain(&g_dirty, out, sizeof(out), &frames);
+
+    uint8_t expected[16];
+    size_t e = cart_proto_build_set(300U, 0x56U, expected);
+    e += cart_proto_build_set(511U, 1U, &expected[e]);
+    assert((n == e) && (memcmp(out, expected, n) == 0));
+    assert(frames == 2U);
+    assert(g_dirty.high_water == 2U);
+}
+
+static void test_burst_boundaries(void) {
+    cart_dirty_init(&g_dirty);
+
+    /* 512 paramètres sales : aucune trame coupée, reprise sans perte. */
+    for (uint16_t p = 0U; p < CART_PARAM_COUNT; ++p) {
+        assert(cart_dirty_set(&g_dirty, p, (uint8_t)p));
+    }
+
+    static uint8_t stream[CART_PARAM_COUNT * 4U];
+    size_t total = 0U;
+    uint32_t frames_total = 0U;
+    uint32_t bursts = 0U;
+    uint8_t out[64];
+    uint32_t frames;
+    size_t n;
+    while ((n = cart_dirty_drain(&g_dirty, out, sizeof(out), &frames)) != 0U) {
+        assert(n <= sizeof(out));
+        memcpy(&stream[total], out, n);
+        total += n;
+        frames_total += frames;
+        bursts++;
+    }
+    assert(frames_total == CART_PARAM_COUNT);
+
+    /* Ordre croissant, chaque paramètre une seule fois avec sa valeur. */
+    static uint8_t expected[CART_PARAM_COUNT * 4U];
+    size_t e = 0U;
+    for (uint16_t p = 0U; p < CART_PARAM_COUNT; ++p) {
+        e += cart_proto_build_set(p, (uint8_t)p, &expected[e]);
+    }
+    assert((total == e) && (memcmp(stream, expected, e) == 0));
+
+    printf("cart_dirty: params=%u bytes=%u bursts=%u (cap=%u)\n",
+           (unsigned)CART_PARAM_COUNT, (unsigned)total, (unsigned)bursts, (unsigned)sizeof(out));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Producteurs concurrents : la valeur finale est toujours émise              */
+/* -------------------------------------------------------------------------- */
+
+#define PRODUCERS      4U
+#define WRITES         20000U
+#define PARAMS_PER_PRODUCER 8U
+
+static volatile bool g_done;
+static uint8_t g_last_sent[CART_PARAM_COUNT];
+
+static void *producer(void *arg) {
+    const uint16_t base = (uint16_t)((uintptr_t)arg * 50U);
+    for (uint32_t i = 0U; i < WRITES; ++i) {
+        const uint16_t p = (uint16_t)(base + (i % PARAMS_PER_PRODUCER));
+        /* La dernière écriture de chaque paramètre vaut 0xA5. */
+        const uint8_t v = (i >= (WRITES - PARAMS_PER_PRODUCER)) ? 0xA5U : (uint8_t)i;
+        assert(cart_dirty_set(&g_dirty, p, v));
+        if ((i & 63U) == 0U) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* Paramètres < 255 : trames SET de 3 octets. */
+static void consume(const uint8_t *buf, size_t n) {
+    size_t i = 0U;
+    while (i < n) {
+        assert(buf[i] == 's');
+        g_last_sent[buf[i + 1U]] = buf[i + 2U];
+        i += 3U;
+    }
+}
+
+static void *consumer(void *arg) {
+    (void)arg;
+    uint8_t out[48];
+    uint32_t frames;
+    for (;;) {
+        const bool done = __atomic_load_n(&g_done, __ATOMIC_ACQUIRE);
+        const size_t n = cart_dirty_drain(&g_dirty, out, sizeof(out), &frames);
+        consume(out, n);
+        if (done && (n == 0U)) {
+            break;
+        }
+        if (n == 0U) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_producers(void) {
+    cart_dirty_init(&g_dirty);
+    memset(g_last_sent, 0, sizeof(g_last_sent));
+    g_done = false;
+
+    pthread_t prod[PRODUCERS];
+    pthread_t cons;
+    assert(pthread_create(&cons, NULL, consumer, NULL) == 0);
+    for (uintptr_t t = 0U; t < PRODUCERS; ++t) {
+        assert(pthread_create(&prod[t], NULL, producer, (void *)t) == 0);
+    }
+    for (unsigned t = 0U; t < PRODUCERS; ++t) {
+        assert(pthread_join(prod[t], NULL) == 0);
+    }
+    __atomic_store_n(&g_done, true, __ATOMIC_RELEASE);
+    assert(pthread_join(cons, NULL) == 0);
+
+    for (uint16_t t = 0U; t < PRODUCERS; ++t) {
+        for (uint16_t k = 0U; k < PARAMS_PER_PRODUCER; ++k) {
+            assert(g_last_sent[(t * 50U) + k] == 0xA5U);
+        }
+    }
+    assert(cart_dirty_pending(&g_dirty) == 0U);
+    printf("cart_dirty: concurrent writes=%u coalesced=%u\n",
+           (unsigned)(PRODUCERS * WRITES), (unsigned)g_dirty.coalesced);
+}
+
+int main(void) {
+    test_last_value_wins();
+    test_classes_drain_in_priority_order();
+    test_extended_params_and_range();
+    test_burst_boundaries();
+    test_concurrent_producers();
+    return 0;
+}
@@ -0,0 +1,283 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cart_proto.h"
+#include "cart_tx.h"
+
+/* -------------------------------------------------------------------------- */
+/* Cartouche simulée : UART 500 kbaud, réponse d’un octet par GET             */
+/* -------------------------------------------------------------------------- */
+
+#define SIM_BYTE_US      20U     /* 10 bits à 500 kbaud */
+#define SIM_TURNAROUND_US 30U    /* traitement d’une trame côté cartouche */
+#define SIM_POLL_US      1000U   /* période du thread consommateur */
+#define SIM_TIMEOUT_US   20000U
+
+typedef struct {
+    uint8_t  mem[CART_PARAM_COUNT];
+    bool     mute;               /* cartouche absente */
+    int32_t  drop_reply_for;     /* paramètre dont la réponse est perdue (-1 : aucune) */
+    /* Analyseur de trames */
+    uint8_t  st;
+    uint8_t  cmd;
+    uint16_t param;
+    /* Ligne RX : octets en route vers Brick */
+    uint8_t  rx_byte[256];
+    uint32_t rx_at[256];
+    uint16_t rx_head;
+    uint16_t rx_tail;
+    uint32_t rx_free_at;         /* ligne RX libre à partir de */
+} sim_cart_t;
+
+static cart_tx_port_t g_port;
+static sim_cart_t g_cart;
+static uint8_t g_shadow[CART_PARAM_COUNT];
+static uint32_t g_now;
+static uint32_t g_dma_end;       /* 0 : DMA inactif */
+static uint32_t g_dma_len;
+
+static void cart_reply(uint8_t v, uint32_t t) {
+    const uint32_t start = (t > g_cart.rx_free_at) ? t : g_cart.rx_free_at;
+    const uint32_t at = start + SIM_BYTE_US;
+    g_cart.rx_free_at = at;
+    const uint16_t i = (uint16_t)(g_cart.rx_head++ & 255U);
+    assert((uint16_t)(g_cart.rx_head - g_cart.rx_tail) <= 256U);
+    g_cart.rx_byte[i] = v;
+    g_cart.rx_at[i] = at;
+}
+
+/** La cartouche reçoit un octet à l’instant @p t (protocole XVA1). */
+static void cart_rx(uint8_t b, uint32_t t) {
+    switch (g_cart.st) {
+        case 0:
+            g_cart.cmd = b;
+            g_cart.st = 1U;
+            return;
+        case 1:
+            if (b == 255U) {
+                g_cart.st = 2U;
+                return;
+            }
+            g_cart.param = b;
+            break;
+        case 2:
+            g_cart.param = (uint16_t)(256U + b);
+            break;
+        default:
+            if (g_cart.cmd == 's') {
+                g_cart.mem[g_cart.param] = b;
+            }
+            g_cart.st = 0U;
+            return;
+    }
+    if (g_cart.cmd == 's') {
+        g_cart.st = 3U;
+        return;
+    }
+    assert(g_cart.cmd == 'g');
+    g_cart.st = 0U;
+    if (!g_cart.mute && ((int32_t)g_cart.param != g_cart.drop_reply_for)) {
+        cart_reply(g_cart.mem[g_cart.param], t + SIM_TURNAROUND_US);
+    }
+    if ((int32_t)g_cart.param == g_cart.drop_reply_for) {
+        g_cart.drop_reply_for = -1; /* une seule perte */
+    }
+}
+
+static void dma_start(size_t len) {
+    if (len == 0U) {
+        return;
+    }
+    g_dma_len = (uint32_t)len;
+    g_dma_end = g_now + ((uint32_t)len * SIM_BYTE_US);
+}
+
+/** Fin de DMA : la cartouche a reçu le bloc, le moteur enchaîne. */
+static void dma_done(void) {
+    for (uint32_t i = 0U; i < g_dma_len; ++i) {
+        cart_rx(g_port.buf[i], g_now - ((g_dma_len - 1U - i) * SIM_BYTE_US));
+    }
+    g_dma_end = 0U;
+    dma_start(cart_tx_complete(&g_port, g_now));
+}
+
+static void consumer_poll(void) {
+    cart_sync_result_t r;
+    while (cart_sync_pop(&g_port.sync, &r)) {
+        g_shadow[r.param] = r.value;
+    }
+    if (cart_sync_poll(&g_port.sync, g_now)) {
+        dma_start(cart_tx_kick(&g_port, g_now));
+    }
+}
+
+static bool idle(void) {
+    return (g_dma_end == 0U) && (g_cart.rx_head == g_cart.rx_tail) &&
+           (cart_sync_inflight(&g_port.sync) == 0U) && !cart_sync_can_emit(&g_port.sync, g_now) &&
+           (g_port.sync.r_head == g_port.sync.r_tail) && !g_port.sync.holding;
+}
+
+/** Boucle d’événements : fin de DMA, octet reçu, passage du consommateur. */
+static void run_until_idle(uint32_t limit_us) {
+    uint32_t next_poll = g_now + SIM_POLL_US;
+    while (g_now < limit_us) {
+        uint32_t t = next_poll;
+        int ev = 0;
+        if ((g_dma_end != 0U) && (g_dma_end < t)) {
+            t = g_dma_end;
+            ev = 1;
+        }
+        if ((g_cart.rx_head != g_cart.rx_tail) && (g_cart.rx_at[g_cart.rx_tail & 255U] < t)) {
+            /* Octet arrivé pendant le bloc DMA : traité à la fin du bloc. */
+            t = (g_cart.rx_at[g_cart.rx_tail & 255U] > g_now) ? g_cart.rx_at[g_cart.rx_tail & 255U] : g_now;
+            ev = 2;
+        }
+        g_now = t;
+        if (ev == 1) {
+            dma_done();
+        } else if (ev == 2) {
+            const uint8_t b = g_cart.rx_byte[g_cart.rx_tail++ & 255U];
+            if (cart_sync_on_byte(&g_port.sync, b, g_now)) {
+                dma_start(cart_tx_kick(&g_port, g_now));
+            }
+        } else {
+            consumer_poll();
+            next_poll += SIM_POLL_US;
+            if (idle()) {
+                return;
+            }
+        }
+    }
+    assert(false && "simulation sans fin");
+}
+
+static void sim_reset(void) {
+    memset(&g_cart, 0, sizeof(g_cart));
+    g_cart.drop_reply_for = -1;
+    for (uint16_t p = 0U; p < CART_PARAM_COUNT; ++p) {
+        g_cart.mem[p] = (uint8_t)((p * 37U) ^ 0x5AU);
+    }
+    memset(g_shadow, 0, sizeof(g_shadow));
+    cart_tx_init(&g_port, SIM_TIMEOUT_US);
+    g_now = 1U;
+    g_dma_end = 0U;
+}
+
+static void assert_shadow_matches(void) {
+    for (uint16_t p = 0U; p < CART_PARAM_COUNT; ++p) {
+        if (p != 255U) {
+            assert(g_shadow[p] == g_cart.mem[p]);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_window_and_order(void) {
+    cart_sync_t s;
+    cart_sync_init(&s, 100U);
+    uint8_t out[128];
+    uint32_t frames = 0U;
+
+    assert(!cart_sync_request(&s, 255U));       /* octet d’extension */
+    assert(!cart_sync_request(&s, 512U));
+    assert(cart_sync_request(&s, 300U));
+    assert(cart_sync_request(&s, 300U));        /* dédoublonné */
+    assert(cart_sync_request(&s, 2U));
+    size_t n = cart_sync_emit(&s, out, sizeof(out), 0U, &frames);
+    assert((frames == 2U) && (n == 5U));
+    assert(cart_sync_inflight(&s) == 2U);
+
+    /* Réponses dans l’ordre d’émission (croissant), validées lot complet. */
+    assert(cart_sync_emit(&s, out, sizeof(out), 0U, &frames) == 0U);  /* lot ouvert */
+    assert(!cart_sync_on_byte(&s, 11U, 1U));
+    cart_sync_result_t r;
+    assert(!cart_sync_pop(&s, &r));
+    assert(cart_sync_on_byte(&s, 22U, 1U));
+    assert((s.stats.rtt_lot == 2U) && (s.stats.rtt_last == 1U));
+    assert(!cart_sync_on_byte(&s, 33U, 1U));    /* orphelin */
+    assert(cart_sync_pop(&s, &r) && (r.param == 2U) && (r.value == 11U));
+    assert(cart_sync_pop(&s, &r) && (r.param == 300U) && (r.value == 22U));
+    assert(!cart_sync_pop(&s, &r));
+    assert(s.stats.stray == 1U);
+
+    /* Lecture complète : lots bornés, puis émission bloquée par la file des réponses pleine. */
+    cart_sync_request_all(&s);
+    n = cart_sync_emit(&s, out, sizeof(out), 2U, &frames);
+    assert(frames == CART_SYNC_WINDOW);
+    for (uint32_t round = 0U; round < 8U; ++round) {
+        for (uint8_t i = 0U; i < CART_SYNC_WINDOW; ++i) {
+            (void)cart_sync_on_byte(&s, 0U, 3U);  /* personne ne lit les réponses */
+        }
+        (void)cart_sync_emit(&s, out, sizeof(out), 3U, &frames);
+    }
+    assert((uint16_t)(s.r_head - s.r_tail) + cart_sync_inflight(&s) <= CART_SYNC_RESULT_LEN);
+    assert(!cart_sync_can_emit(&s, 3U));
+}
+
+static void test_dump_512(void) {
+    sim_reset();
+    cart_sync_request_all(&g_port.sync);
+    dma_start(cart_tx_kick(&g_port, g_now));
+    run_until_idle(10U * 1000U * 1000U);
+
+    assert_shadow_matches();
+    assert(g_port.sync.stats.replies == (CART_PARAM_COUNT - 1U));
+    assert(g_port.sync.stats.timeouts == 0U);
+    assert(g_port.sync.stats.inflight_max == CART_SYNC_WINDOW);
+
+    /* Aller-retour unitaire sans pipeline : trame + traitement + réponse + passage du thread. */
+    const uint32_t naive_us = (CART_PARAM_COUNT - 1U) * (3U * SIM_BYTE_US + SIM_TURNAROUND_US + SIM_BYTE_US + SIM_POLL_US);
+    printf("cart_sync: dump params=%u time_ms=%.2f (round-trip estimate %.1f ms) blocks=%u inflight_max=%u\n",
+           (unsigned)(CART_PARAM_COUNT - 1U), (double)g_now / 1000.0, (double)naive_us / 1000.0,
+           (unsigned)g_port.bursts, (unsigned)g_port.sync.stats.inflight_max);
+}
+
+static void test_set_then_get_sees_new_value(void) {
+    sim_reset();
+    assert(cart_dirty_set(&g_port.dirty, 40U, 200U));
+    assert(cart_sync_request(&g_port.sync, 40U));
+    dma_start(cart_tx_kick(&g_port, g_now));
+    run_until_idle(1000U * 1000U);
+    assert((g_cart.mem[40] == 200U) && (g_shadow[40] == 200U));
+}
+
+static void test_lost_reply_resyncs(void) {
+    sim_reset();
+    g_cart.drop_reply_for = 100;
+    cart_sync_request_all(&g_port.sync);
+    dma_start(cart_tx_kick(&g_port, g_now));
+    run_until_idle(10U * 1000U * 1000U);
+
+    assert_shadow_matches();
+    assert(g_port.sync.stats.timeouts == 1U);
+    assert(g_port.sync.stats.abandoned == 0U);
+    printf("cart_sync: lost reply -> timeouts=%u stray=%u time_ms=%.2f\n",
+           (unsigned)g_port.sync.stats.timeouts, (unsigned)g_port.sync.stats.stray, (double)g_now / 1000.0);
+}
+
+static void test_absent_cart_gives_up(void) {
+    sim_reset();
+    g_cart.mute = true;
+    cart_sync_request_all(&g_port.sync);
+    dma_start(cart_tx_kick(&g_port, g_now));
+    run_until_idle(10U * 1000U * 1000U);
+
+    assert(g_port.sync.stats.timeouts == CART_SYNC_MAX_RETRIES);
+    assert(g_port.sync.stats.abandoned == (CART_PARAM_COUNT - 1U));
+    assert(g_port.sync.stats.gets_sent == (CART_SYNC_MAX_RETRIES * CART_SYNC_WINDOW));
+}
+
+int main(void) {
+    test_window_and_order();
+    test_dump_512();
+    test_set_then_get_sees_new_value();
+    test_lost_reply_resyncs();
+    test_absent_cart_gives_up();
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cart_proto.h"
+#include "cart_tx.h"
+
+static cart_tx_port_t g_port;
+
+/* -------------------------------------------------------------------------- */
+/* Démarrage, occupation et enchaînement                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_kick_and_chain(void) {
+    cart_tx_init(&g_port, 1000U);
+
+    /* Rien en attente : pas de transfert. */
+    assert(cart_tx_kick(&g_port, 0U) == 0U);
+    assert(!g_port.busy);
+
+    assert(cart_dirty_set(&g_port.dirty, 10U, 1U));
+    assert(cart_dirty_set(&g_port.dirty, 11U, 2U));
+    size_t len = cart_tx_kick(&g_port, 0U);
+    assert(len == 6U);
+    assert(g_port.busy);
+
+    uint8_t expected[8];
+    size_t e = cart_proto_build_set(10U, 1U, expected);
+    e += cart_proto_build_set(11U, 2U, &expected[e]);
+    assert(memcmp(g_port.buf, expected, e) == 0);
+
+    /* Pendant le transfert : le tampon n’est pas touché, les écritures s’accumulent. */
+    for (uint8_t v = 0U; v < 10U; ++v) {
+        assert(cart_dirty_set(&g_port.dirty, 10U, v));
+        assert(cart_tx_kick(&g_port, 0U) == 0U);
+    }
+    assert(memcmp(g_port.buf, expected, e) == 0);
+
+    /* Fin de DMA : un seul SET, dernière valeur. */
+    len = cart_tx_complete(&g_port, 0U);
+    assert(len == 3U);
+    e = cart_proto_build_set(10U, 9U, expected);
+    assert(memcmp(g_port.buf, expected, e) == 0);
+    assert(g_port.chained == 1U);
+
+    assert(cart_tx_complete(&g_port, 0U) == 0U);
+    assert(!g_port.busy);
+    assert((g_port.bursts == 2U) && (g_port.frames == 3U) && (g_port.bytes == 9U));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Admission par fenêtre                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_admission_window(void) {
+    cart_tx_init(&g_port, 1000U);
+    cart_tx_set_budget(&g_port, 4U, 20U); /* UI : 15 octets, fond : 10 */
+
+    for (uint16_t p = 0U; p < 8U; ++p) {
+        assert(cart_dirty_set_class(&g_port.dirty, CART_CLASS_SEQ, p, 1U, 0U));
+    }
+    for (uint16_t p = 100U; p < 103U; ++p) {
+        assert(cart_dirty_set_class(&g_port.dirty, CART_CLASS_UI, p, 2U, 0U));
+    }
+    assert(cart_sync_request(&g_port.sync, 200U));
+
+    /* Les p-locks passent au-delà du budget ; l’UI attend la fenêtre suivante. */
+    assert(cart_tx_kick(&g_port, 0U) == 24U);
+    assert(g_port.cls[CART_CLASS_SEQ].frames == 8U);
+    assert(g_port.cls[CART_CLASS_UI].deferred == 1U);
+    assert(cart_tx_complete(&g_port, 1U) == 0U);
+    assert(g_port.cls[CART_CLASS_UI].deferred == 2U);
+    assert(!g_port.busy);
+
+    /* Fenêtre suivante : l’UI part, le GET n’a plus sa part. */
+    assert(cart_tx_kick(&g_port, 4U) == 9U);
+    assert(g_port.cls[CART_CLASS_UI].frames == 3U);
+    assert(g_port.cls[CART_CLASS_UI].latency_max == 4U);
+    assert(g_port.cls[CART_CLASS_BACKGROUND].frames == 0U);
+    assert(cart_tx_complete(&g_port, 5U) == 0U);
+
+    uint8_t get[4];
+    assert(cart_tx_kick(&g_port, 8U) == cart_proto_build_get(200U, get));
+    assert(g_port.cls[CART_CLASS_BACKGROUND].frames == 1U);
+
+    /* Sans fenêtre : aucune limite. */
+    (void)cart_tx_complete(&g_port, 8U);
+    cart_tx_set_budget(&g_port, 0U, 0U);
+    for (uint16_t p = 100U; p < 140U; ++p) {
+        assert(cart_dirty_set_class(&g_port.dirty, CART_CLASS_UI, p, 3U, 8U));
+    }
+    assert(cart_tx_kick(&g_port, 8U) == 120U);
+
+    printf("cart_tx: admission ui_deferred=%u ui_latency_max=%u\n",
+           (unsigned)g_port.cls[CART_CLASS_UI].deferred, (unsigned)g_port.cls[CART_CLASS_UI].latency_max);
+}
+
+/* -------------------------------------------------------------------------- */
+/* UART simulée : temps d’octet configurable                                  */
+/* -------------------------------------------------------------------------- */
+
+#define SIM_PARAMS      256U
+#define SIM_STEPS       64U
+#define SIM_STEP_US     31250U  /* triple-croche à 240 BPM */
+
+typedef struct {
+    uint32_t byte_ns;           /* durée d’un octet (10 bits) */
+    uint64_t now_ns;
+    uint64_t dma_end_ns;        /* fin du transfert en cours (0 si inactif) */
+    uint8_t  wire_value[SIM_PARAMS];
+    uint32_t wire_bytes;
+    uint32_t wire_frames;
+    uint32_t isr_calls;
+    uint64_t busy_ns;
+} sim_uart_t;
+
+static sim_uart_t g_sim;
+static uint8_t g_last_written[SIM_PARAMS];
+
+static void sim_start(size_t len) {
+    /* Décodage des trames au moment où le DMA les prend. */
+    size_t i = 0U;
+    while (i < len) {
+        assert(g_port.buf[i] == 's');
+        const uint8_t p = g_port.buf[i + 1U];
+        assert(p != 255U);
+        g_sim.wire_value[p] = g_port.buf[i + 2U];
+        g_sim.wire_frames++;
+        i += 3U;
+    }
+    g_sim.wire_bytes += (uint32_t)len;
+    g_sim.dma_end_ns = g_sim.now_ns + ((uint64_t)len * g_sim.byte_ns);
+    g_sim.busy_ns += (uint64_t)len * g_sim.byte_ns;
+}
+
+/** Avance l’horloge simulée jusqu’à @p t_ns en servant les fins de DMA. */
+static void sim_advance(uint64_t t_ns) {
+    while ((g_sim.dma_end_ns != 0U) && (g_sim.dma_end_ns <= t_ns)) {
+        g_sim.now_ns = g_sim.dma_end_ns;
+        g_sim.dma_end_ns = 0U;
+        g_sim.isr_calls++;
+        const size_t len = cart_tx_complete(&g_port, 0U);
+        if (len != 0U) {
+            sim_start(len);
+        }
+    }
+    g_sim.now_ns = t_ns;
+}
+
+static void sim_write(uint16_t param, uint8_t value) {
+    assert(cart_dirty_set(&g_port.dirty, param, value));
+    g_last_written[param] = value;
+    const size_t len = cart_tx_kick(&g_port, 0U);
+    if (len != 0U) {
+        sim_start(len);
+    }
+}
+
+static void run_sim(uint32_t baud) {
+    cart_tx_init(&g_port, 1000U);
+    memset(&g_sim, 0, sizeof(g_sim));
+    memset(g_last_written, 0, sizeof(g_last_written));
+    g_sim.byte_ns = (uint32_t)(10000000000ULL / baud);
+
+    uint32_t writes = 0U;
+    for (uint32_t step = 0U; step < SIM_STEPS; ++step) {
+        const uint64_t t0 = (uint64_t)step * SIM_STEP_US * 1000U;
+        sim_advance(t0);
+
+        /* Rafale de p-locks : 16 pistes × 8 paramètres au début du step. */
+        for (uint16_t track = 0U; track < 16U; ++track) {
+            for (uint16_t k = 0U; k < 8U; ++k) {
+                const uint16_t param = (uint16_t)((track * 8U) + k);
+                sim_write(param, (uint8_t)(step + param));
+                writes++;
+            }
+        }
+
+        /* Balayage d’encodeur pendant le step : un paramètre toutes les 250 µs. */
+        for (uint32_t t = 250U; t < SIM_STEP_US; t += 250U) {
+            sim_advance(t0 + ((uint64_t)t * 1000U));
+            sim_write(200U, (uint8_t)(t / 250U));
+            writes++;
+        }
+    }
+    sim_advance(UINT64_MAX / 2U);
+
+    /* Dernière valeur de chaque paramètre arrivée sur le fil, port au repos. */
+    assert(!g_port.busy);
+    assert(memcmp(g_sim.wire_value, g_last_written, sizeof(g_last_written)) == 0);
+    assert(g_sim.wire_frames == g_port.frames);
+    assert(g_sim.wire_frames <= writes);
+    assert(g_sim.isr_calls == g_port.bursts);
+
+    printf("cart_tx: baud=%u writes=%u frames=%u bytes=%u dma_blocks=%u chained=%u coalesced=%u wire_load=%.1f%%\n",
+           (unsigned)baud, (unsigned)writes, (unsigned)g_port.frames, (unsigned)g_port.bytes,
+           (unsigned)g_port.bursts, (unsigned)g_port.chained, (unsigned)g_port.dirty.coalesced,
+           100.0 * (double)g_sim.busy_ns / (double)((uint64_t)SIM_STEPS * SIM_STEP_US * 1000U));
+}
+
+int main(void) {
+    test_kick_and_chain();
+    test_admission_window();
+    run_sim(500000U);
+    run_sim(31250U);    /* lien lent : la coalescence absorbe la surcharge */
+    return 0;
+}
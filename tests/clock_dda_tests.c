@@ -0,0 +1,143 @@
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/clock_dda.h"
+
+#define TEST_TICKS 1000000U
+
+/* Période exacte d’un tick (coups de timer). */
+static double exact_period(uint32_t mbpm) {
+    return (double)CLOCK_DDA_NUM / (double)mbpm;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Dérive cumulée nulle                                                       */
+/* -------------------------------------------------------------------------- */
+
+static void run_zero_drift(uint32_t mbpm) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, mbpm);
+    const uint32_t lo = (uint32_t)(CLOCK_DDA_NUM / mbpm);
+    const systime_t origin = (systime_t)0xFFFFF000U; /* rebouclage de systime_t */
+
+    uint32_t interval = clock_dda_start(&dda);
+    for (uint32_t n = 1U; n <= TEST_TICKS; ++n) {
+        /* Temps exact n × NUM / mbpm, tronqué : at × m ≤ n × NUM < (at + 1) × m. */
+        const uint64_t exact_num = (uint64_t)n * CLOCK_DDA_NUM;
+        const uint64_t at = clock_dda_time(&dda);
+        assert((at * mbpm) <= exact_num);
+        assert(exact_num < ((at + 1U) * mbpm));
+        assert((interval == lo) || (interval == (lo + 1U)));
+        assert(interval <= CLOCK_DDA_INTERVAL_MAX);
+
+        /* Horodatage systime : arrondi du temps exact, à un tick près. */
+        const double exact_st = ((double)exact_num / (double)mbpm) * CLOCK_DDA_ST_HZ / CLOCK_DDA_TIMER_HZ;
+        const systime_t expected = (systime_t)(origin + (systime_t)llround(exact_st));
+        const int32_t st_err = (int32_t)(uint32_t)(clock_dda_to_st(origin, at) - expected);
+        assert((st_err >= -1) && (st_err <= 1));
+
+        interval = clock_dda_next(&dda);
+    }
+
+    /* Ancien calcul : intervalle arrondi à la µs, erreur répétée à chaque tick. */
+    const double rounded = floor(exact_period(mbpm) + 0.5);
+    const double old_drift_ms = fabs(rounded - exact_period(mbpm)) * TEST_TICKS / 1000.0;
+    const double new_err_us = (double)TEST_TICKS * exact_period(mbpm) - (double)(clock_dda_time(&dda) - interval);
+    printf("clock_dda: bpm=%.3f ticks=%u err_us=%.3f rounded_drift_ms=%.1f\n",
+           (double)mbpm / 1000.0, (unsigned)TEST_TICKS, new_err_us, old_drift_ms);
+}
+
+static void test_zero_drift(void) {
+    run_zero_drift(120000U);
+    run_zero_drift(133337U);
+    run_zero_drift(97531U);
+    run_zero_drift(CLOCK_DDA_MBPM_MIN);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Changement de tempo et rampe sans redémarrage                              */
+/* -------------------------------------------------------------------------- */
+
+static void test_tempo_change_keeps_phase(void) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, 120000U);
+    (void)clock_dda_start(&dda);
+    double expected = exact_period(120000U);
+    for (uint32_t n = 1U; n < 100U; ++n) {
+        (void)clock_dda_next(&dda);
+        expected += exact_period(120000U);
+    }
+    clock_dda_set_tempo(&dda, 140000U);
+    for (uint32_t n = 0U; n < 1000U; ++n) {
+        (void)clock_dda_next(&dda);
+        expected += exact_period(140000U);
+    }
+    const double err = expected - (double)clock_dda_time(&dda);
+    assert((err >= 0.0) && (err < 2.0));
+}
+
+static void test_ramp(void) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, 120000U);
+    (void)clock_dda_start(&dda);
+    double expected = exact_period(120000U);
+
+    clock_dda_ramp(&dda, 180000U, 96U);
+    uint32_t prev = clock_dda_next(&dda);
+    expected += exact_period(clock_dda_tempo(&dda));
+    for (uint32_t n = 1U; n < 96U; ++n) {
+        const uint32_t interval = clock_dda_next(&dda);
+        expected += exact_period(clock_dda_tempo(&dda));
+        assert(interval <= (prev + 1U)); /* accelerando : jamais plus lent (au tramage près) */
+        prev = interval;
+        if (n == 47U) {
+            const int32_t mid = (int32_t)clock_dda_tempo(&dda) - 150000;
+            assert((mid >= -1000) && (mid <= 1000));
+        }
+    }
+    assert(clock_dda_tempo(&dda) == 180000U);
+    const double err = expected - (double)clock_dda_time(&dda);
+    assert((err > -2.0) && (err < 2.0));
+
+    /* La rampe finie, le tempo ne bouge plus. */
+    (void)clock_dda_next(&dda);
+    assert(clock_dda_tempo(&dda) == 180000U);
+
+    /* Une consigne directe abandonne la rampe. */
+    clock_dda_ramp(&dda, 60000U, 24U);
+    clock_dda_set_tempo(&dda, 90000U);
+    (void)clock_dda_next(&dda);
+    assert(clock_dda_tempo(&dda) == 90000U);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Durées systime et bornes                                                   */
+/* -------------------------------------------------------------------------- */
+
+static void test_spans_and_limits(void) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, 120000U);
+    assert(clock_dda_span_st(&dda, 1U) == 208U);   /* 20,833 ms */
+    assert(clock_dda_span_st(&dda, 6U) == 1250U);  /* 125 ms, et non 6 × 208 */
+    assert(clock_dda_span_st(&dda, 24U) == 5000U);
+
+    assert(clock_dda_mbpm_from_bpm(120.0f) == 120000U);
+    assert(clock_dda_mbpm_from_bpm(10.0f) == CLOCK_DDA_MBPM_MIN);
+    assert(clock_dda_mbpm_from_bpm(0.0f) == CLOCK_DDA_MBPM_MIN);
+    assert(clock_dda_mbpm_from_bpm(5000.0f) == CLOCK_DDA_MBPM_MAX);
+
+    clock_dda_init(&dda, 1000U); /* borné au tempo minimal : le timer 16 bits suffit */
+    assert(clock_dda_tempo(&dda) == CLOCK_DDA_MBPM_MIN);
+    assert(clock_dda_start(&dda) <= CLOCK_DDA_INTERVAL_MAX);
+}
+
+int main(void) {
+    test_zero_drift();
+    test_tempo_change_keeps_phase();
+    test_ramp();
+    test_spans_and_limits();
+    return 0;
+}
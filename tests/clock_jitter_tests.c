@@ -0,0 +1,168 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/clock_dda.h"
+#include "core/clock_jitter.h"
+
+/* -------------------------------------------------------------------------- */
+/* Sonde                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_probe_arithmetic(void) {
+    clock_jitter_t j;
+    clock_jitter_reset(&j);
+
+    clock_jitter_add(&j, 1000U, 1004U);   /* premier : retard seul */
+    assert((j.samples == 1U) && (j.intervals == 0U));
+    assert((j.late_last == 4U) && (j.jitter_max == 0U));
+
+    clock_jitter_add(&j, 2000U, 2004U);   /* retard constant : aucune gigue */
+    assert((j.jitter_last == 0U) && (j.late_max == 4U));
+
+    clock_jitter_add(&j, 3000U, 3010U);   /* intervalle +6 */
+    assert(j.jitter_last == 6U);
+    clock_jitter_add(&j, 4000U, 3999U);   /* en avance : retard 0, intervalle −11 */
+    assert((j.late_last == 0U) && (j.jitter_last == 11U));
+    assert((j.jitter_max == 11U) && (j.jitter_sum == 17U) && (j.intervals == 3U));
+    assert(j.late_sum == 18U);
+
+    /* Rebouclage de la base µs. */
+    clock_jitter_add(&j, UINT32_MAX - 99U, UINT32_MAX - 97U);
+    clock_jitter_add(&j, 900U, 905U);
+    assert(j.jitter_last == 3U);
+
+    /* Nouvelle origine : pas de gigue à travers la coupure, stats gardées. */
+    clock_jitter_rebase(&j);
+    clock_jitter_add(&j, 500000U, 500002U);
+    assert((j.intervals == 5U) && (j.jitter_max == 11U) && (j.samples == 7U));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Simulateur : F8 depuis le thread vs depuis l’ISR                           */
+/* -------------------------------------------------------------------------- */
+
+#define SIM_MBPM        120000U
+#define SIM_TICKS       (24U * 4U * 16U)  /* 16 mesures */
+#define SIM_QUEUE       8U                /* MIDI_CLOCK_TICK_QUEUE */
+#define SIM_WAKE_US     6U                /* ISR → thread : commutation de contexte */
+
+static uint32_t s_lcg = 12345U;
+
+static uint32_t lcg(void) {
+    s_lcg = (s_lcg * 1664525U) + 1013904223U;
+    return s_lcg >> 8;
+}
+
+/* Latence d’entrée en ISR : 1 µs plus une section critique masquée (0–4 µs). */
+static uint32_t isr_latency(void) {
+    return 1U + (lcg() % 5U);
+}
+
+/* Coût du callback séquenceur : léger hors step, lourd au step (runner, 16
+ * pistes, p-locks), avec un step sur quatre plus long qu’une période de tick. */
+static uint32_t seq_cost(uint32_t tick) {
+    if ((tick % 6U) != 0U) {
+        return 40U + (lcg() % 40U);
+    }
+    const uint32_t step = tick / 6U;
+    return ((step % 4U) == 3U) ? (22000U + (lcg() % 4000U)) : (1500U + (lcg() % 3000U));
+}
+
+typedef struct {
+    clock_jitter_t f8;
+    clock_jitter_t seq;
+    uint32_t       queue_high_water;
+    uint32_t       overruns;
+} sim_result_t;
+
+/*
+ * from_isr = false : ancien chemin, le thread envoie le F8 puis exécute le step
+ *                    (F8 retardé par le réveil et par le step précédent) ;
+ * from_isr = true  : F8 émis dans l’ISR, steps servis dans l’ordre par le thread.
+ */
+static void simulate(bool from_isr, sim_result_t *r) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, SIM_MBPM);
+    (void)clock_dda_start(&dda);
+    clock_jitter_reset(&r->f8);
+    clock_jitter_reset(&r->seq);
+    r->queue_high_water = 0U;
+    r->overruns = 0U;
+    s_lcg = 12345U;
+
+    hr_time_t busy_until = 0U;       /* fin du callback en cours */
+    hr_time_t starts[SIM_QUEUE];     /* début de service des ticks en file */
+    uint32_t q_count = 0U;
+    uint32_t q_head = 0U;
+
+    for (uint32_t tick = 0U; tick < SIM_TICKS; ++tick) {
+        const hr_time_t nominal = (hr_time_t)clock_dda_time(&dda);
+        const hr_time_t irq = nominal + isr_latency();
+
+        /* Ticks déjà servis quand celui-ci tombe. */
+        while ((q_count != 0U) && (hr_time_diff(starts[q_head], irq) >= 0)) {
+            q_head = (q_head + 1U) % SIM_QUEUE;
+            q_count--;
+        }
+
+        hr_time_t wake = irq + SIM_WAKE_US;
+        if (hr_time_diff(wake, busy_until) > 0) {
+            wake = busy_until;
+        }
+        if (from_isr) {
+            clock_jitter_add(&r->f8, nominal, irq);
+            if (q_count >= SIM_QUEUE) {
+                r->overruns++;
+                (void)clock_dda_next(&dda);
+                continue;
+            }
+            starts[(q_head + q_count) % SIM_QUEUE] = wake;
+            q_count++;
+            if (q_count > r->queue_high_water) {
+                r->queue_high_water = q_count;
+            }
+            clock_jitter_add(&r->seq, nominal, wake);
+            busy_until = wake + seq_cost(tick);
+        } else {
+            clock_jitter_add(&r->f8, nominal, wake);  /* midi_clock() en tête du thread */
+            clock_jitter_add(&r->seq, nominal, wake);
+            busy_until = wake + seq_cost(tick);
+        }
+        (void)clock_dda_next(&dda);
+    }
+}
+
+static void test_f8_jitter_simulation(void) {
+    sim_result_t thread_path;
+    sim_result_t isr_path;
+    simulate(false, &thread_path);
+    simulate(true, &isr_path);
+
+    /* Chemin ISR : gigue bornée par la seule latence d’interruption. */
+    assert(isr_path.f8.samples == SIM_TICKS);
+    assert(isr_path.f8.jitter_max <= 4U);
+    assert(isr_path.f8.late_max <= 5U);
+    /* Ancien chemin : le step lourd déborde sur le tick suivant. */
+    assert(thread_path.f8.jitter_max > 1000U);
+    /* Le séquenceur voit les mêmes retards, sans perte de tick. */
+    assert(isr_path.overruns == 0U);
+    assert(isr_path.queue_high_water < SIM_QUEUE);
+    assert(isr_path.seq.samples == SIM_TICKS);
+    assert(isr_path.seq.late_max == thread_path.seq.late_max);
+
+    printf("clock_jitter: ticks=%u thread_f8_jitter_max=%u thread_f8_jitter_avg=%.1f "
+           "isr_f8_jitter_max=%u isr_f8_jitter_avg=%.2f seq_late_max=%u queue_high_water=%u\n",
+           (unsigned)SIM_TICKS, (unsigned)thread_path.f8.jitter_max,
+           (double)thread_path.f8.jitter_sum / (double)thread_path.f8.intervals,
+           (unsigned)isr_path.f8.jitter_max,
+           (double)isr_path.f8.jitter_sum / (double)isr_path.f8.intervals,
+           (unsigned)isr_path.seq.late_max, (unsigned)isr_path.queue_high_water);
+}
+
+int main(void) {
+    test_probe_arithmetic();
+    test_f8_jitter_simulation();
+    return 0;
+}
@@ -0,0 +1,345 @@
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/clock_dda.h"
+#include "core/clock_manager.h"
+#include "core/clock_slave.h"
+#include "core/hr_time.h"
+#include "midi.h"
+
+#define TEST_JITTER_ST 10  /* ±1 ms (trame USB) à 10 kHz */
+
+/* -------------------------------------------------------------------------- */
+/* Stubs (host)                                                               */
+/* -------------------------------------------------------------------------- */
+
+static float g_internal_bpm = 120.0f;
+static bool g_internal_running = false;
+static void (*g_internal_tick_cb)(systime_t now, hr_time_t now_hr) = NULL;
+static int32_t g_spp_sent = -1;
+static unsigned g_continue_sent = 0U;
+
+void midi_clock_init(void) {}
+void midi_clock_register_tick_callback(void (*cb)(systime_t now, hr_time_t now_hr)) { g_internal_tick_cb = cb; }
+void midi_clock_register_service_callback(bool (*cb)(systime_t now, systime_t *next_due)) { (void)cb; }
+void midi_clock_kick(void) {}
+void midi_clock_start(void) { g_internal_running = true; }
+void midi_clock_stop(void) { g_internal_running = false; }
+void midi_clock_set_bpm(float bpm) { g_internal_bpm = bpm; }
+void midi_clock_ramp_bpm(float bpm, uint32_t ticks) {
+    (void)ticks;
+    g_internal_bpm = bpm;
+}
+float midi_clock_get_bpm(void) { return g_internal_bpm; }
+systime_t midi_clock_span_st(uint32_t ticks) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, clock_dda_mbpm_from_bpm(g_internal_bpm));
+    return clock_dda_span_st(&dda, ticks);
+}
+hr_time_t midi_clock_span_hr(uint32_t ticks) {
+    clock_dda_t dda;
+    clock_dda_init(&dda, clock_dda_mbpm_from_bpm(g_internal_bpm));
+    return (hr_time_t)clock_dda_span(&dda, ticks);
+}
+bool midi_clock_is_running(void) { return g_internal_running; }
+void midi_song_position(midi_dest_t dest, uint16_t pos14) {
+    (void)dest;
+    g_spp_sent = pos14;
+}
+void midi_start(midi_dest_t dest) { (void)dest; }
+void midi_continue(midi_dest_t dest) {
+    (void)dest;
+    g_continue_sent++;
+}
+void midi_stop(midi_dest_t dest) { (void)dest; }
+
+/* -------------------------------------------------------------------------- */
+/* Générateur de F8 synthétique (maître DAW)                                  */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    double t;          /* Temps idéal du prochain F8 (systime, fractionnaire). */
+    double period;     /* Période idéale d’un tick. */
+    uint32_t rng;
+    systime_t origin;  /* Décalage pour tester le rebouclage de systime_t. */
+} f8_gen_t;
+
+static double period_for_bpm(double bpm) {
+    return (60.0 * (double)CLOCK_SLAVE_ST_HZ) / (24.0 * bpm);
+}
+
+static void gen_init(f8_gen_t *gen, double bpm, systime_t origin) {
+    gen->t = 1000.0;
+    gen->period = period_for_bpm(bpm);
+    gen->rng = 0x12345678U;
+    gen->origin = origin;
+}
+
+static int gen_jitter(f8_gen_t *gen) {
+    gen->rng = (gen->rng * 1103515245U) + 12345U;
+    return (int)((gen->rng >> 16) % (2U * TEST_JITTER_ST + 1U)) - TEST_JITTER_ST;
+}
+
+/* Horodatage reçu = tick idéal quantifié à la base 10 kHz + gigue de transport. */
+static systime_t gen_next(f8_gen_t *gen) {
+    const systime_t ts = (systime_t)(gen->origin + (systime_t)((int64_t)floor(gen->t) + gen_jitter(gen)));
+    gen->t += gen->period;
+    return ts;
+}
+
+/* Horodatage d’un message de transport, glissé entre deux F8. */
+static systime_t gen_between(const f8_gen_t *gen) {
+    return (systime_t)(gen->origin + (systime_t)((int64_t)floor(gen->t - (gen->period / 2.0))));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests PLL                                                                  */
+/* -------------------------------------------------------------------------- */
+
+static void test_pll_locks_on_jittered_stream(void) {
+    clock_slave_reset();
+    f8_gen_t gen;
+    gen_init(&gen, 120.0, 0U);
+
+    assert(!clock_slave_on_tick(gen_next(&gen)));
+    for (unsigned i = 0U; i < 24U * 16U; ++i) {
+        assert(clock_slave_on_tick(gen_next(&gen)));
+    }
+
+    assert(clock_slave_is_locked());
+    assert(clock_slave_stats.locks == 1U);
+    assert(fabsf(clock_slave_get_bpm() - 120.0f) < 0.5f);
+
+    systime_t tick_st = 0U;
+    systime_t step_st = 0U;
+    assert(clock_slave_get_periods(&tick_st, &step_st));
+    assert(tick_st == 208U);   /* 20,83 ms */
+    assert(step_st == 1250U);  /* 125 ms */
+
+    /* Gigue brute jusqu’à 2×±1 ms, erreur de phase filtrée bien en deçà. */
+    assert(clock_slave_stats.jitter_max <= (2U * TEST_JITTER_ST) + 1U);
+    assert(clock_slave_stats.phase_err_max <= 2U * TEST_JITTER_ST);
+    assert(clock_slave_stats.dropouts == 0U);
+
+    printf("clock_slave: bpm=%.2f tick_st=%u jitter_max=%u jitter_avg=%.2f phase_err_max=%u drift_ppm=%d\n",
+           (double)clock_slave_get_bpm(), (unsigned)tick_st, (unsigned)clock_slave_stats.jitter_max,
+           (double)clock_slave_stats.jitter_sum / (double)clock_slave_stats.ticks,
+           (unsigned)clock_slave_stats.phase_err_max, (int)clock_slave_stats.drift_ppm);
+}
+
+static void test_pll_follows_tempo_change(void) {
+    clock_slave_reset();
+    f8_gen_t gen;
+    gen_init(&gen, 120.0, 0U);
+    for (unsigned i = 0U; i < 24U * 8U; ++i) {
+        (void)clock_slave_on_tick(gen_next(&gen));
+    }
+    assert(clock_slave_is_locked());
+
+    /* Rampe de tempo du maître 120 → 126 BPM sur 4 mesures : suivie sans décrochage. */
+    const unsigned ramp_ticks = 24U * 16U;
+    for (unsigned i = 0U; i < ramp_ticks; ++i) {
+        gen.period = period_for_bpm(120.0 + (6.0 * (double)i / (double)ramp_ticks));
+        (void)clock_slave_on_tick(gen_next(&gen));
+    }
+    for (unsigned i = 0U; i < 24U * 4U; ++i) {
+        (void)clock_slave_on_tick(gen_next(&gen));
+    }
+    assert(clock_slave_is_locked());
+    assert(clock_slave_stats.locks == 1U);
+    assert(fabsf(clock_slave_get_bpm() - 126.0f) < 0.5f);
+    assert(clock_slave_stats.drift_ppm < -40000);  /* période ≈ −4,8 % vs verrouillage à 120 */
+
+    /* Saut brutal à 140 BPM : décrochage, gains d’acquisition, reverrouillage. */
+    gen.period = period_for_bpm(140.0);
+    for (unsigned i = 0U; i < 24U * 8U; ++i) {
+        (void)clock_slave_on_tick(gen_next(&gen));
+    }
+    assert(clock_slave_is_locked());
+    assert(clock_slave_stats.locks == 2U);
+    assert(fabsf(clock_slave_get_bpm() - 140.0f) < 0.5f);
+}
+
+static void test_pll_wraps_and_recovers_from_dropout(void) {
+    clock_slave_reset();
+    f8_gen_t gen;
+    gen_init(&gen, 100.0, (systime_t)(UINT32_MAX - 20000U));
+    for (unsigned i = 0U; i < 24U * 8U; ++i) {
+        (void)clock_slave_on_tick(gen_next(&gen));
+    }
+    assert(clock_slave_is_locked());
+    assert(fabsf(clock_slave_get_bpm() - 100.0f) < 0.5f);
+
+    /* Le maître se tait une mesure : la période est conservée, la phase réacquise. */
+    gen.t += gen.period * 96.0;
+    (void)clock_slave_on_tick(gen_next(&gen));
+    assert(clock_slave_stats.dropouts == 1U);
+    assert(!clock_slave_is_locked());
+    assert(fabsf(clock_slave_get_bpm() - 100.0f) < 0.5f);
+
+    for (unsigned i = 0U; i < 24U * 4U; ++i) {
+        (void)clock_slave_on_tick(gen_next(&gen));
+    }
+    assert(clock_slave_is_locked());
+    assert(fabsf(clock_slave_get_bpm() - 100.0f) < 0.5f);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Intégration clock_manager (mode esclave)                                   */
+/* -------------------------------------------------------------------------- */
+
+static unsigned g_steps = 0U;
+static clock_step_info_t g_last_step;
+static unsigned g_ticks = 0U;
+static unsigned g_transport[3];
+static uint32_t g_transport_step = 0U;
+
+static void on_step(const clock_step_info_t *info) {
+    g_last_step = *info;
+    ++g_steps;
+}
+
+static void on_tick(systime_t now) {
+    (void)now;
+    ++g_ticks;
+}
+
+static void on_transport(clock_transport_event_t ev, uint32_t step_idx_abs) {
+    g_transport[ev]++;
+    g_transport_step = step_idx_abs;
+}
+
+/* Horodatage µs vu par clock_manager (horloge système du stub figée à 0). */
+static hr_time_t hr_of(systime_t st) {
+    return hr_time_span_from_st(st);
+}
+
+static hr_time_t g_last_f8_hr = 0U;
+
+static void feed_ticks(f8_gen_t *gen, unsigned count) {
+    for (unsigned i = 0U; i < count; ++i) {
+        g_last_f8_hr = hr_of(gen_next(gen));
+        clock_manager_on_midi_realtime(0xF8U, g_last_f8_hr);
+    }
+}
+
+static void test_clock_manager_slave_transport(void) {
+    clock_manager_init(CLOCK_SRC_INTERNAL);
+    clock_manager_register_step_callback2(on_step);
+    clock_manager_register_tick_callback(on_tick);
+    clock_manager_register_transport_callback(on_transport);
+
+    f8_gen_t gen;
+    gen_init(&gen, 90.0, 0U);
+
+    /* Source interne : les F8 reçus sont ignorés. */
+    feed_ticks(&gen, 12U);
+    assert(g_ticks == 0U);
+
+    clock_manager_set_source(CLOCK_SRC_MIDI);
+    clock_manager_start();
+    assert(!clock_manager_is_running());
+
+    /* Le maître envoie des F8 à l’arrêt : la PLL se cale, aucun step. */
+    feed_ticks(&gen, 48U);
+    assert(g_ticks == 0U);
+    assert(clock_slave_is_locked());
+    assert(fabsf(clock_manager_get_bpm() - 90.0f) < 0.5f);
+
+    clock_manager_on_midi_realtime(0xFAU, hr_of(gen_between(&gen)));
+    assert(clock_manager_is_running());
+    assert(g_transport[CLOCK_TRANSPORT_START] == 1U);
+    assert(g_transport_step == 0U);
+
+    feed_ticks(&gen, 1U);
+    assert((g_steps == 1U) && (g_last_step.step_idx_abs == 0U));
+    assert(g_last_step.ext_clock);
+    assert(fabsf(g_last_step.bpm - 90.0f) < 0.5f);
+    assert(g_last_step.tick_st == (systime_t)(period_for_bpm(90.0) + 0.5));
+    /* Même tick en µs : horodatage du F8 reçu, période PLL sans arrondi au tick système. */
+    assert(g_last_step.now_hr == g_last_f8_hr);
+    assert(g_last_step.now == (systime_t)(g_last_f8_hr / HR_TIME_PER_ST));
+    assert(fabs((double)g_last_step.tick_hr - (period_for_bpm(90.0) * HR_TIME_PER_ST)) < 50.0);
+    assert(fabs((double)g_last_step.step_hr - (6.0 * period_for_bpm(90.0) * HR_TIME_PER_ST)) < 300.0);
+
+    feed_ticks(&gen, 6U * 4U - 1U);
+    assert((g_steps == 4U) && (g_last_step.step_idx_abs == 3U));
+
+    clock_manager_on_midi_realtime(0xFCU, hr_of(gen_between(&gen)));
+    assert(!clock_manager_is_running());
+    assert(g_transport[CLOCK_TRANSPORT_STOP] == 1U);
+    feed_ticks(&gen, 12U);
+    assert(g_steps == 4U);
+
+    /* SPP = 32 doubles-croches, puis Continue : reprise au step 32. */
+    clock_manager_on_song_position(32U);
+    clock_manager_on_midi_realtime(0xFBU, hr_of(gen_between(&gen)));
+    assert(g_transport[CLOCK_TRANSPORT_CONTINUE] == 1U);
+    assert(g_transport_step == 32U);
+    feed_ticks(&gen, 1U);
+    assert((g_steps == 5U) && (g_last_step.step_idx_abs == 32U));
+
+    clock_manager_set_source(CLOCK_SRC_INTERNAL);
+    assert(!clock_manager_is_running());
+}
+
+/* -------------------------------------------------------------------------- */
+/* Intégration clock_manager (horloge interne : position et Continue)         */
+/* -------------------------------------------------------------------------- */
+
+static void test_clock_manager_internal_locate_continue(void) {
+    clock_manager_init(CLOCK_SRC_INTERNAL);
+    clock_manager_register_step_callback2(on_step);
+    clock_manager_register_tick_callback(on_tick);
+    g_steps = 0U;
+    g_spp_sent = -1;
+    g_continue_sent = 0U;
+
+    /* Départ au step 40 : SPP puis Continue, premier step au premier F8. */
+    assert(clock_manager_locate(40U));
+    clock_manager_continue();
+    assert(clock_manager_is_running());
+    assert((g_spp_sent == 40) && (g_continue_sent == 1U));
+    assert(!clock_manager_locate(0U));  /* transport en marche : refusé */
+    clock_manager_continue();           /* déjà en marche : rien de plus */
+    assert(g_continue_sent == 1U);
+
+    assert(g_internal_tick_cb != NULL);
+    g_internal_tick_cb(100U, hr_time_span_from_st(100U));
+    assert((g_steps == 1U) && (g_last_step.step_idx_abs == 40U));
+    for (unsigned i = 0U; i < 6U; ++i) {
+        g_internal_tick_cb(200U + i, hr_time_span_from_st(200U + i));
+    }
+    assert((g_steps == 2U) && (g_last_step.step_idx_abs == 41U));
+
+    /* Arrêt au milieu du step 42 : la reprise repart du step 42. */
+    g_internal_tick_cb(300U, hr_time_span_from_st(300U));
+    clock_manager_stop();
+    assert(clock_manager_get_position() == 42U);
+    clock_manager_continue();
+    assert((g_spp_sent == 42) && (g_continue_sent == 2U));
+    g_internal_tick_cb(400U, hr_time_span_from_st(400U));
+    assert((g_steps == 3U) && (g_last_step.step_idx_abs == 42U));
+    clock_manager_stop();
+
+    /* Start repart du début (SPP 0), position SPP sur 14 bits. */
+    clock_manager_start();
+    assert((g_spp_sent == 0) && (clock_manager_get_position() == 0U));
+    clock_manager_stop();
+    assert(clock_manager_locate(0x4000U + 5U));
+    clock_manager_continue();
+    assert(g_spp_sent == 5);
+    clock_manager_stop();
+}
+
+int main(void) {
+    test_pll_locks_on_jittered_stream();
+    test_pll_follows_tempo_change();
+    test_pll_wraps_and_recovers_from_dropout();
+    test_clock_manager_slave_transport();
+    test_clock_manager_internal_locate_continue();
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/hr_time.h"
+
+extern hr_time_t g_hr_time_stub_offset;
+
+/* -------------------------------------------------------------------------- */
+/* Écarts et durées                                                           */
+/* -------------------------------------------------------------------------- */
+
+static void test_diff_wraps(void) {
+    assert(hr_time_diff(100U, 250U) == 150);
+    assert(hr_time_diff(250U, 100U) == -150);
+    /* Rebouclage des 32 bits (≈ 71 min) : l’écart reste petit et signé. */
+    assert(hr_time_diff(UINT32_MAX - 9U, 10U) == 20);
+    assert(hr_time_diff(10U, UINT32_MAX - 9U) == -20);
+    assert(HR_TIME_MS(60U) == 60000U);
+}
+
+static void test_spans(void) {
+    assert(HR_TIME_PER_ST == 100U);
+    assert(hr_time_span_from_st(208U) == 20800U);
+    assert(hr_time_span_to_st(20833U) == 208U);  /* tick 24 PPQN à 120 BPM */
+    assert(hr_time_span_to_st(20850U) == 209U);  /* arrondi au plus proche */
+    assert(hr_time_span_to_st(49U) == 0U);
+    assert(hr_time_span_to_st(50U) == 1U);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Instants µs ↔ systime                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_instant_conversions(void) {
+    hr_time_init();
+    ch_stub_set_time(5000U);
+    g_hr_time_stub_offset = 37U;  /* 37 µs après le début du tick 5000 */
+
+    systime_t st = 0U;
+    const hr_time_t now = hr_time_sample(&st);
+    assert(st == 5000U);
+    assert(now == 500037U);
+    assert(hr_time_now() == now);
+
+    /* Passé : 12,34 ms avant maintenant → 123 ticks en arrière (arrondi). */
+    assert(hr_time_to_st(now - 12340U) == (systime_t)(5000U - 123U));
+    /* Futur proche : symétrique. */
+    assert(hr_time_to_st(now + 12360U) == (systime_t)(5000U + 124U));
+    assert(hr_time_to_st(now) == 5000U);
+
+    /* Aller-retour : exact au tick près. */
+    assert(hr_time_from_st(4000U) == (hr_time_t)(now - 100000U));
+    assert(hr_time_to_st(hr_time_from_st(4000U)) == 4000U);
+}
+
+static void test_conversions_across_wrap(void) {
+    /* systime_t proche du rebouclage, base µs déjà rebouclée. */
+    ch_stub_set_time((systime_t)(UINT32_MAX - 50U));
+    g_hr_time_stub_offset = 0U;
+    systime_t st = 0U;
+    const hr_time_t now = hr_time_sample(&st);
+
+    const hr_time_t later = now + 10000U;  /* +100 ticks : systime reboucle */
+    assert(hr_time_to_st(later) == (systime_t)(st + 100U));
+    assert(hr_time_from_st((systime_t)(st + 100U)) == later);
+    assert(hr_time_diff(now, later) == 10000);
+
+    printf("hr_time: per_st=%u now=%u st=%u\n", (unsigned)HR_TIME_PER_ST, (unsigned)now, (unsigned)st);
+}
+
+int main(void) {
+    test_diff_wraps();
+    test_spans();
+    test_instant_conversions();
+    test_conversions_across_wrap();
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/latency_cal.h"
+
+/* -------------------------------------------------------------------------- */
+/* Sondes et échos                                                            */
+/* -------------------------------------------------------------------------- */
+
+static void test_min_round_trip(void) {
+    latency_cal_t c;
+    latency_cal_start(&c, 3U, 20000U);
+    assert(c.state == LATENCY_CAL_RUNNING);
+
+    /* Une seule sonde en vol : pas de nouvelle demande avant l’écho. */
+    assert(latency_cal_poll(&c, 1000U));
+    latency_cal_sent(&c, 1000U);
+    assert(!latency_cal_poll(&c, 1200U));
+    latency_cal_echo(&c, 1701U);             /* 701 µs */
+
+    assert(latency_cal_poll(&c, 2000U));
+    latency_cal_sent(&c, 2000U);
+    latency_cal_echo(&c, 2641U);             /* 641 µs : le minimum */
+    latency_cal_echo(&c, 2700U);             /* doublon : ignoré */
+
+    assert(latency_cal_poll(&c, 3000U));
+    latency_cal_sent(&c, 3000U);
+    latency_cal_sample(&c, 900U);            /* aller-retour mesuré par le lien */
+
+    assert(!latency_cal_poll(&c, 4000U));
+    assert(c.state == LATENCY_CAL_DONE);
+    assert((c.samples == 3U) && (c.rtt_min == 641U) && (c.rtt_max == 900U));
+    assert(c.rtt_sum == 2242U);
+    assert(latency_cal_offset_us(&c) == -321);  /* moitié arrondie au µs */
+
+    /* Terminée : plus de sonde ni d’écho pris en compte. */
+    latency_cal_echo(&c, 5000U);
+    assert(c.samples == 3U);
+}
+
+static void test_timeouts(void) {
+    latency_cal_t c;
+    latency_cal_start(&c, 4U, 20000U);
+
+    /* Sans bouclage : trois sondes perdues, pas de décalage. */
+    hr_time_t now = 0U;
+    for (unsigned i = 0U; i < LATENCY_CAL_MAX_MISSES; ++i) {
+        assert(latency_cal_poll(&c, now));
+        latency_cal_sent(&c, now);
+        assert(!latency_cal_poll(&c, now + 19999U));
+        now += 20000U;
+    }
+    assert(!latency_cal_poll(&c, now));
+    assert(c.state == LATENCY_CAL_NO_LOOPBACK);
+    assert(latency_cal_offset_us(&c) == 0);
+
+    /* Un écho remet le compte des pertes à zéro ; une liaison devenue
+       muette après des échos garde la mesure. Base µs rebouclée au passage. */
+    now = UINT32_MAX - 30000U;
+    latency_cal_start(&c, 4U, 20000U);
+    assert(latency_cal_poll(&c, now));
+    latency_cal_sent(&c, now);
+    assert(latency_cal_poll(&c, now + 20000U));  /* perte 1 */
+    latency_cal_sent(&c, now + 20000U);
+    latency_cal_echo(&c, now + 19990U);         /* antérieur à l’émission : ignoré */
+    assert(c.pending && (c.misses == 1U));
+    latency_cal_echo(&c, now + 20480U);         /* écho après rebouclage */
+    assert(!c.pending && (c.misses == 0U));
+    now += 40000U;
+    for (unsigned i = 0U; i < LATENCY_CAL_MAX_MISSES; ++i) {
+        assert(latency_cal_poll(&c, now));
+        latency_cal_sent(&c, now);
+        now += 20000U;
+    }
+    assert(!latency_cal_poll(&c, now));
+    assert(c.state == LATENCY_CAL_DONE);
+    assert((c.samples == 1U) && (c.rtt_min == 480U));
+    assert(latency_cal_offset_us(&c) == -240);
+
+    printf("latency_cal: rtt_min=%u offset_us=%d misses=%u\n",
+           (unsigned)c.rtt_min, (int)latency_cal_offset_us(&c), (unsigned)c.misses);
+}
+
+static void test_idle(void) {
+    latency_cal_t c = {0};
+    assert(!latency_cal_poll(&c, 0U));
+    latency_cal_sent(&c, 0U);
+    latency_cal_echo(&c, 10U);
+    assert((c.state == LATENCY_CAL_IDLE) && !c.pending && (c.samples == 0U));
+    assert(latency_cal_offset_us(&c) == 0);
+}
+
+int main(void) {
+    test_min_round_trip();
+    test_timeouts();
+    test_idle();
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "midi_din_out.h"
+
+static midi_din_out_t g_out;
+
+static void push3(uint8_t st, uint8_t d1, uint8_t d2) {
+    const uint8_t m[3] = {st, d1, d2};
+    assert(midi_din_out_push(&g_out, m, 3U));
+}
+
+static void push1(uint8_t st) {
+    assert(midi_din_out_push(&g_out, &st, 1U));
+}
+
+static size_t drain_all(uint8_t *out, size_t cap) {
+    size_t n = 0U;
+    size_t chunk;
+    /* Petits blocs, comme le thread DIN. */
+    while ((chunk = midi_din_out_drain(&g_out, &out[n], (cap - n) < 6U ? (cap - n) : 6U)) != 0U) {
+        n += chunk;
+    }
+    return n;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Priorités et running status                                                */
+/* -------------------------------------------------------------------------- */
+
+static void test_priority_and_running_status(void) {
+    midi_din_out_init(&g_out);
+
+    /* Ordre d’arrivée volontairement mélangé. */
+    push3(0xB0, 7, 100);    /* CC */
+    push3(0x90, 60, 100);   /* ON  ch0 */
+    push3(0x80, 48, 0);     /* OFF ch0 (vélocité neutre) */
+    push3(0x91, 40, 90);    /* ON  ch1 */
+    push3(0x90, 64, 100);   /* ON  ch0 */
+    push3(0x81, 41, 0);     /* OFF ch1 */
+    push1(0xF8);            /* Clock */
+    push3(0x80, 50, 64);    /* OFF ch0 (vélocité neutre) */
+
+    uint8_t out[64];
+    const size_t n = drain_all(out, sizeof(out));
+
+    const uint8_t expected[] = {
+        0xF8,                    /* temps réel d’abord */
+        0x90, 48, 0, 50, 0,      /* OFF ch0 en NOTE_ON vél. 0, running status */
+        0x91, 41, 0,             /* OFF ch1 */
+        40, 90,                  /* ON ch1 : enchaîne le running status 0x91 */
+        0x90, 60, 100, 64, 100,  /* ON ch0 */
+        0xB0, 7, 100             /* CC en dernier */
+    };
+    assert(n == sizeof(expected));
+    assert(memcmp(out, expected, n) == 0);
+    assert(g_out.stats.off_as_on == 3U);
+    assert(g_out.stats.bytes_saved == 3U);
+    assert(midi_din_out_pending(&g_out) == 0U);
+}
+
+static void test_release_velocity_and_realtime(void) {
+    midi_din_out_init(&g_out);
+    uint8_t out[32];
+
+    /* Vélocité de relâchement significative : NOTE_OFF conservé. */
+    push3(0x82, 60, 90);
+    push3(0x82, 61, 90);
+    size_t n = drain_all(out, sizeof(out));
+    const uint8_t a[] = {0x82, 60, 90, 61, 90};
+    assert((n == sizeof(a)) && (memcmp(out, a, n) == 0));
+
+    /* Le temps réel ne casse pas le running status, System Common si. */
+    push3(0xB2, 1, 2);
+    n = midi_din_out_drain(&g_out, out, 3U);
+    push1(0xFE);
+    push3(0xB2, 1, 3);
+    n += midi_din_out_drain(&g_out, &out[n], 3U);
+    push3(0xF2, 0x10, 0x00);
+    push3(0xB2, 1, 4);
+    n += midi_din_out_drain(&g_out, &out[n], 6U);
+    const uint8_t b[] = {0xB2, 1, 2, 0xFE, 1, 3, 0xF2, 0x10, 0x00, 0xB2, 1, 4};
+    assert((n == sizeof(b)) && (memcmp(out, b, n) == 0));
+
+    /* File vide : le statut est réémis au message suivant. */
+    assert(midi_din_out_drain(&g_out, out, sizeof(out)) == 0U);
+    push3(0xB2, 1, 5);
+    n = drain_all(out, sizeof(out));
+    assert((n == 3U) && (out[0] == 0xB2));
+}
+
+static void test_off_never_overtakes_its_on(void) {
+    midi_din_out_init(&g_out);
+    uint8_t out[32];
+
+    /* Note très courte : ON puis OFF de la même note encore en attente. */
+    push3(0x93, 60, 100);
+    push3(0x83, 60, 0);
+    push3(0x83, 62, 0);   /* autre note : reste prioritaire */
+    const size_t n = drain_all(out, sizeof(out));
+    const uint8_t expected[] = {0x93, 62, 0, 60, 100, 60, 0};
+    assert((n == sizeof(expected)) && (memcmp(out, expected, n) == 0));
+}
+
+static void test_chunk_boundaries(void) {
+    midi_din_out_init(&g_out);
+    uint8_t out[8];
+    push3(0x90, 60, 100);
+    push3(0x90, 61, 100);
+    /* Bloc de 4 : un message complet (3), le suivant (2) ne tient pas. */
+    assert(midi_din_out_drain(&g_out, out, 4U) == 3U);
+    push1(0xFA);
+    /* Le temps réel déposé entre deux blocs passe devant. */
+    assert(midi_din_out_drain(&g_out, out, 3U) == 3U);
+    assert((out[0] == 0xFA) && (out[1] == 61) && (out[2] == 100));
+}
+
+static void test_queue_full(void) {
+    midi_din_out_init(&g_out);
+    const uint8_t m[3] = {0xB0, 1, 1};
+    for (unsigned i = 0U; i < MIDI_DIN_OUT_QUEUE_LEN; ++i) {
+        assert(midi_din_out_push(&g_out, m, 3U));
+    }
+    assert(!midi_din_out_push(&g_out, m, 3U));
+    assert(g_out.stats.drops == 1U);
+    push1(0xF8); /* autre classe : non affectée */
+}
+
+static void test_realtime_bypass(void) {
+    midi_din_out_init(&g_out);
+    uint8_t out[8];
+
+    /* Étage sans temps réel : F8 direct, compté dans le step. */
+    midi_din_out_step_mark(&g_out, 125000U);
+    push3(0x90, 60, 100);
+    assert(midi_din_out_bypass(&g_out));
+    assert(g_out.stats.messages == 1U);
+    assert(g_out.stats.bytes == 1U);
+    assert(midi_din_out_pending(&g_out) == 1U);
+
+    /* Un FA encore en attente : le F8 passe par l’étage, derrière lui. */
+    push1(0xFA);
+    assert(!midi_din_out_bypass(&g_out));
+    push1(0xF8);
+    assert(midi_din_out_drain(&g_out, out, 2U) == 2U);
+    assert((out[0] == 0xFA) && (out[1] == 0xF8));
+    assert(midi_din_out_bypass(&g_out));
+
+    /* Le running status des notes n’est pas touché. */
+    assert(midi_din_out_drain(&g_out, out, sizeof(out)) == 3U);
+    push3(0x90, 61, 100);
+    assert(midi_din_out_bypass(&g_out));
+    assert(midi_din_out_drain(&g_out, out, sizeof(out)) == 2U);
+    midi_din_out_step_mark(&g_out, 125000U);
+    assert(g_out.stats.step_bytes_last == 10U);
+}
+
+static void test_spp_before_continue(void) {
+    midi_din_out_init(&g_out);
+    uint8_t out[16];
+
+    /* Locate + Continue : le SPP sort avant le FB, même derrière des notes. */
+    push3(0x80, 60, 0);
+    push3(0xF2, 0x20, 0x01);
+    push1(0xFB);
+    assert(!midi_din_out_bypass(&g_out)); /* le F8 attend derrière la position */
+    push1(0xF8);
+    const size_t n = drain_all(out, sizeof(out));
+    const uint8_t a[] = {0xF2, 0x20, 0x01, 0xFB, 0xF8, 0x90, 60, 0};
+    assert((n == sizeof(a)) && (memcmp(out, a, n) == 0));
+
+    /* Bloc trop court pour le SPP : le FB ne le dépasse pas. */
+    push3(0xF2, 0x00, 0x00);
+    push1(0xFB);
+    assert(midi_din_out_drain(&g_out, out, 2U) == 0U);
+    assert(midi_din_out_drain(&g_out, out, 4U) == 4U);
+    assert((out[0] == 0xF2) && (out[3] == 0xFB));
+    assert(midi_din_out_bypass(&g_out));
+}
+
+/* -------------------------------------------------------------------------- */
+/* Rafale de step 16 pistes × 4 voix et budget                                */
+/* -------------------------------------------------------------------------- */
+
+static void test_step_burst_budget(void) {
+    midi_din_out_init(&g_out);
+
+    /* 120 BPM : un step de double-croche = 125 ms ≈ 390 octets de fil. */
+    const uint32_t step_us = 125000U;
+    midi_din_out_step_mark(&g_out, step_us);
+    assert(g_out.stats.step_capacity == 390U);
+
+    size_t naive = 0U;
+    for (uint8_t track = 0U; track < 16U; ++track) {
+        for (uint8_t v = 0U; v < 4U; ++v) {
+            push3((uint8_t)(0x80U | track), (uint8_t)(36U + v), 0U);
+            push3((uint8_t)(0x90U | track), (uint8_t)(48U + v), 100U);
+            naive += 6U;
+        }
+    }
+
+    uint8_t out[1024];
+    const size_t encoded = drain_all(out, sizeof(out));
+    assert(encoded < naive);
+    /* Par piste : OFF (3 + 3×2) puis ON (3 + 3×2) ; les ON démarrent par la
+     * dernière piste des OFF, dont le statut 0x9F est déjà en running status. */
+    assert(encoded == (16U * 2U * 9U) - 1U);
+
+    /* Step suffisant : aucun dépassement ; puis un step trop court. */
+    midi_din_out_step_mark(&g_out, step_us);
+    assert(g_out.stats.step_overruns == 0U);
+    assert(g_out.stats.step_bytes_last == encoded);
+
+    for (uint8_t track = 0U; track < 16U; ++track) {
+        push3((uint8_t)(0x90U | track), 60U, 100U);
+    }
+    (void)midi_din_out_drain(&g_out, out, 6U);
+    midi_din_out_step_mark(&g_out, 2000U);  /* 2 ms : 6 octets de capacité */
+    assert(g_out.stats.step_overruns == 1U);
+    assert(g_out.stats.step_backlog_last == 14U);
+
+    printf("midi_din_out: naive_bytes=%u encoded_bytes=%u wire_ms=%.1f->%.1f saved=%u step_capacity=%u overruns=%u\n",
+           (unsigned)naive, (unsigned)encoded, (double)naive * 0.32, (double)encoded * 0.32,
+           (unsigned)g_out.stats.bytes_saved, 390U, (unsigned)g_out.stats.step_overruns);
+}
+
+int main(void) {
+    test_priority_and_running_status();
+    test_release_velocity_and_realtime();
+    test_off_never_overtakes_its_on();
+    test_chunk_boundaries();
+    test_queue_full();
+    test_realtime_bypass();
+    test_spp_before_continue();
+    test_step_burst_budget();
+    return 0;
+}
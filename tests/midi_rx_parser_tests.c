@@ -0,0 +1,201 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "midi_rx_parser.h"
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+#define MAX_EVENTS 64U
+
+typedef struct {
+    midi_rx_event_t ev[MAX_EVENTS];
+    unsigned count;
+} capture_t;
+
+/* Injecte un flux d’octets ; l’octet i est horodaté ts0 + i. */
+static void feed(midi_parser_t *p, const uint8_t *bytes, unsigned len, hr_time_t ts0, capture_t *cap) {
+    for (unsigned i = 0U; i < len; ++i) {
+        midi_rx_event_t ev[MIDI_PARSER_MAX_EVENTS];
+        const uint8_t n = midi_parser_feed(p, bytes[i], (hr_time_t)(ts0 + i), ev);
+        assert(n <= MIDI_PARSER_MAX_EVENTS);
+        for (uint8_t k = 0U; k < n; ++k) {
+            assert(cap->count < MAX_EVENTS);
+            cap->ev[cap->count++] = ev[k];
+        }
+    }
+}
+
+static void expect(const capture_t *cap, unsigned idx, uint8_t status, uint8_t d1, uint8_t d2, hr_time_t ts) {
+    assert(idx < cap->count);
+    const midi_rx_event_t *ev = &cap->ev[idx];
+    assert(ev->status == status);
+    assert(ev->data1 == d1);
+    assert(ev->data2 == d2);
+    assert(ev->ts == ts);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Analyseur                                                                  */
+/* -------------------------------------------------------------------------- */
+
+static void test_running_status(void) {
+    midi_parser_t p;
+    capture_t cap = {0};
+    midi_parser_init(&p, MIDI_RX_SRC_DIN);
+
+    /* Note On, puis deux notes en running status, puis un Program Change. */
+    const uint8_t bytes[] = {0x92, 60, 100, 62, 90, 64, 0, 0xC2, 5, 6};
+    feed(&p, bytes, sizeof(bytes), 100U, &cap);
+
+    assert(cap.count == 5U);
+    expect(&cap, 0U, 0x92, 60, 100, 100U);
+    expect(&cap, 1U, 0x92, 62, 90, 103U);   /* horodaté à sa première donnée */
+    expect(&cap, 2U, 0x92, 64, 0, 105U);
+    expect(&cap, 3U, 0xC2, 5, 0, 107U);
+    expect(&cap, 4U, 0xC2, 6, 0, 109U);     /* running status sur 1 octet */
+    assert(cap.ev[0].source == MIDI_RX_SRC_DIN);
+    assert(p.stray_bytes == 0U);
+}
+
+static void test_realtime_interleaved(void) {
+    midi_parser_t p;
+    capture_t cap = {0};
+    midi_parser_init(&p, MIDI_RX_SRC_USB);
+
+    /* F8 au milieu d’un Note On et d’un SysEx, FE entre deux, F9/FD ignorés. */
+    const uint8_t bytes[] = {0x90, 0xF8, 60, 0xF9, 127, 0xF0, 0x7E, 0xF8, 0x01, 0xF7, 0xFE, 0xFD};
+    feed(&p, bytes, sizeof(bytes), 0U, &cap);
+
+    assert(cap.count == 5U);
+    expect(&cap, 0U, 0xF8, 0, 0, 1U);
+    expect(&cap, 1U, 0x90, 60, 127, 0U);    /* pas perturbé par F8/F9 */
+    expect(&cap, 2U, 0xF8, 0, 0, 7U);
+    expect(&cap, 3U, 0xF0, 2, 0, 5U);       /* SysEx de 2 octets, horodaté à F0 */
+    expect(&cap, 4U, 0xFE, 0, 0, 10U);
+    assert(p.sysex_aborted == 0U);
+}
+
+static void test_sysex_aborted_and_stray(void) {
+    midi_parser_t p;
+    capture_t cap = {0};
+    midi_parser_init(&p, MIDI_RX_SRC_DIN);
+
+    /* Données orphelines, SysEx interrompu par un Note On, F7 orphelin. */
+    const uint8_t bytes[] = {0x10, 0x20, 0xF0, 1, 2, 3, 0x91, 40, 50, 0xF7, 41, 51};
+    feed(&p, bytes, sizeof(bytes), 0U, &cap);
+
+    assert(p.stray_bytes == 2U);
+    assert(p.sysex_aborted == 1U);
+    assert(cap.count == 3U);
+    expect(&cap, 0U, 0xF0, 3, 0, 2U);
+    expect(&cap, 1U, 0x91, 40, 50, 6U);
+    expect(&cap, 2U, 0x91, 41, 51, 10U);    /* F7 orphelin : running status conservé */
+}
+
+static void test_system_common(void) {
+    midi_parser_t p;
+    capture_t cap = {0};
+    midi_parser_init(&p, MIDI_RX_SRC_DIN);
+
+    /* SPP (LSB/MSB), Tune Request ; un System Common annule le running status. */
+    const uint8_t bytes[] = {0x90, 60, 1, 0xF2, 0x10, 0x02, 61, 2, 0xF6};
+    feed(&p, bytes, sizeof(bytes), 0U, &cap);
+
+    assert(cap.count == 3U);
+    expect(&cap, 0U, 0x90, 60, 1, 0U);
+    expect(&cap, 1U, 0xF2, 0x10, 0x02, 3U);
+    expect(&cap, 2U, 0xF6, 0, 0, 8U);
+    assert(p.stray_bytes == 2U);
+}
+
+static void test_tune_request_ends_sysex(void) {
+    midi_parser_t p;
+    capture_t cap = {0};
+    midi_parser_init(&p, MIDI_RX_SRC_USB);
+
+    /* F6 clôt le SysEx et reste un Tune Request ; le running status repart de zéro. */
+    const uint8_t bytes[] = {0xF0, 0x41, 0x10, 0x42, 0xF6, 0x90, 60, 100};
+    feed(&p, bytes, sizeof(bytes), 20U, &cap);
+
+    assert(cap.count == 3U);
+    expect(&cap, 0U, 0xF0, 3, 0, 20U);
+    expect(&cap, 1U, 0xF6, 0, 0, 24U);
+    expect(&cap, 2U, 0x90, 60, 100, 25U);
+    assert(p.sysex_aborted == 1U);
+    assert(!p.in_sysex);
+}
+
+static void test_usb_cin_length(void) {
+    assert(midi_usb_cin_length(0x00) == 0U);
+    assert(midi_usb_cin_length(0x01) == 0U);
+    assert(midi_usb_cin_length(0x02) == 2U);  /* System Common 2 octets */
+    assert(midi_usb_cin_length(0x03) == 3U);
+    assert(midi_usb_cin_length(0x04) == 3U);  /* SysEx start/continue */
+    assert(midi_usb_cin_length(0x05) == 1U);
+    assert(midi_usb_cin_length(0x06) == 2U);
+    assert(midi_usb_cin_length(0x07) == 3U);
+    assert(midi_usb_cin_length(0x19) == 3U);  /* câble 1, Note On */
+    assert(midi_usb_cin_length(0x0C) == 2U);
+    assert(midi_usb_cin_length(0x0D) == 2U);
+    assert(midi_usb_cin_length(0x0F) == 1U);  /* octet unique (temps réel) */
+}
+
+/* -------------------------------------------------------------------------- */
+/* File SPSC                                                                  */
+/* -------------------------------------------------------------------------- */
+
+static void test_ring_wrap_and_overflow(void) {
+    static midi_rx_ring_t ring;
+    midi_rx_ring_reset(&ring);
+
+    midi_rx_event_t ev = {0};
+    midi_rx_event_t out;
+    assert(!midi_rx_ring_pop(&ring, &out));
+
+    /* Plusieurs tours complets : les indices 16 bits rebouclent sans perte. */
+    uint32_t next_in = 0U;
+    uint32_t next_out = 0U;
+    for (unsigned round = 0U; round < 700U; ++round) {
+        for (unsigned i = 0U; i < 97U; ++i) {
+            ev.ts = (hr_time_t)next_in++;
+            assert(midi_rx_ring_push(&ring, &ev));
+        }
+        while (midi_rx_ring_pop(&ring, &out)) {
+            assert(out.ts == (hr_time_t)next_out);
+            ++next_out;
+        }
+    }
+    assert(next_in == next_out);
+    assert(ring.drops == 0U);
+    assert(ring.high_water == 97U);
+
+    /* Remplissage complet puis débordement : drops comptés, ordre conservé. */
+    for (unsigned i = 0U; i < MIDI_RX_RING_LEN + 5U; ++i) {
+        ev.ts = (hr_time_t)(1000U + i);
+        (void)midi_rx_ring_push(&ring, &ev);
+    }
+    assert(midi_rx_ring_count(&ring) == MIDI_RX_RING_LEN);
+    assert(ring.drops == 5U);
+    assert(ring.high_water == MIDI_RX_RING_LEN);
+    assert(midi_rx_ring_pop(&ring, &out) && (out.ts == 1000U));
+    assert(midi_rx_ring_push(&ring, &ev));
+    assert(midi_rx_ring_count(&ring) == MIDI_RX_RING_LEN);
+
+    printf("midi_rx_parser: ring_len=%u high_water=%u drops=%u passed=%u\n",
+           (unsigned)MIDI_RX_RING_LEN, (unsigned)ring.high_water, (unsigned)ring.drops, (unsigned)next_out);
+}
+
+int main(void) {
+    test_running_status();
+    test_realtime_interleaved();
+    test_sysex_aborted_and_stray();
+    test_system_common();
+    test_tune_request_ends_sysex();
+    test_usb_cin_length();
+    test_ring_wrap_and_overflow();
+    return 0;
+}
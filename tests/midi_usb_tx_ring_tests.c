@@ -0,0 +1,190 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "midi_usb_tx_ring.h"
+
+static midi_usb_tx_ring_t g_ring;
+
+static void make_packet(uint8_t packet[4], uint8_t producer, uint16_t seq) {
+    packet[0] = 0x09U;
+    packet[1] = (uint8_t)(0x90U | producer);
+    packet[2] = (uint8_t)(seq & 0x7FU);
+    packet[3] = (uint8_t)((seq >> 7) & 0x7FU);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Séquence déterministe                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_double_buffer_sequence(void) {
+    midi_usb_tx_ring_reset(&g_ring);
+    const uint8_t *buf = NULL;
+    size_t len = 0U;
+    uint8_t packet[4];
+
+    /* Endpoint libre : le premier paquet part immédiatement, seul. */
+    make_packet(packet, 0U, 0U);
+    assert(midi_usb_tx_ring_push(&g_ring, packet, &buf, &len) == MIDI_USB_TX_START);
+    assert(len == 4U);
+    assert(memcmp(buf, packet, 4U) == 0);
+    const uint8_t *first = buf;
+    assert(midi_usb_tx_ring_busy(&g_ring));
+
+    /* Endpoint occupé : les suivants s’accumulent dans l’autre tampon. */
+    for (uint16_t i = 1U; i <= 3U; ++i) {
+        make_packet(packet, 0U, i);
+        assert(midi_usb_tx_ring_push(&g_ring, packet, &buf, &len) == MIDI_USB_TX_QUEUED);
+    }
+    assert(midi_usb_tx_ring_pending(&g_ring) == 3U);
+    assert(g_ring.high_water == 4U);
+
+    /* Fin de transfert : bascule sans copie, les 3 paquets partent ensemble. */
+    assert(midi_usb_tx_ring_complete(&g_ring, &buf, &len));
+    assert(len == 12U);
+    assert(buf != first);
+    for (uint16_t i = 0U; i < 3U; ++i) {
+        make_packet(packet, 0U, (uint16_t)(i + 1U));
+        assert(memcmp(&buf[i * 4U], packet, 4U) == 0);
+    }
+    assert(midi_usb_tx_ring_pending(&g_ring) == 0U);
+
+    /* Rien en attente : l’endpoint redevient libre. */
+    assert(!midi_usb_tx_ring_complete(&g_ring, &buf, &len));
+    assert(!midi_usb_tx_ring_busy(&g_ring));
+
+    /* Débordement : un tampon en vol + un tampon plein, le reste est perdu. */
+    make_packet(packet, 1U, 0U);
+    assert(midi_usb_tx_ring_push(&g_ring, packet, &buf, &len) == MIDI_USB_TX_START);
+    for (unsigned i = 0U; i < MIDI_USB_TX_BUF_PACKETS + 3U; ++i) {
+        (void)midi_usb_tx_ring_push(&g_ring, packet, &buf, &len);
+    }
+    assert(g_ring.drops == 3U);
+    assert(g_ring.high_water == MIDI_USB_TX_BUF_PACKETS + 1U);
+    assert(midi_usb_tx_ring_complete(&g_ring, &buf, &len));
+    assert(len == MIDI_USB_TX_BUF_PACKETS * 4U);
+
+    /* Reconfiguration USB : contenu abandonné, compteurs conservés. */
+    midi_usb_tx_ring_abort(&g_ring);
+    assert(!midi_usb_tx_ring_busy(&g_ring));
+    assert(g_ring.drops == 3U);
+    assert(midi_usb_tx_ring_push(&g_ring, packet, &buf, &len) == MIDI_USB_TX_START);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Concurrence : N producteurs + un « endpoint » simulé                       */
+/* -------------------------------------------------------------------------- */
+
+#define PRODUCERS        4U
+#define PACKETS_PER_PROD 16000U  /* séquence sur 14 bits */
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+} transfer_t;
+
+static transfer_t g_in_flight;
+static volatile int g_has_transfer = 0;
+static volatile int g_producers_done = 0;
+static uint32_t g_pushed_ok[PRODUCERS];
+
+static void post_transfer(const uint8_t *buf, size_t len) {
+    /* Un seul transfert en vol à la fois : garanti par la file elle-même. */
+    assert(__atomic_load_n(&g_has_transfer, __ATOMIC_ACQUIRE) == 0);
+    g_in_flight.buf = buf;
+    g_in_flight.len = len;
+    __atomic_store_n(&g_has_transfer, 1, __ATOMIC_RELEASE);
+}
+
+static void *producer_main(void *arg) {
+    const uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t packet[4];
+    for (uint16_t seq = 0U; seq < PACKETS_PER_PROD; ++seq) {
+        const uint8_t *buf = NULL;
+        size_t len = 0U;
+        make_packet(packet, id, seq);
+        midi_usb_tx_push_t res;
+        /* Tampon plein : perte comptée, puis nouvel essai pour garder le flux complet. */
+        while ((res = midi_usb_tx_ring_push(&g_ring, packet, &buf, &len)) == MIDI_USB_TX_FULL) {
+            sched_yield();
+        }
+        if (res == MIDI_USB_TX_START) {
+            post_transfer(buf, len);
+        }
+        g_pushed_ok[id]++;
+    }
+    __atomic_add_fetch(&g_producers_done, 1, __ATOMIC_ACQ_REL);
+    return NULL;
+}
+
+static void test_concurrent_producers(void) {
+    midi_usb_tx_ring_reset(&g_ring);
+    memset(g_pushed_ok, 0, sizeof(g_pushed_ok));
+
+    pthread_t threads[PRODUCERS];
+    for (uintptr_t i = 0U; i < PRODUCERS; ++i) {
+        assert(pthread_create(&threads[i], NULL, producer_main, (void *)i) == 0);
+    }
+
+    int32_t last_seq[PRODUCERS];
+    uint32_t received[PRODUCERS] = {0};
+    uint32_t transfers = 0U;
+    for (unsigned i = 0U; i < PRODUCERS; ++i) {
+        last_seq[i] = -1;
+    }
+
+    for (;;) {
+        if (__atomic_load_n(&g_has_transfer, __ATOMIC_ACQUIRE) != 0) {
+            const transfer_t t = g_in_flight;
+            assert((t.len > 0U) && ((t.len % 4U) == 0U));
+            assert(t.len <= MIDI_USB_TX_BUF_PACKETS * 4U);
+            for (size_t off = 0U; off < t.len; off += 4U) {
+                const uint8_t *p = &t.buf[off];
+                assert(p[0] == 0x09U);
+                const unsigned id = p[1] & 0x0FU;
+                assert(id < PRODUCERS);
+                const int32_t seq = (int32_t)(p[2] | ((uint16_t)p[3] << 7));
+                assert(seq == last_seq[id] + 1);  /* ordre par producteur, ni perte ni doublon */
+                last_seq[id] = seq;
+                received[id]++;
+            }
+            ++transfers;
+            __atomic_store_n(&g_has_transfer, 0, __ATOMIC_RELEASE);
+
+            const uint8_t *buf = NULL;
+            size_t len = 0U;
+            if (midi_usb_tx_ring_complete(&g_ring, &buf, &len)) {
+                post_transfer(buf, len);
+            }
+        } else if ((__atomic_load_n(&g_producers_done, __ATOMIC_ACQUIRE) == (int)PRODUCERS) &&
+                   !midi_usb_tx_ring_busy(&g_ring)) {
+            break;
+        }
+    }
+
+    uint32_t total_rx = 0U;
+    uint32_t total_ok = 0U;
+    for (unsigned i = 0U; i < PRODUCERS; ++i) {
+        assert(pthread_join(threads[i], NULL) == 0);
+        assert(received[i] == g_pushed_ok[i]);
+        total_rx += received[i];
+        total_ok += g_pushed_ok[i];
+    }
+    assert(total_ok == PRODUCERS * PACKETS_PER_PROD);
+    assert(midi_usb_tx_ring_pending(&g_ring) == 0U);
+
+    printf("midi_usb_tx_ring: producers=%u packets=%u delivered=%u full_retries=%u transfers=%u avg_batch=%.1f high_water=%u\n",
+           (unsigned)PRODUCERS, (unsigned)(PRODUCERS * PACKETS_PER_PROD), (unsigned)total_rx,
+           (unsigned)g_ring.drops, (unsigned)transfers, (double)total_rx / (double)transfers,
+           (unsigned)g_ring.high_water);
+}
+
+int main(void) {
+    test_double_buffer_sequence();
+    test_concurrent_producers();
+    return 0;
+}
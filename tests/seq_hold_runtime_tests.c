@@ -237,6 +237,9 @@ static void test_seq_recorder_commits_length_and_led_state(void) {
         .tick_st = 100,
         .step_st = 600,
         .ext_clock = false,
+        .now_hr = 0,
+        .tick_hr = 10000,
+        .step_hr = 60000,
     };
 
     seq_recorder_on_clock_step(&info);
@@ -246,6 +249,7 @@ static void test_seq_recorder_commits_length_and_led_state(void) {
 
     info.step_idx_abs = 1;
     info.now = 600;
+    info.now_hr = 60000;
     seq_recorder_on_clock_step(&info);
 
     set_stub_time(1250);
@@ -281,13 +285,16 @@ static void test_live_capture_records_length(void) {
         .bpm = 120.0f,
         .tick_st = 100,
         .step_st = 600,
-        .ext_clock = false
+        .ext_clock = false,
+        .now_hr = 0,
+        .tick_hr = 10000,
+        .step_hr = 60000
     };
     seq_live_capture_update_clock(&capture, &info);
 
     seq_live_capture_input_t on = {
         .type = SEQ_LIVE_CAPTURE_EVENT_NOTE_ON,
-        .timestamp = 10,
+        .timestamp = 1000,
         .note = 60,
         .velocity = 100,
         .voice_index = 0
@@ -298,12 +305,13 @@ static void test_live_capture_records_length(void) {
 
     size_t recorded_step = plan.step_index;
     info.now = 600;
+    info.now_hr = 60000;
     info.step_idx_abs = 1;
     seq_live_capture_update_clock(&capture, &info);
 
     seq_live_capture_input_t off = {
         .type = SEQ_LIVE_CAPTURE_EVENT_NOTE_OFF,
-        .timestamp = 1210,
+        .timestamp = 121000,
         .note = 60,
         .velocity = 0,
         .voice_index = 0
@@ -317,13 +325,15 @@ static void test_live_capture_records_length(void) {
     assert(voice->length > 1U);
 
     bool has_length_plock = false;
-    for (uint8_t i = 0U; i < step->plock_count; ++i) {
-        const seq_model_plock_t *plk = &step->plocks[i];
-        if ((plk->domain == SEQ_MODEL_PLOCK_INTERNAL) &&
-            (plk->internal_param == SEQ_MODEL_PLOCK_PARAM_LENGTH) &&
-            (plk->voice_index == 0U)) {
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plk;
+    seq_model_step_plock_iter(step, &track.plocks, &it);
+    while (seq_model_plock_iter_next(&it, &plk)) {
+        if ((plk.domain == SEQ_MODEL_PLOCK_INTERNAL) &&
+            (plk.internal_param == SEQ_MODEL_PLOCK_PARAM_LENGTH) &&
+            (plk.voice_index == 0U)) {
             has_length_plock = true;
-            assert(plk->value == (int16_t)voice->length);
+            assert(plk.value == (int16_t)voice->length);
         }
     }
     assert(has_length_plock);
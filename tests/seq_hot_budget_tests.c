@@ -8,13 +8,16 @@ int main(void) {
     const seq_hot_snapshot_t snapshot = seq_runtime_hot_snapshot();
     const size_t hot = seq_runtime_hot_total(&snapshot);
 
-    printf("HOT detail:\n  reader=%zu, scheduler=%zu, player=%zu, queues=%zu, scratch=%zu\n",
+    printf("HOT detail:\n  reader=%zu, scheduler=%zu, player=%zu, queues=%zu, scratch=%zu, tracks=%zu\n",
            snapshot.sizeof_reader_core, snapshot.sizeof_scheduler_core,
            snapshot.sizeof_player_core, snapshot.sizeof_rt_queues,
-           snapshot.sizeof_rt_scratch);
+           snapshot.sizeof_rt_scratch, snapshot.sizeof_tracks);
     printf("HOT estimate (host): %zu bytes\n", hot);
+    printf("CCM spare tracks: %zu bytes\n", snapshot.sizeof_ccm_tracks);
+    printf("CCM back plans: %zu bytes\n", snapshot.sizeof_ccm_plans);
 
     assert(hot <= SEQ_RUNTIME_HOT_BUDGET_MAX);
+    assert((snapshot.sizeof_ccm_tracks + snapshot.sizeof_ccm_plans) <= SEQ_RUNTIME_CCM_BUDGET_MAX);
 
 #if defined(HOST_BUILD) || defined(UNIT_TEST)
     /* Force link of the compile-time guard to surface violations during host builds. */
@@ -43,7 +43,7 @@ static void seed_test_pattern(void) {
         .voice_index = 0U,
         .internal_param = SEQ_MODEL_PLOCK_PARAM_NOTE,
     };
-    assert(seq_model_step_add_plock(step1, &cart_plock));
+    assert(seq_model_step_add_plock(step1, &track->plocks, &cart_plock));
 }
 
 static void render_led_frame(uint8_t *dst, size_t n_steps) {
@@ -9,6 +9,8 @@
 
 #include "core/seq/seq_model.h"
 
+static seq_model_plock_pool_t g_pool;
+
 static void test_generation_helpers(void) {
     seq_model_gen_t gen_a;
     seq_model_gen_t gen_b;
@@ -59,6 +61,7 @@ static void test_default_step_initialisation(void) {
 
 static void test_step_state_helpers(void) {
     seq_model_step_t step;
+    seq_model_plock_pool_init(&g_pool);
     seq_model_step_init(&step);
 
     assert(!seq_model_step_has_playable_voice(&step));
@@ -95,7 +98,7 @@ static void test_step_state_helpers(void) {
         .value = 64,
         .internal_param = SEQ_MODEL_PLOCK_PARAM_NOTE,
     };
-    assert(seq_model_step_add_plock(&step, &plock));
+    assert(seq_model_step_add_plock(&step, &g_pool, &plock));
     assert(seq_model_step_has_any_plock(&step));
     assert(seq_model_step_has_seq_plock(&step));
     assert(!seq_model_step_has_cart_plock(&step));
@@ -108,13 +111,15 @@ static void test_step_state_helpers(void) {
         .value = 32,
         .internal_param = SEQ_MODEL_PLOCK_PARAM_NOTE,
     };
-    assert(seq_model_step_add_plock(&step, &cart));
+    assert(seq_model_step_add_plock(&step, &g_pool, &cart));
     assert(seq_model_step_has_cart_plock(&step));
     assert(!seq_model_step_is_automation_only(&step));
 
+    seq_model_step_clear_plocks(&step, &g_pool);
+    assert(seq_model_plock_pool_available(&g_pool) == SEQ_MODEL_TRACK_PLOCK_CAPACITY);
     seq_model_step_init(&step);
     seq_model_step_make_automation_only(&step);
-    assert(seq_model_step_add_plock(&step, &cart));
+    assert(seq_model_step_add_plock(&step, &g_pool, &cart));
     assert(!seq_model_step_has_seq_plock(&step));
     assert(seq_model_step_has_cart_plock(&step));
     assert(seq_model_step_is_automation_only(&step));
@@ -125,19 +130,174 @@ static void test_plock_capacity_guard(void) {
     seq_model_plock_t plock;
     size_t i;
 
+    seq_model_plock_pool_init(&g_pool);
     seq_model_step_init(&step);
     memset(&plock, 0, sizeof(plock));
     plock.domain = SEQ_MODEL_PLOCK_INTERNAL;
 
     for (i = 0U; i < SEQ_MODEL_MAX_PLOCKS_PER_STEP; ++i) {
         plock.voice_index = 0U;
-        assert(seq_model_step_add_plock(&step, &plock));
+        assert(seq_model_step_add_plock(&step, &g_pool, &plock));
     }
 
     assert(step.plock_count == SEQ_MODEL_MAX_PLOCKS_PER_STEP);
 
     /* The next addition should be rejected because the buffer is full. */
-    assert(!seq_model_step_add_plock(&step, &plock));
+    const uint32_t step_full = seq_model_plock_drop_stats.step_full;
+    assert(!seq_model_step_add_plock(&step, &g_pool, &plock));
+    assert(seq_model_plock_drop_stats.step_full == step_full + 1U);
+}
+
+static seq_model_plock_t make_cart_plock(uint16_t parameter_id, int16_t value) {
+    seq_model_plock_t plock = {
+        .domain = SEQ_MODEL_PLOCK_CART,
+        .voice_index = 1U,
+        .parameter_id = parameter_id,
+        .value = value,
+        .internal_param = 0U,
+    };
+    return plock;
+}
+
+static void assert_step_plocks(const seq_model_step_t *step, const seq_model_plock_pool_t *pool,
+                               const uint16_t *ids, size_t count) {
+    seq_model_plock_iter_t it;
+    seq_model_plock_t plock;
+    size_t n = 0U;
+
+    assert(step->plock_count == count);
+    seq_model_step_plock_iter(step, pool, &it);
+    while (seq_model_plock_iter_next(&it, &plock)) {
+        assert(n < count);
+        assert(plock.domain == SEQ_MODEL_PLOCK_CART);
+        assert(plock.voice_index == 1U);
+        assert(plock.parameter_id == ids[n]);
+        assert(plock.value == (int16_t)(ids[n] * 3));
+        ++n;
+    }
+    assert(n == count);
+}
+
+static void test_plock_arena(void) {
+    static seq_model_track_t track;
+    seq_model_track_init(&track);
+    seq_model_step_t *a = &track.steps[0];
+    seq_model_step_t *b = &track.steps[5];
+
+    /* Interleaved appends keep each step's insertion order. */
+    for (uint16_t i = 0U; i < 6U; ++i) {
+        seq_model_plock_t pa = make_cart_plock((uint16_t)(10U + i), (int16_t)((10 + i) * 3));
+        seq_model_plock_t pb = make_cart_plock((uint16_t)(100U + i), (int16_t)((100 + i) * 3));
+        assert(seq_model_step_add_plock(a, &track.plocks, &pa));
+        assert(seq_model_step_add_plock(b, &track.plocks, &pb));
+    }
+    assert(track.plocks.used == 12U);
+
+    /* Remove head, middle and tail. */
+    assert(seq_model_step_remove_plock(a, &track.plocks, 0U));
+    assert(seq_model_step_remove_plock(a, &track.plocks, 2U));
+    assert(seq_model_step_remove_plock(a, &track.plocks, 3U));
+    const uint16_t a_ids[] = { 11U, 12U, 14U };
+    assert_step_plocks(a, &track.plocks, a_ids, 3U);
+    assert(!seq_model_step_remove_plock(a, &track.plocks, 3U));
+
+    /* Appending after removing the tail links to the right head. */
+    seq_model_plock_t extra = make_cart_plock(20U, 60);
+    assert(seq_model_step_add_plock(a, &track.plocks, &extra));
+    const uint16_t a_ids2[] = { 11U, 12U, 14U, 20U };
+    assert_step_plocks(a, &track.plocks, a_ids2, 4U);
+
+    /* The slide flag of a cart lock survives packing, internal locks never slide. */
+    seq_model_plock_t got_slide;
+    assert(seq_model_step_get_plock(a, &track.plocks, 3U, &got_slide) && !got_slide.slide);
+    extra.slide = true;
+    assert(seq_model_step_set_plock(a, &track.plocks, 3U, &extra));
+    assert(seq_model_step_get_plock(a, &track.plocks, 3U, &got_slide));
+    assert(got_slide.slide && (got_slide.parameter_id == 20U) && (got_slide.value == 60) &&
+           (got_slide.voice_index == 1U));
+    assert_step_plocks(a, &track.plocks, a_ids2, 4U);
+
+    /* In-place rewrite, including a domain change. */
+    seq_model_plock_t got;
+    assert(seq_model_step_get_plock(a, &track.plocks, 1U, &got) && (got.parameter_id == 12U));
+    seq_model_plock_t internal = {
+        .domain = SEQ_MODEL_PLOCK_INTERNAL,
+        .voice_index = 2U,
+        .parameter_id = 0U,
+        .value = -7,
+        .internal_param = SEQ_MODEL_PLOCK_PARAM_MICRO,
+    };
+    assert(seq_model_step_set_plock(a, &track.plocks, 1U, &internal));
+    assert(seq_model_step_has_seq_plock(a) && seq_model_step_has_cart_plock(a));
+    assert(seq_model_step_get_plock(a, &track.plocks, 1U, &got));
+    assert((got.domain == SEQ_MODEL_PLOCK_INTERNAL) && (got.voice_index == 2U) &&
+           (got.internal_param == SEQ_MODEL_PLOCK_PARAM_MICRO) && (got.value == -7));
+    assert(seq_model_step_remove_plock(a, &track.plocks, 1U));
+    assert(!seq_model_step_has_seq_plock(a));
+
+    /* Out-of-range targets are rejected. */
+    seq_model_plock_t bad = make_cart_plock(SEQ_MODEL_PLOCK_CART_PARAM_MAX + 1U, 0);
+    assert(!seq_model_step_add_plock(a, &track.plocks, &bad));
+    bad.parameter_id = 1U;
+    bad.voice_index = SEQ_MODEL_VOICES_PER_STEP;
+    assert(!seq_model_step_add_plock(a, &track.plocks, &bad));
+
+    /* Copy into another arena and back. */
+    seq_model_plock_pool_init(&g_pool);
+    seq_model_step_t staged;
+    seq_model_step_init(&staged);
+    assert(seq_model_step_copy(&staged, &g_pool, b, &track.plocks));
+    const uint16_t b_ids[] = { 100U, 101U, 102U, 103U, 104U, 105U };
+    assert_step_plocks(&staged, &g_pool, b_ids, 6U);
+    assert(seq_model_step_remove_plock(&staged, &g_pool, 0U));
+    assert_step_plocks(b, &track.plocks, b_ids, 6U);
+    assert(seq_model_step_copy(b, &track.plocks, &staged, &g_pool));
+    assert_step_plocks(b, &track.plocks, &b_ids[1], 5U);
+
+    /* Clearing a step returns every record. */
+    const uint16_t before = seq_model_plock_pool_available(&track.plocks);
+    seq_model_step_clear_plocks(a, &track.plocks);
+    assert(seq_model_plock_pool_available(&track.plocks) == (uint16_t)(before + 3U));
+    assert(!seq_model_step_has_any_plock(a) && !seq_model_step_has_cart_plock(a));
+
+    /* Fill the arena across many steps; the per-track capacity is the limit. */
+    const uint32_t arena_full = seq_model_plock_drop_stats.arena_full;
+    uint16_t added = 0U;
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+        for (uint8_t p = 0U; p < 4U; ++p) {
+            seq_model_plock_t plock = make_cart_plock((uint16_t)(s * 4U + p), (int16_t)((s * 4U + p) * 3U));
+            if ((s == 5U) || !seq_model_step_add_plock(&track.steps[s], &track.plocks, &plock)) {
+                continue;
+            }
+            ++added;
+        }
+    }
+    assert(seq_model_plock_pool_available(&track.plocks) == 0U);
+    assert(track.plocks.used == SEQ_MODEL_TRACK_PLOCK_CAPACITY);
+    assert(seq_model_plock_drop_stats.arena_full > arena_full);
+
+    /* A leaked chain (step reset without releasing) comes back on compaction. */
+    const uint8_t leaked = track.steps[1].plock_count;
+    seq_model_step_init(&track.steps[1]);
+    seq_model_track_compact_plocks(&track);
+    assert(seq_model_plock_pool_available(&track.plocks) == leaked);
+    assert_step_plocks(b, &track.plocks, &b_ids[1], 5U);
+    uint16_t expected = 0U;
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+        const seq_model_step_t *step = &track.steps[s];
+        if ((s == 5U) || (step->plock_count == 0U)) {
+            continue;
+        }
+        /* Records are contiguous and in step order after compaction. */
+        uint16_t ids[4];
+        for (uint8_t p = 0U; p < step->plock_count; ++p) {
+            ids[p] = (uint16_t)(s * 4U + p);
+        }
+        assert_step_plocks(step, &track.plocks, ids, step->plock_count);
+        expected = (uint16_t)(expected + step->plock_count);
+    }
+    assert((uint16_t)(expected + 5U) == track.plocks.used);
+    (void)added;
 }
 
 static void test_track_config_mutations(void) {
@@ -181,6 +341,7 @@ int main(void) {
     test_default_step_initialisation();
     test_step_state_helpers();
     test_plock_capacity_guard();
+    test_plock_arena();
     test_track_config_mutations();
 
     printf("seq_model_tests: OK\n");
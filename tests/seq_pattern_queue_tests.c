@@ -0,0 +1,269 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "apps/seq_engine_runner.h"
+#include "board/board_flash.h"
+#include "cart/cart_bus.h"
+#include "cart/cart_registry.h"
+#include "core/seq/reader/seq_reader.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_pattern_queue.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+#include "core/seq/seq_scheduler.h"
+
+#include "seq_runner_env_stub.h"
+
+#define TEST_TICK_ST 4U
+#define TEST_STEP_ST (TEST_TICK_ST * 6U)
+#define NOTE_A 60U
+#define NOTE_B 72U
+#define NOTE_B_EARLY 74U
+
+/* -------------------------------------------------------------------------- */
+/* Capture                                                                    */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    systime_t time;
+    uint8_t note;
+} note_on_t;
+
+static systime_t g_now = 0U;
+static uint32_t g_step = 0U;
+static uint32_t g_tick = 0U;
+static note_on_t g_ons[512];
+static unsigned g_on_count = 0U;
+
+void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+    if (((b0 & 0xF0U) == 0x90U) && (b2 != 0U) && (g_on_count < (sizeof(g_ons) / sizeof(g_ons[0])))) {
+        g_ons[g_on_count++] = (note_on_t){g_now, b1};
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stubs (host)                                                               */
+/* -------------------------------------------------------------------------- */
+
+/* Runner environment (LED bridge, mutes, cart link): seq_runner_env_stub.h. */
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static const seq_project_t *g_project;
+
+/* Track bound to the project: the set the runner plays. */
+static const seq_model_track_t *live_track(uint8_t idx) {
+    return seq_project_get_track_const(g_project, idx);
+}
+
+static void set_voice(seq_model_track_t *track, uint8_t step, uint8_t note, int8_t micro) {
+    seq_model_step_t *slot = &track->steps[step];
+    seq_model_step_make_neutral(slot);
+    slot->voices[0].note = note;
+    slot->voices[0].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+    slot->voices[0].length = 1U;
+    slot->voices[0].micro_offset = micro;
+    slot->voices[0].state = SEQ_MODEL_VOICE_ENABLED;
+    seq_model_step_recompute_flags(slot);
+}
+
+/* Pattern A (0,0): NOTE_A on every beat. Pattern B (0,1): NOTE_B on every beat,
+   plus an early voice on step 0 that must be planned from B during A's last step. */
+static void prepare_patterns(void) {
+    seq_runtime_init();
+    seq_pattern_queue_init();
+
+    seq_project_t *project = seq_runtime_access_project_mut();
+    g_project = project;
+    (void)seq_project_set_active_slot(project, 0U, 1U);
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; s += 4U) {
+        set_voice(track, s, NOTE_B, 0);
+    }
+    set_voice(seq_runtime_access_track_mut(1U), 0U, NOTE_B_EARLY, -3);
+    assert(seq_pattern_save(0U, 1U));
+
+    seq_model_track_init(seq_runtime_access_track_mut(1U));
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; s += 4U) {
+        set_voice(track, s, NOTE_A, 0);
+    }
+    assert(seq_pattern_save(0U, 0U));
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+    seq_model_gen_bump(&track->generation);
+    (void)seq_reader_plan_service(); /* UI thread: A compiled before play */
+    seq_reader_sync_stats_reset();
+
+    seq_scheduler_init();
+    seq_led_bridge_set_active(0U, 0U);
+    seq_engine_runner_init();
+    seq_engine_runner_on_transport_play();
+    g_now = 0U;
+    g_step = 0U;
+    g_tick = 0U;
+    g_on_count = 0U;
+}
+
+static void run_steps(uint32_t steps) {
+    const uint32_t end = g_step + steps;
+    while (g_step < end) {
+        g_now = (systime_t)(g_tick * TEST_TICK_ST);
+        seq_engine_runner_on_clock_tick(g_now);
+        if ((g_tick % 6U) == 0U) {
+            clock_step_info_t info = {
+                .now = g_now,
+                .step_idx_abs = g_step++,
+                .bpm = 120.0f,
+                .tick_st = TEST_TICK_ST,
+                .step_st = TEST_STEP_ST,
+                .ext_clock = false,
+            };
+            seq_engine_runner_on_clock_step(&info);
+        }
+        ++g_tick;
+    }
+}
+
+/* Every beat of [first_step, first_step + steps) played exactly @p note. */
+static void assert_beats(uint32_t first_step, uint32_t steps, uint8_t note) {
+    for (uint32_t s = first_step; s < (first_step + steps); s += 4U) {
+        const systime_t t = (systime_t)(s * TEST_STEP_ST);
+        bool found = false;
+        for (unsigned i = 0U; i < g_on_count; ++i) {
+            if ((g_ons[i].time == t) && (g_ons[i].note != NOTE_B_EARLY)) {
+                assert(g_ons[i].note == note);
+                found = true;
+            }
+        }
+        assert(found);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_swap_on_boundary(void) {
+    prepare_patterns();
+    const seq_model_track_t *live_before = live_track(0U);
+
+    run_steps(10U);
+    assert(seq_pattern_queue_request(0U, 1U, g_now));
+    assert(seq_pattern_queue_service(g_now));
+    assert(!seq_pattern_queue_service(g_now)); /* already decoded */
+    assert(live_track(0U) == live_before); /* decoded off to the side */
+
+    run_steps(54U + 64U + 1U);
+    assert_beats(0U, 64U, NOTE_A);
+    assert_beats(64U, 64U, NOTE_B);
+    assert(live_track(0U) != live_before);
+    assert(seq_runtime_shadow_track(0U) == live_before);
+
+    /* The early voice of B's first step was planned during A's last step. */
+    bool early = false;
+    for (unsigned i = 0U; i < g_on_count; ++i) {
+        if ((g_ons[i].note == NOTE_B_EARLY) && (g_ons[i].time < (64U * TEST_STEP_ST))) {
+            assert(g_ons[i].time >= ((64U * TEST_STEP_ST) - (TEST_STEP_ST / 4U)));
+            early = true;
+        }
+    }
+    assert(early);
+
+    uint8_t bank = 0xFFU;
+    uint8_t pattern = 0xFFU;
+    assert(seq_pattern_queue_take_swapped(&bank, &pattern));
+    assert((bank == 0U) && (pattern == 1U));
+    assert(!seq_pattern_queue_take_swapped(NULL, NULL));
+    assert((g_stub_active_bank == 0U) && (g_stub_active_pattern == 1U));
+    assert(seq_pattern_queue_stats.swaps == 1U);
+    assert(seq_pattern_queue_stats.prefetch_misses == 0U);
+    assert(seq_pattern_queue_stats.swap_latency_last == (systime_t)(54U * TEST_STEP_ST));
+}
+
+static void test_prefetch_miss_keeps_current_pattern(void) {
+    prepare_patterns();
+
+    run_steps(10U);
+    assert(seq_pattern_queue_request(0U, 1U, g_now));
+    run_steps(64U); /* storage thread late: boundary 64 is a miss, A loops */
+    assert(seq_pattern_queue_stats.prefetch_misses == 1U);
+    assert(seq_pattern_queue_stats.swaps == 0U);
+    assert(seq_pattern_queue_pending(NULL, NULL));
+
+    assert(seq_pattern_queue_service(g_now));
+    run_steps(64U);
+    assert_beats(0U, 128U, NOTE_A);
+    assert_beats(128U, 8U, NOTE_B);
+    assert(seq_pattern_queue_stats.swaps == 1U);
+
+    printf("pattern_queue: requests=%u prefetches=%u misses=%u swaps=%u swap_latency_ticks=%u\n",
+           (unsigned)seq_pattern_queue_stats.requests, (unsigned)seq_pattern_queue_stats.prefetches,
+           (unsigned)seq_pattern_queue_stats.prefetch_misses, (unsigned)seq_pattern_queue_stats.swaps,
+           (unsigned)seq_pattern_queue_stats.swap_latency_last);
+}
+
+/* Shadow plans compiled by the UI thread once decoded: the flip swaps them in,
+   the runner compiles nothing on the boundary. */
+static void test_flip_swaps_prefetched_plans(void) {
+    prepare_patterns();
+
+    run_steps(10U);
+    assert(seq_reader_sync_stats.tick_compiles == 0U);
+    const uint32_t swaps = seq_reader_sync_stats.swaps; /* A's plans, swapped in on play */
+    assert(seq_pattern_queue_request(0U, 1U, g_now));
+    assert(seq_pattern_queue_prefetch_plans() == 0U); /* not decoded yet */
+    assert(seq_pattern_queue_service(g_now));
+    assert(seq_pattern_queue_prefetch_plans() > 0U);
+    assert(seq_pattern_queue_prefetch_plans() == 0U); /* already waiting for the flip */
+
+    run_steps(52U);
+    assert(seq_reader_sync_stats.swaps == swaps); /* still playing A */
+    run_steps(10U);
+    assert_beats(0U, 64U, NOTE_A);
+    assert_beats(64U, 8U, NOTE_B);
+    assert(seq_pattern_queue_stats.swaps == 1U);
+    assert(seq_reader_sync_stats.swaps > swaps);
+    assert(seq_reader_sync_stats.tick_compiles == 0U);
+    assert(seq_reader_plan_service() == 0U); /* B's plans are current */
+}
+
+static void test_request_superseded_and_cancel(void) {
+    prepare_patterns();
+
+    /* A newer request invalidates the decoded shadow. */
+    assert(seq_pattern_queue_request(0U, 1U, 0U));
+    assert(seq_pattern_queue_service(0U));
+    assert(seq_pattern_queue_request(0U, 0U, 0U));
+    assert(!seq_pattern_queue_flip(0U, NULL, NULL));
+    assert(seq_pattern_queue_stats.prefetch_misses == 1U);
+    assert(seq_pattern_queue_service(0U));
+
+    seq_pattern_queue_cancel();
+    assert(!seq_pattern_queue_flip(0U, NULL, NULL));
+    assert(!seq_pattern_queue_pending(NULL, NULL));
+    assert(!seq_pattern_queue_request(SEQ_PROJECT_BANK_COUNT, 0U, 0U));
+
+    /* Back and forth: the two track sets alternate. */
+    const seq_model_track_t *set0 = live_track(0U);
+    assert(seq_pattern_queue_request(0U, 1U, 0U) && seq_pattern_queue_service(0U));
+    assert(seq_pattern_queue_flip(0U, NULL, NULL));
+    assert(live_track(0U)->steps[0].voices[0].note == NOTE_B);
+    assert(seq_pattern_queue_request(0U, 0U, 0U) && seq_pattern_queue_service(0U));
+    assert(seq_pattern_queue_flip(0U, NULL, NULL));
+    assert(live_track(0U) == set0);
+    assert(live_track(0U)->steps[0].voices[0].note == NOTE_A);
+}
+
+int main(void) {
+    assert(board_flash_init());
+    assert(board_flash_erase(0U, SEQ_PROJECT_FLASH_SLOT_SIZE));
+    test_swap_on_boundary();
+    test_prefetch_miss_keeps_current_pattern();
+    test_flip_swaps_prefetched_plans();
+    test_request_superseded_and_cancel();
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "board/board_flash.h"
+#include "core/seq/seq_pattern_store.h"
+
+#define SLOT_SIZE      (1024U * 1024U)
+#define SLOT_SECTORS   ((uint16_t)(SLOT_SIZE / BOARD_FLASH_SECTOR_SIZE))
+#define PATTERN_KEYS   256U
+
+static seq_pattern_store_t g_store;
+static uint8_t g_buf[SEQ_PATTERN_STORE_MAX_PAYLOAD];
+static uint8_t g_expect[PATTERN_KEYS][1200];
+static uint16_t g_expect_len[PATTERN_KEYS];
+static uint32_t g_rng = 0x12345678U;
+
+static uint32_t rng_next(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static void fill(uint8_t *dst, size_t len, uint32_t seed) {
+    for (size_t i = 0U; i < len; ++i) {
+        dst[i] = (uint8_t)((seed * 31U) + (i * 7U) + (i >> 8));
+    }
+}
+
+static void save(uint16_t key, uint16_t len, uint32_t seed) {
+    fill(g_expect[key], len, seed);
+    g_expect_len[key] = len;
+    assert(seq_pattern_store_write(&g_store, key, g_expect[key], len));
+}
+
+static void assert_contents(const seq_pattern_store_t *store) {
+    for (uint16_t key = 0U; key < PATTERN_KEYS; ++key) {
+        const size_t len = seq_pattern_store_length(store, key);
+        assert(len == g_expect_len[key]);
+        if (len == 0U) {
+            continue;
+        }
+        size_t read = 0U;
+        assert(seq_pattern_store_read(store, key, 0U, g_buf, sizeof(g_buf), &read));
+        assert((read == len) && (memcmp(g_buf, g_expect[key], len) == 0));
+    }
+}
+
+static void erase_slot(uint32_t base) {
+    assert(board_flash_erase(base, SLOT_SIZE));
+    memset(g_expect_len, 0, sizeof(g_expect_len));
+}
+
+static void erase_spread(const seq_pattern_store_t *store, uint32_t *min_out, uint32_t *max_out) {
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0U;
+    for (uint16_t s = 0U; s < store->sector_count; ++s) {
+        const uint32_t e = store->sectors[s].erase_count;
+        min = (e < min) ? e : min;
+        max = (e > max) ? e : max;
+    }
+    *min_out = min;
+    *max_out = max;
+}
+
+static void test_append_and_remount(void) {
+    const uint32_t base = 0U;
+    erase_slot(base);
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+    assert(seq_pattern_store_blank_sectors(&g_store) == SLOT_SECTORS);
+
+    for (uint16_t key = 0U; key < 10U; ++key) {
+        save(key, (uint16_t)(100U + key), key);
+    }
+    for (uint16_t key = 0U; key < 10U; ++key) {
+        save(key, (uint16_t)(300U - key), 1000U + key); /* newer version wins */
+    }
+    save(SEQ_PATTERN_STORE_KEY_COUNT - 1U, 0U, 0U);     /* empty payloads are valid records */
+    assert_contents(&g_store);
+    assert((g_store.stats.erases == 0U) && (g_store.stats.sync_erases == 0U));
+
+    const uint32_t next_seq = g_store.next_seq;
+    static seq_pattern_store_t remounted;
+    assert(seq_pattern_store_mount(&remounted, base, SLOT_SECTORS));
+    assert_contents(&remounted);
+    assert(remounted.next_seq == next_seq);
+    assert(seq_pattern_store_address(&remounted, SEQ_PATTERN_STORE_KEY_COUNT - 1U) != 0U);
+    assert(remounted.stats.torn == 0U);
+
+    /* Partial reads start anywhere in the payload. */
+    size_t read = 0U;
+    assert(seq_pattern_store_read(&remounted, 3U, 290U, g_buf, sizeof(g_buf), &read));
+    assert((read == 7U) && (memcmp(g_buf, &g_expect[3][290], 7U) == 0));
+    assert(!seq_pattern_store_read(&remounted, 42U, 0U, g_buf, sizeof(g_buf), &read));
+}
+
+static void test_torn_record_ignored(void) {
+    const uint32_t base = 1U * SLOT_SIZE;
+    erase_slot(base);
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+    save(5U, 200U, 1U);
+
+    /* Power cut before the commit byte: header and payload programmed, commit still 0xFF. */
+    const seq_pattern_store_sector_t *active = &g_store.sectors[g_store.active];
+    const uint32_t addr = base + ((uint32_t)g_store.active * BOARD_FLASH_SECTOR_SIZE) + active->write_off;
+    const uint8_t torn_header[SEQ_PATTERN_STORE_RECORD_HEADER_SIZE] = {
+        0x45U, 0x52U, 5U, 0U, 0xFFU, 0U, 0U, 0U, 200U, 0U, 0x12U, 0x34U, 0xFFU, 0xFFU, 0xFFU, 0xFFU
+    };
+    uint8_t garbage[200];
+    fill(garbage, sizeof(garbage), 99U);
+    assert(board_flash_write(addr, torn_header, sizeof(torn_header)));
+    assert(board_flash_write(addr + sizeof(torn_header), garbage, sizeof(garbage)));
+
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+    assert(g_store.stats.torn == 1U);
+    assert_contents(&g_store);
+
+    /* Later records land after the torn one and survive another reboot. */
+    save(5U, 210U, 2U);
+    save(6U, 50U, 3U);
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+    assert(g_store.stats.torn == 1U);
+    assert_contents(&g_store);
+}
+
+/* Live-set workload: hot patterns saved over and over, cold ones written once. */
+static void test_live_set_wear(void) {
+    const uint32_t base = 2U * SLOT_SIZE;
+    const uint32_t saves = 40000U;
+    erase_slot(base);
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+
+    for (uint16_t key = 0U; key < PATTERN_KEYS; ++key) {
+        save(key, (uint16_t)(200U + (rng_next() % 1000U)), rng_next());
+    }
+    for (uint32_t i = 0U; i < saves; ++i) {
+        const uint16_t key = (uint16_t)(rng_next() % 32U);
+        save(key, (uint16_t)(200U + (rng_next() % 1000U)), rng_next());
+
+        /* Idle-time service between saves: a few bounded steps. */
+        uint32_t steps = 0U;
+        while ((steps < 4U) && seq_pattern_store_maintain(&g_store)) {
+            ++steps;
+        }
+    }
+    assert(g_store.stats.sync_erases == 0U);
+    assert(g_store.stats.wear_moves > 0U);
+    assert_contents(&g_store);
+
+    uint32_t min = 0U;
+    uint32_t max = 0U;
+    erase_spread(&g_store, &min, &max);
+    /* Former layout: every save erased the pattern slot and the directory sector (2 erases). */
+    const uint32_t legacy_directory_erases = 2U * saves;
+    printf("pattern_store: saves=%u erases=%u gc_moves=%u wear_moves=%u erase_count[min=%u max=%u] "
+           "legacy_directory_sector=%u\n",
+           (unsigned)saves, (unsigned)g_store.stats.erases, (unsigned)g_store.stats.gc_moves,
+           (unsigned)g_store.stats.wear_moves, (unsigned)min, (unsigned)max, (unsigned)legacy_directory_erases);
+    assert((max - min) <= (2U * SEQ_PATTERN_STORE_WEAR_SPREAD));
+    assert((max * 100U) < legacy_directory_erases);
+
+    static seq_pattern_store_t remounted;
+    assert(seq_pattern_store_mount(&remounted, base, SLOT_SECTORS));
+    assert_contents(&remounted);
+    for (uint16_t s = 0U; s < SLOT_SECTORS; ++s) {
+        assert(remounted.sectors[s].erase_count == g_store.sectors[s].erase_count);
+    }
+}
+
+/* Without any service call, writes still make progress by reclaiming synchronously. */
+static void test_no_service_falls_back(void) {
+    const uint32_t base = 3U * SLOT_SIZE;
+    erase_slot(base);
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+
+    for (uint32_t i = 0U; i < 3000U; ++i) {
+        const uint16_t key = (uint16_t)(rng_next() % PATTERN_KEYS);
+        save(key, (uint16_t)(600U + (rng_next() % 600U)), rng_next());
+    }
+    assert(g_store.stats.sync_erases > 0U);
+    assert(g_store.stats.erases == 0U);
+    assert_contents(&g_store);
+
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+    assert_contents(&g_store);
+}
+
+static void test_rejects_invalid(void) {
+    const uint32_t base = 4U * SLOT_SIZE;
+    erase_slot(base);
+    assert(seq_pattern_store_mount(&g_store, base, SLOT_SECTORS));
+    assert(!seq_pattern_store_write(&g_store, SEQ_PATTERN_STORE_KEY_COUNT, g_buf, 1U));
+    assert(!seq_pattern_store_write(&g_store, 0U, g_buf, SEQ_PATTERN_STORE_MAX_PAYLOAD + 1U));
+    assert(seq_pattern_store_write(&g_store, 0U, g_buf, SEQ_PATTERN_STORE_MAX_PAYLOAD));
+    assert(!seq_pattern_store_mount(&g_store, base, SEQ_PATTERN_STORE_MAX_SECTORS + 1U));
+}
+
+int main(void) {
+    assert(board_flash_init());
+    test_append_and_remount();
+    test_torn_record_ignored();
+    test_live_set_wear();
+    test_no_service_falls_back();
+    test_rejects_invalid();
+    return 0;
+}
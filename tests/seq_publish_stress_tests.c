@@ -0,0 +1,223 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "apps/seq_engine_runner.h"
+#include "cart/cart_bus.h"
+#include "core/seq/reader/seq_reader.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+#include "core/seq/seq_scheduler.h"
+
+#include "seq_runner_env_stub.h"
+
+#define TEST_TICK_ST 4U
+#define TEST_STEP_ST (TEST_TICK_ST * 6U)
+#define READER_TICKS 1200000U
+
+/* Writer invariant: every edit rewrites the whole track with one value v, used
+   as note AND velocity of every step. A consistent snapshot therefore has
+   note == velocity everywhere and the same value on every step. */
+
+static seq_model_track_t *g_track;
+static volatile bool g_reader_done;
+static uint32_t g_edits;
+static uint32_t g_note_ons;
+static uint32_t g_bad_note_ons;
+
+void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+    if (((b0 & 0xF0U) == 0x90U) && (b2 != 0U)) {
+        g_note_ons++;
+        if (b1 != b2) {
+            g_bad_note_ons++;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stubs (host)                                                               */
+/* -------------------------------------------------------------------------- */
+
+/* Runner environment (LED bridge, mutes, cart link): seq_runner_env_stub.h. */
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static void fill_track(seq_model_track_t *track, uint8_t v) {
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+        seq_model_step_t *step = &track->steps[s];
+        step->voices[0].note = v;
+        step->voices[0].velocity = v;
+        step->voices[0].length = 1U;
+        step->voices[0].state = SEQ_MODEL_VOICE_ENABLED;
+        seq_model_step_recompute_flags(step);
+    }
+}
+
+static void prepare(void) {
+    seq_runtime_init();
+    seq_project_t *project = seq_runtime_access_project_mut();
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+    g_track = seq_runtime_access_track_mut(0U);
+    assert(g_track != NULL);
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+        seq_model_step_make_neutral(&g_track->steps[s]);
+    }
+    fill_track(g_track, 1U);
+    seq_model_gen_bump(&g_track->generation);
+    (void)seq_reader_plan_service();
+    seq_reader_sync_stats_reset();
+}
+
+static bool plan_is_consistent(const seq_plan_track_t *plan) {
+    const seq_plan_voice_t first = seq_plan_voice(plan, 0U, 0U);
+    if (plan->voice_bits != UINT64_MAX) {
+        return false;
+    }
+    for (uint8_t s = 0U; s < SEQ_PLAN_STEP_COUNT; ++s) {
+        const seq_plan_voice_t voice = seq_plan_voice(plan, s, 0U);
+        if ((voice.note != first.note) || (voice.vel != voice.note)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* UI-thread stand-in: edits back to back until the Reader is done, each one
+   compiled by the plan service once its write section is closed. The value is
+   computed outside the write section so preemption lands on both sides of it. */
+static void *writer(void *arg) {
+    (void)arg;
+    uint32_t i = 0U;
+    while (!__atomic_load_n(&g_reader_done, __ATOMIC_ACQUIRE)) {
+        uint32_t v = i;
+        for (uint8_t k = 0U; k < 64U; ++k) {
+            v = (v * 1103515245U) + 12345U;
+        }
+        seq_model_gen_write_begin(&g_track->generation);
+        fill_track(g_track, (uint8_t)(1U + (v % 100U)));
+        seq_model_gen_write_end(&g_track->generation);
+        (void)seq_reader_plan_service();
+        ++i;
+    }
+    g_edits = i;
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_open_write_section_serves_previous_plan(void) {
+    prepare();
+    const seq_track_handle_t h = seq_reader_make_handle(0U, 0U, 0U);
+    const seq_plan_track_t *plan = seq_reader_get_plan(h);
+    assert((plan != NULL) && (seq_plan_voice(plan, 5U, 0U).note == 1U));
+    assert(seq_reader_sync_stats.swaps == 1U);
+
+    /* Writer preempted mid-edit: the service does not wait, the Reader keeps the old plan. */
+    seq_model_gen_write_begin(&g_track->generation);
+    fill_track(g_track, 9U);
+    const uint32_t rebuilds = seq_reader_plan_rebuild_count();
+    assert(seq_reader_plan_service() == 0U);
+    assert(seq_reader_sync_stats.writer_active == 1U);
+    plan = seq_reader_get_plan(h);
+    assert((plan != NULL) && (seq_plan_voice(plan, 5U, 0U).note == 1U));
+    assert(seq_reader_plan_rebuild_count() == rebuilds);
+    assert(seq_reader_sync_stats.stale_plans == 1U);
+
+    /* The LED side reads flags without compiling. */
+    uint8_t flags[4];
+    assert(seq_reader_get_step_flags(h, 62U, 4U, flags));
+    assert((flags[0] & SEQ_STEPF_HAS_VOICE) && (flags[1] & SEQ_STEPF_HAS_VOICE));
+    assert((flags[2] == 0U) && (flags[3] == 0U));
+
+    /* Closed edit: still the old plan until the service compiled the new one. */
+    seq_model_gen_write_end(&g_track->generation);
+    plan = seq_reader_get_plan(h);
+    assert((plan != NULL) && (seq_plan_voice(plan, 5U, 0U).note == 1U));
+    assert(seq_reader_plan_service() == 1U);
+    plan = seq_reader_get_plan(h);
+    assert((plan != NULL) && (seq_plan_voice(plan, 5U, 0U).note == 9U));
+    assert(seq_reader_plan_rebuild_count() == (rebuilds + 1U));
+    assert((seq_reader_sync_stats.swaps == 2U) && (seq_reader_sync_stats.tick_compiles == 0U));
+}
+
+static void test_torn_plock_walk_is_dropped(void) {
+    prepare();
+    seq_model_plock_t plock = {.value = 7, .parameter_id = 3U, .domain = SEQ_MODEL_PLOCK_CART};
+    assert(seq_model_step_add_plock(&g_track->steps[0], &g_track->plocks, &plock));
+    seq_model_gen_bump(&g_track->generation);
+
+    seq_plock_iter_t it;
+    assert(seq_reader_plock_iter_open(seq_reader_make_handle(0U, 0U, 0U), 0U, &it));
+    uint16_t param = 0U;
+    int32_t value = 0;
+    assert(seq_reader_plock_iter_next(&it, &param, &value));
+    assert(!seq_reader_plock_iter_torn(&it));
+
+    seq_model_gen_bump(&g_track->generation); /* an edit landed during the walk */
+    assert(seq_reader_plock_iter_torn(&it));
+    assert(seq_reader_sync_stats.torn_plocks == 1U);
+}
+
+static void test_concurrent_edits_and_ticks(void) {
+    prepare();
+    seq_scheduler_init();
+    seq_engine_runner_init();
+    seq_engine_runner_on_transport_play();
+    g_note_ons = 0U;
+    g_bad_note_ons = 0U;
+    g_reader_done = false;
+
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, writer, NULL) == 0);
+
+    const seq_track_handle_t h = seq_reader_make_handle(0U, 0U, 0U);
+    uint32_t tick = 0U;
+    uint32_t step = 0U;
+    uint32_t plans = 0U;
+    while (tick < READER_TICKS) {
+        const systime_t now = (systime_t)(tick * TEST_TICK_ST);
+        seq_engine_runner_on_clock_tick(now);
+        if ((tick % 6U) == 0U) {
+            clock_step_info_t info = {
+                .now = now,
+                .step_idx_abs = step++,
+                .bpm = 120.0f,
+                .tick_st = TEST_TICK_ST,
+                .step_st = TEST_STEP_ST,
+                .ext_clock = false,
+            };
+            seq_engine_runner_on_clock_step(&info);
+        }
+        const seq_plan_track_t *plan = seq_reader_get_plan(h);
+        assert((plan != NULL) && plan_is_consistent(plan));
+        ++plans;
+        ++tick;
+    }
+    __atomic_store_n(&g_reader_done, true, __ATOMIC_RELEASE);
+    assert(pthread_join(thread, NULL) == 0);
+
+    assert(g_note_ons == step); /* stale plans still play: no step dropped */
+    assert(g_bad_note_ons == 0U);
+    assert(seq_reader_sync_stats.tick_compiles == 0U); /* every edit compiled by the writer side */
+    printf("publish_stress: edits=%u ticks=%u plans=%u rebuilds=%u torn_retries=%u writer_active=%u "
+           "stale_plans=%u swaps=%u note_ons=%u\n",
+           (unsigned)g_edits, (unsigned)tick, (unsigned)plans, (unsigned)seq_reader_plan_rebuild_count(),
+           (unsigned)seq_reader_sync_stats.torn_retries, (unsigned)seq_reader_sync_stats.writer_active,
+           (unsigned)seq_reader_sync_stats.stale_plans, (unsigned)seq_reader_sync_stats.swaps,
+           (unsigned)g_note_ons);
+}
+
+int main(void) {
+    test_open_write_section_serves_previous_plan();
+    test_torn_plock_walk_is_dropped();
+    test_concurrent_edits_and_ticks();
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include "core/seq/seq_runtime.h"
 #include "core/seq/seq_model.h"
 #include "core/seq/seq_project.h"
+#include "core/seq/seq_scale.h"
 #include "cart/cart_registry.h"
 
 bool board_flash_init(void) { return true; }
@@ -96,7 +97,7 @@ static void prepare_track(void) {
         .value = 42,
         .internal_param = SEQ_MODEL_PLOCK_PARAM_NOTE,
     };
-    assert(seq_model_step_add_plock(step, &plock));
+    assert(seq_model_step_add_plock(step, &track->plocks, &plock));
 }
 
 static void test_reader_get_step(void) {
@@ -157,10 +158,56 @@ static void test_invalid_handle(void) {
     assert(!seq_reader_plock_iter_open(handle, 0U, &it));
 }
 
+static void test_plan_applies_track_scale(void) {
+    prepare_track();
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    const seq_track_handle_t handle = {.bank = 0U, .pattern = 0U, .track = 0U};
+    (void)seq_reader_plan_service(); // every track compiled once, with its own note map
+    (void)seq_reader_get_plan(handle);
+    seq_reader_sync_stats_reset();
+
+    // E (64) is out of C minor: equidistant from D# and F, the lower wins.
+    seq_model_scale_config_t scale = {.enabled = true, .root = 0U, .mode = SEQ_MODEL_SCALE_MINOR};
+    seq_model_track_set_scale(track, &scale);
+    seq_model_gen_bump(&track->generation);
+    // Edits are compiled off the tick by the plan service, the runner swaps them in.
+    const uint32_t builds = seq_scale_lut_builds;
+    assert(seq_reader_plan_service() == 1U);
+    const seq_plan_track_t *plan = seq_reader_get_plan(handle);
+    assert((plan != NULL) && (seq_plan_voice(plan, 0U, 0U).note == 63U));
+    assert(seq_scale_lut_builds == (builds + 1U));
+
+    // Unrelated edit: the plan is rebuilt, the note map is not.
+    seq_model_gen_bump(&track->generation);
+    assert(seq_reader_plan_service() == 1U);
+    plan = seq_reader_get_plan(handle);
+    assert((plan != NULL) && (seq_plan_voice(plan, 0U, 0U).note == 63U));
+    assert(seq_scale_lut_builds == (builds + 1U));
+
+    // Transpose is applied before the scale; D minor keeps E.
+    seq_model_transpose_config_t transpose = track->config.transpose;
+    transpose.global = 2;
+    seq_model_track_set_transpose(track, &transpose);
+    scale.root = 2U;
+    seq_model_track_set_scale(track, &scale);
+    seq_model_gen_bump(&track->generation);
+    assert(seq_reader_plan_service() == 1U);
+    plan = seq_reader_get_plan(handle);
+    assert((plan != NULL) && (seq_plan_voice(plan, 0U, 0U).note == 65U)); // F# -> F
+    assert(seq_scale_lut_builds == (builds + 2U));
+    assert((seq_reader_sync_stats.swaps == 3U) && (seq_reader_sync_stats.tick_compiles == 0U));
+
+    // The cold path resolves the same note without the map.
+    seq_step_voice_view_t voice;
+    assert(seq_reader_get_step_voice(handle, 0U, 0U, &voice));
+    assert(voice.enabled && (voice.note == 65U));
+}
+
 int main(void) {
     test_reader_get_step();
     test_reader_plock_iter();
     test_invalid_handle();
+    test_plan_applies_track_scale();
 
     printf("seq_reader_tests: OK\n");
     return 0;
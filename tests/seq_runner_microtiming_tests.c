@@ -0,0 +1,541 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "apps/midi_probe.h"
+#include "apps/seq_engine_runner.h"
+#include "cart/cart_bus.h"
+#include "cart/cart_registry.h"
+#include "core/seq/reader/seq_reader.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+#include "core/seq/seq_scheduler.h"
+
+#include "seq_runner_env_stub.h"
+
+#define TEST_TICK_ST 4U
+#define TEST_STEP_ST (TEST_TICK_ST * 6U)
+#define TEST_PLOCK_PARAM 42U
+
+/* -------------------------------------------------------------------------- */
+/* Capture                                                                    */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    systime_t time;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    uint8_t dests; /* scheduler output bits (DIN | USB for midi_tx3) */
+} captured_event_t;
+
+static systime_t g_now = 0U;
+static captured_event_t g_events[1024];
+static unsigned g_event_count = 0U;
+static systime_t g_plock_time = 0U;
+static unsigned g_plock_count = 0U;
+static unsigned g_plock_order = 0U;
+
+void midi_tx3_to(uint8_t dests, uint8_t b0, uint8_t b1, uint8_t b2) {
+    if (g_event_count < (sizeof(g_events) / sizeof(g_events[0]))) {
+        g_events[g_event_count++] = (captured_event_t){g_now, b0, b1, b2, dests};
+    }
+}
+
+void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+    midi_tx3_to(SEQ_SCHEDULER_OUT_MIDI, b0, b1, b2);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stubs (host)                                                               */
+/* -------------------------------------------------------------------------- */
+
+/* Runner environment (LED bridge, mutes, cart link): seq_runner_env_stub.h. */
+
+static void capture_param_send(uint16_t param_id, uint8_t value, cart_class_t cls) {
+    (void)cls;
+    if ((param_id == TEST_PLOCK_PARAM) && (value == 99U)) {
+        g_plock_time = g_now;
+        g_plock_order = g_event_count;
+        ++g_plock_count;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static void set_voice(seq_model_track_t *track, uint8_t step, uint8_t note, int8_t micro) {
+    seq_model_step_t *slot = &track->steps[step];
+    seq_model_step_make_neutral(slot);
+    slot->voices[0].note = note;
+    slot->voices[0].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+    slot->voices[0].length = 1U;
+    slot->voices[0].micro_offset = micro;
+    slot->voices[0].state = SEQ_MODEL_VOICE_ENABLED;
+    seq_model_step_recompute_flags(slot);
+}
+
+static void prepare_pattern(void) {
+    seq_runtime_init();
+
+    seq_project_t *project = seq_runtime_access_project_mut();
+    assert(project != NULL);
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    assert(track != NULL);
+
+    /* Step 0: on the grid. */
+    set_voice(track, 0U, 60U, 0);
+    /* Step 1: late by half a step, with a cart p-lock. */
+    set_voice(track, 1U, 62U, 6);
+    seq_model_plock_t plock = {
+        .value = 99,
+        .parameter_id = TEST_PLOCK_PARAM,
+        .domain = SEQ_MODEL_PLOCK_CART,
+    };
+    assert(seq_model_step_add_plock(&track->steps[1], &track->plocks, &plock));
+    seq_model_step_recompute_flags(&track->steps[1]);
+    /* Step 3: early by a quarter step, pushed further by the step "All" offset. */
+    set_voice(track, 3U, 64U, -2);
+    track->steps[3].offsets.micro = -1;
+    track->steps[3].offsets.transpose = 2;
+
+    seq_model_gen_bump(&track->generation);
+    (void)seq_reader_plan_service(); /* UI thread: plans compiled off the tick */
+}
+
+static int find_event(uint8_t status, uint8_t note, systime_t *out_time) {
+    for (unsigned i = 0U; i < g_event_count; ++i) {
+        if ((g_events[i].status == status) && (g_events[i].data1 == note)) {
+            *out_time = g_events[i].time;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/* Time of the only event matching @p dest; asserts it was sent exactly once there. */
+static systime_t event_time_on(uint8_t status, uint8_t note, uint8_t dest) {
+    unsigned hits = 0U;
+    systime_t t = 0U;
+    for (unsigned i = 0U; i < g_event_count; ++i) {
+        if ((g_events[i].status == status) && (g_events[i].data1 == note) && ((g_events[i].dests & dest) != 0U)) {
+            t = g_events[i].time;
+            hits++;
+        }
+    }
+    assert(hits == 1U);
+    return t;
+}
+
+static unsigned event_count(uint8_t status, uint8_t note) {
+    unsigned hits = 0U;
+    for (unsigned i = 0U; i < g_event_count; ++i) {
+        if ((g_events[i].status == status) && (g_events[i].data1 == note)) {
+            hits++;
+        }
+    }
+    return hits;
+}
+
+/* Playback from step @p first_step (locate + Continue), first tick at @p origin. */
+static void run_ticks_from(uint32_t first_step, systime_t origin, uint32_t tick_count) {
+    uint32_t step = first_step;
+    for (uint32_t tick = 0U; tick < tick_count; ++tick) {
+        g_now = (systime_t)(origin + (tick * TEST_TICK_ST));
+        seq_engine_runner_on_clock_tick(g_now);
+        if ((tick % 6U) == 0U) {
+            clock_step_info_t info = {
+                .now = g_now,
+                .step_idx_abs = step++,
+                .bpm = 120.0f,
+                .tick_st = TEST_TICK_ST,
+                .step_st = TEST_STEP_ST,
+            };
+            seq_engine_runner_on_clock_step(&info);
+        }
+    }
+}
+
+/* Clock ticks plus the clock_seq service wake-ups between them (one call per system tick). */
+static void run_steps_serviced(uint32_t step_count) {
+    uint32_t step = 0U;
+    systime_t next_due = 0U;
+    bool armed = false;
+    for (systime_t t = 0U; t < (step_count * TEST_STEP_ST); ++t) {
+        g_now = t;
+        if ((t % TEST_TICK_ST) == 0U) {
+            seq_engine_runner_on_clock_tick(t);
+            if ((t % TEST_STEP_ST) == 0U) {
+                clock_step_info_t info = {
+                    .now = t,
+                    .step_idx_abs = step++,
+                    .bpm = 120.0f,
+                    .tick_st = TEST_TICK_ST,
+                    .step_st = TEST_STEP_ST,
+                };
+                seq_engine_runner_on_clock_step(&info);
+            }
+            armed = seq_engine_runner_service(t, &next_due);
+        } else if (armed && ((int32_t)(t - next_due) >= 0)) {
+            armed = seq_engine_runner_service(t, &next_due);
+        }
+    }
+}
+
+static void run_ticks(uint32_t tick_count) {
+    uint32_t step = 0U;
+    for (uint32_t tick = 0U; tick < tick_count; ++tick) {
+        g_now = (systime_t)(tick * TEST_TICK_ST);
+        seq_engine_runner_on_clock_tick(g_now);
+        if ((tick % 6U) == 0U) {
+            clock_step_info_t info = {
+                .now = g_now,
+                .step_idx_abs = step++,
+                .bpm = 120.0f,
+                .tick_st = TEST_TICK_ST,
+                .step_st = TEST_STEP_ST,
+                .ext_clock = false,
+            };
+            seq_engine_runner_on_clock_step(&info);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_scheduler_ordering(void) {
+    seq_scheduler_init();
+
+    const seq_scheduler_event_t on = {.due = 10U, .type = SEQ_SCHEDULER_EV_NOTE_ON, .note = 1U};
+    const seq_scheduler_event_t plock = {.due = 10U, .type = SEQ_SCHEDULER_EV_PLOCK, .param_id = 2U};
+    const seq_scheduler_event_t off = {.due = 10U, .type = SEQ_SCHEDULER_EV_NOTE_OFF, .note = 3U};
+    const seq_scheduler_event_t early = {.due = 5U, .type = SEQ_SCHEDULER_EV_NOTE_ON, .note = 4U};
+    assert(seq_scheduler_push(&on));
+    assert(seq_scheduler_push(&plock));
+    assert(seq_scheduler_push(&off));
+    assert(seq_scheduler_push(&early));
+    assert(seq_scheduler_pending() == 4U);
+
+    assert(seq_scheduler_dispatch(4U, NULL) == 0U);
+    assert(seq_scheduler_dispatch(7U, NULL) == 1U);
+    assert(seq_scheduler_stats.lateness_max == 2U);
+    assert(seq_scheduler_dispatch(10U, NULL) == 3U);
+    assert(seq_scheduler_pending() == 0U);
+    assert(seq_scheduler_stats.dispatched == 4U);
+    assert(seq_scheduler_stats.jitter_max == 2U);
+
+    /* Saturate with NOTE_ON: a NOTE_OFF must still find room. */
+    for (unsigned i = 0U; i < SEQ_SCHEDULER_CAPACITY; ++i) {
+        const seq_scheduler_event_t fill = {.due = 100U + i, .type = SEQ_SCHEDULER_EV_NOTE_ON};
+        assert(seq_scheduler_push(&fill));
+    }
+    assert(!seq_scheduler_push(&on));
+    assert(seq_scheduler_push(&off));
+    assert(seq_scheduler_stats.dropped == 2U);
+    assert(seq_scheduler_pending() == SEQ_SCHEDULER_CAPACITY);
+    seq_scheduler_init();
+}
+
+static void test_scheduler_output_offsets(void) {
+    seq_scheduler_init();
+    const uint8_t din = SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_DIN);
+
+    /* Microseconds, rounded half away from zero to the 100 us system tick, clamped. */
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_DIN, 250);
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, -150);
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_CART1, -30000);
+    assert(seq_scheduler_get_latency(SEQ_SCHEDULER_OUT_CART1) == -SEQ_SCHEDULER_LATENCY_MAX_US);
+    assert(seq_scheduler_lead() == 200U);
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_CART1, 0);
+    assert(seq_scheduler_lead() == 2U);
+
+    /* One entry per event, each output group released at due + offset. */
+    const seq_scheduler_event_t on = {.due = 100U, .type = SEQ_SCHEDULER_EV_NOTE_ON, .outputs = SEQ_SCHEDULER_OUT_MIDI};
+    const seq_scheduler_event_t off = {
+        .due = 110U, .type = SEQ_SCHEDULER_EV_NOTE_OFF, .outputs = SEQ_SCHEDULER_OUT_MIDI, .track = 1U, .slot = 2U};
+    assert(seq_scheduler_push(&on));
+    assert(seq_scheduler_push(&off));
+    assert(seq_scheduler_pending() == 2U);
+    systime_t next = 0U;
+    assert(seq_scheduler_next_release(&next) && (next == 98U));
+
+    assert(seq_scheduler_dispatch(97U, NULL) == 0U);
+    assert(seq_scheduler_dispatch(98U, NULL) == 1U);
+    assert(seq_scheduler_pending() == 2U); /* DIN still pending on the same entry */
+    assert(seq_scheduler_next_release(&next) && (next == 103U));
+    assert(seq_scheduler_dispatch(103U, NULL) == 1U);
+    assert(seq_scheduler_pending() == 1U);
+    assert(seq_scheduler_stats.lateness_max == 0U);
+    assert(seq_scheduler_stats.scheduled == 2U);
+
+    /* Withdrawing a NOTE_OFF withdraws it from every output. */
+    assert(seq_scheduler_cancel_note_off(1U, 2U));
+    assert(seq_scheduler_pending() == 0U);
+    assert(!seq_scheduler_next_release(&next));
+
+    /* Same offset on both outputs: a single copy. */
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, 270);
+    assert(seq_scheduler_push(&on));
+    assert(seq_scheduler_pending() == 1U);
+    assert(seq_scheduler_lead() == 0U);
+    seq_scheduler_clear();
+
+    /* Split offsets cost no extra entry; a full queue still evicts for a NOTE_OFF. */
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, -150);
+    for (unsigned i = 0U; i < (SEQ_SCHEDULER_CAPACITY - 1U); ++i) {
+        const seq_scheduler_event_t fill = {.due = 200U + i, .type = SEQ_SCHEDULER_EV_NOTE_ON, .outputs = din};
+        assert(seq_scheduler_push(&fill));
+    }
+    assert(seq_scheduler_push(&on));
+    assert(seq_scheduler_pending() == SEQ_SCHEDULER_CAPACITY);
+    assert(!seq_scheduler_push(&on));
+    assert(seq_scheduler_push(&off));
+    assert(seq_scheduler_pending() == SEQ_SCHEDULER_CAPACITY);
+
+    /* Offsets are read at release: a pending event follows a new setting. */
+    seq_scheduler_clear();
+    assert(seq_scheduler_push(&on));
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, 500);
+    assert(seq_scheduler_dispatch(98U, NULL) == 0U);
+    assert(seq_scheduler_dispatch(103U, NULL) == 1U); /* DIN */
+    assert(seq_scheduler_next_release(&next) && (next == 105U));
+    assert(seq_scheduler_dispatch(105U, NULL) == 1U); /* USB */
+    assert(seq_scheduler_pending() == 0U);
+
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_DIN, 0);
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, 0);
+    seq_scheduler_init();
+}
+
+static void test_runner_microtiming(void) {
+    midi_probe_reset();
+    prepare_pattern();
+    seq_engine_runner_init();
+    g_event_count = 0U;
+
+    run_ticks(6U * 6U);
+
+    systime_t t = 0U;
+    assert((find_event(0x90U, 60U, &t) >= 0) && (t == 0U));
+    assert((find_event(0x80U, 60U, &t) >= 0) && (t == TEST_STEP_ST));
+
+    /* +6 micro-ticks = half a step after the step 1 boundary. */
+    const int on_index = find_event(0x90U, 62U, &t);
+    assert((on_index >= 0) && (t == (TEST_STEP_ST + (TEST_STEP_ST / 2U))));
+    /* P-lock due tick_st/2 before the note: released on the same dispatch tick, ahead of it. */
+    assert(g_plock_count == 1U);
+    assert((g_plock_time >= TEST_STEP_ST) && (g_plock_time <= t));
+    assert(g_plock_order <= (unsigned)on_index);
+
+    /* -3 micro-ticks (voice -2 + All -1) and +2 transpose: fires before step 3. */
+    const systime_t step3 = 3U * TEST_STEP_ST;
+    assert(find_event(0x90U, 66U, &t) >= 0);
+    assert(t < step3);
+    assert(t >= (step3 - (TEST_STEP_ST / 4U)));
+    assert((find_event(0x80U, 66U, &t) >= 0) && (t < (step3 + TEST_STEP_ST)));
+
+    assert(seq_scheduler_stats.late == 0U);
+    assert(seq_scheduler_stats.lateness_max < TEST_TICK_ST);
+    assert(seq_scheduler_stats.overflow == 0U);
+
+    printf("runner_microtiming: dispatched=%u lateness_max=%u jitter_max=%u high_water=%u\n",
+           (unsigned)seq_scheduler_stats.dispatched, (unsigned)seq_scheduler_stats.lateness_max,
+           (unsigned)seq_scheduler_stats.jitter_max, (unsigned)seq_scheduler_stats.queue_high_water);
+
+    seq_engine_runner_on_transport_stop();
+    assert(seq_scheduler_pending() == 0U);
+}
+
+/* Negative USB offset: every voice is planned one step ahead and the clock_seq
+   service releases each output at its own time, between ticks. */
+static void test_runner_output_latency(void) {
+    const uint8_t din = SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_DIN);
+    const uint8_t usb = SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_USB);
+    midi_probe_reset();
+    prepare_pattern();
+    seq_engine_runner_init();
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, -300);
+    g_event_count = 0U;
+    g_plock_count = 0U;
+    run_steps_serviced(6U);
+
+    /* Step 1, +6 micro: DIN on time, USB 3 ticks ahead, each sent once. */
+    const systime_t on62 = TEST_STEP_ST + (TEST_STEP_ST / 2U);
+    assert(event_time_on(0x90U, 62U, din) == on62);
+    assert(event_time_on(0x90U, 62U, usb) == (on62 - 3U));
+    assert(event_time_on(0x80U, 60U, usb) == (TEST_STEP_ST - 3U));
+    assert(event_time_on(0x80U, 60U, din) == TEST_STEP_ST);
+    /* Step 3, early voice: still ahead of its boundary on both outputs. */
+    const systime_t on66 = event_time_on(0x90U, 66U, din);
+    assert(on66 < (3U * TEST_STEP_ST));
+    assert(event_time_on(0x90U, 66U, usb) == (on66 - 3U));
+    assert(g_plock_count == 1U);
+    assert(seq_scheduler_stats.late == 0U);
+
+    printf("runner_output_latency: lead=%u dispatched=%u lateness_max=%u\n", (unsigned)seq_scheduler_lead(),
+           (unsigned)seq_scheduler_stats.dispatched, (unsigned)seq_scheduler_stats.lateness_max);
+
+    seq_engine_runner_on_transport_stop();
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, 0);
+}
+
+static unsigned count_note_on(uint8_t dest) {
+    unsigned hits = 0U;
+    for (unsigned i = 0U; i < g_event_count; ++i) {
+        if (((g_events[i].status & 0xF0U) == 0x90U) && ((g_events[i].dests & dest) != 0U)) {
+            hits++;
+        }
+    }
+    return hits;
+}
+
+/* 16 tracks x 4 voices on every step, DIN and USB on different offsets: each
+   event must take a single queue entry or the look-ahead pass drops NOTE_ONs. */
+static void test_runner_dense_offsets(void) {
+    const uint8_t din = SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_DIN);
+    const uint8_t usb = SEQ_SCHEDULER_OUT_BIT(SEQ_SCHEDULER_OUT_USB);
+    const uint32_t steps = 4U;
+    midi_probe_reset();
+    seq_runtime_init();
+    seq_project_t *project = seq_runtime_access_project_mut();
+    assert(project != NULL);
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+    for (uint8_t t = 0U; t < SEQ_RUNTIME_TRACK_CAPACITY; ++t) {
+        seq_model_track_t *track = seq_runtime_access_track_mut(t);
+        assert(track != NULL);
+        for (uint8_t s = 0U; s < steps; ++s) {
+            seq_model_step_t *st = &track->steps[s];
+            seq_model_step_make_neutral(st);
+            for (uint8_t v = 0U; v < SEQ_MODEL_VOICES_PER_STEP; ++v) {
+                st->voices[v].note = (uint8_t)(48U + (v * 7U) + s);
+                st->voices[v].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+                st->voices[v].length = 3U; /* still sounding when the next step retriggers */
+                st->voices[v].state = SEQ_MODEL_VOICE_ENABLED;
+            }
+            seq_model_step_recompute_flags(st);
+        }
+        seq_model_gen_bump(&track->generation);
+        seq_model_gen_bump(&track->generation);
+    }
+    (void)seq_reader_plan_service();
+
+    seq_engine_runner_init();
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_DIN, 200);
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, -300);
+    seq_engine_runner_on_transport_play();
+    g_event_count = 0U;
+    run_steps_serviced(steps + 1U);
+
+    const unsigned expected = SEQ_RUNTIME_TRACK_CAPACITY * SEQ_MODEL_VOICES_PER_STEP * steps;
+    assert(seq_scheduler_stats.dropped == 0U);
+    assert(seq_scheduler_stats.overflow == 0U);
+    assert(count_note_on(din) == expected);
+    assert(count_note_on(usb) == expected);
+    assert(seq_scheduler_stats.queue_high_water <= SEQ_SCHEDULER_CAPACITY);
+
+    printf("runner_dense_offsets: notes=%u high_water=%u capacity=%u\n", expected,
+           (unsigned)seq_scheduler_stats.queue_high_water, (unsigned)SEQ_SCHEDULER_CAPACITY);
+
+    seq_engine_runner_on_transport_stop();
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_DIN, 0);
+    seq_scheduler_set_latency(SEQ_SCHEDULER_OUT_USB, 0);
+}
+
+static void set_chase_voice(seq_model_track_t *track, uint8_t step, uint8_t slot, uint8_t note, uint8_t length,
+                            int8_t micro) {
+    seq_model_step_t *st = &track->steps[step];
+    seq_model_step_make_neutral(st);
+    st->voices[0].state = SEQ_MODEL_VOICE_DISABLED;
+    st->voices[slot].note = note;
+    st->voices[slot].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+    st->voices[slot].length = length;
+    st->voices[slot].micro_offset = micro;
+    st->voices[slot].state = SEQ_MODEL_VOICE_ENABLED;
+    seq_model_step_recompute_flags(st);
+    seq_model_gen_bump(&track->generation); /* one bump per edit, as the editor does */
+}
+
+/* Start mid-pattern: the voices still sounding at the start step are sent again,
+   found by a backward scan that stops once every slot is resolved. */
+static void test_runner_chase(void) {
+    midi_probe_reset();
+    seq_runtime_init();
+    seq_project_t *project = seq_runtime_access_project_mut();
+    assert(project != NULL);
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    assert(track != NULL);
+
+    set_chase_voice(track, 0U, 0U, 68U, 20U, 0);  /* cut by step 2 on the first pass */
+    set_chase_voice(track, 2U, 0U, 70U, 8U, 0);   /* sounds until step 10 */
+    set_chase_voice(track, 3U, 1U, 72U, 2U, 0);   /* over at step 5 */
+    set_chase_voice(track, 4U, 2U, 74U, 4U, 6);   /* 4.5 -> 8.5 */
+    set_chase_voice(track, 6U, 3U, 76U, 1U, 0);   /* played by the start step itself */
+    set_chase_voice(track, 62U, 0U, 80U, 4U, 0);  /* cut by step 0 of the next pass */
+    (void)seq_reader_plan_service();
+
+    seq_engine_runner_init();
+    memset(&seq_engine_runner_chase_stats, 0, sizeof(seq_engine_runner_chase_stats));
+
+    /* From the top: nothing before step 0. */
+    seq_engine_runner_on_transport_play();
+    g_event_count = 0U;
+    run_ticks_from(0U, 500U, 1U);
+    assert(seq_engine_runner_chase_stats.chases == 0U);
+    seq_engine_runner_on_transport_stop();
+
+    /* Locate to step 6. */
+    const systime_t t0 = 1000U;
+    seq_engine_runner_on_transport_play();
+    g_event_count = 0U;
+    run_ticks_from(6U, t0, 6U * 6U);
+    assert(seq_engine_runner_chase_stats.chases == 1U);
+    assert(seq_engine_runner_chase_stats.notes == 2U);
+    assert(seq_engine_runner_chase_stats.steps_visited == 3U);  /* steps 4, 3, 2: step 0 never read */
+    assert(event_time_on(0x90U, 70U, SEQ_SCHEDULER_OUT_MIDI) == t0);
+    assert(event_time_on(0x80U, 70U, SEQ_SCHEDULER_OUT_MIDI) == (t0 + (4U * TEST_STEP_ST)));
+    assert(event_time_on(0x90U, 74U, SEQ_SCHEDULER_OUT_MIDI) == t0);
+    assert(event_time_on(0x80U, 74U, SEQ_SCHEDULER_OUT_MIDI) == (t0 + (5U * TEST_STEP_ST / 2U)));
+    assert(event_time_on(0x90U, 76U, SEQ_SCHEDULER_OUT_MIDI) == t0);
+    assert((event_count(0x90U, 68U) == 0U) && (event_count(0x90U, 72U) == 0U));
+    seq_engine_runner_on_transport_stop();
+
+    /* Step 65 (second pass): the scan wraps to the end of the pattern. Step 64 cut
+       step 62 on slot 0 and still sounds; the other slots ended long ago. */
+    const systime_t t1 = 5000U;
+    seq_engine_runner_on_transport_play();
+    g_event_count = 0U;
+    run_ticks_from(65U, t1, 6U);
+    assert(seq_engine_runner_chase_stats.chases == 2U);
+    assert(seq_engine_runner_chase_stats.notes == 3U);
+    assert(seq_engine_runner_chase_stats.steps_visited == 5U);  /* 64, 62, 6, 4, 3 */
+    assert(event_time_on(0x90U, 68U, SEQ_SCHEDULER_OUT_MIDI) == t1);
+    assert(event_count(0x90U, 80U) == 0U);
+    assert(seq_scheduler_stats.late == 0U);
+
+    printf("runner_chase: chases=%u notes=%u steps_visited=%u\n", (unsigned)seq_engine_runner_chase_stats.chases,
+           (unsigned)seq_engine_runner_chase_stats.notes, (unsigned)seq_engine_runner_chase_stats.steps_visited);
+
+    seq_engine_runner_on_transport_stop();
+    /* The chased NOTE_OFF went out with the stop. */
+    assert(event_count(0x80U, 68U) == 1U);
+}
+
+int main(void) {
+    g_stub_cart_param_send = capture_param_send;
+    test_scheduler_ordering();
+    test_scheduler_output_offsets();
+    test_runner_microtiming();
+    test_runner_output_latency();
+    test_runner_dense_offsets();
+    test_runner_chase();
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core/seq/reader/seq_reader.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+#include "tests/support/rt_timing.h"
+
+#define BENCH_TRACK_COUNT SEQ_RUNTIME_TRACK_CAPACITY
+#define BENCH_TICK_COUNT (SEQ_MODEL_STEPS_PER_TRACK * 8U)
+#define BENCH_PLOCK_PARAM 7U
+
+/* Sink defeating dead-code elimination of both paths. */
+static volatile uint32_t g_sink = 0U;
+
+static void fill_track(seq_model_track_t *track, uint8_t track_index) {
+    for (uint8_t step = 0U; step < SEQ_MODEL_STEPS_PER_TRACK; ++step) {
+        seq_model_step_t *slot = &track->steps[step];
+        seq_model_step_make_neutral(slot);
+        for (uint8_t v = 0U; v < SEQ_MODEL_VOICES_PER_STEP; ++v) {
+            slot->voices[v].note = (uint8_t)(48U + track_index + (v * 4U));
+            slot->voices[v].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+            slot->voices[v].length = 1U;
+            slot->voices[v].micro_offset = (int8_t)((step % 3U) - 1);
+            slot->voices[v].state = SEQ_MODEL_VOICE_ENABLED;
+        }
+        if ((step % 4U) == 0U) {
+            seq_model_plock_t plock = {
+                .value = (int16_t)step,
+                .parameter_id = BENCH_PLOCK_PARAM,
+                .domain = SEQ_MODEL_PLOCK_CART,
+            };
+            (void)seq_model_step_add_plock(slot, &track->plocks, &plock);
+        }
+        seq_model_step_recompute_flags(slot);
+    }
+    track->config.transpose.global = 2;
+    seq_model_gen_bump(&track->generation);
+}
+
+static void prepare_project(void) {
+    seq_runtime_init();
+
+    seq_project_t *project = seq_runtime_access_project_mut();
+    assert(project != NULL);
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        seq_model_track_t *track = seq_runtime_access_track_mut(t);
+        assert(track != NULL);
+        fill_track(track, t);
+    }
+}
+
+static void drain_plocks(seq_track_handle_t handle, uint8_t step_idx) {
+    seq_plock_iter_t it;
+    if (!seq_reader_plock_iter_open(handle, step_idx, &it)) {
+        return;
+    }
+    uint16_t param_id = 0U;
+    int32_t value = 0;
+    while (seq_reader_plock_iter_next(&it, &param_id, &value)) {
+        g_sink += (uint32_t)param_id + (uint32_t)value;
+    }
+}
+
+/* Runner access pattern before the plan: one step view and four voice views per track. */
+static void tick_legacy(uint8_t step_idx) {
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        const seq_track_handle_t handle = seq_reader_make_handle(0U, 0U, t);
+        seq_step_view_t view;
+        if (!seq_reader_get_step(handle, step_idx, &view)) {
+            continue;
+        }
+        for (uint8_t v = 0U; v < SEQ_MODEL_VOICES_PER_STEP; ++v) {
+            seq_step_voice_view_t voice;
+            if (seq_reader_get_step_voice(handle, step_idx, v, &voice) && voice.enabled && (voice.vel > 0U)) {
+                g_sink += (uint32_t)voice.note + (uint32_t)voice.vel + (uint32_t)voice.length;
+            }
+        }
+        if ((view.flags & SEQ_STEPF_HAS_CART_PLOCK) != 0U) {
+            drain_plocks(handle, step_idx);
+        }
+    }
+}
+
+/* Runner access pattern with the plan: one cached lookup per track, mask walk. */
+static void tick_plan(uint8_t step_idx) {
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        const seq_track_handle_t handle = seq_reader_make_handle(0U, 0U, t);
+        const seq_plan_track_t *plan = seq_reader_get_plan(handle);
+        if (plan == NULL) {
+            continue;
+        }
+        uint8_t voices = (uint8_t)(plan->voice_mask[step_idx] & SEQ_PLAN_VOICE_PLAY_MASK);
+        for (uint8_t v = 0U; voices != 0U; ++v, voices >>= 1U) {
+            if ((voices & 1U) != 0U) {
+                g_sink += (uint32_t)plan->note[step_idx][v] + (uint32_t)plan->vel[step_idx][v] +
+                          (uint32_t)plan->length[step_idx][v];
+            }
+        }
+        if (((plan->cart_plock_bits >> step_idx) & 1U) != 0U) {
+            drain_plocks(handle, step_idx);
+        }
+    }
+}
+
+/* Full 16x64 "which steps play" scan, straight over the resident AoS steps. */
+static void scan_aos(uint8_t unused) {
+    (void)unused;
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        const seq_model_track_t *track = seq_runtime_access_track_mut(t);
+        for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+            const seq_model_step_t *step = &track->steps[s];
+            if (seq_model_step_has_playable_voice(step) && !seq_model_step_is_automation_only(step)) {
+                g_sink += s;
+            }
+        }
+    }
+}
+
+/* Same scan through the plan: one contiguous flags array per track. */
+static void scan_soa(uint8_t unused) {
+    (void)unused;
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        const seq_plan_track_t *plan = seq_reader_get_plan(seq_reader_make_handle(0U, 0U, t));
+        for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+            if (plan->voice_mask[s] != 0U) {
+                g_sink += s;
+            }
+        }
+    }
+}
+
+/* Distinct 64-byte lines covered by @p count fields of @p width bytes, @p stride apart. */
+static uint32_t lines_touched(const void *base, size_t stride, size_t width, uint32_t count) {
+    uintptr_t last = UINTPTR_MAX;
+    uint32_t lines = 0U;
+    for (uint32_t i = 0U; i < count; ++i) {
+        const uintptr_t first = ((uintptr_t)base + (i * stride)) >> 6;
+        const uintptr_t end = ((uintptr_t)base + (i * stride) + width - 1U) >> 6;
+        for (uintptr_t line = first; line <= end; ++line) {
+            if (line != last) {
+                ++lines;
+                last = line;
+            }
+        }
+    }
+    return lines;
+}
+
+static double run_bench(void (*tick)(uint8_t)) {
+    rt_tim_reset();
+    for (uint32_t i = 0U; i < BENCH_TICK_COUNT; ++i) {
+        rt_tim_tick_begin();
+        tick((uint8_t)(i % SEQ_MODEL_STEPS_PER_TRACK));
+        rt_tim_tick_end();
+    }
+    return rt_tim_p99_ns();
+}
+
+static void test_plan_matches_reader(void) {
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        const seq_track_handle_t handle = seq_reader_make_handle(0U, 0U, t);
+        const seq_plan_track_t *plan = seq_reader_get_plan(handle);
+        assert(plan != NULL);
+        for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+            seq_step_view_t view;
+            assert(seq_reader_get_step(handle, s, &view));
+            assert(plan->flags[s] == view.flags);
+            assert(((plan->cart_plock_bits >> s) & 1U) == (((view.flags & SEQ_STEPF_HAS_CART_PLOCK) != 0U) ? 1U : 0U));
+            assert(((plan->voice_bits >> s) & 1U) == ((plan->voice_mask[s] != 0U) ? 1U : 0U));
+            for (uint8_t v = 0U; v < SEQ_MODEL_VOICES_PER_STEP; ++v) {
+                seq_step_voice_view_t voice;
+                assert(seq_reader_get_step_voice(handle, s, v, &voice));
+                const bool playable = voice.enabled && (voice.vel > 0U);
+                assert(((plan->voice_mask[s] >> v) & 1U) == (playable ? 1U : 0U));
+                if (playable) {
+                    const seq_plan_voice_t resolved = seq_plan_voice(plan, s, v);
+                    assert(resolved.note == voice.note);
+                    assert(resolved.vel == voice.vel);
+                    assert(resolved.length == voice.length);
+                    assert(resolved.micro == voice.micro);
+                    assert(((plan->voice_mask[s] >> (SEQ_PLAN_VOICE_EARLY_SHIFT + v)) & 1U) == ((voice.micro < 0) ? 1U : 0U));
+                }
+            }
+        }
+    }
+}
+
+static void test_plan_rebuilds_on_generation(void) {
+    const seq_track_handle_t handle = seq_reader_make_handle(0U, 0U, 0U);
+    (void)seq_reader_get_plan(handle);
+    const uint32_t before = seq_reader_plan_rebuild_count();
+    (void)seq_reader_get_plan(handle);
+    assert(seq_reader_plan_rebuild_count() == before);
+
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    track->steps[5].voices[0].note = 100U;
+    seq_model_gen_bump(&track->generation);
+
+    /* The tick never compiles an edit: it plays the previous plan until the
+       service (UI thread) compiled the new one, then swaps it in. */
+    const uint32_t tick_compiles = seq_reader_sync_stats.tick_compiles;
+    const seq_plan_track_t *plan = seq_reader_get_plan(handle);
+    assert(seq_reader_plan_rebuild_count() == before);
+    assert(plan->note[5][0] != 102U);
+    assert(seq_reader_plan_service() == 1U);
+    assert(seq_reader_plan_rebuild_count() == (before + 1U));
+    plan = seq_reader_get_plan(handle);
+    assert(plan->note[5][0] == 102U);
+    assert(seq_reader_plan_service() == 0U);
+    assert(seq_reader_sync_stats.tick_compiles == tick_compiles);
+}
+
+int main(void) {
+    prepare_project();
+    test_plan_matches_reader();
+
+    /* Warm both paths once so the first plan build is not charged to a tick. */
+    for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
+        tick_legacy(s);
+        tick_plan(s);
+    }
+
+    const double legacy_p99 = run_bench(tick_legacy);
+    const double plan_p99 = run_bench(tick_plan);
+    printf("runner_plan_bench: tracks=%u ticks=%u legacy_p99_ns=%.0f plan_p99_ns=%.0f rebuilds=%u\n",
+           (unsigned)BENCH_TRACK_COUNT,
+           (unsigned)BENCH_TICK_COUNT,
+           legacy_p99,
+           plan_p99,
+           (unsigned)seq_reader_plan_rebuild_count());
+
+    /* Full-pattern scan: cache lines the scan pulls in, per layout (whole step vs flags byte). */
+    uint32_t aos_lines = 0U;
+    uint32_t soa_lines = 0U;
+    for (uint8_t t = 0U; t < BENCH_TRACK_COUNT; ++t) {
+        const seq_model_track_t *track = seq_runtime_access_track_mut(t);
+        const seq_plan_track_t *plan = seq_reader_get_plan(seq_reader_make_handle(0U, 0U, t));
+        aos_lines += lines_touched(track->steps, sizeof(track->steps[0]), sizeof(track->steps[0]),
+                                   SEQ_MODEL_STEPS_PER_TRACK);
+        soa_lines += lines_touched(plan->voice_mask, 1U, 1U, SEQ_MODEL_STEPS_PER_TRACK);
+    }
+    for (uint8_t i = 0U; i < 4U; ++i) {
+        scan_aos(0U);
+        scan_soa(0U);
+    }
+    const double aos_p99 = run_bench(scan_aos);
+    const double soa_p99 = run_bench(scan_soa);
+    printf("runner_plan_bench: scan %ux%u aos_lines=%u soa_lines=%u aos_p99_ns=%.0f soa_p99_ns=%.0f\n",
+           (unsigned)BENCH_TRACK_COUNT,
+           (unsigned)SEQ_MODEL_STEPS_PER_TRACK,
+           (unsigned)aos_lines,
+           (unsigned)soa_lines,
+           aos_p99,
+           soa_p99);
+    assert((soa_lines * 8U) <= aos_lines);
+
+    test_plan_rebuilds_on_generation();
+    return 0;
+}
@@ -0,0 +1,470 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "apps/seq_engine_runner.h"
+#include "cart/cart_bus.h"
+#include "cart/cart_dirty.h"
+#include "cart/cart_registry.h"
+#include "core/seq/reader/seq_reader.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+#include "core/seq/seq_scheduler.h"
+
+#include "seq_runner_env_stub.h"
+
+#define TEST_TICK_ST 4U
+#define TEST_STEP_ST (TEST_TICK_ST * 6U)
+#define TEST_TRACKS 16U
+#define LOCKED_STEPS 4U
+
+/* -------------------------------------------------------------------------- */
+/* Capture                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static cart_id_t g_active_cart = CART1;
+static uint32_t g_restores = 0U;
+static uint32_t g_bad_restores = 0U;
+static uint32_t g_frames = 0U;
+static uint8_t g_last_lock[CART_PARAM_COUNT];
+static uint8_t g_lock_frames[CART_PARAM_COUNT];
+
+#define TRACE_DEPTH 16U
+static uint16_t g_trace_param = CART_PARAM_COUNT;
+static uint8_t g_trace[TRACE_DEPTH];
+static uint32_t g_trace_len = 0U;
+
+/* The shadow value of a parameter is derived from its id, so every restore
+   can be checked against the value captured when the lock was taken. */
+static uint8_t shadow_value(uint16_t param_id) {
+    return (uint8_t)((param_id * 5U) & 0x3FU);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stubs (host)                                                               */
+/* -------------------------------------------------------------------------- */
+
+void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+    (void)b0;
+    (void)b1;
+    (void)b2;
+}
+
+/* Runner environment (LED bridge, mutes, cart link): seq_runner_env_stub.h. */
+
+static void capture_param_send(uint16_t param_id, uint8_t value, cart_class_t cls) {
+    g_frames++;
+    if ((param_id == g_trace_param) && (g_trace_len < TRACE_DEPTH)) {
+        g_trace[g_trace_len++] = value;
+    }
+    /* Scheduled p-lock values are >= 0x40 in this test; restores carry their own class. */
+    if (cls == CART_CLASS_RESTORE) {
+        g_restores++;
+        if (value != shadow_value(param_id)) {
+            g_bad_restores++;
+        }
+    } else if (param_id < CART_PARAM_COUNT) {
+        g_last_lock[param_id] = value;
+        g_lock_frames[param_id]++;
+    }
+}
+
+static uint8_t shadow_get(cart_id_t cid, uint16_t param_id) {
+    (void)cid;
+    return shadow_value(param_id);
+}
+
+cart_id_t cart_registry_get_active_id(void) {
+    return g_active_cart;
+}
+
+void cart_registry_init(void) {}
+
+void cart_registry_register(cart_id_t id, const struct ui_cart_spec_t *ui_spec) {
+    (void)id;
+    (void)ui_spec;
+}
+
+const struct ui_cart_spec_t *cart_registry_get_ui_spec(cart_id_t id) {
+    (void)id;
+    return NULL;
+}
+
+const struct ui_cart_spec_t *cart_registry_switch(cart_id_t id) {
+    (void)id;
+    return NULL;
+}
+
+bool cart_registry_is_present(cart_id_t id) {
+    (void)id;
+    return true;
+}
+
+void cart_registry_set_uid(cart_id_t id, uint32_t uid) {
+    (void)id;
+    (void)uid;
+}
+
+uint32_t cart_registry_get_uid(cart_id_t id) {
+    (void)id;
+    return 0U;
+}
+
+bool cart_registry_find_by_uid(uint32_t uid, cart_id_t *out_id) {
+    (void)uid;
+    if (out_id != NULL) {
+        *out_id = CART1;
+    }
+    return false;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t g_step = 0U;
+static uint32_t g_tick = 0U;
+
+/* Param of lock @p i on @p step of @p track: consecutive steps overlap partly,
+   so locks are both re-taken and freshly acquired on every step. */
+static uint16_t lock_param(uint8_t track, uint8_t step, uint8_t i) {
+    return (uint16_t)(((track * SEQ_MODEL_MAX_PLOCKS_PER_STEP) + i + (step * 7U)) % CART_PARAM_COUNT);
+}
+
+static void start(void) {
+    g_active_cart = CART1;
+    seq_scheduler_init();
+    seq_engine_runner_init();
+    seq_engine_runner_on_transport_play();
+    g_step = 0U;
+    g_tick = 0U;
+    g_restores = 0U;
+    g_bad_restores = 0U;
+    g_frames = 0U;
+    memset(g_last_lock, 0, sizeof(g_last_lock));
+    memset(g_lock_frames, 0, sizeof(g_lock_frames));
+    g_trace_param = CART_PARAM_COUNT;
+    g_trace_len = 0U;
+}
+
+static void clear_model(void) {
+    seq_runtime_init();
+    seq_project_t *project = seq_runtime_access_project_mut();
+    (void)seq_project_set_active_slot(project, 0U, 0U);
+}
+
+/* A voice (micro offset @p micro) and one cart p-lock on @p step of @p track. */
+static void lock_step(uint8_t t, uint8_t s, uint16_t param_id, uint8_t value, int8_t micro, bool slide) {
+    seq_model_track_t *track = seq_runtime_access_track_mut(t);
+    assert(track != NULL);
+    seq_model_step_t *step = &track->steps[s];
+    seq_model_step_make_neutral(step);
+    step->voices[0].note = (uint8_t)(48U + t);
+    step->voices[0].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+    step->voices[0].length = 1U;
+    step->voices[0].micro_offset = micro;
+    step->voices[0].state = SEQ_MODEL_VOICE_ENABLED;
+    const seq_model_plock_t plock = {
+        .value = (int16_t)value,
+        .parameter_id = param_id,
+        .domain = SEQ_MODEL_PLOCK_CART,
+        .slide = slide,
+    };
+    assert(seq_model_step_add_plock(step, &track->plocks, &plock));
+    seq_model_step_recompute_flags(step);
+    seq_model_gen_bump(&track->generation);
+}
+
+/* Add a cart p-lock to a step that already plays. */
+static void add_lock(uint8_t t, uint8_t s, uint16_t param_id, uint8_t value, bool slide) {
+    seq_model_track_t *track = seq_runtime_access_track_mut(t);
+    assert(track != NULL);
+    const seq_model_plock_t plock = {
+        .value = (int16_t)value,
+        .parameter_id = param_id,
+        .domain = SEQ_MODEL_PLOCK_CART,
+        .slide = slide,
+    };
+    assert(seq_model_step_add_plock(&track->steps[s], &track->plocks, &plock));
+    seq_model_step_recompute_flags(&track->steps[s]);
+    seq_model_gen_bump(&track->generation);
+}
+
+/* Every track: a voice and SEQ_MODEL_MAX_PLOCKS_PER_STEP cart p-locks on steps 0..3. */
+static void prepare(void) {
+    clear_model();
+
+    for (uint8_t t = 0U; t < TEST_TRACKS; ++t) {
+        seq_model_track_t *track = seq_runtime_access_track_mut(t);
+        assert(track != NULL);
+        for (uint8_t s = 0U; s < LOCKED_STEPS; ++s) {
+            seq_model_step_t *step = &track->steps[s];
+            seq_model_step_make_neutral(step);
+            step->voices[0].note = (uint8_t)(48U + t);
+            step->voices[0].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+            step->voices[0].length = 1U;
+            step->voices[0].state = SEQ_MODEL_VOICE_ENABLED;
+            for (uint8_t i = 0U; i < SEQ_MODEL_MAX_PLOCKS_PER_STEP; ++i) {
+                const seq_model_plock_t plock = {
+                    .value = (int16_t)(0x40 + i),
+                    .parameter_id = lock_param(t, s, i),
+                    .domain = SEQ_MODEL_PLOCK_CART,
+                };
+                assert(seq_model_step_add_plock(step, &track->plocks, &plock));
+            }
+            seq_model_step_recompute_flags(step);
+        }
+        seq_model_gen_bump(&track->generation);
+    }
+    start();
+}
+
+static void run_steps(uint32_t steps) {
+    (void)seq_reader_plan_service(); /* UI thread: edits compiled before the ticks */
+    const uint32_t end = g_step + steps;
+    while (g_step < end) {
+        const systime_t now = (systime_t)(g_tick * TEST_TICK_ST);
+        seq_engine_runner_on_clock_tick(now);
+        if ((g_tick % 6U) == 0U) {
+            clock_step_info_t info = {
+                .now = now,
+                .step_idx_abs = g_step++,
+                .bpm = 120.0f,
+                .tick_st = TEST_TICK_ST,
+                .step_st = TEST_STEP_ST,
+                .ext_clock = false,
+            };
+            seq_engine_runner_on_clock_step(&info);
+        }
+        ++g_tick;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_worst_case_fits_and_restores(void) {
+    prepare();
+    run_steps(SEQ_MODEL_STEPS_PER_TRACK * 2U);
+
+    /* 16 tracks x 24 locks held at once; the former 24-slot table dropped 360 of them. */
+    assert(seq_engine_runner_plock_stats.exhausted == 0U);
+    assert(seq_engine_runner_plock_stats.out_of_range == 0U);
+    assert(seq_engine_runner_plock_stats.high_water >= (TEST_TRACKS * SEQ_MODEL_MAX_PLOCKS_PER_STEP));
+    assert(seq_engine_runner_plock_stats.high_water <= CART_PARAM_COUNT);
+
+    /* Steps 4..63 carry no lock: everything was restored and released. */
+    assert(seq_engine_runner_plock_stats.active == 0U);
+    assert(g_restores > 0U);
+    assert(g_bad_restores == 0U);
+    assert(seq_engine_runner_plock_stats.restores == g_restores);
+    assert(seq_engine_runner_plock_stats.collisions == 0U);
+
+    printf("plock_table: high_water=%u probe_max=%u restores=%u\n",
+           (unsigned)seq_engine_runner_plock_stats.high_water,
+           (unsigned)seq_engine_runner_plock_stats.probe_max, (unsigned)g_restores);
+}
+
+static void test_stop_restores_held_locks(void) {
+    prepare();
+    run_steps(2U); /* step 1 locks held */
+    const uint16_t held = seq_engine_runner_plock_stats.active;
+    assert(held >= (TEST_TRACKS * SEQ_MODEL_MAX_PLOCKS_PER_STEP));
+    assert(g_stub_cart_tick_st == TEST_TICK_ST); /* cart link metered one clock tick at a time */
+
+    const uint32_t restores = g_restores;
+    seq_engine_runner_on_transport_stop();
+    assert((g_restores - restores) == held);
+    assert(g_bad_restores == 0U);
+    assert(g_stub_cart_tick_st == 0U);
+    assert(seq_engine_runner_plock_stats.active == 0U);
+}
+
+static void test_cart_switch_releases_without_restore(void) {
+    prepare();
+    run_steps(2U);
+    assert(seq_engine_runner_plock_stats.active > 0U);
+
+    /* Locks taken on CART1 have nothing to restore on CART2: they are dropped,
+       not leaked until the next transport stop. */
+    g_active_cart = CART2;
+    const uint32_t restores = g_restores;
+    run_steps(1U);
+    assert(g_restores == restores);
+    /* Only the locks of step 2, taken on CART2, are held now. */
+    assert(seq_engine_runner_plock_stats.active == (TEST_TRACKS * SEQ_MODEL_MAX_PLOCKS_PER_STEP));
+
+    run_steps(SEQ_MODEL_STEPS_PER_TRACK - 3U);
+    assert(seq_engine_runner_plock_stats.active == 0U);
+    /* Steps 2 and 3 locked CART2; every parameter of either step is restored once
+       (step 3 shifts the window by 7 parameters). */
+    assert(g_restores == (restores + (TEST_TRACKS * SEQ_MODEL_MAX_PLOCKS_PER_STEP) + 7U));
+    assert(g_bad_restores == 0U);
+    assert(seq_engine_runner_plock_stats.exhausted == 0U);
+}
+
+static void test_out_of_range_param_is_counted(void) {
+    prepare();
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    const seq_model_plock_t plock = {
+        .value = 0x50,
+        .parameter_id = CART_PARAM_COUNT + 3U,
+        .domain = SEQ_MODEL_PLOCK_CART,
+    };
+    seq_model_step_t *step = &track->steps[8];
+    seq_model_step_make_neutral(step);
+    assert(seq_model_step_add_plock(step, &track->plocks, &plock));
+    seq_model_step_recompute_flags(step);
+    seq_model_gen_bump(&track->generation);
+
+    run_steps(SEQ_MODEL_STEPS_PER_TRACK);
+    assert(seq_engine_runner_plock_stats.out_of_range == 1U);
+    assert(seq_engine_runner_plock_stats.exhausted == 0U);
+}
+
+static void test_repeated_lock_is_sent_once(void) {
+    clear_model();
+    for (uint8_t s = 0U; s < 8U; ++s) {
+        lock_step(0U, s, 10U, 0x50U, 0, false);
+    }
+    start();
+
+    /* Steps 0..7 hold one value, 8..15 are unlocked: one lock and one restore per loop. */
+    run_steps(SEQ_MODEL_STEPS_PER_TRACK * 2U);
+    assert(seq_engine_runner_plock_stats.sent == 2U);
+    assert(seq_engine_runner_plock_stats.unchanged == 14U);
+    assert(seq_engine_runner_plock_stats.restores == 2U);
+    assert(g_frames == 4U);
+    assert(g_restores == 2U);
+    assert(g_bad_restores == 0U);
+    assert(seq_engine_runner_plock_stats.active == 0U);
+
+    /* A different value on step 4 is a transition of its own, and so is step 5. */
+    lock_step(0U, 4U, 10U, 0x51U, 0, false);
+    run_steps(SEQ_MODEL_STEPS_PER_TRACK);
+    assert(seq_engine_runner_plock_stats.sent == 5U);
+    assert(g_frames == 8U);
+}
+
+static void test_collision_lowest_track_wins(void) {
+    clear_model();
+    /* Track 3 is planned one step ahead (negative micro), track 1 on time: the
+       lowest track must win whatever the pass that planned it. */
+    lock_step(3U, 1U, 100U, 0x60U, -3, false);
+    lock_step(1U, 1U, 100U, 0x50U, 0, false);
+    start();
+
+    run_steps(2U);
+    assert(seq_engine_runner_plock_stats.collisions == 1U);
+    assert(seq_engine_runner_plock_stats.active == 1U);
+    run_steps(1U);
+    assert(g_last_lock[100] == 0x50U);
+    assert(seq_engine_runner_plock_stats.restores == 1U);
+    assert(seq_engine_runner_plock_stats.active == 0U);
+
+    /* Other order: the lower track is the early one, the higher one is dropped. */
+    lock_step(1U, 1U, 100U, 0x50U, -3, false);
+    lock_step(3U, 1U, 100U, 0x60U, 0, false);
+    start();
+    run_steps(3U);
+    assert(seq_engine_runner_plock_stats.collisions == 1U);
+    assert(seq_engine_runner_plock_stats.sent == 1U);
+    assert(g_last_lock[100] == 0x50U);
+    assert(g_bad_restores == 0U);
+    printf("plock_diff: collisions=%u sent=%u\n", (unsigned)seq_engine_runner_plock_stats.collisions,
+           (unsigned)seq_engine_runner_plock_stats.sent);
+}
+
+static void test_slide_ramps_over_the_step(void) {
+    clear_model();
+    lock_step(0U, 0U, 20U, 0x7FU, 0, true);
+    start();
+    g_trace_param = 20U;
+
+    /* One step of 6 ticks: 5 intermediate values then the lock value, no frame at
+       the start (the ramp leaves from the value already on the cart). */
+    run_steps(3U);
+    const uint8_t from = shadow_value(20U);
+    assert(seq_engine_runner_plock_stats.slides == 1U);
+    assert(seq_engine_runner_plock_stats.slide_skipped == 0U);
+    assert(seq_engine_runner_plock_stats.slide_frames == 6U);
+    assert(seq_engine_runner_plock_stats.sent == 0U);
+    assert(g_trace_len == 7U);
+    for (uint32_t k = 1U; k <= 5U; ++k) {
+        assert(g_trace[k - 1U] == (uint8_t)(from + (((0x7FU - from) * k * TEST_TICK_ST) / TEST_STEP_ST)));
+    }
+    assert(g_trace[5] == 0x7FU);
+    assert(g_trace[6] == from); /* step 1 does not lock it: restored at its end */
+    assert(seq_engine_runner_plock_stats.active == 0U);
+}
+
+static void test_slides_share_the_link_budget(void) {
+    /* CART_UART_BAUD over one host step: 120 bytes, half of it for ramps. */
+    const uint32_t share = (uint32_t)(((uint64_t)(CART_UART_BAUD / 10U) * TEST_STEP_ST / CH_CFG_ST_FREQUENCY) / 2U);
+    clear_model();
+    for (uint8_t i = 0U; i < 16U; ++i) {
+        if (i == 0U) {
+            lock_step(0U, 0U, 40U, 0x7FU, 0, true);
+            lock_step(1U, 0U, 60U, 0x7FU, 0, true);
+        } else {
+            add_lock(0U, 0U, (uint16_t)(40U + i), 0x7FU, true);
+            add_lock(1U, 0U, (uint16_t)(60U + i), 0x7FU, true);
+        }
+    }
+    start();
+    run_steps(1U);
+    assert(seq_engine_runner_plock_stats.slide_budget == share);
+    run_steps(1U);
+    /* The 32 restores planned at the end of step 1 use up the next step's share. */
+    assert(seq_engine_runner_plock_stats.slide_budget == 0U);
+
+    /* 32 ramps want 5 intermediate frames each; only the budget goes out, every
+       ramp still lands on its value. */
+    assert(seq_engine_runner_plock_stats.slides == 32U);
+    assert(seq_engine_runner_plock_stats.slide_skipped > 0U);
+    const uint32_t intermediate = seq_engine_runner_plock_stats.slide_frames - 32U;
+    assert((intermediate * 3U) <= share);
+    for (uint8_t i = 0U; i < 16U; ++i) {
+        assert(g_last_lock[40U + i] == 0x7FU);
+        assert(g_last_lock[60U + i] == 0x7FU);
+        assert(g_lock_frames[40U + i] >= 1U); /* round robin: no ramp starves */
+    }
+    printf("plock_slide: budget=%u frames=%u skipped=%u\n", (unsigned)share,
+           (unsigned)seq_engine_runner_plock_stats.slide_frames,
+           (unsigned)seq_engine_runner_plock_stats.slide_skipped);
+
+    /* Plain locks of the same step come first: 24 frames of 3 bytes leave the
+       ramps nothing but their final values. */
+    for (uint8_t i = 0U; i < SEQ_MODEL_MAX_PLOCKS_PER_STEP; ++i) {
+        if (i == 0U) {
+            lock_step(2U, 0U, 100U, 0x50U, 0, false);
+        } else {
+            add_lock(2U, 0U, (uint16_t)(100U + i), 0x50U, false);
+        }
+    }
+    start();
+    run_steps(2U);
+    assert(seq_engine_runner_plock_stats.sent == SEQ_MODEL_MAX_PLOCKS_PER_STEP);
+    assert(seq_engine_runner_plock_stats.slide_frames == 32U);
+    for (uint8_t i = 0U; i < SEQ_MODEL_MAX_PLOCKS_PER_STEP; ++i) {
+        assert(g_last_lock[100U + i] == 0x50U);
+    }
+}
+
+int main(void) {
+    g_stub_cart_param_send = capture_param_send;
+    g_stub_cart_shadow_get = shadow_get;
+    test_worst_case_fits_and_restores();
+    test_stop_restores_held_locks();
+    test_cart_switch_releases_without_restore();
+    test_out_of_range_param_is_counted();
+    test_repeated_lock_is_sent_once();
+    test_collision_lowest_track_wins();
+    test_slide_ramps_over_the_step();
+    test_slides_share_the_link_budget();
+    return 0;
+}
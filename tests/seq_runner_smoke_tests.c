@@ -43,11 +43,14 @@ bool ui_mute_backend_is_muted(uint8_t track) {
     return false;
 }
 
-void cart_link_param_changed(uint16_t param_id, uint8_t value, bool is_bitwise, uint8_t bit_mask) {
+void cart_link_param_send(uint16_t param_id, uint8_t value, cart_class_t cls) {
     (void)param_id;
     (void)value;
-    (void)is_bitwise;
-    (void)bit_mask;
+    (void)cls;
+}
+
+void cart_bus_on_tick(uint32_t tick_st) {
+    (void)tick_st;
 }
 
 uint8_t cart_link_shadow_get(cart_id_t cid, uint16_t param_id) {
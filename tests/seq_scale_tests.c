@@ -0,0 +1,87 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/seq/seq_scale.h"
+
+#define MODE_COUNT 5U
+
+/* Reference: nearest in-scale note inside [0, 127], the lower one on a tie. */
+static uint8_t reference_snap(uint16_t mask, uint8_t root, uint8_t note) {
+    int32_t best = -1;
+    int32_t best_dist = 128;
+    for (int32_t n = 0; n < 128; ++n) {
+        const int32_t pc = (n - (int32_t)root + 120) % 12;
+        if ((mask & (1U << pc)) == 0U) {
+            continue;
+        }
+        const int32_t dist = (n > note) ? (n - note) : (note - n);
+        if (dist < best_dist) { /* ascending scan: ties keep the lower note */
+            best = n;
+            best_dist = dist;
+        }
+    }
+    return (uint8_t)best;
+}
+
+static void test_maps_match_reference(void) {
+    static seq_scale_lut_t lut;
+    for (uint8_t mode = 0U; mode < MODE_COUNT; ++mode) {
+        const uint16_t mask = seq_scale_mask(mode);
+        for (uint8_t root = 0U; root < 12U; ++root) {
+            seq_scale_lut_build(&lut, mask, root);
+            for (uint32_t n = 0U; n < SEQ_SCALE_NOTE_COUNT; ++n) {
+                const uint8_t expected = reference_snap(mask, root, (uint8_t)n);
+                assert(seq_scale_lut_apply(&lut, (uint8_t)n) == expected);
+                assert(seq_scale_snap(mask, root, (uint8_t)n) == expected);
+            }
+        }
+    }
+}
+
+static void test_known_degrees(void) {
+    const uint16_t major = seq_scale_mask(SEQ_MODEL_SCALE_MAJOR);
+    assert(seq_scale_snap(major, 0U, 61U) == 60U); /* C# -> C (tie, lower) */
+    assert(seq_scale_snap(major, 0U, 66U) == 65U); /* F# -> F */
+    assert(seq_scale_snap(major, 2U, 61U) == 61U); /* C# in D major */
+    assert(seq_scale_snap(major, 0U, 127U) == 127U);
+    assert(seq_scale_snap(major, 2U, 0U) == 1U);   /* no degree below 0: go up */
+    assert(seq_scale_mask(200U) == SEQ_SCALE_MASK_CHROMATIC);
+
+    const seq_model_scale_config_t off = {.enabled = false, .root = 3U, .mode = SEQ_MODEL_SCALE_MINOR};
+    assert(seq_scale_config_mask(&off) == SEQ_SCALE_MASK_CHROMATIC);
+    const seq_model_scale_config_t on = {.enabled = true, .root = 3U, .mode = SEQ_MODEL_SCALE_MINOR};
+    assert(seq_scale_config_mask(&on) == seq_scale_mask(SEQ_MODEL_SCALE_MINOR));
+}
+
+static void test_prepare_rebuilds_on_change_only(void) {
+    seq_scale_lut_t lut;
+    memset(&lut, 0, sizeof(lut));
+    const uint16_t dorian = seq_scale_mask(SEQ_MODEL_SCALE_DORIAN);
+
+    const uint32_t builds = seq_scale_lut_builds;
+    const uint8_t *map = seq_scale_lut_prepare(&lut, dorian, 2U);
+    assert(seq_scale_lut_builds == (builds + 1U));
+    for (uint32_t i = 0U; i < 1000U; ++i) {
+        assert(seq_scale_lut_prepare(&lut, dorian, 14U) == map); /* root 14 == root 2 */
+    }
+    assert(seq_scale_lut_builds == (builds + 1U));
+
+    (void)seq_scale_lut_prepare(&lut, dorian, 3U);
+    assert(seq_scale_lut_builds == (builds + 2U));
+    (void)seq_scale_lut_prepare(&lut, SEQ_SCALE_MASK_CHROMATIC, 3U);
+    assert(seq_scale_lut_builds == (builds + 3U));
+    for (uint32_t n = 0U; n < SEQ_SCALE_NOTE_COUNT; ++n) {
+        assert(lut.map[n] == n);
+    }
+    printf("scale: lut_bytes=%zu builds=%u\n", sizeof(seq_scale_lut_t), (unsigned)seq_scale_lut_builds);
+}
+
+int main(void) {
+    test_maps_match_reference();
+    test_known_degrees();
+    test_prepare_rebuilds_on_change_only();
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "apps/seq_engine_runner.h"
+#include "board/board_flash.h"
+#include "cart/cart_bus.h"
+#include "core/seq/seq_model.h"
+#include "core/seq/seq_pattern_queue.h"
+#include "core/seq/seq_project.h"
+#include "core/seq/seq_runtime.h"
+#include "core/seq/seq_scheduler.h"
+#include "core/seq/seq_song.h"
+
+#include "seq_runner_env_stub.h"
+
+#define TEST_TICK_ST 4U
+#define TEST_STEP_ST (TEST_TICK_ST * 6U)
+#define PATTERN_COUNT 4U
+#define NOTE_BASE 60U
+#define SONG_LENGTH 256U
+
+/* -------------------------------------------------------------------------- */
+/* Capture                                                                    */
+/* -------------------------------------------------------------------------- */
+
+/* Note played on step 0 of each 64-step block (0 = silent block). */
+static uint8_t g_block_note[600];
+static uint32_t g_block = 0U;
+static uint32_t g_step = 0U;
+static uint32_t g_tick = 0U;
+
+void midi_tx3(uint8_t b0, uint8_t b1, uint8_t b2) {
+    if (((b0 & 0xF0U) == 0x90U) && (b2 != 0U) && (g_block < (sizeof(g_block_note)))) {
+        g_block_note[g_block] = b1;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Stubs (host)                                                               */
+/* -------------------------------------------------------------------------- */
+
+/* Runner environment (LED bridge, mutes, cart link): seq_runner_env_stub.h. */
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+/* Pattern (0, p): track 0 plays NOTE_BASE + p on step 0 only. */
+static void prepare_patterns(void) {
+    seq_runtime_init();
+    seq_pattern_queue_init();
+    seq_song_init();
+
+    seq_project_t *project = seq_runtime_access_project_mut();
+    seq_model_track_t *track = seq_runtime_access_track_mut(0U);
+    for (uint8_t i = 0U; i < PATTERN_COUNT; ++i) {
+        const uint8_t p = (uint8_t)(PATTERN_COUNT - 1U - i); /* (0, 0) ends up live */
+        (void)seq_project_set_active_slot(project, 0U, p);
+        seq_model_step_t *slot = &track->steps[0];
+        seq_model_step_make_neutral(slot);
+        slot->voices[0].note = (uint8_t)(NOTE_BASE + p);
+        slot->voices[0].velocity = SEQ_MODEL_DEFAULT_VELOCITY_PRIMARY;
+        slot->voices[0].length = 1U;
+        slot->voices[0].state = SEQ_MODEL_VOICE_ENABLED;
+        seq_model_step_recompute_flags(slot);
+        assert(seq_pattern_save(0U, p));
+    }
+    seq_model_gen_bump(&track->generation);
+
+    seq_scheduler_init();
+    seq_led_bridge_set_active(0U, 0U);
+    seq_engine_runner_init();
+    seq_engine_runner_on_transport_play();
+    memset(g_block_note, 0, sizeof(g_block_note));
+    g_block = 0U;
+    g_step = 0U;
+    g_tick = 0U;
+}
+
+/* Storage thread stand-in: read the next entry, then decode it. */
+static void storage_service(void) {
+    (void)seq_song_service(0U);
+    (void)seq_pattern_queue_service(0U);
+}
+
+/* Run @p blocks 64-step blocks; the storage thread runs once per block if @p serviced. */
+static void run_blocks(uint32_t blocks, bool serviced) {
+    for (uint32_t b = 0U; b < blocks; ++b) {
+        if (serviced) {
+            storage_service();
+        }
+        const uint32_t end = g_step + SEQ_MODEL_STEPS_PER_TRACK;
+        while (g_step < end) {
+            const systime_t now = (systime_t)(g_tick * TEST_TICK_ST);
+            g_block = g_step / SEQ_MODEL_STEPS_PER_TRACK;
+            seq_engine_runner_on_clock_tick(now);
+            if ((g_tick % 6U) == 0U) {
+                clock_step_info_t info = {
+                    .now = now,
+                    .step_idx_abs = g_step++,
+                    .bpm = 120.0f,
+                    .tick_st = TEST_TICK_ST,
+                    .step_st = TEST_STEP_ST,
+                    .ext_clock = false,
+                };
+                seq_engine_runner_on_clock_step(&info);
+            }
+            ++g_tick;
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Tests                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void test_song_repeats_mutes_and_end(void) {
+    prepare_patterns();
+    const seq_project_song_entry_t song[] = {
+        {.bank = 0U, .pattern = 1U, .repeats = 2U},
+        {.bank = 0U, .pattern = 2U, .repeats = 1U, .mute_mask = 0x0001U},
+        {.bank = 0U, .pattern = 3U, .repeats = 0U}, /* 0 plays once */
+    };
+    assert(seq_project_song_save(song, 3U, 0U));
+    uint8_t flags = 0xFFU;
+    assert(seq_project_song_length(&flags) == 3U);
+    assert(flags == 0U);
+
+    assert(seq_song_start(0U));
+    run_blocks(7U, true);
+
+    /* Block 0 is the pattern that was live; the song takes over at the first boundary. */
+    const uint8_t expect[] = {60U, 61U, 61U, 0U, 63U, 63U, 63U};
+    for (uint32_t b = 0U; b < 7U; ++b) {
+        assert(g_block_note[b] == expect[b]);
+    }
+    assert(!seq_song_is_active()); /* not looped: the last pattern keeps playing */
+    assert(seq_song_stats.entries_played == 3U);
+    assert(seq_song_stats.entries_read == 3U);
+    assert(seq_song_stats.underruns == 0U);
+    assert((g_stub_active_bank == 0U) && (g_stub_active_pattern == 3U));
+}
+
+static void test_underrun_loops_current_pattern(void) {
+    prepare_patterns();
+    const seq_project_song_entry_t song[] = {
+        {.bank = 0U, .pattern = 1U, .repeats = 1U},
+        {.bank = 0U, .pattern = 2U, .repeats = 1U},
+    };
+    assert(seq_project_song_save(song, 2U, SEQ_PROJECT_SONG_FLAG_LOOP));
+    assert(seq_song_start(0U));
+
+    run_blocks(1U, true);  /* entry 0 decoded */
+    run_blocks(1U, false); /* storage thread stalls: entry 1 not read in time */
+    assert(seq_song_stats.underruns == 1U);
+    run_blocks(4U, true);
+
+    const uint8_t expect[] = {60U, 61U, 61U, 62U, 61U, 62U};
+    for (uint32_t b = 0U; b < 6U; ++b) {
+        assert(g_block_note[b] == expect[b]);
+    }
+    assert(seq_song_is_active());
+    uint8_t repeats = 0U;
+    assert(seq_song_position(&repeats) == 0U); /* block 6 already flipped back to entry 0 */
+    assert(repeats == 1U);
+
+    seq_song_stop();
+    assert(!seq_song_is_active());
+    assert(!seq_pattern_queue_pending(NULL, NULL));
+}
+
+/* 256 entries streamed from flash: the only decoded patterns are the live set
+   and the queue's shadow set, whatever the song length. */
+static void test_long_song_streams_entries(void) {
+    prepare_patterns();
+    static seq_project_song_entry_t song[SONG_LENGTH];
+    for (uint16_t i = 0U; i < SONG_LENGTH; ++i) {
+        song[i] = (seq_project_song_entry_t){.bank = 0U, .pattern = (uint8_t)((i * 7U) % PATTERN_COUNT), .repeats = 1U};
+    }
+    assert(seq_project_song_save(song, SONG_LENGTH, 0U));
+    assert(!seq_project_song_save(song, SEQ_PROJECT_SONG_MAX_ENTRIES + 1U, 0U));
+
+    seq_project_song_entry_t entry;
+    assert(seq_project_song_read(SONG_LENGTH - 1U, &entry));
+    assert(entry.pattern == song[SONG_LENGTH - 1U].pattern);
+    assert(!seq_project_song_read(SONG_LENGTH, &entry));
+
+    assert(seq_song_start(0U));
+    run_blocks(SONG_LENGTH + 2U, true);
+    for (uint32_t i = 0U; i < SONG_LENGTH; ++i) {
+        assert(g_block_note[i + 1U] == (uint8_t)(NOTE_BASE + song[i].pattern));
+    }
+    assert(seq_song_stats.entries_played == SONG_LENGTH);
+    assert(seq_song_stats.underruns == 0U);
+    assert(seq_pattern_queue_stats.swaps == SONG_LENGTH);
+
+    printf("song: entries=%u read=%u played=%u underruns=%u decoded_sets=2 state_bytes=%zu\n",
+           (unsigned)SONG_LENGTH, (unsigned)seq_song_stats.entries_read,
+           (unsigned)seq_song_stats.entries_played, (unsigned)seq_song_stats.underruns,
+           sizeof(seq_project_song_entry_t) * 2U);
+}
+
+/* Output latency offsets live in the project header (format 3), next to the tempo. */
+static void test_project_output_latency_round_trip(void) {
+    seq_runtime_init();
+    seq_project_t *project = seq_runtime_access_project_mut();
+    assert(seq_project_get_output_latency(project, 0U) == 0);
+
+    assert(seq_project_set_output_latency(project, 0U, 1200));
+    assert(seq_project_set_output_latency(project, 3U, -450));
+    assert(seq_project_set_output_latency(project, 5U, -90000)); /* clamped */
+    assert(!seq_project_set_output_latency(project, SEQ_PROJECT_OUTPUT_COUNT, 100));
+    assert(seq_project_save(0U));
+
+    for (uint8_t out = 0U; out < SEQ_PROJECT_OUTPUT_COUNT; ++out) {
+        (void)seq_project_set_output_latency(project, out, 0);
+    }
+    assert(seq_project_load(0U));
+    assert(seq_project_get_output_latency(project, 0U) == 1200);
+    assert(seq_project_get_output_latency(project, 1U) == 0);
+    assert(seq_project_get_output_latency(project, 3U) == -450);
+    assert(seq_project_get_output_latency(project, 5U) == -SEQ_PROJECT_LATENCY_MAX_US);
+    assert(project->tempo == 120U);
+}
+
+int main(void) {
+    assert(board_flash_init());
+    assert(board_flash_erase(0U, SEQ_PROJECT_FLASH_SLOT_SIZE));
+    test_song_repeats_mutes_and_end();
+    test_underrun_loops_current_pattern();
+    test_long_song_streams_entries();
+    test_project_output_latency_round_trip();
+    return 0;
+}
@@ -91,7 +91,7 @@ static void populate_track(seq_model_track_t *track) {
             .voice_index = 0U,
             .internal_param = SEQ_MODEL_PLOCK_PARAM_LENGTH
         };
-        assert(seq_model_step_add_plock(s, &internal));
+        assert(seq_model_step_add_plock(s, &track->plocks, &internal));
 
         seq_model_plock_t cart = {
             .value = (int16_t)(-step),
@@ -100,7 +100,7 @@ static void populate_track(seq_model_track_t *track) {
             .voice_index = 1U,
             .internal_param = 0U
         };
-        assert(seq_model_step_add_plock(s, &cart));
+        assert(seq_model_step_add_plock(s, &track->plocks, &cart));
     }
 }
 
@@ -110,9 +110,11 @@ static bool track_equals(const seq_model_track_t *lhs, const seq_model_track_t *
 
 static bool track_has_cart_plocks(const seq_model_track_t *track) {
     for (uint8_t s = 0U; s < SEQ_MODEL_STEPS_PER_TRACK; ++s) {
-        const seq_model_step_t *step = &track->steps[s];
-        for (uint8_t p = 0U; p < step->plock_count; ++p) {
-            if (step->plocks[p].domain == SEQ_MODEL_PLOCK_CART) {
+        seq_model_plock_iter_t it;
+        seq_model_plock_t plock;
+        seq_model_step_plock_iter(&track->steps[s], &track->plocks, &it);
+        while (seq_model_plock_iter_next(&it, &plock)) {
+            if (plock.domain == SEQ_MODEL_PLOCK_CART) {
                 return true;
             }
         }
@@ -133,10 +135,11 @@ static bool track_has_enabled_voice(const seq_model_track_t *track) {
 }
 
 int main(void) {
-    seq_model_track_t original;
-    seq_model_track_t decoded_full;
-    seq_model_track_t decoded_drop;
-    seq_model_track_t decoded_absent;
+    /* Static storage: padding bytes are zeroed, so track_equals() can memcmp. */
+    static seq_model_track_t original;
+    static seq_model_track_t decoded_full;
+    static seq_model_track_t decoded_drop;
+    static seq_model_track_t decoded_absent;
     uint8_t buffer[SEQ_PROJECT_PATTERN_STORAGE_MAX];
     size_t written = 0U;
 
@@ -49,6 +49,11 @@ msg_t chBSemWaitTimeout(binary_semaphore_t *bsp, systime_t timeout);
 void chBSemSignal(binary_semaphore_t *bsp);
 
 #define TIME_MS2I(ms) ((systime_t)(ms))
+
+#ifndef CH_CFG_ST_FREQUENCY
+#define CH_CFG_ST_FREQUENCY 10000U
+#endif
+#define chTimeUS2I(us) ((systime_t)((((uint64_t)(us)) * CH_CFG_ST_FREQUENCY + 999999U) / 1000000U))
 #define TIME_INFINITE ((systime_t)(-1))
 
 #define chDbgCheck(cond) do { (void)(cond); } while (0)
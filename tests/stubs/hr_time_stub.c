@@ -0,0 +1,18 @@
+#include "core/hr_time.h"
+
+/* Base µs simulée : l’horloge système du test, plus un décalage sous le tick
+   (`g_hr_time_stub_offset`) pour les tests qui ont besoin de la résolution µs. */
+hr_time_t g_hr_time_stub_offset;
+
+void hr_time_init(void) {
+    g_hr_time_stub_offset = 0U;
+}
+
+hr_time_t hr_time_now(void) {
+    return (hr_time_t)(hr_time_span_from_st(chVTGetSystemTimeX()) + g_hr_time_stub_offset);
+}
+
+hr_time_t hr_time_sample(systime_t *st) {
+    *st = chVTGetSystemTimeX();
+    return (hr_time_t)(hr_time_span_from_st(*st) + g_hr_time_stub_offset);
+}
@@ -6,3 +6,6 @@ void seq_engine_runner_on_transport_stop(void) {}
 void seq_engine_runner_on_clock_step(const clock_step_info_t *info) {
     (void)info;
 }
+void seq_engine_runner_on_clock_tick(systime_t now) {
+    (void)now;
+}
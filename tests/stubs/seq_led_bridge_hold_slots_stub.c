@@ -1,5 +1,5 @@
 #include <stddef.h>
 #include <stdint.h>
 
-uint8_t g_hold_slots[3648];
+uint8_t g_hold_slots[576];
 const size_t g_hold_slots_size = sizeof(g_hold_slots);
@@ -0,0 +1,62 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "seq_runner_env_stub.h"
+
+/* Environnement du runner pour les tests hôtes : pont LED, mutes et lien cart.
+   Le dernier pattern activé par le runner reste lisible (`g_stub_active_*`),
+   comme la fenêtre ouverte sur le bus cart (`g_stub_cart_tick_st`). Un test qui
+   observe les trames cart installe ses crochets ; sans crochet, les trames sont
+   ignorées et l’ombre lit 0. */
+uint8_t g_stub_active_bank;
+uint8_t g_stub_active_pattern;
+uint32_t g_stub_cart_tick_st;
+void (*g_stub_cart_param_send)(uint16_t param_id, uint8_t value, cart_class_t cls);
+uint8_t (*g_stub_cart_shadow_get)(cart_id_t cid, uint16_t param_id);
+
+void seq_led_bridge_set_active(uint8_t bank, uint8_t pattern) {
+    g_stub_active_bank = bank;
+    g_stub_active_pattern = pattern;
+}
+
+void seq_led_bridge_get_active(uint8_t *out_bank, uint8_t *out_pattern) {
+    if (out_bank != NULL) {
+        *out_bank = g_stub_active_bank;
+    }
+    if (out_pattern != NULL) {
+        *out_pattern = g_stub_active_pattern;
+    }
+}
+
+bool ui_mute_backend_is_muted(uint8_t track) {
+    (void)track;
+    return false;
+}
+
+void cart_bus_on_tick(uint32_t tick_st) {
+    g_stub_cart_tick_st = tick_st;
+}
+
+void cart_link_param_send(uint16_t param_id, uint8_t value, cart_class_t cls) {
+    if (g_stub_cart_param_send != NULL) {
+        g_stub_cart_param_send(param_id, value, cls);
+    }
+}
+
+uint8_t cart_link_shadow_get(cart_id_t cid, uint16_t param_id) {
+    return (g_stub_cart_shadow_get != NULL) ? g_stub_cart_shadow_get(cid, param_id) : 0U;
+}
+
+void cart_link_shadow_set(cart_id_t cid, uint16_t param_id, uint8_t value) {
+    (void)cid;
+    (void)param_id;
+    (void)value;
+}
+
+bool cart_set_param(cart_id_t id, uint16_t param, uint8_t value) {
+    (void)id;
+    (void)param;
+    (void)value;
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef TESTS_STUBS_SEQ_RUNNER_ENV_STUB_H
+#define TESTS_STUBS_SEQ_RUNNER_ENV_STUB_H
+
+#include <stdint.h>
+
+#include "cart/cart_bus.h"
+#include "cart/cart_registry.h"
+
+/* Environnement du runner pour les tests hôtes (seq_runner_env_stub.c) :
+   pont LED, mutes et lien cart, avec les crochets et relevés des tests. */
+
+/* Dernier pattern activé par le runner. */
+extern uint8_t g_stub_active_bank;
+extern uint8_t g_stub_active_pattern;
+/* Fenêtre d’admission ouverte en dernier sur le bus cart. */
+extern uint32_t g_stub_cart_tick_st;
+/* Crochets facultatifs : trames cart envoyées, lecture de l’ombre. */
+extern void (*g_stub_cart_param_send)(uint16_t param_id, uint8_t value, cart_class_t cls);
+extern uint8_t (*g_stub_cart_shadow_get)(cart_id_t cid, uint16_t param_id);
+
+void seq_led_bridge_set_active(uint8_t bank, uint8_t pattern);
+void seq_led_bridge_get_active(uint8_t *out_bank, uint8_t *out_pattern);
+
+#endif /* TESTS_STUBS_SEQ_RUNNER_ENV_STUB_H */
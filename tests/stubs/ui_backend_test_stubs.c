@@ -161,6 +161,8 @@ bool cart_registry_find_by_uid(uint32_t uid, cart_id_t *out_id)
 /* Clock manager & MIDI                                                       */
 /* -------------------------------------------------------------------------- */
 void clock_manager_start(void) {}
+void clock_manager_continue(void) {}
+bool clock_manager_locate(uint32_t step_idx_abs) { (void)step_idx_abs; return true; }
 void clock_manager_stop(void) {}
 
 void midi_note_on(midi_dest_t dest, uint8_t ch, uint8_t note, uint8_t velocity)
@@ -108,11 +108,14 @@ static void test_track_metadata_initialisation(void)
         }
     }
 
-    /* Cart 1 exposes the contiguous number of assigned tracks, others zero. */
-    assert(g_stub_cart_counts[0] == seq_led_bridge_get_track_count());
-    assert(g_stub_cart_counts[1] == 0U);
-    assert(g_stub_cart_counts[2] == 0U);
-    assert(g_stub_cart_counts[3] == 0U);
+    /* Each cart exposes the contiguous number of assigned tracks in its group of four. */
+    const uint8_t assigned = seq_led_bridge_get_track_count();
+    for (uint8_t cart = 0U; cart < 4U; ++cart) {
+        const uint8_t first = (uint8_t)(cart * 4U);
+        const uint8_t remaining = (assigned <= first) ? 0U : (uint8_t)(assigned - first);
+        const uint8_t expected = (remaining > 4U) ? 4U : remaining;
+        assert(g_stub_cart_counts[cart] == expected);
+    }
 }
 
 static void test_track_select_focus_updates(void)
@@ -140,7 +143,7 @@ static void test_track_select_focus_updates(void)
     }
 
     /* Out of range selection leaves focus unchanged. */
-    assert(seq_led_bridge_select_track(15U) == false);
+    assert(seq_led_bridge_select_track(SEQ_PROJECT_MAX_TRACKS) == false);
     if (seq_led_bridge_get_track_count() > 1U) {
         assert(g_stub_track_focus == 1U);
     } else {
@@ -190,11 +193,46 @@ static void test_track_mode_mapping(void)
     assert(ctx.track.active == false);
 }
 
+static void test_locate_mapping(void)
+{
+    ui_mode_context_t ctx;
+    ui_shortcut_map_init(&ctx);
+
+    ui_input_event_t evt;
+    memset(&evt, 0, sizeof(evt));
+
+    /* SHIFT+BS4 while stopped places the playhead on step 3, no hold. */
+    g_shift_pressed = true;
+    evt.has_button = true;
+    evt.btn_id = UI_BTN_SEQ4;
+    evt.btn_pressed = true;
+    ui_shortcut_map_result_t res = ui_shortcut_map_process(&evt, &ctx);
+    assert(res.consumed);
+    assert(res.action_count == 1U);
+    assert(res.actions[0].type == UI_SHORTCUT_ACTION_TRANSPORT_LOCATE);
+    assert(res.actions[0].data.seq_step.index == 3U);
+    assert(ctx.seq.held_mask == 0U);
+
+    /* Its release does not toggle the step. */
+    evt.btn_pressed = false;
+    res = ui_shortcut_map_process(&evt, &ctx);
+    assert(res.action_count == 0U);
+
+    /* While playing, SHIFT+pad keeps the step hold. */
+    ctx.transport.playing = true;
+    evt.btn_pressed = true;
+    res = ui_shortcut_map_process(&evt, &ctx);
+    assert(res.action_count == 1U);
+    assert(res.actions[0].type == UI_SHORTCUT_ACTION_SEQ_STEP_HOLD);
+    g_shift_pressed = false;
+}
+
 int main(void)
 {
     test_track_metadata_initialisation();
     test_track_select_focus_updates();
     test_track_mode_mapping();
+    test_locate_mapping();
     printf("ui_mode_transition_tests: OK\n");
     return 0;
 }
@@ -32,6 +32,7 @@
 #include "ui_overlay.h"
 #include "ui_mute_backend.h"
 #include "seq_led_bridge.h"
+#include "core/seq/seq_model.h" /* seq_model_plock_drop_total() */
 #include "seq_engine_runner.h"
 #include "seq_recorder.h"
 #include "clock_manager.h"
@@ -61,6 +62,14 @@ static CCM_DATA ui_mode_context_t s_mode_ctx;
 static seq_mode_t s_active_seq_mode = SEQ_MODE_DEFAULT;
 static char s_mode_label[8] = "SEQ";
 
+#ifndef UI_BACKEND_PLOCK_FULL_MS
+#define UI_BACKEND_PLOCK_FULL_MS  1500u
+#endif
+
+static uint32_t  s_plock_drops_seen;
+static bool      s_plock_full_shown;
+static systime_t s_plock_full_since;
+
 static const ui_cart_spec_t *s_seq_mode_spec_banner   = &seq_ui_spec;
 static const ui_cart_spec_t *s_seq_setup_spec_banner  = &seq_setup_ui_spec;
 static const ui_cart_spec_t *s_arp_mode_spec_banner   = &arp_ui_spec;
@@ -340,12 +349,29 @@ const ui_mode_context_t *ui_backend_get_mode_context(void) {
 }
 
 const char *ui_backend_get_mode_label(void) {
+    if (s_plock_full_shown) {
+        return "FULL";
+    }
     if (s_mode_label[0] == '\0') {
         _set_mode_label("SEQ");
     }
     return s_mode_label;
 }
 
+void ui_backend_poll_plock_drops(systime_t now) {
+    const uint32_t drops = seq_model_plock_drop_total();
+    if (drops != s_plock_drops_seen) {
+        s_plock_drops_seen = drops;
+        s_plock_full_shown = true;
+        s_plock_full_since = now;
+        ui_mark_dirty();
+    } else if (s_plock_full_shown &&
+               ((systime_t)(now - s_plock_full_since) >= TIME_MS2I(UI_BACKEND_PLOCK_FULL_MS))) {
+        s_plock_full_shown = false;
+        ui_mark_dirty();
+    }
+}
+
 void ui_backend_process_input(const ui_input_event_t *evt) {
     if (!evt) {
         return;
@@ -492,6 +518,16 @@ static void _disarm_track_mode_if_active(void) {
     }
 }
 
+/* État UI/LED du transport, commun aux raccourcis PLAY/STOP et au transport du maître. */
+static void _transport_set_playing(bool playing) {
+    if (playing) {
+        seq_led_bridge_on_play();
+    } else {
+        seq_led_bridge_on_stop();
+    }
+    s_mode_ctx.transport.playing = playing;
+}
+
 static void _handle_shortcut_action(const ui_shortcut_action_t *act) {
     if (!act) {
         return;
@@ -593,16 +629,28 @@ static void _handle_shortcut_action(const ui_shortcut_action_t *act) {
     case UI_SHORTCUT_ACTION_TRANSPORT_PLAY:
         seq_engine_runner_on_transport_play();
         clock_manager_start();
-        seq_led_bridge_on_play();
-        s_mode_ctx.transport.playing = true;
+        _transport_set_playing(true);
+        break;
+
+    case UI_SHORTCUT_ACTION_TRANSPORT_CONTINUE:
+        /* Reprise (SPP + Continue) : le runner reconstitue les notes tenues au premier step. */
+        seq_engine_runner_on_transport_play();
+        clock_manager_continue();
+        _transport_set_playing(true);
+        break;
+
+    case UI_SHORTCUT_ACTION_TRANSPORT_LOCATE:
+        /* Page visible + pad : SHIFT+PLAY repart ensuite de ce step. */
+        (void)clock_manager_locate((uint32_t)seq_led_bridge_get_visible_page() * 16U +
+                                   act->data.seq_step.index);
+        ui_mark_dirty();
         break;
 
     case UI_SHORTCUT_ACTION_TRANSPORT_STOP:
         ui_keyboard_bridge_on_transport_stop(); // --- ARP: flush avant STOP ---
         seq_engine_runner_on_transport_stop();
         clock_manager_stop();
-        seq_led_bridge_on_stop();
-        s_mode_ctx.transport.playing = false;
+        _transport_set_playing(false);
         break;
 
     case UI_SHORTCUT_ACTION_TRANSPORT_REC_TOGGLE:
@@ -791,6 +839,13 @@ static uint8_t _ui_shadow_get(uint16_t id_full) {
     return (idx >= 0) ? s_ui_shadow[(uint16_t)idx].val : 0u; // --- FIX: accès sécurisé au cache étendu ---
 }
 
+void ui_backend_on_master_transport(bool playing) {
+    if (!playing) {
+        ui_keyboard_bridge_on_transport_stop(); // --- ARP: flush comme sur STOP ---
+    }
+    _transport_set_playing(playing);
+}
+
 void ui_backend_init_runtime(void) {
     ui_shortcut_map_init(&s_mode_ctx);
     s_mode_ctx.custom_mode     = ui_overlay_get_custom_mode();
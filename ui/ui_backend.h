@@ -173,6 +173,29 @@ const char* ui_backend_get_mode_label(void);
  */
 void ui_mode_reset_context(ui_context_t *ctx, seq_mode_t next_mode);
 
+/**
+ * @brief Applique le transport du maître (FA/FB/FC, mode esclave) à l'état UI/LED.
+ *
+ * Même chemin que les raccourcis PLAY/STOP, sans runner ni horloge : le runner
+ * a déjà été notifié dans le contexte horloge, avant le premier F8 du maître.
+ * Appelée exclusivement depuis le thread UI.
+ *
+ * @param playing `true` sur FA/FB, `false` sur FC.
+ */
+void ui_backend_on_master_transport(bool playing);
+
+/**
+ * @brief Signale les p-locks perdus faute de place (step ou arène piste pleins).
+ *
+ * Compare `seq_model_plock_drop_total()` au dernier total vu : après une
+ * nouvelle perte, le tag de mode affiche "FULL" pendant
+ * `UI_BACKEND_PLOCK_FULL_MS`, puis le tag du mode revient.
+ * Appelée exclusivement depuis le thread UI.
+ *
+ * @param now Instant courant.
+ */
+void ui_backend_poll_plock_drops(systime_t now);
+
 /**
  * @brief Traite un évènement d'entrée complet (bouton/encodeur).
  * @param evt Évènement à traiter (doit être non NULL).
@@ -0,0 +1,157 @@
+/**
+ * @file ui_output_latency.c
+ * @brief Compensation de latence par sortie : projet ↔ ordonnanceur, calibration.
+ *
+ * L’état de calibration est partagé entre le thread UI (sondes, fin de mesure)
+ * et le thread de lecture DIN (écho) : chaque accès passe sous verrou système,
+ * le module `latency_cal` ne fait que du calcul.
+ *
+ * @ingroup ui
+ */
+
+#include "ui_output_latency.h"
+
+#include "ch.h"
+#include "hal.h"
+
+#include "seq_led_bridge.h"
+#include "cart_bus.h"
+#include "core/hr_time.h"
+#include "midi.h"
+#include "midi_rx.h"
+
+_Static_assert(SEQ_PROJECT_OUTPUT_COUNT == SEQ_SCHEDULER_OUT_COUNT,
+               "ui_output_latency: projet et ordonnanceur doivent compter les mêmes sorties");
+_Static_assert(SEQ_PROJECT_LATENCY_MAX_US == SEQ_SCHEDULER_LATENCY_MAX_US,
+               "ui_output_latency: bornes de décalage différentes");
+
+/* ====================================================================== */
+/*                                 ÉTAT                                   */
+/* ====================================================================== */
+
+static latency_cal_t          s_cal;
+static seq_scheduler_output_t s_cal_out = SEQ_SCHEDULER_OUT_DIN;
+static uint32_t               s_cart_lots;   /**< Lots cartouche déjà vus (détection d’une réponse) */
+
+/* ====================================================================== */
+/*                          FONCTIONS INTERNES                            */
+/* ====================================================================== */
+
+static bool _is_cart(seq_scheduler_output_t out) {
+  return (out >= SEQ_SCHEDULER_OUT_CART1) && (out < (SEQ_SCHEDULER_OUT_CART1 + CART_COUNT));
+}
+
+/** Écho de sonde (thread de lecture DIN). */
+static void _on_din_echo(hr_time_t ts) {
+  osalSysLock();
+  if (s_cal_out == SEQ_SCHEDULER_OUT_DIN) {
+    latency_cal_echo(&s_cal, ts);
+  }
+  osalSysUnlock();
+}
+
+/** Réponse cartouche : un nouveau lot d’un seul GET donne un aller-retour. */
+static void _poll_cart_echo(void) {
+  uint32_t lots = 0U;
+  uint32_t rtt = 0U;
+  uint8_t  lot_size = 0U;
+  if (!cart_bus_get_rtt((cart_id_t)(s_cal_out - SEQ_SCHEDULER_OUT_CART1), &lots, &rtt, &lot_size) ||
+      (lots == s_cart_lots)) {
+    return;
+  }
+  s_cart_lots = lots;
+  if (lot_size == 1U) {
+    osalSysLock();
+    latency_cal_sample(&s_cal, hr_time_span_from_st(rtt));
+    osalSysUnlock();
+  }
+}
+
+static void _send_probe(void) {
+  if (s_cal_out == SEQ_SCHEDULER_OUT_DIN) {
+    midi_din_probe();
+  } else {
+    /* Refus (file pleine, port absent) : la sonde expirera comme une perte. */
+    (void)cart_get_param((cart_id_t)(s_cal_out - SEQ_SCHEDULER_OUT_CART1), UI_OUTPUT_LATENCY_CART_PROBE_PARAM);
+  }
+}
+
+/* ====================================================================== */
+/*                              API PUBLIQUE                              */
+/* ====================================================================== */
+
+void ui_output_latency_init(void) {
+  midi_rx_register_probe_callback(_on_din_echo);
+  ui_output_latency_apply();
+}
+
+void ui_output_latency_apply(void) {
+  const seq_project_t *project = seq_led_bridge_get_project_const();
+  for (uint8_t out = 0U; out < SEQ_SCHEDULER_OUT_COUNT; ++out) {
+    seq_scheduler_set_latency((seq_scheduler_output_t)out, seq_project_get_output_latency(project, out));
+  }
+}
+
+bool ui_output_latency_set(seq_scheduler_output_t out, int32_t offset_us) {
+  if (out >= SEQ_SCHEDULER_OUT_COUNT) {
+    return false;
+  }
+  (void)seq_project_set_output_latency(seq_led_bridge_get_project(), (uint8_t)out, offset_us);
+  seq_scheduler_set_latency(out, offset_us);
+  return true;
+}
+
+bool ui_output_latency_calibrate(seq_scheduler_output_t out) {
+  if ((out != SEQ_SCHEDULER_OUT_DIN) && !_is_cart(out)) {
+    return false;  /* USB : pas de bouclage */
+  }
+  if (_is_cart(out) &&
+      !cart_bus_get_rtt((cart_id_t)(out - SEQ_SCHEDULER_OUT_CART1), &s_cart_lots, NULL, NULL)) {
+    return false;
+  }
+  osalSysLock();
+  const bool busy = (s_cal.state == LATENCY_CAL_RUNNING);
+  if (!busy) {
+    s_cal_out = out;
+    latency_cal_start(&s_cal, UI_OUTPUT_LATENCY_CAL_PROBES, UI_OUTPUT_LATENCY_CAL_TIMEOUT_US);
+  }
+  osalSysUnlock();
+  return !busy;
+}
+
+void ui_output_latency_poll(void) {
+  if (s_cal.state != LATENCY_CAL_RUNNING) {
+    return;
+  }
+  if (_is_cart(s_cal_out)) {
+    _poll_cart_echo();
+  }
+
+  osalSysLock();
+  const bool probe = latency_cal_poll(&s_cal, hr_time_now());
+  const latency_cal_state_t state = s_cal.state;
+  osalSysUnlock();
+
+  if (probe) {
+    /* Instant noté avant l’envoi : l’aller-retour inclut la file de sortie. */
+    osalSysLock();
+    latency_cal_sent(&s_cal, hr_time_now());
+    osalSysUnlock();
+    _send_probe();
+  } else if (state == LATENCY_CAL_DONE) {
+    (void)ui_output_latency_set(s_cal_out, latency_cal_offset_us(&s_cal));
+  }
+}
+
+latency_cal_state_t ui_output_latency_cal_state(seq_scheduler_output_t *out, uint32_t *rtt_min) {
+  osalSysLock();
+  const latency_cal_state_t state = s_cal.state;
+  if (out != NULL) {
+    *out = s_cal_out;
+  }
+  if (rtt_min != NULL) {
+    *rtt_min = (state == LATENCY_CAL_DONE) ? s_cal.rtt_min : 0U;
+  }
+  osalSysUnlock();
+  return state;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file ui_output_latency.h
+ * @brief Compensation de latence par sortie : projet ↔ ordonnanceur, calibration.
+ *
+ * Les décalages (µs, négatif = sortie servie en avance) sont enregistrés dans
+ * le projet et appliqués à `seq_scheduler`. La calibration mesure
+ * l’aller-retour d’une sortie bouclée :
+ * - DIN : sonde F9 sur la sortie DIN, écho sur l’entrée DIN (câble OUT → IN) ;
+ * - cartouche : GET d’un seul paramètre, aller-retour compté par `cart_sync`
+ *   (résolution d’un tick système).
+ * L’USB n’a pas de bouclage : son décalage se règle à la main.
+ *
+ * Thread UI : `ui_output_latency_init()` au démarrage, `ui_output_latency_poll()`
+ * dans la boucle.
+ *
+ * @ingroup ui
+ */
+
+#ifndef BRICK_UI_OUTPUT_LATENCY_H
+#define BRICK_UI_OUTPUT_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/latency_cal.h"
+#include "core/seq/seq_scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Échos retenus par calibration. */
+#ifndef UI_OUTPUT_LATENCY_CAL_PROBES
+#define UI_OUTPUT_LATENCY_CAL_PROBES 8U
+#endif
+
+/** Délai d’écho d’une sonde (µs) : au-delà, la sonde est perdue. */
+#ifndef UI_OUTPUT_LATENCY_CAL_TIMEOUT_US
+#define UI_OUTPUT_LATENCY_CAL_TIMEOUT_US 20000U
+#endif
+
+/** Paramètre lu par la sonde cartouche (la réponse rafraîchit aussi le shadow). */
+#ifndef UI_OUTPUT_LATENCY_CART_PROBE_PARAM
+#define UI_OUTPUT_LATENCY_CART_PROBE_PARAM 0U
+#endif
+
+/** Enregistre l’écho DIN et applique les décalages du projet courant. */
+void ui_output_latency_init(void);
+
+/** Recopie les décalages du projet courant dans l’ordonnanceur (après chargement). */
+void ui_output_latency_apply(void);
+
+/** Règle le décalage d’une sortie (projet + ordonnanceur, borné). */
+bool ui_output_latency_set(seq_scheduler_output_t out, int32_t offset_us);
+
+/**
+ * @brief Lance la calibration d’une sortie bouclée (DIN ou cartouche).
+ *
+ * Une seule calibration à la fois ; le décalage mesuré est appliqué par
+ * `ui_output_latency_poll()` en fin de mesure.
+ * @return false pour l’USB, une sortie invalide ou une calibration déjà en cours.
+ */
+bool ui_output_latency_calibrate(seq_scheduler_output_t out);
+
+/** Fait avancer la calibration en cours (sondes, échos cartouche, fin de mesure). */
+void ui_output_latency_poll(void);
+
+/**
+ * @brief État de la dernière calibration lancée.
+ * @param out     Sortie calibrée (peut être NULL).
+ * @param rtt_min Aller-retour minimal mesuré, en µs (peut être NULL).
+ */
+latency_cal_state_t ui_output_latency_cal_state(seq_scheduler_output_t *out, uint32_t *rtt_min);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRICK_UI_OUTPUT_LATENCY_H */
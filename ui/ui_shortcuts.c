@@ -224,7 +224,12 @@ static bool _map_transport(const ui_input_event_t *evt,
         return false;
     }
     if (shift_now) {
-        return false;
+        if (evt->btn_id != UI_BTN_PLAY) {
+            return false;
+        }
+        (void)_push_action(res, UI_SHORTCUT_ACTION_TRANSPORT_CONTINUE);
+        res->consumed = true;
+        return true;
     }
 
     switch (evt->btn_id) {
@@ -277,7 +282,8 @@ static bool _map_seq_pages(const ui_input_event_t *evt,
 
 static bool _map_seq_pads(const ui_input_event_t *evt,
                           ui_mode_context_t *ctx,
-                          ui_shortcut_map_result_t *res) {
+                          ui_shortcut_map_result_t *res,
+                          bool shift_now) {
     if (ctx->mute_state != UI_MUTE_STATE_OFF) {
         return false;
     }
@@ -296,6 +302,18 @@ static bool _map_seq_pads(const ui_input_event_t *evt,
         return false;
     }
 
+    /* SHIFT+pad transport à l'arrêt : locate, sans hold ni toggle du step.
+       SEQ9/10/11 restent aux overlays et au mode Track (mappés avant). */
+    if (shift_now && evt->btn_pressed && !ctx->transport.playing) {
+        ui_shortcut_action_t *act =
+            _push_action(res, UI_SHORTCUT_ACTION_TRANSPORT_LOCATE);
+        if (act) {
+            act->data.seq_step.index = idx;
+        }
+        res->consumed = true;
+        return true;
+    }
+
     if (evt->btn_pressed) {
         ctx->seq.held_flags[idx] = true;
         ctx->seq.held_mask |= (uint16_t)(1u << idx);
@@ -408,7 +426,7 @@ ui_shortcut_map_process(const ui_input_event_t *evt, ui_mode_context_t *ctx) {
         return res;
     }
 
-    if (_map_seq_pads(evt, ctx, &res)) {
+    if (_map_seq_pads(evt, ctx, &res, shift_now)) {
         ctx->mute_shift_latched = shift_now;
         return res;
     }
@@ -46,6 +46,8 @@ typedef enum {
     UI_SHORTCUT_ACTION_TRACK_SELECT,        /**< Sélectionne une piste depuis la grille. */
     UI_SHORTCUT_ACTION_TRANSPORT_PLAY,      /**< PLAY global. */
     UI_SHORTCUT_ACTION_TRANSPORT_STOP,      /**< STOP global. */
+    UI_SHORTCUT_ACTION_TRANSPORT_CONTINUE,  /**< SHIFT+PLAY : reprise à la position d'arrêt. */
+    UI_SHORTCUT_ACTION_TRANSPORT_LOCATE,    /**< SHIFT+pad SEQ (arrêt) : place la tête sur le step. */
     UI_SHORTCUT_ACTION_TRANSPORT_REC_TOGGLE,/**< Toggle REC global. */
     UI_SHORTCUT_ACTION_SEQ_PAGE_NEXT,       /**< Page SEQ suivante. */
     UI_SHORTCUT_ACTION_SEQ_PAGE_PREV,       /**< Page SEQ précédente. */
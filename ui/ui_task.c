@@ -30,12 +30,18 @@
 #include "ui_controller.h"
 #include "ui_renderer.h"
 #include "cart_registry.h"
+#include "cart_link.h"
 #include "ui_backend.h"
 #include "clock_manager.h"
+#include "midi.h"
+#include "midi_rx.h"
 #include "ui_led_backend.h"
 #include "seq_led_bridge.h"
 #include "seq_engine_runner.h"
+#include "ui_output_latency.h"
 #include "seq_recorder.h"
+#include "core/seq/seq_pattern_queue.h"
+#include "core/seq/reader/seq_reader.h"
 
 /* Keyboard runtime */
 #include "ui_keyboard_bridge.h"
@@ -70,14 +76,75 @@ static void _on_clock_step(const clock_step_info_t* info) {
   if (!info) return;
   const uint8_t step_abs = (uint8_t)(info->step_idx_abs & 0xFFu);  /* <-- plus de & 15U */
   ui_led_backend_post_event_i(UI_LED_EVENT_CLOCK_TICK, step_abs, true);
+  midi_din_step_mark(info->step_hr);
   seq_recorder_on_clock_step(info);
   seq_engine_runner_on_clock_step(info);
 }
 
+/* Transport du maître en attente pour le thread UI (dernier reçu), sous chSysLock(). */
+typedef enum {
+  UI_MASTER_TRANSPORT_NONE = 0,
+  UI_MASTER_TRANSPORT_PLAY,
+  UI_MASTER_TRANSPORT_STOP
+} ui_master_transport_t;
+
+static ui_master_transport_t s_master_transport = UI_MASTER_TRANSPORT_NONE;
+
+/**
+ * @brief Callback transport en mode esclave (FA/FB/FC du maître).
+ *
+ * Appelé depuis le thread de réception MIDI, sous le verrou des ticks : le
+ * runner est remis à zéro ici, avant le premier F8 du maître. L’état UI/LED
+ * est posté au thread UI, qui l’applique comme PLAY/STOP.
+ */
+static void _on_clock_transport(clock_transport_event_t ev, uint32_t step_idx_abs) {
+  (void)step_idx_abs;
+  const bool stop = (ev == CLOCK_TRANSPORT_STOP);
+  if (stop) {
+    seq_engine_runner_on_transport_stop();
+  } else {
+    seq_engine_runner_on_transport_play();
+  }
+  chSysLock();
+  s_master_transport = stop ? UI_MASTER_TRANSPORT_STOP : UI_MASTER_TRANSPORT_PLAY;
+  chSysUnlock();
+}
+
+/**
+ * @brief Applique au thread UI le dernier transport reçu du maître.
+ */
+static void _apply_master_transport(void) {
+  chSysLock();
+  const ui_master_transport_t ev = s_master_transport;
+  s_master_transport = UI_MASTER_TRANSPORT_NONE;
+  chSysUnlock();
+  if (ev != UI_MASTER_TRANSPORT_NONE) {
+    ui_backend_on_master_transport(ev == UI_MASTER_TRANSPORT_PLAY);
+    ui_mark_dirty();
+  }
+}
+
 /* ============================================================================
  * Helpers
  * ==========================================================================*/
 
+/**
+ * @brief Vide la file « canal » de la réception MIDI vers le bridge clavier.
+ *
+ * Note On vélocité 0 = Note Off. Les autres messages canal sont ignorés.
+ */
+static void _drain_midi_input(void) {
+  midi_rx_event_t rx;
+  while (midi_rx_pop(&rx)) {
+    const uint8_t kind = (uint8_t)(rx.status & 0xF0U);
+    if ((kind == 0x90U) && (rx.data2 != 0U)) {
+      ui_keyboard_bridge_on_external_note(rx.data1, rx.data2, true, rx.ts);
+    } else if ((kind == 0x80U) || (kind == 0x90U)) {
+      ui_keyboard_bridge_on_external_note(rx.data1, 0U, false, rx.ts);
+    }
+  }
+}
+
 /* ============================================================================
  * Thread principal UI
  * ==========================================================================*/
@@ -98,6 +165,10 @@ static THD_FUNCTION(UIThread, arg) {
   /* 2) Init clock manager (tick 24 PPQN → step 1/16) */
   clock_manager_init(CLOCK_SRC_INTERNAL);  /* enregistre on_midi_tick, prépare GPT */
   clock_manager_register_step_callback2(_on_clock_step);
+  clock_manager_register_tick_callback(seq_engine_runner_on_clock_tick);
+  clock_manager_register_service_callback(seq_engine_runner_service);
+  clock_manager_register_transport_callback(_on_clock_transport);
+  midi_rx_register_clock_callbacks(clock_manager_on_midi_realtime, clock_manager_on_song_position);
 
   /* 3) Initialisation backend + bridge Keyboard */
   ui_backend_init_runtime();
@@ -105,20 +176,47 @@ static THD_FUNCTION(UIThread, arg) {
   ui_keyboard_bridge_update_from_model();
   seq_recorder_init(seq_led_bridge_access_track());
   seq_engine_runner_init();
+  ui_output_latency_init();  /* décalages de sortie du projet → ordonnanceur, écho DIN */
 
   ui_input_event_t evt;
 
   for (;;) {
-    const systime_t now = chVTGetSystemTimeX();
     const bool got = ui_input_poll(&evt, TIME_MS2I(UI_TASK_POLL_MS));
 
     if (got) {
       ui_backend_process_input(&evt);
     }
 
+    /* Transport du maître (esclave) → état UI/LED */
+    _apply_master_transport();
+
+    /* Notes MIDI externes (USB/DIN), horodatées à l’arrivée */
+    _drain_midi_input();
+
+    /* Réponses cartouche (GET / relecture complète) → shadow */
+    if (cart_link_sync_poll() != 0U) {
+      ui_mark_dirty();
+    }
+
+    /* Calibration de latence en cours : sondes DIN/cartouche, décalage appliqué en fin de mesure */
+    ui_output_latency_poll();
+
+    /* Plans de lecture compilés hors du tick : pistes éditées, puis pattern en file */
+    (void)seq_reader_plan_service();
+    (void)seq_pattern_queue_prefetch_plans();
+
+    /* P-locks refusés (step ou arène piste pleins) → tag "FULL" */
+    ui_backend_poll_plock_drops(chVTGetSystemTimeX());
+
+    /* Pattern basculé par le runner en fin de pattern → bridge recalé sur les nouvelles pistes */
+    if (seq_pattern_queue_take_swapped(NULL, NULL)) {
+      seq_led_bridge_on_pattern_swap();
+      ui_mark_dirty();
+    }
+
     /* Sync Keyboard runtime (root/scale/omni & p2) */
     ui_keyboard_bridge_update_from_model();
-    ui_keyboard_bridge_tick(now); // --- ARP: tick moteur ---
+    ui_keyboard_bridge_tick(hr_time_now()); // --- ARP: tick moteur (après le poll bloquant) ---
 
     /* LEDs + affichage */
     ui_led_backend_refresh();
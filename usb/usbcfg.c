@@ -30,7 +30,9 @@
 
 #include "hal.h"
 #include "usbcfg.h"
-#include "ch.h"         /* chBSemSignalI */
+#include "ch.h"
+#include "midi.h"       /* midi_usb_tx_complete_i / midi_usb_tx_reset_i */
+#include "midi_rx.h"    /* midi_rx_usb_receive_i */
 #include <stdint.h>
 
 /** @brief Indique si l’interface USB-MIDI est prête pour la transmission. */
@@ -154,32 +156,33 @@ static const USBDescriptor strings[] = {
 static USBInEndpointState   ep2_in_state;   /**< État runtime EP2 IN  */
 static USBOutEndpointState  ep1_out_state;  /**< État runtime EP1 OUT */
 
-/** @brief Buffer de réception de 4 octets (1 paquet MIDI). */
-static uint8_t rx_pkt[4];
+/** @brief Buffer de réception d’un transfert bulk (jusqu’à 16 paquets MIDI). */
+static uint8_t rx_pkt[MIDI_EP_SIZE];
 
 /**
- * @brief Callback OUT (EP1) — réarme la réception de paquets MIDI.
+ * @brief Callback OUT (EP1) — transmet le transfert reçu à `midi_rx` puis réarme.
  * @param usbp Pointeur driver USB.
- * @param ep   Numéro d’endpoint (ignoré).
+ * @param ep   Numéro d’endpoint.
  */
 static void ep1_out_cb(USBDriver *usbp, usbep_t ep) {
-  (void)ep;
+  midi_rx_usb_receive_i(rx_pkt, usbGetReceiveTransactionSizeX(usbp, ep));
   usbStartReceiveI(usbp, MIDI_EP_OUT, rx_pkt, sizeof rx_pkt);
 }
 
 /**
- * @brief Callback IN (EP2) — signale la fin de transmission MIDI.
+ * @brief Callback IN (EP2) — fin de transmission MIDI.
  * @param usbp Pointeur driver USB.
  * @param ep   Numéro d’endpoint (ignoré).
  *
  * @details
- * Appelle `chBSemSignalI()` sur le sémaphore `tx_sem` défini dans `midi.c`
- * pour réveiller le thread d’émission.
+ * Bascule les tampons de la file d’émission de `midi.c` et renvoie
+ * immédiatement le tampon rempli s’il y en a un (pas de thread intermédiaire).
  */
-extern binary_semaphore_t tx_sem;  /* défini dans midi.c */
 static void ep2_in_cb(USBDriver *usbp, usbep_t ep) {
   (void)usbp; (void)ep;
-  chBSemSignalI(&tx_sem);
+  osalSysLockFromISR();
+  midi_usb_tx_complete_i();
+  osalSysUnlockFromISR();
 }
 
 /* --- EP1 : OUT (bulk) --- */
@@ -247,8 +250,8 @@ static void usb_event(USBDriver *usbp, usbevent_t event) {
       usbInitEndpointI(usbp, MIDI_EP_OUT, &ep1_out_cfg);
       usbInitEndpointI(usbp, MIDI_EP_IN,  &ep2_in_cfg);
       usbStartReceiveI(usbp, MIDI_EP_OUT, rx_pkt, sizeof rx_pkt);
+      midi_usb_tx_reset_i();
       usb_midi_tx_ready = true;
-      chBSemSignalI(&tx_sem);
       osalSysUnlock();
       break;
 